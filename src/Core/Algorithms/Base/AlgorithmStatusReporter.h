@@ -32,6 +32,7 @@
 #include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 #include <Core/Utils/ProgressReporter.h>
+#include <Core/Logging/ExecutionTrace.h>
 #include <Core/Algorithms/Base/share.h>
 
 namespace SCIRun {
@@ -62,6 +63,7 @@ namespace Algorithms {
     static UpdaterFunc defaultUpdaterFunc_;
   };
 
+  /// Also records the scope as an "algorithm" span when execution tracing is enabled.
   class SCISHARE ScopedAlgorithmStatusReporter : boost::noncopyable
   {
   public:
@@ -69,6 +71,7 @@ namespace Algorithms {
     ~ScopedAlgorithmStatusReporter();
   private:
     const AlgorithmStatusReporter* asr_;
+    Core::Logging::ScopedTraceSpan span_;
   };
 
   #define REPORT_STATUS(className) ScopedAlgorithmStatusReporter __asr(this, #className);
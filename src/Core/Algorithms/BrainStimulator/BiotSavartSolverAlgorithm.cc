@@ -33,12 +33,17 @@
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Math/MiscMath.h>
+#include <Core/GeometryPrimitives/BBox.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Thread/Barrier.h>
 #include <Core/Thread/Parallel.h>
 #include <string>
 #include <cassert>
+#include <cfloat>
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <Core/Logging/Log.h>
 #include <boost/lexical_cast.hpp>
 
@@ -55,6 +60,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, Coil);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorBField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorAField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
+ALGORITHM_PARAMETER_DEF(BrainStimulator, FarFieldOpeningAngle);
 
 	class KernelBase
 		{
@@ -99,7 +105,9 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 			//! parallel essential primitives
 			Barrier barrier_;
-			std::vector<bool> success;
+			//! one flag per thread; not std::vector<bool>, whose packed bits race when
+			//! neighbouring threads write their own flag
+			std::vector<char> success;
 
 			//! output Field
 			int typeOut;
@@ -137,7 +145,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 					algo_->remark("number of processors:  " + boost::lexical_cast<std::string>(this->numprocessors_));
 
-					success.resize(numprocessors_,true);
+					success.assign(numprocessors_, true);
 
 					//! get number of nodes for the model
 					modelSize = vmesh->num_nodes();
@@ -172,6 +180,50 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 		};
 
 
+	//! Quadrature points of all coil segments, kept as structure of arrays so the
+	//! integration loops stream through contiguous memory and vectorize.
+	struct CoilQuadrature
+	{
+		//! midpoints of the infinitesimal curve-elements
+		std::vector<double> mx, my, mz;
+		//! infinitesimal curve-element components
+		std::vector<double> dx, dy, dz;
+		//! absolute current of the coil segment the element belongs to
+		std::vector<double> w;
+
+		size_t size() const { return w.size(); }
+
+		void add(const Vector& mid, const Vector& dL, double current)
+		{
+			mx.push_back(mid.x()); my.push_back(mid.y()); mz.push_back(mid.z());
+			dx.push_back(dL.x()); dy.push_back(dL.y()); dz.push_back(dL.z());
+			w.push_back(current);
+		}
+
+		void permute(const std::vector<size_t>& order)
+		{
+			for (auto* a : { &mx, &my, &mz, &dx, &dy, &dz, &w })
+			{
+				std::vector<double> tmp(order.size());
+				for (size_t i = 0; i < order.size(); i++)
+					tmp[i] = (*a)[order[i]];
+				a->swap(tmp);
+			}
+		}
+	};
+
+	//! Cluster of quadrature points for the far-field approximation. The moments
+	//! are taken about the center: Q = sum w*dL, M = sum w*(m-center)(x)dL.
+	struct CoilCluster
+	{
+		size_t begin, end;
+		int left, right;
+		Vector center;
+		double radius;
+		Vector Q;
+		double M[3][3];
+	};
+
 	class PieceWiseKernel : public KernelBase
 		{
 			public:
@@ -183,7 +235,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					//it makes more sense to keep a look-up table of previous steps for given lenght
 					autostep = 0.1;
 					extstep = -1.0;
-
+					theta = 0.0;
 				}
 
 				~PieceWiseKernel()
@@ -191,6 +243,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 				}
 
 				//! Complexity O(M*N) ,where M is the number of nodes of the model and N is the numbder of nodes of the coil
+				//! With a positive opening angle the far field is approximated and the complexity drops to O(M*log(N))
 				virtual bool Integrate(FieldHandle& mesh, FieldHandle& coil, MatrixHandle& outdata)
 				{
 
@@ -201,31 +254,40 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 					vmesh->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
-					VMesh::Node::array_type enodes;
-					Point enode1;
-					Point enode2;
-
 					//! get numbder of nodes for the coil
 					coilSize = vcoil->num_nodes();
 
 					//! basic assumption
 					assert(modelSize > 0 && coilSize > 1);
 
-					coilNodes.clear();
-					coilNodes.reserve(coilSize);
+					BuildQuadrature();
 
+					if (theta > 0.0)
+						BuildClusters();
 
-					for(VMesh::Edge::index_type i = 0; i < vcoil->num_edges(); i++)
+					nearZeroDistance = false;
+					nodesDone = 0;
+
+					try
 					{
-						vcoil->get_nodes(enodes,i);
-						vcoil->get_point(enode1,enodes[0]);
-						vcoil->get_point(enode2,enodes[1]);
-						coilNodes.push_back(Vector(enode1));
-						coilNodes.push_back(Vector(enode2));
+						Parallel::For(IndexRange(0, modelSize), 0, [this](const IndexRange& r)
+						{
+							if (theta > 0.0)
+								TreeKernel(r);
+							else
+								DirectKernel(r);
+						});
+					}
+					catch (...)
+					{
+						algo_->error(std::string("PieceWiseKernel crashed while integrating"));
+						success[0] = false;
 					}
 
-					//! Start the multi threaded
-					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
+					if (nearZeroDistance)
+					{
+						algo_->warning("coil<->model distance approaching zero!");
+					}
 
 					return PostIntegration(outdata);
 				}
@@ -241,36 +303,46 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					return extstep;
 				}
 
+				//! Clusters of coil elements smaller than theta times their distance to a
+				//! model node are replaced by a first-order expansion about the cluster center.
+				//! The truncation error of each cluster is of order theta^2 relative to the sum
+				//! of the magnitudes of its elements' contributions. Zero disables the approximation.
+				void SetFarFieldOpeningAngle(double angle)
+				{
+					assert(angle >= 0.0 && angle < 1.0);
+					theta = angle;
+				}
 
 			private:
 
+				//! number of model nodes integrated together in the direct kernel
+				static const size_t blockSize = 64;
+				//! maximum number of coil elements in a leaf cluster
+				static const size_t leafSize = 16;
+
 				//! integration step, will auto adapt
 				double autostep;
 
 				//! integration step, externally provided
 				double extstep;
 
-				//! keep nodes on the coil cached
-				std::vector<Vector> coilNodes;
+				//! far-field opening angle
+				double theta;
 
-				//! execute in parallel
-				void ParallelKernel(int proc_num)
-				{
+				CoilQuadrature quad;
+				std::vector<CoilCluster> clusters;
 
-					assert(proc_num >= 0);
+				std::atomic<bool> nearZeroDistance;
+				std::atomic<size_type> nodesDone;
+				std::mutex progressLock;
 
-					int cnt = 0;
+				//! Discretize every coil segment once, instead of once per model node
+				void BuildQuadrature()
+				{
+					VMesh::Node::array_type enodes;
+					Point enode1;
+					Point enode2;
 					double current = 1.0;
-					Point modelNode;
-
-					const index_type begins = (modelSize * proc_num) / numprocessors_;
-					const index_type ends  = (modelSize * (proc_num+1)) / numprocessors_;
-
-					assert( begins <= ends );
-
-					//! buffer of points used for integration
-					std::vector<Vector> integrPoints;
-					integrPoints.reserve(256);
 
 					//! keep previous step length
 					//! used for optimization purpose
@@ -278,147 +350,338 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 					//! number of integration points
 					int nips = 0;
-					index_type helpme=0;
+					bool stepTooBig = false;
 
-					try{
+					quad = CoilQuadrature();
+					std::vector<Vector> integrPoints;
+					integrPoints.reserve(256);
 
-						for(index_type iM = begins;
-							iM < ends;
-							iM++)
+					for(VMesh::Edge::index_type i = 0; i < vcoil->num_edges(); i++)
+					{
+						vcoil->get_nodes(enodes,i);
+						vcoil->get_point(enode1,enodes[0]);
+						vcoil->get_point(enode2,enodes[1]);
+
+						vcoilField->get_value(current,i);
+
+						current = current == 0.0 ? 1.0 : current;
+
+						Vector coilNodeThis(enode1);
+						Vector coilNodeNext(enode2);
+
+						if(current < 0.0)
 						{
-						        helpme++;
-							vmesh->get_node(modelNode,iM);
+							std::swap(coilNodeThis, coilNodeNext);
+						}
 
-							// result
-							Vector F;
+						//! Length of the curve element
+						Vector diffNodes = coilNodeNext - coilNodeThis;
+						double newSegLen = diffNodes.length();
 
-							for( size_t iC0 = 0, iC1 =1, iCV = 0;
-								iC0 < coilNodes.size();
-								iC0+=2, iC1+=2, iCV++)
+						//first check if externally suplied integration step is available and use it
+						if(extstep > 0)
+						{
+							nips = newSegLen / extstep;
+						}
+						else
+						{
+							//! optimization
+							//! only rexompute integration step only if segment length changes
+							if( Abs(prevSegLen - newSegLen ) > 0.00000001 )
 							{
-								vcoilField->get_value(current,iCV);
+								prevSegLen = newSegLen;
 
-								current = current == 0.0 ? 1.0 : current;
+								//auto adaptive integration step calculation
+								nips =  AdjustNumberOfIntegrationPoints(newSegLen);
+							}
+						}
 
-								Vector coilNodeThis;
-								Vector coilNodeNext;
+						if( nips < 3 )
+						{
+							stepTooBig = true;
+						}
 
-								if(current >= 0.0)
-								{
-									coilNodeThis = coilNodes[iC0];
-									coilNodeNext = coilNodes[iC1];
-								}
-								else
-								{
-									coilNodeThis = coilNodes[iC1];
-									coilNodeNext = coilNodes[iC0];
-								}
+						integrPoints.clear();
 
-								//! Length of the curve element
-								Vector diffNodes = coilNodeNext - coilNodeThis;
-								double newSegLen = diffNodes.length();
+						//! curve segment discretization
+						for(int iip = 0; iip < nips; iip++)
+						{
+							double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
+							integrPoints.push_back( Interpolate( coilNodeThis, coilNodeNext, interpolant ) );
+						}
 
-								//first check if externally suplied integration step is available and use it
-								if(extstep > 0)
-								{
-									nips = newSegLen / extstep;
-								}
-								else
-								{
-									//! optimization
-									//! only rexompute integration step only if segment length changes
-									if( Abs(prevSegLen - newSegLen ) > 0.00000001 )
-									{
-										prevSegLen = newSegLen;
-
-										//auto adaptive integration step calculation
-										nips =  AdjustNumberOfIntegrationPoints(newSegLen);
-									}
-								}
+						for(int iip = 0; iip < nips -1; iip++)
+						{
+							quad.add((integrPoints[iip] + integrPoints[iip+1] ) / 2,
+								integrPoints[iip+1] - integrPoints[iip], Abs(current));
+						}
+					}
 
-								if( nips < 3 )
-								{
-									algo_->warning("integration step too big");
-								}
+					if (stepTooBig)
+					{
+						algo_->warning("integration step too big");
+					}
+				}
 
-								integrPoints.clear();
+				//! Binary space partition of the quadrature points, with moments per cluster
+				void BuildClusters()
+				{
+					std::vector<size_t> order(quad.size());
+					for (size_t i = 0; i < order.size(); i++)
+						order[i] = i;
 
-								//! curve segment discretization
-								for(int iip = 0; iip < nips; iip++)
-								{
-									double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
-									Vector v = Interpolate( coilNodeThis, coilNodeNext, interpolant );
-									integrPoints.push_back( v );
-								}
+					clusters.clear();
+					if (!order.empty())
+						Split(order, 0, order.size());
 
+					quad.permute(order);
 
-								//! integration step over line segment
-								for(int iip = 0; iip < nips -1; iip++)
-								{
-									//! Vector connecting the infinitesimal curve-element
-									Vector Rxyz = (integrPoints[iip] + integrPoints[iip+1] ) / 2  - Vector(modelNode);
+					for (auto& c : clusters)
+					{
+						c.radius = 0.0;
+						c.Q = Vector(0, 0, 0);
+						for (int a = 0; a < 3; a++)
+							for (int b = 0; b < 3; b++)
+								c.M[a][b] = 0.0;
 
-									//! Infinitesimal curve-element components
-									Vector dLxyz = integrPoints[iip+1] - integrPoints[iip];
+						for (size_t j = c.begin; j < c.end; j++)
+						{
+							const double s[3] = { quad.mx[j] - c.center.x(), quad.my[j] - c.center.y(), quad.mz[j] - c.center.z() };
+							const double dL[3] = { quad.w[j] * quad.dx[j], quad.w[j] * quad.dy[j], quad.w[j] * quad.dz[j] };
+							c.radius = std::max(c.radius, std::sqrt(s[0]*s[0] + s[1]*s[1] + s[2]*s[2]));
+							c.Q += Vector(dL[0], dL[1], dL[2]);
+							for (int a = 0; a < 3; a++)
+								for (int b = 0; b < 3; b++)
+									c.M[a][b] += s[a] * dL[b];
+						}
+					}
+				}
 
-									double Rn = Rxyz.length();
+				int Split(std::vector<size_t>& order, size_t begin, size_t end)
+				{
+					BBox box;
+					for (size_t i = begin; i < end; i++)
+						box.extend(Point(quad.mx[order[i]], quad.my[order[i]], quad.mz[order[i]]));
+
+					const int index = static_cast<int>(clusters.size());
+					CoilCluster c;
+					c.begin = begin;
+					c.end = end;
+					c.left = c.right = -1;
+					c.center = Vector(box.center());
+					clusters.push_back(c);
+
+					if (end - begin > leafSize)
+					{
+						const Vector diag = box.diagonal();
+						const auto& coord = diag.x() >= diag.y() && diag.x() >= diag.z() ? quad.mx :
+							(diag.y() >= diag.z() ? quad.my : quad.mz);
+						const size_t mid = (begin + end) / 2;
+						std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+							[&coord](size_t i, size_t j) { return coord[i] < coord[j]; });
+
+						const int left = Split(order, begin, mid);
+						const int right = Split(order, mid, end);
+						clusters[index].left = left;
+						clusters[index].right = right;
+					}
+					return index;
+				}
 
-									//! check for distance between coil and model close to zero
-									//! it might cause numerical stability issues with respect to the cross-product
-									if(Rn < 0.00001)
-									{
-										algo_->warning("coil<->model distance approaching zero!");
-									}
+				//! Exact sum over all coil elements for a block of model nodes at a time. The
+				//! innermost loop runs over the nodes of the block, which keeps the summation
+				//! order per node unchanged and lets the compiler vectorize it.
+				void DirectKernel(const IndexRange& range)
+				{
+					double px[blockSize], py[blockSize], pz[blockSize];
+					double fx[blockSize], fy[blockSize], fz[blockSize];
+					double rmin[blockSize];
+					Point modelNode;
 
-									if(typeOut == 1)
-									{
-										//! Biot-Savart Magnetic Field
-										F +=  1.0e-7 * Cross( Rxyz, dLxyz ) * ( Abs(current) / (Rn*Rn*Rn) );
+					const double* mx = quad.mx.data();
+					const double* my = quad.my.data();
+					const double* mz = quad.mz.data();
+					const double* dx = quad.dx.data();
+					const double* dy = quad.dy.data();
+					const double* dz = quad.dz.data();
+					const double* w = quad.w.data();
+					const size_t numElements = quad.size();
 
-									}
+					for (size_t first = range.begin; first < range.end; first += blockSize)
+					{
+						const size_t count = std::min(blockSize, range.end - first);
 
-									if(typeOut == 2)
-									{
-										//! Biot-Savart Magnetic Vector Potential Field
-										F += 1.0e-7 * dLxyz * ( Abs(current) / (Rn) );
-									}
+						for (size_t t = 0; t < count; t++)
+						{
+							vmesh->get_node(modelNode, static_cast<VMesh::Node::index_type>(first + t));
+							px[t] = modelNode.x(); py[t] = modelNode.y(); pz[t] = modelNode.z();
+							fx[t] = fy[t] = fz[t] = 0.0;
+							rmin[t] = DBL_MAX;
+						}
 
-								}
+						for (size_t q = 0; q < numElements; q++)
+						{
+							const double qmx = mx[q], qmy = my[q], qmz = mz[q];
+							const double qdx = dx[q], qdy = dy[q], qdz = dz[q], qw = w[q];
 
+							if (typeOut == 1)
+							{
+								//! Biot-Savart Magnetic Field
+								for (size_t t = 0; t < count; t++)
+								{
+									const double rx = qmx - px[t], ry = qmy - py[t], rz = qmz - pz[t];
+									const double rn = std::sqrt(rx*rx + ry*ry + rz*rz);
+									const double s = qw / (rn*rn*rn);
+									fx[t] += (ry*qdz - rz*qdy) * s;
+									fy[t] += (rz*qdx - rx*qdz) * s;
+									fz[t] += (rx*qdy - ry*qdx) * s;
+									rmin[t] = std::min(rmin[t], rn);
+								}
 							}
-
-							matOut->put(iM,0, F[0]);
-							matOut->put(iM,1, F[1]);
-							matOut->put(iM,2, F[2]);
-
-							//! progress reporter
-							if (proc_num == 0)
+							else if (typeOut == 2)
 							{
-								cnt++;
-								if (cnt == 200)
+								//! Biot-Savart Magnetic Vector Potential Field
+								for (size_t t = 0; t < count; t++)
 								{
-									cnt = 0;
-									algo_->update_progress(iM/(ends-begins));
-						                  /// The progress bar update does not work ... and it also counts to iM/2 in other classes strange!
+									const double rx = qmx - px[t], ry = qmy - py[t], rz = qmz - pz[t];
+									const double rn = std::sqrt(rx*rx + ry*ry + rz*rz);
+									const double s = qw / rn;
+									fx[t] += qdx * s;
+									fy[t] += qdy * s;
+									fz[t] += qdz * s;
+									rmin[t] = std::min(rmin[t], rn);
 								}
 							}
 						}
 
-						success[proc_num] = true;
+						for (size_t t = 0; t < count; t++)
+						{
+							StoreResult(first + t, Vector(fx[t], fy[t], fz[t]), rmin[t]);
+						}
+						ReportProgress(count);
 					}
-					catch (...)
+				}
+
+				//! Barnes-Hut style traversal of the coil clusters for each model node
+				void TreeKernel(const IndexRange& range)
+				{
+					std::vector<int> stack;
+					stack.reserve(64);
+					Point modelNode;
+
+					for (size_t iM = range.begin; iM < range.end; iM++)
 					{
-						algo_->error(std::string("PieceWiseKernel crashed while integrating"));
-						success[proc_num] = false;
+						vmesh->get_node(modelNode, static_cast<VMesh::Node::index_type>(iM));
+						const Vector x(modelNode);
+						Vector F(0, 0, 0);
+						double rmin = DBL_MAX;
+
+						stack.clear();
+						stack.push_back(0);
+						while (!stack.empty())
+						{
+							const CoilCluster& c = clusters[stack.back()];
+							stack.pop_back();
+
+							const Vector R0 = c.center - x;
+							const double r0 = R0.length();
+
+							if (c.radius < theta * r0)
+							{
+								F += FarField(c, R0, r0);
+								rmin = std::min(rmin, r0 - c.radius);
+							}
+							else if (c.left < 0)
+							{
+								F += NearField(c, x, rmin);
+							}
+							else
+							{
+								stack.push_back(c.right);
+								stack.push_back(c.left);
+							}
+						}
+
+						StoreResult(iM, F, rmin);
+						if ((iM - range.begin) % blockSize == blockSize - 1)
+							ReportProgress(blockSize);
 					}
+				}
 
-					//! check point
-					barrier_.wait();
+				Vector NearField(const CoilCluster& c, const Vector& x, double& rmin) const
+				{
+					double fx = 0, fy = 0, fz = 0;
+					for (size_t q = c.begin; q < c.end; q++)
+					{
+						const double rx = quad.mx[q] - x.x(), ry = quad.my[q] - x.y(), rz = quad.mz[q] - x.z();
+						const double rn = std::sqrt(rx*rx + ry*ry + rz*rz);
+						rmin = std::min(rmin, rn);
+						if (typeOut == 1)
+						{
+							const double s = quad.w[q] / (rn*rn*rn);
+							fx += (ry*quad.dz[q] - rz*quad.dy[q]) * s;
+							fy += (rz*quad.dx[q] - rx*quad.dz[q]) * s;
+							fz += (rx*quad.dy[q] - ry*quad.dx[q]) * s;
+						}
+						else if (typeOut == 2)
+						{
+							const double s = quad.w[q] / rn;
+							fx += quad.dx[q] * s;
+							fy += quad.dy[q] * s;
+							fz += quad.dz[q] * s;
+						}
+					}
+					return Vector(fx, fy, fz);
+				}
 
-					// Bail out if one of the processes failed
-					for (size_t q=0; q<numprocessors_;q++)
-						if (success[q] == false) return;
+				//! First-order expansion of the cluster sum about its center, R0 = center - node
+				Vector FarField(const CoilCluster& c, const Vector& R0, double r0) const
+				{
+					const double r3 = r0 * r0 * r0;
+					if (typeOut == 1)
+					{
+						//! R/|R|^3 ~ R0/r0^3 + J s  with  J = (I - 3 R0 R0^T / r0^2) / r0^3
+						const double u[3] = { R0.x() / r0, R0.y() / r0, R0.z() / r0 };
+						double N[3][3];
+						for (int a = 0; a < 3; a++)
+							for (int b = 0; b < 3; b++)
+							{
+								N[a][b] = 0.0;
+								for (int d = 0; d < 3; d++)
+									N[a][b] += ((a == d ? 1.0 : 0.0) - 3.0 * u[a] * u[d]) * c.M[d][b];
+								N[a][b] /= r3;
+							}
+						return Cross(R0 / r3, c.Q) + Vector(N[1][2] - N[2][1], N[2][0] - N[0][2], N[0][1] - N[1][0]);
+					}
+					if (typeOut == 2)
+					{
+						//! 1/|R| ~ 1/r0 - R0.s / r0^3
+						Vector F = c.Q / r0;
+						for (int b = 0; b < 3; b++)
+							F[b] -= (R0.x() * c.M[0][b] + R0.y() * c.M[1][b] + R0.z() * c.M[2][b]) / r3;
+						return F;
+					}
+					return Vector(0, 0, 0);
+				}
 
+				void StoreResult(size_t iM, const Vector& F, double rmin)
+				{
+					//! check for distance between coil and model close to zero
+					//! it might cause numerical stability issues with respect to the cross-product
+					if (rmin < 0.00001)
+						nearZeroDistance = true;
+
+					matOut->put(iM,0, 1.0e-7 * F[0]);
+					matOut->put(iM,1, 1.0e-7 * F[1]);
+					matOut->put(iM,2, 1.0e-7 * F[2]);
+				}
+
+				void ReportProgress(size_t count)
+				{
+					const auto done = nodesDone += count;
+					std::unique_lock<std::mutex> lock(progressLock, std::try_to_lock);
+					if (lock.owns_lock())
+						algo_->update_progress(static_cast<double>(done) / modelSize);
 				}
 
 				//! Auto adjust accuracy of integration
@@ -722,12 +985,17 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
    return (false);
   }
 
+  const double openingAngle = get(Parameters::FarFieldOpeningAngle).toDouble();
+  if (!(openingAngle >= 0.0 && openingAngle < 1.0))
+    THROW_ALGORITHM_INPUT_ERROR("Far field opening angle must be at least 0 and less than 1, got " + boost::lexical_cast<std::string>(openingAngle));
+
   if( coil->vmesh()->is_curvemesh() )
   {
     if(coil->vfield()->is_constantdata() && coil->vfield()->is_scalar())
     {
-      auto pwk = std::unique_ptr<KernelBase>(new PieceWiseKernel(this, outtype));
+      auto pwk = std::unique_ptr<PieceWiseKernel>(new PieceWiseKernel(this, outtype));
       //pwk->SetIntegrationStep(this->istep);
+      pwk->SetFarFieldOpeningAngle(openingAngle);
       if( !pwk->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
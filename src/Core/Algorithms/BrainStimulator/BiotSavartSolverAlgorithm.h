@@ -57,6 +57,7 @@ namespace BrainStimulator {
  ALGORITHM_PARAMETER_DECL(VectorBField);
  ALGORITHM_PARAMETER_DECL(VectorAField);
  ALGORITHM_PARAMETER_DECL(OutType);
+ ALGORITHM_PARAMETER_DECL(FarFieldOpeningAngle);
 
   class SCISHARE BiotSavartSolverAlgorithm : public AlgorithmBase
   {
@@ -66,6 +67,7 @@ namespace BrainStimulator {
      //istep=0.0;
      //tfactor = 0;
      addParameter(Parameters::OutType,0);
+     addParameter(Parameters::FarFieldOpeningAngle,0.0);
     }
     AlgorithmOutput run(const AlgorithmInput& input) const override;
     bool run(FieldHandle mesh, FieldHandle coil, Datatypes::MatrixHandle &outdata, int outtype) const;
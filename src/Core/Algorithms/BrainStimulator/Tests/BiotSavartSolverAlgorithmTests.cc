@@ -0,0 +1,150 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  const double loopRadius = 0.05;
+
+  // Counterclockwise circular loop in the xy plane carrying 1 A.
+  FieldHandle CreateLoopCoil(int segments)
+  {
+    FieldInformation fi("CurveMesh", 0, "double");
+    auto coil = CreateField(fi);
+    auto mesh = coil->vmesh();
+    VMesh::Node::array_type edge(2);
+    for (int i = 0; i < segments; ++i)
+    {
+      const double phi = 2.0 * M_PI * i / segments;
+      mesh->add_point(Point(loopRadius * cos(phi), loopRadius * sin(phi), 0));
+    }
+    for (int i = 0; i < segments; ++i)
+    {
+      edge[0] = i;
+      edge[1] = (i + 1) % segments;
+      mesh->add_elem(edge);
+    }
+    coil->vfield()->resize_values();
+    coil->vfield()->set_all_values(1.0);
+    return coil;
+  }
+
+  FieldHandle CreatePoints(const std::vector<Point>& points)
+  {
+    FieldInformation fi("PointCloudMesh", 1, "double");
+    auto field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  DenseMatrixHandle Solve(FieldHandle mesh, FieldHandle coil, int outType, double angle)
+  {
+    BiotSavartSolverAlgorithm algo;
+    algo.set(Parameters::FarFieldOpeningAngle, angle);
+    MatrixHandle out;
+    EXPECT_TRUE(algo.run(mesh, coil, out, outType));
+    return castMatrix::toDense(out);
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTests, LoopFieldOnAxisMatchesAnalyticSolution)
+{
+  std::vector<Point> axis;
+  for (int i = 0; i < 10; ++i)
+    axis.push_back(Point(0, 0, 0.01 * i));
+
+  auto B = Solve(CreatePoints(axis), CreateLoopCoil(64), 1, 0.0);
+  ASSERT_EQ(axis.size(), B->nrows());
+
+  const double mu0 = 4.0e-7 * M_PI;
+  for (size_t i = 0; i < axis.size(); ++i)
+  {
+    const double z = axis[i].z();
+    const double expected = mu0 * loopRadius * loopRadius / (2.0 * pow(loopRadius * loopRadius + z * z, 1.5));
+    EXPECT_NEAR(0.0, (*B)(i, 0), 1e-3 * expected);
+    EXPECT_NEAR(0.0, (*B)(i, 1), 1e-3 * expected);
+    EXPECT_NEAR(expected, (*B)(i, 2), 2e-2 * expected);
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTests, FarFieldApproximationMatchesDirectSum)
+{
+  std::vector<Point> grid;
+  for (int i = 0; i < 8; ++i)
+    for (int j = 0; j < 8; ++j)
+      for (int k = 0; k < 8; ++k)
+        grid.push_back(Point(-0.1 + 0.03 * i, -0.1 + 0.03 * j, 0.02 + 0.03 * k));
+  auto mesh = CreatePoints(grid);
+  auto coil = CreateLoopCoil(64);
+
+  for (int outType : { 1, 2 })
+  {
+    auto exact = Solve(mesh, coil, outType, 0.0);
+    auto approx = Solve(mesh, coil, outType, 0.2);
+    ASSERT_EQ(exact->nrows(), approx->nrows());
+
+    // The error bound holds per cluster, not per node: where the loop's contributions
+    // cancel the node's own field can be much smaller than the error.
+    double maxNorm = 0;
+    for (size_t i = 0; i < exact->nrows(); ++i)
+      maxNorm = std::max(maxNorm, exact->row(i).norm());
+
+    for (size_t i = 0; i < exact->nrows(); ++i)
+      EXPECT_LT((exact->row(i) - approx->row(i)).norm(), 1e-2 * maxNorm);
+  }
+}
+
+TEST(BiotSavartSolverAlgorithmTests, RejectsOpeningAngleOutsideUnitInterval)
+{
+  auto mesh = CreatePoints({ Point(0, 0, 0.01) });
+  auto coil = CreateLoopCoil(8);
+  for (double angle : { -0.1, 1.0, 2.5 })
+  {
+    BiotSavartSolverAlgorithm algo;
+    algo.set(Parameters::FarFieldOpeningAngle, angle);
+    MatrixHandle out;
+    EXPECT_THROW(algo.run(mesh, coil, out, 1), Core::Algorithms::AlgorithmInputException);
+  }
+}
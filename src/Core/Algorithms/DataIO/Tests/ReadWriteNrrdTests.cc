@@ -30,6 +30,11 @@
 #include <Core/IEPlugin/NrrdField_Plugin.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Nrrd/NrrdData.h>
+#include <Core/Algorithms/Legacy/Converter/FieldToNrrd.h>
+#include <boost/weak_ptr.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
@@ -40,6 +45,25 @@ namespace
 {
   boost::filesystem::path testNrrd = TestResources::rootDir() / "ToolKits" / "FwdInvToolbox" / "pot_based_FEM_forward" / "Segmentation.nrrd";
   boost::filesystem::path testNrrdHeader = TestResources::rootDir() / "Fields" / "nrrd" / "fieldOut.nhdr";
+
+  // Node values are their own index, so any reordering or aliasing shows up.
+  FieldHandle indexedLatVol(data_info_type type, size_type size = 5)
+  {
+    FieldInformation fi(LATVOLMESH_E, LINEARDATA_E, type);
+    auto mesh = CreateMesh(fi, size, size + 1, size + 2, Geometry::Point(0, 0, 0), Geometry::Point(1, 1, 1));
+    auto field = CreateField(fi, mesh);
+    auto vfield = field->vfield();
+    for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+      vfield->set_value(static_cast<double>(i % 100), i);
+    return field;
+  }
+
+  double nodeValue(const FieldHandle& field, VMesh::index_type i)
+  {
+    double value;
+    field->vfield()->get_value(value, i);
+    return value;
+  }
 }
 
 TEST(ReadNrrdTests, CanReadFullNrrdFile)
@@ -127,3 +151,77 @@ TEST(WriteNrrdTests, CanWriteNrrdFileHeader)
   boost::filesystem::path out(TestResources::rootDir() / "TransientOutput" / "fieldOutUnitHeader.nhdr");
   ASSERT_TRUE(FieldToNrrd_writer(nullptr, field, out.string().c_str()));
 }
+
+TEST(FieldToNrrdSharingTests, NrrdOutlivesTheField)
+{
+  auto field = indexedLatVol(DOUBLE_E);
+  const auto numValues = field->vfield()->num_values();
+  NrrdDataHandle nrrd;
+  ASSERT_TRUE(Algorithms::FieldToNrrdAlgo().fieldToNrrd(nullptr, field, nrrd));
+  EXPECT_EQ(field->vfield()->get_values_pointer(), nrrd->getNrrd()->data);
+
+  boost::weak_ptr<Field> observer(field);
+  field.reset();
+  ASSERT_FALSE(observer.expired());
+
+  auto data = static_cast<const double*>(nrrd->getNrrd()->data);
+  for (VMesh::index_type i = 0; i < numValues; ++i)
+    ASSERT_EQ(i % 100, data[i]);
+
+  // the nrrd gives the storage back to the field instead of freeing it
+  nrrd.reset();
+  EXPECT_TRUE(observer.expired());
+}
+
+TEST(FieldToNrrdSharingTests, FieldOutlivesTheNrrd)
+{
+  auto field = indexedLatVol(DOUBLE_E);
+  NrrdDataHandle nrrd;
+  ASSERT_TRUE(Algorithms::FieldToNrrdAlgo().fieldToNrrd(nullptr, field, nrrd));
+  nrrd.reset();
+
+  ASSERT_TRUE(field->vfield()->get_values_pointer() != nullptr);
+  for (VMesh::index_type i = 0; i < field->vfield()->num_values(); ++i)
+    ASSERT_EQ(i % 100, nodeValue(field, i));
+}
+
+TEST(FieldToNrrdSharingTests, CloneIsIndependentOfTheField)
+{
+  auto field = indexedLatVol(DOUBLE_E);
+  NrrdDataHandle nrrd;
+  ASSERT_TRUE(Algorithms::FieldToNrrdAlgo().fieldToNrrd(nullptr, field, nrrd));
+
+  NrrdDataHandle copy(nrrd->clone());
+  ASSERT_NE(nrrd->getNrrd()->data, copy->getNrrd()->data);
+  auto copied = static_cast<double*>(copy->getNrrd()->data);
+
+  field->vfield()->set_value(-1.0, 0);
+  EXPECT_EQ(0, copied[0]);
+  copied[1] = -2;
+  EXPECT_EQ(1, nodeValue(field, 1));
+
+  // the copy owns its data, so freeing it leaves the field alone
+  copy.reset();
+  nrrd.reset();
+  EXPECT_EQ(-1, nodeValue(field, 0));
+  EXPECT_EQ(2, nodeValue(field, 2));
+}
+
+TEST(FieldToNrrdSharingTests, WrittenNonDoubleFieldsReadBackInBulk)
+{
+  // large enough that reading back fills the field in several parallel blocks
+  const size_type size = 40;
+  for (auto type : { CHAR_E, UNSIGNED_CHAR_E, SHORT_E, UNSIGNED_SHORT_E, INT_E, UNSIGNED_INT_E, FLOAT_E })
+  {
+    auto field = indexedLatVol(type, size);
+    boost::filesystem::path out(TestResources::rootDir() / "TransientOutput" / ("sharedField" + std::to_string(type) + ".nrrd"));
+    ASSERT_TRUE(FieldToNrrd_writer(nullptr, field, out.string().c_str()));
+
+    auto read = NrrdToField_reader(nullptr, out.string().c_str());
+    ASSERT_TRUE(read != nullptr);
+    ASSERT_EQ(field->vfield()->num_values(), read->vfield()->num_values());
+    EXPECT_EQ(field->vfield()->get_data_type(), read->vfield()->get_data_type());
+    for (VMesh::index_type i = 0; i < read->vfield()->num_values(); ++i)
+      ASSERT_EQ(i % 100, nodeValue(read, i)) << "type " << type << ", value " << i;
+  }
+}
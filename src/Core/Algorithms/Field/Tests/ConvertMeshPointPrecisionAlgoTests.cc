@@ -0,0 +1,162 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/ConvertMeshType/ConvertMeshPointPrecision.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  FieldHandle convertPrecision(FieldHandle input, const std::string& precision)
+  {
+    ConvertMeshPointPrecisionAlgo algo;
+    algo.setOption(Parameters::PointPrecision, precision);
+    FieldHandle output;
+    if (!algo.runImpl(input, output))
+      return FieldHandle();
+    return output;
+  }
+
+  void expectSameField(FieldHandle expected, FieldHandle actual)
+  {
+    VMesh* emesh = expected->vmesh();
+    VMesh* amesh = actual->vmesh();
+    ASSERT_EQ(emesh->num_nodes(), amesh->num_nodes());
+    ASSERT_EQ(emesh->num_elems(), amesh->num_elems());
+
+    Point ep, ap;
+    for (VMesh::Node::index_type i = 0; i < emesh->num_nodes(); ++i)
+    {
+      emesh->get_point(ep, i);
+      amesh->get_point(ap, i);
+      EXPECT_NEAR(ep.x(), ap.x(), 1e-6);
+      EXPECT_NEAR(ep.y(), ap.y(), 1e-6);
+      EXPECT_NEAR(ep.z(), ap.z(), 1e-6);
+    }
+
+    VMesh::Node::array_type enodes, anodes;
+    for (VMesh::Elem::index_type i = 0; i < emesh->num_elems(); ++i)
+    {
+      emesh->get_nodes(enodes, i);
+      amesh->get_nodes(anodes, i);
+      EXPECT_EQ(enodes, anodes);
+    }
+
+    ASSERT_EQ(expected->vfield()->num_values(), actual->vfield()->num_values());
+    double ev, av;
+    for (VMesh::index_type i = 0; i < expected->vfield()->num_values(); ++i)
+    {
+      expected->vfield()->get_value(ev, i);
+      actual->vfield()->get_value(av, i);
+      EXPECT_EQ(ev, av);
+    }
+  }
+}
+
+TEST(ConvertMeshPointPrecisionAlgoTests, TetVolRoundTripsThroughSinglePrecision)
+{
+  FieldHandle input = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  for (VMesh::index_type i = 0; i < input->vfield()->num_values(); ++i)
+    input->vfield()->set_value(static_cast<double>(i + 1), i);
+
+  FieldHandle single = convertPrecision(input, "float");
+  ASSERT_TRUE(single != nullptr);
+  FieldInformation fi(single);
+  EXPECT_TRUE(fi.is_float_points());
+  EXPECT_EQ("TetVolMesh<TetLinearLgn<PointF>>", fi.get_mesh_type_id());
+  EXPECT_TRUE(single->vmesh()->get_points_pointer() == nullptr);
+  expectSameField(input, single);
+
+  FieldHandle back = convertPrecision(single, "double");
+  ASSERT_TRUE(back != nullptr);
+  EXPECT_FALSE(FieldInformation(back).is_float_points());
+  expectSameField(input, back);
+}
+
+TEST(ConvertMeshPointPrecisionAlgoTests, SinglePrecisionMeshInterpolatesLikeDoubleMesh)
+{
+  FieldHandle input = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  for (VMesh::index_type i = 0; i < input->vfield()->num_values(); ++i)
+    input->vfield()->set_value(static_cast<double>(i + 1), i);
+  FieldHandle single = convertPrecision(input, "float");
+  ASSERT_TRUE(single != nullptr);
+
+  input->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+  single->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+
+  const Point p(0.5, 0.4, 0.2);
+  VMesh::Elem::index_type delem, selem;
+  ASSERT_TRUE(input->vmesh()->locate(delem, p));
+  ASSERT_TRUE(single->vmesh()->locate(selem, p));
+  EXPECT_EQ(delem, selem);
+
+  double dval, sval;
+  ASSERT_TRUE(input->vfield()->interpolate(dval, p));
+  ASSERT_TRUE(single->vfield()->interpolate(sval, p));
+  EXPECT_NEAR(dval, sval, 1e-6);
+}
+
+TEST(ConvertMeshPointPrecisionAlgoTests, TriSurfConvertsToSinglePrecision)
+{
+  FieldHandle input = CubeTriSurfLinearBasis(DOUBLE_E);
+  FieldHandle single = convertPrecision(input, "float");
+  ASSERT_TRUE(single != nullptr);
+  EXPECT_EQ("TriSurfMesh<TriLinearLgn<PointF>>", FieldInformation(single).get_mesh_type_id());
+  expectSameField(input, single);
+}
+
+TEST(ConvertMeshPointPrecisionAlgoTests, StructuredMeshesStayInDoublePrecision)
+{
+  FieldHandle input = CreateEmptyLatVol();
+  EXPECT_TRUE(convertPrecision(input, "float") == nullptr);
+}
+
+TEST(ConvertMeshPointPrecisionAlgoTests, DerivedMeshTypesFallBackToDoublePrecision)
+{
+  FieldInformation fi(convertPrecision(TetrahedronTetVolLinearBasis(DOUBLE_E), "float"));
+
+  fi.make_trisurfmesh();
+  fi.make_linearmesh();
+  EXPECT_EQ("TriSurfMesh<TriLinearLgn<PointF>>", fi.get_mesh_type_id());
+
+  fi.make_curvemesh();
+  fi.make_linearmesh();
+  EXPECT_EQ("CurveMesh<CrvLinearLgn<Point>>", fi.get_mesh_type_id());
+  EXPECT_TRUE(CreateField(fi) != nullptr);
+}
@@ -35,6 +35,10 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/ExtractSimpleIsosurfaceAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -44,6 +48,7 @@
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::TestUtils;
 
@@ -101,3 +106,95 @@ TEST(ExtractSimpleIsoSurfaceAlgoTest, ExtractSimpleIsoSurf_LatVol_DataOnNodes)
   EXPECT_EQ(output->vmesh()->num_elems(),3);
   EXPECT_EQ(output->vfield()->num_values(),5);
 }
+
+namespace
+{
+  FieldHandle SphereDistanceLatVol(size_type n)
+  {
+    FieldHandle field = CreateEmptyLatVol(n, n, n);
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+    {
+      Point p;
+      mesh->get_center(p, i);
+      vfield->set_value(Vector(p).length(), i);
+    }
+    return field;
+  }
+
+  FieldHandle RunMarchingCubes(FieldHandle input, int threads, MatrixHandle& nodeInterpolant, MatrixHandle& elemInterpolant)
+  {
+    MarchingCubesAlgo algo;
+    algo.set(MarchingCubesAlgo::build_field, true);
+    algo.set(MarchingCubesAlgo::build_node_interpolant, true);
+    algo.set(MarchingCubesAlgo::build_elem_interpolant, true);
+    algo.set(MarchingCubesAlgo::num_threads, threads);
+    FieldHandle output;
+    algo.run(input, std::vector<double>(1, 0.5), output, nodeInterpolant, elemInterpolant);
+    return output;
+  }
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ThreadedMarchingCubesStitchesSharedVertices)
+{
+  auto input = SphereDistanceLatVol(30);
+
+  MatrixHandle serialNodes, serialElems, threadedNodes, threadedElems;
+  auto serial = RunMarchingCubes(input, 1, serialNodes, serialElems);
+  auto threaded = RunMarchingCubes(input, 8, threadedNodes, threadedElems);
+
+  ASSERT_TRUE(serial != nullptr);
+  ASSERT_TRUE(threaded != nullptr);
+  EXPECT_GT(serial->vmesh()->num_nodes(), 0);
+  EXPECT_EQ(serial->vmesh()->num_nodes(), threaded->vmesh()->num_nodes());
+  EXPECT_EQ(serial->vmesh()->num_elems(), threaded->vmesh()->num_elems());
+  EXPECT_EQ(threaded->vmesh()->num_nodes(), threaded->vfield()->num_values());
+
+  ASSERT_TRUE(threadedNodes != nullptr);
+  ASSERT_TRUE(threadedElems != nullptr);
+  EXPECT_EQ(threaded->vmesh()->num_nodes(), threadedNodes->nrows());
+  EXPECT_EQ(input->vmesh()->num_nodes(), threadedNodes->ncols());
+  EXPECT_EQ(threaded->vmesh()->num_elems(), threadedElems->nrows());
+  EXPECT_EQ(input->vmesh()->num_elems(), threadedElems->ncols());
+
+  // every output vertex is a convex combination of input nodes
+  auto sparse = castMatrix::toSparse(threadedNodes);
+  ASSERT_TRUE(sparse != nullptr);
+  for (int r = 0; r < sparse->rows(); ++r)
+    EXPECT_NEAR(1.0, sparse->row(r).sum(), 1e-12);
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ThreadedMarchingCubesMatchesSerialGeometry)
+{
+  auto input = SphereDistanceLatVol(30);
+
+  MatrixHandle serialNodes, serialElems;
+  auto serial = RunMarchingCubes(input, 1, serialNodes, serialElems);
+  VMesh* smesh = serial->vmesh();
+
+  for (int threads : { 2, 3, 8 })
+  {
+    MatrixHandle threadedNodes, threadedElems;
+    auto threaded = RunMarchingCubes(input, threads, threadedNodes, threadedElems);
+    VMesh* tmesh = threaded->vmesh();
+    ASSERT_EQ(smesh->num_nodes(), tmesh->num_nodes()) << threads;
+    ASSERT_EQ(smesh->num_elems(), tmesh->num_elems()) << threads;
+
+    // threads take consecutive element ranges, so stitching keeps the serial numbering
+    for (VMesh::Node::index_type i = 0; i < smesh->num_nodes(); ++i)
+    {
+      Point ps, pt;
+      smesh->get_center(ps, i);
+      tmesh->get_center(pt, i);
+      ASSERT_NEAR(0.0, (ps - pt).length(), 1e-12) << threads << " threads, node " << i;
+    }
+    for (VMesh::Elem::index_type e = 0; e < smesh->num_elems(); ++e)
+    {
+      VMesh::Node::array_type ns, nt;
+      smesh->get_nodes(ns, e);
+      tmesh->get_nodes(nt, e);
+      ASSERT_EQ(ns, nt) << threads << " threads, element " << e;
+    }
+  }
+}
@@ -288,3 +288,48 @@ TEST(GenerateStreamLinesTests, ManySeedsMultithreadedStreamlineLength)
     EXPECT_NEAR(max, meshOutputByMethodTotalLength[method].second, 1e-1);
   }
 }
+
+TEST(GenerateStreamLinesTests, MultithreadedOutputMatchesSingleThreaded)
+{
+  auto torsoSeeds = LoadTorsoSeeds();
+  auto torso = LoadTorso();
+
+  for (const auto& method : methods)
+  {
+    FieldHandle serialOutput, parallelOutput;
+    {
+      GenerateStreamLinesAlgo algo;
+      algo.set(Parameters::UseMultithreading, false);
+      algo.set(Parameters::StreamlineMaxSteps, 200);
+      algo.setOption(Parameters::StreamlineValue, "Distance from seed");
+      algo.setOption(Parameters::StreamlineMethod, method);
+      ASSERT_TRUE(algo.runImpl(torso, torsoSeeds, serialOutput));
+    }
+    {
+      GenerateStreamLinesAlgo algo;
+      algo.set(Parameters::UseMultithreading, true);
+      algo.set(Parameters::StreamlineMaxSteps, 200);
+      algo.setOption(Parameters::StreamlineValue, "Distance from seed");
+      algo.setOption(Parameters::StreamlineMethod, method);
+      ASSERT_TRUE(algo.runImpl(torso, torsoSeeds, parallelOutput));
+    }
+
+    auto serialMesh = serialOutput->vmesh();
+    auto parallelMesh = parallelOutput->vmesh();
+    ASSERT_EQ(serialMesh->num_nodes(), parallelMesh->num_nodes());
+    ASSERT_EQ(serialMesh->num_elems(), parallelMesh->num_elems());
+
+    // Streamlines are assembled in seed order regardless of which thread traced them.
+    for (VMesh::Node::index_type i = 0; i < serialMesh->num_nodes(); ++i)
+    {
+      Point p, q;
+      double a, b;
+      serialMesh->get_point(p, i);
+      parallelMesh->get_point(q, i);
+      serialOutput->vfield()->get_value(a, i);
+      parallelOutput->vfield()->get_value(b, i);
+      ASSERT_EQ(p, q);
+      ASSERT_EQ(a, b);
+    }
+  }
+}
@@ -260,8 +260,23 @@ ConvertToNrrdAlgo::runImpl(FieldHandle input, NrrdDataHandle& points,
     {
       size_t size[NRRD_DIM_MAX];
       unsigned int centers[NRRD_DIM_MAX];
-      for (size_t j=0;j<dataDims.size(); j++) size[j] = dataDims[j];
-      nrrdAlloc_nva(data->getNrrd(), nrrdtype, dataDims.size(), size);
+      size_t num_data = 1;
+      for (size_t j=0;j<dataDims.size(); j++) { size[j] = dataDims[j]; num_data *= dataDims[j]; }
+
+      // Scalar values are stored contiguously in the nrrd's own type, so the
+      // nrrd shares the field's storage instead of copying it.
+      VField::size_type num_values = field->num_values();
+      void* values = field->get_values_pointer();
+      const bool shared = values && num_data == static_cast<size_t>(num_values);
+      if (shared)
+      {
+        data.reset(new NrrdData(input));
+        nrrdWrap_nva(data->getNrrd(), values, nrrdtype, dataDims.size(), size);
+      }
+      else
+      {
+        nrrdAlloc_nva(data->getNrrd(), nrrdtype, dataDims.size(), size);
+      }
 
       if (field->basis_order() == 1)
       {
@@ -306,27 +321,29 @@ ConvertToNrrdAlgo::runImpl(FieldHandle input, NrrdDataHandle& points,
 
       for (size_t j=0;j<dataDims.size(); j++) data->getNrrd()->axis[j].kind = nrrdKindDomain;
 
-      VField::size_type num_values = field->num_values();
-      if (field->is_char())
-        field->get_values(reinterpret_cast<char*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_char())
-        field->get_values(reinterpret_cast<unsigned char*>(data->getNrrd()->data),num_values);
-      if (field->is_short())
-        field->get_values(reinterpret_cast<short*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_short())
-        field->get_values(reinterpret_cast<unsigned short*>(data->getNrrd()->data),num_values);
-      if (field->is_int())
-        field->get_values(reinterpret_cast<int*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_int())
-        field->get_values(reinterpret_cast<unsigned int*>(data->getNrrd()->data),num_values);
-      if (field->is_longlong())
-        field->get_values(reinterpret_cast<long long*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_longlong())
-        field->get_values(reinterpret_cast<unsigned long long*>(data->getNrrd()->data),num_values);
-      if (field->is_float())
-        field->get_values(reinterpret_cast<float*>(data->getNrrd()->data),num_values);
-      if (field->is_double())
-        field->get_values(reinterpret_cast<double*>(data->getNrrd()->data),num_values);
+      if (!shared)
+      {
+        if (field->is_char())
+          field->get_values(reinterpret_cast<char*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_char())
+          field->get_values(reinterpret_cast<unsigned char*>(data->getNrrd()->data),num_values);
+        if (field->is_short())
+          field->get_values(reinterpret_cast<short*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_short())
+          field->get_values(reinterpret_cast<unsigned short*>(data->getNrrd()->data),num_values);
+        if (field->is_int())
+          field->get_values(reinterpret_cast<int*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_int())
+          field->get_values(reinterpret_cast<unsigned int*>(data->getNrrd()->data),num_values);
+        if (field->is_longlong())
+          field->get_values(reinterpret_cast<long long*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_longlong())
+          field->get_values(reinterpret_cast<unsigned long long*>(data->getNrrd()->data),num_values);
+        if (field->is_float())
+          field->get_values(reinterpret_cast<float*>(data->getNrrd()->data),num_values);
+        if (field->is_double())
+          field->get_values(reinterpret_cast<double*>(data->getNrrd()->data),num_values);
+      }
     }
     else
     {
@@ -60,7 +60,9 @@ public:
 template<class T>
 bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, NrrdDataHandle& output,int datatype)
 {
-  output.reset(new NrrdData());
+  // The nrrd shares the field's value storage, which is laid out exactly as
+  // the nrrd expects.
+  output.reset(new NrrdData(input));
 
   Nrrd* nrrd = output->getNrrd();
 
@@ -90,16 +92,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
     dim[2] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_nodes());
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -117,16 +117,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
     dim[2] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_elems());
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -142,16 +140,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     nrrddim = 2;
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_nodes());
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -167,16 +163,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     nrrddim = 2;
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_elems());
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -191,16 +185,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
 
     nrrddim = 1;
     dim[0] = static_cast<size_t>(sz[0]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_nodes());
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -216,16 +208,14 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
 
     nrrddim = 1;
     dim[0] = static_cast<size_t>(sz[0]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),datatype,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_elems());
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -276,7 +266,10 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
 
 bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, NrrdDataHandle& output)
 {
-  output.reset(new NrrdData());
+  // Vectors are stored as three consecutive doubles, so the nrrd can share
+  // the field's value storage with the vector components on the first axis.
+  static_assert(sizeof(Vector) == 3*sizeof(double), "Vector is not packed");
+  output.reset(new NrrdData(input));
 
   Nrrd* nrrd = output->getNrrd();
 
@@ -306,30 +299,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[1] = static_cast<size_t>(sz[0]);
     dim[2] = static_cast<size_t>(sz[1]);
     dim[3] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Node::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -347,30 +324,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[1] = static_cast<size_t>(sz[0]);
     dim[2] = static_cast<size_t>(sz[1]);
     dim[3] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Elem::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -387,30 +348,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     nrrddim = 3; dim[0] = 3;
     dim[1] = static_cast<size_t>(sz[0]);
     dim[2] = static_cast<size_t>(sz[1]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Node::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -427,30 +372,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     nrrddim = 3; dim[0] = 3;
     dim[1] = static_cast<size_t>(sz[0]);
     dim[2] = static_cast<size_t>(sz[1]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Elem::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -466,30 +395,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
 
     nrrddim = 2; dim[0] = 3;
     dim[1] = static_cast<size_t>(sz[0]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Node::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
   }
@@ -505,30 +418,14 @@ bool FieldToNrrdAlgoT::vectorFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
 
     nrrddim = 2; dim[0] = 3;
     dim[1] = static_cast<size_t>(sz[0]);
-    nrrdAlloc_nva(nrrd,nrrdTypeDouble,nrrddim,dim);
+    nrrdWrap_nva(nrrd,field->get_values_pointer(),nrrdTypeDouble,nrrddim,dim);
 
     if (nrrd->data == 0)
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+      pr->error("FieldToNrrd: Input field does not contain any data");
       return (false);
     }
 
-    VMesh::Elem::iterator it, it_end;
-    mesh->begin(it);
-    mesh->end(it_end);
-    size_t k = 0;
-
-    double* data = reinterpret_cast<double*>(nrrd->data);
-    while (it != it_end)
-    {
-      Vector v;
-      field->get_value(v,*it);
-      data[k] = v.x(); k++;
-      data[k] = v.y(); k++;
-      data[k] = v.z(); k++;
-      ++it;
-    }
-
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
   }
@@ -36,11 +36,13 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/Algorithms/Legacy/Converter/NrrdToField.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Logging;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 namespace detail {
 class NrrdToFieldAlgoT {
@@ -64,6 +66,19 @@ public:
   bool nrrdToTensorField(LoggerHandle pr,NrrdDataHandle input, FieldHandle& output,const std::string& datalocation, const std::string& spaceparity,int tendim = -1);
 };
 
+// Scalar nrrds are ordered exactly like the value storage of the regular
+// fields built from them, so values are moved with bulk set_values calls on
+// disjoint blocks that are copied in parallel.
+template<class T>
+void copyNrrdValues(VField* vfield, const T* dataptr)
+{
+  Parallel::For(IndexRange(0, vfield->num_values()), 1 << 16, [vfield, dataptr](const IndexRange& range)
+  {
+    vfield->set_values(dataptr + range.begin, static_cast<VMesh::size_type>(range.size()),
+                       static_cast<VMesh::index_type>(range.begin));
+  });
+}
+
 // Templated converter for Scalar data so we can use every type supported by the Teem library
 template<class T>
 bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHandle& output,const std::string& datalocation, const std::string& spaceparity)
@@ -326,8 +341,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
 
   if (rdim == 1)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(SCANLINEMESH_E,LINEARDATA_E,DOUBLE_E);
@@ -339,16 +352,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
 
       if (use_tf)
       {
@@ -368,15 +372,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
       if (use_tf)
       {
         Transform trans = vmesh->get_transform();
@@ -392,8 +388,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
   }
   else if (rdim == 2)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(IMAGEMESH_E,LINEARDATA_E,DOUBLE_E);
@@ -405,16 +399,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
 
       if (use_tf)
       {
@@ -434,15 +419,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
       if (use_tf)
       {
         Transform trans = vmesh->get_transform();
@@ -458,8 +435,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
   }
   else if (rdim == 3)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(LATVOLMESH_E,LINEARDATA_E,DOUBLE_E);
@@ -471,16 +446,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
 
       if (use_tf)
       {
@@ -500,15 +466,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      copyNrrdValues(vfield,dataptr);
 
       if (use_tf)
       {
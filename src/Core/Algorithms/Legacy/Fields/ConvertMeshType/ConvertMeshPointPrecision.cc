@@ -0,0 +1,124 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/ConvertMeshType/ConvertMeshPointPrecision.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Utility;
+using namespace SCIRun::Core::Algorithms;
+
+ALGORITHM_PARAMETER_DEF(Fields, PointPrecision);
+
+ConvertMeshPointPrecisionAlgo::ConvertMeshPointPrecisionAlgo()
+{
+  addOption(Parameters::PointPrecision, "float", "float|double");
+}
+
+bool
+ConvertMeshPointPrecisionAlgo::runImpl(FieldHandle input, FieldHandle& output) const
+{
+  ScopedAlgorithmStatusReporter asr(this, "ConvertMeshPointPrecision");
+
+  if (!input)
+  {
+    error("No input field");
+    return (false);
+  }
+
+  FieldInformation fi(input);
+  FieldInformation fo(input);
+
+  if (getOption(Parameters::PointPrecision) == "float")
+  {
+    if (!fo.make_float_points())
+    {
+      error("Single precision nodes are only supported for linear TriSurf, TetVol and HexVol meshes");
+      return (false);
+    }
+  }
+  else
+  {
+    fo.make_double_points();
+  }
+
+  if (fo.get_point_type() == fi.get_point_type())
+  {
+    remark("The input mesh already has the requested precision; copying input to output");
+    output = input;
+    return (true);
+  }
+
+  output = CreateField(fo);
+  if (!output)
+  {
+    error("Could not create output field");
+    return (false);
+  }
+
+  VField* ifield = input->vfield();
+  VMesh*  imesh  = input->vmesh();
+  VField* ofield = output->vfield();
+  VMesh*  omesh  = output->vmesh();
+
+  // Both meshes are unstructured and of the same type, so the element
+  // arrays are identical and only the nodes need converting.
+  const VMesh::size_type num_elems = imesh->num_elems();
+
+  omesh->copy_nodes(imesh);
+
+  omesh->resize_elems(num_elems);
+  omesh->copy_elems(imesh);
+
+  ofield->resize_values();
+  if (ifield->basis_order() != -1) ofield->copy_values(ifield);
+
+  CopyProperties(*input, *output);
+
+  return (true);
+}
+
+AlgorithmOutput ConvertMeshPointPrecisionAlgo::run(const AlgorithmInput& input) const
+{
+  auto field = input.get<Field>(Variables::InputField);
+
+  FieldHandle outputField;
+  if (!runImpl(field, outputField))
+    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
+
+  AlgorithmOutput output;
+  output[Variables::OutputField] = outputField;
+  return output;
+}
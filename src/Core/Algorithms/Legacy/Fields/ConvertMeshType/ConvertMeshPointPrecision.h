@@ -0,0 +1,60 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_CONVERTMESHTYPE_CONVERTMESHPOINTPRECISION_H
+#define CORE_ALGORITHMS_FIELDS_CONVERTMESHTYPE_CONVERTMESHPOINTPRECISION_H 1
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        ALGORITHM_PARAMETER_DECL(PointPrecision);
+
+        /// Copy a field into a mesh that stores its nodes in single ("float")
+        /// or double ("double") precision. Single precision nodes are only
+        /// available for linear TriSurf, TetVol and HexVol meshes. Field data
+        /// keeps its type; use ConvertFieldDataType to change it.
+        class SCISHARE ConvertMeshPointPrecisionAlgo : public AlgorithmBase
+        {
+        public:
+          ConvertMeshPointPrecisionAlgo();
+          bool runImpl(FieldHandle input, FieldHandle& output) const;
+
+          virtual AlgorithmOutput run(const AlgorithmInput& input) const override;
+        };
+
+      }
+    }
+  }
+}
+#endif
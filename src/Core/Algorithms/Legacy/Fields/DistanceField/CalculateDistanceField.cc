@@ -32,6 +32,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Parallel.h>
 
@@ -66,10 +67,12 @@ class CalculateDistanceFieldP : public Interruptible
 {
   public:
     CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField*  ofield, const AlgorithmBase* algo) :
-      imesh(imesh), objmesh(objmesh), objfield(0), ofield(ofield), vfield(0), algo_(algo) {}
+      imesh(imesh), objmesh(objmesh), objfield(0), ofield(ofield), vfield(0), algo_(algo),
+      bvh_(objmesh->get_surface_bvh()) {}
 
     CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField* objfield, VField*  ofield, VField* vfield, const AlgorithmBase* algo) :
-      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), algo_(algo)  {}
+      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), algo_(algo),
+      bvh_(objmesh->get_surface_bvh()) {}
 
     void parallel(int proc, int nproc)
     {
@@ -96,7 +99,7 @@ class CalculateDistanceFieldP : public Interruptible
           checkForInterruption();
           Point p, p2;
           imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
+          if(!(find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
 
           if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
@@ -113,7 +116,7 @@ class CalculateDistanceFieldP : public Interruptible
           checkForInterruption();
           Point p, p2;
           imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
+          if(!(find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
 
           if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
@@ -130,7 +133,7 @@ class CalculateDistanceFieldP : public Interruptible
           checkForInterruption();
           Point p, p2;
           imesh->get_center(p,idx);
-          if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
+          if(!(find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
 
           if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
@@ -168,7 +171,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
@@ -183,7 +186,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
@@ -198,7 +201,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
@@ -222,7 +225,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
@@ -238,7 +241,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
@@ -254,7 +257,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
@@ -278,7 +281,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
@@ -293,7 +296,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
@@ -308,7 +311,7 @@ class CalculateDistanceFieldP : public Interruptible
           {
             checkForInterruption();
             imesh->get_center(p,idx);
-            objmesh->find_closest_elem(val,p2,coords,fidx,p);
+            find_closest_elem(val,p2,coords,fidx,p);
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
@@ -331,12 +334,34 @@ class CalculateDistanceFieldP : public Interruptible
     }
 
   private:
+    /// Surface meshes provide a BVH, which is searched without the global
+    /// locks of the mesh's own search grid.
+    bool find_closest_elem(double& val, Point& p2, VMesh::Elem::index_type& fidx,
+                           const Point& p, double maxdist) const
+    {
+      if (!bvh_) return objmesh->find_closest_elem(val,p2,fidx,p,maxdist);
+      index_type elem = 0;
+      if (!bvh_->find_closest_elem(val,p2,elem,p,maxdist)) return false;
+      fidx = elem;
+      return true;
+    }
+
+    bool find_closest_elem(double& val, Point& p2, VMesh::coords_type& coords,
+                           VMesh::Elem::index_type& fidx, const Point& p) const
+    {
+      if (!bvh_) return objmesh->find_closest_elem(val,p2,coords,fidx,p);
+      if (!find_closest_elem(val,p2,fidx,p,DBL_MAX)) return false;
+      objmesh->get_coords(coords,p2,fidx);
+      return true;
+    }
+
     VMesh*   imesh;
     VMesh*   objmesh;
     VField*  objfield;
     VField*  ofield;
     VField*  vfield;
     const AlgorithmBase* algo_;
+    boost::shared_ptr<SurfaceBVH> bvh_;
 };
 }
 
@@ -396,7 +421,9 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+  objmesh->synchronize(Mesh::SURFACE_BVH_E);
+  if (!objmesh->get_surface_bvh())
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
 
   if (ofield->basis_order() > 2)
   {
@@ -481,7 +508,9 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+  objmesh->synchronize(Mesh::SURFACE_BVH_E);
+  if (!objmesh->get_surface_bvh())
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
 
   if (distance->basis_order() > 2)
   {
@@ -31,12 +31,16 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
@@ -126,14 +130,20 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
 
   ofield->set_all_values(outside_value);
 
-  objmesh->synchronize(Mesh::ELEM_LOCATE_E);
+  // Closed surfaces are tested with the winding number of their BVH; volume
+  // meshes are tested by locating the point in one of their elements.
+  objmesh->synchronize(Mesh::SURFACE_BVH_E);
+  boost::shared_ptr<SurfaceBVH> bvh = objmesh->get_surface_bvh();
+  if (!bvh) objmesh->synchronize(Mesh::ELEM_LOCATE_E);
 
-  VMesh::size_type num_elems = omesh->num_elems();
-  VMesh::Node::array_type nodes;
-  VMesh::Elem::index_type cidx;
+  auto point_inside = [objmesh, bvh](const Point& p) -> bool
+  {
+    if (bvh) return bvh->is_inside(p);
+    VMesh::Elem::index_type cidx;
+    return objmesh->locate(cidx,p);
+  };
 
-  std::vector<Point> points;
-  std::vector<Point> points2;
+  VMesh::size_type num_elems = omesh->num_elems();
 
   std::vector<VMesh::coords_type> coords;
   std::vector<double> weights;
@@ -147,93 +157,49 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
 
   std::string method = getOption(Parameters::CalcInsideMethod);
 
-  if (method == "one")
+  // Elements are classified independently and each writes only its own value.
+  Parallel::For(IndexRange(0, num_elems), 0, [&](const IndexRange& range)
   {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
+    VMesh::Node::array_type nodes;
+    std::vector<Point> points;
+    std::vector<Point> points2;
+
+    for (VMesh::Elem::index_type idx=range.begin; idx<static_cast<VMesh::index_type>(range.end); idx++)
     {
       omesh->get_nodes(nodes,idx);
       omesh->get_centers(points,nodes);
       omesh->minterpolate(points2,coords,idx);
 
-      bool is_inside = false;
-
-      for (size_t r=0; r< points2.size(); r++)
+      bool is_inside;
+      if (method == "one")
       {
-        if (objmesh->locate(cidx,points2[r]))
-        {
-          is_inside = true; break;
-        }
+        is_inside = std::any_of(points2.begin(),points2.end(),point_inside) ||
+                    std::any_of(points.begin(),points.end(),point_inside);
       }
-
-      if (!is_inside)
+      else if (method == "all")
       {
-        for (size_t r=0; r< points.size(); r++)
-        {
-          if (objmesh->locate(cidx,points[r]))
-          {
-            is_inside = true; break;
-          }
-        }
+        is_inside = std::all_of(points2.begin(),points2.end(),point_inside) &&
+                    std::all_of(points.begin(),points.end(),point_inside);
       }
-
-      if (is_inside) ofield->set_value(inside_value,idx);
-    }
-  }
-  else if (method == "all")
-  {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-    {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
-
-      bool is_inside = true;
-
-      for (size_t r=0; r< points2.size(); r++)
+      else
       {
-        if (!(objmesh->locate(cidx,points2[r])))
+        int outside = 0;
+        int inside = 0;
+        for (size_t r=0; r< points2.size(); r++)
         {
-          is_inside = false; break;
+          if (point_inside(points2[r])) inside++; else outside++;
         }
-      }
 
-      if (is_inside)
-      {
         for (size_t r=0; r< points.size(); r++)
         {
-          if (!(objmesh->locate(cidx,points[r])))
-          {
-            is_inside = false; break;
-          }
+          if (point_inside(points[r])) inside++; else outside++;
         }
+        is_inside = inside >= outside;
       }
 
       if (is_inside) ofield->set_value(inside_value,idx);
     }
-  }
-  else
-  {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-    {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
-
-      int outside = 0;
-      int inside = 0;
-      for (size_t r=0; r< points2.size(); r++)
-      {
-        if (objmesh->locate(cidx,points2[r])) inside++; else outside++;
-      }
-
-      for (size_t r=0; r< points.size(); r++)
-      {
-        if (objmesh->locate(cidx,points[r])) inside++; else outside++;
-      }
-
-      if (inside >= outside) ofield->set_value(inside_value,idx);
-    }
-  }
+  });
 
   return (true);
 }
@@ -31,6 +31,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
 #include <Core/Thread/Parallel.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 
@@ -46,367 +47,68 @@ class CalculateSignedDistanceFieldP : public Interruptible
 {
   public:
     CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField*  ofield, const ProgressReporter* pr) :
-      imesh(imesh), objmesh(objmesh), ofield(ofield), pr_(pr) {}
+      imesh(imesh), objmesh(objmesh), objfield(0), ofield(ofield), vfield(0), pr_(pr),
+      bvh_(objmesh->get_surface_bvh()), epsilon_(objmesh->get_epsilon()) {}
 
     CalculateSignedDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField* objfield,
             VField* ofield, VField* vfield, const ProgressReporter* pr) :
-      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), pr_(pr) {}
+      imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), pr_(pr),
+      bvh_(objmesh->get_surface_bvh()), epsilon_(objmesh->get_epsilon()) {}
 
     void parallel(int proc, int nproc)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
-
-      double val = 0.0;
-      double epsilon = objmesh->get_epsilon();
-      int cnt = 0;
-
-      if (ofield->basis_order() == 0)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Elem::index_type idx = start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-
-          objmesh->find_closest_elem(val,p2,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
-      else if (ofield->basis_order() == 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Node::index_type idx =start; idx <end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
-      else if (ofield->basis_order() > 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
+      run(proc, nproc, false);
+    }
 
-        for (VMesh::ENode::index_type idx=start; idx < end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
+    void parallel2(int proc, int nproc)
+    {
+      run(proc, nproc, true);
+    }
 
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_evalue(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
+    void range(int proc, int nproc,
+               VMesh::index_type& start, VMesh::index_type& end,
+               VMesh::size_type size)
+    {
+      VMesh::size_type m = size/nproc;
+      start = proc*m;
+      end = (proc+1)*m;
+      if (proc == nproc-1) end = size;
     }
 
-    void parallel2(int proc, int nproc)
+  private:
+    /// Distance to the object surface for every output value; with
+    /// interpolate_values the object field is also sampled at the closest point.
+    void run(int proc, int nproc, bool interpolate_values)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
+      const int basis_order = ofield->basis_order();
+      const VMesh::size_type num_values = basis_order > 1 ? ofield->num_evalues() : ofield->num_values();
+
+      VMesh::index_type start, end;
+      range(proc,nproc,start,end,num_values);
 
-      double val = 0.0;
-      double epsilon = objmesh->get_epsilon();
+      VMesh::coords_type coords;
       int cnt = 0;
 
-      if (ofield->basis_order() == 0)
+      for (VMesh::index_type idx = start; idx < end; idx++)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
-
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
-
-        for (VMesh::Elem::index_type idx = start; idx < end; idx++)
+        checkForInterruption();
+        Point p, p2;
+        if (basis_order == 0) imesh->get_center(p,VMesh::Elem::index_type(idx));
+        else if (basis_order == 1) imesh->get_center(p,VMesh::Node::index_type(idx));
+        else imesh->get_center(p,VMesh::ENode::index_type(idx));
+
+        double val = 0.0;
+        VMesh::Elem::index_type fidx;
+        find_closest_elem(val,p2,fidx,p);
+        val = apply_sign(val,p,p2,fidx);
+
+        checkForInterruption();
+        if (basis_order > 1) ofield->set_evalue(val,idx);
+        else ofield->set_value(val,idx);
+
+        if (interpolate_values)
         {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
+          objmesh->get_coords(coords,p2,fidx);
           if (objfield->is_scalar())
           {
             double val;
@@ -425,132 +127,92 @@ class CalculateSignedDistanceFieldP : public Interruptible
             objfield->interpolate(val,coords,fidx);
             vfield->set_value(val,idx);
           }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
+        if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
       }
-      else if (ofield->basis_order() == 1)
+    }
+
+    void find_closest_elem(double& val, Point& p2, VMesh::Elem::index_type& fidx, const Point& p) const
+    {
+      if (bvh_)
+      {
+        index_type elem = 0;
+        bvh_->find_closest_elem(val,p2,elem,p);
+        fidx = elem;
+      }
+      else
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
+        objmesh->find_closest_elem(val,p2,fidx,p);
+      }
+    }
 
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
+    /// Closed surfaces are signed by their winding number, which does not
+    /// depend on which face or edge happens to be closest. Open surfaces use
+    /// the normal of the closest face.
+    double apply_sign(double val, const Point& p, Point p2, VMesh::Elem::index_type fidx) const
+    {
+      if (bvh_ && bvh_->is_closed())
+      {
+        const bool behind_normals = bvh_->is_inside(p) == (bvh_->signed_volume() > 0.0);
+        return behind_normals ? -val : val;
+      }
 
-        for (VMesh::Node::index_type idx =start; idx <end; idx++)
-        {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
+      VMesh::Elem::index_type fidx_n;
+      VMesh::Node::array_type nodes;
+      VMesh::DElem::array_type delems;
+      Point n0,n1,n2,p1;
 
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 Point p1, p2;
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_value(val,idx);
-          if (objfield->is_scalar())
-          {
-            double val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_vector())
-          {
-            Vector val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_tensor())
-          {
-            Tensor val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
-        }
-      }
-      else if (ofield->basis_order() > 1)
-      {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        VMesh::coords_type coords;
+      objmesh->get_nodes(nodes,fidx);
+      objmesh->get_center(n0,nodes[0]);
+      objmesh->get_center(n1,nodes[1]);
+      objmesh->get_center(n2,nodes[2]);
 
-        Vector n, k;
-        Point n0,n1,n2;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
+      Vector n = Cross(Vector(n1-n0),Vector(n2-n1));
+      Vector k = Vector(p-p2); k.normalize();
 
-        for (VMesh::ENode::index_type idx=start; idx < end; idx++)
+      double angle = Dot(n,k);
+      if (angle < -epsilon_)
+      {
+        val = -val;
+      }
+      else if (angle > epsilon_)
+      {
+      }
+      else
+      {
+        // trouble
+        if (val != 0.0)
         {
-          checkForInterruption();
-          Point p, p1, p2;
-          imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,coords,fidx,p);
+          objmesh->get_delems(delems,fidx);
+          double mindist = DBL_MAX;
+          double dist;
+          int edgeidx = 0;
+          for (size_t r=0; r<delems.size();r++)
+          {
+            objmesh->get_nodes(nodes,delems[r]);
+            objmesh->get_center(p1,nodes[0]);
+            objmesh->get_center(p2,nodes[1]);
 
+            if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
+            {
+              Vector v = Vector(p-p2);
+              dist  = Dot(v,v);
+            }
+            else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
+            {
+              Vector v = Vector(p-p1);
+              dist = Dot(v,v);
+            }
+            else
+            {
+              Vector v1 = Vector(p1-p2);
+              Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
+              dist = Dot(v,v);
+            }
+
+            if (dist < mindist) { mindist = dist; edgeidx = r;}
+          }
+          objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
           objmesh->get_nodes(nodes,fidx);
           objmesh->get_center(n0,nodes[0]);
           objmesh->get_center(n1,nodes[1]);
@@ -558,97 +220,13 @@ class CalculateSignedDistanceFieldP : public Interruptible
           n = Cross(Vector(n1-n0),Vector(n2-n1));
           k = Vector(p-p2);
           k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-          checkForInterruption();
-          ofield->set_evalue(val,idx);
-          if (objfield->is_scalar())
-          {
-            double val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_vector())
-          {
-            Vector val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          else if (objfield->is_tensor())
-          {
-            Tensor val;
-            objfield->interpolate(val,coords,fidx);
-            vfield->set_value(val,idx);
-          }
-          if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
+          angle = Dot(n,k);
+          if (angle < 0.0) val = -(val);
         }
       }
+      return val;
     }
 
-
-    void range(int proc, int nproc,
-               VMesh::index_type& start, VMesh::index_type& end,
-               VMesh::size_type size)
-    {
-      VMesh::size_type m = size/nproc;
-      start = proc*m;
-      end = (proc+1)*m;
-      if (proc == nproc-1) end = size;
-    }
-
-  private:
     VMesh*   imesh;
     VMesh*   objmesh;
     VField*  objfield;
@@ -656,6 +234,8 @@ class CalculateSignedDistanceFieldP : public Interruptible
     VField*  vfield;
 
     const ProgressReporter* pr_;
+    boost::shared_ptr<SurfaceBVH> bvh_;
+    double epsilon_;
 };
 
 CalculateSignedDistanceFieldAlgo::CalculateSignedDistanceFieldAlgo()
@@ -718,7 +298,9 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+  objmesh->synchronize(Mesh::SURFACE_BVH_E|Mesh::EDGES_E);
+  if (!objmesh->get_surface_bvh())
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
   const int numThreads = Parallel::NumCores();
   auto task_i = [&palgo,numThreads](int i) { palgo.parallel(i, numThreads); };
@@ -800,7 +382,9 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+  objmesh->synchronize(Mesh::SURFACE_BVH_E|Mesh::EDGES_E);
+  if (!objmesh->get_surface_bvh())
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
 
   if (distance->basis_order() > 2)
   {
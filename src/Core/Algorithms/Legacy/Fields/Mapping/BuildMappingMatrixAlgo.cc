@@ -610,11 +610,14 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     }
   }
 
-  LegacySparseDataContainer<double> legacySparseData(m+1, nnz);
+  // The mapping is written straight into the compressed storage of the
+  // output matrix; nnz is an upper bound that is trimmed afterwards.
+  SparseRowMatrixHandle mapping(new SparseRowMatrix(m, n));
+  mapping->allocateCompressed(nnz);
 
-  const SparseRowMatrix::RowsPtr& rr = legacySparseData.rows().get();
-  const SparseRowMatrix::ColumnsPtr& cc = legacySparseData.columns().get();
-  const SparseRowMatrix::Storage& vv = legacySparseData.data().get();
+  const SparseRowMatrix::RowsPtr rr = mapping->get_rows();
+  const SparseRowMatrix::ColumnsPtr cc = mapping->get_cols();
+  const SparseRowMatrix::Storage vv = mapping->valuePtr();
 
   double maxdist = get(Parameters::MaxDistance).toDouble();
 
@@ -669,12 +672,8 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     Parallel::RunTasks(task_i, np);
   }
 
-  output.reset(new SparseRowMatrix(m,n,rr,cc,vv,nnz));
-  if (!output)
-  {
-    error("Could not create output matrix");
-    return (false);
-  }
+  mapping->finishCompressed();
+  output = mapping;
 
   return (true);
 }
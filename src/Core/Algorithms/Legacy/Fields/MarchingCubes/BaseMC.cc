@@ -121,3 +121,57 @@ MatrixHandle BaseMC::get_parent_cells()
   #endif
     return MatrixHandle();
 }
+
+
+std::vector<BaseMC::edgepair_t> BaseMC::get_node_keys() const
+{
+  std::vector<edgepair_t> keys;
+  if (basis_order_ == 0)
+  {
+    const edgepair_t unknown = { -1, -1, 0.0 };
+    // constant data: output nodes are copies of input nodes
+    for (index_type n = 0; n < static_cast<index_type>(node_map_.size()); ++n)
+    {
+      const index_type out = node_map_[n];
+      if (out < 0)
+        continue;
+      if (out >= static_cast<index_type>(keys.size()))
+        keys.resize(out + 1, unknown);
+      edgepair_t key = { -1, n, 1.0 };
+      keys[out] = key;
+    }
+  }
+  else
+  {
+    keys.resize(edge_map_.size());
+    for (const auto& cut : edge_map_)
+      keys[cut.second] = cut.first;
+  }
+  return keys;
+}
+
+std::vector<BaseMC::edgepair_t> BaseMC::get_elem_parents() const
+{
+  std::vector<edgepair_t> parents;
+  if (basis_order_ == 0)
+  {
+    // constant data: each output element separates the two cells stored as its key
+    const edgepair_t unknown = { -1, -1, 0.0 };
+    for (const auto& face : edge_map_)
+    {
+      if (face.second >= static_cast<index_type>(parents.size()))
+        parents.resize(face.second + 1, unknown);
+      parents[face.second] = face.first;
+    }
+  }
+  else
+  {
+    parents.reserve(cell_map_.size());
+    for (auto cell : cell_map_)
+    {
+      edgepair_t parent = { -1, cell, 1.0 };
+      parents.push_back(parent);
+    }
+  }
+  return parents;
+}
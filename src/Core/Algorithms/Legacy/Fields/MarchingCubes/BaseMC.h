@@ -87,6 +87,17 @@ namespace SCIRun {
       SCIRun::index_type second;
       double dfirst;
     };
+
+    /// Where each output node came from, indexed by output node: the cut input edge
+    /// (first, second, dfirst), or the input node it coincides with (first == -1).
+    /// Tesselators that ran on disjoint element ranges produce equal keys for a shared
+    /// vertex, which is what allows their outputs to be stitched together.
+    std::vector<edgepair_t> get_node_keys() const;
+
+    /// Input elements each output element was generated from, indexed by output element,
+    /// in the same encoding as get_node_keys().
+    std::vector<edgepair_t> get_elem_parents() const;
+
   protected:
     struct edgepairhash
     {
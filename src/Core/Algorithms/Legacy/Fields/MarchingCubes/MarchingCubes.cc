@@ -38,6 +38,9 @@
 #include <Core/Algorithms/Math/AppendMatrix.h>
 #include <Core/Algorithms/Legacy/Fields/MergeFields/AppendFieldsAlgo.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
 
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/HexMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/UHexMC.h>
@@ -97,17 +100,16 @@ class MarchingCubesAlgoP {
 
     ~MarchingCubesAlgoP()
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       delete_all_items(tesselator_);
-      #endif
+      for (auto tesselator : tesselator_)
+        delete tesselator;
     }
 
     FieldHandle    input_;
 
     std::vector<TESSELATOR*>   tesselator_;
     std::vector<FieldHandle>  output_field_;
-    std::vector<MatrixHandle> output_interpolant_matrix_;
-    std::vector<MatrixHandle> output_parent_cell_matrix_;
+    std::vector<std::vector<BaseMC::edgepair_t> > node_keys_;
+    std::vector<std::vector<BaseMC::edgepair_t> > elem_parents_;
     #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
      std::vector<GeomHandle>   output_geometry_;
     #endif
@@ -127,12 +129,14 @@ class MarchingCubesAlgoP {
     void parallel(int proc, int nproc, size_t iso);
 
   private:
-    AppendFieldsAlgorithm append_fields_;
-    AppendMatrixAlgorithm append_matrices_;
+    FieldHandle merge(int nproc, size_t iso,
+                      std::vector<BaseMC::edgepair_t>& node_keys,
+                      std::vector<BaseMC::edgepair_t>& elem_parents);
+    MatrixHandle build_interpolant(const std::vector<std::vector<BaseMC::edgepair_t> >& keys, size_type ncols) const;
 
+    AppendFieldsAlgorithm append_fields_;
 };
 
-
 bool
 MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isovalues)
 {
@@ -157,18 +161,15 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
 {
   algo_ = algo;
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  int np = algo->get_int("num_threads");
+  int np = algo->get(MarchingCubesAlgo::num_threads).toInt();
   /// By default (-1) choose number of processors
-  if (np < 1) np = Thread::numProcessors();
+  if (np < 1) np = Parallel::NumCores();
   /// Cap the number of threads
-  if (np > 4*Thread::numProcessors()) np = 4*Thread::numProcessors();
-  */
-  /// @todo: FIX MULTI THREADING OF MARCHING CUBES FIELDS ARE NOT PROPORLY LINKED
- #endif
-  int np = Parallel::NumCores();
+  if (np > 4*static_cast<int>(Parallel::NumCores())) np = 4*Parallel::NumCores();
+  /// Small meshes are not worth splitting
+  const size_type num_elems = input_->vmesh()->num_elems();
+  if (np > num_elems / 1000) np = std::max<int>(1, num_elems / 1000);
 
-  np = 1;
   size_t num_values = iso_values_.size();
 
   tesselator_.resize(np);
@@ -176,8 +177,8 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
     tesselator_[j] = new TESSELATOR(input_);
 
   output_field_.resize(np*num_values);
-  output_interpolant_matrix_.resize(np*num_values);
-  output_parent_cell_matrix_.resize(np*num_values);
+  node_keys_.resize(np*num_values);
+  elem_parents_.resize(np*num_values);
   //output_geometry_.resize(np*num_values);
 
   build_field_ = algo->get(MarchingCubesAlgo::build_field).toBool();
@@ -186,24 +187,24 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   build_elem_interpolant_ = algo->get(MarchingCubesAlgo::build_elem_interpolant).toBool();
   transparency_ = algo->get(MarchingCubesAlgo::transparency).toBool();
 
+  // Interpolants are defined on the output field, so they need it built as well
+  if (build_node_interpolant_ || build_elem_interpolant_)
+    build_field_ = true;
+
  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   append_fields_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.setOption("method","append_rows");
  #endif
 
+  std::vector<FieldHandle> iso_fields(num_values);
+  std::vector<std::vector<BaseMC::edgepair_t> > iso_node_keys(num_values);
+  std::vector<std::vector<BaseMC::edgepair_t> > iso_elem_parents(num_values);
+
   for (size_t j=0; j<iso_values_.size(); j++)
   {
-    if (np == 1)
-    {
-      parallel(0,1,j);
-    }
-    else
-    {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       Thread::parallel(this,&MarchingCubesAlgoP<TESSELATOR>::parallel,np,np,j);
-      #endif
-    }
+    Parallel::RunTasks([this, np, j](int proc) { parallel(proc, np, j); }, np);
+
+    if (build_field_)
+      iso_fields[j] = merge(np, j, iso_node_keys[j], iso_elem_parents[j]);
   }
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (output_geometry_.size() == 0)
@@ -225,27 +226,252 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
 
   if (build_field_)
   {
-   if (!(append_fields_.run(output_field_,output)))
+    if (iso_fields.size() == 1)
+    {
+      output = iso_fields[0];
+    }
+    else if (!(append_fields_.run(iso_fields,output)))
+    {
       return (false);
+    }
   }
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
+  // Rows of the interpolants follow the output field: isovalues in order,
+  // each one numbered the way merge() numbered it.
   if (build_node_interpolant_)
   {
-    if (!(append_matrices_.run(output_interpolant_matrix_,node_interpolant)))
-      return (false);
+    node_interpolant = build_interpolant(iso_node_keys, input_->vmesh()->num_nodes());
   }
 
   if (build_elem_interpolant_)
   {
-    if (!(append_matrices_.run(output_parent_cell_matrix_,elem_interpolant)))
-      return (false);
+    elem_interpolant = build_interpolant(iso_elem_parents, num_elems);
   }
- #endif
 
   return (true);
 }
 
+namespace
+{
+  bool keyLess(const BaseMC::edgepair_t& a, const BaseMC::edgepair_t& b)
+  {
+    if (a.first != b.first) return a.first < b.first;
+    return a.second < b.second;
+  }
+
+  /// Orders vertex indices by their key, then by index.
+  struct VertexKeyLess
+  {
+    explicit VertexKeyLess(const std::vector<BaseMC::edgepair_t>& keys) : keys_(keys) {}
+    bool operator()(index_type a, index_type b) const
+    {
+      if (keys_[a] != keys_[b]) return keyLess(keys_[a], keys_[b]);
+      return a < b;
+    }
+    const std::vector<BaseMC::edgepair_t>& keys_;
+  };
+
+  /// Compares a vertex index with a bare key, for searching the sorted per-thread lists.
+  struct VertexBeforeKey
+  {
+    explicit VertexBeforeKey(const std::vector<BaseMC::edgepair_t>& keys) : keys_(keys) {}
+    bool operator()(index_type a, const BaseMC::edgepair_t& key) const
+    {
+      return keyLess(keys_[a], key);
+    }
+    const std::vector<BaseMC::edgepair_t>& keys_;
+  };
+}
+
+/// Stitches the per-thread surfaces for one isovalue into a single field. Vertices cut
+/// from the same input edge by different threads are merged, so the result is identical
+/// to what a single tesselator would have produced (up to node numbering).
+template<class TESSELATOR>
+FieldHandle MarchingCubesAlgoP<TESSELATOR>::merge(int nproc, size_t iso,
+                                                  std::vector<BaseMC::edgepair_t>& node_keys,
+                                                  std::vector<BaseMC::edgepair_t>& elem_parents)
+{
+  const size_t first = iso*nproc;
+  if (nproc == 1)
+  {
+    node_keys.swap(node_keys_[first]);
+    elem_parents.swap(elem_parents_[first]);
+    return output_field_[first];
+  }
+
+  std::vector<index_type> node_offset(nproc+1, 0), elem_offset(nproc+1, 0);
+  for (int p = 0; p < nproc; p++)
+  {
+    node_offset[p+1] = node_offset[p] + output_field_[first+p]->vmesh()->num_nodes();
+    elem_offset[p+1] = elem_offset[p] + output_field_[first+p]->vmesh()->num_elems();
+  }
+  const size_type total_nodes = node_offset[nproc];
+  const size_type total_elems = elem_offset[nproc];
+
+  // Each thread sorts its own vertices by key. Keys are unique within a thread, so only
+  // vertices of different threads can coincide.
+  std::vector<BaseMC::edgepair_t> all_keys(total_nodes);
+  std::vector<index_type> representative(total_nodes);
+  std::vector<std::vector<index_type> > sorted(nproc);
+  Parallel::RunTasks([&](int p)
+  {
+    const index_type noff = node_offset[p];
+    std::copy(node_keys_[first+p].begin(), node_keys_[first+p].end(), all_keys.begin() + noff);
+    for (index_type idx = noff; idx < node_offset[p+1]; idx++)
+    {
+      representative[idx] = idx;
+      if (all_keys[idx].second >= 0)
+        sorted[p].push_back(idx);
+    }
+    std::sort(sorted[p].begin(), sorted[p].end(), VertexKeyLess(all_keys));
+  }, nproc);
+
+  // Split the key range into one part per thread, using keys sampled from every list.
+  std::vector<index_type> samples;
+  for (int p = 0; p < nproc; p++)
+    for (int s = 1; s < nproc; s++)
+      if (!sorted[p].empty())
+        samples.push_back(sorted[p][s*sorted[p].size()/nproc]);
+  std::sort(samples.begin(), samples.end(), VertexKeyLess(all_keys));
+
+  // Each part merges its slice of the sorted lists. Copies of a shared vertex meet there,
+  // and the lowest index of each group represents it, which keeps thread 0's numbering first.
+  Parallel::RunTasks([&](int q)
+  {
+    std::vector<std::vector<index_type>::const_iterator> head(nproc), end(nproc);
+    for (int p = 0; p < nproc; p++)
+    {
+      head[p] = sorted[p].begin();
+      end[p] = sorted[p].end();
+      if (q > 0 && !samples.empty())
+        head[p] = std::lower_bound(sorted[p].begin(), sorted[p].end(),
+          all_keys[samples[q*samples.size()/nproc]], VertexBeforeKey(all_keys));
+      if (q < nproc-1 && !samples.empty())
+        end[p] = std::lower_bound(sorted[p].begin(), sorted[p].end(),
+          all_keys[samples[(q+1)*samples.size()/nproc]], VertexBeforeKey(all_keys));
+    }
+
+    std::vector<index_type> group;
+    for (;;)
+    {
+      int lowest = -1;
+      for (int p = 0; p < nproc; p++)
+        if (head[p] < end[p] && (lowest < 0 || keyLess(all_keys[*head[p]], all_keys[*head[lowest]])))
+          lowest = p;
+      if (lowest < 0)
+        break;
+
+      const BaseMC::edgepair_t key = all_keys[*head[lowest]];
+      group.clear();
+      for (int p = 0; p < nproc; p++)
+        while (head[p] < end[p] && all_keys[*head[p]] == key)
+          group.push_back(*head[p]++);
+      // lists are visited in thread order, so the first index is the lowest
+      for (auto idx : group)
+        representative[idx] = group.front();
+    }
+  }, nproc);
+
+  // Representatives are numbered in index order; the others take their representative's number.
+  std::vector<index_type> unique_offset(nproc+1, 0);
+  Parallel::RunTasks([&](int p)
+  {
+    for (index_type idx = node_offset[p]; idx < node_offset[p+1]; idx++)
+      if (representative[idx] == idx) unique_offset[p+1]++;
+  }, nproc);
+  for (int p = 0; p < nproc; p++)
+    unique_offset[p+1] += unique_offset[p];
+  const index_type unique_nodes = unique_offset[nproc];
+
+  std::vector<index_type> remap(total_nodes);
+  Parallel::RunTasks([&](int p)
+  {
+    index_type next = unique_offset[p];
+    for (index_type idx = node_offset[p]; idx < node_offset[p+1]; idx++)
+      if (representative[idx] == idx) remap[idx] = next++;
+  }, nproc);
+
+  FieldInformation fi(output_field_[first]);
+  FieldHandle merged = CreateField(fi);
+  VMesh* omesh = merged->vmesh();
+  omesh->resize_nodes(unique_nodes);
+  const bool has_connectivity = !omesh->is_pointcloudmesh();
+  if (has_connectivity)
+    omesh->resize_elems(total_elems);
+
+  // Point clouds have one element per node, so their elements are merged along with the nodes
+  node_keys.resize(unique_nodes);
+  elem_parents.resize(has_connectivity ? total_elems : unique_nodes);
+
+  Core::Geometry::Point* opoints = omesh->get_points_pointer();
+  VMesh::index_type* oelems = has_connectivity ? omesh->get_elems_pointer() : nullptr;
+  const size_type nodes_per_elem = omesh->num_nodes_per_elem();
+
+  Parallel::RunTasks([&](int p)
+  {
+    VMesh* imesh = output_field_[first+p]->vmesh();
+    const Core::Geometry::Point* ipoints = imesh->get_points_pointer();
+    const index_type noff = node_offset[p];
+    // representatives come from this or an earlier thread, all numbered above
+    for (index_type idx = noff; idx < node_offset[p+1]; idx++)
+      if (representative[idx] != idx) remap[idx] = remap[representative[idx]];
+    for (index_type n = 0; n < node_offset[p+1] - noff; n++)
+    {
+      if (representative[noff+n] == noff+n)
+      {
+        opoints[remap[noff+n]] = ipoints[n];
+        node_keys[remap[noff+n]] = all_keys[noff+n];
+        if (!has_connectivity && n < static_cast<index_type>(elem_parents_[first+p].size()))
+          elem_parents[remap[noff+n]] = elem_parents_[first+p][n];
+      }
+    }
+
+    const index_type eoff = elem_offset[p];
+    const size_type nelems = elem_offset[p+1] - eoff;
+    if (oelems)
+    {
+      const VMesh::index_type* ielems = imesh->get_elems_pointer();
+      for (index_type k = 0; k < nelems*nodes_per_elem; k++)
+        oelems[eoff*nodes_per_elem+k] = remap[noff+ielems[k]];
+    }
+    if (has_connectivity)
+      std::copy(elem_parents_[first+p].begin(), elem_parents_[first+p].end(), elem_parents.begin() + eoff);
+  }, nproc);
+
+  VField* ofield = merged->vfield();
+  ofield->resize_values();
+  ofield->set_all_values(iso_values_[iso]);
+
+  return merged;
+}
+
+template<class TESSELATOR>
+MatrixHandle MarchingCubesAlgoP<TESSELATOR>::build_interpolant(const std::vector<std::vector<BaseMC::edgepair_t> >& keys, size_type ncols) const
+{
+  typedef SparseRowMatrix::Triplet T;
+  std::vector<T> triplets;
+  index_type row = 0;
+  for (const auto& iso_keys : keys)
+  {
+    for (const auto& key : iso_keys)
+    {
+      if (key.first >= 0)
+      {
+        triplets.push_back(T(row, key.first, 1.0 - key.dfirst));
+        triplets.push_back(T(row, key.second, key.dfirst));
+      }
+      else if (key.second >= 0)
+      {
+        triplets.push_back(T(row, key.second, 1.0));
+      }
+      row++;
+    }
+  }
+  auto matrix = boost::make_shared<SparseRowMatrix>(row, ncols);
+  matrix->setFromTriplets(triplets.begin(), triplets.end());
+  return matrix;
+}
+
 bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isovalues, FieldHandle& field, MatrixHandle& node_interpolant, MatrixHandle& elem_interpolant) const
 {
 
@@ -337,8 +563,8 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   }
 
   output_field_[iso*nproc+proc] = 0;
-  output_interpolant_matrix_[iso*nproc+proc] = 0;
-  output_parent_cell_matrix_[iso*nproc+proc] = 0;
+  node_keys_[iso*nproc+proc].clear();
+  elem_parents_[iso*nproc+proc].clear();
 
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
    output_geometry_[iso*nproc+proc] = 0;
@@ -347,14 +573,9 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   if (build_field_)
   {
     output_field_[iso*nproc+proc] = tesselator_[proc]->get_field(isoval);
-  }
-  if (build_node_interpolant_)
-  {
-    output_interpolant_matrix_[iso*nproc+proc] = tesselator_[proc]->get_interpolant();
-  }
-  if (build_elem_interpolant_)
-  {
-    output_parent_cell_matrix_[iso*nproc+proc] = tesselator_[proc]->get_parent_cells();
+    node_keys_[iso*nproc+proc] = tesselator_[proc]->get_node_keys();
+    if (build_elem_interpolant_)
+      elem_parents_[iso*nproc+proc] = tesselator_[proc]->get_elem_parents();
   }
 
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -38,6 +38,7 @@
 #include <Core/Datatypes/PropertyManagerExtensions.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/Thread/Parallel.h>
 #include <boost/scoped_ptr.hpp>
 
 using namespace SCIRun;
@@ -47,6 +48,96 @@ using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Utility;
 using namespace SCIRun::Core::Algorithms;
 
+namespace
+{
+  /// Searches the bins of grid in growing shells around P for the node of
+  /// mesh closest to P that lies within sqrt(dmin). With values given only
+  /// nodes whose value equals curval are considered. Returns -1 if there is
+  /// no such node, otherwise the node index; dmin is then updated.
+  index_type closest_grid_node(const SearchGridT<index_type>& grid, VMesh* mesh,
+    const Point& P, double& dmin, const std::vector<int>* values, int curval)
+  {
+    const size_type ni = grid.get_ni()-1;
+    const size_type nj = grid.get_nj()-1;
+    const size_type nk = grid.get_nk()-1;
+
+    // Convert to grid coordinates.
+    index_type bi, bj, bk, ei, ej, ek;
+    grid.unsafe_locate(bi, bj, bk, P);
+
+    // Clamp to closest point on the grid.
+    if (bi > ni) bi = ni;
+    if (bi < 0) bi = 0;
+
+    if (bj > nj) bj = nj;
+    if (bj < 0) bj = 0;
+
+    if (bk > nk) bk = nk;
+    if (bk < 0) bk = 0;
+
+    ei = bi; ej = bj; ek = bk;
+
+    const bool use_points = grid.has_points() && !values;
+    index_type cidx = -1;
+    bool found = true;
+
+    do
+    {
+      found = true;
+      for (index_type i = bi; i <= ei; i++)
+      {
+        if (i < 0 || i > ni) continue;
+        for (index_type j = bj; j <= ej; j++)
+        {
+        if (j < 0 || j > nj) continue;
+          for (index_type k = bk; k <= ek; k++)
+          {
+            if (k < 0 || k > nk) continue;
+            if (i == bi || i == ei || j == bj || j == ej || k == bk || k == ek)
+            {
+              if (grid.min_distance_squared(P, i, j, k) < dmin)
+              {
+                found = false;
+                if (use_points)
+                {
+                  grid.closest_in_bin(P, i, j, k, dmin, cidx);
+                  continue;
+                }
+
+                SearchGridT<index_type>::iterator it, eit;
+                grid.lookup_ijk(it, eit, i, j, k);
+
+                while (it != eit)
+                {
+                  if (!values || (*values)[*it] == curval)
+                  {
+                    Point point;
+                    mesh->get_center(point,VMesh::Node::index_type(*it));
+                    const double dist  = (P-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      cidx = *it;
+                      dmin = dist;
+                    }
+                  }
+                  ++it;
+                }
+              }
+            }
+          }
+        }
+      }
+      bi--;ei++;
+      bj--;ej++;
+      bk--;ek++;
+    }
+    while (!found);
+
+    return (cidx);
+  }
+}
+
 AlgorithmParameterName JoinFieldsAlgo::MergeNodes("merge_nodes");
 AlgorithmParameterName JoinFieldsAlgo::MergeElems("merge_elems");
 AlgorithmParameterName JoinFieldsAlgo::Tolerance("tolerance");
@@ -172,7 +263,7 @@ JoinFieldsAlgo::runImpl(const FieldList& input, FieldHandle& output) const
   boost::scoped_ptr<SearchGridT<index_type> > node_grid;
   boost::scoped_ptr<SearchGridT<index_type> > elem_grid;
 
-  size_type ni = 0, nj = 0, nk = 0;
+  size_type gx = 0, gy = 0, gz = 0;
 
   size_type tot_num_nodes = 0;
   size_type tot_num_elems = 0;
@@ -210,15 +301,11 @@ JoinFieldsAlgo::runImpl(const FieldList& input, FieldHandle& output) const
     size_type sy = static_cast<size_type>(ceil(diag.y()/trace*s));
     size_type sz = static_cast<size_type>(ceil(diag.z()/trace*s));
 
-    node_grid.reset(new SearchGridT<index_type>(sx, sy, sz, box.get_min(), box.get_max()));
-
     if (sx == 0) sx = 1;
     if (sy == 0) sy = 1;
     if (sz == 0) sz = 1;
 
-    ni = node_grid->get_ni()-1;
-    nj = node_grid->get_nj()-1;
-    nk = node_grid->get_nk()-1;
+    gx = sx; gy = sy; gz = sz;
   }
 
   if (merge_elems)
@@ -237,10 +324,6 @@ JoinFieldsAlgo::runImpl(const FieldList& input, FieldHandle& output) const
     if (sz == 0) sz = 1;
 
     elem_grid.reset(new SearchGridT<index_type>(sx, sy, sz, box.get_min(), box.get_max()));
-
-    ni = node_grid->get_ni()-1;
-    nj = node_grid->get_nj()-1;
-    nk = node_grid->get_nk()-1;
   }
 
   MeshHandle mesh = CreateMesh(first);
@@ -302,6 +385,44 @@ JoinFieldsAlgo::runImpl(const FieldList& input, FieldHandle& output) const
       local_to_global_elem.resize(num_elems,-1);
     }
 
+    // Nodes are matched against the output nodes of the earlier inputs in
+    // parallel, using a grid that is bulk loaded once per input. Only the
+    // nodes added from this input itself need the incrementally filled grid.
+    std::vector<index_type> prior_match;
+    std::vector<double> prior_dist;
+    if (merge_nodes)
+    {
+      node_grid.reset(new SearchGridT<index_type>(gx, gy, gz, box.get_min(), box.get_max()));
+
+      const size_type num_prior = omesh->num_nodes();
+      if (num_prior > 0)
+      {
+        SearchGridT<index_type> prior_grid(gx, gy, gz, box.get_min(), box.get_max());
+        prior_grid.fill_points(num_prior, [omesh](index_type n)
+        {
+          Point q;
+          omesh->get_center(q, VMesh::Node::index_type(n));
+          return q;
+        });
+
+        prior_match.assign(num_nodes, -1);
+        prior_dist.assign(num_nodes, tol2);
+        const std::vector<int>* match = match_node_values ? &values : 0;
+        Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_nodes), 0,
+          [&](const Core::Thread::IndexRange& r)
+          {
+            for (size_t n = r.begin; n < r.end; ++n)
+            {
+              Point Q;
+              int val = 0;
+              imesh->get_center(Q, VMesh::Node::index_type(n));
+              if (match_node_values) ifield->get_value(val, VMesh::Node::index_type(n));
+              prior_match[n] = closest_grid_node(prior_grid, omesh, Q, prior_dist[n], match, val);
+            }
+          });
+      }
+    }
+
     for (VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
     {
       imesh->get_nodes(nodes,idx);
@@ -326,91 +447,17 @@ JoinFieldsAlgo::runImpl(const FieldList& input, FieldHandle& output) const
 
             if (match_node_values) ifield->get_value(curval,nodeq);
 
-            // Convert to grid coordinates.
-            index_type bi, bj, bk, ei, ej, ek;
-            node_grid->unsafe_locate(bi, bj, bk, P);
-
-            // Clamp to closest point on the grid.
-            if (bi > ni) bi = ni;
-            if (bi < 0) bi = 0;
-
-            if (bj > nj) bj = nj;
-            if (bj < 0) bj = 0;
-
-            if (bk > nk) bk = nk;
-            if (bk < 0) bk = 0;
-
-            ei = bi; ej = bj; ek = bk;
-
             index_type cidx = -1;
             double dmin = tol2;
-            bool found = true;
-
-            do
+            if (!prior_match.empty() && prior_match[nodeq] >= 0)
             {
-              found = true;
-              for (index_type i = bi; i <= ei; i++)
-              {
-                if (i < 0 || i > ni) continue;
-                for (index_type j = bj; j <= ej; j++)
-                {
-                if (j < 0 || j > nj) continue;
-                  for (index_type k = bk; k <= ek; k++)
-                  {
-                    if (k < 0 || k > nk) continue;
-                    if (i == bi || i == ei || j == bj || j == ej || k == bk || k == ek)
-                    {
-                      if (node_grid->min_distance_squared(P, i, j, k) < dmin)
-                      {
-                        found = false;
-                        SearchGridT<index_type>::iterator it, eit;
-                        node_grid->lookup_ijk(it, eit, i, j, k);
-
-                        if (match_node_values)
-                        {
-                          while (it != eit)
-                          {
-                            if (values[*it] == curval)
-                            {
-                              Point point;
-                              omesh->get_center(point,VMesh::Node::index_type(*it));
-                              const double dist  = (P-point).length2();
-
-                              if (dist < dmin)
-                              {
-                                cidx = *it;
-                                dmin = dist;
-                              }
-                            }
-                            ++it;
-                          }
-                        }
-                        else
-                        {
-                          while (it != eit)
-                          {
-                            Point point;
-                            omesh->get_center(point,VMesh::Node::index_type(*it));
-                            const double dist  = (P-point).length2();
-
-                            if (dist < dmin)
-                            {
-                              cidx = *it;
-                              dmin = dist;
-                            }
-                            ++it;
-                          }
-                        }
-                      }
-                    }
-                  }
-                }
-              }
-              bi--;ei++;
-              bj--;ej++;
-              bk--;ek++;
+              cidx = prior_match[nodeq];
+              dmin = prior_dist[nodeq];
             }
-            while (!found);
+
+            const index_type added = closest_grid_node(*node_grid, omesh, P, dmin,
+              match_node_values ? &values : 0, curval);
+            if (added >= 0) cidx = added;
 
             if (cidx >= 0)
             {
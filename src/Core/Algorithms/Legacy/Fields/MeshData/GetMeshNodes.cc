@@ -65,7 +65,7 @@ bool GetMeshNodesAlgo::run(FieldHandle& input, DenseMatrixHandle& output) const
   FieldInformation fi(input);
 
   /// @todo: refactor duplication
-  if (fi.is_regularmesh())
+  if (fi.is_regularmesh() || fi.is_float_points())
   {
     Point p;
     int cnt = 0;
@@ -68,6 +68,12 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
     return (false);
   }
 
+  if (fi.is_float_points())
+  {
+    error("This algorithm requires a mesh with double precision nodes");
+    return (false);
+  }
+
   if (fi.is_imagemesh())
   {
     warning("An image mesh is byt default smooth, skipping mesh smoothing");
@@ -33,15 +33,16 @@
 #include <Core/Algorithms/Legacy/Fields/StreamLines/GenerateStreamLines.h>
 #include <Core/Algorithms/Legacy/Fields/StreamLines/StreamLineIntegrators.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
-#include <Core/Algorithms/Legacy/Fields/MergeFields/JoinFieldsAlgo.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Thread/Interruptible.h>
-#include <Core/Thread/Barrier.h>
 #include <Core/Thread/Parallel.h>
 #include <Core/Logging/Log.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
@@ -163,34 +164,33 @@ namespace detail
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Unknown streamline value selected"));
   }
 
+  /// Streamlines traced from one batch of consecutive seeds. Each batch is filled by a single
+  /// thread, so tracing never touches the shared output field.
+  struct StreamlineBatch
+  {
+    std::vector<Point> points;
+    std::vector<double> values;
+    /// Seed index and number of points of each streamline, in seed order.
+    std::vector<std::pair<VMesh::Node::index_type, size_type>> lines;
+    size_type nodeOffset {0};
+    size_type elemOffset {0};
+  };
+
   class GenerateStreamLinesAlgoImplBase : public Core::Thread::Interruptible
   {
   public:
-    GenerateStreamLinesAlgoImplBase(const AlgorithmBase* algo, IntegrationMethod method) : algo_(algo),
-      numprocessors_(Parallel::NumCores()),
-      barrier_("GenerateStreamLinesAlgoImplBase Barrier", numprocessors_), method_(method)
+    GenerateStreamLinesAlgoImplBase(const AlgorithmBase* algo, IntegrationMethod method) : algo_(algo), method_(method)
     {}
 
     bool run(FieldHandle input, FieldHandle seeds, FieldHandle& output);
 
-    std::pair<index_type, index_type> partitionNodes(int proc_num) const
-    {
-      const index_type start_gd = (global_dimension_ * proc_num) / numprocessors_;
-      const index_type end_gd = (global_dimension_ * (proc_num + 1)) / numprocessors_;
-
-      LOG_DEBUG("GenerateStreamLinesAlgoP proc {}, start {}, end {}", proc_num, start_gd, end_gd);
-      return {start_gd, end_gd};
-    }
-
   protected:
-    void parallel(int proc);
-    virtual FieldHandle StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num) = 0;
+    virtual void traceSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, StreamlineBatch& batch) = 0;
     double calcTotalStreamlineLength(const std::vector<Point>& nodes) const;
-    void setOutputData(FieldHandle out, const std::vector<Point>& nodes, VMesh::Node::index_type idx, int cc) const;
+    void appendStreamline(StreamlineBatch& batch, const std::vector<Point>& nodes, VMesh::Node::index_type idx, int cc) const;
+    void seedsTraced(size_type count);
 
     const AlgorithmBase* algo_;
-    int numprocessors_;
-    Barrier barrier_;
     double tolerance_ {0};
     double step_size_ {0};
     int    max_steps_ {0};
@@ -206,9 +206,19 @@ namespace detail
     VMesh*  mesh_ {nullptr};
 
     FieldHandle input_;
-    std::vector<bool> success_;
-    FieldList outputs_;
     VMesh::Node::index_type global_dimension_ {0};
+
+  private:
+    void traceBatch(index_type batch);
+    void fillOutput(const StreamlineBatch& batch, VMesh* omesh, VField* ofield) const;
+    void forEachBatch(const std::function<void(index_type)>& task) const;
+
+    std::vector<StreamlineBatch> batches_;
+    size_type seedsPerBatch_ {1};
+    bool multithreaded_ {true};
+    std::atomic<bool> failed_ {false};
+    std::atomic<size_type> seedsDone_ {0};
+    std::mutex progressLock_;
   };
 
   double GenerateStreamLinesAlgoImplBase::calcTotalStreamlineLength(const std::vector<Point>& nodes) const
@@ -227,179 +237,124 @@ namespace detail
     return totalStreamlineLength;
   }
 
-  class GenerateStreamLinesAlgoP : public GenerateStreamLinesAlgoImplBase
+  void GenerateStreamLinesAlgoImplBase::appendStreamline(StreamlineBatch& batch, const std::vector<Point>& nodes, VMesh::Node::index_type idx, int cc) const
   {
+    if (nodes.empty())
+      return;
 
-  public:
-    GenerateStreamLinesAlgoP(const AlgorithmBase* algo, IntegrationMethod method) : GenerateStreamLinesAlgoImplBase(algo, method)
-    {}
-  protected:
-    FieldHandle StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num) override;
-  };
-
-  FieldHandle GenerateStreamLinesAlgoP::StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num)
-  {
-    FieldHandle out;
-    try
-    {
-      Vector test;
-      FieldInformation fi(input_);
-      fi.make_curvemesh();
-      fi.make_lineardata();
-      fi.make_linearmesh();
-      fi.make_double();
-      out = CreateField(fi);
-
-      StreamLineIntegrators BI;
-      BI.nodes_.reserve(max_steps_);                  // storage for points
-      BI.tolerance2_ = tolerance_ * tolerance_;      // square error tolerance
-      BI.max_steps_ = max_steps_;                  // max number of steps
-      BI.vfield_ = field_;                       // the vector field
-      std::vector<Point>::iterator node_iter;
-
-      // Try to find the streamline for each seed point.
-      for (VMesh::Node::index_type idx = from; idx < to; ++idx)
-      {
-        checkForInterruption();
-        seed_mesh_->get_point(BI.seed_, idx);
-
-        // Is the seed point inside the field?
-        if (!field_->interpolate(test, BI.seed_))
-          continue;
-
-        BI.nodes_.clear();
-        BI.nodes_.push_back(BI.seed_);
+    batch.lines.emplace_back(idx, static_cast<size_type>(nodes.size()));
+    batch.points.insert(batch.points.end(), nodes.begin(), nodes.end());
 
-        int cc = 0;
+    // Seed values are copied straight from the seed field during assembly.
+    if (value_ == StreamlineValue::SeedValue)
+      return;
 
-        // Find the negative streamlines.
-        if (directionIncludesNegative(direction_))
-        {
-          BI.step_size_ = -step_size_;   // initial step size
-          BI.integrate(method_);
+    const auto totalLength = calcTotalStreamlineLength(nodes);
+    double partialStreamlineLength = 0;
 
-          if (directionIsBoth(direction_))
-          {
-            BI.seed_ = BI.nodes_[0];     // Reset the seed
+    for (size_t i = 0; i < nodes.size(); ++i, ++cc)
+    {
+      const double length = i > 0 ? Vector(nodes[i] - nodes[i - 1]).length() : 0.0;
+      partialStreamlineLength += length;
+
+      if (value_ == StreamlineValue::SeedIndex) batch.values.push_back(static_cast<double>(idx));
+      else if (value_ == StreamlineValue::IntegrationIndex) batch.values.push_back(abs(cc));
+      else if (value_ == StreamlineValue::IntegrationStep) batch.values.push_back(length);
+      else if (value_ == StreamlineValue::DistanceFromSeed) batch.values.push_back(partialStreamlineLength);
+      else if (value_ == StreamlineValue::StreamlineLength) batch.values.push_back(totalLength);
+    }
+  }
 
-            reverse(BI.nodes_.begin(), BI.nodes_.end());
-            cc = BI.nodes_.size() - 1;
-            cc = -(cc - 1);
-          }
-        }
+  void GenerateStreamLinesAlgoImplBase::seedsTraced(size_type count)
+  {
+    const auto done = seedsDone_ += count;
 
-        // Append the positive streamlines.
-        if (directionIncludesPositive(direction_))
-        {
-          BI.step_size_ = step_size_;   // initial step size
-          BI.integrate(method_);
-        }
+    // Whichever thread gets here first reports; the others just keep tracing.
+    std::unique_lock<std::mutex> lock(progressLock_, std::try_to_lock);
+    if (lock.owns_lock())
+      algo_->update_progress_max(done, global_dimension_);
+  }
 
-        setOutputData(out, BI.nodes_, idx, cc);
+  void GenerateStreamLinesAlgoImplBase::traceBatch(index_type batch)
+  {
+    if (failed_)
+      return;
 
-        if (proc_num == 0)
-          algo_->update_progress_max(idx, to);
-      }
+    const auto from = static_cast<VMesh::Node::index_type>(batch * seedsPerBatch_);
+    const auto to = std::min(static_cast<VMesh::Node::index_type>(from + seedsPerBatch_), global_dimension_);
 
-#ifdef NEEDS_ADDITIONAL_ALGO_OUTPUT
-      algo_->set_int("num_streamlines", num_seeds);
-#endif
+    try
+    {
+      traceSeeds(from, to, batches_[batch]);
+      seedsTraced(to - from);
     }
-
     catch (const Exception &e)
     {
       algo_->error(std::string("Crashed with the following exception:\n") + e.message());
-      success_[proc_num] = false;
+      failed_ = true;
     }
     catch (const std::string& a)
     {
       algo_->error(a);
-      success_[proc_num] = false;
+      failed_ = true;
     }
     catch (const char *a)
     {
       algo_->error(a);
-      success_[proc_num] = false;
+      failed_ = true;
     }
-
-    return out;
   }
 
-  void GenerateStreamLinesAlgoImplBase::setOutputData(FieldHandle out, const std::vector<Point>& nodes, VMesh::Node::index_type idx, int cc) const
+  void GenerateStreamLinesAlgoImplBase::fillOutput(const StreamlineBatch& batch, VMesh* omesh, VField* ofield) const
   {
-    auto ofield = out->vfield();
-    auto omesh = out->vmesh();
-    const auto totalLength = calcTotalStreamlineLength(nodes);
-    double partialStreamlineLength = 0;
-    int nodeIndex = 0;
-    Point previousNode;
-    VMesh::Node::array_type newnodes(2);
-    VMesh::Node::index_type n1, n2;
+    if (batch.points.empty())
+      return;
 
-    for (const auto& node : nodes)
+    Point* points = omesh->get_points_pointer() + batch.nodeOffset;
+    std::copy(batch.points.begin(), batch.points.end(), points);
+
+    VMesh::index_type* edges = omesh->get_elems_pointer() + 2 * batch.elemOffset;
+    auto node = static_cast<VMesh::index_type>(batch.nodeOffset);
+    for (const auto& line : batch.lines)
     {
-      if (0 == nodeIndex)
+      for (size_type j = 1; j < line.second; ++j, ++node)
       {
-        n1 = omesh->add_point(node);
-        ofield->resize_values();
-
-        if (value_ == StreamlineValue::SeedValue) ofield->copy_value(seed_field_, idx, n1);
-        else if (value_ == StreamlineValue::SeedIndex) ofield->set_value(index_type(idx), n1);
-        else if (value_ == StreamlineValue::IntegrationIndex) ofield->set_value(abs(cc), n1);
-        else if (value_ == StreamlineValue::IntegrationStep) ofield->set_value(0, n1);
-        else if (value_ == StreamlineValue::DistanceFromSeed) ofield->set_value(partialStreamlineLength, n1);
-        else if (value_ == StreamlineValue::StreamlineLength) ofield->set_value(totalLength, n1);
-
-        cc++;
+        *edges++ = node;
+        *edges++ = node + 1;
       }
-      else
-      {
-        n2 = omesh->add_point(node);
-        ofield->resize_fdata();
-
-        if (value_ == StreamlineValue::SeedValue) ofield->copy_value(seed_field_, idx, n2);
-        else if (value_ == StreamlineValue::SeedIndex) ofield->set_value(index_type(idx), n2);
-        else if (value_ == StreamlineValue::IntegrationIndex) ofield->set_value(abs(cc), n2);
-        else if (value_ == StreamlineValue::IntegrationStep)
-        {
-          double length = Vector(node - previousNode).length();
-          ofield->set_value(length, n2);
-        }
-        else if (value_ == StreamlineValue::DistanceFromSeed)
-        {
-          partialStreamlineLength += Vector(node - previousNode).length();
-          ofield->set_value(partialStreamlineLength, n2);
-        }
-        else if (value_ == StreamlineValue::StreamlineLength)
-        {
-          ofield->set_value(totalLength, n2);
-        }
-
-        newnodes[0] = n1;
-        newnodes[1] = n2;
-
-        omesh->add_elem(newnodes);
-        n1 = n2;
+      ++node;
+    }
 
-        cc++;
-      }
-      ++nodeIndex;
-      previousNode = node;
+    if (value_ == StreamlineValue::SeedValue)
+    {
+      VMesh::Node::index_type n = batch.nodeOffset;
+      for (const auto& line : batch.lines)
+        for (size_type j = 0; j < line.second; ++j, ++n)
+          ofield->copy_value(seed_field_, line.first, n);
+    }
+    else
+    {
+      auto values = static_cast<double*>(ofield->get_values_pointer()) + batch.nodeOffset;
+      std::copy(batch.values.begin(), batch.values.end(), values);
     }
   }
 
-  void GenerateStreamLinesAlgoImplBase::parallel(int proc_num)
+  void GenerateStreamLinesAlgoImplBase::forEachBatch(const std::function<void(index_type)>& task) const
   {
-    success_[proc_num] = true;
-
-    for (int q = 0; q < numprocessors_; q++)
+    const auto numBatches = batches_.size();
+    if (multithreaded_ && numBatches > 1)
     {
-      if (!success_[q])
-        return;
+      Parallel::For(IndexRange(0, numBatches), 1, [&task](const IndexRange& r)
+      {
+        for (auto b = r.begin; b < r.end; ++b)
+          task(static_cast<index_type>(b));
+      });
+    }
+    else
+    {
+      for (size_t b = 0; b < numBatches; ++b)
+        task(static_cast<index_type>(b));
     }
-
-    auto range = partitionNodes(proc_num);
-    outputs_[proc_num] = StreamLinesForCertainSeeds(range.first, range.second, proc_num);
   }
 
   bool GenerateStreamLinesAlgoImplBase::run(FieldHandle input,
@@ -417,30 +372,109 @@ namespace detail
     direction_ = convertDirectionOption(algo_->getOption(Parameters::StreamlineDirection));
     value_ = convertValue(algo_->getOption(Parameters::StreamlineValue));
     remove_colinear_pts_ = algo_->get(Parameters::RemoveColinearPoints).toBool();
+    multithreaded_ = algo_->get(Parameters::UseMultithreading).toBool();
     global_dimension_ = seed_mesh_->num_nodes();
-    if (global_dimension_ < numprocessors_ || numprocessors_ < 1) numprocessors_ = 1;
-    if (numprocessors_ > 16)
-      numprocessors_ = 16;  // limit the number of threads
-    if (!algo_->get(Parameters::UseMultithreading).toBool())
-      numprocessors_ = 1;
-    success_.resize(numprocessors_, true);
-    outputs_.resize(numprocessors_, nullptr);
-
-    Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
-    for (size_t j = 0; j < success_.size(); j++)
+
+    // Streamline lengths vary wildly between seeds, so hand out many small batches and let
+    // idle threads steal them instead of giving each thread one fixed block of seeds.
+    const size_type batchesPerCore = 64;
+    const size_type numCores = multithreaded_ ? Parallel::NumCores() : 1;
+    seedsPerBatch_ = std::max<size_type>(1, global_dimension_ / (batchesPerCore * numCores));
+    batches_.resize((global_dimension_ + seedsPerBatch_ - 1) / seedsPerBatch_);
+
+    LOG_DEBUG("GenerateStreamLines: {} seeds in {} batches of {}", global_dimension_, batches_.size(), seedsPerBatch_);
+
+    forEachBatch([this](index_type b) { traceBatch(b); });
+    if (failed_)
+      return false;
+
+    // Exclusive prefix sum over the batches gives every batch its slice of the output.
+    size_type totalNodes = 0, totalElems = 0;
+    for (auto& batch : batches_)
     {
-      if (!success_[j]) return false;
-      if (!outputs_[j]) return false;
+      batch.nodeOffset = totalNodes;
+      batch.elemOffset = totalElems;
+      totalNodes += batch.points.size();
+      for (const auto& line : batch.lines)
+        totalElems += line.second - 1;
     }
-    JoinFieldsAlgo join;
-    join.set(JoinFieldsAlgo::MergeNodes, false);
-    if (IntegrationMethod::CellWalk == method_)
-      join.set(JoinFieldsAlgo::Tolerance, 1e-8);
-    join.runImpl(outputs_, output);
+
+    auto omesh = output->vmesh();
+    auto ofield = output->vfield();
+    omesh->resize_nodes(totalNodes);
+    omesh->resize_elems(totalElems);
+    ofield->resize_values();
+
+    forEachBatch([this, omesh, ofield](index_type b) { fillOutput(batches_[b], omesh, ofield); });
+
+#ifdef NEEDS_ADDITIONAL_ALGO_OUTPUT
+    algo_->set_int("num_streamlines", num_seeds);
+#endif
 
     return true;
   }
 
+  class GenerateStreamLinesAlgoP : public GenerateStreamLinesAlgoImplBase
+  {
+
+  public:
+    GenerateStreamLinesAlgoP(const AlgorithmBase* algo, IntegrationMethod method) : GenerateStreamLinesAlgoImplBase(algo, method)
+    {}
+  protected:
+    void traceSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, StreamlineBatch& batch) override;
+  };
+
+  void GenerateStreamLinesAlgoP::traceSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, StreamlineBatch& batch)
+  {
+    Vector test;
+    StreamLineIntegrators BI;
+    BI.nodes_.reserve(max_steps_);                  // storage for points
+    BI.tolerance2_ = tolerance_ * tolerance_;      // square error tolerance
+    BI.max_steps_ = max_steps_;                  // max number of steps
+    BI.vfield_ = field_;                       // the vector field
+
+    // Try to find the streamline for each seed point.
+    for (VMesh::Node::index_type idx = from; idx < to; ++idx)
+    {
+      checkForInterruption();
+      seed_mesh_->get_point(BI.seed_, idx);
+
+      // Is the seed point inside the field?
+      if (!field_->interpolate(test, BI.seed_))
+        continue;
+
+      BI.nodes_.clear();
+      BI.nodes_.push_back(BI.seed_);
+
+      int cc = 0;
+
+      // Find the negative streamlines.
+      if (directionIncludesNegative(direction_))
+      {
+        BI.step_size_ = -step_size_;   // initial step size
+        BI.integrate(method_);
+
+        if (directionIsBoth(direction_))
+        {
+          BI.seed_ = BI.nodes_[0];     // Reset the seed
+
+          reverse(BI.nodes_.begin(), BI.nodes_.end());
+          cc = BI.nodes_.size() - 1;
+          cc = -(cc - 1);
+        }
+      }
+
+      // Append the positive streamlines.
+      if (directionIncludesPositive(direction_))
+      {
+        BI.step_size_ = step_size_;   // initial step size
+        BI.integrate(method_);
+      }
+
+      appendStreamline(batch, BI.nodes_, idx, cc);
+    }
+  }
+
   // Cell walk streamline code
   class GenerateStreamLinesAccAlgo : public GenerateStreamLinesAlgoImplBase
   {
@@ -449,87 +483,53 @@ namespace detail
     GenerateStreamLinesAccAlgo(const AlgorithmBase* algo, IntegrationMethod method) : GenerateStreamLinesAlgoImplBase(algo, method)
     {}
   protected:
-    FieldHandle StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num) override;
+    void traceSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, StreamlineBatch& batch) override;
   private:
     void find_nodes(std::vector<Point>& v, Point seed, bool back);
   };
 
-  FieldHandle GenerateStreamLinesAccAlgo::StreamLinesForCertainSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, int proc_num)
+  void GenerateStreamLinesAccAlgo::traceSeeds(VMesh::Node::index_type from, VMesh::Node::index_type to, StreamlineBatch& batch)
   {
-    FieldInformation fi(input_);
-    fi.make_curvemesh();
-    fi.make_lineardata();
-    fi.make_linearmesh();
-    fi.make_double();
-    FieldHandle out;
-    try
+    Point seed;
+    VMesh::Elem::index_type elem;
+    std::vector<Point> nodes;
+    nodes.reserve(max_steps_);
+
+    // Try to find the streamline for each seed point.
+    for (VMesh::Node::index_type idx = from; idx < to; ++idx)
     {
-      out = CreateField(fi);
-      Point seed;
-      VMesh::Elem::index_type elem;
-      std::vector<Point> nodes;
-      nodes.reserve(max_steps_);
-
-      // Try to find the streamline for each seed point.
-      for (VMesh::Node::index_type idx = from; idx < to; ++idx)
-      {
-        seed_mesh_->get_center(seed, idx);
+      checkForInterruption();
+      seed_mesh_->get_center(seed, idx);
 
-        // Is the seed point inside the field?
-        if (!(mesh_->locate(elem, seed)))
-          continue;
-        nodes.clear();
-        nodes.push_back(seed);
+      // Is the seed point inside the field?
+      if (!(mesh_->locate(elem, seed)))
+        continue;
+      nodes.clear();
+      nodes.push_back(seed);
 
-        int cc = 0;
+      int cc = 0;
 
-        // Find the negative streamlines.
-        if (directionIncludesNegative(direction_))
-        {
-          find_nodes(nodes, seed, true);
-
-          if (directionIsBoth(direction_))
-          {
-            std::reverse(nodes.begin(), nodes.end());
-            cc = nodes.size();
-            cc = -(cc - 1);
-          }
-        }
+      // Find the negative streamlines.
+      if (directionIncludesNegative(direction_))
+      {
+        find_nodes(nodes, seed, true);
 
-        // Append the positive streamlines.
-        if (directionIncludesPositive(direction_))
+        if (directionIsBoth(direction_))
         {
-          find_nodes(nodes, seed, false);
+          std::reverse(nodes.begin(), nodes.end());
+          cc = nodes.size();
+          cc = -(cc - 1);
         }
-
-        setOutputData(out, nodes, idx, cc);
-
-        if (proc_num == 0)
-          algo_->update_progress_max(from, to);
       }
 
-#ifdef NEED_ADDITIONAL_ALGO_OUTPUT
-      algo->set_int("num_streamlines", num_seeds);
-#endif
+      // Append the positive streamlines.
+      if (directionIncludesPositive(direction_))
+      {
+        find_nodes(nodes, seed, false);
       }
 
-    catch (const Exception &e)
-    {
-      algo_->error(std::string("Crashed with the following exception:\n") + e.message());
-      success_[proc_num] = false;
-    }
-    catch (const std::string& a)
-    {
-      algo_->error(a);
-      success_[proc_num] = false;
-    }
-    catch (const char *a)
-    {
-      algo_->error(a);
-      success_[proc_num] = false;
+      appendStreamline(batch, nodes, idx, cc);
     }
-
-    return out;
   }
 
   void GenerateStreamLinesAccAlgo::find_nodes(std::vector<Point> &v, Point seed, bool back)
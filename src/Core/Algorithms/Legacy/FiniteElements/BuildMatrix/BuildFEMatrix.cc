@@ -116,7 +116,6 @@ private:
   std::vector<bool> success_;
 
   boost::shared_array<index_type> rows_;
-  boost::shared_array<index_type> allcols_;
   std::vector<index_type> colidx_;
 
   index_type domain_dimension;
@@ -820,11 +819,10 @@ FEMBuilder<T>::parallel(int proc_num)
   std::vector<std::vector<T>> precompute;
   index_type st = 0;
 
-  if (proc_num == 0)
-    allcols_.reset();
-
   try
   {
+    /// the main thread makes the matrix, the threads fill in its
+    /// compressed row storage directly
     if (proc_num == 0)
     {
       for(int i=0; i<numprocessors_; i++)
@@ -835,14 +833,16 @@ FEMBuilder<T>::parallel(int proc_num)
       }
 
       colidx_[numprocessors_] = st;
-      allcols_.reset(new index_type[st]);
+      algo_->remark("Creating fematrix on main thread.");
+      fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension);
+      fematrix_->allocateCompressed(st);
     }
     success_[proc_num] = true;
   }
   catch (...)
   {
     if (proc_num == 0)
-      allcols_.reset();
+      fematrix_.reset();
 
     algo_->error("Could not allocate enough memory");
     success_[proc_num] = false;
@@ -862,13 +862,12 @@ FEMBuilder<T>::parallel(int proc_num)
   {
     /// updating global column by each of the processors
     const index_type s = colidx_[proc_num];
-    const size_t n = mycols.size();
-
-    for(size_t i=0; i<n; i++)
-      allcols_[i+s] = mycols[i];
+    std::copy(mycols.begin(), mycols.end(), fematrix_->get_cols() + s);
+    std::vector<index_type>().swap(mycols);
 
+    auto rows = fematrix_->get_rows();
     for(index_type i = start_gd; i<end_gd; i++)
-      rows_[i] += s;
+      rows[i] = rows_[i] + s;
 
     success_[proc_num] = true;
   }
@@ -890,14 +889,12 @@ FEMBuilder<T>::parallel(int proc_num)
 
   try
   {
-    /// the main thread makes the matrix
+    /// the main thread validates the structure
     if (proc_num == 0)
     {
-      rows_[global_dimension] = st;
-      algo_->remark("Creating fematrix on main thread.");
-      fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension, rows_.get(), allcols_.get(), st);
+      fematrix_->get_rows()[global_dimension] = st;
+      fematrix_->finishCompressed();
       rows_.reset();
-      allcols_.reset();
     }
     success_[proc_num] = true;
   }
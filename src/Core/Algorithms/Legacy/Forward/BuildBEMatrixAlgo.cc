@@ -54,11 +54,13 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
@@ -514,8 +516,161 @@ public:
   double,
   double,
   const std::vector<double>& );
+
+protected:
+  //! Surface geometry pulled out of the VMesh once, so the assembly loops do not
+  //! go through the virtual mesh interface for every node/triangle pair.
+  struct FlatSurface
+  {
+    explicit FlatSurface(VMesh* hsurf);
+    size_t numNodes() const { return points.size(); }
+    size_t numFaces() const { return faces.size() / 3; }
+    const VMesh::index_type* face(size_t f) const { return &faces[3*f]; }
+
+    std::vector<Vector> points;
+    std::vector<VMesh::index_type> faces;
+  };
+
+  //! Per-triangle constants of the 7-point Radon rule used for the G matrices:
+  //! the Radon points, and the Cruse weights premultiplied by area and Radon weights.
+  struct RadonTriangle
+  {
+    Vector points[7];
+    double weights[3][7];
+
+    void integrate(const Vector& op, double g[3]) const
+    {
+      double g_coef[7];
+      for (int k = 0; k < 7; ++k)
+        g_coef[k] = 1 / (points[k] - op).length();
+      for (int i = 0; i < 3; ++i)
+      {
+        g[i] = 0;
+        for (int k = 0; k < 7; ++k)
+          g[i] += weights[i][k] * g_coef[k];
+      }
+    }
+  };
+
+  struct RadonRule
+  {
+    RadonRule();
+    DenseMatrix R_W; // Radon Points Weights
+    double s, r;
+  };
+
+  static std::vector<RadonTriangle> radon_triangles(const FlatSurface& surf, const RadonRule& rule, const std::vector<double>& avInn);
+
+  //! Output matrices of bem_sing, which also takes the Radon weights by non-const reference.
+  struct SingularScratch
+  {
+    explicit SingularScratch(const RadonRule& rule) : g_values(3, 1), R_W(rule.R_W) {}
+    DenseMatrix g_values;
+    DenseMatrix R_W;
+  };
+
+  struct NoScratch {};
+
+  //! Runs task(row, firstFace, lastFace, scratch) over tiles of matrix rows and triangles.
+  //! Row tiles are processed in parallel and every row is owned by exactly one tile, so tasks
+  //! can accumulate into their rows without locking. Each tile gets its own copy of scratch,
+  //! made once and reused for all of its rows. Within a tile a block of triangles is reused
+  //! for all rows before moving on, and each matrix entry still receives its contributions
+  //! in triangle order.
+  template <class Scratch, class Task>
+  static void for_each_tile(size_t rows, size_t faces, const Scratch& scratch, Task task)
+  {
+    const size_t rowTile = 64;
+    const size_t faceTile = 256;
+    Parallel::For(IndexRange(0, (rows + rowTile - 1) / rowTile), 1, [&](const IndexRange& range)
+    {
+      for (size_t t = range.begin; t < range.end; ++t)
+      {
+        Scratch tileScratch(scratch);
+        const size_t endRow = std::min(rows, (t + 1) * rowTile);
+        for (size_t f = 0; f < faces; f += faceTile)
+        {
+          const size_t endFace = std::min(faces, f + faceTile);
+          for (size_t row = t * rowTile; row < endRow; ++row)
+            task(row, f, endFace, tileScratch);
+        }
+      }
+    });
+  }
 };
 
+BuildBEMatrixBaseCompute::FlatSurface::FlatSurface(VMesh* hsurf)
+{
+  VMesh::Node::size_type nnodes;
+  hsurf->size(nnodes);
+  points.reserve(nnodes);
+  for (VMesh::Node::index_type i = 0; i < nnodes; ++i)
+    points.emplace_back(hsurf->get_point(i));
+
+  VMesh::Face::size_type nfaces;
+  hsurf->size(nfaces);
+  faces.reserve(3 * nfaces);
+  VMesh::Node::array_type nodes;
+  for (VMesh::Face::index_type f = 0; f < nfaces; ++f)
+  {
+    hsurf->get_nodes(nodes, f);
+    faces.insert(faces.end(), nodes.begin(), nodes.begin() + 3);
+  }
+}
+
+BuildBEMatrixBaseCompute::RadonRule::RadonRule() : R_W(1, 7)
+{
+  double sqrt15 = sqrt(15.0);
+  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
+  R_W(0,0) = 9.0/40.0;
+  R_W(0,1) = (155 + sqrt15) / 1200;
+  R_W(0,2) = R_W(0,1);
+  R_W(0,3) = R_W(0,1);
+  R_W(0,4) = (155 - sqrt15) / 1200;
+  R_W(0,5) = R_W(0,4);
+  R_W(0,6) = R_W(0,4);
+
+  s = (1 - sqrt15) / 7;
+  r = (1 + sqrt15) / 7;
+}
+
+std::vector<BuildBEMatrixBaseCompute::RadonTriangle> BuildBEMatrixBaseCompute::radon_triangles(
+  const FlatSurface& surf, const RadonRule& rule, const std::vector<double>& avInn)
+{
+  std::vector<RadonTriangle> triangles(surf.numFaces());
+
+  Parallel::For(IndexRange(0, surf.numFaces()), 0, [&](const IndexRange& range)
+  {
+    DenseMatrix cruse_weights(3, 7);
+    for (size_t f = range.begin; f < range.end; ++f)
+    {
+      const auto* nodes = surf.face(f);
+      const Vector& p1 = surf.points[nodes[0]];
+      const Vector& p2 = surf.points[nodes[1]];
+      const Vector& p3 = surf.points[nodes[2]];
+      const double area = avInn[f];
+
+      get_cruse_weights(p1, p2, p3, rule.s, rule.r, area, cruse_weights);
+
+      auto& tri = triangles[f];
+      const Vector centroid = (p1 + p2 + p3) / 3.0;
+      tri.points[0] = centroid;
+      tri.points[1] = centroid * (1 - rule.s) + p1 * rule.s;
+      tri.points[2] = centroid * (1 - rule.s) + p2 * rule.s;
+      tri.points[3] = centroid * (1 - rule.s) + p3 * rule.s;
+      tri.points[4] = centroid * (1 - rule.r) + p1 * rule.r;
+      tri.points[5] = centroid * (1 - rule.r) + p2 * rule.r;
+      tri.points[6] = centroid * (1 - rule.r) + p3 * rule.r;
+
+      for (int i = 0; i < 3; ++i)
+        for (int k = 0; k < 7; ++k)
+          tri.weights[i][k] = area * cruse_weights(i, k) * rule.R_W(0, k);
+    }
+  });
+
+  return triangles;
+}
+
 void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
 {
   auto nnodes = numNodes(hsurf);
@@ -536,66 +691,41 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
+  const FlatSurface surf(hsurf);
+  const RadonRule rule;
+  const auto triangles = radon_triangles(surf, rule, avInn);
 
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
+  for_each_tile(surf.numNodes(), surf.numFaces(), SingularScratch(rule),
+    [&](size_t ppi, size_t firstFace, size_t lastFace, SingularScratch& scratch)
+  { //! for every node
+    double g[3];
+    const Vector& op = surf.points[ppi];
+    const VMesh::index_type node = static_cast<VMesh::index_type>(ppi);
 
-  double area;
+    for (size_t f = firstFace; f < lastFace; ++f)
+    { //! find contributions from every triangle
+      const auto* nodes = surf.face(f);
 
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
+      int sing = -1;
+      if (node == nodes[0])       sing = 0;
+      else if (node == nodes[1])  sing = 1;
+      else if (node == nodes[2])  sing = 2;
 
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values, s, r, R_W);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values, s, r, R_W);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values, s, r, R_W);
+      if (sing >= 0)
+      {
+        bem_sing(surf.points[nodes[0]], surf.points[nodes[1]], surf.points[nodes[2]], sing, scratch.g_values, rule.s, rule.r, scratch.R_W);
+        for (int i=0; i<3; ++i)
+          g[i] = scratch.g_values(i,0);
+      }
       else
       {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
+        triangles[f].integrate(op, g);
+      }
 
       for (int i=0; i<3; ++i)
-        auto_G(ppi, nodes[i])+=g_values(i,0)*mult;
+        auto_G(ppi, nodes[i])+=g[i]*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -617,60 +747,25 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
+  const RadonRule rule;
+  const auto triangles = radon_triangles(surf2, rule, avInn);
 
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
+  for_each_tile(surf1.numNodes(), surf2.numFaces(), NoScratch(), [&](size_t ppi, size_t firstFace, size_t lastFace, NoScratch&)
+  { //! for every node
+    double g[3];
+    const Vector& op = surf1.points[ppi];
 
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-      g_values = area * (cruse_weights * temp.transpose());
+    for (size_t f = firstFace; f < lastFace; ++f)
+    { //! find contributions from every triangle
+      const auto* nodes = surf2.face(f);
+      triangles[f].integrate(op, g);
 
       for (int i=0; i<3; ++i)
-        cross_G(ppi, nodes[i])+=g_values(i,0)*mult;
+        cross_G(ppi, nodes[i])+=g[i]*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -690,32 +785,24 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
 
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
+  const FlatSurface surf1(hsurf1);
+  const FlatSurface surf2(hsurf2);
 
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
+  for_each_tile(surf1.numNodes(), surf2.numFaces(), DenseMatrix(1, 3),
+    [&](size_t ppi, size_t firstFace, size_t lastFace, DenseMatrix& coef)
+  { //! for every node
+    const Vector& pp = surf1.points[ppi];
 
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+    for (size_t f = firstFace; f < lastFace; ++f)
+    { //! find contributions from every triangle
+      const auto* nodes = surf2.face(f);
+      getOmega(surf2.points[nodes[0]] - pp, surf2.points[nodes[1]] - pp, surf2.points[nodes[2]] - pp, coef);
 
-      getOmega(v1, v2, v3, coef);
-
-      for (i=0; i<3; ++i)
+      for (int i=0; i<3; ++i)
         cross_P(ppi, nodes[i])-=coef(0,i)*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -741,46 +828,32 @@ void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& aut
 {
   auto nnodes = auto_P.rows();
 
-
-
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
+  const FlatSurface surf(hsurf);
 
-  unsigned int i;
+  for_each_tile(surf.numNodes(), surf.numFaces(), DenseMatrix(1, 3),
+    [&](size_t ppi, size_t firstFace, size_t lastFace, DenseMatrix& coef)
+  { //! for every node
+    const Vector& pp = surf.points[ppi];
+    const VMesh::index_type node = static_cast<VMesh::index_type>(ppi);
 
-  hsurf->begin(ni); hsurf->end(nie);
+    for (size_t f = firstFace; f < lastFace; ++f)
+    { //! find contributions from every triangle
+      const auto* nodes = surf.face(f);
+      if (node!=nodes[0] && node!=nodes[1] && node!=nodes[2]){
+        getOmega(surf.points[nodes[0]] - pp, surf.points[nodes[1]] - pp, surf.points[nodes[2]] - pp, coef);
 
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
-
-    hsurf->begin(fi); hsurf->end(fie);
-
-    for (; fi != fie; ++fi) { //! find contributions from every triangle
-
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2]){
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
-
-        getOmega(v1, v2, v3, coef);
-
-        for (i=0; i<3; ++i)
+        for (int i=0; i<3; ++i)
           auto_P(ppi, nodes[i])-=coef(0,i)*mult;
       }
     }
-  }
+  });
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
@@ -1036,6 +1109,46 @@ static void printInfo(const DenseMatrix& m, const std::string& name)
 #endif
 }
 
+namespace
+{
+  // Column blocks of a dense product or solve are independent of each other, so the
+  // final combination of the BEM blocks is spread over threads one column block at a time.
+  template <class BlockOp>
+  DenseMatrix by_column_blocks(Eigen::Index rows, Eigen::Index cols, BlockOp op)
+  {
+    const Eigen::Index width = 64;
+    DenseMatrix result(rows, cols);
+    Parallel::For(IndexRange(0, static_cast<size_t>((cols + width - 1) / width)), 1, [&](const IndexRange& range)
+    {
+      for (size_t b = range.begin; b < range.end; ++b)
+      {
+        const Eigen::Index first = static_cast<Eigen::Index>(b) * width;
+        const Eigen::Index n = std::min(width, cols - first);
+        result.middleCols(first, n) = op(first, n);
+      }
+    });
+    return result;
+  }
+
+  DenseMatrix parallel_product(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B)
+  {
+    return by_column_blocks(A.rows(), B.cols(), [&](Eigen::Index first, Eigen::Index n) -> Eigen::MatrixXd
+    {
+      return A * B.middleCols(first, n);
+    });
+  }
+
+  // inv(A)*B through one LU factorization instead of an explicit inverse
+  DenseMatrix parallel_solve(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B)
+  {
+    const Eigen::PartialPivLU<Eigen::MatrixXd> lu(A);
+    return by_column_blocks(A.cols(), B.cols(), [&](Eigen::Index first, Eigen::Index n) -> Eigen::MatrixXd
+    {
+      return lu.solve(B.middleCols(first, n));
+    });
+  }
+}
+
 MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
 {
   // Math for surface-to-surface BEM algorithm (based on Jeroen Stinstra's BEM Matlab code that's part of SCIRun)
@@ -1239,12 +1352,12 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
   // Compute T here (see math in comments above)
   // TransferMatrix = T = inv(Pmm - Gms*iGss*Psm)*(Gms*iGss*Pss - Pms) = inv(C)*D
 
-  auto Y = Gms.matrix() * Gss.matrix().inverse();
-  auto C = Pmm.matrix() - Y * Psm.matrix();
-  auto D = Y * Pss.matrix() - Pms.matrix();
+  // Y = Gms*inv(Gss) is computed as the transpose of inv(Gss^T)*Gms^T
+  const Eigen::MatrixXd Y = parallel_solve(Gss.matrix().transpose(), Gms.matrix().transpose()).transpose();
+  const Eigen::MatrixXd C = Pmm.matrix() - parallel_product(Y, Psm.matrix());
+  const Eigen::MatrixXd D = parallel_product(Y, Pss.matrix()) - Pms.matrix();
 
-  auto T = C.inverse() * D; // T = inv(C)*D
-  return boost::make_shared<DenseMatrix>(T);
+  return boost::make_shared<DenseMatrix>(parallel_solve(C, D)); // T = inv(C)*D
 
   //This could be done on one line (see below), but Y (see above) would need to be calculated twice:
   //MatrixHandle TransferMatrix1 = inv(Pmm - Gms * Gss * Psm) * (Gms * Gss * Pss - Pms);
@@ -1318,5 +1431,5 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
   make_auto_G( surface, Gss, 1.0, 0.0, 1.0, area );
   make_cross_G( nodes, surface, Gns, 1.0, 0.0, 1.0, area );
 
-  return boost::make_shared<DenseMatrix>(*Pns - (*Gns * Gss->inverse() * *Pss));
+  return boost::make_shared<DenseMatrix>(*Pns - parallel_product(*Gns, parallel_solve(*Gss, *Pss)));
 }
@@ -0,0 +1,183 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/math/constants/constants.hpp>
+#include <array>
+#include <map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Forward;
+
+class BuildBEMatrixTests : public ::testing::Test
+{
+protected:
+  // Icosphere centered at the origin, with outward facing triangles. Two levels give
+  // 162 nodes and 320 triangles, enough to span several row and triangle tiles.
+  static FieldHandle sphere(double radius, int levels = 2)
+  {
+    const double t = (1 + sqrt(5.0)) / 2;
+    std::vector<Vector> points = {
+      { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+      { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+      { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 } };
+    std::vector<std::array<int, 3>> faces = {
+      {{ 0, 11, 5 }}, {{ 0, 5, 1 }}, {{ 0, 1, 7 }}, {{ 0, 7, 10 }}, {{ 0, 10, 11 }},
+      {{ 1, 5, 9 }}, {{ 5, 11, 4 }}, {{ 11, 10, 2 }}, {{ 10, 7, 6 }}, {{ 7, 1, 8 }},
+      {{ 3, 9, 4 }}, {{ 3, 4, 2 }}, {{ 3, 2, 6 }}, {{ 3, 6, 8 }}, {{ 3, 8, 9 }},
+      {{ 4, 9, 5 }}, {{ 2, 4, 11 }}, {{ 6, 2, 10 }}, {{ 8, 6, 7 }}, {{ 9, 8, 1 }} };
+
+    for (int level = 0; level < levels; ++level)
+    {
+      std::map<std::pair<int, int>, int> midpoints;
+      auto midpoint = [&](int a, int b)
+      {
+        auto key = std::make_pair(std::min(a, b), std::max(a, b));
+        auto found = midpoints.find(key);
+        if (found != midpoints.end())
+          return found->second;
+        points.push_back((points[a] + points[b]) / 2);
+        return midpoints[key] = static_cast<int>(points.size()) - 1;
+      };
+      std::vector<std::array<int, 3>> refined;
+      for (const auto& f : faces)
+      {
+        const int ab = midpoint(f[0], f[1]), bc = midpoint(f[1], f[2]), ca = midpoint(f[2], f[0]);
+        refined.push_back({{ f[0], ab, ca }});
+        refined.push_back({{ f[1], bc, ab }});
+        refined.push_back({{ f[2], ca, bc }});
+        refined.push_back({{ ab, bc, ca }});
+      }
+      faces.swap(refined);
+    }
+
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    auto field = CreateField(fi);
+    auto mesh = field->vmesh();
+    for (const auto& p : points)
+      mesh->add_point(Point(p.normal() * radius));
+    VMesh::Node::array_type nodes(3);
+    for (const auto& f : faces)
+    {
+      for (int i = 0; i < 3; ++i)
+        nodes[i] = f[i];
+      mesh->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  static std::vector<double> areas(const FieldHandle& field)
+  {
+    std::vector<double> result;
+    BuildBEMatrixBase::pre_calc_tri_areas(field->vmesh(), result);
+    return result;
+  }
+
+  static double rowSum(const DenseMatrix& m, int row)
+  {
+    return m.row(row).sum();
+  }
+
+  // The tessellated spheres are a little smaller than the analytic ones.
+  static constexpr double tolerance = 0.02;
+  const double pi = boost::math::constants::pi<double>();
+  const double innerRadius = 1, outerRadius = 2;
+};
+
+// Every row of G integrates 1/r over the surface, since the linear basis functions sum
+// to one: 4*pi*R for a point on a sphere of radius R. The multiplier with unit conductivity
+// jump is 1/(4*pi), so rows should sum to R.
+TEST_F(BuildBEMatrixTests, AutoGMatchesSingleLayerPotentialOfSphere)
+{
+  auto surf = sphere(outerRadius);
+  DenseMatrixHandle G;
+  BuildBEMatrixBase::make_auto_G(surf->vmesh(), G, 0, 1, 1, areas(surf));
+
+  ASSERT_EQ(162, G->rows());
+  for (int i = 0; i < G->rows(); ++i)
+    EXPECT_NEAR(outerRadius, rowSum(*G, i), tolerance * outerRadius);
+}
+
+// Inside a sphere the single layer potential is constant at R; outside it falls off as R^2/|x|.
+TEST_F(BuildBEMatrixTests, CrossGMatchesSingleLayerPotentialOfNestedSpheres)
+{
+  auto inner = sphere(innerRadius), outer = sphere(outerRadius);
+  DenseMatrixHandle innerToOuter, outerToInner;
+  BuildBEMatrixBase::make_cross_G(inner->vmesh(), outer->vmesh(), innerToOuter, 0, 1, 1, areas(outer));
+  BuildBEMatrixBase::make_cross_G(outer->vmesh(), inner->vmesh(), outerToInner, 0, 1, 1, areas(inner));
+
+  for (int i = 0; i < innerToOuter->rows(); ++i)
+  {
+    EXPECT_NEAR(outerRadius, rowSum(*innerToOuter, i), tolerance * outerRadius);
+    const double expected = innerRadius * innerRadius / outerRadius;
+    EXPECT_NEAR(expected, rowSum(*outerToInner, i), tolerance * expected);
+  }
+}
+
+// Rows of P add up solid angles over a closed surface: the whole sphere from inside it,
+// nothing from outside it.
+TEST_F(BuildBEMatrixTests, CrossPMatchesSolidAnglesOfNestedSpheres)
+{
+  auto inner = sphere(innerRadius), outer = sphere(outerRadius);
+  DenseMatrixHandle innerToOuter, outerToInner;
+  BuildBEMatrixBase::make_cross_P(inner->vmesh(), outer->vmesh(), innerToOuter, 0, 1, 1);
+  BuildBEMatrixBase::make_cross_P(outer->vmesh(), inner->vmesh(), outerToInner, 0, 1, 1);
+
+  for (int i = 0; i < innerToOuter->rows(); ++i)
+  {
+    EXPECT_NEAR(1, std::abs(rowSum(*innerToOuter, i)), 1e-10);
+    EXPECT_NEAR(0, rowSum(*outerToInner, i), 1e-10);
+  }
+}
+
+// The diagonal of auto P is chosen so each row adds up to the outside conductivity. The
+// triangles around a node are skipped, so from a point on a sphere the others cover less
+// than half of the full solid angle.
+TEST_F(BuildBEMatrixTests, AutoPRowsAddUpToOutsideConductivity)
+{
+  auto surf = sphere(outerRadius);
+  DenseMatrixHandle P;
+  BuildBEMatrixBase::make_auto_P(surf->vmesh(), P, 0, 1, 1);
+
+  for (int i = 0; i < P->rows(); ++i)
+  {
+    EXPECT_NEAR(1, rowSum(*P, i), 1e-10);
+    const double offDiagonal = std::abs(1 - (*P)(i, i));
+    EXPECT_GT(offDiagonal, 0.4);
+    EXPECT_LT(offDiagonal, 0.5);
+  }
+}
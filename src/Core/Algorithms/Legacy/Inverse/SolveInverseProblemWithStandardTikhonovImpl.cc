@@ -31,6 +31,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 
 #include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
@@ -42,10 +43,13 @@
 #include <Core/Datatypes/MatrixTypeConversions.h>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
 
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Utils/Exception.h>
 
+#include <Eigen/Eigenvalues>
+
 using namespace SCIRun;
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Datatypes;
@@ -64,29 +68,28 @@ using namespace SCIRun::Core::Algorithms::Inverse;
         //............................
         //
         //      G = (M1 + lambda^2 * M2)
-        //      b = G^-1 * y
+        //      b = G^-1 * y = Q * (D + lambda^2)^-1 * Q^T * y
         //      x = M3 * b
         //
         //      A^-1 = M3 * G^-1 * M4
         //...........................................................................................................
-        const int sizeB = M1.ncols();
-        const int sizeSolution = M3.nrows();
-        const int numTimeSamples = y.ncols();
-        DenseMatrix inverseG(sizeB,sizeB);
-
-        DenseMatrix b(sizeB);
-        DenseMatrix solution(sizeSolution,numTimeSamples);
-        DenseMatrix G;
+        const auto& eigenvalues = decomposition->eigenvalues;
+        const double lambda_sq = lambda * lambda;
 
-        G = M1 + lambda * lambda * M2;
+        DenseColumnMatrix scale(eigenvalues.nrows());
+        for (int i = 0; i < eigenvalues.nrows(); i++)
+        {
+            const double denominator = eigenvalues[i] + lambda_sq;
+            scale[i] = denominator > 0 ? 1.0 / denominator : 0.0;
+        }
 
-        b = G.lu().solve(y).eval();
+        DenseMatrix b = decomposition->eigenvectors * ( scale.asDiagonal() * Qy );
 
-        solution = M3 * b;
+        DenseMatrix solution = M3 * b;
 
         // if (inverseCalculation)
         // {
-        //     inverseG = G.inverse().eval();
+        //     inverseG = Q * (D + lambda^2)^-1 * Q^T;
         //     inverseMatrix_.reset( new DenseMatrix( (M3 * inverseG) * M4) );
         // }
         //     inverseSolution_.reset(new DenseMatrix(solution));
@@ -95,6 +98,79 @@ using namespace SCIRun::Core::Algorithms::Inverse;
 //////// fi compute inverse solution
 ////////////////////////
 
+/////// L-curve norms
+///////////////
+    bool SolveInverseProblemWithStandardTikhonovImpl::computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const
+    {
+        // Without weighting M1 is A*A^T (underdetermined) or A^T*A (overdetermined), so its eigenvalues are the
+        // squared singular values of A and Q holds the left or right singular vectors
+        if (weighted)
+            return false;
+
+        const auto& eigenvalues = decomposition->eigenvalues;
+        const int size = eigenvalues.nrows();
+        DenseColumnMatrix singularValues(size);
+        DenseColumnMatrix projectedData = Qy.rowwise().squaredNorm();
+
+        const double tolerance = size * std::numeric_limits<double>::epsilon() * std::max(eigenvalues.maxCoeff(), 0.0);
+        for (int i = 0; i < size; i++)
+        {
+            const double d = eigenvalues[i] > tolerance ? eigenvalues[i] : 0.0;
+            singularValues[i] = std::sqrt(d);
+
+            // overdetermined: y = A^T * data, so Q^T * y is scaled by the singular values
+            if (overdetermined)
+                projectedData[i] = d > 0 ? projectedData[i] / d : 0.0;
+        }
+
+        tikhonovLcurveNorms( singularValues, projectedData, dataNorm, size, lambdaArray, rho, eta );
+        return true;
+    }
+
+/////// decompose G
+///////////////
+    void SolveInverseProblemWithStandardTikhonovImpl::decompose(const DenseMatrix& forwardMatrix_, const boost::function<DenseMatrix()>& computeM1, const DenseMatrix& M2, const DenseMatrix& y)
+    {
+        using SCIRun::Core::Algorithms::Math::LinearSolverCache;
+
+        // Without weighting, G only depends on the forward matrix, so its decomposition is kept for the next
+        // execution (e.g. when only the lambda range changes)
+        auto& cache = LinearSolverCache::instance();
+        const auto key = LinearSolverCache::key(forwardMatrix_);
+        const std::string name = overdetermined ? "standard Tikhonov A^T*A" : "standard Tikhonov A*A^T";
+        if (!weighted)
+            decomposition = cache.find<Decomposition>(key, name);
+
+        if (!decomposition)
+        {
+            auto result = boost::make_shared<Decomposition>();
+            DenseMatrix M1 = computeM1();
+            if (!weighted)
+            {
+                Eigen::SelfAdjointEigenSolver<DenseMatrix::EigenBase> eigenSolver(M1);
+                result->eigenvectors = eigenSolver.eigenvectors();
+                result->eigenvalues = eigenSolver.eigenvalues();
+            }
+            else
+            {
+                // generalized problem M1 * q = d * M2 * q, with eigenvectors normalized to Q^T * M2 * Q = I
+                Eigen::GeneralizedSelfAdjointEigenSolver<DenseMatrix::EigenBase> eigenSolver(M1, M2);
+                if (eigenSolver.info() != Eigen::Success)
+                {
+                    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Regularization matrix is not positive definite.");
+                }
+                result->eigenvectors = eigenSolver.eigenvectors();
+                result->eigenvalues = eigenSolver.eigenvalues();
+            }
+
+            if (!weighted)
+                cache.insert(key, name, result, sizeof(double) * (result->eigenvectors.size() + result->eigenvalues.size()));
+            decomposition = result;
+        }
+
+        Qy = decomposition->eigenvectors.transpose() * y;
+    }
+
 /////// precomputeInverseMatrices
 ///////////////
     void SolveInverseProblemWithStandardTikhonovImpl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const int regularizationChoice_, const int regularizationSolutionSubcase_, const int regularizationResidualSubcase_)
@@ -105,8 +181,8 @@ using namespace SCIRun::Core::Algorithms::Inverse;
         const int M = forwardMatrix_.nrows();
         const int N = forwardMatrix_.ncols();
 
-        // PREALOCATE VARIABLES and MATRICES
-        DenseMatrix forward_transpose = forwardMatrix_.transpose();
+        dataNorm = measuredData_.squaredNorm();
+        weighted = false;
 
 		// get Parameters
 		// auto  regularizationChoice_ = get(regularizationChoice).toInt();
@@ -128,21 +204,20 @@ using namespace SCIRun::Core::Algorithms::Inverse;
             //      M4 = identity
             //      y = measuredData
             //.........................M1,................................................
+            overdetermined = false;
 
-            DenseMatrix RRtr(N,N);
-            DenseMatrix iRRtr(N,N);
-            DenseMatrix CCtr(M,M);
-            DenseMatrix iCCtr(M,M);
+            DenseMatrix M2;
 
             // DEFINITIONS AND PREALOCATION OF SOURCE REGULARIZATION MATRIX 'R'
             // if R does not exist, set as identity of size equal to N (columns of fwd matrix)
             if (true)//(&sourceWeighting_==NULL)
             {
-                RRtr = DenseMatrix::Identity(N, N);
-                iRRtr = RRtr;
+                // DEFINE M3 = (R^TR)^-1 * A^T = A^T, without forming the N x N identity
+                M3 = forwardMatrix_.transpose();
             }
             else
             {
+                DenseMatrix RRtr(N,N);
 
                 // if provided the non-squared version of R
                 if( regularizationSolutionSubcase_ ==  TikhonovAlgoAbstractBase::solution_constrained )
@@ -163,9 +238,10 @@ using namespace SCIRun::Core::Algorithms::Inverse;
                     THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Regularization matrix in the source space is not invertible.");
                 }
 
-                // COMPUTE inverse
-                iRRtr = LURRtr.inverse().eval();
-
+                // DEFINE M3 = (R^TR)^-1 * A^T
+                DenseMatrix iRRtr = LURRtr.inverse().eval();
+                M3 = iRRtr * forwardMatrix_.transpose();
+                weighted = true;
             }
 
 
@@ -173,12 +249,12 @@ using namespace SCIRun::Core::Algorithms::Inverse;
             // if C does not exist, set as identity of size equal to M (rows of fwd matrix)
             if (true)//(&sensorWeighting_==NULL)
             {
-                CCtr = DenseMatrix::Identity(M, M);
-                iCCtr = CCtr;
-
+                M2 = DenseMatrix::Identity(M, M);
             }
             else
             {
+                DenseMatrix CCtr(M,M);
+
                 // if measurement covariance matrix provided in non-squared form
                 if (regularizationResidualSubcase_ ==  TikhonovAlgoAbstractBase::residual_constrained)
                 {
@@ -200,29 +276,16 @@ using namespace SCIRun::Core::Algorithms::Inverse;
                 {
                     THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Residual covariance matrix is not invertible.");
                 }
-                iCCtr = LUCCtr.inverse().eval();
-
-
 
+                // DEFINE M2 = (C^TC)^-1
+                M2 = LUCCtr.inverse().eval();
+                weighted = true;
             }
 
-            // DEFINE  M1 = (A * (R^T*R)^-1 * A^T MATRIX FOR FASTER COMPUTATION
-            DenseMatrix RAtr = iRRtr * forward_transpose;
-            M1 = forwardMatrix_ * RAtr;
-
-            // DEFINE M2 = (C^TC)^-1
-            M2 = iCCtr;
-
-            // DEFINE M3 = (R^TR)^-1 * A^T
-            M3 = RAtr;
-
-            // DEFINE M4 = identity (size of number of measurements)
-            M4 = DenseMatrix::Identity(M, N);
-
-            // DEFINE measurement vector
-            y = measuredData_;
-
-
+            // DEFINE  M1 = (A * (R^T*R)^-1 * A^T MATRIX, only needed when its decomposition is not cached
+            // DEFINE measurement vector y = measuredData
+            const DenseMatrix& RAtr = M3;
+            decompose( forwardMatrix_, [&forwardMatrix_, &RAtr]() { return DenseMatrix(forwardMatrix_ * RAtr); }, M2, measuredData_ );
 
         }
         //OVERDETERMINED CASE,
@@ -241,11 +304,11 @@ using namespace SCIRun::Core::Algorithms::Inverse;
             //      M4 = A^TC^TC
             //      y = A * C^T*C * measuredData
             //.........................................................................
-
+            overdetermined = true;
 
             // prealocations
             DenseMatrix RtrR(N,N);
-            DenseMatrix CtrC(M,M);
+            DenseMatrix CtrCA;
 
 
             // DEFINITIONS AND PREALOCATION OF SOURCE REGULARIZATION MATRIX 'R'
@@ -267,6 +330,7 @@ using namespace SCIRun::Core::Algorithms::Inverse;
                 {
                     RtrR = sourceWeighting_;
                 }
+                weighted = true;
             }
 
 
@@ -274,10 +338,12 @@ using namespace SCIRun::Core::Algorithms::Inverse;
             // if C does not exist, set as identity of size equal to M (rows of fwd matrix)
             if (true)//(&sensorWeighting_==NULL)
             {
-                CtrC = DenseMatrix::Identity(M, M);
+                CtrCA = forwardMatrix_;
             }
             else
             {
+                DenseMatrix CtrC(M,M);
+
                 // if measurement covariance matrix provided in non-squared form
                 if (regularizationResidualSubcase_ ==  TikhonovAlgoAbstractBase::residual_constrained)
                 {
@@ -288,24 +354,17 @@ using namespace SCIRun::Core::Algorithms::Inverse;
                 {
                     CtrC = sensorWeighting_;
                 }
-
+                CtrCA = CtrC * (forwardMatrix_);
+                weighted = true;
             }
 
-            // DEFINE  M1 = (A * (R*R^T)^-1 * A^T MATRIX FOR FASTER COMPUTATION
-            DenseMatrix CtrCA = CtrC * (forwardMatrix_);
-            M1 = forward_transpose * CtrCA;
-
-            // DEFINE M2 = (CC^T)^-1
-            M2 = RtrR;
-
             // DEFINE M3 = identity (size of number of measurements)
             M3 = DenseMatrix::Identity(N, N);
 
-            // DEFINT M4 = A^T* C^T * C
-            M4 = CtrCA.transpose();
-
-            // DEFINE measurement vector
-            y = CtrCA.transpose() * measuredData_;
+            // DEFINE  M1 = A^T * C^T*C * A, only needed when its decomposition is not cached
+            // DEFINE M2 = R^T*R
+            // DEFINE measurement vector y = A^T * C^T*C * measuredData
+            decompose( forwardMatrix_, [&forwardMatrix_, &CtrCA]() { return DenseMatrix(forwardMatrix_.transpose() * CtrCA); }, RtrR, CtrCA.transpose() * measuredData_ );
 
         }
 
@@ -35,6 +35,7 @@
 #include <vector>
 #include <boost/utility.hpp>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <Core/Datatypes/MatrixFwd.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -59,15 +60,26 @@ namespace SCIRun {
 
 			    private:
 
-			        SCIRun::Core::Datatypes::DenseMatrix M1;
-			        SCIRun::Core::Datatypes::DenseMatrix M2;
+			        // G = M1 + lambda^2 * M2 diagonalized once as G = M2 * Q * (D + lambda^2) * Q^T * M2 with Q^T * M2 * Q = I,
+			        // so that each lambda only costs a diagonal scaling instead of a factorization of G
+			        struct Decomposition
+			        {
+			            SCIRun::Core::Datatypes::DenseMatrix eigenvectors;
+			            SCIRun::Core::Datatypes::DenseColumnMatrix eigenvalues;
+			        };
+
+			        boost::shared_ptr<const Decomposition> decomposition;
 			        SCIRun::Core::Datatypes::DenseMatrix M3;
-			        SCIRun::Core::Datatypes::DenseMatrix M4;
-			        SCIRun::Core::Datatypes::DenseMatrix y;
+			        SCIRun::Core::Datatypes::DenseMatrix Qy;
+			        double dataNorm;
+			        bool overdetermined;
+			        bool weighted;
 
 							void preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const int regularizationChoice_, const int regularizationSolutionSubcase_, const int regularizationResidualSubcase_ );
+			        void decompose(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const boost::function<SCIRun::Core::Datatypes::DenseMatrix()>& computeM1, const SCIRun::Core::Datatypes::DenseMatrix& M2, const SCIRun::Core::Datatypes::DenseMatrix& y);
 
 			        virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double lambda, bool inverseCalculation) const;
+			        virtual bool computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const;
 			    };
 			}
 		}
@@ -32,6 +32,7 @@
 // SCIRUN lybraries
 #include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -66,43 +67,39 @@ using namespace SCIRun::Core::Algorithms::Inverse;
 ///////////////////////////////////////////////////////////////////
 void SolveInverseProblemWithTSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& matrixU_, const SCIRun::Core::Datatypes::DenseMatrix& singularValues_, const SCIRun::Core::Datatypes::DenseMatrix& matrixV_)
 {
+		auto precomputed = boost::make_shared<ForwardMatrixSVD>();
 
 		// alocate U and V matrices
-			svd_MatrixU = matrixU_;
-			svd_MatrixV = matrixV_;
+			precomputed->matrixU = matrixU_;
+			precomputed->matrixV = matrixV_;
 
 		// alocate singular values
 			if (singularValues_.ncols() == 1 ){
-				svd_SingularValues = singularValues_;
+				precomputed->singularValues = singularValues_;
 			}
 			else{
-				svd_SingularValues = singularValues_.diagonal();
+				precomputed->singularValues = singularValues_.diagonal();
 			}
 
-		// Compute the projection of data y on the left singular vectors
-			Uy = svd_MatrixU.transpose() * (measuredData_);
-
 		// determine rank
-	        rank = svd_SingularValues.nrows();
+	        precomputed->rank = precomputed->singularValues.nrows();
+	        svd = precomputed;
+
+		// Compute the projection of data y on the left singular vectors
+			Uy = svd->matrixU.transpose() * (measuredData_);
+			dataNorm = measuredData_.squaredNorm();
 
 }
 
 void SolveInverseProblemWithTSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_)
 {
 
-	    // Compute the SVD of the forward matrix
-	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeFullU | Eigen::ComputeFullV);
-
-		// alocate the left and right singular vectors and the singular values
-			svd_MatrixU = SVDdecomposition.matrixU();
-			svd_MatrixV = SVDdecomposition.matrixV();
-			svd_SingularValues = SVDdecomposition.singularValues();
-
-	    // determine rank
-	        rank = SVDdecomposition.nonzeroSingularValues();
+	    // Compute the SVD of the forward matrix, or reuse it from an earlier execution
+	        svd = computeSVD( forwardMatrix_ );
 
 	    // Compute the projection of data y on the left singular vectors
-	        Uy = svd_MatrixU.transpose() * (measuredData_);
+	        Uy = svd->matrixU.transpose() * (measuredData_);
+	        dataNorm = measuredData_.squaredNorm();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -112,36 +109,56 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTSVD_impl::computeIn
 {
 
     // prealocate matrices
-        const int N = svd_MatrixV.cols();
-        const int M = svd_MatrixU.rows();
-        const int numTimeSamples = Uy.ncols();
-        DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
-        DenseMatrix tempInverse(DenseMatrix::Zero(N,M));
+		const int truncationPoint = std::max( Min( int(lambda), svd->rank, int(9999999999999) ), 0 );
+        DenseColumnMatrix filterFactors(truncationPoint);
 
-		const int truncationPoint = Min( int(lambda), rank, int(9999999999999) );
-
-    // Compute inverse SolveInverseProblemWithTSVD
+    // evaluate filter factors
         for (int rr=0; rr < truncationPoint ; rr++)
         {
-            // evaluate filter factor
-                double singVal = svd_SingularValues[rr];
-                auto filterFactor_i =  1 / ( singVal );
-
-            // update solution
-                solution += filterFactor_i * svd_MatrixV.col(rr) * Uy.row(rr);
-
-            // update inverse operator
-                if (inverseCalculation)
-                    tempInverse += filterFactor_i * ( svd_MatrixV.col(rr) *  svd_MatrixU.col(rr).transpose() );
+                filterFactors[rr] =  1 / ( svd->singularValues[rr] );
         }
 
+    // Compute inverse SolveInverseProblemWithTSVD
+        DenseMatrix solution = svd->matrixV.leftCols(truncationPoint) * ( filterFactors.asDiagonal() * Uy.topRows(truncationPoint) );
+
     // output solutions
+    //   the inverse operator V * diag(filterFactors) * U^T is not an output yet, so it is not formed
     //   if (inverseCalculation)
-    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(tempInverse) );
+    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(svd->matrixV.leftCols(truncationPoint) * filterFactors.asDiagonal() * svd->matrixU.leftCols(truncationPoint).transpose()) );
 
         return solution;
 }
 
+//////////////////////////////////////////////////////////////////////
+// THIS FUNCTION returns the residual and solution norms of the L-curve without solving for each truncation point
+//////////////////////////////////////////////////////////////////////
+bool SolveInverseProblemWithTSVD_impl::computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const
+{
+        const int rank = svd->rank;
+        const int nLambda = static_cast<int>(lambdaArray.size());
+        DenseColumnMatrix projectedData = Uy.topRows(rank).rowwise().squaredNorm();
+
+    // prefix sums of the projected data, so that every truncation point costs O(1)
+        std::vector<double> residual(rank + 1, 0.0), solution(rank + 1, 0.0);
+        for (int rr=0; rr < rank ; rr++)
+        {
+            const double singVal = svd->singularValues[rr];
+            residual[rr+1] = residual[rr] + projectedData[rr];
+            solution[rr+1] = solution[rr] + projectedData[rr] / ( singVal * singVal );
+        }
+        const double outsideNorm = std::max( dataNorm - residual[rank], 0.0 );
+
+        rho.assign(nLambda, 0.0);
+        eta.assign(nLambda, 0.0);
+        for (int j = 0; j < nLambda; j++)
+        {
+            const int truncationPoint = std::max( Min( int(lambdaArray[j]), rank, int(9999999999999) ), 0 );
+            rho[j] = std::sqrt( outsideNorm + residual[rank] - residual[truncationPoint] );
+            eta[j] = std::sqrt( solution[truncationPoint] );
+        }
+        return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 // THIS FUNCTION returns a string of lambdas from which the L-curve is computed
 //////////////////////////////////////////////////////////////////////
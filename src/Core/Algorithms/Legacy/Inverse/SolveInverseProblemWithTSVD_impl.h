@@ -70,12 +70,10 @@ namespace Inverse {
 		    private:
 
 				// Data Members
-		        int rank;
-				SCIRun::Core::Datatypes::DenseMatrix svd_MatrixU;
-				SCIRun::Core::Datatypes::DenseColumnMatrix svd_SingularValues;
-				SCIRun::Core::Datatypes::DenseMatrix svd_MatrixV;
+				ForwardMatrixSVDHandle svd;
 
 		        SCIRun::Core::Datatypes::DenseMatrix Uy;
+		        double dataNorm;
 
 				// Methods
 				void preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& matrixU_, const SCIRun::Core::Datatypes::DenseMatrix& singularValues_, const SCIRun::Core::Datatypes::DenseMatrix& matrixV_);
@@ -83,6 +81,7 @@ namespace Inverse {
 
 		        virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double truncationPoint, bool inverseCalculation) const;
 				std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
+		        virtual bool computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const;
 		        //      bool checkInputMatrixSizes(); // DEFINED IN PARENT, MIGHT WANT TO OVERRIDE SOME OTHER TIME
 
 
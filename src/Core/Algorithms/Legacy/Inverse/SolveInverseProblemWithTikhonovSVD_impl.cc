@@ -32,6 +32,7 @@
 // SCIRUN lybraries
 #include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -66,42 +67,38 @@ using namespace SCIRun::Core::Algorithms::Inverse;
 ///////////////////////////////////////////////////////////////////
 void SolveInverseProblemWithTikhonovSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& matrixU_, const SCIRun::Core::Datatypes::DenseMatrix& singularValues_, const SCIRun::Core::Datatypes::DenseMatrix& matrixV_)
 {
+		auto precomputed = boost::make_shared<ForwardMatrixSVD>();
 
 		// alocate U and V matrices
-			svd_MatrixU = matrixU_;
-			svd_MatrixV = matrixV_;
+			precomputed->matrixU = matrixU_;
+			precomputed->matrixV = matrixV_;
 
 		// alocate singular values
 			if (singularValues_.ncols() == 1 ){
-				svd_SingularValues = singularValues_;
+				precomputed->singularValues = singularValues_;
 			}
 			else{
-				svd_SingularValues = singularValues_.diagonal();
+				precomputed->singularValues = singularValues_.diagonal();
 			}
 
-		// Compute the projection of data y on the left singular vectors
-			Uy = svd_MatrixU.transpose() * (measuredData_);
-
 		// determine rank
-	        rank = svd_SingularValues.nrows();
+	        precomputed->rank = precomputed->singularValues.nrows();
+	        svd = precomputed;
+
+		// Compute the projection of data y on the left singular vectors
+			Uy = svd->matrixU.transpose() * (measuredData_);
+			dataNorm = measuredData_.squaredNorm();
 }
 
 void SolveInverseProblemWithTikhonovSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_)
 {
 
-	    // Compute the SVD of the forward matrix
-	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeFullU | Eigen::ComputeFullV);
-
-		// alocate the left and right singular vectors and the singular values
-			svd_MatrixU = SVDdecomposition.matrixU();
-			svd_MatrixV = SVDdecomposition.matrixV();
-			svd_SingularValues = SVDdecomposition.singularValues();
-
-	    // determine rank
-	        rank = SVDdecomposition.nonzeroSingularValues();
+	    // Compute the SVD of the forward matrix, or reuse it from an earlier execution
+	        svd = computeSVD( forwardMatrix_ );
 
 	    // Compute the projection of data y on the left singular vectors
-	        Uy = svd_MatrixU.transpose() * (measuredData_);
+	        Uy = svd->matrixU.transpose() * (measuredData_);
+	        dataNorm = measuredData_.squaredNorm();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -111,30 +108,33 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTikhonovSVD_impl::co
 {
 
     // prealocate matrices
-        const int N = svd_MatrixV.cols();
-        const int M = svd_MatrixU.rows();
-        const int numTimeSamples = Uy.ncols();
-        DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
-        DenseMatrix tempInverse(DenseMatrix::Zero(N,M));
+        const int rank = svd->rank;
+        DenseColumnMatrix filterFactors(DenseColumnMatrix::Zero(rank));
 
-    // Compute inverse solution
+    // evaluate filter factors
         for (int rr=0; rr<rank ; rr++)
         {
-            // evaluate filter factor
-                double singVal = svd_SingularValues[rr];
-                double filterFactor_i =  singVal / ( lambda * lambda + singVal * singVal );
-
-            // u[date solution
-                solution += filterFactor_i * svd_MatrixV.col(rr) * Uy.row(rr);
-
-            // update inverse operator
-                if (inverseCalculation)
-                    tempInverse += filterFactor_i * ( svd_MatrixV.col(rr) *  svd_MatrixU.col(rr).transpose() );
+                double singVal = svd->singularValues[rr];
+                filterFactors[rr] =  singVal / ( lambda * lambda + singVal * singVal );
         }
 
+    // Compute inverse solution
+        DenseMatrix solution = svd->matrixV.leftCols(rank) * ( filterFactors.asDiagonal() * Uy.topRows(rank) );
+
     // output solutions
+    //   the inverse operator V * diag(filterFactors) * U^T is not an output yet, so it is not formed
     //   if (inverseCalculation)
-    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(tempInverse) );
+    //       inverseMatrix_.reset( new SCIRun::Core::Datatypes::DenseMatrix(svd->matrixV.leftCols(rank) * filterFactors.asDiagonal() * svd->matrixU.leftCols(rank).transpose()) );
 
         return solution;
 }
+
+//////////////////////////////////////////////////////////////////////
+// THIS FUNCTION returns the residual and solution norms of the L-curve without solving for each lambda
+//////////////////////////////////////////////////////////////////////
+bool SolveInverseProblemWithTikhonovSVD_impl::computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const
+{
+        DenseColumnMatrix projectedData = Uy.rowwise().squaredNorm();
+        tikhonovLcurveNorms( svd->singularValues, projectedData, dataNorm, svd->rank, lambdaArray, rho, eta );
+        return true;
+}
@@ -299,6 +299,23 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
 
   lambdaArray[0] = lambdaMin;
 
+  // without weighting matrices the norms follow from the decomposition the implementation already holds
+  if (!sourceWeighting && !sensorWeighting && algoImpl.computeLcurveNorms(lambdaArray, rho, eta))
+  {
+    for (int j = 0; j < nLambda; j++)
+    {
+      lambdamatrix->put(j,0,lambdaArray[j]);
+      lambdamatrix->put(j,1,rho[j]);
+      lambdamatrix->put(j,2,eta[j]);
+    }
+    lambda = FindCorner( rho, eta, lambdaArray, nLambda,lambda_index);
+    LOG_DEBUG("Lambda: {}", lambda);
+    return lambda;
+  }
+
+  auto forward = castMatrix::toDense(forwardMatrix);
+  auto measured = castMatrix::toDense(measuredData);
+
   // for all lambdas
   for (int j = 0; j < nLambda; j++)
   {
@@ -321,9 +338,7 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
     else
       Rx = solution;
 
-    auto forward = castMatrix::toDense(forwardMatrix);
     auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
     auto residualSolution = Ax - (*measured);
 
     // if using source regularization matrix, apply it to compute Rx (for the eta computations)
@@ -29,7 +29,15 @@
 */
 
 
+#include <algorithm>
+#include <cmath>
+#include <boost/make_shared.hpp>
 #include <Core/Algorithms/Legacy/Inverse/TikhonovImpl.h>
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
+#include <Core/Thread/Parallel.h>
+#include <Eigen/SVD>
+
+using SCIRun::Core::Algorithms::Math::LinearSolverCache;
 
 
 	// default lambda step. Can ve overriden if necessary (see TSVD as reference)
@@ -46,3 +54,69 @@
 
 		return lambdaArray;
 	}
+
+	SCIRun::Core::Algorithms::Inverse::ForwardMatrixSVDHandle SCIRun::Core::Algorithms::Inverse::TikhonovImpl::computeSVD( const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix )
+	{
+		auto& cache = LinearSolverCache::instance();
+		const auto key = LinearSolverCache::key(forwardMatrix);
+		auto svd = cache.find<ForwardMatrixSVD>(key, "Tikhonov SVD");
+		if (svd)
+			return svd;
+
+		// divide and conquer SVD; the thin factors are all the Tikhonov filters need
+		Eigen::BDCSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> decomposition( forwardMatrix, Eigen::ComputeThinU | Eigen::ComputeThinV );
+
+		svd = boost::make_shared<ForwardMatrixSVD>();
+		svd->matrixU = decomposition.matrixU();
+		svd->matrixV = decomposition.matrixV();
+		svd->singularValues = decomposition.singularValues();
+		svd->rank = static_cast<int>(decomposition.nonzeroSingularValues());
+
+		const size_t bytes = sizeof(double) * (svd->matrixU.size() + svd->matrixV.size() + svd->singularValues.size());
+		cache.insert(key, "Tikhonov SVD", svd, bytes);
+		return svd;
+	}
+
+	bool SCIRun::Core::Algorithms::Inverse::TikhonovImpl::computeLcurveNorms( const std::vector<double>&, std::vector<double>&, std::vector<double>& ) const
+	{
+		return false;
+	}
+
+	// With A = U*S*V^T and c = U^T*y the Tikhonov solution is x = V * s/(s^2+lambda^2) * c, so
+	//		eta^2 = sum( (s/(s^2+lambda^2))^2 * c^2 )
+	//		rho^2 = sum( (lambda^2/(s^2+lambda^2))^2 * c^2 ) + ||y||^2 - sum( c^2 )
+	void SCIRun::Core::Algorithms::Inverse::TikhonovImpl::tikhonovLcurveNorms( const SCIRun::Core::Datatypes::DenseColumnMatrix& singularValues, const SCIRun::Core::Datatypes::DenseColumnMatrix& projectedData, double dataNorm, int rank, const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta )
+	{
+		const int nLambda = static_cast<int>(lambdaArray.size());
+		rho.assign(nLambda, 0.0);
+		eta.assign(nLambda, 0.0);
+
+		double projectedNorm = 0;
+		for (int i = 0; i < rank; i++)
+			projectedNorm += projectedData[i];
+		const double outsideNorm = std::max( dataNorm - projectedNorm, 0.0 );
+
+		SCIRun::Core::Thread::Parallel::For(SCIRun::Core::Thread::IndexRange(0, nLambda), 0,
+			[&](const SCIRun::Core::Thread::IndexRange& r)
+			{
+				for (size_t j = r.begin; j < r.end; j++)
+				{
+					const double lambda_sq = lambdaArray[j] * lambdaArray[j];
+					double rho_sq = outsideNorm;
+					double eta_sq = 0;
+					for (int i = 0; i < rank; i++)
+					{
+						const double s = singularValues[i];
+						const double denominator = s * s + lambda_sq;
+						if (denominator <= 0)
+							continue;
+						const double filter = s / denominator;
+						const double residual = lambda_sq / denominator;
+						eta_sq += filter * filter * projectedData[i];
+						rho_sq += residual * residual * projectedData[i];
+					}
+					rho[j] = std::sqrt(rho_sq);
+					eta[j] = std::sqrt(eta_sq);
+				}
+			});
+	}
@@ -33,8 +33,10 @@
 #define BioPSE_TikhonovImpl_H__
 
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Algorithms/Legacy/Inverse/share.h>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 
 namespace SCIRun {
@@ -43,6 +45,16 @@ namespace Algorithms {
 namespace Inverse {
 
 
+	// Singular value decomposition A = U * diag(singularValues) * V^T of a forward matrix, of which the first rank values are nonzero
+	struct SCISHARE ForwardMatrixSVD
+	{
+		SCIRun::Core::Datatypes::DenseMatrix matrixU;
+		SCIRun::Core::Datatypes::DenseColumnMatrix singularValues;
+		SCIRun::Core::Datatypes::DenseMatrix matrixV;
+		int rank;
+	};
+	typedef boost::shared_ptr<const ForwardMatrixSVD> ForwardMatrixSVDHandle;
+
 	class SCISHARE TikhonovImpl
 	{
 
@@ -57,6 +69,22 @@ namespace Inverse {
 		// default lambda step. Can ve overriden if necessary (see TSVD as reference)
 		virtual std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
 
+		// Residual norm rho and solution norm eta (without weighting matrices) for every lambda of an L-curve.
+		// Implementations that keep a spectral decomposition of the forward matrix get these in O(rank) per
+		// lambda; the default returns false and the caller solves for each lambda instead.
+		virtual bool computeLcurveNorms( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const;
+
+	protected:
+
+		// Thin SVD of the forward matrix. Kept in the linear solver cache, so executing again with the same forward
+		// matrix (e.g. with a new lambda range) does not decompose it again
+		static ForwardMatrixSVDHandle computeSVD( const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix );
+
+		// L-curve norms of the Tikhonov solution from singular values s_i, squared norms c_i of the data projected
+		// on the left singular vectors and the squared norm of the data, which also covers the part outside their span.
+		// The lambdas are evaluated in parallel.
+		static void tikhonovLcurveNorms( const SCIRun::Core::Datatypes::DenseColumnMatrix& singularValues, const SCIRun::Core::Datatypes::DenseColumnMatrix& projectedData, double dataNorm, int rank, const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta );
+
 	};
 
 	}}}}
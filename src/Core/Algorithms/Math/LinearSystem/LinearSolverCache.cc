@@ -0,0 +1,196 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
+#include <Core/Utils/ContentHash.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+
+using namespace SCIRun;
+using SCIRun::Core::ContentHash;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  template <typename T>
+  LinearSolverCache::Key matrix_key(const SparseRowMatrixGeneric<T>& A)
+  {
+    ContentHash hash;
+    hash.add(static_cast<boost::uint64_t>(A.rows()));
+    hash.add(static_cast<boost::uint64_t>(A.cols()));
+
+    const index_type* rows = A.outerIndexPtr();
+    const index_type* columns = A.innerIndexPtr();
+    const T* values = A.valuePtr();
+    const auto* nonzeros = A.innerNonZeroPtr();
+    if (!nonzeros)
+    {
+      const size_t nnz = A.nonZeros();
+      hash.add(rows, (A.outerSize() + 1) * sizeof(index_type));
+      hash.add(columns, nnz * sizeof(index_type));
+      hash.add(values, nnz * sizeof(T));
+    }
+    else
+    {
+      // uncompressed storage has gaps between the rows
+      for (index_type i = 0; i < A.outerSize(); ++i)
+      {
+        hash.add(static_cast<boost::uint64_t>(nonzeros[i]));
+        hash.add(columns + rows[i], nonzeros[i] * sizeof(index_type));
+        hash.add(values + rows[i], nonzeros[i] * sizeof(T));
+      }
+    }
+
+    LinearSolverCache::Key key;
+    key.id = A.id();
+    key.hash = hash.value();
+    return key;
+  }
+}
+
+const size_t LinearSolverCache::defaultMemoryBudget;
+const size_t LinearSolverCache::maxEntries;
+
+LinearSolverCache::LinearSolverCache(size_t memoryBudget) :
+  memoryBudget_(memoryBudget), memoryUsed_(0)
+{
+}
+
+LinearSolverCache& LinearSolverCache::instance()
+{
+  static LinearSolverCache cache;
+  return cache;
+}
+
+LinearSolverCache::Key LinearSolverCache::key(const SparseRowMatrix& A)
+{
+  return matrix_key(A);
+}
+
+LinearSolverCache::Key LinearSolverCache::key(const ComplexSparseRowMatrix& A)
+{
+  return matrix_key(A);
+}
+
+LinearSolverCache::Key LinearSolverCache::key(const DenseMatrix& A)
+{
+  ContentHash hash;
+  hash.add(static_cast<boost::uint64_t>(A.rows()));
+  hash.add(static_cast<boost::uint64_t>(A.cols()));
+  hash.add(A.data(), A.size() * sizeof(double));
+
+  Key key;
+  key.id = A.id();
+  key.hash = hash.value();
+  return key;
+}
+
+boost::shared_ptr<void> LinearSolverCache::findEntry(const Key& key, const std::string& name)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    if (it->key == key && it->name == name)
+    {
+      entries_.splice(entries_.begin(), entries_, it);
+      return it->value;
+    }
+  }
+  return boost::shared_ptr<void>();
+}
+
+void LinearSolverCache::insertEntry(const Key& key, const std::string& name,
+  boost::shared_ptr<void> value, size_t bytes)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();)
+  {
+    // the same value, or one for older contents of this matrix
+    if (it->key.id == key.id && (it->key.hash != key.hash || it->name == name))
+    {
+      memoryUsed_ -= it->bytes;
+      it = entries_.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  if (!value || bytes > memoryBudget_)
+    return;
+
+  Entry entry;
+  entry.key = key;
+  entry.name = name;
+  entry.value = value;
+  entry.bytes = bytes;
+  entries_.push_front(entry);
+  memoryUsed_ += bytes;
+  trim();
+}
+
+void LinearSolverCache::trim()
+{
+  while (!entries_.empty() && (memoryUsed_ > memoryBudget_ || entries_.size() > maxEntries))
+  {
+    memoryUsed_ -= entries_.back().bytes;
+    entries_.pop_back();
+  }
+}
+
+void LinearSolverCache::clear()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  entries_.clear();
+  memoryUsed_ = 0;
+}
+
+size_t LinearSolverCache::memoryBudget() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return memoryBudget_;
+}
+
+void LinearSolverCache::setMemoryBudget(size_t bytes)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  memoryBudget_ = bytes;
+  trim();
+}
+
+size_t LinearSolverCache::memoryUsed() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return memoryUsed_;
+}
+
+size_t LinearSolverCache::size() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return entries_.size();
+}
@@ -0,0 +1,125 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_LINEARSOLVERCACHE_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_LINEARSOLVERCACHE_H
+
+#include <list>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Keeps what the linear solvers set up for a matrix (preconditioners,
+  /// factorizations, the last solution) so that solving with the same
+  /// matrix again only pays for the solve itself. Entries are keyed on the
+  /// datatype id of the matrix together with a hash of its contents, so a
+  /// matrix that is changed in place misses the cache. The least recently
+  /// used entries are dropped when the memory budget or the number of
+  /// entries is exceeded. All functions are thread safe.
+  class SCISHARE LinearSolverCache : boost::noncopyable
+  {
+  public:
+    struct Key
+    {
+      int id;
+      boost::uint64_t hash;
+      bool operator==(const Key& other) const { return id == other.id && hash == other.hash; }
+    };
+
+    static const size_t defaultMemoryBudget = size_t(512) << 20;
+    static const size_t maxEntries = 64;
+
+    explicit LinearSolverCache(size_t memoryBudget = defaultMemoryBudget);
+
+    /// The cache shared by all solver algorithms.
+    static LinearSolverCache& instance();
+
+    /// Hashes the structure and values of A, O(nnz).
+    static Key key(const Datatypes::SparseRowMatrix& A);
+    static Key key(const Datatypes::ComplexSparseRowMatrix& A);
+    /// Hashes the values of A, O(rows*cols).
+    static Key key(const Datatypes::DenseMatrix& A);
+
+    /// The value stored under key and name, or an empty handle. The name
+    /// determines the type of the value, so T must match the inserted type.
+    template <class T>
+    boost::shared_ptr<T> find(const Key& key, const std::string& name)
+    {
+      return boost::static_pointer_cast<T>(findEntry(key, name));
+    }
+
+    /// Stores value under key and name, replacing an older value with that
+    /// name. Values for earlier contents of the same matrix are dropped.
+    /// Values larger than the whole budget are not kept.
+    template <class T>
+    void insert(const Key& key, const std::string& name, boost::shared_ptr<T> value, size_t bytes)
+    {
+      insertEntry(key, name, boost::static_pointer_cast<void>(value), bytes);
+    }
+
+    void clear();
+
+    size_t memoryBudget() const;
+    /// A budget of zero turns the cache off.
+    void setMemoryBudget(size_t bytes);
+
+    size_t memoryUsed() const;
+    size_t size() const;
+
+  private:
+    struct Entry
+    {
+      Key key;
+      std::string name;
+      boost::shared_ptr<void> value;
+      size_t bytes;
+    };
+
+    boost::shared_ptr<void> findEntry(const Key& key, const std::string& name);
+    void insertEntry(const Key& key, const std::string& name, boost::shared_ptr<void> value, size_t bytes);
+    void trim();
+
+    mutable boost::mutex mutex_;
+    /// most recently used first
+    std::list<Entry> entries_;
+    size_t memoryBudget_;
+    size_t memoryUsed_;
+  };
+
+}}}}
+
+#endif
@@ -30,9 +30,14 @@
 // PORTED SCIRUN v4 CODE //
 ///////////////////////////
 
+#include <algorithm>
+#include <cfloat>
+
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -44,16 +49,19 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 
+ALGORITHM_PARAMETER_DEF(Math, WarmStart);
+
 SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
   addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|IC(0)|ILU(0)|AMG");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
 
   addParameter(Variables::BuildConvergence, true);
+  addParameter(Parameters::WarmStart, false);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // for callback
@@ -73,23 +81,166 @@ SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 class SolveLinearSystemParallelAlgo : public ParallelLinearAlgebraBase
 {
 public:
-  explicit SolveLinearSystemParallelAlgo(const AlgorithmBase* base);
+  SolveLinearSystemParallelAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner);
 
   bool run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
             DenseColumnMatrixHandle& convergence) const;
+  // Block solve, one system per column of b
+  bool run(SparseRowMatrixHandle a, DenseMatrixHandle b,
+            DenseMatrixHandle x0, DenseMatrixHandle& x) const;
 protected:
+  // Builds the diagonal preconditioner, or the scratch space of the given one
+  bool setup_preconditioner(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A,
+    ParallelLinearAlgebra::ParallelVector& DIAG, ParallelLinearAlgebra::ParallelVector& WORK) const;
+  // z = inv(M)*r, r and z may be the same vector
+  void precondition(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+    ParallelLinearAlgebra::ParallelVector& WORK, const ParallelLinearAlgebra::ParallelVector& r,
+    ParallelLinearAlgebra::ParallelVector& z) const;
+  // z = inv(M)'*r
+  void precondition_transpose(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+    ParallelLinearAlgebra::ParallelVector& WORK, const ParallelLinearAlgebra::ParallelVector& r,
+    ParallelLinearAlgebra::ParallelVector& z) const;
+  // z = inv(M)*r for the active columns, r and z may be the same. T is a
+  // vector of scratch space for the preconditioners that work on vectors.
+  void precondition(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+    ParallelLinearAlgebra::ParallelVector& WORK, ParallelLinearAlgebra::ParallelVector& T,
+    const ParallelLinearAlgebra::ParallelMultiVector& r, ParallelLinearAlgebra::ParallelMultiVector& z,
+    const std::vector<char>& active) const;
+  bool link_block(ParallelLinearAlgebra& PLA, SolverInputs& matrices, ParallelLinearAlgebra::ParallelMatrix& A,
+    ParallelLinearAlgebra::ParallelMultiVector& B, ParallelLinearAlgebra::ParallelMultiVector& X) const;
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
+  ParallelPreconditionerHandle preconditioner_;
   DenseColumnMatrixHandle convergence_;
 };
 
-SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
+SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base,
+  ParallelPreconditionerHandle preconditioner) : algo_(base),
   pre_conditioner_(base->getOption(Variables::Preconditioner)),
+  preconditioner_(preconditioner),
   convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt()))
 {
 }
 
+bool
+SolveLinearSystemParallelAlgo::setup_preconditioner(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelMatrix& A, ParallelLinearAlgebra::ParallelVector& DIAG,
+  ParallelLinearAlgebra::ParallelVector& WORK) const
+{
+  if (preconditioner_)
+  {
+    if (!PLA.new_buffer(preconditioner_->workspace_size(), WORK))
+    {
+      if (PLA.first())
+        algo_->error("Could not allocate enough memory for preconditioner");
+      PLA.wait();
+      return (false);
+    }
+  }
+  else if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+  return (true);
+}
+
+void
+SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+  ParallelLinearAlgebra::ParallelVector& WORK, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply(PLA, r, z, WORK.data_);
+  else
+    PLA.mult(r,DIAG,z);
+}
+
+void
+SolveLinearSystemParallelAlgo::precondition_transpose(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+  ParallelLinearAlgebra::ParallelVector& WORK, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply_transpose(PLA, r, z, WORK.data_);
+  else
+    PLA.mult(r,DIAG,z);
+}
+
+void
+SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA, ParallelLinearAlgebra::ParallelVector& DIAG,
+  ParallelLinearAlgebra::ParallelVector& WORK, ParallelLinearAlgebra::ParallelVector& T,
+  const ParallelLinearAlgebra::ParallelMultiVector& r, ParallelLinearAlgebra::ParallelMultiVector& z,
+  const std::vector<char>& active) const
+{
+  if (!preconditioner_)
+  {
+    PLA.mult(DIAG,r,z);
+    return;
+  }
+
+  for (size_t j = 0; j < r.cols_; ++j)
+  {
+    if (!active[j])
+      continue;
+    // T may still be read by the previous apply
+    PLA.wait();
+    PLA.copy_column(r,j,T);
+    preconditioner_->apply(PLA, T, T, WORK.data_);
+    PLA.wait();
+    PLA.copy_column(T,j,z);
+  }
+}
+
+bool
+SolveLinearSystemParallelAlgo::link_block(ParallelLinearAlgebra& PLA, SolverInputs& matrices,
+  ParallelLinearAlgebra::ParallelMatrix& A, ParallelLinearAlgebra::ParallelMultiVector& B,
+  ParallelLinearAlgebra::ParallelMultiVector& X) const
+{
+  ParallelLinearAlgebra::ParallelMultiVector X0;
+  if ( !PLA.add_matrix(matrices.A,A) ||
+       !PLA.add_multi_vector(matrices.B,B) ||
+       !PLA.add_multi_vector(matrices.X0,X0) ||
+       !PLA.add_multi_vector(matrices.X,X))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  PLA.copy(X0,X);
+  return (true);
+}
+
+bool
+SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseMatrixHandle b,
+                                   DenseMatrixHandle x0, DenseMatrixHandle& x) const
+{
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.B = b;
+  matrices.X0 = x0;
+
+  x = boost::make_shared<DenseMatrix>(x0->nrows(), x0->ncols());
+  matrices.X = x;
+
+  if(!start_parallel(matrices))
+  {
+    const std::string msg = "Encountered an error while running parallel linear algebra";
+    algo_->error(msg);
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
+  }
+
+  return (true);
+}
+
 bool
 SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
                                    DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
@@ -131,14 +282,15 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
 class SolveLinearSystemCGAlgo : public SolveLinearSystemParallelAlgo
 {
   public:
-    explicit SolveLinearSystemCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    SolveLinearSystemCGAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
     virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
 bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 {
   ParallelLinearAlgebra::ParallelMatrix A;
-  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P, WORK;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -189,16 +341,8 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  if (!setup_preconditioner(PLA,A,DIAG,WORK))
+    return (false);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -256,7 +400,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
+    precondition(PLA,DIAG,WORK,R,Z);
     double bknum = PLA.dot(Z,R);
 
     if (niter == 0)
@@ -343,7 +487,8 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
 {
   public:
-    explicit SolveLinearSystemBICGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    SolveLinearSystemBICGAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
     virtual bool parallel(ParallelLinearAlgebra& PLA,
                           SolverInputs& matrices) const;
 };
@@ -357,7 +502,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   // Define matrices and vectors to be used in the algorithm
   ParallelLinearAlgebra::ParallelMatrix A;
   ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN;
-  ParallelLinearAlgebra::ParallelVector DIAG, R, R1, Z, Z1, P, P1;
+  ParallelLinearAlgebra::ParallelVector DIAG, R, R1, Z, Z1, P, P1, WORK;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -399,16 +544,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  if (!setup_preconditioner(PLA,A,DIAG,WORK))
+    return (false);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -460,8 +597,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       return (true);
     }
 
-    PLA.mult(R,DIAG,Z);
-    PLA.mult(R1,DIAG,Z1);
+    precondition(PLA,DIAG,WORK,R,Z);
+    precondition_transpose(PLA,DIAG,WORK,R1,Z1);
 
     double bknum = PLA.dot(Z,R1);
 
@@ -558,7 +695,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 class SolveLinearSystemMINRESAlgo : public SolveLinearSystemParallelAlgo
 {
 public:
-  explicit SolveLinearSystemMINRESAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+  SolveLinearSystemMINRESAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
   virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
@@ -572,7 +710,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   // Define matrices and vectors to be used in the algorithm
   ParallelLinearAlgebra::ParallelMatrix A;
   ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN;
-  ParallelLinearAlgebra::ParallelVector DIAG, R, V, VOLD, VV;
+  ParallelLinearAlgebra::ParallelVector DIAG, R, V, VOLD, VV, WORK;
   ParallelLinearAlgebra::ParallelVector VOLDER, M, MOLD, MOLDER, XCG;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
@@ -618,16 +756,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(X0,XMIN);
 
   // Build a preconditioner
-  if (pre_conditioner_ == "Jacobi")
-  {
-    PLA.absdiag(A,DIAG);
-    double max = PLA.max(DIAG);
-    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
-  }
-  else
-  {
-    PLA.ones(DIAG);
-  }
+  if (!setup_preconditioner(PLA,A,DIAG,WORK))
+    return (false);
 
   PLA.mult(A,X,R);
   PLA.sub(B,R,R);
@@ -656,7 +786,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(R,VOLD);
   PLA.copy(R,V);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,WORK,V,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +803,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,WORK,V,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -734,7 +864,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    precondition(PLA,DIAG,WORK,V,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -904,13 +1034,342 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 }
 
 
+//------------------------------------------------------------------
+// Block CG and MINRES solvers
+//
+// All right-hand sides are iterated at the same time, each with its own
+// recurrence coefficients, so that every sparse matrix product serves all
+// of them and the dot products share one reduction. Converged columns get
+// zero coefficients and keep their solution.
+
+namespace
+{
+  size_t count_active(const std::vector<double>& error, double tolerance, std::vector<char>& active)
+  {
+    size_t num = 0;
+    for (size_t j = 0; j < error.size(); ++j)
+    {
+      active[j] = error[j] > tolerance;
+      if (active[j]) num++;
+    }
+    return num;
+  }
+
+  double max_error(const std::vector<double>& error)
+  {
+    return error.empty() ? 0.0 : *std::max_element(error.begin(), error.end());
+  }
+}
+
+class SolveLinearSystemBlockCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
+};
+
+bool SolveLinearSystemBlockCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelMultiVector B, X, R, Z, P, Q;
+  ParallelLinearAlgebra::ParallelVector DIAG, T, WORK;
+
+  double tolerance = algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =  algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if (!link_block(PLA,matrices,A,B,X))
+    return (false);
+
+  const size_t k = B.cols_;
+  if ( !PLA.new_multi_vector(k,R) ||
+       !PLA.new_multi_vector(k,Z) ||
+       !PLA.new_multi_vector(k,P) ||
+       !PLA.new_multi_vector(k,Q) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(T))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  if (!setup_preconditioner(PLA,A,DIAG,WORK))
+    return (false);
+
+  std::vector<double> bnorm(k), error(k), rho(k), rho_old(k), coef(k);
+  std::vector<char> active(k);
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  PLA.norm(B,&bnorm[0]);
+  PLA.norm(R,&error[0]);
+  for (size_t j = 0; j < k; ++j)
+  {
+    // a zero right-hand side is measured by the absolute residual
+    if (bnorm[j] == 0.0) bnorm[j] = 1.0;
+    error[j] /= bnorm[j];
+  }
+
+  double log_target = log(tolerance);
+  double log_orig = log(max_error(error));
+  double log_scale = log_orig - log_target;
+  int cnt = 0;
+
+  while (niter < max_iter && count_active(error,tolerance,active) > 0)
+  {
+    precondition(PLA,DIAG,WORK,T,R,Z,active);
+    PLA.dot(Z,R,&rho[0]);
+
+    if (niter == 0)
+    {
+      PLA.copy(Z,P);
+    }
+    else
+    {
+      for (size_t j = 0; j < k; ++j)
+        coef[j] = (active[j] && rho_old[j] != 0.0) ? rho[j]/rho_old[j] : 0.0;
+      PLA.scale_add(&coef[0],P,Z,P);
+    }
+
+    PLA.mult(A,P,Q);
+    PLA.dot(P,Q,&coef[0]);
+    for (size_t j = 0; j < k; ++j)
+      coef[j] = (active[j] && coef[j] != 0.0) ? rho[j]/coef[j] : 0.0;
+
+    PLA.scale_add(&coef[0],P,X,X);
+    for (size_t j = 0; j < k; ++j) coef[j] = -coef[j];
+    PLA.scale_add(&coef[0],Q,R,R);
+
+    rho_old.swap(rho);
+
+    PLA.norm(R,&error[0]);
+    for (size_t j = 0; j < k; ++j) error[j] /= bnorm[j];
+
+    if (PLA.first()) (*convergence_)[niter] = max_error(error);
+    niter++;
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(max_error(error)))/log_scale);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Block solver stopped after " << niter << " iterations for " << k
+      << " right-hand sides. Largest error was " << max_error(error);
+    algo_->remark(ostr.str());
+  }
+  PLA.wait();
+
+  return (true);
+}
+
+class SolveLinearSystemBlockMINRESAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    SolveLinearSystemBlockMINRESAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
+};
+
+bool SolveLinearSystemBlockMINRESAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  // Preconditioned MINRES after Paige and Saunders, one recurrence per column
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelMultiVector B, X, R, R1, R2, Y, V, W, W1, W2;
+  ParallelLinearAlgebra::ParallelVector DIAG, T, WORK;
+
+  double tolerance = algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =  algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if (!link_block(PLA,matrices,A,B,X))
+    return (false);
+
+  const size_t k = B.cols_;
+  if ( !PLA.new_multi_vector(k,R) ||
+       !PLA.new_multi_vector(k,R1) ||
+       !PLA.new_multi_vector(k,R2) ||
+       !PLA.new_multi_vector(k,Y) ||
+       !PLA.new_multi_vector(k,V) ||
+       !PLA.new_multi_vector(k,W) ||
+       !PLA.new_multi_vector(k,W1) ||
+       !PLA.new_multi_vector(k,W2) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(T))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  if (!setup_preconditioner(PLA,A,DIAG,WORK))
+    return (false);
+
+  std::vector<double> bnorm(k), error(k), estimate(k), coef(k);
+  std::vector<double> alfa(k), beta(k), oldb(k, 0.0), beta1(k), rnorm0(k);
+  std::vector<double> cs(k, -1.0), sn(k, 0.0), dbar(k, 0.0), epsln(k, 0.0), phibar(k);
+  std::vector<double> rr(k), w1coef(k), w2coef(k), invgamma(k);
+  std::vector<char> active(k);
+
+  PLA.mult(A,X,R1);
+  PLA.sub(B,R1,R1);
+  PLA.copy(R1,R2);
+
+  PLA.norm(B,&bnorm[0]);
+  PLA.norm(R1,&rnorm0[0]);
+  for (size_t j = 0; j < k; ++j)
+  {
+    if (bnorm[j] == 0.0) bnorm[j] = 1.0;
+    error[j] = rnorm0[j]/bnorm[j];
+  }
+  count_active(error,tolerance,active);
+
+  precondition(PLA,DIAG,WORK,T,R1,Y,active);
+  PLA.dot(R1,Y,&beta1[0]);
+  for (size_t j = 0; j < k; ++j)
+  {
+    beta1[j] = std::sqrt(std::max(beta1[j], 0.0));
+    beta[j] = beta1[j];
+    phibar[j] = beta1[j];
+  }
+
+  PLA.zeros(W);
+  PLA.zeros(W2);
+
+  double log_target = log(tolerance);
+  double log_orig = log(max_error(error));
+  double log_scale = log_orig - log_target;
+  int cnt = 0;
+  int ucnt = 0;
+
+  while (niter < max_iter && count_active(error,tolerance,active) > 0)
+  {
+    for (size_t j = 0; j < k; ++j)
+      coef[j] = (active[j] && beta[j] > 0.0) ? 1.0/beta[j] : 0.0;
+    PLA.scale(&coef[0],Y,V);
+    PLA.mult(A,V,Y);
+
+    if (niter > 0)
+    {
+      for (size_t j = 0; j < k; ++j)
+        coef[j] = (active[j] && oldb[j] > 0.0) ? -beta[j]/oldb[j] : 0.0;
+      PLA.scale_add(&coef[0],R1,Y,Y);
+    }
+
+    PLA.dot(V,Y,&alfa[0]);
+    for (size_t j = 0; j < k; ++j)
+      coef[j] = (active[j] && beta[j] > 0.0) ? -alfa[j]/beta[j] : 0.0;
+    PLA.scale_add(&coef[0],R2,Y,Y);
+
+    PLA.copy(R2,R1);
+    PLA.copy(Y,R2);
+    precondition(PLA,DIAG,WORK,T,R2,Y,active);
+
+    PLA.dot(R2,Y,&rr[0]);
+    for (size_t j = 0; j < k; ++j)
+    {
+      // converged columns keep a zero search direction
+      coef[j] = w1coef[j] = w2coef[j] = invgamma[j] = 0.0;
+      if (!active[j])
+        continue;
+
+      oldb[j] = beta[j];
+      beta[j] = std::sqrt(std::max(rr[j], 0.0));
+
+      // apply the previous rotation, then eliminate beta with a new one
+      const double oldeps = epsln[j];
+      const double delta = cs[j]*dbar[j] + sn[j]*alfa[j];
+      const double gbar = sn[j]*dbar[j] - cs[j]*alfa[j];
+      epsln[j] = sn[j]*beta[j];
+      dbar[j] = -cs[j]*beta[j];
+
+      const double gamma = std::max(std::sqrt(gbar*gbar + beta[j]*beta[j]), DBL_EPSILON);
+      cs[j] = gbar/gamma;
+      sn[j] = beta[j]/gamma;
+      coef[j] = cs[j]*phibar[j];
+      phibar[j] = sn[j]*phibar[j];
+
+      w1coef[j] = -oldeps;
+      w2coef[j] = -delta;
+      invgamma[j] = 1.0/gamma;
+    }
+
+    // W = (V - oldeps*W1 - delta*W2)/gamma with W1, W2 the last two W
+    std::swap(W1,W2);
+    std::swap(W2,W);
+    PLA.scale_add(&w1coef[0],W1,V,W);
+    PLA.scale_add(&w2coef[0],W2,W,W);
+    PLA.scale(&invgamma[0],W,W);
+    PLA.scale_add(&coef[0],W,X,X);
+
+    // phibar estimates the residual in the preconditioner norm; check the
+    // true residual when it claims convergence and every few iterations
+    bool check = (cnt == 6);
+    for (size_t j = 0; j < k; ++j)
+    {
+      estimate[j] = error[j];
+      if (active[j] && beta1[j] > 0.0)
+      {
+        estimate[j] = phibar[j]/beta1[j]*rnorm0[j]/bnorm[j];
+        if (estimate[j] <= tolerance) check = true;
+      }
+    }
+
+    if (check)
+    {
+      PLA.mult(A,X,R);
+      PLA.sub(B,R,R);
+      PLA.norm(R,&error[0]);
+      for (size_t j = 0; j < k; ++j) error[j] /= bnorm[j];
+      cnt = 0;
+    }
+    else
+    {
+      cnt++;
+    }
+
+    if (PLA.first()) (*convergence_)[niter] = max_error(estimate);
+    niter++;
+
+    ucnt++;
+    if (ucnt == 20)
+    {
+      ucnt = 0;
+      algo_->update_progress((log_orig-log(max_error(estimate)))/log_scale);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Block solver stopped after " << niter << " iterations for " << k
+      << " right-hand sides. Largest error was " << max_error(error);
+    algo_->remark(ostr.str());
+  }
+  PLA.wait();
+
+  return (true);
+}
+
+
 //------------------------------------------------------------------
 // JACOBI Solver with simple preconditioner
 
 class SolveLinearSystemJACOBIAlgo : public SolveLinearSystemParallelAlgo
 {
 public:
-  explicit SolveLinearSystemJACOBIAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+  SolveLinearSystemJACOBIAlgo(const AlgorithmBase* base, ParallelPreconditionerHandle preconditioner) :
+    SolveLinearSystemParallelAlgo(base, preconditioner) {}
   virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
@@ -1077,10 +1536,167 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
 }
 
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
-  DenseColumnMatrixHandle b,
+                           DenseColumnMatrixHandle b,
                            DenseColumnMatrixHandle x0,
                            DenseColumnMatrixHandle& x,
                            DenseColumnMatrixHandle& convergence) const
+{
+  return run(A,b,x0,x,convergence,ParallelPreconditionerHandle());
+}
+
+ParallelPreconditionerHandle SolveLinearSystemAlgo::buildPreconditioner(SparseRowMatrixHandle A) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  return ParallelPreconditioner::create(getOption(Variables::Preconditioner), A);
+}
+
+ParallelPreconditionerHandle SolveLinearSystemAlgo::cachedPreconditioner(SparseRowMatrixHandle A,
+  boost::optional<LinearSolverCache::Key>& key) const
+{
+  const auto option = getOption(Variables::Preconditioner);
+  if (!ParallelPreconditioner::exists(option))
+    return ParallelPreconditionerHandle();
+
+  LinearSolverCache& cache = LinearSolverCache::instance();
+  const std::string name = "preconditioner " + option;
+  if (!key)
+    key = LinearSolverCache::key(*A);
+  auto preconditioner = cache.find<ParallelPreconditioner>(*key, name);
+  if (!preconditioner)
+  {
+    preconditioner = buildPreconditioner(A);
+    if (preconditioner)
+      cache.insert(*key, name, preconditioner, preconditioner->memory_size());
+  }
+  return preconditioner;
+}
+
+void SolveLinearSystemAlgo::checkPreconditionerFitsMethod(const std::string& method,
+  ParallelPreconditionerHandle preconditioner) const
+{
+  if (method != "cg" && method != "minres")
+    return;
+  const bool symmetric = preconditioner ? preconditioner->is_symmetric() :
+    ParallelPreconditioner::is_symmetric(getOption(Variables::Preconditioner));
+  if (!symmetric)
+  {
+    THROW_ALGORITHM_INPUT_ERROR("The " + method + " method needs a symmetric preconditioner. Use ILU(0) with the bicg method, or choose IC(0) or AMG.");
+  }
+}
+
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle B,
+                           DenseMatrixHandle X0,
+                           DenseMatrixHandle& X) const
+{
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(B, "No matrix B is given");
+
+  double tolerance = get(Variables::TargetError).toDouble();
+  int maxIterations = get(Variables::MaxIterations).toInt();
+  ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+  ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != B->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and B do not have the same number of rows");
+  }
+
+  if (B->ncols() == 0)
+  {
+    X = boost::make_shared<DenseMatrix>(B->nrows(), 0);
+    return true;
+  }
+
+  LinearSolverCache& cache = LinearSolverCache::instance();
+  boost::optional<LinearSolverCache::Key> key;
+  const bool warmStart = get(Parameters::WarmStart).toBool();
+  if (warmStart)
+    key = LinearSolverCache::key(*A);
+
+  if (!X0 && warmStart)
+  {
+    // per column, only when it is a better start than zero
+    auto last = cache.find<DenseMatrix>(*key, "block solution");
+    if (last && last->nrows() == B->nrows() && last->ncols() == B->ncols())
+    {
+      X0 = boost::make_shared<DenseMatrix>(*last);
+      DenseMatrix residual = *B - *A * *X0;
+      for (index_type j = 0; j < B->ncols(); ++j)
+        if (residual.col(j).norm() >= B->col(j).norm())
+          X0->col(j).setZero();
+    }
+  }
+
+  if (!X0)
+  {
+    X0 = boost::make_shared<DenseMatrix>(B->nrows(), B->ncols());
+    X0->setZero();
+  }
+
+  if ((X0->nrows() != B->nrows()) || (X0->ncols() != B->ncols()))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix X0 and B need to have the same dimensions");
+  }
+
+  std::string method = getOption(Variables::Method);
+  if (method != "cg" && method != "minres")
+  {
+    // No block version, solve column by column
+    X = boost::make_shared<DenseMatrix>(B->nrows(), B->ncols());
+    for (index_type j = 0; j < B->ncols(); ++j)
+    {
+      auto b = boost::make_shared<DenseColumnMatrix>(B->col(j));
+      auto x0 = boost::make_shared<DenseColumnMatrix>(X0->col(j));
+      DenseColumnMatrixHandle x;
+      if (!run(A, b, x0, x))
+        return false;
+      X->col(j) = *x;
+    }
+  }
+  else
+  {
+    checkPreconditionerFitsMethod(method, ParallelPreconditionerHandle());
+    solveBlock(method, A, B, X0, X, key);
+  }
+
+  if (warmStart)
+    cache.insert(*key, "block solution", X, X->nrows() * X->ncols() * sizeof(double));
+  return true;
+}
+
+void SolveLinearSystemAlgo::solveBlock(const std::string& method, SparseRowMatrixHandle A,
+  DenseMatrixHandle B, DenseMatrixHandle X0, DenseMatrixHandle& X,
+  boost::optional<LinearSolverCache::Key>& key) const
+{
+  auto preconditioner = cachedPreconditioner(A, key);
+
+  if (method == "cg")
+  {
+    SolveLinearSystemBlockCGAlgo algo(this, preconditioner);
+    if (!algo.run(A,B,X0,X))
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block Conjugate Gradient method failed"));
+  }
+  else
+  {
+    SolveLinearSystemBlockMINRESAlgo algo(this, preconditioner);
+    if (!algo.run(A,B,X0,X))
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block MINRES method failed"));
+  }
+}
+
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+  DenseColumnMatrixHandle b,
+                           DenseColumnMatrixHandle x0,
+                           DenseColumnMatrixHandle& x,
+                           DenseColumnMatrixHandle& convergence,
+                           ParallelPreconditionerHandle preconditioner) const
 {
   ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
   ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
@@ -1117,6 +1733,21 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
 #endif
   }
 
+  LinearSolverCache& cache = LinearSolverCache::instance();
+  boost::optional<LinearSolverCache::Key> key;
+  const bool warmStart = get(Parameters::WarmStart).toBool();
+  if (warmStart)
+    key = LinearSolverCache::key(*A);
+
+  if (!x0 && warmStart)
+  {
+    // only when it is a better start than zero
+    auto last = cache.find<DenseColumnMatrix>(*key, "solution");
+    if (last && last->nrows() == b->nrows() && A->ncols() == b->nrows() &&
+        (*b - *A * *last).norm() < b->norm())
+      x0 = last;
+  }
+
   if (!x0)
   {
     // create an x0 matrix
@@ -1146,11 +1777,16 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
 
   std::string method = getOption(Variables::Method);
+  checkPreconditionerFitsMethod(method, preconditioner);
+
+  // The Jacobi method iterates with the diagonal itself
+  if (!preconditioner && method != "jacobi")
+    preconditioner = cachedPreconditioner(A, key);
 
   DenseColumnMatrixHandle conv;
   if (method == "cg")
   {
-    SolveLinearSystemCGAlgo algo(this);
+    SolveLinearSystemCGAlgo algo(this, preconditioner);
     if(!algo.run(A,b,x0,x,conv))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
@@ -1158,7 +1794,7 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
   else if (method == "bicg")
   {
-    SolveLinearSystemBICGAlgo algo(this);
+    SolveLinearSystemBICGAlgo algo(this, preconditioner);
     if(!(algo.run(A,b,x0,x,conv)))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("BiConjugate Gradient method failed"));
@@ -1166,7 +1802,7 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
   else if (method == "jacobi")
   {
-    SolveLinearSystemJACOBIAlgo algo(this);
+    SolveLinearSystemJACOBIAlgo algo(this, preconditioner);
     if(!(algo.run(A,b,x0,x,conv)))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Jacobi method failed"));
@@ -1174,7 +1810,7 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
   else if (method == "minres")
   {
-    SolveLinearSystemMINRESAlgo algo(this);
+    SolveLinearSystemMINRESAlgo algo(this, preconditioner);
     if(!(algo.run(A,b,x0,x,conv)))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("MINRES method failed"));
@@ -1183,6 +1819,9 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
 
+  if (warmStart)
+    cache.insert(*key, "solution", x, x->nrows() * sizeof(double));
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (get_bool("build_convergence"))
   {
@@ -1205,6 +1844,17 @@ AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
+  // A block of right-hand sides is solved all at once
+  auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
+  if (!rhs && rhsBlock)
+  {
+    DenseMatrixHandle solutions;
+    run(lhs, rhsBlock, DenseMatrixHandle(), solutions);
+    AlgorithmOutput output;
+    output[Variables::Solution] = solutions;
+    return output;
+  }
+
   DenseColumnMatrixHandle solution;
 
   bool success = run(lhs, rhs, DenseColumnMatrixHandle(), solution);
@@ -35,6 +35,9 @@
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
+#include <boost/optional.hpp>
 #include <Core/Algorithms/Math/share.h>
 
 namespace SCIRun {
@@ -42,8 +45,13 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+  ALGORITHM_PARAMETER_DECL(WarmStart);
+
 // Solve a linear system in parallel using a standard iterative method
 // Method solves A*x = b, with x0 being the initializer for the solution
+// Preconditioners are kept in the LinearSolverCache, so solving again with
+// the same matrix skips their setup. With WarmStart set, a missing x0 is
+// taken from the last solution for that matrix.
 
 class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
 {
@@ -61,7 +69,42 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0,
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // Solve with a preconditioner made by buildPreconditioner, so that its
+    // setup is done once for all solves with the same matrix. An empty
+    // handle uses the one selected by the Preconditioner option.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseColumnMatrixHandle b,
+             Datatypes::DenseColumnMatrixHandle x0,
+             Datatypes::DenseColumnMatrixHandle& x,
+             Datatypes::DenseColumnMatrixHandle& convergence,
+             ParallelPreconditionerHandle preconditioner) const;
+
+    // Sets up the IC(0), ILU(0) or AMG preconditioner for A; empty for the
+    // diagonal options, which cost nothing to set up.
+    ParallelPreconditionerHandle buildPreconditioner(Datatypes::SparseRowMatrixHandle A) const;
+
+    // Solves A*X = B for every column of B. CG and MINRES iterate all
+    // columns together, so each pass over A serves all right-hand sides;
+    // the other methods solve one column at a time. With WarmStart set, a
+    // missing X0 is taken from the last block solution for that matrix.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle B,
+             Datatypes::DenseMatrixHandle X0,
+             Datatypes::DenseMatrixHandle& X) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const;
+
+  private:
+    // key is computed on first use and kept for the caller, so solves that
+    // neither warm start nor build a preconditioner never hash A.
+    ParallelPreconditionerHandle cachedPreconditioner(Datatypes::SparseRowMatrixHandle A,
+      boost::optional<LinearSolverCache::Key>& key) const;
+    void solveBlock(const std::string& method, Datatypes::SparseRowMatrixHandle A,
+      Datatypes::DenseMatrixHandle B, Datatypes::DenseMatrixHandle X0, Datatypes::DenseMatrixHandle& X,
+      boost::optional<LinearSolverCache::Key>& key) const;
+    // CG and MINRES need a symmetric preconditioner; throws for ILU(0).
+    void checkPreconditionerFitsMethod(const std::string& method,
+      ParallelPreconditionerHandle preconditioner) const;
 };
 
 
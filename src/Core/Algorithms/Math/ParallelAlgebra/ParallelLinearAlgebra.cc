@@ -32,6 +32,7 @@
 /// @todo DAN: REFACTORING NEEDED: LEVEL HIGHEST
 ///////////////////////////
 
+#include <algorithm>
 #include <cfloat>
 
 #include <Core/Datatypes/Matrix.h>
@@ -97,6 +98,11 @@ bool ParallelLinearAlgebra::add_vector(DenseColumnMatrixHandle mat, ParallelVect
 }
 
 bool ParallelLinearAlgebra::new_vector(ParallelVector& V)
+{
+  return new_buffer(size_, V);
+}
+
+bool ParallelLinearAlgebra::new_buffer(size_t size, ParallelVector& V)
 {
   wait();
 
@@ -105,7 +111,7 @@ bool ParallelLinearAlgebra::new_vector(ParallelVector& V)
   {
     try
     {
-      DenseColumnMatrixHandle mat(boost::make_shared<DenseColumnMatrix>(data_.getSize()));
+      DenseColumnMatrixHandle mat(boost::make_shared<DenseColumnMatrix>(size));
       data_.setCurrentMatrix(mat);
       data_.addVector(mat);
     }
@@ -123,7 +129,9 @@ bool ParallelLinearAlgebra::new_vector(ParallelVector& V)
   auto mat = data_.getCurrentMatrix();
   wait();
 
-  return(add_vector(mat,V));
+  V.data_ = mat->data();
+  V.size_ = size;
+  return true;
 }
 
 bool ParallelLinearAlgebra::add_matrix(SparseRowMatrixHandle mat, ParallelMatrix& M)
@@ -720,6 +728,155 @@ void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
   }
 }
 
+bool ParallelLinearAlgebra::add_multi_vector(DenseMatrixHandle mat, ParallelMultiVector& V)
+{
+  if (!mat) { return (false); }
+  if (mat->nrows() != size_) { return (false); }
+
+  // DenseMatrix is row major, which is the multi vector layout
+  V.data_ = mat->data();
+  V.size_ = size_;
+  V.cols_ = mat->ncols();
+
+  wait();
+  if (proc_ == 0)
+    data_.reserveBlockReduce(V.cols_);
+  wait();
+
+  return true;
+}
+
+bool ParallelLinearAlgebra::new_multi_vector(size_t cols, ParallelMultiVector& V)
+{
+  ParallelVector buffer;
+  if (!new_buffer(size_*cols, buffer))
+    return false;
+
+  V.data_ = buffer.data_;
+  V.size_ = size_;
+  V.cols_ = cols;
+
+  if (proc_ == 0)
+    data_.reserveBlockReduce(cols);
+  wait();
+
+  return true;
+}
+
+void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelMultiVector& b, ParallelMultiVector& r)
+{
+  wait();
+
+  const size_t k = b.cols_;
+  const double* idata = b.data_;
+  double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  for (size_t i=start_;i<end_;i++)
+  {
+    double* out = r.data_ + i*k;
+    for (size_t c=0;c<k;c++) out[c] = 0.0;
+
+    index_type row_idx = rows[i];
+    index_type next_idx = rows[i+1];
+    for (index_type j=row_idx;j<next_idx;j++)
+    {
+      const double val = data[j];
+      const double* in = idata + columns[j]*k;
+      for (size_t c=0;c<k;c++) out[c] += val*in[c];
+    }
+  }
+}
+
+void ParallelLinearAlgebra::mult(const ParallelVector& a, const ParallelMultiVector& b, ParallelMultiVector& r)
+{
+  const size_t k = b.cols_;
+  for (size_t i=start_;i<end_;i++)
+  {
+    const double d = a.data_[i];
+    const double* in = b.data_ + i*k;
+    double* out = r.data_ + i*k;
+    for (size_t c=0;c<k;c++) out[c] = d*in[c];
+  }
+}
+
+void ParallelLinearAlgebra::sub(const ParallelMultiVector& a, const ParallelMultiVector& b, ParallelMultiVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t j=start_*k;j<end_*k;j++)
+    r.data_[j] = a.data_[j] - b.data_[j];
+}
+
+void ParallelLinearAlgebra::copy(const ParallelMultiVector& a, ParallelMultiVector& r)
+{
+  const size_t k = a.cols_;
+  std::copy(a.data_ + start_*k, a.data_ + end_*k, r.data_ + start_*k);
+}
+
+void ParallelLinearAlgebra::scale(const double* s, const ParallelMultiVector& a, ParallelMultiVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t i=start_;i<end_;i++)
+  {
+    const double* in = a.data_ + i*k;
+    double* out = r.data_ + i*k;
+    for (size_t c=0;c<k;c++) out[c] = s[c]*in[c];
+  }
+}
+
+void ParallelLinearAlgebra::scale_add(const double* s, const ParallelMultiVector& a,
+  const ParallelMultiVector& b, ParallelMultiVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t i=start_;i<end_;i++)
+  {
+    const double* ain = a.data_ + i*k;
+    const double* bin = b.data_ + i*k;
+    double* out = r.data_ + i*k;
+    for (size_t c=0;c<k;c++) out[c] = s[c]*ain[c] + bin[c];
+  }
+}
+
+void ParallelLinearAlgebra::zeros(ParallelMultiVector& r)
+{
+  const size_t k = r.cols_;
+  std::fill(r.data_ + start_*k, r.data_ + end_*k, 0.0);
+}
+
+void ParallelLinearAlgebra::dot(const ParallelMultiVector& a, const ParallelMultiVector& b, double* r)
+{
+  const size_t k = a.cols_;
+  for (size_t c=0;c<k;c++) r[c] = 0.0;
+  for (size_t i=start_;i<end_;i++)
+  {
+    const double* ain = a.data_ + i*k;
+    const double* bin = b.data_ + i*k;
+    for (size_t c=0;c<k;c++) r[c] += ain[c]*bin[c];
+  }
+  reduce_sum(r, k);
+}
+
+void ParallelLinearAlgebra::norm(const ParallelMultiVector& a, double* r)
+{
+  dot(a, a, r);
+  for (size_t c=0;c<a.cols_;c++) r[c] = sqrt(r[c]);
+}
+
+void ParallelLinearAlgebra::copy_column(const ParallelMultiVector& a, size_t j, ParallelVector& r)
+{
+  const size_t k = a.cols_;
+  for (size_t i=start_;i<end_;i++)
+    r.data_[i] = a.data_[i*k + j];
+}
+
+void ParallelLinearAlgebra::copy_column(const ParallelVector& a, size_t j, ParallelMultiVector& r)
+{
+  const size_t k = r.cols_;
+  for (size_t i=start_;i<end_;i++)
+    r.data_[i*k + j] = a.data_[i];
+}
+
 double ParallelLinearAlgebra::reduce_sum(double val)
 {
   int buffer = reduce_buffer_;
@@ -734,6 +891,22 @@ double ParallelLinearAlgebra::reduce_sum(double val)
   return (ret);
 }
 
+void ParallelLinearAlgebra::reduce_sum(double* vals, size_t n)
+{
+  const size_t stride = data_.blockReduceColumns();
+  double* buffer = data_.blockReduceBuffer(reduce_buffer_);
+  std::copy(vals, vals + n, buffer + proc_*stride);
+  if (reduce_buffer_)
+    reduce_buffer_ = 0;
+  else
+    reduce_buffer_ = 1;
+  wait();
+
+  for (size_t c=0; c<n; c++) vals[c] = 0.0;
+  for (int j=0; j<nproc_; j++)
+    for (size_t c=0; c<n; c++) vals[c] += buffer[j*stride + c];
+}
+
 /// @todo: std::max_element
 double ParallelLinearAlgebra::reduce_max(double val)
 {
@@ -766,12 +939,23 @@ double ParallelLinearAlgebra::reduce_min(double val)
 
 
 
+bool SolverInputs::dimensionsMatch(size_t size) const
+{
+  if (!b && !B)
+    return false;
+  if ((b && b->nrows() != size) || (x && x->nrows() != size) || (x0 && x0->nrows() != size))
+    return false;
+  if ((B && B->nrows() != size) || (X && X->nrows() != size) || (X0 && X0->nrows() != size))
+    return false;
+  if (B && ((X && X->ncols() != B->ncols()) || (X0 && X0->ncols() != B->ncols())))
+    return false;
+  return true;
+}
+
 bool ParallelLinearAlgebraBase::start_parallel(SolverInputs& matrices, int nproc) const
 {
   size_t size = matrices.A->nrows();
-  if (matrices.b->nrows() != size
-    || matrices.x->nrows() != size
-    || matrices.x0->nrows() != size)
+  if (!matrices.dimensionsMatch(size))
     return false;
 
   /// Require a minimum of 50 variables per processor
@@ -806,10 +990,18 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   barrier_("Parallel Linear Algebra", numProcs),
   numProcs_(numProcs),
   reduce1_(numProcs),
-  reduce2_(numProcs)
+  reduce2_(numProcs),
+  blockReduceColumns_(0)
 {
-  if (inputs.b->nrows() != size_
-    || inputs.x->nrows() != size_
-    || inputs.x0->nrows() != size_)
+  if (!inputs.dimensionsMatch(size_))
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Dimension mismatch")); /// @todo: use new DimensionMismatch exception type
 }
+
+void ParallelLinearAlgebraSharedData::reserveBlockReduce(size_t columns)
+{
+  if (columns > blockReduceColumns_)
+  {
+    blockReduceColumns_ = columns;
+    blockReduce_.assign(2*numProcs_*columns, 0.0);
+  }
+}
@@ -55,13 +55,26 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle x0;
     Datatypes::DenseColumnMatrixHandle x;
 
+    /// Right-hand sides, initial guesses and solutions of a block solve,
+    /// one system per column. The vectors above are not used then.
+    Datatypes::DenseMatrixHandle B;
+    Datatypes::DenseMatrixHandle X0;
+    Datatypes::DenseMatrixHandle X;
+
     void clear()
     {
       A.reset();
       b.reset();
       x0.reset();
       x.reset();
+      B.reset();
+      X0.reset();
+      X.reset();
     }
+
+    /// True if all given vectors and blocks have size rows and the blocks
+    /// have the same number of columns.
+    bool dimensionsMatch(size_t size) const;
   };
 
   class SCISHARE ParallelLinearAlgebraSharedData : boost::noncopyable
@@ -96,6 +109,12 @@ namespace Math {
     double* reduceBuffer1() { return &reduce1_[0]; }
     double* reduceBuffer2() { return &reduce2_[0]; }
 
+    /// Two buffers of numProcs x columns values for reducing all columns of
+    /// a multi vector at once
+    void reserveBlockReduce(size_t columns);
+    size_t blockReduceColumns() const { return blockReduceColumns_; }
+    double* blockReduceBuffer(int i) { return &blockReduce_[i*numProcs_*blockReduceColumns_]; }
+
   private:
     size_t size_;
     Datatypes::DenseColumnMatrixHandle current_matrix_;
@@ -107,6 +126,8 @@ namespace Math {
     /// classes for communication
     std::vector<double> reduce1_;
     std::vector<double> reduce2_;
+    std::vector<double> blockReduce_;
+    size_t blockReduceColumns_;
   };
 
 // The algorithm that uses this should derive from this class
@@ -147,13 +168,28 @@ public:
       size_t   nnz_;
   };
 
+  // A block of vectors stored row by row, so that entry (i,j) is
+  // data_[i*cols_ + j]. A sparse matrix times a multi vector reads every
+  // matrix entry once for all columns.
+  class ParallelMultiVector {
+    public:
+      double* data_;
+      size_t size_;
+      size_t cols_;
+  };
+
   // Constructor
   ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& base, int proc);
 
   bool add_vector(Datatypes::DenseColumnMatrixHandle mat, ParallelVector& V);
   bool new_vector(ParallelVector& V);
+  // Shared vector of any length, e.g. scratch space for a preconditioner
+  bool new_buffer(size_t size, ParallelVector& V);
   bool add_matrix(Datatypes::SparseRowMatrixHandle mat, ParallelMatrix& M);
 
+  bool add_multi_vector(Datatypes::DenseMatrixHandle mat, ParallelMultiVector& V);
+  bool new_multi_vector(size_t cols, ParallelMultiVector& V);
+
   void mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
   void sub(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
   void copy(const ParallelVector& a, ParallelVector& r);
@@ -189,6 +225,25 @@ public:
 
   void ones(ParallelVector& r);
 
+  // Multi vector versions of the above. Scalars are given per column, and
+  // reductions return one value per column.
+  void mult(const ParallelMatrix& a, const ParallelMultiVector& b, ParallelMultiVector& r);
+  // r(i,j) = a(i)*b(i,j), row scaling as done by a diagonal preconditioner
+  void mult(const ParallelVector& a, const ParallelMultiVector& b, ParallelMultiVector& r);
+  void sub(const ParallelMultiVector& a, const ParallelMultiVector& b, ParallelMultiVector& r);
+  void copy(const ParallelMultiVector& a, ParallelMultiVector& r);
+  // r(:,j) = s[j]*a(:,j)
+  void scale(const double* s, const ParallelMultiVector& a, ParallelMultiVector& r);
+  // r(:,j) = s[j]*a(:,j) + b(:,j)
+  void scale_add(const double* s, const ParallelMultiVector& a, const ParallelMultiVector& b, ParallelMultiVector& r);
+  void zeros(ParallelMultiVector& r);
+  void dot(const ParallelMultiVector& a, const ParallelMultiVector& b, double* r);
+  void norm(const ParallelMultiVector& a, double* r);
+
+  // Moves one column in or out of a multi vector
+  void copy_column(const ParallelMultiVector& a, size_t j, ParallelVector& r);
+  void copy_column(const ParallelVector& a, size_t j, ParallelMultiVector& r);
+
   int  proc() { return proc_; }
   int  nproc() { return nproc_; }
 
@@ -199,6 +254,7 @@ private:
   double reduce_sum(double val);
   double reduce_min(double val);
   double reduce_max(double val);
+  void reduce_sum(double* vals, size_t n);
 
   ParallelLinearAlgebraSharedData& data_;
 
@@ -0,0 +1,831 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cmath>
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/make_shared.hpp>
+
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  /// Levels with fewer rows than this are not worth a parallel pass and
+  /// are merged with their neighbours into one stage run by a single thread.
+  const index_type SERIAL_STAGE_ROWS = 512;
+
+  /// The coarsest AMG level is solved with a dense LU up to this size.
+  const size_type MAX_DENSE_COARSE_SIZE = 2000;
+
+  /// Rows of a vector of length n handled by this thread.
+  void thread_rows(ParallelLinearAlgebra& PLA, size_t n, size_t& start, size_t& end)
+  {
+    start = n * PLA.proc() / PLA.nproc();
+    end = n * (PLA.proc() + 1) / PLA.nproc();
+  }
+
+  /// Sorts the rows of a triangular dependency graph by level: a row of a
+  /// lower (upper) triangular system depends on the rows of its columns
+  /// below (above) the diagonal. Runs of small levels become serial stages.
+  size_t compute_levels(bool lower, index_type n, const index_type* rows, const index_type* columns,
+    std::vector<index_type>& order, std::vector<index_type>& stages, std::vector<char>& serial)
+  {
+    std::vector<index_type> level(n, 0);
+    index_type num_levels = 0;
+    for (index_type k = 0; k < n; ++k)
+    {
+      const index_type i = lower ? k : n - 1 - k;
+      index_type l = 0;
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      {
+        const index_type c = columns[j];
+        if (lower ? c < i : c > i)
+          l = std::max(l, level[c] + 1);
+      }
+      level[i] = l;
+      num_levels = std::max(num_levels, l + 1);
+    }
+
+    std::vector<index_type> start(num_levels + 1, 0);
+    for (index_type i = 0; i < n; ++i)
+      ++start[level[i] + 1];
+    for (index_type l = 0; l < num_levels; ++l)
+      start[l + 1] += start[l];
+
+    order.resize(n);
+    std::vector<index_type> pos(start.begin(), start.end() - 1);
+    for (index_type i = 0; i < n; ++i)
+      order[pos[level[i]]++] = i;
+
+    stages.clear();
+    serial.clear();
+    for (index_type l = 0; l < num_levels;)
+    {
+      stages.push_back(start[l]);
+      if (start[l + 1] - start[l] >= SERIAL_STAGE_ROWS)
+      {
+        serial.push_back(0);
+        ++l;
+      }
+      else
+      {
+        serial.push_back(1);
+        while (l < num_levels && start[l + 1] - start[l] < SERIAL_STAGE_ROWS)
+          ++l;
+      }
+    }
+    stages.push_back(n);
+    return static_cast<size_t>(num_levels);
+  }
+
+  /// Calls rowfunc for every row, level by level, using the thread pool for
+  /// the parallel stages. Used to compute the factorizations, where a row
+  /// depends on the same rows as in the triangular solve.
+  template <class ROWFUNC>
+  void for_each_row_by_level(const std::vector<index_type>& order, const std::vector<index_type>& stages,
+    const std::vector<char>& serial, ROWFUNC rowfunc)
+  {
+    for (size_t s = 0; s < serial.size(); ++s)
+    {
+      if (serial[s])
+      {
+        for (index_type k = stages[s]; k < stages[s + 1]; ++k)
+          rowfunc(order[k]);
+      }
+      else
+      {
+        Parallel::For(IndexRange(stages[s], stages[s + 1]), 0,
+          [&order, &rowfunc](const IndexRange& r)
+          {
+            for (size_t k = r.begin; k < r.end; ++k)
+              rowfunc(order[k]);
+          });
+      }
+    }
+  }
+
+  void transpose_csr(index_type n, const std::vector<index_type>& rows, const std::vector<index_type>& columns,
+    const std::vector<double>& values, std::vector<index_type>& trows, std::vector<index_type>& tcolumns,
+    std::vector<double>& tvalues)
+  {
+    trows.assign(n + 1, 0);
+    for (size_t j = 0; j < columns.size(); ++j)
+      ++trows[columns[j] + 1];
+    for (index_type i = 0; i < n; ++i)
+      trows[i + 1] += trows[i];
+
+    std::vector<index_type> pos(trows.begin(), trows.end() - 1);
+    tcolumns.resize(columns.size());
+    tvalues.resize(values.size());
+    for (index_type i = 0; i < n; ++i)
+    {
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      {
+        const index_type q = pos[columns[j]]++;
+        tcolumns[q] = i;
+        tvalues[q] = values[j];
+      }
+    }
+  }
+
+  /// Splits a factored matrix into its strictly lower or upper part.
+  void strict_part(bool lower, index_type n, const index_type* rows, const index_type* columns,
+    const double* values, std::vector<index_type>& prows, std::vector<index_type>& pcolumns,
+    std::vector<double>& pvalues)
+  {
+    prows.assign(n + 1, 0);
+    pcolumns.clear();
+    pvalues.clear();
+    for (index_type i = 0; i < n; ++i)
+    {
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      {
+        if (lower ? columns[j] < i : columns[j] > i)
+        {
+          pcolumns.push_back(columns[j]);
+          pvalues.push_back(values[j]);
+        }
+      }
+      prows[i + 1] = static_cast<index_type>(pcolumns.size());
+    }
+  }
+
+  // The setups read the CSR arrays directly. An uncompressed matrix is
+  // compressed as a copy so the caller's matrix is left as it was.
+  SparseRowMatrixHandle compressed(SparseRowMatrixHandle A)
+  {
+    if (A->isCompressed())
+      return A;
+    auto copy = boost::make_shared<SparseRowMatrix>(*A);
+    copy->makeCompressed();
+    return copy;
+  }
+
+  size_t matrix_bytes(const SparseRowMatrix& A)
+  {
+    return (A.outerSize() + 1) * sizeof(index_type) +
+      A.nonZeros() * (sizeof(index_type) + sizeof(double));
+  }
+
+  inline double row_times(const index_type* rows, const index_type* columns, const double* values,
+    size_t i, const double* x)
+  {
+    double sum = 0.0;
+    for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      sum += values[j] * x[columns[j]];
+    return sum;
+  }
+}
+
+ParallelPreconditioner::~ParallelPreconditioner()
+{
+}
+
+ParallelPreconditionerHandle
+ParallelPreconditioner::create(const std::string& name, SparseRowMatrixHandle A)
+{
+  if (name == "IC(0)")
+    return boost::make_shared<IncompleteCholeskyPreconditioner>(A);
+  if (name == "ILU(0)")
+    return boost::make_shared<IncompleteLUPreconditioner>(A);
+  if (name == "AMG")
+    return boost::make_shared<SmoothedAggregationAMGPreconditioner>(A);
+  return ParallelPreconditionerHandle();
+}
+
+bool ParallelPreconditioner::exists(const std::string& name)
+{
+  return name == "IC(0)" || name == "ILU(0)" || name == "AMG";
+}
+
+bool ParallelPreconditioner::is_symmetric(const std::string& name)
+{
+  return name != "ILU(0)";
+}
+
+//------------------------------------------------------------------
+// Level scheduled triangular solve
+
+void LevelScheduledTriangularSolve::assign(bool lower, std::vector<index_type>& rows,
+  std::vector<index_type>& columns, std::vector<double>& values, std::vector<double>& invdiag)
+{
+  rows_.swap(rows);
+  columns_.swap(columns);
+  values_.swap(values);
+  invdiag_.swap(invdiag);
+
+  num_levels_ = compute_levels(lower, static_cast<index_type>(invdiag_.size()),
+    &rows_[0], columns_.empty() ? nullptr : &columns_[0], order_, stages_, serial_);
+}
+
+size_t LevelScheduledTriangularSolve::memory_size() const
+{
+  return (rows_.size() + columns_.size() + order_.size() + stages_.size()) * sizeof(index_type) +
+    (values_.size() + invdiag_.size()) * sizeof(double) + serial_.size();
+}
+
+void LevelScheduledTriangularSolve::solve(ParallelLinearAlgebra& PLA, const double* r, double* z) const
+{
+  const index_type* rows = &rows_[0];
+  const index_type* columns = columns_.empty() ? nullptr : &columns_[0];
+  const double* values = values_.empty() ? nullptr : &values_[0];
+
+  // r is written by all threads
+  PLA.wait();
+
+  for (size_t s = 0; s < serial_.size(); ++s)
+  {
+    size_t start = stages_[s];
+    size_t end = stages_[s + 1];
+    if (serial_[s])
+    {
+      if (!PLA.first()) end = start;
+    }
+    else
+    {
+      const size_t n = end - start;
+      end = start + n * (PLA.proc() + 1) / PLA.nproc();
+      start = start + n * PLA.proc() / PLA.nproc();
+    }
+
+    for (size_t k = start; k < end; ++k)
+    {
+      const index_type i = order_[k];
+      z[i] = (r[i] - row_times(rows, columns, values, i, z)) * invdiag_[i];
+    }
+    PLA.wait();
+  }
+}
+
+//------------------------------------------------------------------
+// Incomplete Cholesky
+
+IncompleteCholeskyPreconditioner::IncompleteCholeskyPreconditioner(SparseRowMatrixHandle A) :
+  shift_(0.0)
+{
+  A = compressed(A);
+  const index_type n = A->nrows();
+  const index_type* arows = A->outerIndexPtr();
+  const index_type* acolumns = A->innerIndexPtr();
+  const double* avalues = A->valuePtr();
+
+  std::vector<index_type> rows, columns;
+  std::vector<double> lower, values;
+  strict_part(true, n, arows, acolumns, avalues, rows, columns, lower);
+
+  std::vector<double> diag(n, 0.0);
+  for (index_type i = 0; i < n; ++i)
+  {
+    for (index_type j = arows[i]; j < arows[i + 1]; ++j)
+      if (acolumns[j] == i) diag[i] = avalues[j];
+    if (!(diag[i] > 0.0))
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("IC(0) preconditioner needs a matrix with a positive diagonal"));
+  }
+
+  std::vector<index_type> order, stages;
+  std::vector<char> serial;
+  compute_levels(true, n, &rows[0], columns.empty() ? nullptr : &columns[0], order, stages, serial);
+
+  std::vector<double> invdiag(n);
+  boost::atomic<bool> failed(true);
+  while (failed)
+  {
+    failed = false;
+    values = lower;
+    const double scale = 1.0 + shift_;
+
+    // Row i of L only needs the rows of L it has entries in, which are
+    // all in earlier levels.
+    for_each_row_by_level(order, stages, serial, [&](index_type i)
+    {
+      double d = diag[i] * scale;
+      for (index_type p = rows[i]; p < rows[i + 1]; ++p)
+      {
+        const index_type k = columns[p];
+        double s = values[p];
+        index_type t = rows[i];
+        index_type q = rows[k];
+        while (t < p && q < rows[k + 1])
+        {
+          if (columns[t] == columns[q]) s -= values[t++] * values[q++];
+          else if (columns[t] < columns[q]) ++t;
+          else ++q;
+        }
+        values[p] = s * invdiag[k];
+        d -= values[p] * values[p];
+      }
+      if (!(d > 0.0))
+      {
+        failed = true;
+        d = diag[i];
+      }
+      invdiag[i] = 1.0 / std::sqrt(d);
+    });
+
+    if (failed)
+    {
+      shift_ = (shift_ == 0.0) ? 1e-3 : 2.0 * shift_;
+      if (shift_ > 1.0)
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("IC(0) preconditioner could not be computed, matrix is not positive definite"));
+    }
+  }
+
+  std::vector<index_type> trows, tcolumns;
+  std::vector<double> tvalues;
+  transpose_csr(n, rows, columns, values, trows, tcolumns, tvalues);
+  std::vector<double> tinvdiag(invdiag);
+
+  lower_.assign(true, rows, columns, values, invdiag);
+  upper_.assign(false, trows, tcolumns, tvalues, tinvdiag);
+}
+
+void IncompleteCholeskyPreconditioner::apply(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z, double*) const
+{
+  lower_.solve(PLA, r.data_, z.data_);
+  upper_.solve(PLA, z.data_, z.data_);
+}
+
+size_t IncompleteCholeskyPreconditioner::memory_size() const
+{
+  return lower_.memory_size() + upper_.memory_size();
+}
+
+//------------------------------------------------------------------
+// Incomplete LU
+
+IncompleteLUPreconditioner::IncompleteLUPreconditioner(SparseRowMatrixHandle A)
+{
+  A = compressed(A);
+  const index_type n = A->nrows();
+  const index_type* rows = A->outerIndexPtr();
+  const index_type* columns = A->innerIndexPtr();
+  std::vector<double> values(A->valuePtr(), A->valuePtr() + A->nonZeros());
+
+  std::vector<index_type> diagpos(n);
+  for (index_type i = 0; i < n; ++i)
+  {
+    const index_type* d = std::lower_bound(columns + rows[i], columns + rows[i + 1], i);
+    if (d == columns + rows[i + 1] || *d != i)
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("ILU(0) preconditioner needs a matrix with all diagonal entries present"));
+    diagpos[i] = d - columns;
+  }
+
+  std::vector<index_type> order, stages;
+  std::vector<char> serial;
+  compute_levels(true, n, rows, columns, order, stages, serial);
+
+  for_each_row_by_level(order, stages, serial, [&](index_type i)
+  {
+    double rowmax = 0.0;
+    for (index_type p = rows[i]; p < rows[i + 1]; ++p)
+      rowmax = std::max(rowmax, std::abs(values[p]));
+
+    for (index_type p = rows[i]; p < diagpos[i]; ++p)
+    {
+      const index_type k = columns[p];
+      const double lik = values[p] / values[diagpos[k]];
+      values[p] = lik;
+
+      index_type t = p + 1;
+      index_type q = diagpos[k] + 1;
+      while (t < rows[i + 1] && q < rows[k + 1])
+      {
+        if (columns[t] == columns[q]) values[t++] -= lik * values[q++];
+        else if (columns[t] < columns[q]) ++t;
+        else ++q;
+      }
+    }
+
+    // keep the pivot away from zero
+    double& pivot = values[diagpos[i]];
+    const double tiny = 1e-12 * (rowmax > 0.0 ? rowmax : 1.0);
+    if (std::abs(pivot) < tiny)
+      pivot = (pivot < 0.0) ? -tiny : tiny;
+  });
+
+  std::vector<double> unit(n, 1.0), invdiag(n);
+  for (index_type i = 0; i < n; ++i)
+    invdiag[i] = 1.0 / values[diagpos[i]];
+
+  std::vector<index_type> lrows, lcolumns, urows, ucolumns, trows, tcolumns;
+  std::vector<double> lvalues, uvalues, tvalues;
+  strict_part(true, n, rows, columns, &values[0], lrows, lcolumns, lvalues);
+  strict_part(false, n, rows, columns, &values[0], urows, ucolumns, uvalues);
+
+  {
+    transpose_csr(n, urows, ucolumns, uvalues, trows, tcolumns, tvalues);
+    std::vector<double> d(invdiag);
+    Ut_.assign(true, trows, tcolumns, tvalues, d);
+  }
+  {
+    transpose_csr(n, lrows, lcolumns, lvalues, trows, tcolumns, tvalues);
+    std::vector<double> d(unit);
+    Lt_.assign(false, trows, tcolumns, tvalues, d);
+  }
+  L_.assign(true, lrows, lcolumns, lvalues, unit);
+  U_.assign(false, urows, ucolumns, uvalues, invdiag);
+}
+
+void IncompleteLUPreconditioner::apply(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z, double*) const
+{
+  L_.solve(PLA, r.data_, z.data_);
+  U_.solve(PLA, z.data_, z.data_);
+}
+
+void IncompleteLUPreconditioner::apply_transpose(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z, double*) const
+{
+  Ut_.solve(PLA, r.data_, z.data_);
+  Lt_.solve(PLA, z.data_, z.data_);
+}
+
+size_t IncompleteLUPreconditioner::memory_size() const
+{
+  return L_.memory_size() + U_.memory_size() + Ut_.memory_size() + Lt_.memory_size();
+}
+
+//------------------------------------------------------------------
+// Smoothed aggregation AMG
+
+class SmoothedAggregationAMGPreconditioner::CoarseSolver
+{
+public:
+  explicit CoarseSolver(const SparseRowMatrix& A) : lu_(Eigen::MatrixXd(A.toDense())) {}
+
+  void solve(const double* b, double* x, size_t n) const
+  {
+    Eigen::Map<Eigen::VectorXd>(x, n) = lu_.solve(Eigen::Map<const Eigen::VectorXd>(b, n));
+  }
+
+  size_t memory_size() const
+  {
+    return lu_.rows() * lu_.cols() * sizeof(double) + 4 * lu_.rows() * sizeof(index_type);
+  }
+
+private:
+  Eigen::FullPivLU<Eigen::MatrixXd> lu_;
+};
+
+namespace
+{
+  /// Estimates the largest eigenvalue of inv(D)*A with a few power
+  /// iterations, bounded from above by the Gershgorin estimate.
+  double estimate_spectral_radius(const SparseRowMatrix& A, const std::vector<double>& invdiag)
+  {
+    const index_type n = A.nrows();
+    const index_type* rows = A.outerIndexPtr();
+    const index_type* columns = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+
+    double gershgorin = 0.0;
+    for (index_type i = 0; i < n; ++i)
+    {
+      double sum = 0.0;
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        sum += std::abs(values[j]);
+      gershgorin = std::max(gershgorin, sum * std::abs(invdiag[i]));
+    }
+
+    std::vector<double> v(n), w(n);
+    for (index_type i = 0; i < n; ++i)
+      v[i] = 1.0 + static_cast<double>((i * 7919) % 1000) / 1000.0;
+
+    double rho = 0.0;
+    for (int iter = 0; iter < 15; ++iter)
+    {
+      double vnorm = 0.0, wnorm = 0.0;
+      for (index_type i = 0; i < n; ++i)
+      {
+        w[i] = invdiag[i] * row_times(rows, columns, values, i, &v[0]);
+        vnorm += v[i] * v[i];
+        wnorm += w[i] * w[i];
+      }
+      if (wnorm == 0.0) break;
+      rho = std::sqrt(wnorm / vnorm);
+      const double s = 1.0 / std::sqrt(wnorm);
+      for (index_type i = 0; i < n; ++i)
+        v[i] = w[i] * s;
+    }
+    rho = std::min(1.05 * rho, gershgorin);
+    return (rho > 0.0) ? rho : 1.0;
+  }
+
+  /// Greedy aggregation on the graph of strong connections,
+  /// |a_ij| >= theta*sqrt(|a_ii*a_jj|). Nodes without strong connections,
+  /// like Dirichlet rows, stay unaggregated (-1) and are left to the smoother.
+  index_type aggregate(const SparseRowMatrix& A, double theta, std::vector<index_type>& agg)
+  {
+    const index_type n = A.nrows();
+    const index_type* rows = A.outerIndexPtr();
+    const index_type* columns = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+
+    std::vector<double> diag(n, 0.0);
+    for (index_type i = 0; i < n; ++i)
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+        if (columns[j] == i) diag[i] = std::abs(values[j]);
+
+    std::vector<index_type> srows(n + 1, 0), scolumns;
+    scolumns.reserve(A.nonZeros());
+    for (index_type i = 0; i < n; ++i)
+    {
+      for (index_type j = rows[i]; j < rows[i + 1]; ++j)
+      {
+        const index_type c = columns[j];
+        if (c != i && values[j] * values[j] >= theta * theta * diag[i] * diag[c])
+          scolumns.push_back(c);
+      }
+      srows[i + 1] = static_cast<index_type>(scolumns.size());
+    }
+
+    agg.assign(n, -1);
+    index_type num_aggregates = 0;
+
+    // pass 1: nodes whose strong neighbourhood is still free seed an aggregate
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0 || srows[i] == srows[i + 1]) continue;
+      bool free = true;
+      for (index_type j = srows[i]; j < srows[i + 1] && free; ++j)
+        free = (agg[scolumns[j]] < 0);
+      if (!free) continue;
+      agg[i] = num_aggregates;
+      for (index_type j = srows[i]; j < srows[i + 1]; ++j)
+        agg[scolumns[j]] = num_aggregates;
+      ++num_aggregates;
+    }
+
+    // pass 2: attach the remaining nodes to a neighbouring aggregate
+    std::vector<index_type> seeded(agg);
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0) continue;
+      for (index_type j = srows[i]; j < srows[i + 1]; ++j)
+      {
+        if (seeded[scolumns[j]] >= 0)
+        {
+          agg[i] = seeded[scolumns[j]];
+          break;
+        }
+      }
+    }
+
+    // pass 3: whatever is left forms aggregates with its free neighbours
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0 || srows[i] == srows[i + 1]) continue;
+      agg[i] = num_aggregates;
+      for (index_type j = srows[i]; j < srows[i + 1]; ++j)
+        if (agg[scolumns[j]] < 0) agg[scolumns[j]] = num_aggregates;
+      ++num_aggregates;
+    }
+
+    return num_aggregates;
+  }
+}
+
+SmoothedAggregationAMGPreconditioner::SmoothedAggregationAMGPreconditioner(SparseRowMatrixHandle A)
+{
+  const size_t max_levels = 10;
+  const size_type coarse_size = 400;
+  const double theta = 0.08;
+
+  SparseRowMatrixHandle Al = compressed(A);
+  ownsFinestLevel_ = Al != A;
+  for (;;)
+  {
+    Level level;
+    level.A = Al;
+    level.size = Al->nrows();
+    level.invdiag.assign(level.size, 0.0);
+    for (index_type i = 0; i < Al->nrows(); ++i)
+    {
+      const double d = Al->coeff(i, i);
+      if (d != 0.0) level.invdiag[i] = 1.0 / d;
+    }
+    const double rho = estimate_spectral_radius(*Al, level.invdiag);
+    level.omega = 4.0 / (3.0 * rho);
+
+    std::vector<index_type> agg;
+    const index_type num_aggregates = (Al->nrows() > coarse_size && levels_.size() + 1 < max_levels) ?
+      aggregate(*Al, theta, agg) : 0;
+    if (num_aggregates == 0 || num_aggregates > 0.8 * Al->nrows())
+    {
+      levels_.push_back(level);
+      break;
+    }
+
+    // tentative prolongator: the normalized constant on each aggregate
+    std::vector<index_type> count(num_aggregates, 0);
+    for (size_t i = 0; i < agg.size(); ++i)
+      if (agg[i] >= 0) ++count[agg[i]];
+
+    SparseRowMatrix P0(Al->nrows(), num_aggregates);
+    P0.allocateCompressed(agg.size());
+    index_type* prows = P0.get_rows();
+    index_type* pcolumns = P0.get_cols();
+    double* pvalues = P0.valuePtr();
+    prows[0] = 0;
+    for (size_t i = 0; i < agg.size(); ++i)
+    {
+      index_type k = prows[i];
+      if (agg[i] >= 0)
+      {
+        pcolumns[k] = agg[i];
+        pvalues[k] = 1.0 / std::sqrt(static_cast<double>(count[agg[i]]));
+        ++k;
+      }
+      prows[i + 1] = k;
+    }
+    P0.finishCompressed();
+
+    // smoothed prolongator P = (I - omega*inv(D)*A)*P0
+    SparseRowMatrix AP0 = (*Al) * P0;
+    for (index_type i = 0; i < AP0.outerSize(); ++i)
+      for (SparseRowMatrix::InnerIterator it(AP0, i); it; ++it)
+        it.valueRef() *= level.omega * level.invdiag[i];
+    level.P = boost::make_shared<SparseRowMatrix>(P0 - AP0);
+    level.R = boost::make_shared<SparseRowMatrix>(level.P->transpose());
+    level.P->makeCompressed();
+    level.R->makeCompressed();
+
+    SparseRowMatrix RA = (*level.R) * (*Al);
+    Al = boost::make_shared<SparseRowMatrix>(RA * (*level.P));
+    Al->makeCompressed();
+    levels_.push_back(level);
+  }
+
+  if (levels_.back().A->nrows() <= MAX_DENSE_COARSE_SIZE)
+    coarse_ = boost::make_shared<CoarseSolver>(*levels_.back().A);
+}
+
+SmoothedAggregationAMGPreconditioner::~SmoothedAggregationAMGPreconditioner()
+{
+}
+
+size_t SmoothedAggregationAMGPreconditioner::workspace_size() const
+{
+  size_t size = 0;
+  for (size_t l = 0; l < levels_.size(); ++l)
+    size += 3 * levels_[l].size;
+  return size;
+}
+
+size_t SmoothedAggregationAMGPreconditioner::memory_size() const
+{
+  size_t size = coarse_ ? coarse_->memory_size() : 0;
+  for (size_t l = 0; l < levels_.size(); ++l)
+  {
+    // the finest level operator is the input matrix unless it was copied
+    if (l > 0 || ownsFinestLevel_) size += matrix_bytes(*levels_[l].A);
+    if (levels_[l].P) size += matrix_bytes(*levels_[l].P) + matrix_bytes(*levels_[l].R);
+    size += levels_[l].invdiag.size() * sizeof(double);
+  }
+  return size;
+}
+
+void SmoothedAggregationAMGPreconditioner::smooth(ParallelLinearAlgebra& PLA, const Level& level,
+  const double* b, double* x, double* tmp, bool zero_guess) const
+{
+  const index_type* rows = level.A->outerIndexPtr();
+  const index_type* columns = level.A->innerIndexPtr();
+  const double* values = level.A->valuePtr();
+  const double* invdiag = level.invdiag.empty() ? nullptr : &level.invdiag[0];
+  const double w = level.omega;
+
+  size_t start, end;
+  thread_rows(PLA, level.size, start, end);
+
+  // Two damped Jacobi sweeps, x -> tmp -> x
+  if (zero_guess)
+  {
+    for (size_t i = start; i < end; ++i)
+      tmp[i] = w * invdiag[i] * b[i];
+  }
+  else
+  {
+    for (size_t i = start; i < end; ++i)
+      tmp[i] = x[i] + w * invdiag[i] * (b[i] - row_times(rows, columns, values, i, x));
+  }
+  PLA.wait();
+
+  for (size_t i = start; i < end; ++i)
+    x[i] = tmp[i] + w * invdiag[i] * (b[i] - row_times(rows, columns, values, i, tmp));
+  PLA.wait();
+}
+
+void SmoothedAggregationAMGPreconditioner::apply(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z, double* work) const
+{
+  const size_t num_levels = levels_.size();
+  size_t start, end;
+
+  // work holds x, b and a temporary for every level
+  std::vector<double*> x(num_levels), b(num_levels), tmp(num_levels);
+  double* ptr = work;
+  for (size_t l = 0; l < num_levels; ++l)
+  {
+    x[l] = ptr; ptr += levels_[l].size;
+    b[l] = ptr; ptr += levels_[l].size;
+    tmp[l] = ptr; ptr += levels_[l].size;
+  }
+
+  // r is written by all threads
+  PLA.wait();
+  thread_rows(PLA, levels_[0].size, start, end);
+  std::copy(r.data_ + start, r.data_ + end, b[0] + start);
+  PLA.wait();
+
+  for (size_t l = 0; l + 1 < num_levels; ++l)
+  {
+    const Level& level = levels_[l];
+    smooth(PLA, level, b[l], x[l], tmp[l], true);
+
+    const index_type* rows = level.A->outerIndexPtr();
+    const index_type* columns = level.A->innerIndexPtr();
+    const double* values = level.A->valuePtr();
+    thread_rows(PLA, level.size, start, end);
+    for (size_t i = start; i < end; ++i)
+      tmp[l][i] = b[l][i] - row_times(rows, columns, values, i, x[l]);
+    PLA.wait();
+
+    rows = level.R->outerIndexPtr();
+    columns = level.R->innerIndexPtr();
+    values = level.R->valuePtr();
+    thread_rows(PLA, levels_[l + 1].size, start, end);
+    for (size_t i = start; i < end; ++i)
+      b[l + 1][i] = row_times(rows, columns, values, i, tmp[l]);
+    PLA.wait();
+  }
+
+  const Level& coarsest = levels_.back();
+  if (coarse_)
+  {
+    if (PLA.first())
+      coarse_->solve(b.back(), x.back(), coarsest.size);
+    PLA.wait();
+  }
+  else
+  {
+    smooth(PLA, coarsest, b.back(), x.back(), tmp.back(), true);
+  }
+
+  for (size_t l = num_levels - 1; l-- > 0;)
+  {
+    const Level& level = levels_[l];
+    const index_type* rows = level.P->outerIndexPtr();
+    const index_type* columns = level.P->innerIndexPtr();
+    const double* values = level.P->valuePtr();
+    thread_rows(PLA, level.size, start, end);
+    for (size_t i = start; i < end; ++i)
+      x[l][i] += row_times(rows, columns, values, i, x[l + 1]);
+    PLA.wait();
+
+    smooth(PLA, level, b[l], x[l], tmp[l], false);
+  }
+
+  thread_rows(PLA, levels_[0].size, start, end);
+  std::copy(x[0] + start, x[0] + end, z.data_ + start);
+  PLA.wait();
+}
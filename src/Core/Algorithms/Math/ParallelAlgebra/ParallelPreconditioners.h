@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// A preconditioner M for the ParallelLinearAlgebra solvers. The setup
+  /// (factorization or multigrid hierarchy) only depends on the matrix and
+  /// is done once when the object is made, so one object can be used for any
+  /// number of solves with the same matrix, also concurrently. apply() is
+  /// called by every thread of a ParallelLinearAlgebra run.
+  class SCISHARE ParallelPreconditioner : boost::noncopyable
+  {
+  public:
+    virtual ~ParallelPreconditioner();
+
+    /// Number of doubles of scratch space apply() needs per solve.
+    virtual size_t workspace_size() const { return 0; }
+
+    /// Bytes held by the setup, not counting the matrix itself. Used to
+    /// budget the solver cache.
+    virtual size_t memory_size() const = 0;
+
+    /// z = inv(M) * r. r and z may be the same vector; work must hold
+    /// workspace_size() values and be shared by all threads.
+    virtual void apply(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const = 0;
+
+    /// Whether M is symmetric, which CG and MINRES rely on.
+    virtual bool is_symmetric() const { return true; }
+
+    /// z = inv(M)' * r, needed by BiCG. The default is exact for symmetric
+    /// preconditioners.
+    virtual void apply_transpose(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const
+    {
+      apply(PLA, r, z, work);
+    }
+
+    /// Creates the preconditioner named by the SolveLinearSystem
+    /// Preconditioner option ("IC(0)", "ILU(0)" or "AMG"). Returns an empty
+    /// handle for the diagonal options that the solvers handle themselves.
+    static boost::shared_ptr<ParallelPreconditioner> create(const std::string& name,
+      Datatypes::SparseRowMatrixHandle A);
+    /// Whether create builds a preconditioner for name.
+    static bool exists(const std::string& name);
+    /// Whether the preconditioner create builds for name is symmetric.
+    static bool is_symmetric(const std::string& name);
+  };
+
+  typedef boost::shared_ptr<ParallelPreconditioner> ParallelPreconditionerHandle;
+
+  /// Triangular solve with level scheduling: rows whose dependencies are
+  /// all in earlier levels are solved in parallel, with one barrier per
+  /// level. Runs of small levels are done by the first thread only.
+  class SCISHARE LevelScheduledTriangularSolve
+  {
+  public:
+    /// Takes over CSR arrays of the strictly lower (or upper) part and the
+    /// inverse of the diagonal. The arrays are swapped in.
+    void assign(bool lower, std::vector<index_type>& rows,
+      std::vector<index_type>& columns, std::vector<double>& values,
+      std::vector<double>& invdiag);
+
+    /// Solves T z = r; r and z may be the same array.
+    void solve(ParallelLinearAlgebra& PLA, const double* r, double* z) const;
+
+    size_t size() const { return invdiag_.size(); }
+    size_t num_levels() const { return num_levels_; }
+    size_t memory_size() const;
+
+  private:
+    std::vector<index_type> rows_;
+    std::vector<index_type> columns_;
+    std::vector<double> values_;
+    std::vector<double> invdiag_;
+
+    /// rows ordered by level, and the start of each stage in that order
+    std::vector<index_type> order_;
+    std::vector<index_type> stages_;
+    std::vector<char> serial_;
+    size_t num_levels_ = 0;
+  };
+
+  /// Incomplete Cholesky factorization without fill, A ~ L*L', for
+  /// symmetric positive definite matrices. If the factorization breaks down
+  /// the diagonal is shifted until it does not.
+  class SCISHARE IncompleteCholeskyPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit IncompleteCholeskyPreconditioner(Datatypes::SparseRowMatrixHandle A);
+
+    virtual void apply(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const override;
+
+    virtual size_t memory_size() const override;
+
+    double shift() const { return shift_; }
+
+  private:
+    LevelScheduledTriangularSolve lower_;
+    LevelScheduledTriangularSolve upper_;
+    double shift_;
+  };
+
+  /// Incomplete LU factorization without fill, A ~ L*U with unit L. As
+  /// L*U is not symmetric, it only works with BiCG.
+  class SCISHARE IncompleteLUPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit IncompleteLUPreconditioner(Datatypes::SparseRowMatrixHandle A);
+
+    virtual bool is_symmetric() const override { return false; }
+
+    virtual void apply(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const override;
+
+    virtual void apply_transpose(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const override;
+
+    virtual size_t memory_size() const override;
+
+  private:
+    LevelScheduledTriangularSolve L_, U_;
+    LevelScheduledTriangularSolve Ut_, Lt_;
+  };
+
+  /// Smoothed aggregation algebraic multigrid, applied as one V-cycle with
+  /// damped Jacobi smoothing and an exact solve on the coarsest level. The
+  /// near null space is taken to be the constant vector, which suits the
+  /// scalar elliptic (Laplace type) systems the FEM modules produce.
+  class SCISHARE SmoothedAggregationAMGPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit SmoothedAggregationAMGPreconditioner(Datatypes::SparseRowMatrixHandle A);
+    ~SmoothedAggregationAMGPreconditioner();
+
+    virtual size_t workspace_size() const override;
+    virtual size_t memory_size() const override;
+
+    virtual void apply(ParallelLinearAlgebra& PLA,
+      const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z, double* work) const override;
+
+    size_t num_levels() const { return levels_.size(); }
+
+  private:
+    struct Level
+    {
+      Datatypes::SparseRowMatrixHandle A;
+      Datatypes::SparseRowMatrixHandle P;
+      Datatypes::SparseRowMatrixHandle R;
+      std::vector<double> invdiag;
+      double omega;
+      size_t size;
+    };
+    class CoarseSolver;
+
+    void smooth(ParallelLinearAlgebra& PLA, const Level& level, const double* b,
+      double* x, double* tmp, bool zero_guess) const;
+
+    std::vector<Level> levels_;
+    boost::shared_ptr<CoarseSolver> coarse_;
+    bool ownsFinestLevel_;
+  };
+
+}}}}
+
+#endif
@@ -28,11 +28,15 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+#include <typeinfo>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Math;
@@ -77,6 +81,80 @@ namespace
   private:
     SharedPointer<ColumnMatrixType> rhs_;
   };
+
+  template <class MatrixType>
+  size_t factorization_bytes(const Eigen::SimplicialLDLT<MatrixType>& f)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    const size_t n = f.rows();
+    return f.matrixL().nestedExpression().nonZeros() * (sizeof(Scalar) + sizeof(StorageIndex)) +
+      n * (sizeof(Scalar) + 3 * sizeof(StorageIndex));
+  }
+
+  template <class MatrixType, class OrderingType>
+  size_t factorization_bytes(const Eigen::SparseLU<MatrixType, OrderingType>& f)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    const size_t n = f.rows();
+    return (f.nnzL() + f.nnzU()) * (sizeof(Scalar) + sizeof(StorageIndex)) +
+      n * 6 * sizeof(StorageIndex);
+  }
+
+  /// Sparse direct solve. The factorization only depends on the matrix, so
+  /// it is kept in the LinearSolverCache and solving again with the same
+  /// matrix only costs the triangular solves.
+  template <class ColumnMatrixType, template <typename> class FactorizationType>
+  class SolveLinearSystemAlgorithmEigenDirectImpl
+  {
+  public:
+    SolveLinearSystemAlgorithmEigenDirectImpl(SharedPointer<ColumnMatrixType> rhs, double, int) :
+        tolerance_(0), maxIterations_(0), rhs_(rhs) {}
+
+    using SolutionType = ColumnMatrixType;
+
+    template <class MatrixType>
+    typename ColumnMatrixType::EigenBase solveWithEigen(const MatrixType&)
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmInputException()
+        << LinearAlgebraErrorMessage("Direct solvers need a sparse matrix"));
+    }
+
+    template <typename T>
+    typename ColumnMatrixType::EigenBase solveWithEigen(const SparseRowMatrixGeneric<T>& lhs)
+    {
+      typedef FactorizationType<Eigen::SparseMatrix<T>> Factorization;
+
+      auto& cache = LinearSolverCache::instance();
+      const auto key = LinearSolverCache::key(lhs);
+      const std::string name = std::string("eigen ") + typeid(Factorization).name();
+
+      auto factorization = cache.find<Factorization>(key, name);
+      if (!factorization)
+      {
+        factorization = boost::make_shared<Factorization>();
+        factorization->compute(Eigen::SparseMatrix<T>(lhs));
+
+        if (factorization->info() != Eigen::Success)
+          BOOST_THROW_EXCEPTION(AlgorithmInputException()
+            << LinearAlgebraErrorMessage("Eigen factorization was unsuccessful")
+            << EigenComputationInfo(factorization->info()));
+
+        cache.insert(key, name, factorization, factorization_bytes(*factorization));
+      }
+
+      typename ColumnMatrixType::EigenBase solution = factorization->solve(*rhs_);
+      const double bnorm = rhs_->norm();
+      tolerance_ = bnorm > 0 ? (*rhs_ - lhs * solution).norm() / bnorm : 0;
+      return solution;
+    }
+
+    double tolerance_;
+    int maxIterations_;
+  private:
+    SharedPointer<ColumnMatrixType> rhs_;
+  };
 }
 
 SolveLinearSystemAlgorithm::Outputs SolveLinearSystemAlgorithm::run(const Inputs& input, const Parameters& params) const
@@ -96,6 +174,10 @@ using CG = Eigen::ConjugateGradient<T>;
 // using LSCG = Eigen::LeastSquaresConjugateGradient<T>;
 template <typename T>
 using BiCG = Eigen::BiCGSTAB<T>;
+template <typename T>
+using Cholesky = Eigen::SimplicialLDLT<T>;
+template <typename T>
+using LU = Eigen::SparseLU<T>;
 
 template <typename In, typename Out>
 Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& params) const
@@ -117,11 +199,17 @@ Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& param
   using SolutionType = DenseColumnMatrixGeneric<typename std::tuple_element<0, In>::type::element_type::value_type>;
   using AlgoTypeCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, CG>;
   using AlgoTypeBiCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, BiCG>;
+  using AlgoTypeCholesky = SolveLinearSystemAlgorithmEigenDirectImpl<SolutionType, Cholesky>;
+  using AlgoTypeLU = SolveLinearSystemAlgorithmEigenDirectImpl<SolutionType, LU>;
 
   if ("cg" == method)
     return solve<AlgoTypeCG, In, Out>(input, params);
   else if ("bicg" == method)
     return solve<AlgoTypeBiCG, In, Out>(input, params);
+  else if ("cholesky" == method)
+    return solve<AlgoTypeCholesky, In, Out>(input, params);
+  else if ("lu" == method)
+    return solve<AlgoTypeLU, In, Out>(input, params);
   else
   {
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Need to upgrade Eigen for LSCG."));
@@ -0,0 +1,156 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/LinearSystem/LinearSolverCache.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+using namespace SCIRun::TestUtils;
+
+TEST(LinearSolverCacheTests, KeyChangesWithMatrixContents)
+{
+  auto A = tridiagonal(100, -1.0, 3.0, -1.0);
+  auto B = tridiagonal(100, -1.0, 3.0, -1.0);
+
+  auto key = LinearSolverCache::key(*A);
+  EXPECT_TRUE(key == LinearSolverCache::key(*A));
+  EXPECT_EQ(key.hash, LinearSolverCache::key(*B).hash);
+  EXPECT_FALSE(key == LinearSolverCache::key(*B));
+
+  A->coeffRef(50, 50) = 3.5;
+  EXPECT_FALSE(key == LinearSolverCache::key(*A));
+}
+
+TEST(LinearSolverCacheTests, DropsLeastRecentlyUsedEntriesOverBudget)
+{
+  LinearSolverCache cache(1000);
+  auto A = tridiagonal(10, -1.0, 3.0, -1.0);
+  auto B = tridiagonal(20, -1.0, 3.0, -1.0);
+  auto C = tridiagonal(30, -1.0, 3.0, -1.0);
+
+  cache.insert(LinearSolverCache::key(*A), "a", A, 400);
+  cache.insert(LinearSolverCache::key(*B), "b", B, 400);
+  EXPECT_EQ(A, cache.find<SparseRowMatrix>(LinearSolverCache::key(*A), "a"));
+  cache.insert(LinearSolverCache::key(*C), "c", C, 400);
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(800u, cache.memoryUsed());
+  EXPECT_EQ(A, cache.find<SparseRowMatrix>(LinearSolverCache::key(*A), "a"));
+  EXPECT_FALSE(cache.find<SparseRowMatrix>(LinearSolverCache::key(*B), "b"));
+  EXPECT_EQ(C, cache.find<SparseRowMatrix>(LinearSolverCache::key(*C), "c"));
+
+  cache.insert(LinearSolverCache::key(*B), "b", B, 2000);
+  EXPECT_FALSE(cache.find<SparseRowMatrix>(LinearSolverCache::key(*B), "b"));
+
+  cache.setMemoryBudget(0);
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.memoryUsed());
+}
+
+TEST(LinearSolverCacheTests, ChangedMatrixReplacesOldEntries)
+{
+  LinearSolverCache cache;
+  auto A = tridiagonal(10, -1.0, 3.0, -1.0);
+  auto oldKey = LinearSolverCache::key(*A);
+  cache.insert(oldKey, "a", A, 100);
+  cache.insert(oldKey, "b", A, 100);
+
+  A->coeffRef(0, 0) = 4.0;
+  auto newKey = LinearSolverCache::key(*A);
+  EXPECT_FALSE(cache.find<SparseRowMatrix>(newKey, "a"));
+
+  cache.insert(newKey, "a", A, 100);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_FALSE(cache.find<SparseRowMatrix>(oldKey, "b"));
+}
+
+TEST(LinearSolverCacheTests, SolveLinearSystemReusesPreconditionerAndSolution)
+{
+  LinearSolverCache::instance().clear();
+  auto A = laplacian(40);
+  auto b = sampleRhs(1600, 1);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.setOption(Variables::Preconditioner, "IC(0)");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.set(Variables::MaxIterations, 500);
+  algo.set(Parameters::WarmStart, true);
+  algo.setUpdaterFunc([](double) {});
+
+  DenseColumnMatrixHandle x;
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+  EXPECT_LT(relativeResidual(*A, *x, *b), 1e-10);
+
+  auto key = LinearSolverCache::key(*A);
+  auto M = LinearSolverCache::instance().find<ParallelPreconditioner>(key, "preconditioner IC(0)");
+  ASSERT_TRUE(M != nullptr);
+  EXPECT_GT(M->memory_size(), 0u);
+  EXPECT_EQ(x, LinearSolverCache::instance().find<DenseColumnMatrix>(key, "solution"));
+
+  // nothing left to iterate when starting from the last solution
+  algo.set(Variables::MaxIterations, 1);
+  DenseColumnMatrixHandle again;
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), again));
+  EXPECT_LT(relativeResidual(*A, *again, *b), 1e-10);
+  EXPECT_EQ(M, LinearSolverCache::instance().find<ParallelPreconditioner>(key, "preconditioner IC(0)"));
+}
+
+TEST(LinearSolverCacheTests, EigenDirectSolversKeepFactorization)
+{
+  LinearSolverCache::instance().clear();
+  auto spd = tridiagonal(500, -1.0, 2.5, -1.0);
+  auto nonsymmetric = tridiagonal(500, -1.5, 3.0, -0.5);
+
+  SolveLinearSystemAlgorithm algo;
+  const char* methods[] = { "cholesky", "lu" };
+  for (auto method : methods)
+  {
+    auto A = std::string(method) == "lu" ? nonsymmetric : spd;
+    for (int seed = 0; seed < 3; ++seed)
+    {
+      auto b = sampleRhs(500, seed);
+      auto result = algo.run(std::make_tuple(MatrixHandle(A), b), std::make_tuple(1e-10, 10, std::string(method)));
+      auto x = std::get<0>(result);
+      ASSERT_TRUE(x != nullptr);
+      EXPECT_LT(relativeResidual(*A, *x, *b), 1e-12) << method;
+      EXPECT_LT(std::get<1>(result), 1e-12);
+    }
+  }
+  EXPECT_EQ(2u, LinearSolverCache::instance().size());
+}
@@ -976,3 +976,55 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByMultiVectorMulti)
+{
+  auto mat1 = matrix1();
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vec3 = vector3();
+  auto block = boost::make_shared<DenseMatrix>(size, 3);
+  block->col(0) = *vec1;
+  block->col(1) = *vec2;
+  block->col(2) = *vec3;
+  auto result = boost::make_shared<DenseMatrix>(size, 3);
+
+  SolverInputs system;
+  system.A = mat1;
+  system.B = block;
+  system.X = result;
+  ParallelLinearAlgebraSharedData data(system, 2);
+
+  std::vector<double> dots(3), norms(3);
+  auto task = [&](int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    ParallelLinearAlgebra::ParallelMatrix m;
+    ParallelLinearAlgebra::ParallelMultiVector b, r;
+    pla.add_matrix(mat1, m);
+    pla.add_multi_vector(block, b);
+    pla.add_multi_vector(result, r);
+    pla.mult(m, b, r);
+    std::vector<double> d(3), n(3);
+    pla.dot(b, r, &d[0]);
+    pla.norm(r, &n[0]);
+    if (proc == 0)
+    {
+      dots = d;
+      norms = n;
+    }
+  };
+  boost::thread t1(task, 0);
+  boost::thread t2(task, 1);
+  t1.join();
+  t2.join();
+
+  for (int j = 0; j < 3; ++j)
+  {
+    DenseColumnMatrix expected = *mat1 * DenseColumnMatrix(block->col(j));
+    for (int i = 0; i < size; ++i)
+      EXPECT_EQ(expected[i], (*result)(i, j));
+    EXPECT_DOUBLE_EQ(expected.dot(block->col(j)), dots[j]);
+    EXPECT_DOUBLE_EQ(expected.norm(), norms[j]);
+  }
+}
@@ -0,0 +1,218 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  double solve(const std::string& method, const std::string& preconditioner, SparseRowMatrixHandle A,
+    DenseColumnMatrixHandle b, int maxIterations)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return relativeResidual(*A, *x, *b);
+  }
+
+  // Applies a preconditioner once with the given number of threads
+  class ApplyPreconditioner : public ParallelLinearAlgebraBase
+  {
+  public:
+    explicit ApplyPreconditioner(ParallelPreconditionerHandle M) : M_(M) {}
+
+    DenseColumnMatrixHandle run(SparseRowMatrixHandle A, DenseColumnMatrixHandle r, int nproc) const
+    {
+      SolverInputs matrices;
+      matrices.A = A;
+      matrices.b = r;
+      matrices.x0 = r;
+      matrices.x = boost::make_shared<DenseColumnMatrix>(r->nrows());
+      EXPECT_TRUE(start_parallel(matrices, nproc));
+      return matrices.x;
+    }
+
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override
+    {
+      ParallelLinearAlgebra::ParallelVector R, Z, WORK;
+      if (!PLA.add_vector(matrices.b, R) || !PLA.add_vector(matrices.x, Z) ||
+          !PLA.new_buffer(M_->workspace_size(), WORK))
+        return false;
+      M_->apply(PLA, R, Z, WORK.data_);
+      return true;
+    }
+
+  private:
+    ParallelPreconditionerHandle M_;
+  };
+}
+
+TEST(ParallelPreconditionersTests, IncompleteFactorizationsAreExactWithoutFill)
+{
+  auto spd = tridiagonal(500, -1.0, 2.5, -1.0);
+  auto b = sampleRhs(500, 1);
+  EXPECT_LT(solve("cg", "IC(0)", spd, b, 2), 1e-12);
+
+  auto nonsymmetric = tridiagonal(500, -1.5, 3.0, -0.5);
+  EXPECT_LT(solve("bicg", "ILU(0)", nonsymmetric, b, 2), 1e-12);
+}
+
+TEST(ParallelPreconditionersTests, PreconditionersReduceCGIterations)
+{
+  auto A = laplacian(60);
+  auto b = sampleRhs(3600, 2);
+
+  const int iterations = 25;
+  double jacobi = solve("cg", "Jacobi", A, b, iterations);
+  double ic = solve("cg", "IC(0)", A, b, iterations);
+  double amg = solve("cg", "AMG", A, b, iterations);
+
+  EXPECT_GT(jacobi, 1e-3);
+  EXPECT_LT(ic, jacobi / 10);
+  EXPECT_LT(amg, 1e-8);
+
+  EXPECT_LT(solve("minres", "IC(0)", A, b, iterations), solve("minres", "Jacobi", A, b, iterations) / 10);
+  EXPECT_LT(solve("bicg", "ILU(0)", A, b, iterations), solve("bicg", "Jacobi", A, b, iterations) / 10);
+  EXPECT_LT(solve("bicg", "AMG", A, b, iterations), 1e-8);
+}
+
+TEST(ParallelPreconditionersTests, SymmetricSolversRejectILU)
+{
+  auto A = laplacian(20);
+  auto b = sampleRhs(400, 5);
+  auto B = boost::make_shared<DenseMatrix>(400, 2);
+  B->setOnes();
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Preconditioner, "ILU(0)");
+  algo.setUpdaterFunc([](double) {});
+
+  const char* methods[] = { "cg", "minres" };
+  for (auto method : methods)
+  {
+    algo.setOption(Variables::Method, method);
+    DenseColumnMatrixHandle x;
+    EXPECT_THROW(algo.run(A, b, DenseColumnMatrixHandle(), x), AlgorithmInputException) << method;
+    DenseMatrixHandle X;
+    EXPECT_THROW(algo.run(A, B, DenseMatrixHandle(), X), AlgorithmInputException) << method;
+
+    // also when the preconditioner is built up front
+    DenseColumnMatrixHandle convergence;
+    auto M = ParallelPreconditioner::create("ILU(0)", A);
+    algo.setOption(Variables::Preconditioner, "Jacobi");
+    EXPECT_THROW(algo.run(A, b, DenseColumnMatrixHandle(), x, convergence, M), AlgorithmInputException) << method;
+    algo.setOption(Variables::Preconditioner, "ILU(0)");
+  }
+}
+
+TEST(ParallelPreconditionersTests, AMGBuildsCoarseLevels)
+{
+  auto A = laplacian(60);
+  SmoothedAggregationAMGPreconditioner amg(A);
+  EXPECT_GE(amg.num_levels(), 2u);
+}
+
+TEST(ParallelPreconditionersTests, PreconditionerCanBeReusedAcrossSolves)
+{
+  auto A = laplacian(40);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.setOption(Variables::Preconditioner, "AMG");
+  algo.set(Variables::TargetError, 1e-9);
+  algo.set(Variables::MaxIterations, 50);
+  algo.setUpdaterFunc([](double) {});
+
+  auto M = algo.buildPreconditioner(A);
+  ASSERT_TRUE(M != nullptr);
+
+  for (int seed = 0; seed < 3; ++seed)
+  {
+    auto b = sampleRhs(1600, seed);
+    DenseColumnMatrixHandle x, convergence;
+    ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x, convergence, M));
+    EXPECT_LT(relativeResidual(*A, *x, *b), 1e-8);
+  }
+}
+
+TEST(ParallelPreconditionersTests, ApplyGivesSameResultOnAnyNumberOfThreads)
+{
+  auto A = laplacian(50);
+  auto r = sampleRhs(2500, 3);
+
+  const char* names[] = { "IC(0)", "ILU(0)", "AMG" };
+  for (auto name : names)
+  {
+    ApplyPreconditioner apply(ParallelPreconditioner::create(name, A));
+    auto z1 = apply.run(A, r, 1);
+    auto z4 = apply.run(A, r, 4);
+    for (int i = 0; i < 2500; ++i)
+      ASSERT_EQ((*z1)[i], (*z4)[i]) << name << " differs at row " << i;
+  }
+}
+
+TEST(ParallelPreconditionersTests, SetupDoesNotCompressTheInputMatrix)
+{
+  auto A = laplacian(50);
+  auto r = sampleRhs(2500, 4);
+
+  const char* names[] = { "IC(0)", "ILU(0)", "AMG" };
+  for (auto name : names)
+  {
+    auto uncompressed = boost::make_shared<SparseRowMatrix>(*A);
+    uncompressed->uncompress();
+    ApplyPreconditioner fromUncompressed(ParallelPreconditioner::create(name, uncompressed));
+    EXPECT_FALSE(uncompressed->isCompressed()) << name;
+
+    ApplyPreconditioner fromCompressed(ParallelPreconditioner::create(name, A));
+    auto z1 = fromUncompressed.run(A, r, 1);
+    auto z2 = fromCompressed.run(A, r, 1);
+    for (int i = 0; i < 2500; ++i)
+      ASSERT_EQ((*z1)[i], (*z2)[i]) << name << " differs at row " << i;
+  }
+}
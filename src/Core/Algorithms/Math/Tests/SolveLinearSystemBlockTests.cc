@@ -0,0 +1,177 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Columns with different right-hand sides; the third one is all zeros
+  DenseMatrixHandle rhsBlock(int n)
+  {
+    auto B = boost::make_shared<DenseMatrix>(n, 4);
+    for (int i = 0; i < n; ++i)
+    {
+      (*B)(i, 0) = 1.0;
+      (*B)(i, 1) = 1.0 + ((i * 37) % 11) / 10.0;
+      (*B)(i, 2) = 0.0;
+      (*B)(i, 3) = (i % 2) ? -1.0 : 2.0;
+    }
+    return B;
+  }
+
+  void expectSolved(const SparseRowMatrix& A, const DenseMatrix& X, const DenseMatrix& B, double tolerance)
+  {
+    ASSERT_EQ(B.nrows(), X.nrows());
+    ASSERT_EQ(B.ncols(), X.ncols());
+    DenseMatrix residual = B - A * X;
+    for (int j = 0; j < B.ncols(); ++j)
+    {
+      if (B.col(j).norm() == 0)
+        EXPECT_EQ(0.0, X.col(j).norm());
+      else
+        EXPECT_LT(residual.col(j).norm() / B.col(j).norm(), tolerance) << "column " << j;
+    }
+  }
+
+  DenseMatrixHandle solveBlock(const std::string& method, const std::string& preconditioner,
+    SparseRowMatrixHandle A, DenseMatrixHandle B, DenseMatrixHandle X0 = DenseMatrixHandle())
+  {
+    SolveLinearSystemAlgo algo;
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.set(Variables::MaxIterations, 2000);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseMatrixHandle X;
+    EXPECT_TRUE(algo.run(A, B, X0, X));
+    return X;
+  }
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGSolvesEveryColumn)
+{
+  auto A = laplacian(30);
+  auto B = rhsBlock(900);
+  expectSolved(*A, *solveBlock("cg", "Jacobi", A, B), *B, 1e-8);
+  expectSolved(*A, *solveBlock("cg", "IC(0)", A, B), *B, 1e-8);
+  expectSolved(*A, *solveBlock("cg", "AMG", A, B), *B, 1e-8);
+}
+
+TEST(SolveLinearSystemBlockTests, BlockMINRESSolvesEveryColumn)
+{
+  auto A = laplacian(30);
+  auto B = rhsBlock(900);
+  expectSolved(*A, *solveBlock("minres", "Jacobi", A, B), *B, 1e-8);
+  expectSolved(*A, *solveBlock("minres", "AMG", A, B), *B, 1e-8);
+}
+
+TEST(SolveLinearSystemBlockTests, OtherMethodsSolveColumnByColumn)
+{
+  auto A = laplacian(20);
+  auto B = rhsBlock(400);
+  expectSolved(*A, *solveBlock("bicg", "Jacobi", A, B), *B, 1e-8);
+}
+
+TEST(SolveLinearSystemBlockTests, BlockSolveStartsFromInitialGuess)
+{
+  auto A = laplacian(30);
+  auto B = rhsBlock(900);
+  auto X = solveBlock("cg", "Jacobi", A, B);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.set(Variables::MaxIterations, 1);
+  algo.setUpdaterFunc([](double) {});
+
+  DenseMatrixHandle X1;
+  ASSERT_TRUE(algo.run(A, B, X, X1));
+  expectSolved(*A, *X1, *B, 1e-8);
+}
+
+TEST(SolveLinearSystemBlockTests, RejectsMismatchedBlock)
+{
+  auto A = laplacian(10);
+  auto B = boost::make_shared<DenseMatrix>(50, 2);
+  B->setOnes();
+
+  SolveLinearSystemAlgo algo;
+  DenseMatrixHandle X;
+  EXPECT_THROW(algo.run(A, B, DenseMatrixHandle(), X), AlgorithmInputException);
+}
+
+TEST(SolveLinearSystemBlockTests, EmptyBlockGivesEmptySolution)
+{
+  auto A = laplacian(10);
+  auto B = boost::make_shared<DenseMatrix>(100, 0);
+
+  const char* methods[] = { "cg", "minres", "bicg" };
+  for (auto method : methods)
+  {
+    auto X = solveBlock(method, "Jacobi", A, B);
+    ASSERT_TRUE(X != nullptr) << method;
+    EXPECT_EQ(100, X->nrows());
+    EXPECT_EQ(0, X->ncols());
+  }
+}
+
+TEST(SolveLinearSystemBlockTests, WarmStartReusesLastBlockSolution)
+{
+  auto A = laplacian(30);
+  auto B = rhsBlock(900);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.set(Variables::MaxIterations, 2000);
+  algo.set(Parameters::WarmStart, true);
+  algo.setUpdaterFunc([](double) {});
+
+  DenseMatrixHandle X;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X));
+
+  // a second solve without X0 only converges in one iteration from the last solution
+  algo.set(Variables::MaxIterations, 1);
+  DenseMatrixHandle X1;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X1));
+  expectSolved(*A, *X1, *B, 1e-8);
+}
@@ -38,6 +38,7 @@
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Core/Command/GlobalCommandBuilderFromCommandLine.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionTrace.h>
 #include <Core/Logging/ApplicationHelper.h>
 #include <Core/IEPlugin/IEPluginInit.h>
 #include <Core/Utils/Exception.h>
@@ -49,6 +50,7 @@
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <boost/algorithm/string.hpp>
 #include <Core/Thread/Parallel.h>
+#include <Dataflow/Network/PortDataCache.h>
 
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Logging;
@@ -98,6 +100,7 @@ void Application::shutdown()
 {
   if (!private_)
     logInfo("Application shutdown called with null internals");
+  writeExecutionTrace();
   try
   {
     private_.reset();
@@ -160,10 +163,31 @@ void Application::readCommandLine(int argc, const char* argv[])
     if (maxCoresOption)
       Thread::Parallel::SetMaximumCores(*maxCoresOption);
 
+    auto portCacheOption = private_->parameters_->developerParameters()->portCacheBudgetMB();
+    if (portCacheOption)
+      PortDataCache::instance().setMemoryBudget(size_t(*portCacheOption) << 20);
+
     LogSettings::Instance().setVerbose(parameters()->verboseMode());
+
+    if (parameters()->traceFile())
+      ExecutionTracer::Instance().setEnabled(true);
   }
 }
 
+void Application::writeExecutionTrace() const
+{
+  if (!private_ || !private_->parameters_)
+    return;
+  auto traceFile = private_->parameters_->traceFile();
+  if (!traceFile)
+    return;
+
+  if (ExecutionTracer::Instance().writeChromeTrace(*traceFile))
+    logInfo("Execution trace written to {}", traceFile->string());
+  else
+    logError("Could not write execution trace to {}", traceFile->string());
+}
+
 namespace
 {
 #ifdef BUILD_WITH_PYTHON
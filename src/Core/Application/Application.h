@@ -84,6 +84,9 @@ public:
   std::string moduleList();
   bool moduleNameExists(const std::string& name);
 
+  /// Writes the execution trace to the file given with --trace, if any.
+  void writeExecutionTrace() const;
+
   void shutdown();
 
   /// @todo: following will be useful later
@@ -34,6 +34,7 @@
 
 #include <float.h>
 
+#include <Core/GeometryPrimitives/PointF.h>
 #include <Core/Basis/CrvLinearLgn.h>
 #include <Core/Basis/QuadBilinearLgn.h>
 #include <Core/Basis/HexElementWeights.h>
@@ -541,6 +542,41 @@ const TypeDescription*
                        HEX_TRILINEAR_LGN_VERSION);
     stream.end_class();
   }
+
+namespace Core {
+namespace Basis {
+
+/// Trilinear hexahedral basis for meshes that store their nodes as PointF. Node values
+/// are converted on access, so interpolation and locate still run in double
+/// precision; only the type name differs from the Point basis.
+template <>
+class HexTrilinearLgn<Geometry::PointF> : public HexTrilinearLgn<Geometry::Point>
+{
+public:
+  static const std::string type_name(int n = -1)
+  {
+    ASSERT((n >= -1) && n <= 1);
+    if (n == -1)
+    {
+      static const std::string name = TypeNameGenerator::make_template_id(type_name(0), type_name(1));
+      return name;
+    }
+    else if (n == 0)
+    {
+      static const std::string nm("HexTrilinearLgn");
+      return nm;
+    }
+    return find_type_name(static_cast<Geometry::PointF*>(0));
+  }
+
+  virtual void io(Piostream& stream) override
+  {
+    stream.begin_class(get_type_description(this)->get_name(), HEX_TRILINEAR_LGN_VERSION);
+    stream.end_class();
+  }
+};
+
+}}
 }
 
 #endif
@@ -35,6 +35,7 @@
 
 #include <Core/Basis/TetElementWeights.h>
 #include <Core/Basis/TetSamplingSchemes.h>
+#include <Core/GeometryPrimitives/PointF.h>
 #include <Core/Basis/TriLinearLgn.h>
 #include <Core/Basis/share.h>
 
@@ -518,6 +519,41 @@ void
     TETLINEARLGN_VERSION);
   stream.end_class();
 }
+
+namespace Core {
+namespace Basis {
+
+/// Linear tet basis for meshes that store their nodes as PointF. Node values
+/// are converted on access, so interpolation and locate still run in double
+/// precision; only the type name differs from the Point basis.
+template <>
+class TetLinearLgn<Geometry::PointF> : public TetLinearLgn<Geometry::Point>
+{
+public:
+  static const std::string type_name(int n = -1)
+  {
+    ASSERT((n >= -1) && n <= 1);
+    if (n == -1)
+    {
+      static const std::string name = TypeNameGenerator::make_template_id(type_name(0), type_name(1));
+      return name;
+    }
+    else if (n == 0)
+    {
+      static const std::string nm("TetLinearLgn");
+      return nm;
+    }
+    return find_type_name(static_cast<Geometry::PointF*>(0));
+  }
+
+  virtual void io(Piostream& stream) override
+  {
+    stream.begin_class(get_type_description(this)->get_name(), TETLINEARLGN_VERSION);
+    stream.end_class();
+  }
+};
+
+}}
 }
 
 #endif
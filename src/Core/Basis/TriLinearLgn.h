@@ -34,6 +34,7 @@
 
 #include <float.h>
 
+#include <Core/GeometryPrimitives/PointF.h>
 #include <Core/Basis/CrvLinearLgn.h>
 #include <Core/Basis/TriElementWeights.h>
 #include <Core/Basis/TriSamplingSchemes.h>
@@ -520,6 +521,41 @@ const TypeDescription* get_type_description(Core::Basis::TriLinearLgn<T> *)
                        TRILINEARLGN_VERSION);
     stream.end_class();
   }
+
+namespace Core {
+namespace Basis {
+
+/// Linear triangle basis for meshes that store their nodes as PointF. Node values
+/// are converted on access, so interpolation and locate still run in double
+/// precision; only the type name differs from the Point basis.
+template <>
+class TriLinearLgn<Geometry::PointF> : public TriLinearLgn<Geometry::Point>
+{
+public:
+  static const std::string type_name(int n = -1)
+  {
+    ASSERT((n >= -1) && n <= 1);
+    if (n == -1)
+    {
+      static const std::string name = TypeNameGenerator::make_template_id(type_name(0), type_name(1));
+      return name;
+    }
+    else if (n == 0)
+    {
+      static const std::string nm("TriLinearLgn");
+      return nm;
+    }
+    return find_type_name(static_cast<Geometry::PointF*>(0));
+  }
+
+  virtual void io(Piostream& stream) override
+  {
+    stream.begin_class(get_type_description(this)->get_name(), TRILINEARLGN_VERSION);
+    stream.end_class();
+  }
+};
+
+}}
 }
 
 #endif
@@ -69,6 +69,8 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("port-cache-mb", po::value<unsigned int>(), "Memory budget in MB for cached port data")
+      ("trace", po::value<std::string>(), "write a Chrome trace-event JSON file on exit")
       ("list-modules", "print list of available modules")
       ;
 
@@ -118,9 +120,11 @@ public:
     const boost::optional<int>& frameInitLimit,
     const boost::optional<int>& regressionTimeout,
     const boost::optional<unsigned int>& maxCores,
-    const boost::optional<double>& guiExpandFactor
+    const boost::optional<double>& guiExpandFactor,
+    const boost::optional<unsigned int>& portCacheBudgetMB
     ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor),
+    portCacheBudgetMB_(portCacheBudgetMB)
   {}
   boost::optional<int> regressionTimeoutSeconds() const override
   {
@@ -146,11 +150,16 @@ public:
   {
     return guiExpandFactor_;
   }
+  boost::optional<unsigned int> portCacheBudgetMB() const override
+  {
+    return portCacheBudgetMB_;
+  }
 private:
   boost::optional<std::string> threadMode_, reexecuteMode_;
   boost::optional<int> frameInitLimit_, regressionTimeout_;
   boost::optional<unsigned int> maxCores_;
   boost::optional<double> guiExpandFactor_;
+  boost::optional<unsigned int> portCacheBudgetMB_;
 };
 
 class ApplicationParametersImpl : public ApplicationParameters
@@ -189,11 +198,12 @@ public:
     const boost::optional<boost::filesystem::path>& pythonScriptFile,
     const boost::optional<boost::filesystem::path>& dataDirectory,
     const boost::optional<std::string>& networkToImport,
+    const boost::optional<boost::filesystem::path>& traceFile,
     DeveloperParametersPtr devParams,
     const Flags& flags
    ) : entireCommandLine_(entireCommandLine),
     inputFiles_(inputFiles), pythonScriptFile_(pythonScriptFile), dataDirectory_(dataDirectory),
-    networkToImport_(networkToImport),
+    networkToImport_(networkToImport), traceFile_(traceFile),
     devParams_(devParams),
     flags_(flags)
   {}
@@ -218,6 +228,11 @@ public:
     return networkToImport_;
   }
 
+  boost::optional<boost::filesystem::path> traceFile() const override
+  {
+    return traceFile_;
+  }
+
   bool help() const override
   {
     return flags_.help_;
@@ -294,6 +309,7 @@ private:
   boost::optional<boost::filesystem::path> pythonScriptFile_;
   boost::optional<boost::filesystem::path> dataDirectory_;
   boost::optional<std::string> networkToImport_;
+  boost::optional<boost::filesystem::path> traceFile_;
   DeveloperParametersPtr devParams_;
   Flags flags_;
 };
@@ -344,6 +360,11 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
     {
       importNetworkFile = parsed["import"].as<std::string>();
     }
+    auto traceFile = boost::optional<boost::filesystem::path>();
+    if (parsed.count("trace") != 0 && !parsed["trace"].empty() && !parsed["trace"].defaulted())
+    {
+      traceFile = boost::filesystem::path(parsed["trace"].as<std::string>());
+    }
 
     return boost::make_shared<ApplicationParametersImpl>
       (boost::algorithm::join(cmdline, " "),
@@ -351,13 +372,15 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
       pythonScriptFile,
       dataDirectory,
       importNetworkFile,
+      traceFile,
       boost::make_shared<DeveloperParametersImpl>(
         parseOptionalArg<std::string>(parsed, "threadMode"),
         parseOptionalArg<std::string>(parsed, "reexecuteMode"),
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
-        parseOptionalArg<double>(parsed, "guiExpandFactor")
+        parseOptionalArg<double>(parsed, "guiExpandFactor"),
+        parseOptionalArg<unsigned int>(parsed, "port-cache-mb")
       ),
       ApplicationParametersImpl::Flags(
         parsed.count("help") != 0,
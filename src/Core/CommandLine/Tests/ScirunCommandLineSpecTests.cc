@@ -58,6 +58,8 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --port-cache-mb arg     Memory budget in MB for cached port data\n"
+    "  --trace arg             write a Chrome trace-event JSON file on exit\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
@@ -139,6 +141,28 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     EXPECT_EQ("net.srn5", aph->inputFiles()[0]);
   }
 
+  {
+    const char* argv[] = {"scirun.exe", "-E", "net.srn5", "--trace", "net.json"};
+    int argc = sizeof(argv)/sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    EXPECT_TRUE(aph->executeNetworkAndQuit());
+    ASSERT_TRUE(!!aph->traceFile());
+    EXPECT_EQ("net.json", aph->traceFile()->string());
+    EXPECT_EQ("net.srn5", aph->inputFiles()[0]);
+  }
+
+  {
+    const char* argv[] = {"scirun.exe", "--port-cache-mb", "256"};
+    int argc = sizeof(argv)/sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->developerParameters()->portCacheBudgetMB());
+    EXPECT_EQ(256u, *aph->developerParameters()->portCacheBudgetMB());
+  }
+
   // {
   //   const char* argv[] = {"scirun.exe", "--threadMode", "serial"};
   //   int argc = sizeof(argv)/sizeof(char*);
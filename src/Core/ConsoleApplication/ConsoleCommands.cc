@@ -132,6 +132,7 @@ bool QuitAfterExecuteCommandConsole::execute()
   Application::Instance().controller()->connectNetworkExecutionFinished([](int code)
   {
     LOG_CONSOLE("Goodbye! Exit code: " << code);
+    Application::Instance().writeExecutionTrace();
     exit(code);
   });
   return true;
@@ -145,6 +146,7 @@ QuitCommandConsole::QuitCommandConsole()
 bool QuitCommandConsole::execute()
 {
   LOG_CONSOLE("Goodbye!");
+  Application::Instance().writeExecutionTrace();
   exit(0);
   return true;
 }
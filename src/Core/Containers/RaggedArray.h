@@ -0,0 +1,200 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+///
+///@file   RaggedArray.h
+///@brief  Compressed row storage for variable length adjacency lists.
+///
+
+#ifndef CORE_CONTAINERS_RAGGEDARRAY_H
+#define CORE_CONTAINERS_RAGGEDARRAY_H 1
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace SCIRun {
+
+/// A RaggedArray stores a list of rows of varying length in one flat value
+/// array (compressed sparse row layout). It replaces
+/// std::vector<std::vector<T> > for mesh adjacency tables, where the per-row
+/// heap allocation dominates both build time and memory use.
+///
+/// Rows are normally filled in bulk with assign(). Rows can still be edited
+/// afterwards: a row that outgrows its slot is moved to the end of the value
+/// array with room to grow, so push_back() is amortized constant time.
+template <class T, class INDEX = size_t>
+class RaggedArray
+{
+public:
+  typedef T value_type;
+  typedef INDEX index_type;
+
+  /// Read-only view of one row.
+  class const_row
+  {
+  public:
+    typedef const T* const_iterator;
+    typedef T value_type;
+
+    const_row() : begin_(0), end_(0) {}
+    const_row(const T* b, const T* e) : begin_(b), end_(e) {}
+
+    const_iterator begin() const { return begin_; }
+    const_iterator end() const { return end_; }
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    const T& operator[](size_t i) const { return begin_[i]; }
+
+  private:
+    const T* begin_;
+    const T* end_;
+  };
+
+  RaggedArray() {}
+
+  /// Number of rows.
+  size_t size() const { return start_.size(); }
+  bool empty() const { return start_.empty(); }
+
+  /// Total number of stored values over all rows.
+  size_t num_values() const { return num_values_; }
+
+  void clear()
+  {
+    std::vector<T>().swap(values_);
+    std::vector<INDEX>().swap(start_);
+    std::vector<INDEX>().swap(size_);
+    std::vector<INDEX>().swap(capacity_);
+    num_values_ = 0;
+  }
+
+  /// Changes the number of rows; new rows are empty.
+  void resize(size_t rows)
+  {
+    for (size_t r = rows; r < start_.size(); ++r) num_values_ -= size_[r];
+    start_.resize(rows, static_cast<INDEX>(values_.size()));
+    size_.resize(rows, 0);
+    capacity_.resize(rows, 0);
+  }
+
+  /// Takes over rows described by CSR offsets (rows + 1 entries) and the
+  /// matching values. Both vectors are swapped in and left empty.
+  void assign(std::vector<INDEX>& offsets, std::vector<T>& values)
+  {
+    const size_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+    values_.swap(values);
+    std::vector<T>().swap(values);
+    start_.swap(offsets);
+    std::vector<INDEX>().swap(offsets);
+    start_.resize(rows);
+    size_.resize(rows);
+    capacity_.resize(rows);
+    for (size_t r = 0; r < rows; ++r)
+    {
+      const INDEX end = (r + 1 < rows) ? start_[r + 1] : static_cast<INDEX>(values_.size());
+      size_[r] = capacity_[r] = end - start_[r];
+    }
+    num_values_ = values_.size();
+  }
+
+  const_row operator[](size_t row) const
+  {
+    const T* b = values_.empty() ? 0 : &values_[0] + start_[row];
+    return const_row(b, b + size_[row]);
+  }
+
+  size_t row_size(size_t row) const { return static_cast<size_t>(size_[row]); }
+
+  T& at(size_t row, size_t i) { return values_[start_[row] + i]; }
+  const T& at(size_t row, size_t i) const { return values_[start_[row] + i]; }
+
+  /// Appends a value to a row.
+  void push_back(size_t row, const T& v)
+  {
+    if (size_[row] == capacity_[row])
+    {
+      const INDEX cap = capacity_[row] < 2 ? 4 : 2 * capacity_[row];
+      const INDEX start = static_cast<INDEX>(values_.size());
+      values_.resize(values_.size() + cap);
+      std::copy(values_.begin() + start_[row],
+                values_.begin() + start_[row] + size_[row],
+                values_.begin() + start);
+      start_[row] = start;
+      capacity_[row] = cap;
+    }
+    values_[start_[row] + size_[row]] = v;
+    ++size_[row];
+    ++num_values_;
+  }
+
+  /// Removes the first occurrence of a value from a row, keeping the order
+  /// of the remaining values. Returns false if the value was not found.
+  bool erase(size_t row, const T& v)
+  {
+    typename std::vector<T>::iterator b = values_.begin() + start_[row];
+    typename std::vector<T>::iterator e = b + size_[row];
+    typename std::vector<T>::iterator it = std::find(b, e, v);
+    if (it == e) return (false);
+    std::copy(it + 1, e, it);
+    --size_[row];
+    --num_values_;
+    return (true);
+  }
+
+  /// Removes every value of a row for which pred returns true and returns
+  /// the number of values removed.
+  template <class PRED>
+  size_t erase_if(size_t row, PRED pred)
+  {
+    typename std::vector<T>::iterator b = values_.begin() + start_[row];
+    typename std::vector<T>::iterator e = b + size_[row];
+    const size_t removed = static_cast<size_t>(e - std::remove_if(b, e, pred));
+    size_[row] -= static_cast<INDEX>(removed);
+    num_values_ -= removed;
+    return (removed);
+  }
+
+  /// Removes all values from a row.
+  void clear_row(size_t row)
+  {
+    num_values_ -= size_[row];
+    size_[row] = 0;
+  }
+
+private:
+  std::vector<T>     values_;
+  std::vector<INDEX> start_;
+  std::vector<INDEX> size_;
+  std::vector<INDEX> capacity_;
+  size_t             num_values_ = 0;
+};
+
+} // End namespace SCIRun
+
+#endif
@@ -0,0 +1,97 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Containers/RaggedArray.h>
+
+using namespace SCIRun;
+
+namespace
+{
+  std::vector<int> row(const RaggedArray<int>& a, size_t r)
+  {
+    RaggedArray<int>::const_row v = a[r];
+    return std::vector<int>(v.begin(), v.end());
+  }
+}
+
+TEST(RaggedArrayTest, AssignTakesOverCompressedRows)
+{
+  std::vector<size_t> offsets = { 0, 2, 2, 5 };
+  std::vector<int> values = { 1, 2, 3, 4, 5 };
+  RaggedArray<int> a;
+  a.assign(offsets, values);
+
+  EXPECT_TRUE(offsets.empty());
+  EXPECT_TRUE(values.empty());
+  ASSERT_EQ(3u, a.size());
+  EXPECT_EQ(5u, a.num_values());
+  EXPECT_EQ(std::vector<int>({ 1, 2 }), row(a, 0));
+  EXPECT_TRUE(a[1].empty());
+  EXPECT_EQ(std::vector<int>({ 3, 4, 5 }), row(a, 2));
+  EXPECT_EQ(4, a.at(2, 1));
+}
+
+TEST(RaggedArrayTest, RowsGrowWithoutDisturbingNeighbors)
+{
+  std::vector<size_t> offsets = { 0, 1, 2 };
+  std::vector<int> values = { 10, 20 };
+  RaggedArray<int> a;
+  a.assign(offsets, values);
+
+  for (int i = 0; i < 10; ++i)
+    a.push_back(0, i);
+  a.resize(3);
+  a.push_back(2, 30);
+
+  EXPECT_EQ(11u, a.row_size(0));
+  EXPECT_EQ(10, a.at(0, 0));
+  EXPECT_EQ(9, a.at(0, 10));
+  EXPECT_EQ(std::vector<int>({ 20 }), row(a, 1));
+  EXPECT_EQ(std::vector<int>({ 30 }), row(a, 2));
+  EXPECT_EQ(13u, a.num_values());
+}
+
+TEST(RaggedArrayTest, EraseKeepsOrder)
+{
+  RaggedArray<int> a;
+  a.resize(1);
+  for (int i = 0; i < 6; ++i)
+    a.push_back(0, i);
+
+  EXPECT_TRUE(a.erase(0, 2));
+  EXPECT_FALSE(a.erase(0, 2));
+  EXPECT_EQ(std::vector<int>({ 0, 1, 3, 4, 5 }), row(a, 0));
+
+  EXPECT_EQ(3u, a.erase_if(0, [](int v) { return v % 2 == 1; }));
+  EXPECT_EQ(std::vector<int>({ 0, 4 }), row(a, 0));
+
+  a.clear_row(0);
+  EXPECT_TRUE(a[0].empty());
+  EXPECT_EQ(0u, a.num_values());
+}
@@ -45,6 +45,7 @@
 #include <Core/Datatypes/Legacy/Base/TypeName.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/PointF.h>
 
 namespace SCIRun{
 
@@ -165,6 +166,12 @@ template<> std::string find_type_name(Point*)
   return name;
 }
 
+template<> std::string find_type_name(PointF*)
+{
+  static const std::string name = "PointF";
+  return name;
+}
+
 template<> std::string find_type_name(Transform*)
 {
   static const std::string name = "Transform";
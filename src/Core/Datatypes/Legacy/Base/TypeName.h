@@ -129,6 +129,7 @@ template<> SCISHARE std::string find_type_name(bool*);
 template<> SCISHARE std::string find_type_name(SCIRun::Core::Geometry::Vector*);
 template<> SCISHARE std::string find_type_name(IntVector*);
 template<> SCISHARE std::string find_type_name(SCIRun::Core::Geometry::Point*);
+template<> SCISHARE std::string find_type_name(SCIRun::Core::Geometry::PointF*);
 template<> SCISHARE std::string find_type_name(SCIRun::Core::Geometry::Transform*);
 template<> SCISHARE std::string find_type_name(std::string*);
 
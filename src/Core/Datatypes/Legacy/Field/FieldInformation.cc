@@ -659,9 +659,31 @@ FieldInformation::set_container_type(const std::string& type)
   container_type = type;
 }
 
+/// Meshes that have no single precision version silently fall back to
+/// double precision nodes, so changing the mesh type of a FieldInformation
+/// describing a float mesh still yields a valid type.
+static bool
+supports_float_points(const std::string& mesh_type, const std::string& mesh_basis_type)
+{
+  return ((mesh_type == "TriSurfMesh" && mesh_basis_type == "TriLinearLgn") ||
+          (mesh_type == "TetVolMesh" && mesh_basis_type == "TetLinearLgn") ||
+          (mesh_type == "HexVolMesh" && mesh_basis_type == "HexTrilinearLgn"));
+}
+
+static std::string
+supported_point_type(const std::string& mesh_type, const std::string& mesh_basis_type,
+                     const std::string& point_type)
+{
+  if (point_type == "PointF" && !supports_float_points(mesh_type, mesh_basis_type))
+    return ("Point");
+  return (point_type);
+}
+
 std::string
 FieldInformation::get_field_type_id() const
 {
+  const std::string point_type = supported_point_type(mesh_type, mesh_basis_type, this->point_type);
+
   // Deal with some SCIRun design flaw
   std::string meshptr = "";
   if ((container_type.find("2d") != std::string::npos)||(container_type.find("3d") != std::string::npos))
@@ -681,6 +703,7 @@ FieldInformation::get_field_type_id() const
 std::string
 FieldInformation::get_mesh_type_id() const
 {
+  const std::string point_type = supported_point_type(mesh_type, mesh_basis_type, this->point_type);
   std::string mesh_template =  mesh_type + "<" + mesh_basis_type + "<" + point_type + ">" + ">";
 
   for (std::string::size_type r=0; r< mesh_template.size(); r++) if (mesh_template[r] == ' ') mesh_template[r] = '_';
@@ -769,6 +792,12 @@ FieldTypeInformation::is_linearmesh() const
   return((mesh_basis_type.find("inear") != std::string::npos));
 }
 
+bool
+FieldTypeInformation::is_float_points() const
+{
+  return((point_type == "PointF"));
+}
+
 bool
 FieldTypeInformation::is_nonlinearmesh() const
 {
@@ -1235,6 +1264,21 @@ FieldInformation::make_hexvolmesh()
   return (true);
 }
 
+bool
+FieldInformation::make_float_points()
+{
+  if (!supports_float_points(mesh_type, mesh_basis_type)) return (false);
+  set_point_type("PointF");
+  return (true);
+}
+
+bool
+FieldInformation::make_double_points()
+{
+  set_point_type("Point");
+  return (true);
+}
+
 bool
 FieldInformation::make_structhexvolmesh()
 {
@@ -119,6 +119,8 @@ class SCISHARE FieldTypeInformation
     bool        is_structquadsurfmesh() const;
     bool        is_structhexvolmesh() const;
 
+    /// Mesh nodes stored in single precision (PointF).
+    bool        is_float_points() const;
 
     bool        is_point() const;
     bool        is_line() const;
@@ -243,6 +245,12 @@ class SCISHARE FieldInformation : public FieldTypeInformation {
     bool        make_prismvolmesh();
     bool        make_hexvolmesh();
 
+    /// Switch the node storage precision. Single precision nodes are only
+    /// available for linear TriSurf, TetVol and HexVol meshes; other meshes
+    /// are always created with double precision nodes.
+    bool        make_float_points();
+    bool        make_double_points();
+
     bool        make_unstructuredmesh();
     bool        make_irregularmesh();
 
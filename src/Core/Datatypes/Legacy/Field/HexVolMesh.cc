@@ -161,10 +161,11 @@ public:
 /// Functions for creating the virtual interface for specific mesh types
 /// These are similar to compare maker and only serve to instantiate the class
 
-/// Currently there are only 3 variations of this mesh available
+/// Currently there are only 4 variations of this mesh available
 /// 1) linear interpolation
-/// 2) quadratic interpolation
-/// 3) cubic interpolation
+/// 2) linear interpolation with single precision nodes
+/// 3) quadratic interpolation
+/// 4) cubic interpolation
 
 /// Add the LINEAR virtual interface and the meshid for creating it
 
@@ -178,6 +179,18 @@ VMesh* CreateVHexVolMesh(HexVolMesh<HexTrilinearLgn<Point> >* mesh)
 static MeshTypeID HexVolMesh_MeshID1(HexVolMesh<HexTrilinearLgn<Point> >::type_name(-1),
                   HexVolMesh<HexTrilinearLgn<Point> >::mesh_maker);
 
+/// Add the LINEAR virtual interface for meshes storing their nodes as PointF
+
+/// Create virtual interface
+VMesh* CreateVHexVolMesh(HexVolMesh<HexTrilinearLgn<PointF> >* mesh)
+{
+  return new VHexVolMesh<HexVolMesh<HexTrilinearLgn<PointF> > >(mesh);
+}
+
+/// Register class maker, so we can instantiate it
+static MeshTypeID HexVolMesh_MeshID1F(HexVolMesh<HexTrilinearLgn<PointF> >::type_name(-1),
+                  HexVolMesh<HexTrilinearLgn<PointF> >::mesh_maker);
+
 
 /// Add the QUADRATIC virtual interface and the meshid for creating it
 #if (SCIRUN_QUADRATIC_SUPPORT > 0)
@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
 #include <Core/Containers/StackVector.h>
+#include <Core/Containers/RaggedArray.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
 #include <Core/GeometryPrimitives/BBox.h>
@@ -51,6 +52,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshPointStorage.h>
+#include <Core/Datatypes/Legacy/Field/SortedTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -59,7 +62,6 @@
 
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
-#include <boost/unordered_map.hpp>
 #include <boost/thread.hpp>
 
 #include <set>
@@ -90,6 +92,7 @@ VMesh* CreateVHexVolMesh(MESH*) { return (0); }
 #if (SCIRUN_HEXVOL_SUPPORT > 0)
 
 SCISHARE VMesh* CreateVHexVolMesh(HexVolMesh<Core::Basis::HexTrilinearLgn<Core::Geometry::Point> >* mesh);
+SCISHARE VMesh* CreateVHexVolMesh(HexVolMesh<Core::Basis::HexTrilinearLgn<Core::Geometry::PointF> >* mesh);
 #if (SCIRUN_QUADRATIC_SUPPORT > 0)
 SCISHARE VMesh* CreateVHexVolMesh(HexVolMesh<Core::Basis::HexTriquadraticLgn<Core::Geometry::Point> >* mesh);
 #endif
@@ -171,6 +174,8 @@ public:
 
   typedef boost::shared_ptr<HexVolMesh<Basis> > handle_type;
   typedef Basis                             basis_type;
+  typedef typename MeshPointStorage<Basis>::value_type      point_storage_type;
+  typedef typename MeshPointStorage<Basis>::const_reference point_const_reference;
 
   /// Index and Iterator types required for Mesh Concept.
   struct Node {
@@ -314,35 +319,35 @@ public:
     }
 
     inline
-    const Core::Geometry::Point &node0() const {
+    point_const_reference node0() const {
       return mesh_.points_[node0_index()];
     }
     inline
-    const Core::Geometry::Point &node1() const {
+    point_const_reference node1() const {
       return mesh_.points_[node1_index()];
     }
     inline
-    const Core::Geometry::Point &node2() const {
+    point_const_reference node2() const {
       return mesh_.points_[node2_index()];
     }
     inline
-    const Core::Geometry::Point &node3() const {
+    point_const_reference node3() const {
       return mesh_.points_[node3_index()];
     }
     inline
-    const Core::Geometry::Point &node4() const {
+    point_const_reference node4() const {
       return mesh_.points_[node4_index()];
     }
     inline
-    const Core::Geometry::Point &node5() const {
+    point_const_reference node5() const {
       return mesh_.points_[node5_index()];
     }
     inline
-    const Core::Geometry::Point &node6() const {
+    point_const_reference node6() const {
       return mesh_.points_[node6_index()];
     }
     inline
-    const Core::Geometry::Point &node7() const {
+    point_const_reference node7() const {
       return mesh_.points_[node7_index()];
     }
 
@@ -771,9 +776,9 @@ public:
 
   /// Functions to improve memory management. Often one knows how many
   /// nodes/elements one needs, prereserving memory is often possible.
-  void node_reserve(size_type s) { points_.reserve(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
+  void node_reserve(size_type s) { points_.reserve(static_cast<typename std::vector<point_storage_type>::size_type>(s)); }
   void elem_reserve(size_type s) { cells_.reserve(static_cast<std::vector<index_type>::size_type>(s*8)); }
-  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
+  void resize_nodes(size_type s) { points_.resize(static_cast<typename std::vector<point_storage_type>::size_type>(s)); }
   void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*8)); }
 
   /// Get the local coordinates for a certain point within an element
@@ -972,21 +977,15 @@ public:
             {
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
-                typename SearchGridT<index_type>::iterator it, eit;
                 found = false;
-                node_grid_->lookup_ijk(it,eit, i, j, k);
-
-                while (it != eit)
+                if (node_grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
                     {
@@ -994,7 +993,32 @@ public:
                       return (true);
                     }
                   }
-                  ++it;
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it,eit, i, j, k);
+
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+                    ++it;
+                  }
                 }
               }
             }
@@ -1544,7 +1568,7 @@ public:
 				    const Core::Geometry::Point &p6, const Core::Geometry::Point &p7);
 
   /// must detach, if altering points!
-  std::vector<Core::Geometry::Point>& get_points() { return points_; }
+  std::vector<point_storage_type>& get_points() { return points_; }
 
   int compute_checksum();
 
@@ -1567,12 +1591,12 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
       "HexVolMesh: Must call synchronize EDGES_E first");
 
-    if (edges_[idx].cells_.size() == 0)
+    if (edges_.row_size(idx) == 0)
       { array.clear(); return; }
 
     array.resize(2);
 
-    index_type cell_edge_index = edges_[idx].cells_[0];
+    index_type cell_edge_index = edges_.at(idx, 0);
     index_type cell_index = (cell_edge_index>>4) << 3;
     index_type edge_index = (cell_edge_index)&0xF;
 
@@ -1808,7 +1832,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1822,17 +1846,17 @@ protected:
 
       PEdgeNode e(cells_[cell_index+offset[0]],cells_[cell_index+offset[1]]);
       typename edge_nt::const_iterator iter = edge_table_.find(e);
-      if (((edges_[iter->second].cells_[0])&(~0xf))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0xf))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
 
       PEdgeNode e1(cells_[cell_index+offset[2]],cells_[cell_index+offset[3]]);
       iter = edge_table_.find(e1);
-      if (((edges_[iter->second].cells_[0])&(~0xf))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0xf))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
 
       PEdgeNode e2(cells_[cell_index+offset[4]],cells_[cell_index+offset[5]]);
       iter = edge_table_.find(e2);
-      if (((edges_[iter->second].cells_[0])&(~0xf))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0xf))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
     }
   }
@@ -1847,10 +1871,10 @@ protected:
 
     array.clear();
 
-    for (size_t c=0; c<edges_[idx].cells_.size();c++)
+    for (size_t c=0; c<edges_.row_size(idx);c++)
     {
-      index_type cell_index = ((edges_[idx].cells_[c])>>4)<<3;
-      index_type face_index = (edges_[idx].cells_[c])&0xF;
+      index_type cell_index = ((edges_.at(idx, c))>>4)<<3;
+      index_type face_index = (edges_.at(idx, c))&0xF;
 
       const int* off = HexVolFacePerEdgeTable[face_index];
 
@@ -1890,7 +1914,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row neighbors = node_neighbors_[idx];
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -1940,9 +1964,9 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
                     "HexVolMesh: Must call synchronize EDGES_E first");
 
-    array.resize(edges_[idx].cells_.size());
-    for (size_t i=0; i<edges_[idx].cells_.size();i++)
-      array[i] = static_cast<typename ARRAY::value_type>((edges_[idx].cells_[i])>>4);
+    array.resize(edges_.row_size(idx));
+    for (size_t i=0; i<edges_.row_size(idx);i++)
+      array[i] = static_cast<typename ARRAY::value_type>((edges_.at(idx, i))>>4);
   }
 
   template<class ARRAY, class INDEX>
@@ -2164,22 +2188,35 @@ protected:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                SearchGridT<index_type>::iterator it, eit;
-                node_grid_->lookup_ijk(it, eit, i, j, k);
+                if (node_grid_->has_points())
+                {
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it, eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
 
-                    if (dist < epsilon2_) return (true);
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -2436,12 +2473,13 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
-  const Core::Geometry::Point &point(typename Node::index_type i) const { return points_[i]; }
+  point_const_reference point(typename Node::index_type i) const { return points_[i]; }
 
   template<class INDEX>
   bool inside(INDEX idx, const Core::Geometry::Point &p) const
@@ -2480,7 +2518,7 @@ protected:
   }
 
   /// all the nodes.
-  std::vector<Core::Geometry::Point>        points_;
+  std::vector<point_storage_type>           points_;
   /// each 8 indecies make up a Hex
   std::vector<under_type>   cells_;
 
@@ -2589,14 +2627,6 @@ protected:
     }
   };
 
-  class PFace : public PFaceNode, public PFaceCell
-  {
-    public:
-      PFace(typename Node::index_type n1, typename Node::index_type n2,
-          typename Node::index_type n3, typename Node::index_type n4) :
-        PFaceNode(n1,n2,n3,n4) {}
-  };
-
   /// Edge information.
   class PEdgeNode {
     public:
@@ -2640,129 +2670,16 @@ protected:
       }
   };
 
-  class PEdgeCell {
-  public:
-    /// list of all the cells this edge is in.
-    //typedef StackBasedVector<index_type,4> cells_type ;
-    typedef std::vector<index_type> cells_type;
-    cells_type cells_;
-
-    bool shared() const { return cells_.size() > 1; }
-  };
-
-  /// Edge information.
-  class PEdge : public PEdgeNode, public PEdgeCell
-  {
-    public:
-      PEdge(typename Node::index_type n1,typename Node::index_type n2) :
-        PEdgeNode(n1,n2) {}
-  };
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_quarter_int = (int)(sz_int / 4);
-    static const int top4_mask = -(1 << sz_quarter_int << sz_quarter_int << sz_quarter_int);
-    static const int up4_mask = top4_mask ^ -(1 << sz_quarter_int << sz_quarter_int);
-    static const int mid4_mask =  top4_mask ^ -(1 << sz_quarter_int);
-    static const int low4_mask = ~(top4_mask | mid4_mask);
-
-    /// This is the hash function
-    template <class PFACE>
-    size_t operator()(const PFACE &f) const
-    {
-      if (f.nodes_[2] == f.nodes_[3])
-      {
-        if (f.nodes_[1] < f.nodes_[2])
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[3]));
-        }
-        else
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[2] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[1] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[1]));
-        }
-      }
-      else
-      {
-        if (f.nodes_[1] < f.nodes_[3] )
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[3]));
-        }
-        else
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[3] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[1]));
-        }
-      }
-    }
-
-    /// This should return less than rather than equal to.
-    template <class PFACE>
-    bool operator()(const PFACE &f1, const PFACE& f2) const {
-      return f1 < f2;
-    }
-  };
-
-  /*/ hash the egde's node_indecies such that edges with the same nodes
-   *  hash to the same value. nodes are sorted on edge construction. */
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    template<class PEDGE>
-    size_t operator()(const PEDGE &e) const
-    {
-      return (e.nodes_[0] << sz_half_int) |
-	(low_mask & e.nodes_[1]);
-    }
-
-    ///  This should return less than rather than equal to.
-    template<class PEDGE>
-    bool operator()(const PEDGE &e1, const PEDGE &e2) const
-    {
-      return e1 < e2;
-    }
-  };
-
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  typedef SortedTopologyTable<PFaceNode, typename Face::index_type> face_nt;
+  typedef SortedTopologyTable<PEdgeNode, typename Edge::index_type> edge_nt;
 
   typedef std::vector<PFaceCell> face_ct;
-  typedef std::vector<PEdgeCell> edge_ct;
+  /// For every edge the combined (cell<<4 | local edge) indices of the
+  /// cells sharing it.
+  typedef RaggedArray<index_type, index_type> edge_ct;
+  /// For every node the combined (cell<<3 | local node) indices of the
+  /// cells using it.
+  typedef RaggedArray<index_type, index_type> node_neighbor_ct;
 
   /// container for face storage. Must be computed each time
   ///  nodes or cells change.
@@ -2774,15 +2691,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2852,7 +2760,7 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  node_neighbor_ct node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2898,7 +2806,7 @@ HexVolMesh<Basis>::HexVolMesh() :
   cells_(0),
   faces_(0),
   face_table_(),
-  edges_(0),
+  edges_(),
   edge_table_(),
   synchronize_lock_("HexVolMesh Lock"),
   synchronize_cond_("HexVolMesh condition variable"),
@@ -2920,7 +2828,7 @@ HexVolMesh<Basis>::HexVolMesh(const HexVolMesh &copy) :
   cells_(0),
   faces_(0),
   face_table_(),
-  edges_(0),
+  edges_(),
   edge_table_(),
   synchronize_lock_("HexVolMesh Lock"),
   synchronize_cond_("HexVolMesh condition variable"),
@@ -2971,7 +2879,7 @@ HexVolMesh<Basis>::fill_points(Iter begin, Iter end, Functor fill_ftor)
   synchronize_lock_.lock();
   Iter iter = begin;
   points_.resize(end - begin); // resize to the new size
-  std::vector<Core::Geometry::Point>::iterator piter = points_.begin();
+  typename std::vector<point_storage_type>::iterator piter = points_.begin();
   while (iter != end)
   {
     *piter = fill_ftor(*iter);
@@ -3175,8 +3083,8 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
   synchronize_lock_.lock();
 
-  std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
-  std::vector<Core::Geometry::Point>::iterator eitr = points_.end();
+  typename std::vector<point_storage_type>::iterator itr = points_.begin();
+  typename std::vector<point_storage_type>::iterator eitr = points_.end();
   while (itr != eitr)
   {
     *itr = t.project(*itr);
@@ -3210,184 +3118,133 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
-{
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-
-  typename face_ht::iterator iter = table.find(f);
-
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_faces()
 {
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
-
-  face_ht table;
-
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
+  typedef TopologyRecord<PFaceNode> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 3);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  // 6 faces -- each is entered CCW from outside looking in. The nodes are
+  // reordered while maintaining the orientation; degenerate faces (e.g.
+  // nodes on opposite corners are equal, or more than two nodes are equal)
+  // are ignored.
+  std::vector<record_type> records(num_cells * 6);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      static const int face_nodes[6][4] = { {0,1,2,3}, {7,6,5,4}, {0,4,5,1},
+                                            {2,6,7,3}, {3,7,4,0}, {1,5,6,2} };
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c << 3];
+        const index_type cell_index = static_cast<index_type>(c) << 3;
+        for (int f = 0; f < 6; ++f)
+        {
+          typename Node::index_type n1(n[face_nodes[f][0]]), n2(n[face_nodes[f][1]]);
+          typename Node::index_type n3(n[face_nodes[f][2]]), n4(n[face_nodes[f][3]]);
+          if (order_face_nodes(n1, n2, n3, n4))
+            records[c * 6 + f] = record_type(PFaceNode(n1, n2, n3, n4), cell_index + f);
+          else
+            records[c * 6 + f].item_ = -1;
+        }
+      }
+    });
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const record_type& rec) { return rec.item_ < 0; }), records.end());
+
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  const size_type num_faces =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
+
+  // The records of a face are ordered by cell, so the first one becomes
+  // cells_[0]. A third cell sharing a face, or a cell sharing a face with
+  // itself, means the mesh is malformed and is ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  std::vector<unsigned char> boundary(cells_.size(), 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_faces), 0,
+    [this, &records, &group_offsets, &boundary](const Core::Thread::IndexRange& r)
+    {
+      for (size_t f = r.begin; f < r.end; ++f)
+      {
+        const index_type b = group_offsets[f], e = group_offsets[f + 1];
+        PFaceCell& face = faces_[f];
+        face.cells_[0] = records[b].item_;
+        for (index_type i = b + 1; i < e; ++i)
+        {
+          if ((records[i].item_>>3) != (face.cells_[0]>>3))
+          {
+            face.cells_[1] = records[i].item_;
+            break;
+          }
+        }
+        if (face.cells_[1] == MESH_NO_NEIGHBOR) boundary[face.cells_[0]] = 1;
+      }
+    });
 
-    if (pface.cells_[1] == -1)
+  boundary_faces_.clear();
+  boundary_faces_.resize(num_cells, 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &boundary](const Core::Thread::IndexRange& r)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
-      boundary_faces_[cell] |= 1 << face;
-    }
+      for (size_t c = r.begin; c < r.end; ++c)
+        for (int face = 0; face < 6; ++face)
+          if (boundary[(c << 3) + face]) boundary_faces_[c] |= 1 << face;
+    });
 
-    ++ht_iter; uidx++;
-  }
+  face_table_.assign(records, group_offsets, node_groups);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
-
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+  typedef TopologyRecord<PEdgeNode> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 3);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  std::vector<record_type> records(num_cells * 12);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      static const int edge_nodes[12][2] = { {0,1}, {1,2}, {2,3}, {3,0},
+                                             {4,5}, {5,6}, {6,7}, {7,4},
+                                             {0,4}, {5,1}, {2,6}, {7,3} };
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c << 3];
+        const index_type cell_index = static_cast<index_type>(c) << 4;
+        for (int e = 0; e < 12; ++e)
+          records[c * 12 + e] = record_type(
+            PEdgeNode(n[edge_nodes[e][0]], n[edge_nodes[e][1]]), cell_index + e);
+      }
+    });
+  // Collapsed edges of degenerate hexes are not edges of the mesh.
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const record_type& rec) { return rec.key_.nodes_[0] == rec.key_.nodes_[1]; }),
+    records.end());
+
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  group_topology_records(records, node_offsets, group_offsets, node_groups);
+
+  // The records of an edge are contiguous and ordered by cell, so they are
+  // the rows of edges_ as they stand.
+  std::vector<index_type> cells(records.size());
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, records.size()), 0,
+    [&records, &cells](const Core::Thread::IndexRange& r)
+    {
+      for (size_t i = r.begin; i < r.end; ++i) cells[i] = records[i].item_;
+    });
+  edge_table_.assign(records, group_offsets, node_groups);
+  edges_.assign(group_offsets, cells);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3677,13 +3534,9 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  std::vector<index_type> offsets, items;
+  build_node_adjacency(cells_, static_cast<size_type>(points_.size()), offsets, items);
+  node_neighbors_.assign(offsets, items);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3726,12 +3579,9 @@ HexVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::ar
 }
 
 template <class Basis>
-void
-HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+HexVolMesh<Basis>::elem_grid_bbox(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*8;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3743,26 +3593,24 @@ HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+6]]);
   box.extend(points_[cells_[idx+7]]);
   box.extend(epsilon_);
+  return (box);
+}
+
+template <class Basis>
+void
+HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
 
-  elem_grid_->insert(ci, box);
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 HexVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*8;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(points_[cells_[idx+6]]);
-  box.extend(points_[cells_[idx+7]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3803,13 +3651,7 @@ HexVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->fill_boxes(esz, [this](index_type ci) { return elem_grid_bbox(ci); });
   }
 
   synchronize_lock_.lock();
@@ -3840,13 +3682,8 @@ HexVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    typename Node::size_type nsz;  size(nsz);
+    node_grid_->fill_points(nsz, [this](index_type n) { return points_[n]; });
   }
 
   synchronize_lock_.lock();
@@ -81,7 +81,8 @@ public:
     BOUNDING_BOX_E = 1 << 12,
     FIND_CLOSEST_NODE_E		= 1 << 13,
     FIND_CLOSEST_ELEM_E		= 1 << 14,
-    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E
+    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E,
+    SURFACE_BVH_E = 1 << 15
   };
 
   virtual bool synchronize(mask_type) { return false; }
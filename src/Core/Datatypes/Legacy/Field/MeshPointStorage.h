@@ -0,0 +1,74 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_MESHPOINTSTORAGE_H
+#define CORE_DATATYPES_MESHPOINTSTORAGE_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/PointF.h>
+
+#include <vector>
+
+namespace SCIRun {
+
+/// Selects how an unstructured mesh stores its nodes. By default nodes are
+/// kept as Point; a basis templated on PointF makes the mesh store floats.
+/// const_reference is what the mesh hands out for a single node: a reference
+/// into the array for Point storage and a converted copy for PointF storage.
+template <class Basis>
+struct MeshPointStorage
+{
+  typedef Core::Geometry::Point        value_type;
+  typedef const Core::Geometry::Point& const_reference;
+  static const bool is_float = false;
+};
+
+template <template <class> class BasisT>
+struct MeshPointStorage<BasisT<Core::Geometry::PointF> >
+{
+  typedef Core::Geometry::PointF       value_type;
+  typedef Core::Geometry::Point        const_reference;
+  static const bool is_float = true;
+};
+
+/// Raw access to the node array, as used by the virtual interface. Only
+/// double precision storage can be handed out as an array of Points.
+inline Core::Geometry::Point* points_pointer(std::vector<Core::Geometry::Point>& points)
+{
+  return points.empty() ? 0 : &points[0];
+}
+
+inline Core::Geometry::Point* points_pointer(std::vector<Core::Geometry::PointF>&)
+{
+  return 0;
+}
+
+}
+
+#endif
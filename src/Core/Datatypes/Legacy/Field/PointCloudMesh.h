@@ -626,22 +626,35 @@ public:
               if (grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                SearchGridT<index_type>::iterator it, eit;
-                grid_->lookup_ijk(it, eit, i, j, k);
+                if (grid_->has_points())
+                {
+                  index_type closest;
+                  if (grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  SearchGridT<index_type>::iterator it, eit;
+                  grid_->lookup_ijk(it, eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
 
-                    if (dist < epsilon2_) return (true);
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -798,20 +811,14 @@ public:
               if (grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                typename SearchGridT<index_type>::iterator  it, eit;
-                grid_->lookup_ijk(it, eit, i, j, k);
-
-                while (it != eit)
+                if (grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist  = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
 
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
@@ -820,8 +827,34 @@ public:
                       return (true);
                     }
                   }
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator  it, eit;
+                  grid_->lookup_ijk(it, eit, i, j, k);
 
-                  ++it;
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist  = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+
+                    ++it;
+                  }
                 }
               }
             }
@@ -1682,13 +1715,7 @@ PointCloudMesh<Basis>::compute_grid(Core::Geometry::BBox& bb)
     Core::Geometry::BBox b = bb; b.extend(10*epsilon_);
     grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    grid_->fill_points(esz, [this](index_type n) { return points_[n]; });
   }
   else
   {
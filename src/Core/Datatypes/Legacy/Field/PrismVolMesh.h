@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
 #include <Core/Containers/StackVector.h>
+#include <Core/Containers/RaggedArray.h>
 #include <Core/Persistent/PersistentSTL.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
@@ -51,15 +52,16 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/SortedTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
 
 #include <boost/thread.hpp>
-#include <boost/unordered_map.hpp>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
 
+#include <algorithm>
 #include <set>
 
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -899,21 +901,15 @@ public:
             {
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
-                typename SearchGridT<index_type>::iterator it, eit;
                 found = false;
-                node_grid_->lookup_ijk(it,eit, i, j, k);
-
-                while (it != eit)
+                if (node_grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
                     {
@@ -921,7 +917,32 @@ public:
                       return (true);
                     }
                   }
-                  ++it;
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it,eit, i, j, k);
+
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+                    ++it;
+                  }
                 }
               }
             }
@@ -1457,7 +1478,7 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
       "PrismVolMesh: Must call synchronize EDGES_E first");
 
-    if (edges_[idx].cells_.size() == 0)
+    if (edge_cells_.row_size(idx) == 0)
       { array.clear(); return; }
 
     array.resize(2);
@@ -1711,16 +1732,16 @@ protected:
     for (size_t n = 0; n < neighbors.size(); n++)
     {
       // Get the edge information for the current edge
-      typename edge_ht::const_iterator iter =
+      typename edge_nt::const_iterator iter =
                   edge_table_.find(PEdge(
                     static_cast<typename Node::index_type>(idx),neighbors[n]));
       ASSERTMSG(iter != edge_table_.end(),
                 "Edge not found in PrismVolMesh::edge_table_");
       // Insert all cells that share this edge into
       // the unique set of cell indices
-      for (size_t c = 0; c < (iter->first).cells_.size(); c++)
-        unique_cells.insert(static_cast<typename ARRAY::value_type>(
-                                                    (iter->first).cells_[c]));
+      const typename edge_cell_ct::const_row cells = edge_cells_[iter->second];
+      for (size_t c = 0; c < cells.size(); c++)
+        unique_cells.insert(static_cast<typename ARRAY::value_type>(cells[c]));
     }
 
     // Copy the unique set of cells to our Cells array return argument
@@ -1733,8 +1754,9 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
 	      "PrismVolMesh: Must call synchronize EDGES_E first");
-    for (size_t i=0; i<edges_[idx].cells_.size();i++)
-      array[i] = static_cast<typename ARRAY::value_type>(edges_[idx].cells_[i]);
+    array.resize(edge_cells_.row_size(idx));
+    for (size_t i=0; i<edge_cells_.row_size(idx);i++)
+      array[i] = static_cast<typename ARRAY::value_type>(edge_cells_.at(idx, i));
   }
 
   template <class ARRAY, class INDEX>
@@ -1898,22 +1920,35 @@ protected:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                SearchGridT<index_type>::iterator it, eit;
-                node_grid_->lookup_ijk(it, eit, i, j, k);
+                if (node_grid_->has_points())
+                {
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it, eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
 
-                    if (dist < epsilon2_) return (true);
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -2170,6 +2205,7 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2244,123 +2280,40 @@ protected:
     bool shared() const { return ((cells_[0] != MESH_NO_NEIGHBOR) &&
                                   (cells_[1] != MESH_NO_NEIGHBOR)); }
 
-    /// true if both have the same nodes (order does not matter)
-    bool operator==(const PFace &f) const {
-      if (nodes_[2] == nodes_[3])
+    /// The nodes in the order faces are compared in: the first node, then
+    /// its two neighbors on the face in ascending order with the opposite
+    /// node in between. Triangles (the fourth node is the dummy node) and
+    /// degenerate quads (the last two nodes are equal) list their last node
+    /// twice. The first node is the smallest one, see order_face_nodes.
+    void key(typename Node::index_type k[4]) const
+    {
+      k[0] = nodes_[0];
+      if (nodes_[3] == PRISM_DUMMY_NODE_INDEX || nodes_[2] == nodes_[3])
       {
-        return ((nodes_[0] == f.nodes_[0]) &&
-                (((nodes_[1]==f.nodes_[1])&&(nodes_[2] == f.nodes_[2]))||
-		 ((nodes_[1]==f.nodes_[2])&&(nodes_[2] == f.nodes_[1]))));
+        k[1] = std::min(nodes_[1], nodes_[2]);
+        k[2] = k[3] = std::max(nodes_[1], nodes_[2]);
       }
       else
       {
-        return (((nodes_[0] == f.nodes_[0])&&(nodes_[2] == f.nodes_[2])) &&
-                (((nodes_[1]==f.nodes_[1])&&(nodes_[3] == f.nodes_[3]))||
-		 ((nodes_[1]==f.nodes_[3])&&(nodes_[3] == f.nodes_[1]))));
+        k[1] = std::min(nodes_[1], nodes_[3]);
+        k[2] = nodes_[2];
+        k[3] = std::max(nodes_[1], nodes_[3]);
       }
     }
 
+    /// true if both have the same nodes (order does not matter)
+    bool operator==(const PFace &f) const {
+      typename Node::index_type a[4], b[4];
+      key(a); f.key(b);
+      return (std::equal(a, a + 4, b));
+    }
+
     /// Compares each node.  When a non equal node is found the <
     /// operator is applied.
     bool operator<(const PFace &f) const {
-      if (nodes_[2] == nodes_[3])
-      {
-        if ((nodes_[1] < nodes_[2]) && (f.nodes_[1] < f.nodes_[2]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[1] == f.nodes_[1])
-              return (nodes_[2] < f.nodes_[2]);
-            else
-              return (nodes_[1] < f.nodes_[1]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else if ((nodes_[1] < nodes_[2]) && (f.nodes_[1] >= f.nodes_[2]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[1] == f.nodes_[2])
-              return (nodes_[2] < f.nodes_[1]);
-            else
-              return (nodes_[1] < f.nodes_[2]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else if ((nodes_[1] >= nodes_[2]) && (f.nodes_[1] < f.nodes_[2]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[2] == f.nodes_[1])
-              return (nodes_[1] < f.nodes_[2]);
-            else
-              return (nodes_[2] < f.nodes_[1]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[2] == f.nodes_[2])
-              return (nodes_[1] < f.nodes_[1]);
-            else
-              return (nodes_[2] < f.nodes_[2]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-      }
-      else
-      {
-        if ((nodes_[1] < nodes_[3]) && (f.nodes_[1] < f.nodes_[3]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[1] == f.nodes_[1])
-              if (nodes_[2] == f.nodes_[2])
-                return (nodes_[3] < f.nodes_[3]);
-              else
-                return (nodes_[2] < f.nodes_[2]);
-            else
-              return (nodes_[1] < f.nodes_[1]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else if ((nodes_[1] < nodes_[3]) && (f.nodes_[1] >= f.nodes_[3]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[1] == f.nodes_[3])
-              if (nodes_[2] == f.nodes_[2])
-                return (nodes_[3] < f.nodes_[1]);
-              else
-                return (nodes_[2] < f.nodes_[2]);
-            else
-              return (nodes_[1] < f.nodes_[3]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else if ((nodes_[1] >= nodes_[3]) && (f.nodes_[1] < f.nodes_[3]))
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[3] == f.nodes_[1])
-              if (nodes_[2] == f.nodes_[2])
-                return (nodes_[1] < f.nodes_[3]);
-              else
-                return (nodes_[2] < f.nodes_[2]);
-            else
-              return (nodes_[3] < f.nodes_[1]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-        else
-        {
-          if (nodes_[0] == f.nodes_[0])
-            if (nodes_[3] == f.nodes_[3])
-              if (nodes_[2] == f.nodes_[2])
-                return (nodes_[1] < f.nodes_[1]);
-              else
-                return (nodes_[2] < f.nodes_[2]);
-            else
-              return (nodes_[3] < f.nodes_[3]);
-          else
-            return (nodes_[0] < f.nodes_[0]);
-        }
-      }
+      typename Node::index_type a[4], b[4];
+      key(a); f.key(b);
+      return (std::lexicographical_compare(a, a + 4, b, b + 4));
     }
 
   };
@@ -2369,16 +2322,14 @@ protected:
   struct PEdge
   {
     typename Node::index_type         nodes_[2];   /// 2 nodes makes an edge.
-    /// list of all the cells this edge is in.
-    std::vector<typename Cell::index_type> cells_;
 
-    PEdge() : cells_(0) {
+    PEdge() {
       nodes_[0] = MESH_NO_NEIGHBOR;
       nodes_[1] = MESH_NO_NEIGHBOR;
     }
-    // node_[0] must be smaller than node_[1]. See Hash Function below.
+    // node_[0] must be smaller than node_[1].
     PEdge(typename Node::index_type n1,
-          typename Node::index_type n2) : cells_(0)
+          typename Node::index_type n2)
     {
       if (n1 < n2)
       {
@@ -2392,8 +2343,6 @@ protected:
       }
     }
 
-    bool shared() const { return cells_.size() > 1; }
-
     /// true if both have the same nodes (order does not matter)
     bool operator==(const PEdge &e) const
     {
@@ -2411,106 +2360,42 @@ protected:
     }
   };
 
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_quarter_int = (int)(sz_int / 4);
-    static const int top4_mask = -(1 << sz_quarter_int << sz_quarter_int << sz_quarter_int);
-    static const int up4_mask = top4_mask ^ -(1 << sz_quarter_int << sz_quarter_int);
-    static const int mid4_mask =  top4_mask ^ -(1 << sz_quarter_int);
-    static const int low4_mask = ~(top4_mask | mid4_mask);
-
-    /// This is the hash function
-    size_t operator()(const PFace &f) const {
-      if (f.nodes_[1] < f.nodes_[3] )
-      {
-        return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-              (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-              (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-              (low4_mask & f.nodes_[3]));
-      }
-      else
-      {
-        return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-              (up4_mask & (f.nodes_[3] << sz_quarter_int << sz_quarter_int)) |
-              (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-              (low4_mask & f.nodes_[1]));
-      }
-    }
-    /// This should return less than rather than equal to.
-    bool operator()(const PFace &f1, const PFace& f2) const {
-      return f1 < f2;
-    }
-  };
-
-  friend struct FaceHash; // needed by the gcc-2.95.3 compiler
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    size_t operator()(const PEdge &e) const
-    {
-      return (e.nodes_[0] << sz_half_int) |
-	(low_mask & e.nodes_[1]);
-    }
-
-    ///  This should return less than rather than equal to.
-    bool operator()(const PEdge &e1, const PEdge& e2) const
-    {
-      return e1 < e2;
-    }
-  };
-
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
+  typedef SortedTopologyTable<PFace, typename Face::index_type> face_nt;
+  typedef SortedTopologyTable<PEdge, typename Edge::index_type> edge_nt;
+  /// For every edge the cells sharing it.
+  typedef RaggedArray<index_type, index_type> edge_cell_ct;
+  /// For every node the nodes it shares an edge with.
+  typedef RaggedArray<index_type, index_type> node_neighbor_ct;
 
   /// container for face storage. Must be computed each time
   ///  nodes or cells change.
   std::vector<PFace>            faces_;
-  face_ht                  face_table_;
+  face_nt                  face_table_;
   /// container for edge storage. Must be computed each time
   ///  nodes or cells change.
   std::vector<PEdge>            edges_;
-  edge_ht                  edge_table_;
-
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
+  edge_cell_ct             edge_cells_;
+  edge_nt                  edge_table_;
 
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
+    // Triangles start at their smallest node, which keeps the orientation
     if( n4 == PRISM_DUMMY_NODE_INDEX )
+    {
+      INDEX t;
+      if ((n2 < n1)&&(n2 < n3))
+      {
+        // shift one position to left
+        t = n1; n1 = n2; n2 = n3; n3 = t;
+      }
+      else if ((n3 < n1)&&(n3 < n2))
+      {
+        // shift one position to right
+        t = n3; n3 = n2; n2 = n1; n1 = t;
+      }
       return (true);
+    }
 
     // Check for degenerate or misformed face
     // Opposite faces cannot be equal
@@ -2558,31 +2443,12 @@ protected:
     return (true);
   }
 
-  /// useful functors
-  struct FillNodeNeighbors {
-    FillNodeNeighbors(std::vector<std::vector<typename Node::index_type> > &n,
-                      const PrismVolMesh &m) :
-      nbor_vec_(n),
-      mesh_(m)
-    {}
-
-    void operator()(typename Edge::index_type e) {
-      mesh_.get_nodes(nodes_, e);
-      nbor_vec_[nodes_[0]].push_back(nodes_[1]);
-      nbor_vec_[nodes_[1]].push_back(nodes_[0]);
-    }
-
-    std::vector<std::vector<typename Node::index_type> > &nbor_vec_;
-    const PrismVolMesh            &mesh_;
-    typename Node::array_type   nodes_;
-  };
-
   /// This grid is used as an acceleration structure to expedite calls
   ///  to locate.  For each cell in the grid, we store a list of which
   ///  tets overlap that grid cell -- to find the tet which contains a
   ///  point, we simply find which grid cell contains that point, and
   ///  then search just those tets that overlap that grid cell.
-  std::vector<std::vector<typename Node::index_type> > node_neighbors_;
+  node_neighbor_ct node_neighbors_;
 
   std::vector<unsigned char> boundary_faces_;
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
@@ -2624,6 +2490,7 @@ PrismVolMesh<Basis>::PrismVolMesh() :
   faces_(0),
   face_table_(),
   edges_(0),
+  edge_cells_(),
   edge_table_(),
   synchronize_lock_("PrismVolMesh Lock"),
   synchronize_cond_("PrismVolMesh condition variable"),
@@ -2647,6 +2514,7 @@ PrismVolMesh<Basis>::PrismVolMesh(const PrismVolMesh &copy):
   faces_(0),
   face_table_(),
   edges_(0),
+  edge_cells_(),
   edge_table_(),
   synchronize_lock_("PrismVolMesh Lock"),
   synchronize_cond_("PrismVolMesh condition variable"),
@@ -2885,168 +2753,143 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
-{
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_faces()
 {
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
-
-  boundary_faces_.resize(cells_.size() /6);
-
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
-  {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
+  typedef TopologyRecord<PFace> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() / 6);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  // 5 faces -- each is entered CCW from outside looking in. The nodes are
+  // reordered while maintaining the orientation; degenerate faces (e.g.
+  // nodes on opposite corners are equal, or more than two nodes are equal)
+  // are ignored.
+  std::vector<record_type> records(num_cells * 5);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      static const int face_nodes[5][4] = { {0,1,2,-1}, {5,4,3,-1}, {1,4,5,2},
+                                            {2,5,3,0}, {0,3,4,1} };
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c * 6];
+        const index_type cell_index = static_cast<index_type>(c) << 3;
+        for (int f = 0; f < 5; ++f)
+        {
+          typename Node::index_type n1(n[face_nodes[f][0]]), n2(n[face_nodes[f][1]]);
+          typename Node::index_type n3(n[face_nodes[f][2]]);
+          typename Node::index_type n4 = (face_nodes[f][3] < 0) ?
+            PRISM_DUMMY_NODE_INDEX : typename Node::index_type(n[face_nodes[f][3]]);
+          if (order_face_nodes(n1, n2, n3, n4))
+            records[c * 5 + f] = record_type(PFace(n1, n2, n3, n4), cell_index + f);
+          else
+            records[c * 5 + f].item_ = -1;
+        }
+      }
+    });
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const record_type& rec) { return rec.item_ < 0; }), records.end());
+
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  const size_type num_faces =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
+
+  // The records of a face are ordered by cell, so the first one becomes
+  // cells_[0]. A third cell sharing a face, or a cell sharing a face with
+  // itself, means the mesh is malformed and is ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  std::vector<unsigned char> boundary(num_cells << 3, 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_faces), 0,
+    [this, &records, &group_offsets, &boundary](const Core::Thread::IndexRange& r)
+    {
+      for (size_t f = r.begin; f < r.end; ++f)
+      {
+        const index_type b = group_offsets[f], e = group_offsets[f + 1];
+        PFace& face = faces_[f];
+        face = records[b].key_;
+        face.cells_[0] = records[b].item_;
+        for (index_type i = b + 1; i < e; ++i)
+        {
+          if ((records[i].item_>>3) != (face.cells_[0]>>3))
+          {
+            face.cells_[1] = records[i].item_;
+            break;
+          }
+        }
+        if (face.cells_[1] == MESH_NO_NEIGHBOR) boundary[face.cells_[0]] = 1;
+      }
+    });
 
-    if ((*f_iter).cells_[1] == -1)
+  boundary_faces_.clear();
+  boundary_faces_.resize(num_cells, 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &boundary](const Core::Thread::IndexRange& r)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
-      boundary_faces_[cell] |= 1 << face;
-    }
-    ++f_iter; ++ht_iter; i++;
-  }
+      for (size_t c = r.begin; c < r.end; ++c)
+        for (int face = 0; face < 5; ++face)
+          if (boundary[(c << 3) + face]) boundary_faces_[c] |= 1 << face;
+    });
+
+  face_table_.assign(records, group_offsets, node_groups);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
-
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
-
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-
-  edges_.resize(edge_table_.size());
-
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+  typedef TopologyRecord<PEdge> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() / 6);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  std::vector<record_type> records(num_cells * 9);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      static const int edge_nodes[9][2] = { {0,1}, {1,2}, {2,0},
+                                            {3,4}, {4,5}, {5,3},
+                                            {0,3}, {4,1}, {2,5} };
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c * 6];
+        for (int e = 0; e < 9; ++e)
+          records[c * 9 + e] = record_type(
+            PEdge(n[edge_nodes[e][0]], n[edge_nodes[e][1]]), static_cast<index_type>(c));
+      }
+    });
+  // Collapsed edges of degenerate prisms are not edges of the mesh.
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const record_type& rec) { return rec.key_.nodes_[0] == rec.key_.nodes_[1]; }),
+    records.end());
+
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  const size_type num_edges =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
+
+  // The records of an edge are contiguous and ordered by cell, so they are
+  // the rows of edge_cells_ as they stand.
+  edges_.clear();
+  edges_.resize(num_edges);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_edges), 0,
+    [this, &records, &group_offsets](const Core::Thread::IndexRange& r)
+    {
+      for (size_t e = r.begin; e < r.end; ++e) edges_[e] = records[group_offsets[e]].key_;
+    });
+  std::vector<index_type> cells(records.size());
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, records.size()), 0,
+    [&records, &cells](const Core::Thread::IndexRange& r)
+    {
+      for (size_t i = r.begin; i < r.end; ++i) cells[i] = records[i].item_;
+    });
+  edge_table_.assign(records, group_offsets, node_groups);
+  edge_cells_.assign(group_offsets, cells);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3192,6 +3035,7 @@ PrismVolMesh<Basis>::clear_synchronization()
   // Free memory where possible
   node_neighbors_.clear();
   edges_.clear();
+  edge_cells_.clear();
   edge_table_.clear();
   faces_.clear();
   face_table_.clear();
@@ -3326,7 +3170,7 @@ PrismVolMesh<Basis>::get_face(typename Face::index_type &face,
             "Must call synchronize FACES_E on PrismVolMesh first");
   if(!(order_face_nodes(n1,n2,n3,n4))) return (false);
   PFace f(n1, n2, n3, n4);
-  typename face_ht::const_iterator fiter = face_table_.find(f);
+  typename face_nt::const_iterator fiter = face_table_.find(f);
   if (fiter == face_table_.end()) {
     return false;
   }
@@ -3338,11 +3182,18 @@ template <class Basis>
 void
 PrismVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  typename Edge::iterator ei, eie;
-  begin(ei); end(eie);
-  std::for_each(ei, eie, FillNodeNeighbors(node_neighbors_, *this));
+  // Every edge contributes its two end nodes; the row of a node then lists
+  // the edge slots it appears in, from which the opposite node is read.
+  std::vector<index_type> ends(edges_.size() * 2);
+  for (size_t e = 0; e < edges_.size(); ++e)
+  {
+    ends[2 * e] = edges_[e].nodes_[0];
+    ends[2 * e + 1] = edges_[e].nodes_[1];
+  }
+  std::vector<index_type> offsets, slots;
+  build_node_adjacency(ends, static_cast<size_type>(points_.size()), offsets, slots);
+  for (size_t i = 0; i < slots.size(); ++i) slots[i] = ends[slots[i] ^ 1];
+  node_neighbors_.assign(offsets, slots);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3385,12 +3236,9 @@ PrismVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::
 }
 
 template <class Basis>
-void
-PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+PrismVolMesh<Basis>::elem_grid_bbox(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*6;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3400,23 +3248,24 @@ PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+4]]);
   box.extend(points_[cells_[idx+5]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 PrismVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*6;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3457,13 +3306,7 @@ PrismVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->fill_boxes(esz, [this](index_type ci) { return elem_grid_bbox(ci); });
   }
 
   synchronize_lock_.lock();
@@ -3494,13 +3337,8 @@ PrismVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    typename Node::size_type nsz;  size(nsz);
+    node_grid_->fill_points(nsz, [this](index_type n) { return points_[n]; });
   }
 
   synchronize_lock_.lock();
@@ -112,6 +112,7 @@ public:
                          VMesh::Face::index_type);
 
   virtual VMesh::index_type* get_elems_pointer() const;
+  virtual boost::shared_ptr<SurfaceBVH> get_surface_bvh() { return this->mesh_->bvh_; }
 };
 
 
@@ -51,6 +51,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
 #include <Core/Thread/Mutex.h>
@@ -283,6 +284,7 @@ public:
         if (sync_ & Mesh::NORMALS_E) mesh_->compute_normals();
 
         if (sync_ & Mesh::BOUNDING_BOX_E) mesh_->compute_bounding_box();
+        if (sync_ & Mesh::SURFACE_BVH_E) mesh_->compute_surface_bvh();
 
         // These depend on the bounding box being synchronized
         if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E))
@@ -922,21 +924,15 @@ public:
             {
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
-                typename SearchGridT<index_type>::iterator it, eit;
                 found = false;
-                node_grid_->lookup_ijk(it,eit, i, j, k);
-
-                while (it != eit)
+                if (node_grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
 
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
@@ -945,7 +941,33 @@ public:
                       return (true);
                     }
                   }
-                  ++it;
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it,eit, i, j, k);
+
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+                    ++it;
+                  }
                 }
               }
             }
@@ -1937,22 +1959,35 @@ protected:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                typename SearchGridT<index_type>::iterator it, eit;
-                node_grid_->lookup_ijk(it,eit, i, j, k);
+                if (node_grid_->has_points())
+                {
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  typename SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it,eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
 
-                    if (dist < epsilon2_) return (true);
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -2155,9 +2190,11 @@ protected:
 
   void compute_node_grid();
   void compute_elem_grid();
+  void compute_surface_bvh();
   void compute_bounding_box();
 
   /// Used to recompute data for individual cells.
+  Core::Geometry::BBox elem_grid_bbox(index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
 
@@ -2256,6 +2293,7 @@ protected:
   std::vector<Core::Geometry::Vector>                           normals_; /// normalized per node
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_; /// Lookup grid for nodes
   boost::shared_ptr<SearchGridT<index_type> >  elem_grid_; /// Lookup grid for elements
+  boost::shared_ptr<SurfaceBVH>                bvh_;       /// Bounding volume hierarchy of the faces
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex         synchronize_lock_;
@@ -2611,7 +2649,8 @@ QuadSurfMesh<Basis>::synchronize(mask_type sync)
   // Filter out the only tables available
   sync &= (Mesh::EDGES_E|Mesh::NORMALS_E|
            Mesh::NODE_NEIGHBORS_E|Mesh::BOUNDING_BOX_E|
-           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E);
+           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|
+           Mesh::SURFACE_BVH_E);
 
   {
 
@@ -2710,6 +2749,20 @@ QuadSurfMesh<Basis>::synchronize(mask_type sync)
     boost::thread syncthread(syncclass);
   }
 
+  if (sync == Mesh::SURFACE_BVH_E)
+  {
+    Synchronize Synchronize(this,sync);
+    synchronize_lock_.unlock();
+    Synchronize.run();
+    synchronize_lock_.lock();
+  }
+  else if (sync & Mesh::SURFACE_BVH_E)
+  {
+    mask_type tosync = Mesh::SURFACE_BVH_E;
+    Synchronize syncclass(this,tosync);
+    boost::thread syncthread(syncclass);
+  }
+
   // Wait until threads are done
     while ((synchronized_ & sync) != sync)
     {
@@ -2748,6 +2801,7 @@ QuadSurfMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  bvh_.reset();
 
   synchronize_lock_.unlock();
   return (true);
@@ -2939,11 +2993,9 @@ QuadSurfMesh<Basis>::compute_node_neighbors()
 
 
 template <class Basis>
-void
-QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+QuadSurfMesh<Basis>::elem_grid_bbox(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
@@ -2951,7 +3003,16 @@ QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[faces_[idx+2]]);
   box.extend(points_[faces_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+QuadSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -2959,14 +3020,7 @@ template <class Basis>
 void
 QuadSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(points_[faces_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3011,13 +3065,8 @@ QuadSurfMesh<Basis>::compute_node_grid()
     b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    typename Node::size_type nsz;  size(nsz);
+    node_grid_->fill_points(nsz, [this](index_type n) { return points_[n]; });
   }
 
   synchronize_lock_.lock();
@@ -3048,13 +3097,7 @@ QuadSurfMesh<Basis>::compute_elem_grid()
     b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->fill_boxes(esz, [this](index_type ci) { return elem_grid_bbox(ci); });
   }
 
   synchronize_lock_.lock();
@@ -3063,6 +3106,18 @@ QuadSurfMesh<Basis>::compute_elem_grid()
 }
 
 
+template <class Basis>
+void
+QuadSurfMesh<Basis>::compute_surface_bvh()
+{
+  bvh_.reset(new SurfaceBVH(points_, faces_, 4));
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::SURFACE_BVH_E;
+  synchronize_lock_.unlock();
+}
+
+
 template <class Basis>
 void
 QuadSurfMesh<Basis>::compute_bounding_box()
@@ -0,0 +1,455 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+///
+///@file   SortedTopologyTable.h
+///@brief  Sort based construction of the shared edge and face tables of
+///        the unstructured meshes.
+///
+/// The unstructured meshes identify an edge or a face by the tuple of nodes
+/// that spans it (PEdgeNode, PFaceNode). Instead of inserting every
+/// element edge/face into a hash map, the element records are bucketed on
+/// the first node of their key with a parallel counting sort and every
+/// bucket is sorted on its own. Equivalent keys then form contiguous runs,
+/// which become the edges/faces of the mesh. The same bucket layout is
+/// kept as a flat lookup table from a node tuple to the edge/face index.
+///
+/// A KEY type must provide nodes_[0] (equal for equivalent keys) and a
+/// strict weak ordering through operator<.
+///
+
+#ifndef CORE_DATATYPES_SORTEDTOPOLOGYTABLE_H
+#define CORE_DATATYPES_SORTEDTOPOLOGYTABLE_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <algorithm>
+#include <vector>
+#include <map>
+
+namespace SCIRun {
+
+/// One element edge or face: its node key and the combined
+/// (element, local index) value that the mesh stores for it.
+template <class KEY>
+struct TopologyRecord
+{
+  TopologyRecord() : item_(0) {}
+  TopologyRecord(const KEY& key, index_type item) : key_(key), item_(item) {}
+
+  KEY        key_;
+  index_type item_;
+
+  /// Records sort on their key first; within a key the items are kept in
+  /// ascending order, so the element with the lowest index comes first.
+  bool operator<(const TopologyRecord& r) const
+  {
+    if (key_ < r.key_) return (true);
+    if (r.key_ < key_) return (false);
+    return (item_ < r.item_);
+  }
+};
+
+/// Key of an edge spanned by two nodes, stored in ascending order, for
+/// meshes that do not define their own edge key.
+struct TopologyEdgeKey
+{
+  TopologyEdgeKey() { nodes_[0] = nodes_[1] = -1; }
+  TopologyEdgeKey(index_type n1, index_type n2)
+  {
+    nodes_[0] = std::min(n1, n2);
+    nodes_[1] = std::max(n1, n2);
+  }
+
+  bool operator<(const TopologyEdgeKey& e) const
+  {
+    return (nodes_[0] < e.nodes_[0] || (nodes_[0] == e.nodes_[0] && nodes_[1] < e.nodes_[1]));
+  }
+
+  index_type nodes_[2];
+};
+
+namespace detail {
+
+  /// Grain used for the parallel passes over nodes and records.
+  inline size_t topology_grain(size_t n)
+  {
+    return std::max<size_t>(1024, n / (16 * Core::Thread::Parallel::NumCores() + 1));
+  }
+
+  /// Exclusive prefix sum of counts into offsets (counts.size() + 1 entries).
+  inline void prefix_offsets(const boost::scoped_array<boost::atomic<index_type> >& counts,
+                             size_t n, std::vector<index_type>& offsets)
+  {
+    offsets.resize(n + 1);
+    index_type sum = 0;
+    for (size_t j = 0; j < n; ++j)
+    {
+      offsets[j] = sum;
+      sum += counts[j].load(boost::memory_order_relaxed);
+    }
+    offsets[n] = sum;
+  }
+
+  template <class KEY>
+  struct CountBuckets
+  {
+    const std::vector<TopologyRecord<KEY> >* records_;
+    boost::atomic<index_type>* counts_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t i = r.begin; i < r.end; ++i)
+        counts_[(*records_)[i].key_.nodes_[0]].fetch_add(1, boost::memory_order_relaxed);
+    }
+  };
+
+  template <class KEY>
+  struct ScatterBuckets
+  {
+    const std::vector<TopologyRecord<KEY> >* records_;
+    std::vector<TopologyRecord<KEY> >* sorted_;
+    boost::atomic<index_type>* cursor_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t i = r.begin; i < r.end; ++i)
+      {
+        const TopologyRecord<KEY>& rec = (*records_)[i];
+        (*sorted_)[cursor_[rec.key_.nodes_[0]].fetch_add(1, boost::memory_order_relaxed)] = rec;
+      }
+    }
+  };
+
+  template <class KEY>
+  struct SortBuckets
+  {
+    std::vector<TopologyRecord<KEY> >* sorted_;
+    const std::vector<index_type>* offsets_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t j = r.begin; j < r.end; ++j)
+      {
+        const index_type b = (*offsets_)[j], e = (*offsets_)[j + 1];
+        if (e - b > 1) std::sort(sorted_->begin() + b, sorted_->begin() + e);
+      }
+    }
+  };
+
+  template <class KEY>
+  struct CountRuns
+  {
+    const std::vector<TopologyRecord<KEY> >* records_;
+    const std::vector<index_type>* offsets_;
+    boost::atomic<index_type>* runs_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t j = r.begin; j < r.end; ++j)
+      {
+        index_type count = 0;
+        const index_type b = (*offsets_)[j], e = (*offsets_)[j + 1];
+        for (index_type i = b; i < e; ++i)
+          if (i == b || (*records_)[i - 1].key_ < (*records_)[i].key_) ++count;
+        runs_[j].store(count, boost::memory_order_relaxed);
+      }
+    }
+  };
+
+  template <class KEY>
+  struct FillRuns
+  {
+    const std::vector<TopologyRecord<KEY> >* records_;
+    const std::vector<index_type>* offsets_;
+    const std::vector<index_type>* node_groups_;
+    std::vector<index_type>* groups_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t j = r.begin; j < r.end; ++j)
+      {
+        index_type g = (*node_groups_)[j];
+        const index_type b = (*offsets_)[j], e = (*offsets_)[j + 1];
+        for (index_type i = b; i < e; ++i)
+          if (i == b || (*records_)[i - 1].key_ < (*records_)[i].key_) (*groups_)[g++] = i;
+      }
+    }
+  };
+
+  struct CountNodes
+  {
+    const index_type* nodes_;
+    boost::atomic<index_type>* counts_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t i = r.begin; i < r.end; ++i)
+        counts_[nodes_[i]].fetch_add(1, boost::memory_order_relaxed);
+    }
+  };
+
+  struct ScatterNodes
+  {
+    const index_type* nodes_;
+    boost::atomic<index_type>* cursor_;
+    std::vector<index_type>* items_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t i = r.begin; i < r.end; ++i)
+        (*items_)[cursor_[nodes_[i]].fetch_add(1, boost::memory_order_relaxed)] = static_cast<index_type>(i);
+    }
+  };
+
+  struct SortRows
+  {
+    const std::vector<index_type>* offsets_;
+    std::vector<index_type>* items_;
+    void operator()(const Core::Thread::IndexRange& r) const
+    {
+      for (size_t j = r.begin; j < r.end; ++j)
+        std::sort(items_->begin() + (*offsets_)[j], items_->begin() + (*offsets_)[j + 1]);
+    }
+  };
+
+} // namespace detail
+
+/// Sorts records so that equivalent keys become adjacent. Records are
+/// bucketed on key_.nodes_[0] (which must lie in [0, num_nodes)) and the
+/// buckets are sorted in parallel. On return node_offsets holds the
+/// num_nodes + 1 bucket offsets. The result does not depend on the number
+/// of threads used.
+template <class KEY>
+void sort_topology_records(std::vector<TopologyRecord<KEY> >& records,
+                           size_type num_nodes,
+                           std::vector<index_type>& node_offsets)
+{
+  using namespace Core::Thread;
+  const size_t n = records.size();
+  const size_t nn = static_cast<size_t>(num_nodes);
+
+  boost::scoped_array<boost::atomic<index_type> > counts(new boost::atomic<index_type>[nn]);
+  for (size_t j = 0; j < nn; ++j) counts[j].store(0, boost::memory_order_relaxed);
+
+  detail::CountBuckets<KEY> count = { &records, counts.get() };
+  Parallel::For(IndexRange(0, n), detail::topology_grain(n), count);
+  detail::prefix_offsets(counts, nn, node_offsets);
+
+  for (size_t j = 0; j < nn; ++j) counts[j].store(node_offsets[j], boost::memory_order_relaxed);
+  std::vector<TopologyRecord<KEY> > sorted(n);
+  detail::ScatterBuckets<KEY> scatter = { &records, &sorted, counts.get() };
+  Parallel::For(IndexRange(0, n), detail::topology_grain(n), scatter);
+
+  detail::SortBuckets<KEY> sort = { &sorted, &node_offsets };
+  Parallel::For(IndexRange(0, nn), detail::topology_grain(nn), sort);
+
+  records.swap(sorted);
+}
+
+/// Finds the runs of equivalent keys in records sorted by
+/// sort_topology_records. group_offsets receives the start of every run
+/// followed by records.size(), so run g covers records
+/// [group_offsets[g], group_offsets[g+1]). node_groups receives, for every
+/// node, the index of the first run whose key starts with that node
+/// (num_nodes + 1 entries). Returns the number of runs.
+template <class KEY>
+size_type group_topology_records(const std::vector<TopologyRecord<KEY> >& records,
+                                 const std::vector<index_type>& node_offsets,
+                                 std::vector<index_type>& group_offsets,
+                                 std::vector<index_type>& node_groups)
+{
+  using namespace Core::Thread;
+  const size_t nn = node_offsets.size() - 1;
+
+  boost::scoped_array<boost::atomic<index_type> > runs(new boost::atomic<index_type>[nn]);
+  detail::CountRuns<KEY> count = { &records, &node_offsets, runs.get() };
+  Parallel::For(IndexRange(0, nn), detail::topology_grain(nn), count);
+  detail::prefix_offsets(runs, nn, node_groups);
+
+  const index_type num_groups = node_groups[nn];
+  group_offsets.resize(num_groups + 1);
+  group_offsets[num_groups] = static_cast<index_type>(records.size());
+  detail::FillRuns<KEY> fill = { &records, &node_offsets, &node_groups, &group_offsets };
+  Parallel::For(IndexRange(0, nn), detail::topology_grain(nn), fill);
+
+  return (num_groups);
+}
+
+/// Builds the node to element-slot adjacency of a flat connectivity array
+/// (the cells_/faces_ array of a mesh) in compressed row form: row v lists,
+/// in ascending order, every position i with connectivity[i] == v.
+inline void build_node_adjacency(const std::vector<index_type>& connectivity,
+                                 size_type num_nodes,
+                                 std::vector<index_type>& offsets,
+                                 std::vector<index_type>& items)
+{
+  using namespace Core::Thread;
+  const size_t n = connectivity.size();
+  const size_t nn = static_cast<size_t>(num_nodes);
+  const index_type* nodes = n ? &connectivity[0] : 0;
+
+  boost::scoped_array<boost::atomic<index_type> > counts(new boost::atomic<index_type>[nn]);
+  for (size_t j = 0; j < nn; ++j) counts[j].store(0, boost::memory_order_relaxed);
+
+  detail::CountNodes count = { nodes, counts.get() };
+  Parallel::For(IndexRange(0, n), detail::topology_grain(n), count);
+  detail::prefix_offsets(counts, nn, offsets);
+
+  for (size_t j = 0; j < nn; ++j) counts[j].store(offsets[j], boost::memory_order_relaxed);
+  items.resize(n);
+  detail::ScatterNodes scatter = { nodes, counts.get(), &items };
+  Parallel::For(IndexRange(0, n), detail::topology_grain(n), scatter);
+
+  detail::SortRows sort = { &offsets, &items };
+  Parallel::For(IndexRange(0, nn), detail::topology_grain(nn), sort);
+}
+
+/// Lookup table from a node tuple to the index of the edge or face it
+/// describes. It offers the part of the map interface the meshes use
+/// (find, end, operator[], erase, clear). Entries produced by assign() live
+/// in one flat array that is bucketed on key.nodes_[0] and sorted within a
+/// bucket, so a lookup is a short binary search. Entries that are added
+/// later, when elements are inserted into a synchronized mesh, are kept in
+/// a small ordered map next to it.
+template <class KEY, class VALUE = index_type>
+class SortedTopologyTable
+{
+public:
+  typedef std::pair<KEY, VALUE> value_type;
+  typedef value_type*           iterator;
+  typedef const value_type*     const_iterator;
+
+  SortedTopologyTable() : num_erased_(0) {}
+
+  /// Fills the table with one entry per run of sorted records, mapping the
+  /// key of run g to value g. The arguments are the outputs of
+  /// sort_topology_records and group_topology_records; node_groups is
+  /// taken over by the table.
+  void assign(const std::vector<TopologyRecord<KEY> >& records,
+              const std::vector<index_type>& group_offsets,
+              std::vector<index_type>& node_groups)
+  {
+    clear();
+    const size_t num_groups = group_offsets.empty() ? 0 : group_offsets.size() - 1;
+    entries_.resize(num_groups);
+    for (size_t g = 0; g < num_groups; ++g)
+      entries_[g] = value_type(records[group_offsets[g]].key_, static_cast<VALUE>(g));
+    offsets_.swap(node_groups);
+  }
+
+  iterator find(const KEY& key)
+  {
+    return const_cast<iterator>(static_cast<const SortedTopologyTable*>(this)->find(key));
+  }
+
+  const_iterator find(const KEY& key) const
+  {
+    const index_type n = key.nodes_[0];
+    if (n >= 0 && n + 1 < static_cast<index_type>(offsets_.size()))
+    {
+      const value_type* b = entries_.empty() ? 0 : &entries_[0] + offsets_[n];
+      const value_type* e = entries_.empty() ? 0 : &entries_[0] + offsets_[n + 1];
+      const value_type* it = std::lower_bound(b, e, key, EntryLess());
+      if (it != e && !(key < it->first))
+      {
+        if (erased_.empty() || !erased_[it - &entries_[0]]) return (it);
+      }
+    }
+    if (!overflow_.empty())
+    {
+      typename overflow_type::const_iterator it = overflow_.find(key);
+      if (it != overflow_.end()) return (&(it->second));
+    }
+    return (0);
+  }
+
+  iterator end() { return (0); }
+  const_iterator end() const { return (0); }
+
+  /// Returns the value stored for key, inserting it if needed.
+  VALUE& operator[](const KEY& key)
+  {
+    const index_type n = key.nodes_[0];
+    if (n >= 0 && n + 1 < static_cast<index_type>(offsets_.size()))
+    {
+      value_type* b = entries_.empty() ? 0 : &entries_[0] + offsets_[n];
+      value_type* e = entries_.empty() ? 0 : &entries_[0] + offsets_[n + 1];
+      value_type* it = std::lower_bound(b, e, key, EntryLess());
+      if (it != e && !(key < it->first))
+      {
+        const size_t pos = it - &entries_[0];
+        if (!erased_.empty() && erased_[pos]) { erased_[pos] = 0; --num_erased_; }
+        return (it->second);
+      }
+    }
+    typename overflow_type::iterator it = overflow_.find(key);
+    if (it == overflow_.end())
+      it = overflow_.insert(std::make_pair(key, value_type(key, VALUE()))).first;
+    return (it->second.second);
+  }
+
+  void erase(iterator it)
+  {
+    if (!entries_.empty() && it >= &entries_[0] && it < &entries_[0] + entries_.size())
+    {
+      if (erased_.empty()) erased_.resize(entries_.size(), 0);
+      const size_t pos = it - &entries_[0];
+      if (!erased_[pos]) { erased_[pos] = 1; ++num_erased_; }
+    }
+    else if (it)
+    {
+      overflow_.erase(it->first);
+    }
+  }
+
+  void clear()
+  {
+    std::vector<value_type>().swap(entries_);
+    std::vector<index_type>().swap(offsets_);
+    std::vector<char>().swap(erased_);
+    overflow_.clear();
+    num_erased_ = 0;
+  }
+
+  size_t size() const { return (entries_.size() - num_erased_ + overflow_.size()); }
+  bool empty() const { return (size() == 0); }
+
+private:
+  struct EntryLess
+  {
+    bool operator()(const value_type& a, const KEY& b) const { return (a.first < b); }
+  };
+
+  typedef std::map<KEY, value_type> overflow_type;
+
+  std::vector<value_type> entries_;
+  std::vector<index_type> offsets_;
+  std::vector<char>       erased_;
+  size_t                  num_erased_;
+  overflow_type           overflow_;
+};
+
+} // end namespace SCIRun
+
+#endif
@@ -0,0 +1,477 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <utility>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const index_type LEAF_SIZE = 4;
+  const int MAX_DEPTH = 128;
+
+  inline double component(const Point& p, int axis)
+  {
+    return axis == 0 ? p.x() : (axis == 1 ? p.y() : p.z());
+  }
+
+  inline double component(const Vector& v, int axis)
+  {
+    return axis == 0 ? v.x() : (axis == 1 ? v.y() : v.z());
+  }
+
+  /// Closest point on triangle abc to p (Ericson, Real-Time Collision
+  /// Detection, 5.1.5). Degenerate triangles fall into an edge or vertex region.
+  Point closest_point_on_triangle(const Point& p, const Point& a, const Point& b, const Point& c)
+  {
+    const Vector ab = b - a;
+    const Vector ac = c - a;
+    const Vector ap = p - a;
+    const double d1 = Dot(ab, ap);
+    const double d2 = Dot(ac, ap);
+    if (d1 <= 0.0 && d2 <= 0.0) return a;
+
+    const Vector bp = p - b;
+    const double d3 = Dot(ab, bp);
+    const double d4 = Dot(ac, bp);
+    if (d3 >= 0.0 && d4 <= d3) return b;
+
+    const double vc = d1*d4 - d3*d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+      return a + ab * (d1 / (d1 - d3));
+
+    const Vector cp = p - c;
+    const double d5 = Dot(ab, cp);
+    const double d6 = Dot(ac, cp);
+    if (d6 >= 0.0 && d5 <= d6) return c;
+
+    const double vb = d5*d2 - d1*d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+      return a + ac * (d2 / (d2 - d6));
+
+    const double va = d3*d6 - d5*d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+      return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const double denom = 1.0 / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+  }
+
+  /// Squared distance from p to an axis aligned box, zero inside.
+  inline double box_distance2(const double* bmin, const double* bmax, const Point& p)
+  {
+    double d2 = 0.0;
+    for (int k = 0; k < 3; ++k)
+    {
+      const double x = component(p, k);
+      if (x < bmin[k]) d2 += (bmin[k] - x) * (bmin[k] - x);
+      else if (x > bmax[k]) d2 += (x - bmax[k]) * (x - bmax[k]);
+    }
+    return d2;
+  }
+
+  /// Does the ray p + t*dir, t >= 0, hit the box?
+  inline bool ray_hits_box(const double* bmin, const double* bmax, const Point& p, const double* inv)
+  {
+    double tmin = 0.0, tmax = DBL_MAX;
+    for (int k = 0; k < 3; ++k)
+    {
+      double t0 = (bmin[k] - component(p, k)) * inv[k];
+      double t1 = (bmax[k] - component(p, k)) * inv[k];
+      if (t0 > t1) std::swap(t0, t1);
+      tmin = std::max(tmin, t0);
+      tmax = std::min(tmax, t1);
+      if (tmax < tmin) return false;
+    }
+    return true;
+  }
+
+  /// Moller-Trumbore; counts hits strictly in front of p.
+  inline bool ray_hits_triangle(const Point& p, const Vector& dir, const Point& a, const Point& b, const Point& c)
+  {
+    const Vector e1 = b - a;
+    const Vector e2 = c - a;
+    const Vector h = Cross(dir, e2);
+    const double det = Dot(e1, h);
+    if (std::abs(det) < 1e-300) return false;
+    const double f = 1.0 / det;
+    const Vector s = p - a;
+    const double u = f * Dot(s, h);
+    if (u < 0.0 || u > 1.0) return false;
+    const Vector q = Cross(s, e1);
+    const double v = f * Dot(dir, q);
+    if (v < 0.0 || u + v > 1.0) return false;
+    return f * Dot(e2, q) > 0.0;
+  }
+}
+
+SurfaceBVH::SurfaceBVH(const std::vector<Point>& points, const std::vector<index_type>& faces, int nodes_per_face) :
+  closed_(false), volume_(0.0)
+{
+  const size_type num_faces = static_cast<size_type>(faces.size()) / nodes_per_face;
+  triangles_.reserve(num_faces * (nodes_per_face - 2));
+
+  std::vector<std::pair<index_type, index_type> > edges;
+  edges.reserve(3 * num_faces * (nodes_per_face - 2));
+
+  for (index_type f = 0; f < num_faces; ++f)
+  {
+    const index_type* nodes = &faces[f * nodes_per_face];
+    for (int k = 1; k + 1 < nodes_per_face; ++k)
+    {
+      const index_type n0 = nodes[0], n1 = nodes[k], n2 = nodes[k + 1];
+      if (n0 == n1 || n1 == n2 || n0 == n2) continue;
+
+      Triangle tri = { points[n0], points[n1], points[n2], f };
+      triangles_.push_back(tri);
+      volume_ += Dot(Vector(tri.a), Cross(Vector(tri.b), Vector(tri.c))) / 6.0;
+
+      edges.push_back(std::make_pair(std::min(n0, n1), std::max(n0, n1)));
+      edges.push_back(std::make_pair(std::min(n1, n2), std::max(n1, n2)));
+      edges.push_back(std::make_pair(std::min(n2, n0), std::max(n2, n0)));
+    }
+  }
+
+  if (triangles_.empty())
+    return;
+
+  std::sort(edges.begin(), edges.end());
+  closed_ = true;
+  for (size_t e = 0; e < edges.size() && closed_; e += 2)
+  {
+    closed_ = e + 1 < edges.size() && edges[e] == edges[e + 1] &&
+      (e + 2 == edges.size() || edges[e + 2] != edges[e]);
+  }
+
+  nodes_.reserve(2 * triangles_.size() / LEAF_SIZE + 1);
+  build(0, static_cast<index_type>(triangles_.size()));
+}
+
+void
+SurfaceBVH::summarize(Node& node, index_type first, index_type last) const
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    node.bmin[k] = DBL_MAX;
+    node.bmax[k] = -DBL_MAX;
+  }
+
+  Vector weighted(0.0, 0.0, 0.0);
+  double total = 0.0;
+  node.area = Vector(0.0, 0.0, 0.0);
+
+  for (index_type t = first; t < last; ++t)
+  {
+    const Triangle& tri = triangles_[t];
+    for (const Point* v : { &tri.a, &tri.b, &tri.c })
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        node.bmin[k] = std::min(node.bmin[k], component(*v, k));
+        node.bmax[k] = std::max(node.bmax[k], component(*v, k));
+      }
+    }
+    const Vector area = Cross(tri.b - tri.a, tri.c - tri.a) * 0.5;
+    const double a = area.length();
+    node.area += area;
+    weighted += (Vector(tri.a) + Vector(tri.b) + Vector(tri.c)) * (a / 3.0);
+    total += a;
+  }
+
+  if (total > 0.0)
+    node.center = Point(weighted / total);
+  else
+    node.center = Point(0.5 * (node.bmin[0] + node.bmax[0]), 0.5 * (node.bmin[1] + node.bmax[1]), 0.5 * (node.bmin[2] + node.bmax[2]));
+
+  double radius2 = 0.0;
+  for (index_type t = first; t < last; ++t)
+  {
+    const Triangle& tri = triangles_[t];
+    radius2 = std::max(radius2, (tri.a - node.center).length2());
+    radius2 = std::max(radius2, (tri.b - node.center).length2());
+    radius2 = std::max(radius2, (tri.c - node.center).length2());
+  }
+  node.radius = std::sqrt(radius2);
+}
+
+index_type
+SurfaceBVH::build(index_type first, index_type last)
+{
+  const index_type idx = static_cast<index_type>(nodes_.size());
+  nodes_.push_back(Node());
+  summarize(nodes_[idx], first, last);
+  nodes_[idx].first = first;
+  nodes_[idx].count = last - first;
+
+  if (last - first <= LEAF_SIZE)
+    return idx;
+
+  // Split at the median centroid along the longest axis of the box
+  const Node& node = nodes_[idx];
+  int axis = 0;
+  for (int k = 1; k < 3; ++k)
+  {
+    if (node.bmax[k] - node.bmin[k] > node.bmax[axis] - node.bmin[axis])
+      axis = k;
+  }
+
+  const index_type mid = first + (last - first) / 2;
+  std::nth_element(triangles_.begin() + first, triangles_.begin() + mid, triangles_.begin() + last,
+    [axis](const Triangle& t1, const Triangle& t2)
+    {
+      return component(t1.a, axis) + component(t1.b, axis) + component(t1.c, axis) <
+             component(t2.a, axis) + component(t2.b, axis) + component(t2.c, axis);
+    });
+
+  build(first, mid);
+  const index_type right = build(mid, last);
+  nodes_[idx].first = right;
+  nodes_[idx].count = 0;
+  return idx;
+}
+
+bool
+SurfaceBVH::find_closest_elem(double& dist, Point& result, index_type& elem, const Point& p, double maxdist) const
+{
+  if (nodes_.empty())
+    return false;
+
+  double best = (maxdist < std::sqrt(DBL_MAX)) ? maxdist * maxdist : DBL_MAX;
+  bool found = false;
+
+  index_type stack[MAX_DEPTH];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const index_type idx = stack[--top];
+    const Node& node = nodes_[idx];
+    if (box_distance2(node.bmin, node.bmax, p) >= best)
+      continue;
+
+    if (node.count > 0)
+    {
+      for (index_type t = node.first; t < node.first + node.count; ++t)
+      {
+        const Triangle& tri = triangles_[t];
+        const Point r = closest_point_on_triangle(p, tri.a, tri.b, tri.c);
+        const double d2 = (p - r).length2();
+        if (d2 < best)
+        {
+          best = d2;
+          result = r;
+          elem = tri.elem;
+          found = true;
+        }
+      }
+    }
+    else
+    {
+      // Visit the nearer child first so that it tightens the bound
+      const index_type left = idx + 1;
+      const index_type right = node.first;
+      const double dleft = box_distance2(nodes_[left].bmin, nodes_[left].bmax, p);
+      const double dright = box_distance2(nodes_[right].bmin, nodes_[right].bmax, p);
+      if (dleft < dright)
+      {
+        stack[top++] = right;
+        stack[top++] = left;
+      }
+      else
+      {
+        stack[top++] = left;
+        stack[top++] = right;
+      }
+    }
+  }
+
+  if (found)
+    dist = std::sqrt(best);
+  return found;
+}
+
+void
+SurfaceBVH::find_closest_elems(std::vector<double>& dist, std::vector<Point>& result, std::vector<index_type>& elems,
+  const std::vector<Point>& points, double maxdist) const
+{
+  dist.resize(points.size());
+  result.resize(points.size());
+  elems.resize(points.size());
+
+  Parallel::For(IndexRange(0, points.size()), 0, [&](const IndexRange& range)
+  {
+    for (size_t i = range.begin; i < range.end; ++i)
+    {
+      if (!find_closest_elem(dist[i], result[i], elems[i], points[i], maxdist))
+      {
+        dist[i] = maxdist;
+        elems[i] = -1;
+      }
+    }
+  });
+}
+
+int
+SurfaceBVH::count_crossings(const Point& p, const Vector& dir) const
+{
+  double inv[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    const double d = component(dir, k);
+    inv[k] = d != 0.0 ? 1.0 / d : DBL_MAX;
+  }
+
+  int crossings = 0;
+  index_type stack[MAX_DEPTH];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const index_type idx = stack[--top];
+    const Node& node = nodes_[idx];
+    if (!ray_hits_box(node.bmin, node.bmax, p, inv))
+      continue;
+
+    if (node.count > 0)
+    {
+      for (index_type t = node.first; t < node.first + node.count; ++t)
+      {
+        const Triangle& tri = triangles_[t];
+        if (ray_hits_triangle(p, dir, tri.a, tri.b, tri.c))
+          ++crossings;
+      }
+    }
+    else
+    {
+      stack[top++] = node.first;
+      stack[top++] = idx + 1;
+    }
+  }
+  return crossings;
+}
+
+bool
+SurfaceBVH::is_inside_parity(const Point& p) const
+{
+  if (nodes_.empty())
+    return false;
+
+  // Directions away from the axes and from each other, so that a ray
+  // grazing an edge in one direction is outvoted by the other two
+  static const Vector directions[3] =
+  {
+    Vector(0.9283, 0.3452, 0.1381),
+    Vector(-0.2113, 0.9152, 0.3431),
+    Vector(0.1844, -0.3267, 0.9270)
+  };
+
+  int votes = 0;
+  for (const auto& dir : directions)
+  {
+    if (count_crossings(p, dir) % 2 == 1)
+      ++votes;
+  }
+  return votes >= 2;
+}
+
+double
+SurfaceBVH::leaf_solid_angle(const Node& node, const Point& p) const
+{
+  // Van Oosterom and Strackee, IEEE Trans. Biomed. Eng. 30(2), 1983
+  double omega = 0.0;
+  for (index_type t = node.first; t < node.first + node.count; ++t)
+  {
+    const Triangle& tri = triangles_[t];
+    const Vector a = tri.a - p;
+    const Vector b = tri.b - p;
+    const Vector c = tri.c - p;
+    const double la = a.length();
+    const double lb = b.length();
+    const double lc = c.length();
+    const double det = Dot(a, Cross(b, c));
+    const double div = la*lb*lc + Dot(a, b)*lc + Dot(a, c)*lb + Dot(b, c)*la;
+    omega += 2.0 * std::atan2(det, div);
+  }
+  return omega;
+}
+
+double
+SurfaceBVH::winding_number(const Point& p, double beta) const
+{
+  if (nodes_.empty())
+    return 0.0;
+
+  double omega = 0.0;
+  index_type stack[MAX_DEPTH];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const index_type idx = stack[--top];
+    const Node& node = nodes_[idx];
+    const Vector d = node.center - p;
+    const double r2 = d.length2();
+
+    if (r2 > beta * beta * node.radius * node.radius)
+    {
+      // Dipole approximation of the subtree's solid angle
+      omega += Dot(node.area, d) / (r2 * std::sqrt(r2));
+    }
+    else if (node.count > 0)
+    {
+      omega += leaf_solid_angle(node, p);
+    }
+    else
+    {
+      stack[top++] = node.first;
+      stack[top++] = idx + 1;
+    }
+  }
+  return omega / (4.0 * M_PI);
+}
+
+void
+SurfaceBVH::is_inside(std::vector<char>& inside, const std::vector<Point>& points) const
+{
+  inside.resize(points.size());
+  Parallel::For(IndexRange(0, points.size()), 0, [&](const IndexRange& range)
+  {
+    for (size_t i = range.begin; i < range.end; ++i)
+      inside[i] = is_inside(points[i]) ? 1 : 0;
+  });
+}
@@ -0,0 +1,147 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_LEGACY_FIELD_SURFACEBVH_H
+#define CORE_DATATYPES_LEGACY_FIELD_SURFACEBVH_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/PointF.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <boost/shared_ptr.hpp>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include <Core/Datatypes/Legacy/Field/share.h>
+
+namespace SCIRun {
+
+/// Bounding volume hierarchy over the faces of a triangle or quadrilateral
+/// surface. Quads are split into two triangles along their 0-2 diagonal.
+/// The tree is immutable once built, so all queries may run concurrently.
+///
+/// Besides closest-point queries it answers inside/outside questions for
+/// closed surfaces, either by ray parity (exact for watertight meshes) or by
+/// the generalized winding number, which tolerates small holes and
+/// self-intersections. Winding numbers of distant subtrees are evaluated
+/// from their area-weighted normal (a dipole), so queries far from the
+/// surface cost a handful of node visits.
+class SCISHARE SurfaceBVH
+{
+  public:
+    /// faces holds nodes_per_face (3 or 4) node indices per face.
+    SurfaceBVH(const std::vector<Core::Geometry::Point>& points,
+               const std::vector<index_type>& faces, int nodes_per_face);
+    /// Meshes with single precision nodes are converted on construction;
+    /// the tree itself always stores double precision triangles.
+    SurfaceBVH(const std::vector<Core::Geometry::PointF>& points,
+               const std::vector<index_type>& faces, int nodes_per_face) :
+      SurfaceBVH(std::vector<Core::Geometry::Point>(points.begin(), points.end()), faces, nodes_per_face) {}
+
+    size_type num_triangles() const { return static_cast<size_type>(triangles_.size()); }
+
+    /// True if every triangle edge is shared by exactly two triangles.
+    bool is_closed() const { return closed_; }
+
+    /// Enclosed volume, positive for outward and negative for inward facing
+    /// normals. Only meaningful for closed surfaces.
+    double signed_volume() const { return volume_; }
+
+    /// Closest point on the surface. Returns false if no face is closer
+    /// than maxdist.
+    bool find_closest_elem(double& dist, Core::Geometry::Point& result,
+                           index_type& elem, const Core::Geometry::Point& p,
+                           double maxdist = DBL_MAX) const;
+
+    /// Batched version of find_closest_elem over all points in parallel.
+    /// Points without a face closer than maxdist get dist = maxdist and
+    /// elem = -1.
+    void find_closest_elems(std::vector<double>& dist,
+                            std::vector<Core::Geometry::Point>& result,
+                            std::vector<index_type>& elems,
+                            const std::vector<Core::Geometry::Point>& points,
+                            double maxdist = DBL_MAX) const;
+
+    /// Parity of the crossings of three rays in different directions,
+    /// decided by majority vote.
+    bool is_inside_parity(const Core::Geometry::Point& p) const;
+
+    /// Generalized winding number: close to +1 inside a closed surface with
+    /// outward normals, -1 with inward normals and 0 outside. beta controls
+    /// the far field: a subtree is approximated when it is more than beta
+    /// times its radius away.
+    double winding_number(const Core::Geometry::Point& p, double beta = 2.0) const;
+
+    bool is_inside(const Core::Geometry::Point& p) const
+      { return std::abs(winding_number(p)) > 0.5; }
+
+    /// Batched inside test (winding number) over all points in parallel.
+    void is_inside(std::vector<char>& inside,
+                   const std::vector<Core::Geometry::Point>& points) const;
+
+  private:
+    struct Triangle
+    {
+      Core::Geometry::Point a, b, c;
+      index_type elem;
+    };
+
+    struct Node
+    {
+      double bmin[3], bmax[3];
+      /// Leaves: [first, first+count) in triangles_. Inner nodes have
+      /// count == 0, the left child directly after them and the right child
+      /// at first.
+      index_type first;
+      index_type count;
+      /// Sum of the triangle area vectors, their area-weighted centroid and
+      /// the radius of the sphere around it containing the subtree.
+      Core::Geometry::Vector area;
+      Core::Geometry::Point center;
+      double radius;
+    };
+
+    index_type build(index_type first, index_type last);
+    void summarize(Node& node, index_type first, index_type last) const;
+    double leaf_solid_angle(const Node& node, const Core::Geometry::Point& p) const;
+    int count_crossings(const Core::Geometry::Point& p, const Core::Geometry::Vector& dir) const;
+
+    std::vector<Triangle> triangles_;
+    std::vector<Node> nodes_;
+    bool closed_;
+    double volume_;
+};
+
+typedef boost::shared_ptr<SurfaceBVH> SurfaceBVHHandle;
+
+} // end namespace SCIRun
+
+#endif
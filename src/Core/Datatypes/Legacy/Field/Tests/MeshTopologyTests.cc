@@ -0,0 +1,244 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  typedef std::vector<index_type> NodeKey;
+  typedef std::set<index_type> IndexSet;
+
+  // Edges and faces of one element as local node numbers.
+  struct ElementShape
+  {
+    std::vector<std::vector<int> > edges;
+    std::vector<std::vector<int> > faces;
+    // Prisms list the nodes sharing an edge as neighbors, the other meshes
+    // list every node sharing an element.
+    bool nodeNeighborsShareAnEdge;
+  };
+
+  NodeKey key(const VMesh::Node::array_type& nodes, const std::vector<int>& local)
+  {
+    NodeKey k;
+    for (auto i : local)
+      k.push_back(nodes[i]);
+    std::sort(k.begin(), k.end());
+    return k;
+  }
+
+  template <class ARRAY>
+  IndexSet asSet(const ARRAY& array)
+  {
+    IndexSet s(array.begin(), array.end());
+    EXPECT_EQ(array.size(), s.size()) << "repeated entries";
+    return s;
+  }
+
+  // Compares the edge, face and neighbor tables the mesh builds with the
+  // ones that follow from the element connectivity.
+  void checkTopology(VMesh* mesh, const ElementShape& shape, size_t expectedEdges, size_t expectedFaces)
+  {
+    mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::ELEM_NEIGHBORS_E | Mesh::NODE_NEIGHBORS_E);
+    const bool isVolume = mesh->dimensionality() == 3;
+
+    VMesh::Node::size_type numNodes;
+    VMesh::Elem::size_type numElems;
+    mesh->size(numNodes);
+    mesh->size(numElems);
+
+    std::map<NodeKey, IndexSet> edgeElems, faceElems;
+    std::vector<IndexSet> nodeElems(numNodes), nodeNeighbors(numNodes), elemNeighbors(numElems);
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type e = 0; e < numElems; ++e)
+    {
+      mesh->get_nodes(nodes, e);
+      for (auto n : nodes)
+      {
+        nodeElems[n].insert(e);
+        if (!shape.nodeNeighborsShareAnEdge)
+          for (auto m : nodes)
+            if (m != n) nodeNeighbors[n].insert(m);
+      }
+      for (const auto& edge : shape.edges)
+      {
+        edgeElems[key(nodes, edge)].insert(e);
+        if (shape.nodeNeighborsShareAnEdge)
+        {
+          nodeNeighbors[nodes[edge[0]]].insert(nodes[edge[1]]);
+          nodeNeighbors[nodes[edge[1]]].insert(nodes[edge[0]]);
+        }
+      }
+      for (const auto& face : shape.faces)
+        faceElems[key(nodes, face)].insert(e);
+    }
+
+    // elements are neighbors across a face in a volume and across an edge in a surface
+    for (const auto& side : isVolume ? faceElems : edgeElems)
+      for (auto a : side.second)
+        for (auto b : side.second)
+          if (a != b) elemNeighbors[a].insert(b);
+
+    VMesh::Edge::size_type numEdges;
+    mesh->size(numEdges);
+    EXPECT_EQ(expectedEdges, edgeElems.size());
+    ASSERT_EQ(edgeElems.size(), static_cast<size_t>(numEdges));
+    std::set<NodeKey> seen;
+    VMesh::Elem::array_type elems;
+    for (VMesh::Edge::index_type e = 0; e < numEdges; ++e)
+    {
+      mesh->get_nodes(nodes, e);
+      ASSERT_EQ(2u, nodes.size());
+      auto k = key(nodes, { 0, 1 });
+      ASSERT_EQ(1u, edgeElems.count(k)) << "edge " << e;
+      EXPECT_TRUE(seen.insert(k).second) << "edge " << e << " is listed twice";
+      mesh->get_elems(elems, e);
+      EXPECT_EQ(edgeElems[k], asSet(elems)) << "edge " << e;
+    }
+
+    if (isVolume)
+    {
+      VMesh::Face::size_type numFaces;
+      mesh->size(numFaces);
+      EXPECT_EQ(expectedFaces, faceElems.size());
+      ASSERT_EQ(faceElems.size(), static_cast<size_t>(numFaces));
+      seen.clear();
+      for (VMesh::Face::index_type f = 0; f < numFaces; ++f)
+      {
+        mesh->get_nodes(nodes, f);
+        std::vector<int> all(nodes.size());
+        std::iota(all.begin(), all.end(), 0);
+        auto k = key(nodes, all);
+        ASSERT_EQ(1u, faceElems.count(k)) << "face " << f;
+        EXPECT_TRUE(seen.insert(k).second) << "face " << f << " is listed twice";
+        mesh->get_elems(elems, f);
+        EXPECT_EQ(faceElems[k], asSet(elems)) << "face " << f;
+      }
+    }
+
+    for (VMesh::Elem::index_type e = 0; e < numElems; ++e)
+    {
+      mesh->get_neighbors(elems, e);
+      EXPECT_EQ(elemNeighbors[e], asSet(elems)) << "element " << e;
+    }
+
+    for (VMesh::Node::index_type n = 0; n < numNodes; ++n)
+    {
+      mesh->get_elems(elems, n);
+      EXPECT_EQ(nodeElems[n], asSet(elems)) << "node " << n;
+      mesh->get_neighbors(nodes, n);
+      EXPECT_EQ(nodeNeighbors[n], asSet(nodes)) << "node " << n;
+    }
+  }
+
+  // Regular grid of nx x ny x nz points on the unit cube, numbered x fastest.
+  void addGridPoints(VMesh* mesh, int nx, int ny, int nz)
+  {
+    for (int k = 0; k < nz; ++k)
+      for (int j = 0; j < ny; ++j)
+        for (int i = 0; i < nx; ++i)
+          mesh->add_point(Point(i, j, k));
+  }
+
+  void addElem(VMesh* mesh, const std::vector<index_type>& nodes)
+  {
+    VMesh::Node::array_type elem(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      elem[i] = nodes[i];
+    mesh->add_elem(elem);
+  }
+}
+
+TEST(HexVolMeshTest, EdgeFaceAndNeighborTablesMatchCellConnectivity)
+{
+  // 2 x 2 x 1 hexes
+  FieldInformation fi(HEXVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+  FieldHandle field = CreateField(fi);
+  VMesh* mesh = field->vmesh();
+  addGridPoints(mesh, 3, 3, 2);
+  for (int j = 0; j < 2; ++j)
+    for (int i = 0; i < 2; ++i)
+    {
+      const index_type n = j * 3 + i;
+      addElem(mesh, { n, n + 1, n + 4, n + 3, n + 9, n + 10, n + 13, n + 12 });
+    }
+
+  ElementShape shape;
+  shape.edges = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 },
+    { 6, 7 }, { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+  shape.faces = { { 0, 1, 2, 3 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 },
+    { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+  shape.nodeNeighborsShareAnEdge = false;
+  checkTopology(mesh, shape, 33, 20);
+}
+
+TEST(PrismVolMeshTest, EdgeFaceAndNeighborTablesMatchCellConnectivity)
+{
+  // a unit square split into two triangles, extruded into two layers
+  FieldInformation fi(PRISMVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+  FieldHandle field = CreateField(fi);
+  VMesh* mesh = field->vmesh();
+  addGridPoints(mesh, 2, 2, 3);
+  for (int k = 0; k < 2; ++k)
+  {
+    const index_type n = k * 4;
+    addElem(mesh, { n, n + 1, n + 3, n + 4, n + 5, n + 7 });
+    addElem(mesh, { n, n + 3, n + 2, n + 4, n + 7, n + 6 });
+  }
+
+  ElementShape shape;
+  shape.edges = { { 0, 1 }, { 1, 2 }, { 2, 0 }, { 3, 4 }, { 4, 5 }, { 5, 3 },
+    { 0, 3 }, { 1, 4 }, { 2, 5 } };
+  shape.faces = { { 0, 1, 2 }, { 3, 4, 5 }, { 0, 1, 4, 3 }, { 1, 2, 5, 4 }, { 2, 0, 3, 5 } };
+  shape.nodeNeighborsShareAnEdge = true;
+  checkTopology(mesh, shape, 23, 16);
+}
+
+TEST(TriSurfMeshTest, EdgeAndNeighborTablesMatchFaceConnectivity)
+{
+  FieldHandle field = CubeTriSurfLinearBasis(DOUBLE_E);
+
+  ElementShape shape;
+  shape.edges = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+  shape.nodeNeighborsShareAnEdge = false;
+  checkTopology(field->vmesh(), shape, 18, 0);
+}
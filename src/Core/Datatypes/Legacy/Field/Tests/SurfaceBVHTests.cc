@@ -0,0 +1,193 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
+#include <Core/GeometryPrimitives/Point.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Unit cube [0,1]^3 with outward facing quads.
+  void unitCube(std::vector<Point>& points, std::vector<index_type>& quads)
+  {
+    points.clear();
+    for (int k = 0; k < 2; ++k)
+      for (int j = 0; j < 2; ++j)
+        for (int i = 0; i < 2; ++i)
+          points.push_back(Point(i, j, k));
+
+    const index_type q[] = {
+      0, 2, 3, 1,   // z = 0
+      4, 5, 7, 6,   // z = 1
+      0, 1, 5, 4,   // y = 0
+      2, 6, 7, 3,   // y = 1
+      0, 4, 6, 2,   // x = 0
+      1, 3, 7, 5 }; // x = 1
+    quads.assign(q, q + 24);
+  }
+
+  void splitQuads(const std::vector<index_type>& quads, std::vector<index_type>& tris)
+  {
+    tris.clear();
+    for (size_t f = 0; f < quads.size(); f += 4)
+    {
+      const index_type t[] = { quads[f], quads[f+1], quads[f+2], quads[f], quads[f+2], quads[f+3] };
+      tris.insert(tris.end(), t, t + 6);
+    }
+  }
+
+  double distanceToUnitCube(const Point& p)
+  {
+    double outside = 0.0, inside = DBL_MAX;
+    for (int d = 0; d < 3; ++d)
+    {
+      const double e = std::max(0.0, std::max(-p[d], p[d] - 1.0));
+      outside += e * e;
+      inside = std::min(inside, std::min(p[d], 1.0 - p[d]));
+    }
+    return outside > 0.0 ? std::sqrt(outside) : inside;
+  }
+
+  std::vector<Point> samplePoints()
+  {
+    std::vector<Point> points;
+    for (int k = 0; k < 7; ++k)
+      for (int j = 0; j < 7; ++j)
+        for (int i = 0; i < 7; ++i)
+          points.push_back(Point(-0.73 + 0.41 * i, -0.67 + 0.39 * j, -0.71 + 0.43 * k));
+    return points;
+  }
+
+  bool insideUnitCube(const Point& p)
+  {
+    return p.x() > 0 && p.x() < 1 && p.y() > 0 && p.y() < 1 && p.z() > 0 && p.z() < 1;
+  }
+}
+
+TEST(SurfaceBVHTests, ClosedCubeHasUnitVolume)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads;
+  unitCube(points, quads);
+
+  SurfaceBVH bvh(points, quads, 4);
+  EXPECT_EQ(12, bvh.num_triangles());
+  EXPECT_TRUE(bvh.is_closed());
+  EXPECT_NEAR(1.0, bvh.signed_volume(), 1e-12);
+}
+
+TEST(SurfaceBVHTests, OpenSurfaceIsNotClosed)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads;
+  unitCube(points, quads);
+  quads.resize(20);
+
+  SurfaceBVH bvh(points, quads, 4);
+  EXPECT_FALSE(bvh.is_closed());
+}
+
+TEST(SurfaceBVHTests, ClosestPointMatchesAnalyticDistance)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads, tris;
+  unitCube(points, quads);
+  splitQuads(quads, tris);
+
+  SurfaceBVH bvh(points, tris, 3);
+  for (const auto& p : samplePoints())
+  {
+    double dist;
+    Point closest;
+    index_type elem;
+    ASSERT_TRUE(bvh.find_closest_elem(dist, closest, elem, p));
+    EXPECT_NEAR(distanceToUnitCube(p), dist, 1e-12) << p;
+    EXPECT_NEAR(dist, (closest - p).length(), 1e-12) << p;
+    EXPECT_GE(elem, 0);
+    EXPECT_LT(elem, 12);
+  }
+}
+
+TEST(SurfaceBVHTests, ClosestPointRespectsMaximumDistance)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads;
+  unitCube(points, quads);
+
+  SurfaceBVH bvh(points, quads, 4);
+  double dist;
+  Point closest;
+  index_type elem;
+  EXPECT_FALSE(bvh.find_closest_elem(dist, closest, elem, Point(3, 0.5, 0.5), 1.0));
+  EXPECT_TRUE(bvh.find_closest_elem(dist, closest, elem, Point(3, 0.5, 0.5), 2.5));
+  EXPECT_NEAR(2.0, dist, 1e-12);
+}
+
+TEST(SurfaceBVHTests, InsideTestsAgreeWithGeometry)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads;
+  unitCube(points, quads);
+
+  SurfaceBVH bvh(points, quads, 4);
+  auto samples = samplePoints();
+  std::vector<char> inside;
+  bvh.is_inside(inside, samples);
+  ASSERT_EQ(samples.size(), inside.size());
+
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    const bool expected = insideUnitCube(samples[i]);
+    EXPECT_EQ(expected, bvh.is_inside_parity(samples[i])) << samples[i];
+    EXPECT_EQ(expected, bvh.is_inside(samples[i])) << samples[i];
+    EXPECT_EQ(expected, inside[i] != 0) << samples[i];
+    EXPECT_NEAR(expected ? 1.0 : 0.0, bvh.winding_number(samples[i]), 0.1) << samples[i];
+  }
+}
+
+TEST(SurfaceBVHTests, InwardNormalsFlipWindingNumber)
+{
+  std::vector<Point> points;
+  std::vector<index_type> quads;
+  unitCube(points, quads);
+  for (size_t f = 0; f < quads.size(); f += 4)
+    std::reverse(quads.begin() + f, quads.begin() + f + 4);
+
+  SurfaceBVH bvh(points, quads, 4);
+  EXPECT_NEAR(-1.0, bvh.signed_volume(), 1e-12);
+  EXPECT_NEAR(-1.0, bvh.winding_number(Point(0.5, 0.5, 0.5)), 1e-9);
+  EXPECT_TRUE(bvh.is_inside(Point(0.3, 0.6, 0.2)));
+  EXPECT_FALSE(bvh.is_inside(Point(1.3, 0.6, 0.2)));
+}
@@ -34,6 +34,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 
 #include <gtest/gtest.h>
+#include <map>
+#include <set>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -68,3 +70,60 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   ASSERT_EQ(c, 6);
 
 }
+
+TEST(TetVolMeshTest, EdgeAndFaceTablesMatchCellConnectivity)
+{
+  FieldHandle tetmesh = CubeTetVolLinearBasis(NONE_E);
+  VMesh* mesh = tetmesh->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::ELEM_NEIGHBORS_E);
+
+  std::set<std::pair<index_type, index_type> > edges;
+  std::map<std::vector<index_type>, int> faces;
+  VMesh::Node::array_type nodes;
+  VMesh::Elem::iterator it, eit;
+  mesh->begin(it);
+  mesh->end(eit);
+  for (; it != eit; ++it)
+  {
+    mesh->get_nodes(nodes, *it);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      for (size_t j = i + 1; j < 4; ++j)
+        edges.insert(std::make_pair(std::min(nodes[i], nodes[j]), std::max(nodes[i], nodes[j])));
+      std::vector<index_type> face;
+      for (size_t j = 0; j < 4; ++j)
+        if (j != i) face.push_back(nodes[j]);
+      std::sort(face.begin(), face.end());
+      faces[face]++;
+    }
+  }
+
+  VMesh::Edge::size_type num_edges;
+  VMesh::Face::size_type num_faces;
+  mesh->size(num_edges);
+  mesh->size(num_faces);
+  EXPECT_EQ(edges.size(), static_cast<size_t>(num_edges));
+  EXPECT_EQ(faces.size(), static_cast<size_t>(num_faces));
+
+  for (VMesh::Edge::index_type e = 0; e < num_edges; ++e)
+  {
+    mesh->get_nodes(nodes, e);
+    ASSERT_EQ(2u, nodes.size());
+    EXPECT_EQ(1u, edges.count(std::make_pair(std::min(nodes[0], nodes[1]), std::max(nodes[0], nodes[1]))));
+  }
+
+  size_t boundary = 0;
+  for (VMesh::Face::index_type f = 0; f < num_faces; ++f)
+  {
+    mesh->get_nodes(nodes, f);
+    std::vector<index_type> face(nodes.begin(), nodes.end());
+    std::sort(face.begin(), face.end());
+    ASSERT_EQ(1u, faces.count(face));
+
+    VMesh::Elem::array_type elems;
+    mesh->get_elems(elems, f);
+    EXPECT_EQ(static_cast<size_t>(faces[face]), elems.size());
+    if (elems.size() == 1) boundary++;
+  }
+  EXPECT_EQ(12u, boundary);
+}
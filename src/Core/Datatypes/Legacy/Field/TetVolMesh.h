@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
 #include <Core/Containers/StackVector.h>
+#include <Core/Containers/RaggedArray.h>
 #include <Core/Persistent/PersistentSTL.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
@@ -51,6 +52,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshPointStorage.h>
+#include <Core/Datatypes/Legacy/Field/SortedTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -58,7 +61,6 @@
 #include <Core/Utils/Legacy/CheckSum.h>
 
 #include <boost/thread.hpp>
-#include <boost/unordered_map.hpp>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
 
@@ -89,6 +91,7 @@ VMesh* CreateVTetVolMesh(MESH*) { return nullptr; }
 #if (SCIRUN_TETVOL_SUPPORT > 0)
 
 SCISHARE VMesh* CreateVTetVolMesh(TetVolMesh<Core::Basis::TetLinearLgn<Core::Geometry::Point> >* mesh);
+SCISHARE VMesh* CreateVTetVolMesh(TetVolMesh<Core::Basis::TetLinearLgn<Core::Geometry::PointF> >* mesh);
 #if (SCIRUN_QUADRATIC_SUPPORT > 0)
 SCISHARE VMesh* CreateVTetVolMesh(TetVolMesh<Core::Basis::TetQuadraticLgn<Core::Geometry::Point> >* mesh);
 #endif
@@ -148,6 +151,8 @@ public:
 
   typedef boost::shared_ptr<TetVolMesh<Basis> > handle_type;
   typedef Basis                             basis_type;
+  typedef typename MeshPointStorage<Basis>::value_type      point_storage_type;
+  typedef typename MeshPointStorage<Basis>::const_reference point_const_reference;
 
   /// Index and Iterator types required for Mesh Concept.
   struct Node {
@@ -261,22 +266,22 @@ public:
     }
 
     inline
-    const Core::Geometry::Point &node0() const
+    point_const_reference node0() const
     {
       return mesh_.points_[node0_index()];
     }
     inline
-    const Core::Geometry::Point &node1() const
+    point_const_reference node1() const
     {
       return mesh_.points_[node1_index()];
     }
     inline
-    const Core::Geometry::Point &node2() const
+    point_const_reference node2() const
     {
       return mesh_.points_[node2_index()];
     }
     inline
-    const Core::Geometry::Point &node3() const
+    point_const_reference node3() const
     {
       return mesh_.points_[node3_index()];
     }
@@ -699,9 +704,9 @@ public:
 
   /// Functions to improve memory management. Often one knows how many
   /// nodes/elements one needs, prereserving memory is often possible.
-  void node_reserve(size_type s) { points_.reserve(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
+  void node_reserve(size_type s) { points_.reserve(static_cast<typename std::vector<point_storage_type>::size_type>(s)); }
   void elem_reserve(size_type s) { cells_.reserve(static_cast<std::vector<index_type>::size_type>(s*4)); }
-  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
+  void resize_nodes(size_type s) { points_.resize(static_cast<typename std::vector<point_storage_type>::size_type>(s)); }
   void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*4)); }
 
   /// Get the local coordinates for a certain point within an element
@@ -958,21 +963,15 @@ public:
             {
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
-                typename SearchGridT<index_type>::iterator it, eit;
                 found = false;
-                node_grid_->lookup_ijk(it,eit, i, j, k);
-
-                while (it != eit)
+                if (node_grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
                     {
@@ -980,7 +979,32 @@ public:
                       return (true);
                     }
                   }
-                  ++it;
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it,eit, i, j, k);
+
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+                    ++it;
+                  }
                 }
               }
             }
@@ -1493,7 +1517,7 @@ public:
 			   const Core::Geometry::Point &p);
 
   /// must detach, if altering points!
-  std::vector<Core::Geometry::Point>& get_points() { return points_; }
+  std::vector<point_storage_type>& get_points() { return points_; }
 
   int compute_checksum();
 
@@ -1516,12 +1540,12 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "TetVolMesh: Must call synchronize EDGES_E first");
 
-    if (edges_[idx].cells_.size() == 0)
+    if (edges_.row_size(idx) == 0)
       { array.clear(); return; }
 
     array.resize(2);
 
-    index_type cell_edge_index = edges_[idx].cells_[0];
+    index_type cell_edge_index = edges_.at(idx, 0);
     index_type cell_index = (cell_edge_index>>3) << 2;
     index_type edge_index = (cell_edge_index)&0x7;
 
@@ -1628,37 +1652,37 @@ protected:
     typedef typename ARRAY::value_type T;
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
     n1 = cells_[off + 1]; n2 = cells_[off + 2];
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
     n1 = cells_[off + 2]; n2 = cells_[off    ];
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
     n1 = cells_[off    ]; n2 = cells_[off + 3];
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
     n1 = cells_[off + 1]; n2 = cells_[off + 3];
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
     n1 = cells_[off + 2]; n2 = cells_[off + 3];
     if (n1 != n2)
     {
-      PEdge e(n1,n2);
+      PEdgeNode e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
   }
@@ -1720,7 +1744,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1734,17 +1758,17 @@ protected:
 
       PEdgeNode e(cells_[cell_index+offset[0]],cells_[cell_index+offset[1]]);
       typename edge_nt::const_iterator iter = edge_table_.find(e);
-      if (((edges_[iter->second].cells_[0])&(~0x7))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0x7))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
 
       PEdgeNode e1(cells_[cell_index+offset[2]],cells_[cell_index+offset[3]]);
       iter = edge_table_.find(e1);
-      if (((edges_[iter->second].cells_[0])&(~0x7))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0x7))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
 
       PEdgeNode e2(cells_[cell_index+offset[4]],cells_[cell_index+offset[5]]);
       iter = edge_table_.find(e2);
-      if (((edges_[iter->second].cells_[0])&(~0x7))==(cell_index<<1) )
+      if (((edges_.at(iter->second, 0))&(~0x7))==(cell_index<<1) )
         array.push_back(typename ARRAY::value_type(iter->second));
     }
   }
@@ -1759,10 +1783,10 @@ protected:
 
     array.clear();
 
-    for (size_t c=0; c<edges_[idx].cells_.size();c++)
+    for (size_t c=0; c<edges_.row_size(idx);c++)
     {
-      index_type cell_index = ((edges_[idx].cells_[c])>>3)<<2;
-      index_type face_index = (edges_[idx].cells_[c])&0x7;
+      index_type cell_index = ((edges_.at(idx, c))>>3)<<2;
+      index_type face_index = (edges_.at(idx, c))&0x7;
 
       const int* off = TetVolFacePerEdgeTable[face_index];
 
@@ -1796,7 +1820,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1834,8 +1858,8 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "TetVolMesh: Must call synchronize EDGES_E first");
-    for (size_t i=0; i< edges_[idx].cells_.size(); i++)
-      array[i] = static_cast<typename ARRAY::value_type>(edges_[idx].cells_[i]);
+    for (size_t i=0; i< edges_.row_size(idx); i++)
+      array[i] = static_cast<typename ARRAY::value_type>(edges_.at(idx, i));
   }
 
   template<class ARRAY, class INDEX>
@@ -2006,22 +2030,35 @@ protected:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                SearchGridT<index_type>::iterator it, eit;
-                node_grid_->lookup_ijk(it, eit, i, j, k);
+                if (node_grid_->has_points())
+                {
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it, eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
 
-                    if (dist < epsilon2_) return (true);
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -2264,12 +2301,13 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
-  const Core::Geometry::Point &point(typename Node::index_type i) { return points_[i]; }
+  point_const_reference point(typename Node::index_type i) { return points_[i]; }
 
   template<class INDEX>
   bool inside(INDEX idx, const Core::Geometry::Point &p) const
@@ -2326,7 +2364,7 @@ protected:
   }
 
   /// all the nodes.
-  std::vector<Core::Geometry::Point>         points_;
+  std::vector<point_storage_type>            points_;
 
   /// each 4 indicies make up a tet
   std::vector<under_type>    cells_;
@@ -2415,14 +2453,6 @@ protected:
     }
   };
 
-  class PFace : public PFaceNode, public PFaceCell
-  {
-    public:
-      PFace(typename Node::index_type n1, typename Node::index_type n2,
-          typename Node::index_type n3) :
-        PFaceNode(n1,n2,n3) {}
-  };
-
   /// Edge information.
   class PEdgeNode {
     public:
@@ -2466,96 +2496,16 @@ protected:
     }
   };
 
-  class PEdgeCell {
-    public:
-      /// list of all the cells this edge is in.
-      std::vector<index_type> cells_;
-
-      bool shared() const { return cells_.size() > 1; }
-  };
-
-  /// Edge information.
-  class PEdge : public PEdgeNode, public PEdgeCell
-  {
-    public:
-      PEdge(typename Node::index_type n1,typename Node::index_type n2) :
-        PEdgeNode(n1,n2) {}
-  };
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    // These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function).
-    static const int sz_third_int = (int)(sz_int / 3);
-    static const int up_mask = -(1 << sz_third_int << sz_third_int);
-    static const int mid_mask =  up_mask ^ -(1 << sz_third_int);
-    static const int low_mask = ~(up_mask | mid_mask);
-
-    /// This is the hash function
-    template <class PFACE>
-    size_t operator()(const PFACE &f) const
-    {
-      return ((up_mask & (static_cast<int>(f.nodes_[0]) << sz_third_int << sz_third_int)) |
-              (mid_mask & (static_cast<int>(f.nodes_[1]) << sz_third_int)) |
-              (low_mask & static_cast<int>(f.nodes_[2])));
-    }
-    /// This should return less than rather than equal to.
-
-    template <class PFACE>
-    bool operator()(const PFACE &f1, const PFACE& f2) const
-    {
-      return f1 < f2;
-    }
-  };
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    template <class PEDGE>
-    size_t operator()(const PEDGE &e) const
-    {
-      return (static_cast<int>(e.nodes_[0]) << sz_half_int) |
-              (low_mask & static_cast<int>(e.nodes_[1]));
-    }
-
-    ///  This should return less than rather than equal to.
-    template <class PEDGE>
-    bool operator()(const PEDGE &e1, const PEDGE& e2) const
-    {
-      return e1 < e2;
-    }
-  };
-
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  typedef SortedTopologyTable<PFaceNode, typename Face::index_type> face_nt;
+  typedef SortedTopologyTable<PEdgeNode, typename Edge::index_type> edge_nt;
 
   typedef std::vector<PFaceCell> face_ct;
-  typedef std::vector<PEdgeCell> edge_ct;
+  /// For every edge the combined (cell<<3 | local edge) indices of the
+  /// cells sharing it.
+  typedef RaggedArray<index_type, index_type> edge_ct;
+  /// For every node the combined (cell<<2 | local node) indices of the
+  /// cells using it.
+  typedef RaggedArray<index_type, index_type> node_neighbor_ct;
 
   // These should not be called outside of the synchronize_lock_.
 
@@ -2573,11 +2523,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2587,16 +2532,12 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  node_neighbor_ct node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2661,7 +2602,7 @@ TetVolMesh<Basis>::TetVolMesh() :
   cells_(0),
   faces_(0),
   face_table_(),
-  edges_(0),
+  edges_(),
   edge_table_(),
   synchronize_lock_("TetVolMesh lock"),
   synchronize_cond_("TetVolMesh condition variable"),
@@ -2683,7 +2624,7 @@ TetVolMesh<Basis>::TetVolMesh(const TetVolMesh &copy) :
   cells_(0),
   faces_(0),
   face_table_(),
-  edges_(0),
+  edges_(),
   edge_table_(),
   synchronize_lock_("TetVolMesh lock"),
   synchronize_cond_("TetVolMesh condition variable"),
@@ -2732,7 +2673,7 @@ TetVolMesh<Basis>::fill_points(Iter begin, Iter end, Functor fill_ftor)
   synchronize_lock_.lock();
   Iter iter = begin;
   points_.resize(end - begin); // resize to the new size
-  std::vector<Core::Geometry::Point>::iterator piter = points_.begin();
+  typename std::vector<point_storage_type>::iterator piter = points_.begin();
   while (iter != end)
   {
     *piter = fill_ftor(*iter);
@@ -2868,8 +2809,8 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
   synchronize_lock_.lock();
 
-  std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
-  std::vector<Core::Geometry::Point>::iterator eitr = points_.end();
+  typename std::vector<point_storage_type>::iterator itr = points_.begin();
+  typename std::vector<point_storage_type>::iterator eitr = points_.end();
   while (itr != eitr)
   {
     *itr = t.project(*itr);
@@ -2948,103 +2889,76 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
-{
-  PFace f(n1, n2, n3);
-
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_faces()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
-
-  face_ht table;
-
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+  typedef TopologyRecord<PFaceNode> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 2);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  // 4 faces -- each is entered CCW from outside looking in
+  std::vector<record_type> records(cells_.size());
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c << 2];
+        const index_type cell_index = static_cast<index_type>(c) << 2;
+        records[cell_index]     = record_type(PFaceNode(n[0], n[2], n[1]), cell_index);
+        records[cell_index + 1] = record_type(PFaceNode(n[1], n[2], n[3]), cell_index + 1);
+        records[cell_index + 2] = record_type(PFaceNode(n[0], n[1], n[3]), cell_index + 2);
+        records[cell_index + 3] = record_type(PFaceNode(n[0], n[3], n[2]), cell_index + 3);
+      }
+    });
 
-  boundary_faces_.resize(cells_.size() >> 2);
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  const size_type num_faces =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
+  // The records of a face are ordered by cell, so the first one becomes
+  // cells_[0]. A third cell sharing a face, or a cell sharing a face with
+  // itself, means the mesh is malformed and is ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  std::vector<unsigned char> boundary(cells_.size(), 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_faces), 0,
+    [this, &records, &group_offsets, &boundary](const Core::Thread::IndexRange& r)
+    {
+      for (size_t f = r.begin; f < r.end; ++f)
+      {
+        const index_type b = group_offsets[f], e = group_offsets[f + 1];
+        PFaceCell& face = faces_[f];
+        face.cells_[0] = records[b].item_;
+        for (index_type i = b + 1; i < e; ++i)
+        {
+          if ((records[i].item_>>2) != (face.cells_[0]>>2))
+          {
+            face.cells_[1] = records[i].item_;
+            break;
+          }
+        }
+        if (face.cells_[1] == MESH_NO_NEIGHBOR) boundary[face.cells_[0]] = 1;
+      }
+    });
 
-    if (pface.cells_[1] == -1)
+  boundary_faces_.clear();
+  boundary_faces_.resize(num_cells, 0);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &boundary](const Core::Thread::IndexRange& r)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
-      boundary_faces_[cell] |= 1 << face;
-    }
-    ++ht_iter; uidx++;
-  }
+      for (size_t c = r.begin; c < r.end; ++c)
+        for (int face = 0; face < 4; ++face)
+          if (boundary[(c << 2) + face]) boundary_faces_[c] |= 1 << face;
+    });
+
+  face_table_.assign(records, group_offsets, node_groups);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3082,66 +2996,51 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
-
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+  typedef TopologyRecord<PEdgeNode> record_type;
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 2);
+  const size_type num_nodes = static_cast<size_type>(points_.size());
+
+  // Collapsed edges of degenerate tets are not edges of the mesh; they are
+  // dropped after the records have been generated.
+  std::vector<record_type> records(num_cells * 6);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_cells), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      for (size_t c = r.begin; c < r.end; ++c)
+      {
+        const under_type* n = &cells_[c << 2];
+        const index_type cell_index = static_cast<index_type>(c) << 3;
+        record_type* rec = &records[c * 6];
+        rec[0] = record_type(PEdgeNode(n[0], n[1]), cell_index);
+        rec[1] = record_type(PEdgeNode(n[1], n[2]), cell_index + 1);
+        rec[2] = record_type(PEdgeNode(n[2], n[0]), cell_index + 2);
+        rec[3] = record_type(PEdgeNode(n[3], n[0]), cell_index + 3);
+        rec[4] = record_type(PEdgeNode(n[3], n[1]), cell_index + 4);
+        rec[5] = record_type(PEdgeNode(n[3], n[2]), cell_index + 5);
+      }
+    });
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const record_type& rec) { return rec.key_.nodes_[0] == rec.key_.nodes_[1]; }),
+    records.end());
+
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  group_topology_records(records, node_offsets, group_offsets, node_groups);
+
+  // The records of an edge are contiguous and ordered by cell, so they are
+  // the rows of edges_ as they stand.
+  std::vector<index_type> cells(records.size());
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, records.size()), 0,
+    [&records, &cells](const Core::Thread::IndexRange& r)
+    {
+      for (size_t i = r.begin; i < r.end; ++i) cells[i] = records[i].item_;
+    });
+  edge_table_.assign(records, group_offsets, node_groups);
+  edges_.assign(group_offsets, cells);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3159,13 +3058,12 @@ TetVolMesh<Basis>::add_edge(typename Node::index_type n1,
   {
     index_type uidx = static_cast<index_type>(edges_.size());
     edge_table_[e] = uidx;
-    PEdgeCell c;
-    edges_.push_back(c);
-    edges_[uidx].cells_.push_back(combined_index);
+    edges_.resize(uidx + 1);
+    edges_.push_back(uidx, combined_index);
   }
   else
   {
-    edges_[ht_iter->second].cells_.push_back(combined_index);
+    edges_.push_back(ht_iter->second, combined_index);
   }
 }
 
@@ -3461,35 +3359,20 @@ TetVolMesh<Basis>::remove_edge(typename Node::index_type n1,
 
   index_type found_idx = (*iter).second;
 
-  const std::vector<index_type>& cells = edges_[found_idx].cells_;
-  if (cells.size() < 2)
+  if (edges_.row_size(found_idx) < 2)
   {
-    if ((cells[0] >>3) !=  ci)
+    if ((edges_.at(found_idx, 0) >>3) !=  ci)
     {
       ASSERTFAIL("this edge does exist in the table but is not connected to this cell");
     }
     edge_table_.erase(iter);
-    if (!table_only) edges_[found_idx].cells_.clear();
+    if (!table_only) edges_.clear_row(found_idx);
   }
   else
   {
-    typename std::vector<index_type>::iterator citer = edges_[found_idx].cells_.begin();
-    typename std::vector<index_type>::iterator citer_end = edges_[found_idx].cells_.end();
-
-    index_type cell_idx = ci;
-    while(citer != citer_end)
-    {
-      if (((*citer)>>3)==cell_idx) {
-         // temporary fix
-         // should be replaced with algorithm
-        edges_[found_idx].cells_.erase(citer);
-        citer = edges_[found_idx].cells_.begin();
-        citer_end = edges_[found_idx].cells_.end();
-      }
-      else {
-        ++citer;
-      }
-    }
+    const index_type cell_idx = ci;
+    edges_.erase_if(found_idx,
+      [cell_idx](index_type c) { return (c>>3) == cell_idx; });
   }
 }
 
@@ -3542,7 +3425,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.push_back(cells_[i], i);
   }
 }
 
@@ -3554,16 +3437,10 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
   for (index_type i = c*4; i < c*4+4; ++i)
   {
     const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
+    const bool found = node_neighbors_.erase(n, i);
 
     /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    ASSERT(found);
   }
 }
 
@@ -3671,13 +3548,9 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  std::vector<index_type> offsets, items;
+  build_node_adjacency(cells_, static_cast<size_type>(points_.size()), offsets, items);
+  node_neighbors_.assign(offsets, items);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3720,12 +3593,9 @@ TetVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Node::ar
 }
 
 template <class Basis>
-void
-TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TetVolMesh<Basis>::elem_grid_bbox(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3733,7 +3603,17 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3741,14 +3621,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3789,13 +3662,7 @@ TetVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->fill_boxes(esz, [this](index_type ci) { return elem_grid_bbox(ci); });
   }
 
   synchronize_lock_.lock();
@@ -3826,13 +3693,8 @@ TetVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    typename Node::size_type nsz;  size(nsz);
+    node_grid_->fill_points(nsz, [this](index_type n) { return points_[n]; });
   }
 
   synchronize_lock_.lock();
@@ -3889,7 +3751,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.resize(node_neighbors_.size() + 1);
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -4025,7 +3887,7 @@ TetVolMesh<Basis>::delete_nodes(std::set<index_type> &to_delete)
   while (iter != to_delete.rend())
   {
     typename TetVolMesh::Node::index_type n = *iter++;
-    std::vector<Core::Geometry::Point>::iterator pit = points_.begin() + n;
+    typename std::vector<point_storage_type>::iterator pit = points_.begin() + n;
     points_.erase(pit);
   }
   synchronized_ &= ~Mesh::LOCATE_E;
@@ -4300,7 +4162,8 @@ TetVolMesh<Basis>::insert_node_in_elem(typename Elem::array_type &tets,
 
     typename edge_nt::iterator iter = edge_table_.find(etmp);
     PEdgeNode e = iter->first;
-    const std::vector<index_type>& cells = edges_[iter->second].cells_;
+    const typename edge_ct::const_row row = edges_[iter->second];
+    const std::vector<index_type> cells(row.begin(), row.end());
 
     pi = add_point(p);
     tets.clear();
@@ -4337,7 +4200,7 @@ TetVolMesh<Basis>::insert_node_in_elem(typename Elem::array_type &tets,
     }
 
     typename face_nt::iterator iter = face_table_.find(ftmp);
-    const PFaceNode& n = iter->first;
+    const PFaceNode n = iter->first;
     const PFaceCell& f = faces_[iter->second];
     typename Cell::index_type nbr_tet =
       (ci == (f.cells_[0])>>2) ? ((f.cells_[1])>>2) : ((f.cells_[0])>>2);
@@ -123,6 +123,7 @@ public:
   virtual VMesh::index_type* get_elems_pointer() const;
   virtual boost::shared_ptr<SearchGridT<typename SCIRun::index_type> > get_elem_search_grid() { return this->mesh_->elem_grid_; }
   virtual boost::shared_ptr<SearchGridT<typename SCIRun::index_type> > get_node_search_grid() { return this->mesh_->node_grid_; }
+  virtual boost::shared_ptr<SurfaceBVH> get_surface_bvh() { return this->mesh_->bvh_; }
 
 };
 
@@ -130,10 +131,11 @@ public:
 /// Functions for creating the virtual interface for specific mesh types
 /// These are similar to compare maker and only serve to instantiate the class
 
-/// Currently there are only 3 variations of this mesh available
+/// Currently there are only 4 variations of this mesh available
 /// 1) linear interpolation
-/// 2) quadratic interpolation
-/// 3) cubic interpolation
+/// 2) linear interpolation with single precision nodes
+/// 3) quadratic interpolation
+/// 4) cubic interpolation
 
 /// Add the LINEAR virtual interface and the meshid for creating it
 
@@ -148,6 +150,19 @@ static MeshTypeID TriSurfMesh_MeshID1(
                   TriSurfMesh<TriLinearLgn<Point> >::type_name(-1),
                   TriSurfMesh<TriLinearLgn<Point> >::mesh_maker);
 
+/// Add the LINEAR virtual interface for meshes storing their nodes as PointF
+
+/// Create virtual interface
+VMesh* CreateVTriSurfMesh(TriSurfMesh<TriLinearLgn<PointF> >* mesh)
+{
+  return new VTriSurfMesh<TriSurfMesh<TriLinearLgn<PointF> > >(mesh);
+}
+
+/// Register class maker, so we can instantiate it
+static MeshTypeID TriSurfMesh_MeshID1F(
+                  TriSurfMesh<TriLinearLgn<PointF> >::type_name(-1),
+                  TriSurfMesh<TriLinearLgn<PointF> >::mesh_maker);
+
 
 /// Add the QUADRATIC virtual interface and the meshid for creating it
 #if (SCIRUN_QUADRATIC_SUPPORT > 0)
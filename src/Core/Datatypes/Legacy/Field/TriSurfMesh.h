@@ -40,7 +40,7 @@
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/CompGeom.h>
-#include <Core/Containers/StackVector.h>
+#include <Core/Containers/RaggedArray.h>
 #include <Core/GeometryPrimitives/SearchGridT.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -50,14 +50,16 @@
 #include <Core/Basis/TriCubicHmt.h>
 
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshPointStorage.h>
+#include <Core/Datatypes/Legacy/Field/SurfaceBVH.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
+#include <Core/Datatypes/Legacy/Field/SortedTopologyTable.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
 
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
 #include <boost/thread.hpp>
-#include <boost/unordered_map.hpp>
 
 #include <set>
 
@@ -82,6 +84,7 @@ VMesh* CreateVTriSurfMesh(MESH*) { return (0); }
 /// Declare that these can be found in a library that is already
 /// precompiled. So dynamic compilation will not instantiate them again.
 SCISHARE VMesh* CreateVTriSurfMesh(TriSurfMesh<Core::Basis::TriLinearLgn<Core::Geometry::Point> >* mesh);
+SCISHARE VMesh* CreateVTriSurfMesh(TriSurfMesh<Core::Basis::TriLinearLgn<Core::Geometry::PointF> >* mesh);
 #if (SCIRUN_QUADRATIC_SUPPORT > 0)
 SCISHARE VMesh* CreateVTriSurfMesh(TriSurfMesh<Core::Basis::TriQuadraticLgn<Core::Geometry::Point> >* mesh);
 #endif
@@ -114,6 +117,8 @@ public:
 
   typedef boost::shared_ptr<TriSurfMesh<Basis> > handle_type;
   typedef Basis                              basis_type;
+  typedef typename MeshPointStorage<Basis>::value_type      point_storage_type;
+  typedef typename MeshPointStorage<Basis>::const_reference point_const_reference;
 
   /// Index and Iterator types required for Mesh Concept.
   struct Node {
@@ -204,15 +209,15 @@ public:
     }
 
     inline
-    const Core::Geometry::Point &node0() const {
+    point_const_reference node0() const {
       return mesh_.points_[node0_index()];
     }
     inline
-    const Core::Geometry::Point &node1() const {
+    point_const_reference node1() const {
       return mesh_.points_[node1_index()];
     }
     inline
-    const Core::Geometry::Point &node2() const {
+    point_const_reference node2() const {
       return mesh_.points_[node2_index()];
     }
 
@@ -257,6 +262,7 @@ public:
         if (sync_ & Mesh::EDGES_E) mesh_->compute_edges_bugfix();
         if (sync_ & Mesh::NORMALS_E) mesh_->compute_normals();
         if (sync_ & Mesh::BOUNDING_BOX_E) mesh_->compute_bounding_box();
+        if (sync_ & Mesh::SURFACE_BVH_E) mesh_->compute_surface_bvh();
 
         // These depend on the bounding box being synchronized
         if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E))
@@ -828,20 +834,14 @@ public:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                typename SearchGridT<index_type>::iterator  it, eit;
-                node_grid_->lookup_ijk(it, eit, i, j, k);
-
-                while (it != eit)
+                if (node_grid_->has_points())
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist  = (p-point).length2();
-
-                  if (dist < dmin)
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
                   {
                     found_one = true;
-                    result = point;
-                    node = INDEX(*it);
-                    dmin = dist;
+                    result = points_[closest];
+                    node = INDEX(closest);
 
                     /// If we are closer than eps^2 we found a node close enough
                     if (dmin < epsilon2_)
@@ -850,7 +850,33 @@ public:
                       return (true);
                     }
                   }
-                  ++it;
+                }
+                else
+                {
+                  typename SearchGridT<index_type>::iterator  it, eit;
+                  node_grid_->lookup_ijk(it, eit, i, j, k);
+
+                  while (it != eit)
+                  {
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist  = (p-point).length2();
+
+                    if (dist < dmin)
+                    {
+                      found_one = true;
+                      result = point;
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      /// If we are closer than eps^2 we found a node close enough
+                      if (dmin < epsilon2_)
+                      {
+                        pdist = sqrt(dmin);
+                        return (true);
+                      }
+                    }
+                    ++it;
+                  }
                 }
               }
             }
@@ -1450,7 +1476,7 @@ public:
 
 
 
-  const Core::Geometry::Point &point(typename Node::index_type i) { return points_[i]; }
+  point_const_reference point(typename Node::index_type i) { return points_[i]; }
 
   // This one should be made obsolete
   bool get_neighbor(index_type &nbr_half_edge,
@@ -1482,7 +1508,7 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "TriSurfMesh: Must call synchronize EDGES_E on TriSurfMesh first");
 
-    index_type a = edges_[idx][0];
+    index_type a = edges_.at(idx, 0);
     index_type faceidx = a >> 2;
     index_type offset = a & 0x3;
     array.resize(2);
@@ -1559,7 +1585,7 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "Must call synchronize EDGES_E on TriSurfMesh first");
 
-    const std::vector<index_type>& faces = edges_[idx];
+    const typename halfedge_ct::const_row faces = edges_[idx];
 
     // clear array
     array.clear();
@@ -1582,7 +1608,7 @@ protected:
               "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     // Get the table of faces that are connected to the two nodes
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row faces  = node_neighbors_[idx];
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1606,11 +1632,11 @@ protected:
       "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     array.clear();
-    int n=edge_on_node_[idx].size();
+    int n=edge_on_node_.row_size(idx);
     typename ARRAY::value_type edge;
     for(int i=0; i<n; i++)
     {
-      edge = edge_on_node_[idx][i];
+      edge = edge_on_node_.at(idx, i);
       size_t k=0;
       for (; k<array.size(); k++)
         if (array[k] == edge) break;
@@ -1634,7 +1660,7 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "Must call synchronize EDGES_E on TriSurfMesh first");
 
-    const std::vector<index_type>& faces = edges_[delem];
+    const typename halfedge_ct::const_row faces = edges_[delem];
 
     size_type fs = faces.size();
     for (index_type i=0; i<fs; i++)
@@ -1656,7 +1682,7 @@ protected:
               "Must call synchronize EDGES_E on TriSurfMesh first");
 
     // Find the two nodes that make up the edge
-    const std::vector<index_type>& faces = edges_[delem];
+    const typename halfedge_ct::const_row faces = edges_[delem];
 
     // clear array
     array.clear();
@@ -1710,7 +1736,7 @@ protected:
     array.clear();
 
     // Get all the neighboring elements
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_neighbor_ct::const_row faces  = node_neighbors_[idx];
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -1792,22 +1818,35 @@ protected:
               if (node_grid_->min_distance_squared(p, i, j, k) < dmin)
               {
                 found = false;
-                SearchGridT<index_type>::iterator it, eit;
-                node_grid_->lookup_ijk(it, eit, i, j, k);
+                if (node_grid_->has_points())
+                {
+                  index_type closest;
+                  if (node_grid_->closest_in_bin(p, i, j, k, dmin, closest))
+                  {
+                    node = INDEX(closest);
 
-                while (it != eit)
+                    if (dmin < epsilon2_) return (true);
+                  }
+                }
+                else
                 {
-                  const Core::Geometry::Point point = points_[*it];
-                  const double dist = (p-point).length2();
+                  SearchGridT<index_type>::iterator it, eit;
+                  node_grid_->lookup_ijk(it, eit, i, j, k);
 
-                  if (dist < dmin)
+                  while (it != eit)
                   {
-                    node = INDEX(*it);
-                    dmin = dist;
+                    const Core::Geometry::Point point = points_[*it];
+                    const double dist = (p-point).length2();
 
-                    if (dist < epsilon2_) return (true);
+                    if (dist < dmin)
+                    {
+                      node = INDEX(*it);
+                      dmin = dist;
+
+                      if (dist < epsilon2_) return (true);
+                    }
+                    ++it;
                   }
-                  ++it;
                 }
               }
             }
@@ -2006,13 +2045,16 @@ protected:
   void compute_edges();
   // Fixes bug #887 (gforge)
   void compute_edges_bugfix();
+  void compute_edge_table(bool with_node_edges);
   void compute_edge_neighbors();
 
   void compute_node_grid();
   void compute_elem_grid();
+  void compute_surface_bvh();
   void compute_bounding_box();
 
   /// Used to recompute data for individual cells.
+  Core::Geometry::BBox elem_grid_bbox(index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
 
@@ -2027,17 +2069,21 @@ protected:
   static index_type prev(index_type i) { return ((i%3)==0) ? (i+2) : (i-1); }
 
   /// Actual parameters
-  std::vector<Core::Geometry::Point>         points_;              // Location of vertices
-  std::vector<std::vector<index_type> >    edges_;               // edges->halfedge map
+  std::vector<point_storage_type>            points_;              // Location of vertices
+  typedef RaggedArray<index_type, index_type> halfedge_ct;
+  typedef RaggedArray<index_type, index_type> node_neighbor_ct;
+
+  halfedge_ct                edges_;               // edges->halfedge map
   std::vector<index_type>    halfedge_to_edge_;    // halfedge->edge map
   std::vector<index_type>    faces_;               // Connectivity of this mesh
   std::vector<index_type>    edge_neighbors_;      // Neighbor connectivity
   std::vector<Core::Geometry::Vector>        normals_;             // normalized per node normal.
-  std::vector<std::vector<index_type> > node_neighbors_; // Node neighbor connectivity
-  std::vector<std::vector<index_type> > edge_on_node_; // Edges emanating from a node
+  node_neighbor_ct           node_neighbors_;      // Node neighbor connectivity
+  node_neighbor_ct           edge_on_node_;        // Edges emanating from a node
 
   boost::shared_ptr<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
   boost::shared_ptr<SearchGridT<index_type> > elem_grid_; // Lookup table for elements
+  boost::shared_ptr<SurfaceBVH> bvh_;                  // Bounding volume hierarchy of the faces
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex         synchronize_lock_;
@@ -2055,18 +2101,6 @@ protected:
   double                epsilon2_;          // Square of epsilon
 
   boost::shared_ptr<VMesh>         vmesh_;             // Handle to virtual function table
-
-  struct edgehash
-  {
-    boost::hash<int> hasher_;
-    size_t operator()(const std::pair<index_type, index_type> &a) const
-    {
-      return hasher_(static_cast<int>(hasher_(a.first) + a.second));
-    }
-  };
-
-  using EdgeMapType = boost::unordered_map<std::pair<index_type, index_type>, index_type, edgehash>;
-  using EdgeMapType2 = boost::unordered_map<std::pair<index_type, index_type>, std::vector<index_type>, edgehash>;
 };
 
 
@@ -2109,7 +2143,7 @@ TriSurfMesh<Basis>::TriSurfMesh()
   : points_(0),
     faces_(0),
     edge_neighbors_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2128,12 +2162,12 @@ template <class Basis>
 TriSurfMesh<Basis>::TriSurfMesh(const TriSurfMesh &copy)
   : Mesh(copy),
     points_(0),
-    edges_(0),
+    edges_(),
     halfedge_to_edge_(0),
     faces_(0),
     edge_neighbors_(0),
     normals_(0),
-    node_neighbors_(0),
+    node_neighbors_(),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2233,8 +2267,8 @@ void
 TriSurfMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
   synchronize_lock_.lock();
-  std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
-  std::vector<Core::Geometry::Point>::iterator eitr = points_.end();
+  typename std::vector<point_storage_type>::iterator itr = points_.begin();
+  typename std::vector<point_storage_type>::iterator eitr = points_.end();
   while (itr != eitr)
   {
     *itr = t.project(*itr);
@@ -2432,7 +2466,8 @@ TriSurfMesh<Basis>::synchronize(mask_type sync)
   sync &= (Mesh::EDGES_E|Mesh::NORMALS_E|
            Mesh::NODE_NEIGHBORS_E|Mesh::BOUNDING_BOX_E|
            Mesh::ELEM_NEIGHBORS_E|
-           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E);
+           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|
+           Mesh::SURFACE_BVH_E);
 
   Core::Thread::UniqueLock lock(synchronize_lock_.get());
 
@@ -2537,6 +2572,20 @@ TriSurfMesh<Basis>::synchronize(mask_type sync)
     boost::thread syncthread(syncclass);
   }
 
+  if (sync == Mesh::SURFACE_BVH_E)
+  {
+    Synchronize Synchronize(this,sync);
+    synchronize_lock_.unlock();
+    Synchronize.run();
+    synchronize_lock_.lock();
+  }
+  else if (sync & Mesh::SURFACE_BVH_E)
+  {
+    mask_type tosync = Mesh::SURFACE_BVH_E;
+    Synchronize syncclass(this,tosync);
+    boost::thread syncthread(syncclass);
+  }
+
   // Wait until threads are done
   while ((synchronized_ & sync) != sync)
   {
@@ -2569,6 +2618,7 @@ TriSurfMesh<Basis>::clear_synchronization()
   edges_.clear();
   node_grid_.reset();
   elem_grid_.reset();
+  bvh_.reset();
 
   synchronize_lock_.unlock();
   return (true);
@@ -3015,7 +3065,7 @@ TriSurfMesh<Basis>::bisect_element(const typename Face::index_type face)
   std::vector<Core::Geometry::Vector> normals(3);
   for (index_type edge = 0; edge < 3; ++edge)
   {
-    Core::Geometry::Point p = ((points_[faces_[f0+edge]] +
+    Core::Geometry::Point p = ((Core::Geometry::Point(points_[faces_[f0+edge]]) +
                 points_[faces_[next(f0+edge)]]) / 2.0).asPoint();
     nodes[edge] = add_point(p);
 
@@ -3172,13 +3222,10 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
-  {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+  std::vector<index_type> offsets, items;
+  build_node_adjacency(faces_, static_cast<size_type>(points_.size()), offsets, items);
+  for (size_t i = 0; i < items.size(); ++i) items[i] /= 3;
+  node_neighbors_.assign(offsets, items);
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3189,47 +3236,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edges()
 {
-  EdgeMapType2 edge_map;
-
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
-  {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
-
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
-
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
-
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
-
-  typename EdgeMapType2::iterator itr;
-  edges_.clear();
-  edges_.resize(edge_map.size());
-  halfedge_to_edge_.resize(faces_.size());
-
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
-  {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
-    {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
-
-    }
-    k++;
-  }
-
-  synchronize_lock_.lock();
-  synchronized_ |= (Mesh::EDGES_E);
-  synchronize_lock_.unlock();
+  compute_edge_table(false);
 }
 
 // Fixes bug #887 (gforge)
@@ -3237,47 +3244,70 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edges_bugfix()
 {
-  EdgeMapType2 edge_map;
+  compute_edge_table(true);
+}
 
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
-  {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_edge_table(bool with_node_edges)
+{
+  typedef TopologyRecord<TopologyEdgeKey> record_type;
+  const size_type num_halfedges = static_cast<size_type>(faces_.size());
+  const size_type num_nodes = static_cast<size_type>(points_.size());
 
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
+  // One record per halfedge, tagged with (face<<2 | local edge).
+  std::vector<record_type> records(num_halfedges);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_halfedges), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      for (size_t a = r.begin; a < r.end; ++a)
+      {
+        const size_t b = a - a % 3 + (a + 1) % 3;
+        records[a] = record_type(TopologyEdgeKey(faces_[a], faces_[b]),
+          static_cast<index_type>(((a / 3) << 2) + a % 3));
+      }
+    });
 
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, num_nodes, node_offsets);
+  const size_type num_edges =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
 
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
-
-  typename EdgeMapType2::iterator itr;
-  edges_.clear();
-  edges_.resize(edge_map.size());
+  std::vector<index_type> halfedges(records.size());
   halfedge_to_edge_.resize(faces_.size());
-  edge_on_node_.clear();
-  edge_on_node_.resize(points_.size());
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_edges), 0,
+    [this, &records, &group_offsets, &halfedges](const Core::Thread::IndexRange& r)
+    {
+      for (size_t e = r.begin; e < r.end; ++e)
+      {
+        for (index_type i = group_offsets[e]; i < group_offsets[e + 1]; ++i)
+        {
+          const index_type h = records[i].item_;
+          halfedges[i] = h;
+          halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = static_cast<index_type>(e);
+        }
+      }
+    });
 
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
+  if (with_node_edges)
   {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
+    // Every edge contributes its two end nodes; the row of a node then lists
+    // the edge slots it appears in.
+    std::vector<index_type> ends(num_edges * 2);
+    for (size_type e = 0; e < num_edges; ++e)
     {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
+      const TopologyEdgeKey& key = records[group_offsets[e]].key_;
+      ends[2 * e] = key.nodes_[0];
+      ends[2 * e + 1] = key.nodes_[1];
     }
-    edge_on_node_[(*itr).first.first].push_back(k);
-    edge_on_node_[(*itr).first.second].push_back(k);
-    k++;
+    std::vector<index_type> offsets, slots;
+    build_node_adjacency(ends, num_nodes, offsets, slots);
+    for (size_t i = 0; i < slots.size(); ++i) slots[i] >>= 1;
+    edge_on_node_.assign(offsets, slots);
   }
 
+  edges_.assign(group_offsets, halfedges);
+
   synchronize_lock_.lock();
   synchronized_ |= (Mesh::EDGES_E);
   synchronize_lock_.unlock();
@@ -3296,7 +3326,7 @@ TriSurfMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   {
     synchronize_lock_.lock();
     points_.push_back(p);
-    node_neighbors_.push_back(std::vector<under_type>());
+    node_neighbors_.resize(node_neighbors_.size() + 1);
     synchronize_lock_.unlock();
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -3388,7 +3418,7 @@ TriSurfMesh<Basis>::remove_orphan_nodes()
         node--;
       }
     }
-    std::vector<Core::Geometry::Point>::iterator niter = points_.begin();
+    typename std::vector<point_storage_type>::iterator niter = points_.begin();
     niter += i;
     points_.erase(niter);
   }
@@ -3545,37 +3575,47 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edge_neighbors()
 {
-  EdgeMapType edge_map;
+  typedef TopologyRecord<TopologyEdgeKey> record_type;
+  const size_type num_halfedges = static_cast<size_type>(faces_.size());
 
-  edge_neighbors_.resize(faces_.size());
-  for (size_t j = 0; j < edge_neighbors_.size(); j++)
-  {
-    edge_neighbors_[j] = MESH_NO_NEIGHBOR;
-  }
-
-  index_type i;
-  for (i=static_cast<index_type>(faces_.size()-1); i >= 0; i--)
-  {
-    const index_type a = i;
-    const index_type b = a - a % 3 + (a+1) % 3;
-
-    index_type n0 = faces_[a];
-    index_type n1 = faces_[b];
-    index_type tmp;
-    if (n0 > n1) { tmp = n0; n0 = n1; n1 = tmp; }
+  std::vector<record_type> records(num_halfedges);
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_halfedges), 0,
+    [this, &records](const Core::Thread::IndexRange& r)
+    {
+      for (size_t a = r.begin; a < r.end; ++a)
+      {
+        const size_t b = a - a % 3 + (a + 1) % 3;
+        records[a] = record_type(TopologyEdgeKey(faces_[a], faces_[b]), static_cast<index_type>(a));
+      }
+    });
 
-    std::pair<index_type, index_type> nodes(n0, n1);
+  std::vector<index_type> node_offsets, group_offsets, node_groups;
+  sort_topology_records(records, static_cast<size_type>(points_.size()), node_offsets);
+  const size_type num_edges =
+    group_topology_records(records, node_offsets, group_offsets, node_groups);
 
-    typename EdgeMapType::iterator maploc;
+  edge_neighbors_.assign(faces_.size(), MESH_NO_NEIGHBOR);
 
-    maploc = edge_map.find(nodes);
-    if (maploc != edge_map.end())
+  // Halfedges sharing an edge are linked pairwise from the highest index down,
+  // which matches the pairing of non-manifold edges used so far.
+  Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num_edges), 0,
+    [this, &records, &group_offsets](const Core::Thread::IndexRange& r)
     {
-      edge_neighbors_[(*maploc).second] = i;
-      edge_neighbors_[i] = (*maploc).second;
-    }
-    edge_map[nodes] = i;
-  }
+      for (size_t e = r.begin; e < r.end; ++e)
+      {
+        index_type prev = MESH_NO_NEIGHBOR;
+        for (index_type i = group_offsets[e + 1] - 1; i >= group_offsets[e]; --i)
+        {
+          const index_type h = records[i].item_;
+          if (prev != MESH_NO_NEIGHBOR)
+          {
+            edge_neighbors_[prev] = h;
+            edge_neighbors_[h] = prev;
+          }
+          prev = h;
+        }
+      }
+    });
 
   debug_test_edge_neighbors();
 
@@ -3586,18 +3626,25 @@ TriSurfMesh<Basis>::compute_edge_neighbors()
 
 
 template <class Basis>
-void
-TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TriSurfMesh<Basis>::elem_grid_bbox(index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*3;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
   box.extend(points_[faces_[idx+1]]);
   box.extend(points_[faces_[idx+2]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return (box);
+}
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3605,13 +3652,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*3;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3655,13 +3696,7 @@ TriSurfMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->fill_boxes(esz, [this](index_type ci) { return elem_grid_bbox(ci); });
   }
 
   synchronize_lock_.lock();
@@ -3670,6 +3705,18 @@ TriSurfMesh<Basis>::compute_elem_grid()
 }
 
 
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_surface_bvh()
+{
+  bvh_.reset(new SurfaceBVH(points_, faces_, 3));
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::SURFACE_BVH_E;
+  synchronize_lock_.unlock();
+}
+
+
 template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_grid()
@@ -3692,14 +3739,8 @@ TriSurfMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    typename Node::size_type nsz;  size(nsz);
+    node_grid_->fill_points(nsz, [this](index_type n) { return points_[n]; });
   }
 
   synchronize_lock_.lock();
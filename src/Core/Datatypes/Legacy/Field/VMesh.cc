@@ -91,6 +91,12 @@ VMesh::get_node_search_grid()
   ASSERTFAIL("VMesh interface: get_node_search_grid() has not been implemented");
 }
 
+boost::shared_ptr<SurfaceBVH>
+VMesh::get_surface_bvh()
+{
+  return boost::shared_ptr<SurfaceBVH>();
+}
+
 void
 VMesh::get_nodes(Node::array_type& nodes, Node::index_type i) const
 {
@@ -46,6 +46,7 @@ namespace SCIRun {
 
 class VMesh;
 class TypeDescription;
+class SurfaceBVH;
 
 typedef boost::shared_ptr<VMesh> VMeshHandle;
 
@@ -325,6 +326,9 @@ public:
   /// NOTE NOT VALID FOR EACH MESH:
   virtual boost::shared_ptr<SearchGridT<SCIRun::index_type> > get_elem_search_grid();
   virtual boost::shared_ptr<SearchGridT<SCIRun::index_type> > get_node_search_grid();
+  /// Bounding volume hierarchy of surface meshes, available after
+  /// synchronize(Mesh::SURFACE_BVH_E); null for other meshes.
+  virtual boost::shared_ptr<SurfaceBVH> get_surface_bvh();
 
   /// test for special case where the mesh is empty
   /// empty meshes may need a special treatment
@@ -775,22 +779,34 @@ public:
 
   /// Copy nodes from one mesh to another mesh
   /// Note: currently only for irregular meshes
+  /// Meshes with single precision nodes have no points pointer and are
+  /// copied node by node.
   /// @todo: Add regular meshes to the mix
   inline void copy_nodes(VMesh* imesh, Node::index_type i,
                           Node::index_type o,Node::size_type size)
   {
     Core::Geometry::Point* ipoint = imesh->get_points_pointer();
     Core::Geometry::Point* opoint = get_points_pointer();
-    for (index_type j=0; j<size; j++,i++,o++ ) opoint[o] = ipoint[i];
+    if (ipoint && opoint)
+    {
+      for (index_type j=0; j<size; j++,i++,o++ ) opoint[o] = ipoint[i];
+    }
+    else
+    {
+      Core::Geometry::Point p;
+      for (index_type j=0; j<size; j++,i++,o++ )
+      {
+        imesh->get_point(p,i);
+        set_point(p,o);
+      }
+    }
   }
 
   inline void copy_nodes(VMesh* imesh)
   {
     size_type size = imesh->num_nodes();
     resize_nodes(size);
-    Core::Geometry::Point* ipoint = imesh->get_points_pointer();
-    Core::Geometry::Point* opoint = get_points_pointer();
-    for (index_type j=0; j<size; j++) opoint[j] = ipoint[j];
+    copy_nodes(imesh,0,0,size);
   }
 
   inline void copy_elems(VMesh* imesh, Elem::index_type i,
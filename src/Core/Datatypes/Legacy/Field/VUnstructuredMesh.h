@@ -30,6 +30,7 @@
 #define CORE_DATATYPES_VUNSTRUCTUREDMESH_H
 
 #include <Core/Datatypes/Legacy/Field/VMeshShared.h>
+#include <Core/Datatypes/Legacy/Field/MeshPointStorage.h>
 
 /// Include needed for Windows: declares SCISHARE
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -727,8 +728,7 @@ Core::Geometry::Point*
 VUnstructuredMesh<MESH>::
 get_points_pointer() const
 {
-  if (this->mesh_->points_.size() == 0) return (0);
-   return (&(this->mesh_->points_[0]));
+  return (points_pointer(this->mesh_->points_));
 }
 
 template <class MESH>
@@ -0,0 +1,168 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// Fields on meshes that store their nodes in single precision (PointF).
+
+#include <Core/Persistent/PersistentSTL.h>
+#include <Core/GeometryPrimitives/PointF.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Basis/NoData.h>
+#include <Core/Basis/Constant.h>
+#include <Core/Basis/TetLinearLgn.h>
+#include <Core/Basis/TriLinearLgn.h>
+#include <Core/Datatypes/Legacy/Field/TetVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/TriSurfMesh.h>
+#include <Core/Datatypes/Legacy/Field/GenericField.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Basis;
+using namespace SCIRun::Core::Geometry;
+
+//NoData
+typedef NoDataBasis<double>                  NDBasis;
+
+//Constant
+typedef ConstantBasis<Tensor>                 CFDTensorBasis;
+typedef ConstantBasis<Vector>                 CFDVectorBasis;
+typedef ConstantBasis<double>                 CFDdoubleBasis;
+typedef ConstantBasis<complex>                CFDcomplexBasis;
+typedef ConstantBasis<float>                  CFDfloatBasis;
+typedef ConstantBasis<int>                    CFDintBasis;
+typedef ConstantBasis<long long>              CFDlonglongBasis;
+typedef ConstantBasis<short>                  CFDshortBasis;
+typedef ConstantBasis<char>                   CFDcharBasis;
+typedef ConstantBasis<unsigned int>           CFDuintBasis;
+typedef ConstantBasis<unsigned short>         CFDushortBasis;
+typedef ConstantBasis<unsigned char>          CFDucharBasis;
+typedef ConstantBasis<unsigned long>          CFDulongBasis;
+
+typedef TetLinearLgn<Tensor>                  TFDTensorBasis;
+typedef TetLinearLgn<Vector>                  TFDVectorBasis;
+typedef TetLinearLgn<double>                  TFDdoubleBasis;
+typedef TetLinearLgn<complex>                 TFDcomplexBasis;
+typedef TetLinearLgn<float>                   TFDfloatBasis;
+typedef TetLinearLgn<int>                     TFDintBasis;
+typedef TetLinearLgn<long long>               TFDlonglongBasis;
+typedef TetLinearLgn<short>                   TFDshortBasis;
+typedef TetLinearLgn<char>                    TFDcharBasis;
+typedef TetLinearLgn<unsigned int>            TFDuintBasis;
+typedef TetLinearLgn<unsigned short>          TFDushortBasis;
+typedef TetLinearLgn<unsigned char>           TFDucharBasis;
+typedef TetLinearLgn<unsigned long>           TFDulongBasis;
+
+typedef TriLinearLgn<Tensor>                  SFDTensorBasis;
+typedef TriLinearLgn<Vector>                  SFDVectorBasis;
+typedef TriLinearLgn<double>                  SFDdoubleBasis;
+typedef TriLinearLgn<complex>                 SFDcomplexBasis;
+typedef TriLinearLgn<float>                   SFDfloatBasis;
+typedef TriLinearLgn<int>                     SFDintBasis;
+typedef TriLinearLgn<long long>               SFDlonglongBasis;
+typedef TriLinearLgn<short>                   SFDshortBasis;
+typedef TriLinearLgn<char>                    SFDcharBasis;
+typedef TriLinearLgn<unsigned int>            SFDuintBasis;
+typedef TriLinearLgn<unsigned short>          SFDushortBasis;
+typedef TriLinearLgn<unsigned char>           SFDucharBasis;
+typedef TriLinearLgn<unsigned long>           SFDulongBasis;
+
+typedef TetVolMesh<TetLinearLgn<PointF> > TVFMesh;
+typedef TriSurfMesh<TriLinearLgn<PointF> > TSFMesh;
+
+namespace SCIRun {
+
+template class TetVolMesh<TetLinearLgn<PointF> >;
+
+//NoData
+template class GenericField<TVFMesh, NDBasis, std::vector<double> >;
+
+//Constant
+template class GenericField<TVFMesh, CFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<TVFMesh, CFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<TVFMesh, CFDdoubleBasis,   std::vector<double> >;
+template class GenericField<TVFMesh, CFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<TVFMesh, CFDfloatBasis,    std::vector<float> >;
+template class GenericField<TVFMesh, CFDintBasis,      std::vector<int> >;
+template class GenericField<TVFMesh, CFDlonglongBasis, std::vector<long long> >;
+template class GenericField<TVFMesh, CFDshortBasis,    std::vector<short> >;
+template class GenericField<TVFMesh, CFDcharBasis,     std::vector<char> >;
+template class GenericField<TVFMesh, CFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<TVFMesh, CFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<TVFMesh, CFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<TVFMesh, CFDulongBasis,    std::vector<unsigned long> >;
+
+//Linear
+template class GenericField<TVFMesh, TFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<TVFMesh, TFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<TVFMesh, TFDdoubleBasis,   std::vector<double> >;
+template class GenericField<TVFMesh, TFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<TVFMesh, TFDfloatBasis,    std::vector<float> >;
+template class GenericField<TVFMesh, TFDintBasis,      std::vector<int> >;
+template class GenericField<TVFMesh, TFDlonglongBasis, std::vector<long long> >;
+template class GenericField<TVFMesh, TFDshortBasis,    std::vector<short> >;
+template class GenericField<TVFMesh, TFDcharBasis,     std::vector<char> >;
+template class GenericField<TVFMesh, TFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<TVFMesh, TFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<TVFMesh, TFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<TVFMesh, TFDulongBasis,    std::vector<unsigned long> >;
+
+template class TriSurfMesh<TriLinearLgn<PointF> >;
+
+//NoData
+template class GenericField<TSFMesh, NDBasis, std::vector<double> >;
+
+//Constant
+template class GenericField<TSFMesh, CFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<TSFMesh, CFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<TSFMesh, CFDdoubleBasis,   std::vector<double> >;
+template class GenericField<TSFMesh, CFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<TSFMesh, CFDfloatBasis,    std::vector<float> >;
+template class GenericField<TSFMesh, CFDintBasis,      std::vector<int> >;
+template class GenericField<TSFMesh, CFDlonglongBasis, std::vector<long long> >;
+template class GenericField<TSFMesh, CFDshortBasis,    std::vector<short> >;
+template class GenericField<TSFMesh, CFDcharBasis,     std::vector<char> >;
+template class GenericField<TSFMesh, CFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<TSFMesh, CFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<TSFMesh, CFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<TSFMesh, CFDulongBasis,    std::vector<unsigned long> >;
+
+//Linear
+template class GenericField<TSFMesh, SFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<TSFMesh, SFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<TSFMesh, SFDdoubleBasis,   std::vector<double> >;
+template class GenericField<TSFMesh, SFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<TSFMesh, SFDfloatBasis,    std::vector<float> >;
+template class GenericField<TSFMesh, SFDintBasis,      std::vector<int> >;
+template class GenericField<TSFMesh, SFDlonglongBasis, std::vector<long long> >;
+template class GenericField<TSFMesh, SFDshortBasis,    std::vector<short> >;
+template class GenericField<TSFMesh, SFDcharBasis,     std::vector<char> >;
+template class GenericField<TSFMesh, SFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<TSFMesh, SFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<TSFMesh, SFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<TSFMesh, SFDulongBasis,    std::vector<unsigned long> >;
+
+}
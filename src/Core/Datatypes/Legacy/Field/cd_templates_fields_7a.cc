@@ -0,0 +1,116 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// Fields on meshes that store their nodes in single precision (PointF).
+
+#include <Core/Persistent/PersistentSTL.h>
+#include <Core/GeometryPrimitives/PointF.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Basis/NoData.h>
+#include <Core/Basis/Constant.h>
+#include <Core/Basis/HexTrilinearLgn.h>
+#include <Core/Datatypes/Legacy/Field/HexVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/GenericField.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Basis;
+using namespace SCIRun::Core::Geometry;
+
+//NoData
+typedef NoDataBasis<double>                  NDBasis;
+
+//Constant
+typedef ConstantBasis<Tensor>                 CFDTensorBasis;
+typedef ConstantBasis<Vector>                 CFDVectorBasis;
+typedef ConstantBasis<double>                 CFDdoubleBasis;
+typedef ConstantBasis<complex>                CFDcomplexBasis;
+typedef ConstantBasis<float>                  CFDfloatBasis;
+typedef ConstantBasis<int>                    CFDintBasis;
+typedef ConstantBasis<long long>              CFDlonglongBasis;
+typedef ConstantBasis<short>                  CFDshortBasis;
+typedef ConstantBasis<char>                   CFDcharBasis;
+typedef ConstantBasis<unsigned int>           CFDuintBasis;
+typedef ConstantBasis<unsigned short>         CFDushortBasis;
+typedef ConstantBasis<unsigned char>          CFDucharBasis;
+typedef ConstantBasis<unsigned long>          CFDulongBasis;
+
+typedef HexTrilinearLgn<Tensor>               HFDTensorBasis;
+typedef HexTrilinearLgn<Vector>               HFDVectorBasis;
+typedef HexTrilinearLgn<double>               HFDdoubleBasis;
+typedef HexTrilinearLgn<complex>              HFDcomplexBasis;
+typedef HexTrilinearLgn<float>                HFDfloatBasis;
+typedef HexTrilinearLgn<int>                  HFDintBasis;
+typedef HexTrilinearLgn<long long>            HFDlonglongBasis;
+typedef HexTrilinearLgn<short>                HFDshortBasis;
+typedef HexTrilinearLgn<char>                 HFDcharBasis;
+typedef HexTrilinearLgn<unsigned int>         HFDuintBasis;
+typedef HexTrilinearLgn<unsigned short>       HFDushortBasis;
+typedef HexTrilinearLgn<unsigned char>        HFDucharBasis;
+typedef HexTrilinearLgn<unsigned long>        HFDulongBasis;
+
+typedef HexVolMesh<HexTrilinearLgn<PointF> > HVFMesh;
+
+namespace SCIRun {
+
+template class HexVolMesh<HexTrilinearLgn<PointF> >;
+
+//NoData
+template class GenericField<HVFMesh, NDBasis, std::vector<double> >;
+
+//Constant
+template class GenericField<HVFMesh, CFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<HVFMesh, CFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<HVFMesh, CFDdoubleBasis,   std::vector<double> >;
+template class GenericField<HVFMesh, CFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<HVFMesh, CFDfloatBasis,    std::vector<float> >;
+template class GenericField<HVFMesh, CFDintBasis,      std::vector<int> >;
+template class GenericField<HVFMesh, CFDlonglongBasis, std::vector<long long> >;
+template class GenericField<HVFMesh, CFDshortBasis,    std::vector<short> >;
+template class GenericField<HVFMesh, CFDcharBasis,     std::vector<char> >;
+template class GenericField<HVFMesh, CFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<HVFMesh, CFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<HVFMesh, CFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<HVFMesh, CFDulongBasis,    std::vector<unsigned long> >;
+
+//Linear
+template class GenericField<HVFMesh, HFDTensorBasis,   std::vector<Tensor> >;
+template class GenericField<HVFMesh, HFDVectorBasis,   std::vector<Vector> >;
+template class GenericField<HVFMesh, HFDdoubleBasis,   std::vector<double> >;
+template class GenericField<HVFMesh, HFDcomplexBasis,  std::vector<complex> >;
+template class GenericField<HVFMesh, HFDfloatBasis,    std::vector<float> >;
+template class GenericField<HVFMesh, HFDintBasis,      std::vector<int> >;
+template class GenericField<HVFMesh, HFDlonglongBasis, std::vector<long long> >;
+template class GenericField<HVFMesh, HFDshortBasis,    std::vector<short> >;
+template class GenericField<HVFMesh, HFDcharBasis,     std::vector<char> >;
+template class GenericField<HVFMesh, HFDuintBasis,     std::vector<unsigned int> >;
+template class GenericField<HVFMesh, HFDushortBasis,   std::vector<unsigned short> >;
+template class GenericField<HVFMesh, HFDucharBasis,    std::vector<unsigned char> >;
+template class GenericField<HVFMesh, HFDulongBasis,    std::vector<unsigned long> >;
+
+}
@@ -54,6 +54,11 @@ public:
   NrrdData();
   explicit NrrdData(Nrrd* nrrd);
   explicit NrrdData(const NrrdData&);
+  /// The nrrd wraps memory owned by another object (see nrrdWrap_nva), which
+  /// is kept alive for the lifetime of this NrrdData. The memory is shared,
+  /// so neither side may be modified while both are in use; clone() makes
+  /// an independent copy.
+  explicit NrrdData(Core::Datatypes::DatatypeHandle data_owner);
   virtual ~NrrdData();
 
   virtual NrrdData* clone() const override;
@@ -85,6 +90,7 @@ private:
   Nrrd *nrrd_;
   bool    write_nrrd_;
   bool    embed_object_;
+  Core::Datatypes::DatatypeHandle data_owner_;
 
   bool in_name_set(const std::string &s) const;
 
@@ -31,6 +31,8 @@
 
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Math/MiscMath.h>
+#include <algorithm>
+#include <vector>
 #define register
 #include <Eigen/SparseCore>
 #undef register
@@ -59,50 +61,96 @@ namespace Datatypes {
     {
       if (rowCounter[nrows] != nnz)
         THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array does not match number of non-zero elements.");
-      std::vector<Triplet> triplets;
-      triplets.reserve(nnz);
-
-      int i = 0;
-      int j = 0;
-      while (i < nrows)
-      {
-        while (j < rowCounter[i + 1])
-        {
-          index_type column = columnCounter[j];
-          if (column >= ncols)
-            THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
-          triplets.push_back(Triplet(i, columnCounter[j], 0));
-          j++;
-        }
-        i++;
-      }
-      this->setFromTriplets(triplets.begin(), triplets.end());
+      allocateCompressed(nnz);
+      std::copy(rowCounter, rowCounter + nrows + 1, get_rows());
+      std::copy(columnCounter, columnCounter + nnz, get_cols());
+      std::fill(this->valuePtr(), this->valuePtr() + nnz, T(0));
+      finishCompressed();
     }
 
     SparseRowMatrixGeneric(int nrows, int ncols, const index_type* rowCounter, const index_type* columnCounter, const T* data, size_t nnz) : EigenBase(nrows, ncols)
     {
       if (rowCounter[nrows] != nnz)
         THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array does not match number of non-zero elements.");
-      std::vector<Triplet> triplets;
-      triplets.reserve(nnz);
+      allocateCompressed(nnz);
+      std::copy(rowCounter, rowCounter + nrows + 1, get_rows());
+      std::copy(columnCounter, columnCounter + nnz, get_cols());
+      std::copy(data, data + nnz, this->valuePtr());
+      finishCompressed();
+    }
+
+    /// Allocates compressed row storage for nnz entries, so that a builder can
+    /// write the row pointers, column indices and values in place through
+    /// get_rows(), get_cols() and valuePtr() instead of going through triplets.
+    /// Existing entries are discarded. Call finishCompressed() when done.
+    void allocateCompressed(size_t nnz)
+    {
+      this->resize(this->rows(), this->cols());
+      this->resizeNonZeros(nnz);
+    }
+
+    /// Validates the compressed row data written after allocateCompressed().
+    /// Rows may hold their columns in any order and repeat a column; such
+    /// rows are sorted and repeated entries are summed, as setFromTriplets
+    /// would do. The storage is trimmed to get_rows()[nrows] entries and the
+    /// unused capacity is freed, so a builder may allocate an upper bound.
+    void finishCompressed()
+    {
+      const index_type n = this->rows();
+      index_type* rows = get_rows();
+      index_type* cols = get_cols();
+      T* vals = this->valuePtr();
+
+      if (rows[0] != 0)
+        THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array does not start at zero.");
 
-      int i = 0;
-      int j = 0;
-      while (i < nrows)
+      bool sorted = true;
+      for (index_type r = 0; r < n; ++r)
       {
-        while (j < rowCounter[i + 1])
+        if (rows[r+1] < rows[r] || rows[r+1] > this->data().allocatedSize())
+          THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row accumulator array is not increasing.");
+        for (index_type j = rows[r]; j < rows[r+1]; ++j)
         {
-          index_type column = columnCounter[j];
-          if (column >= ncols)
+          if (cols[j] < 0 || cols[j] >= this->cols())
             THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: column index out of bounds.");
-          triplets.push_back(Triplet(i, columnCounter[j], data[j]));
-          j++;
+          if (j > rows[r] && cols[j] <= cols[j-1])
+            sorted = false;
         }
-        i++;
       }
-      this->setFromTriplets(triplets.begin(), triplets.end());
-      this->reserve(nnz);
-      this->makeCompressed();
+
+      if (!sorted)
+      {
+        std::vector<std::pair<index_type, T> > row;
+        index_type k = 0;
+        index_type begin = rows[0];
+        for (index_type r = 0; r < n; ++r)
+        {
+          const index_type end = rows[r+1];
+          row.clear();
+          for (index_type j = begin; j < end; ++j)
+            row.push_back(std::make_pair(cols[j], vals[j]));
+          std::stable_sort(row.begin(), row.end(),
+            [](const std::pair<index_type, T>& a, const std::pair<index_type, T>& b) { return a.first < b.first; });
+
+          rows[r] = k;
+          for (size_t j = 0; j < row.size(); ++j)
+          {
+            if (j > 0 && row[j].first == row[j-1].first)
+            {
+              vals[k-1] += row[j].second;
+              continue;
+            }
+            cols[k] = row[j].first;
+            vals[k] = row[j].second;
+            ++k;
+          }
+          begin = end;
+        }
+        rows[n] = k;
+      }
+
+      this->resizeNonZeros(rows[n]);
+      this->data().squeeze();
     }
 
     /// This constructor allows you to construct SparseRowMatrixGeneric from Eigen expressions
@@ -69,21 +69,32 @@ namespace SCIRun
 
         static SharedPointer<SparseRowMatrixGeneric<T>> make(size_type rows, size_type cols, const Values& values)
         {
-          using Triplet = Eigen::Triplet<T>;
-          std::vector<Triplet> tripletList;
-          tripletList.reserve(get_nnz(values));
+          // The maps are ordered by row and column, so the compressed row
+          // storage can be written directly.
+          auto mat(boost::make_shared<SparseRowMatrixGeneric<T>>(rows, cols));
+          mat->allocateCompressed(get_nnz(values));
+          auto outer = mat->get_rows();
+          auto inner = mat->get_cols();
+          auto data = mat->valuePtr();
 
+          index_type k = 0;
+          index_type r = 0;
           for (auto row = values.begin(); row != values.end(); ++row)
           {
-            auto rowIndex = row->first;
+            if (row->first < 0 || row->first >= rows)
+              THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row index out of bounds.");
+            for (; r <= row->first; ++r)
+              outer[r] = k;
             for (auto colVal = row->second.begin(); colVal != row->second.end(); ++colVal)
             {
-              tripletList.push_back(Triplet(rowIndex, colVal->first, colVal->second));
+              inner[k] = colVal->first;
+              data[k] = colVal->second;
+              ++k;
             }
           }
-          auto mat(boost::make_shared<SparseRowMatrixGeneric<T>>(rows, cols));
-          mat->setZero();
-          mat->setFromTriplets(tripletList.begin(), tripletList.end());
+          for (; r <= rows; ++r)
+            outer[r] = k;
+          mat->finishCompressed();
           return mat;
         }
 
@@ -97,40 +108,56 @@ namespace SCIRun
           if (rows < sparse.nrows() || cols < sparse.ncols())
             THROW_INVALID_ARGUMENT("new matrix needs to be at least the size of old matrix");
 
-          const size_type nnz = get_nnz(additionalValues) + sparse.nonZeros();
-
-          using Triplet = Eigen::Triplet<T>;
-          std::vector<Triplet> tripletList;
-          tripletList.reserve(nnz);
+          for (auto row = additionalValues.begin(); row != additionalValues.end(); ++row)
+          {
+            if (row->first < 0 || row->first >= rows)
+              THROW_INVALID_ARGUMENT("Invalid sparse row matrix array: row index out of bounds.");
+          }
 
-          for (int k = 0; k < sparse.outerSize(); ++k)
+          // Merge each row of the old matrix with the additional values of
+          // that row; both are sorted by column and an additional value
+          // replaces an existing entry. The result is written straight into
+          // the compressed storage of the new matrix.
+          const size_type nnz = get_nnz(additionalValues) + sparse.nonZeros();
+          auto mat(boost::make_shared<SparseRowMatrixGeneric<T>>(rows, cols));
+          mat->allocateCompressed(nnz);
+          auto outer = mat->get_rows();
+          auto inner = mat->get_cols();
+          auto data = mat->valuePtr();
+
+          const Row empty;
+          auto extra = additionalValues.begin();
+          index_type k = 0;
+          for (index_type r = 0; r < rows; ++r)
           {
-            for (typename SparseRowMatrixGeneric<T>::InnerIterator it(sparse, k); it; ++it)
+            outer[r] = k;
+            const Row& add = (extra != additionalValues.end() && extra->first == r) ? (extra++)->second : empty;
+            auto a = add.begin();
+
+            if (r < sparse.outerSize())
             {
-              auto row = additionalValues.find(it.row());
-              if (row != additionalValues.end())
+              for (typename SparseRowMatrixGeneric<T>::InnerIterator it(sparse, r); it; ++it)
               {
-                auto col = row->second.find(it.col());
-                if (col == row->second.end())
+                for (; a != add.end() && a->first < it.col(); ++a, ++k)
                 {
-                  tripletList.push_back(Triplet(it.row(), it.col(), it.value()));
+                  inner[k] = a->first;
+                  data[k] = a->second;
                 }
+                if (a != add.end() && a->first == it.col())
+                  continue;
+                inner[k] = it.col();
+                data[k] = it.value();
+                ++k;
               }
-              else
-                tripletList.push_back(Triplet(it.row(), it.col(), it.value()));
             }
-          }
-
-          for (auto row = additionalValues.begin(); row != additionalValues.end(); ++row)
-          {
-            auto rowIndex = row->first;
-            for (auto colVal = row->second.begin(); colVal != row->second.end(); ++colVal)
+            for (; a != add.end(); ++a, ++k)
             {
-              tripletList.push_back(Triplet(rowIndex, colVal->first, colVal->second));
+              inner[k] = a->first;
+              data[k] = a->second;
             }
           }
-          auto mat(boost::make_shared<SparseRowMatrixGeneric<T>>(rows, cols));
-          mat->setFromTriplets(tripletList.begin(), tripletList.end());
+          outer[rows] = k;
+          mat->finishCompressed();
 
           return mat;
         }
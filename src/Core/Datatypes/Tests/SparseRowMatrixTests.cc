@@ -650,6 +650,38 @@ TEST(SparseRowMatrixTest, TestLegacyConstructorWithValuesFixesBugWithBuildMappin
   EXPECT_MATRIX_EQ_TOLERANCE(expected, *convertMatrix::toDense(m), 1e-15);
 }
 
+TEST(SparseRowMatrixTest, CanFillCompressedStorageInPlace)
+{
+  SparseRowMatrix m(3, 3);
+  m.allocateCompressed(8);
+
+  // row 1 is unsorted and repeats column 2, so only 5 of 6 entries remain
+  index_type rows[] = {0, 2, 5, 6};
+  index_type cols[] = {0, 2, 2, 0, 2, 1};
+  double vals[] = {1, 2, 3, 4, 5, 6};
+  std::copy(rows, rows + 4, m.get_rows());
+  std::copy(cols, cols + 6, m.get_cols());
+  std::copy(vals, vals + 6, m.valuePtr());
+  m.finishCompressed();
+
+  DenseMatrix expected(3, 3);
+  expected << 1, 0, 2,
+    4, 0, 8,
+    0, 6, 0;
+  EXPECT_EQ(5, m.nonZeros());
+  EXPECT_EQ(5, m.data().allocatedSize());
+  EXPECT_TRUE(m.isCompressed());
+  EXPECT_MATRIX_EQ(expected, *convertMatrix::toDense(boost::make_shared<SparseRowMatrix>(m)));
+
+  SparseRowMatrix bad(2, 2);
+  bad.allocateCompressed(1);
+  bad.get_rows()[0] = 0;
+  bad.get_rows()[1] = 1;
+  bad.get_rows()[2] = 1;
+  bad.get_cols()[0] = 2;
+  EXPECT_THROW(bad.finishCompressed(), Core::InvalidArgumentException);
+}
+
 TEST(SparseRowMatrixTest, CopyBlock)
 {
   auto m = MAKE_SPARSE_MATRIX_HANDLE(
@@ -36,6 +36,7 @@ namespace Core {
 namespace Geometry {
 
 class Point;
+class PointF;
 class Vector;
 class Transform;
 class Tensor;
@@ -0,0 +1,71 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Persistent/Persistent.h>
+#include <Core/GeometryPrimitives/PointF.h>
+#include <iostream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+void
+SCIRun::Core::Geometry::Pio(Piostream& stream, PointF& p)
+{
+  stream.begin_cheap_delim();
+  float x,y,z;
+  if (! stream.reading())
+  {
+    x = static_cast<float>(p.x());
+    y = static_cast<float>(p.y());
+    z = static_cast<float>(p.z());
+  }
+  Pio(stream, x);
+  Pio(stream, y);
+  Pio(stream, z);
+  if (stream.reading())
+  {
+    p = PointF(x,y,z);
+  }
+  stream.end_cheap_delim();
+}
+
+std::ostream& SCIRun::Core::Geometry::operator<<(std::ostream& os, const PointF& p)
+{
+  return os << Point(p);
+}
+
+const TypeDescription* SCIRun::get_type_description(Core::Geometry::PointF*)
+{
+  static TypeDescription* td = 0;
+  if(!td){
+    td = new TypeDescription("PointF", Point_get_h_file_path(),
+				"SCIRun", TypeDescription::DATA_E);
+  }
+  return td;
+}
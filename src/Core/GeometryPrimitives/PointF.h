@@ -0,0 +1,87 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_GEOMETRY_POINTF_H
+#define CORE_GEOMETRY_POINTF_H
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/GeometryPrimitives/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Geometry {
+
+/// Single precision storage for a Point, used by meshes that keep their
+/// nodes in float to halve the memory of large models. A PointF converts
+/// implicitly to and from Point and all arithmetic is done on the converted
+/// Point, so geometric computations remain in double precision.
+class PointF
+{
+public:
+  PointF()
+  { d_[0] = 0.0f; d_[1] = 0.0f; d_[2] = 0.0f; }
+  PointF(double x, double y, double z)
+  { d_[0] = static_cast<float>(x); d_[1] = static_cast<float>(y); d_[2] = static_cast<float>(z); }
+  PointF(const Point& p)
+  { d_[0] = static_cast<float>(p.x()); d_[1] = static_cast<float>(p.y()); d_[2] = static_cast<float>(p.z()); }
+
+  operator Point() const { return Point(d_[0], d_[1], d_[2]); }
+
+  double x() const { return d_[0]; }
+  double y() const { return d_[1]; }
+  double z() const { return d_[2]; }
+  double operator[](int idx) const { return d_[idx]; }
+
+  Vector operator-(const Point& p) const { return Point(*this) - p; }
+  Vector operator-(const PointF& p) const { return Point(*this) - Point(p); }
+  Point operator+(const Vector& v) const { return Point(*this) + v; }
+  Point operator-(const Vector& v) const { return Point(*this) - v; }
+  Point operator*(double d) const { return Point(*this) * d; }
+
+private:
+  float d_[3];
+};
+
+inline Point operator*(double d, const PointF& p) { return p*d; }
+
+inline bool operator==(const PointF& p1, const PointF& p2)
+{ return p1[0] == p2[0] && p1[1] == p2[1] && p1[2] == p2[2]; }
+inline bool operator!=(const PointF& p1, const PointF& p2)
+{ return !(p1 == p2); }
+
+SCISHARE void Pio(Piostream&, PointF&);
+SCISHARE std::ostream& operator<<(std::ostream& os, const PointF& p);
+
+}}
+
+SCISHARE const SCIRun::TypeDescription* get_type_description(Core::Geometry::PointF*);
+}
+
+#endif
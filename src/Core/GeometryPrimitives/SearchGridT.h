@@ -35,6 +35,11 @@
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Containers/RaggedArray.h>
+#include <Core/Thread/Parallel.h>
+
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
 
 #include <algorithm>
 #include <vector>
@@ -43,6 +48,12 @@
 
 namespace SCIRun {
 
+/// Uniform grid of bins over a bounding box, each bin listing the items
+/// (nodes or elements) that overlap it. The bins are stored as one
+/// compressed row array. Grids are normally built in one pass with
+/// fill_points() or fill_boxes(), which count the bin sizes first and then
+/// scatter the items in parallel; insert() and remove() remain available
+/// for meshes that are edited after the grid was built.
 template<class INDEX>
 class SearchGridT
 {
@@ -50,7 +61,7 @@ class SearchGridT
     /// Include the types defined in Types into this class
     typedef SCIRun::index_type                    index_type;
     typedef SCIRun::size_type                     size_type;
-    typedef typename std::vector<INDEX>::iterator iterator;
+    typedef const INDEX*                          iterator;
 
     SearchGridT(size_type x, size_type y, size_type z,
                const Core::Geometry::Point &min, const Core::Geometry::Point &max) :
@@ -62,6 +73,7 @@ class SearchGridT
         transform_.pre_translate(Core::Geometry::Vector(min));
         transform_.compute_imat();
         bin_.resize(x*y*z);
+        has_points_ = false;
       }
 
     inline void transform(const Core::Geometry::Transform &t)
@@ -150,10 +162,11 @@ class SearchGridT
         {
           for (index_type k = mink; k <= maxk; k++)
           {
-            bin_[linearize(i, j, k)].push_back(val);
+            bin_.push_back(linearize(i, j, k), val);
           }
         }
       }
+      has_points_ = false;
     }
 
     void remove(INDEX val, const Core::Geometry::BBox &bbox)
@@ -169,47 +182,144 @@ class SearchGridT
         {
           for (index_type k = mink; k <= maxk; k++)
           {
-            index_type q = linearize(i, j, k);
-            std::remove(bin_[q].begin(),bin_[q].end(),val);
+            bin_.erase(linearize(i, j, k), val);
           }
         }
       }
+      has_points_ = false;
     }
 
     void insert(INDEX val, const Core::Geometry::Point &point)
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      bin_[linearize(i, j, k)].push_back(val);
+      bin_.push_back(linearize(i, j, k), val);
+      has_points_ = false;
     }
 
     void remove(INDEX val, const Core::Geometry::Point &point)
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      index_type q = linearize(i, j, k);
-      std::remove(bin_[q].begin(),bin_[q].end(),val);
+      bin_.erase(linearize(i, j, k), val);
+      has_points_ = false;
     }
 
-    inline bool lookup(iterator &begin, iterator &end, const Core::Geometry::Point &p)
+    /// Replaces the contents of the grid with the items 0..num-1, where item
+    /// n is located at point(n). The coordinates are kept next to the bins
+    /// for closest_in_bin(). As with insert(), every bin lists its items in
+    /// ascending order.
+    template <class POINTFUNC>
+    void fill_points(size_type num, POINTFUNC point)
+    {
+      std::vector<Core::Geometry::Point> pts(num);
+      Core::Thread::Parallel::For(Core::Thread::IndexRange(0, num), 0,
+        [&point, &pts](const Core::Thread::IndexRange& r)
+        {
+          for (size_t n = r.begin; n < r.end; ++n)
+            pts[n] = point(static_cast<index_type>(n));
+        });
+
+      std::vector<INDEX> items;
+      fill_bins(num,
+        [this, &pts](index_type n, index_type& mini, index_type& maxi, index_type& minj, index_type& maxj, index_type& mink, index_type& maxk)
+        {
+          clamp_locate(mini, minj, mink, pts[n]);
+          maxi = mini; maxj = minj; maxk = mink;
+        }, &point_start_, &items);
+
+      // Copy the coordinates into bin order, one array per axis, so the
+      // distance loop in closest_in_bin() runs over contiguous memory.
+      const size_t nvals = items.size();
+      px_.resize(nvals); py_.resize(nvals); pz_.resize(nvals);
+      Core::Thread::Parallel::For(Core::Thread::IndexRange(0, nvals), 0,
+        [this, &pts, &items](const Core::Thread::IndexRange& r)
+        {
+          for (size_t v = r.begin; v < r.end; ++v)
+          {
+            const Core::Geometry::Point& q = pts[items[v]];
+            px_[v] = q.x(); py_[v] = q.y(); pz_[v] = q.z();
+          }
+        });
+      has_points_ = true;
+    }
+
+    /// Replaces the contents of the grid with the items 0..num-1, where item
+    /// n is stored in every bin overlapped by the bounding box box(n).
+    template <class BOXFUNC>
+    void fill_boxes(size_type num, BOXFUNC box)
+    {
+      fill_bins(num,
+        [this, &box](index_type n, index_type& mini, index_type& maxi, index_type& minj, index_type& maxj, index_type& mink, index_type& maxk)
+        {
+          const Core::Geometry::BBox b = box(n);
+          clamp_locate(mini, minj, mink, b.get_min());
+          clamp_locate(maxi, maxj, maxk, b.get_max());
+        }, 0, 0);
+      has_points_ = false;
+      std::vector<index_type>().swap(point_start_);
+      std::vector<double>().swap(px_);
+      std::vector<double>().swap(py_);
+      std::vector<double>().swap(pz_);
+    }
+
+    /// Whether the grid was built with fill_points() and not edited since,
+    /// so closest_in_bin() can be used.
+    inline bool has_points() const { return has_points_; }
+
+    /// Finds the item of bin (i,j,k) closest to p. If its squared distance
+    /// is smaller than dmin, dmin and item are updated and true is returned.
+    /// Ties go to the first item in the bin. Requires has_points().
+    bool closest_in_bin(const Core::Geometry::Point &p, index_type i, index_type j,
+                        index_type k, double &dmin, INDEX &item) const
+    {
+      const index_type q = linearize(i, j, k);
+      const index_type b = point_start_[q];
+      const index_type e = point_start_[q+1];
+      if (b == e) return (false);
+
+      const double x = p.x(), y = p.y(), z = p.z();
+      const double* px = &px_[0];
+      const double* py = &py_[0];
+      const double* pz = &pz_[0];
+
+      // Branch free so the compiler can vectorize the scan.
+      double best = dmin;
+      index_type bestn = -1;
+      for (index_type n = b; n < e; ++n)
+      {
+        const double dx = px[n] - x, dy = py[n] - y, dz = pz[n] - z;
+        const double d = dx*dx + dy*dy + dz*dz;
+        const bool closer = d < best;
+        best = closer ? d : best;
+        bestn = closer ? n : bestn;
+      }
+      if (bestn < 0) return (false);
+
+      item = bin_.at(q, bestn - b);
+      dmin = best;
+      return (true);
+    }
+
+    inline bool lookup(iterator &begin, iterator &end, const Core::Geometry::Point &p) const
     {
       index_type i, j, k;
       if (locate(i, j, k, p))
       {
-        index_type q = linearize(i, j, k);
-        begin = bin_[q].begin();
-        end   = bin_[q].end();
+        const typename bin_type::const_row row = bin_[linearize(i, j, k)];
+        begin = row.begin();
+        end   = row.end();
         return (true);
       }
       return (false);
     }
 
     inline void lookup_ijk(iterator &begin, iterator &end, size_type i, size_type j,
-                    size_type k)
+                    size_type k) const
     {
-      index_type q = linearize(i, j, k);
-      begin = bin_[q].begin();
-      end   = bin_[q].end();
+      const typename bin_type::const_row row = bin_[linearize(i, j, k)];
+      begin = row.begin();
+      end   = row.end();
     }
 
 
@@ -238,9 +348,94 @@ class SearchGridT
     }
 
   private:
+    typedef RaggedArray<INDEX, index_type> bin_type;
+
     index_type linearize(index_type i, index_type j, index_type k) const
       { return (((i * nj_) + j) * nk_ + k); }
 
+    inline void clamp_locate(index_type &i, index_type &j, index_type &k,
+                             const Core::Geometry::Point &p) const
+    {
+      const Core::Geometry::Point r = transform_.unproject(p);
+      i = clamp_bin(r.x(), ni_);
+      j = clamp_bin(r.y(), nj_);
+      k = clamp_bin(r.z(), nk_);
+    }
+
+    static inline index_type clamp_bin(double r, index_type n)
+    {
+      // Clamp in double space to avoid overflow errors.
+      const double f = floor(r);
+      if (f < 0.0) return (0);
+      if (f >= n) return (n-1);
+      return (static_cast<index_type>(f));
+    }
+
+    /// Bulk build shared by fill_points() and fill_boxes(). range(n, ...)
+    /// returns the inclusive bin range of item n. The bin sizes are counted,
+    /// turned into offsets with a prefix sum and the items are scattered in
+    /// parallel; each bin is sorted afterwards so the result does not depend
+    /// on thread timing. The offsets and values are copied out when asked for.
+    template <class RANGEFUNC>
+    void fill_bins(size_type num, RANGEFUNC range,
+                   std::vector<index_type>* offsets_out, std::vector<INDEX>* values_out)
+    {
+      using Core::Thread::Parallel;
+      using Core::Thread::IndexRange;
+
+      const size_type nbins = ni_*nj_*nk_;
+      boost::scoped_array<boost::atomic<index_type> > count(new boost::atomic<index_type>[nbins]);
+      for (index_type q = 0; q < nbins; ++q) count[q].store(0, boost::memory_order_relaxed);
+
+      Parallel::For(IndexRange(0, num), 0,
+        [this, &range, &count](const IndexRange& r)
+        {
+          for (size_t n = r.begin; n < r.end; ++n)
+          {
+            index_type mini, maxi, minj, maxj, mink, maxk;
+            range(static_cast<index_type>(n), mini, maxi, minj, maxj, mink, maxk);
+            for (index_type i = mini; i <= maxi; i++)
+              for (index_type j = minj; j <= maxj; j++)
+                for (index_type k = mink; k <= maxk; k++)
+                  count[linearize(i, j, k)].fetch_add(1, boost::memory_order_relaxed);
+          }
+        });
+
+      std::vector<index_type> offsets(nbins + 1);
+      offsets[0] = 0;
+      for (index_type q = 0; q < nbins; ++q)
+      {
+        offsets[q+1] = offsets[q] + count[q].load(boost::memory_order_relaxed);
+        count[q].store(offsets[q], boost::memory_order_relaxed);
+      }
+
+      std::vector<INDEX> values(offsets[nbins]);
+      Parallel::For(IndexRange(0, num), 0,
+        [this, &range, &count, &values](const IndexRange& r)
+        {
+          for (size_t n = r.begin; n < r.end; ++n)
+          {
+            index_type mini, maxi, minj, maxj, mink, maxk;
+            range(static_cast<index_type>(n), mini, maxi, minj, maxj, mink, maxk);
+            for (index_type i = mini; i <= maxi; i++)
+              for (index_type j = minj; j <= maxj; j++)
+                for (index_type k = mink; k <= maxk; k++)
+                  values[count[linearize(i, j, k)].fetch_add(1, boost::memory_order_relaxed)] = static_cast<INDEX>(n);
+          }
+        });
+
+      Parallel::For(IndexRange(0, nbins), 0,
+        [&offsets, &values](const IndexRange& r)
+        {
+          for (size_t q = r.begin; q < r.end; ++q)
+            std::sort(values.begin() + offsets[q], values.begin() + offsets[q+1]);
+        });
+
+      if (offsets_out) *offsets_out = offsets;
+      if (values_out) *values_out = values;
+      bin_.assign(offsets, values);
+    }
+
 
   private:
     /// Size of the search grid
@@ -249,7 +444,12 @@ class SearchGridT
     Core::Geometry::Transform transform_;
 
     /// Where to store the lookup table
-    std::vector<std::vector<INDEX> > bin_;
+    bin_type bin_;
+
+    /// Point coordinates in bin order, valid while has_points_ is set
+    bool has_points_;
+    std::vector<index_type> point_start_;
+    std::vector<double> px_, py_, pz_;
 };
 
 
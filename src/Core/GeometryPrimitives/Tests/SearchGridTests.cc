@@ -0,0 +1,128 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/GeometryPrimitives/SearchGridT.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  std::vector<Point> randomPoints(int n)
+  {
+    std::vector<Point> pts;
+    unsigned int seed = 7;
+    for (int i = 0; i < n; ++i)
+    {
+      double c[3];
+      for (int d = 0; d < 3; ++d)
+      {
+        seed = seed * 1103515245u + 12345u;
+        c[d] = (seed >> 8) / static_cast<double>(1 << 24);
+      }
+      pts.push_back(Point(c[0], c[1], c[2]));
+    }
+    return pts;
+  }
+
+  std::vector<index_type> bin(const SearchGridT<index_type>& grid, index_type i, index_type j, index_type k)
+  {
+    SearchGridT<index_type>::iterator it, eit;
+    grid.lookup_ijk(it, eit, i, j, k);
+    return std::vector<index_type>(it, eit);
+  }
+}
+
+TEST(SearchGridTest, FillPointsMatchesSequentialInsert)
+{
+  const std::vector<Point> pts = randomPoints(2000);
+  SearchGridT<index_type> bulk(5, 4, 3, Point(0, 0, 0), Point(1, 1, 1));
+  SearchGridT<index_type> seq(5, 4, 3, Point(0, 0, 0), Point(1, 1, 1));
+
+  bulk.fill_points(pts.size(), [&pts](index_type n) { return pts[n]; });
+  for (size_t n = 0; n < pts.size(); ++n)
+    seq.insert(n, pts[n]);
+
+  EXPECT_TRUE(bulk.has_points());
+  EXPECT_FALSE(seq.has_points());
+  for (index_type i = 0; i < 5; ++i)
+    for (index_type j = 0; j < 4; ++j)
+      for (index_type k = 0; k < 3; ++k)
+        EXPECT_EQ(bin(seq, i, j, k), bin(bulk, i, j, k));
+}
+
+TEST(SearchGridTest, FillBoxesMatchesSequentialInsert)
+{
+  const std::vector<Point> pts = randomPoints(500);
+  SearchGridT<index_type> bulk(4, 4, 4, Point(0, 0, 0), Point(1, 1, 1));
+  SearchGridT<index_type> seq(4, 4, 4, Point(0, 0, 0), Point(1, 1, 1));
+
+  auto box = [&pts](index_type n)
+  {
+    BBox b;
+    b.extend(pts[n]);
+    b.extend(pts[(n + 1) % pts.size()]);
+    return b;
+  };
+  bulk.fill_boxes(pts.size(), box);
+  for (size_t n = 0; n < pts.size(); ++n)
+    seq.insert(n, box(n));
+
+  for (index_type i = 0; i < 4; ++i)
+    for (index_type j = 0; j < 4; ++j)
+      for (index_type k = 0; k < 4; ++k)
+        EXPECT_EQ(bin(seq, i, j, k), bin(bulk, i, j, k));
+}
+
+TEST(SearchGridTest, ClosestInBinFindsNearestPoint)
+{
+  const std::vector<Point> pts = randomPoints(1000);
+  SearchGridT<index_type> grid(3, 3, 3, Point(0, 0, 0), Point(1, 1, 1));
+  grid.fill_points(pts.size(), [&pts](index_type n) { return pts[n]; });
+
+  const Point p(0.5, 0.5, 0.5);
+  index_type best = -1;
+  double dmin = 1e300;
+  EXPECT_TRUE(grid.closest_in_bin(p, 1, 1, 1, dmin, best));
+
+  index_type expected = -1;
+  double emin = 1e300;
+  for (auto n : bin(grid, 1, 1, 1))
+  {
+    const double d = (pts[n] - p).length2();
+    if (d < emin) { emin = d; expected = n; }
+  }
+  EXPECT_EQ(expected, best);
+  EXPECT_EQ(emin, dmin);
+
+  EXPECT_FALSE(grid.closest_in_bin(p, 1, 1, 1, dmin, best));
+
+  grid.insert(static_cast<index_type>(pts.size()), p);
+  EXPECT_FALSE(grid.has_points());
+}
@@ -0,0 +1,303 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Logging/ExecutionTrace.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
+using namespace SCIRun::Core::Logging;
+
+CORE_SINGLETON_IMPLEMENTATION(ExecutionTracer)
+
+const size_t ExecutionTracer::EventsPerThread;
+
+// Written only by the thread that owns it, without locks. Events are stored in chunks that are
+// allocated on first use and then kept, so readers never see storage move. The owner fills a slot
+// and then publishes it by advancing head; readers copy the published range and afterwards drop
+// whatever the owner may have overwritten meanwhile, once it wrapped around the ring.
+struct ExecutionTracer::ThreadBuffer
+{
+  static const size_t ChunkSize = 1024;
+  static const size_t NumChunks = EventsPerThread / ChunkSize;
+
+  explicit ThreadBuffer(unsigned int t) : head(0), begun(0), cleared(0), thread(t)
+  {
+    for (auto& chunk : chunks)
+      chunk.store(nullptr, std::memory_order_relaxed);
+  }
+  ~ThreadBuffer()
+  {
+    for (auto& chunk : chunks)
+      delete[] chunk.load(std::memory_order_relaxed);
+  }
+
+  void append(const TraceEvent& event)
+  {
+    auto h = head.load(std::memory_order_relaxed);
+    auto slot = h % EventsPerThread;
+    auto& chunk = chunks[slot / ChunkSize];
+    auto events = chunk.load(std::memory_order_relaxed);
+    if (!events)
+    {
+      events = new TraceEvent[ChunkSize];
+      chunk.store(events, std::memory_order_release);
+    }
+    // announce the slot before overwriting it, so readers can tell their copy may be stale
+    begun.store(h + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    events[slot % ChunkSize] = event;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  void collect(std::vector<TraceEvent>& out) const
+  {
+    auto h = head.load(std::memory_order_acquire);
+    auto first = std::max(cleared.load(std::memory_order_acquire), h > EventsPerThread ? h - EventsPerThread : 0);
+    if (first >= h)
+      return;
+    auto start = out.size();
+    for (auto i = first; i < h; ++i)
+    {
+      auto slot = i % EventsPerThread;
+      out.push_back(chunks[slot / ChunkSize].load(std::memory_order_acquire)[slot % ChunkSize]);
+    }
+    // event i was replaced once the owner began writing event i + EventsPerThread
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto written = begun.load(std::memory_order_relaxed);
+    if (written > EventsPerThread && written - EventsPerThread > first)
+    {
+      auto overwritten = std::min(written - EventsPerThread, h) - first;
+      out.erase(out.begin() + start, out.begin() + start + overwritten);
+    }
+  }
+
+  std::atomic<TraceEvent*> chunks[NumChunks];
+  // Number of events written so far, and started so far; only the owner stores them.
+  std::atomic<boost::uint64_t> head;
+  std::atomic<boost::uint64_t> begun;
+  // Events before this count were discarded by clear().
+  std::atomic<boost::uint64_t> cleared;
+  unsigned int thread;
+};
+
+struct ExecutionTracer::Registry
+{
+  boost::mutex lock;
+  std::vector<boost::shared_ptr<ThreadBuffer>> buffers;
+  // Buffers whose thread has exited, waiting for the next new thread.
+  std::vector<boost::shared_ptr<ThreadBuffer>> idle;
+};
+
+// Owned by thread_specific_ptr, so it is destroyed when its thread exits and hands the buffer back.
+// The registry is weak because a thread may outlive the tracer.
+struct ExecutionTracer::ThreadSlot
+{
+  ~ThreadSlot()
+  {
+    if (auto r = registry.lock())
+    {
+      boost::mutex::scoped_lock lock(r->lock);
+      r->idle.push_back(buffer);
+    }
+  }
+  boost::shared_ptr<ThreadBuffer> buffer;
+  boost::weak_ptr<Registry> registry;
+};
+
+namespace
+{
+  void copyTruncated(char* dest, size_t size, const char* src)
+  {
+    std::strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+  }
+
+  void writeJsonString(std::ostream& out, const char* str)
+  {
+    out << '"';
+    for (const char* c = str; *c; ++c)
+    {
+      switch (*c)
+      {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(*c) >= 0x20)
+          out << *c;
+      }
+    }
+    out << '"';
+  }
+}
+
+ExecutionTracer::ExecutionTracer() : enabled_(false), registry_(new Registry)
+{
+}
+
+void ExecutionTracer::setEnabled(bool enabled)
+{
+  now(); // fix the clock origin before the first span
+  enabled_.store(enabled);
+}
+
+boost::uint64_t ExecutionTracer::now()
+{
+  static const auto origin = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+ExecutionTracer::ThreadBuffer& ExecutionTracer::threadBuffer()
+{
+  auto slot = current_.get();
+  if (!slot)
+  {
+    slot = new ThreadSlot;
+    slot->registry = registry_;
+    {
+      boost::mutex::scoped_lock lock(registry_->lock);
+      if (!registry_->idle.empty())
+      {
+        slot->buffer = registry_->idle.back();
+        registry_->idle.pop_back();
+      }
+      else
+      {
+        slot->buffer.reset(new ThreadBuffer(static_cast<unsigned int>(registry_->buffers.size())));
+        registry_->buffers.push_back(slot->buffer);
+      }
+    }
+    current_.reset(slot);
+  }
+  return *slot->buffer;
+}
+
+void ExecutionTracer::record(const char* category, const std::string& name, boost::uint64_t begin, boost::uint64_t end)
+{
+  TraceEvent event;
+  copyTruncated(event.category, sizeof(event.category), category);
+  copyTruncated(event.name, sizeof(event.name), name.c_str());
+  event.begin = begin;
+  event.end = std::max(begin, end);
+
+  auto& buffer = threadBuffer();
+  event.thread = buffer.thread;
+  buffer.append(event);
+}
+
+std::vector<TraceEvent> ExecutionTracer::events() const
+{
+  std::vector<TraceEvent> all;
+  {
+    boost::mutex::scoped_lock lock(registry_->lock);
+    for (const auto& buffer : registry_->buffers)
+      buffer->collect(all);
+  }
+  std::stable_sort(all.begin(), all.end(), [](const TraceEvent& a, const TraceEvent& b) { return a.begin < b.begin; });
+  return all;
+}
+
+void ExecutionTracer::clear()
+{
+  boost::mutex::scoped_lock lock(registry_->lock);
+  for (auto& buffer : registry_->buffers)
+    buffer->cleared.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+void ExecutionTracer::writeChromeTrace(std::ostream& out) const
+{
+  auto all = events();
+  unsigned int threads;
+  {
+    boost::mutex::scoped_lock lock(registry_->lock);
+    threads = static_cast<unsigned int>(registry_->buffers.size());
+  }
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (unsigned int t = 0; t < threads; ++t)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+  }
+  for (const auto& event : all)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":";
+    writeJsonString(out, event.name);
+    out << ",\"cat\":";
+    writeJsonString(out, event.category);
+    out << ",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << (event.end - event.begin)
+      << ",\"pid\":1,\"tid\":" << event.thread << "}";
+  }
+  out << "\n]}\n";
+}
+
+bool ExecutionTracer::writeChromeTrace(const boost::filesystem::path& file) const
+{
+  std::ofstream out(file.string().c_str());
+  if (!out)
+    return false;
+  writeChromeTrace(out);
+  return static_cast<bool>(out);
+}
+
+ScopedTraceSpan::ScopedTraceSpan(const char* category, const std::string& name) :
+  category_(category), begin_(0), active_(ExecutionTracer::Instance().enabled())
+{
+  if (active_)
+  {
+    name_ = name;
+    begin_ = ExecutionTracer::now();
+  }
+}
+
+ScopedTraceSpan::ScopedTraceSpan(const char* category, const std::string& name, const std::string& detail) :
+  category_(category), begin_(0), active_(ExecutionTracer::Instance().enabled())
+{
+  if (active_)
+  {
+    name_ = name + " " + detail;
+    begin_ = ExecutionTracer::now();
+  }
+}
+
+ScopedTraceSpan::~ScopedTraceSpan()
+{
+  if (active_)
+    ExecutionTracer::Instance().record(category_, name_, begin_, ExecutionTracer::now());
+}
@@ -0,0 +1,122 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_LOGGING_EXECUTIONTRACE_H
+#define CORE_LOGGING_EXECUTIONTRACE_H
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/tss.hpp>
+#include <Core/Utils/Singleton.h>
+#include <Core/Logging/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Logging
+    {
+      /// A completed span of wall time on one thread. Times are microseconds since the tracer was created.
+      struct SCISHARE TraceEvent
+      {
+        char category[16];
+        char name[112];
+        boost::uint64_t begin;
+        boost::uint64_t end;
+        unsigned int thread;
+      };
+
+      /// Records wall-clock spans (module execution, queue wait, port transfer, algorithm phases) into
+      /// per-thread ring buffers and writes them as Chrome trace event JSON, which chrome://tracing and
+      /// ui.perfetto.dev display as one timeline row per thread.
+      ///
+      /// Each thread appends to its own buffer without taking a lock; readers copy what has been published and
+      /// never block the writer. Recording is off until setEnabled(true); while off, a span costs one atomic
+      /// load. Buffers grow in chunks as events arrive, up to EventsPerThread, after which the oldest events are
+      /// overwritten. clear() drops the recorded events but keeps the chunks for the threads to reuse. When a thread
+      /// exits its buffer, events included, passes to the next thread that records, so the number of buffers
+      /// is bounded by the threads tracing at once rather than by every thread ever created.
+      class SCISHARE ExecutionTracer final
+      {
+        CORE_SINGLETON(ExecutionTracer)
+      public:
+        ExecutionTracer();
+        void setEnabled(bool enabled);
+        bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+        /// Microseconds on a monotonic clock, shared by all threads.
+        static boost::uint64_t now();
+
+        void record(const char* category, const std::string& name, boost::uint64_t begin, boost::uint64_t end);
+
+        /// Snapshot of the recorded events, ordered by begin time.
+        std::vector<TraceEvent> events() const;
+        void clear();
+
+        void writeChromeTrace(std::ostream& out) const;
+        bool writeChromeTrace(const boost::filesystem::path& file) const;
+
+        static const size_t EventsPerThread = 1 << 16;
+      private:
+        struct ThreadBuffer;
+        struct Registry;
+        struct ThreadSlot;
+        ThreadBuffer& threadBuffer();
+
+        std::atomic<bool> enabled_;
+        boost::shared_ptr<Registry> registry_;
+        boost::thread_specific_ptr<ThreadSlot> current_;
+      };
+
+      /// Records the lifetime of the scope as one span, if tracing is enabled when the scope begins.
+      class SCISHARE ScopedTraceSpan
+      {
+      public:
+        ScopedTraceSpan(const char* category, const std::string& name);
+        /// The name is only concatenated when tracing is enabled.
+        ScopedTraceSpan(const char* category, const std::string& name, const std::string& detail);
+        ~ScopedTraceSpan();
+      private:
+        ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+        ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+        const char* category_;
+        std::string name_;
+        boost::uint64_t begin_;
+        bool active_;
+      };
+    }
+  }
+}
+
+#endif
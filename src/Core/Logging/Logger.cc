@@ -32,22 +32,38 @@
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Logging/ScopedTimeRemarker.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionTrace.h>
 
 using namespace SCIRun::Core::Logging;
 
 LegacyLoggerInterface::~LegacyLoggerInterface() {}
 
-ScopedTimeRemarker::ScopedTimeRemarker(LegacyLoggerInterface* log, const std::string& label) : log_(log), label_(label)
+namespace
+{
+  double secondsSince(boost::uint64_t begin, boost::uint64_t end)
+  {
+    return (end - begin) * 1e-6;
+  }
+}
+
+ScopedTimeRemarker::ScopedTimeRemarker(LegacyLoggerInterface* log, const std::string& label) : log_(log), label_(label),
+  begin_(ExecutionTracer::now())
 {}
 
 ScopedTimeRemarker::~ScopedTimeRemarker()
 {
+  auto end = ExecutionTracer::now();
+  auto& tracer = ExecutionTracer::Instance();
+  if (tracer.enabled())
+    tracer.record("algorithm", label_, begin_, end);
+
   std::ostringstream perf;
-  perf << label_ <<  " took " << timer_.elapsed() << " seconds." << std::endl;
+  perf << label_ <<  " took " << secondsSince(begin_, end) << " seconds." << std::endl;
   log_->status(perf.str());
 }
 
-ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): label_(label), shouldLog_(shouldLog)
+ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): label_(label), shouldLog_(shouldLog),
+  begin_(ExecutionTracer::now())
 {
   if (shouldLog_)
     LOG_DEBUG("{} starting.", label_);
@@ -55,7 +71,12 @@ ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): la
 
 ScopedTimeLogger::~ScopedTimeLogger()
 {
-  auto time = timer_.elapsed();
+  auto end = ExecutionTracer::now();
+  auto& tracer = ExecutionTracer::Instance();
+  if (tracer.enabled())
+    tracer.record("algorithm", label_, begin_, end);
+
+  auto time = secondsSince(begin_, end);
   if (shouldLog_)
     LOG_DEBUG("{} took {} seconds.", label_, time);
 }
@@ -32,7 +32,7 @@
 #define CORE_LOGGING_SCOPEDTIMEREMARKER_H
 
 #include <string>
-#include <boost/timer.hpp>
+#include <boost/cstdint.hpp>
 #include <Core/Logging/LoggerFwd.h>
 #include <Core/Logging/share.h>
 
@@ -42,6 +42,8 @@ namespace SCIRun
   {
     namespace Logging
     {
+      /// Both report wall-clock time, so multithreaded work is not counted once per thread,
+      /// and record their scope as an "algorithm" span when execution tracing is enabled.
       class SCISHARE ScopedTimeRemarker
       {
       public:
@@ -50,7 +52,7 @@ namespace SCIRun
       private:
         LegacyLoggerInterface* log_;
         std::string label_;
-        boost::timer timer_;
+        boost::uint64_t begin_;
       };
 
       class SCISHARE ScopedTimeLogger
@@ -61,7 +63,7 @@ namespace SCIRun
       private:
         std::string label_;
         bool shouldLog_;
-        boost::timer timer_;
+        boost::uint64_t begin_;
       };
     }
   }
@@ -0,0 +1,206 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <boost/thread.hpp>
+#include <Core/Logging/ExecutionTrace.h>
+
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  class ExecutionTraceTests : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      ExecutionTracer::Instance().clear();
+    }
+    void TearDown() override
+    {
+      ExecutionTracer::Instance().setEnabled(false);
+      ExecutionTracer::Instance().clear();
+    }
+  };
+}
+
+TEST_F(ExecutionTraceTests, SpansAreOnlyRecordedWhenEnabled)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(false);
+  {
+    ScopedTraceSpan span("module", "ignored");
+  }
+  EXPECT_TRUE(tracer.events().empty());
+
+  tracer.setEnabled(true);
+  {
+    ScopedTraceSpan span("port", "ReadField:0", "Field:0");
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+  }
+  auto events = tracer.events();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_STREQ("port", events[0].category);
+  EXPECT_STREQ("ReadField:0 Field:0", events[0].name);
+  EXPECT_GE(events[0].end - events[0].begin, 4000u);
+}
+
+TEST_F(ExecutionTraceTests, ThreadsRecordOnSeparateTimelines)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+
+  const int numThreads = 4;
+  // keep every thread alive until all have recorded, so none hands its buffer to another
+  boost::barrier allRecorded(numThreads);
+  boost::thread_group threads;
+  for (int t = 0; t < numThreads; ++t)
+    threads.create_thread([&allRecorded]()
+    {
+      for (int i = 0; i < 100; ++i)
+        ScopedTraceSpan span("algorithm", "phase");
+      allRecorded.wait();
+    });
+  threads.join_all();
+
+  auto events = tracer.events();
+  ASSERT_EQ(numThreads * 100u, events.size());
+  std::set<unsigned int> ids;
+  for (const auto& e : events)
+    ids.insert(e.thread);
+  EXPECT_EQ(numThreads, static_cast<int>(ids.size()));
+  for (size_t i = 1; i < events.size(); ++i)
+    EXPECT_LE(events[i - 1].begin, events[i].begin);
+}
+
+TEST_F(ExecutionTraceTests, ExitedThreadsHandTheirBufferOn)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+
+  const int numThreads = 20;
+  for (int t = 0; t < numThreads; ++t)
+  {
+    boost::thread thread([]() { ScopedTraceSpan span("module", "run"); });
+    thread.join();
+  }
+
+  auto events = tracer.events();
+  ASSERT_EQ(static_cast<size_t>(numThreads), events.size());
+  std::set<unsigned int> ids;
+  for (const auto& e : events)
+    ids.insert(e.thread);
+  EXPECT_EQ(1u, ids.size());
+}
+
+TEST_F(ExecutionTraceTests, ClearWhileRecordingKeepsEventsWhole)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+
+  std::atomic<bool> done(false);
+  boost::thread writer([&done]()
+  {
+    auto& t = ExecutionTracer::Instance();
+    for (int i = 0; i < 20000; ++i)
+      t.record("module", i % 2 ? "odd" : "even", i, i + 1);
+    done = true;
+  });
+  while (!done)
+  {
+    for (const auto& e : tracer.events())
+    {
+      EXPECT_EQ(e.begin + 1, e.end);
+      EXPECT_STREQ(e.begin % 2 ? "odd" : "even", e.name);
+    }
+    tracer.clear();
+  }
+  writer.join();
+  EXPECT_LE(tracer.events().size(), 20000u);
+}
+
+TEST_F(ExecutionTraceTests, ReadingWhileTheRingWrapsKeepsEventsWhole)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+
+  const auto total = 3 * ExecutionTracer::EventsPerThread;
+  std::atomic<bool> done(false);
+  boost::thread writer([&done, total]()
+  {
+    auto& t = ExecutionTracer::Instance();
+    for (size_t i = 0; i < total; ++i)
+      t.record("module", i % 2 ? "odd" : "even", i, i + 1);
+    done = true;
+  });
+  while (!done)
+  {
+    auto events = tracer.events();
+    EXPECT_LE(events.size(), ExecutionTracer::EventsPerThread);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      EXPECT_STREQ(events[i].begin % 2 ? "odd" : "even", events[i].name);
+      // a copy is either dropped or whole, so the kept events stay consecutive
+      if (i > 0)
+        ASSERT_EQ(events[i - 1].begin + 1, events[i].begin);
+    }
+  }
+  writer.join();
+  EXPECT_EQ(ExecutionTracer::EventsPerThread, tracer.events().size());
+}
+
+TEST_F(ExecutionTraceTests, FullBufferKeepsNewestEvents)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+  const auto extra = 10;
+  for (size_t i = 0; i < ExecutionTracer::EventsPerThread + extra; ++i)
+    tracer.record("module", "m", i, i + 1);
+
+  auto events = tracer.events();
+  ASSERT_EQ(ExecutionTracer::EventsPerThread, events.size());
+  EXPECT_EQ(static_cast<boost::uint64_t>(extra), events.front().begin);
+}
+
+TEST_F(ExecutionTraceTests, WritesChromeTraceEvents)
+{
+  auto& tracer = ExecutionTracer::Instance();
+  tracer.setEnabled(true);
+  tracer.record("module", "Read\"Field\":0", 10, 25);
+
+  std::ostringstream json;
+  tracer.writeChromeTrace(json);
+  auto str = json.str();
+  EXPECT_EQ(0u, str.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, str.find("{\"name\":\"Read\\\"Field\\\":0\",\"cat\":\"module\",\"ph\":\"X\",\"ts\":10,\"dur\":15,\"pid\":1,\"tid\":"));
+  EXPECT_NE(std::string::npos, str.find("\"ph\":\"M\""));
+}
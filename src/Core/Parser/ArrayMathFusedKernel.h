@@ -0,0 +1,93 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_PARSER_ARRAYMATHFUSEDKERNEL_H
+#define CORE_PARSER_ARRAYMATHFUSEDKERNEL_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <vector>
+
+// Include files needed for Windows
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+//-----------------------------------------------------------------------------
+// A run of consecutive sequential instructions that only do elementwise
+// arithmetic on scalar, vector or tensor buffers. The operand pointers are
+// resolved when the program is translated, so running the kernel is a tight
+// loop per instruction over the current chunk without going through the
+// boost::function and operand variant of each ArrayMathProgramCode. The loops
+// are plain indexed loops the compiler can vectorize; with a chunk that fits
+// in L1 all temporaries stay in cache between instructions.
+
+class SCISHARE ArrayMathFusedKernel : boost::noncopyable {
+  public:
+    typedef void (*Kernel)(double* out, const double* in0, const double* in1, size_type n);
+
+    // Whether the function with this id has an elementwise kernel
+    static bool is_fusable(const std::string& function_id);
+
+    // Append an instruction; in1 is ignored for unary functions.
+    // Returns false if the function is not fusable.
+    bool add_instruction(const std::string& function_id,
+                         double* out, const double* in0, const double* in1);
+
+    size_t num_instructions() const { return (instructions_.size()); }
+
+    // Run all instructions over size elements
+    void run(size_type size) const
+    {
+      for (const auto& ins : instructions_)
+        ins.kernel(ins.out, ins.in0, ins.in1, size*ins.width);
+    }
+
+  private:
+    struct Instruction
+    {
+      Kernel        kernel;
+      double*       out;
+      const double* in0;
+      const double* in1;
+      // number of doubles per element: 1, 3 or 6
+      size_type     width;
+    };
+
+    std::vector<Instruction> instructions_;
+};
+
+typedef boost::shared_ptr<ArrayMathFusedKernel> ArrayMathFusedKernelHandle;
+
+}
+
+#endif
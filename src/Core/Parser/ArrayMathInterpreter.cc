@@ -39,6 +39,52 @@ using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 
+namespace {
+
+  // Size of the level 1 data cache the sequential buffers of one thread
+  // should fit in
+  const size_type l1_cache_bytes = 32*1024;
+
+  // Number of values per chunk so that a chunk of every sequential variable
+  // fits in L1, a multiple of 8 to keep the vectorized loops aligned
+  size_type l1_buffer_size(size_type doubles_per_value)
+  {
+    if (doubles_per_value == 0) return (128);
+    size_type buffer_size = l1_cache_bytes/(static_cast<size_type>(sizeof(double))*doubles_per_value);
+    buffer_size = std::max<size_type>(16, std::min<size_type>(1024, buffer_size));
+    return (buffer_size & ~size_type(7));
+  }
+
+  // Add the function to the kernel if it is elementwise arithmetic on
+  // sequential buffers
+  bool fuse_function(ParserScriptFunctionHandle& fhandle,
+                     ArrayMathProgramCode& pc,
+                     ArrayMathFusedKernel& kernel)
+  {
+    const std::string& function_id = fhandle->get_function()->get_function_id();
+    if (!ArrayMathFusedKernel::is_fusable(function_id)) return (false);
+
+    std::string type = fhandle->get_output_var()->get_type();
+    if (type != "S" && type != "V" && type != "T") return (false);
+
+    size_t num_input_vars = fhandle->num_input_vars();
+    if (num_input_vars < 1 || num_input_vars > 2) return (false);
+    for (size_t i=0; i < num_input_vars; i++)
+    {
+      if (!(fhandle->get_input_var(i)->get_flags() & SCRIPT_SEQUENTIAL_VAR_E))
+        return (false);
+    }
+
+    double* out = pc.get_variable(0);
+    double* in0 = pc.get_variable(1);
+    double* in1 = (num_input_vars > 1) ? pc.get_variable(2) : 0;
+    if (!out || !in0 || (num_input_vars > 1 && !in1)) return (false);
+
+    return (kernel.add_instruction(function_id, out, in0, in1));
+  }
+
+}
+
 ArrayMathFunction::ArrayMathFunction(
       ArrayMathFunctionPtr function,
       const std::string& function_id,
@@ -145,6 +191,22 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
+  // Size the chunks so the sequential buffers of one thread stay in L1
+  if (!mprogram->has_fixed_buffer_size())
+  {
+    size_type doubles_per_value = 0;
+    for (size_t j=0; j<num_sequential_variables; j++)
+    {
+      pprogram->get_sequential_variable(j,vhandle);
+      std::string type = vhandle->get_type();
+
+      if (type == "S") { doubles_per_value += 1; }
+      else if (type == "V") { doubles_per_value += 3; }
+      else if (type == "T") { doubles_per_value += 6; }
+    }
+    mprogram->set_buffer_size(l1_buffer_size(doubles_per_value));
+  }
+
   // Determine how many space we need to reserve for sequential variables
   auto buffer_size = mprogram->get_buffer_size();
   int num_proc    = mprogram->get_num_proc();
@@ -1186,6 +1248,31 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
       }
       mprogram->set_sequential_program_code(j,np,pcPtr);
     }
+
+    // Replace runs of elementwise arithmetic by fused kernels
+    ArrayMathFusedKernelHandle kernel;
+    size_t kernel_start = 0;
+    for (size_t j=0; j<=num_sequential_functions; j++)
+    {
+      bool fused = false;
+      if (j < num_sequential_functions)
+      {
+        if (!kernel)
+        {
+          kernel.reset(new ArrayMathFusedKernel);
+          kernel_start = j;
+        }
+        pprogram->get_sequential_function(j,fhandle);
+        fused = fuse_function(fhandle,*(mprogram->get_sequential_program_code(j,np)),*kernel);
+      }
+
+      if (!fused && kernel)
+      {
+        if (kernel->num_instructions() > 0)
+          mprogram->set_sequential_kernel(kernel_start,np,kernel);
+        kernel.reset();
+      }
+    }
   }
 
   return (true);
@@ -1547,18 +1634,26 @@ ArrayMathProgram::run_parallel(int proc)
     if (offset+sz >= end) sz = end-offset;
 
     size_t size = sequential_functions_[proc].size();
-    for (size_t j=0; j<size;j++)
+    size_t j = 0;
+    while (j < size)
     {
-      sequential_functions_[proc][j]->set_index(offset);
-      sequential_functions_[proc][j]->set_size(sz);
-    }
-    for (size_t j=0; j<size; j++)
-    {
-      if(!(sequential_functions_[proc][j]->run()))
+      const ArrayMathFusedKernelHandle& kernel = sequential_kernels_[proc][j];
+      if (kernel)
+      {
+        kernel->run(sz);
+        j += kernel->num_instructions();
+        continue;
+      }
+
+      ArrayMathProgramCode& pc = *(sequential_functions_[proc][j]);
+      pc.set_index(offset);
+      pc.set_size(sz);
+      if(!(pc.run()))
       {
         error_line_[proc] = j;
         success_[proc] = false;
       }
+      j++;
     }
     offset += sz;
   }
@@ -39,6 +39,7 @@
 #include <Core/Containers/StackBasedVector.h>
 
 #include <Core/Parser/Parser.h>
+#include <Core/Parser/ArrayMathFusedKernel.h>
 
 #include <boost/function.hpp>
 #include <boost/variant.hpp>
@@ -315,8 +316,10 @@ class SCISHARE ArrayMathProgramSource {
     ArrayMathProgram() : num_proc_(Core::Thread::Parallel::NumCores()), barrier_("ArrayMathProgram", num_proc_)
     {
       // Buffer size describes how many values of a sequential variable are
-      // grouped together for vectorized execution
+      // grouped together for vectorized execution. This is a default, the
+      // interpreter sizes it to fit the program in L1 when translating.
       buffer_size_ = 128;
+      fixed_buffer_size_ = false;
       array_size_ = 1;
     }
 
@@ -329,6 +332,7 @@ class SCISHARE ArrayMathProgramSource {
       // Buffer size describes how many values of a sequential variable are
       // grouped together for vectorized execution
       buffer_size_ = buffer_size;
+      fixed_buffer_size_ = true;
       array_size_ = array_size;
     }
 
@@ -337,6 +341,10 @@ class SCISHARE ArrayMathProgramSource {
     // when allocated
     // Get the number of entries that are processed at once
     size_type get_buffer_size() const { return (buffer_size_); }
+    // Whether the buffer size was given to the constructor
+    bool has_fixed_buffer_size() const { return (fixed_buffer_size_); }
+    // Only valid before the buffers are created
+    void set_buffer_size(size_type buffer_size) { buffer_size_ = buffer_size; }
     // Get the number of processors
     int get_num_proc() const { return (num_proc_); }
 
@@ -376,8 +384,13 @@ class SCISHARE ArrayMathProgramSource {
     void resize_sequential_functions(size_t sz)
       {
         sequential_functions_.resize(num_proc_);
+        sequential_kernels_.resize(num_proc_);
         for (int np=0; np < num_proc_; np++)
+        {
           sequential_functions_[np].resize(sz);
+          sequential_kernels_[np].clear();
+          sequential_kernels_[np].resize(sz);
+        }
       }
 
     // Central buffer for all parameters
@@ -407,6 +420,13 @@ class SCISHARE ArrayMathProgramSource {
       { single_functions_[j] = pc; }
     void set_sequential_program_code(size_t j, size_t np, ArrayMathProgramCodePtr pc)
       { sequential_functions_[np][j] = pc; }
+    ArrayMathProgramCodePtr get_sequential_program_code(size_t j, size_t np) const
+      { return (sequential_functions_[np][j]); }
+
+    // Set a fused kernel that replaces the sequential functions j up to
+    // j+kernel->num_instructions()
+    void set_sequential_kernel(size_t j, size_t np, ArrayMathFusedKernelHandle kernel)
+      { sequential_kernels_[np][j] = kernel; }
 
     // Code to find the pointers that are given for sources and sinks
     bool find_source(const std::string& name,  ArrayMathProgramSource& ps);
@@ -424,6 +444,7 @@ class SCISHARE ArrayMathProgramSource {
     // General parameters that determine how many values are computed at
     // the same time and how many processors to use
     size_type buffer_size_;
+    bool fixed_buffer_size_;
     int num_proc_;
 
     // The size of the array we are using
@@ -445,6 +466,8 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<ArrayMathProgramCodePtr> const_functions_;
     std::vector<ArrayMathProgramCodePtr> single_functions_;
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
+    // Fused kernels, stored at the index of the first function they replace
+    std::vector<std::vector<ArrayMathFusedKernelHandle> > sequential_kernels_;
 
     ParserProgramHandle pprogram_;
 
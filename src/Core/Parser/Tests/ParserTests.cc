@@ -1404,6 +1404,61 @@ TEST_F(BasicParserTests, CreateFieldData_find_normal2)
   EXPECT_NEAR(19.4422, max,1e-4);
 }
 
+TEST_F(BasicParserTests, FusedArithmeticMatchesNodeValues)
+{
+  // enough nodes for several chunks per thread, and not a multiple of the chunk size
+  FieldHandle field(CreateEmptyLatVol(37, 29, 23));
+
+  NewArrayMathEngine engine;
+  setupEngine(engine, field);
+
+  ASSERT_TRUE(engine.add_expressions("RESULT = sqrt(X*X+Y*Y+Z*Z) - abs(X-Y)/2 + exp(-Z)*cos(Y);"));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+
+  auto vmesh = ofield->vmesh();
+  auto vfield = ofield->vfield();
+  ASSERT_EQ(vmesh->num_nodes(), vfield->num_values());
+  for (VMesh::Node::index_type i = 0; i < vmesh->num_nodes(); ++i)
+  {
+    Point p;
+    vmesh->get_center(p, i);
+    const double x = p.x(), y = p.y(), z = p.z();
+    double value;
+    vfield->get_value(value, i);
+    EXPECT_NEAR(std::sqrt(x*x+y*y+z*z) - std::abs(x-y)/2 + std::exp(-z)*std::cos(y), value, 1e-12);
+  }
+}
+
+TEST_F(BasicParserTests, FusedVectorArithmetic)
+{
+  FieldHandle field(CreateEmptyLatVol(11, 13, 17));
+
+  NewArrayMathEngine engine;
+  setupEngine(engine, field);
+
+  ASSERT_TRUE(engine.add_expressions("RESULT = length(-(POS - vector(X,Z,Y)) + POS);"));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+
+  auto vmesh = ofield->vmesh();
+  auto vfield = ofield->vfield();
+  for (VMesh::Node::index_type i = 0; i < vmesh->num_nodes(); ++i)
+  {
+    Point p;
+    vmesh->get_center(p, i);
+    double value;
+    vfield->get_value(value, i);
+    EXPECT_NEAR(Vector(p.x(), p.z(), p.y()).length(), value, 1e-12);
+  }
+}
+
 
 //Run these tests when the functions below are implemented
 /*
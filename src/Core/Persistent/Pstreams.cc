@@ -1746,6 +1746,14 @@ FastPiostream::FastPiostream(const std::string& filename, Direction dir,
       return;
     }
     readHeader(reporter_, filename, hdr, "FAS", version_, file_endian);
+    // newer writers add an endianness line; skip it
+    char endianLine[4];
+    if (version() > 1 && fread(endianLine, sizeof(char), 4, fp_) != 4)
+    {
+      reporter_->error("Error reading header from: " + filename);
+      err = true;
+      return;
+    }
   }
   else
   {
@@ -1814,6 +1822,14 @@ fp_(0)
       return;
     }
     readHeader(reporter_, "socket", hdr, "FAS", version_, file_endian);
+    char endianLine[4];
+    if (version() > 1 && fread(endianLine, sizeof(char), 4, fp_) != 4)
+    {
+      reporter_->error("Error reading header from socket: " +
+        to_string(fd) + ".");
+      err = true;
+      return;
+    }
   }
   else
   {
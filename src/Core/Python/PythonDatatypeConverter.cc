@@ -37,10 +37,13 @@
 #include <Core/Python/PythonDatatypeConverter.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/String.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Matlab/matlabarray.h>
 #include <Core/Matlab/matlabconverter.h>
+#include <cstring>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Python;
@@ -91,6 +94,275 @@ namespace
     list["values"] = values;
     return list;
   }
+
+  // Python object exporting a block of datatype memory through the buffer protocol. It holds the datatype handle,
+  // so a memoryview or numpy array derived from it keeps the SCIRun data alive.
+  struct BufferExport
+  {
+    DatatypeHandle owner;
+    void* data;
+    std::string format;
+    Py_ssize_t itemsize;
+    std::vector<Py_ssize_t> shape, strides;
+    bool readonly;
+  };
+
+  struct PyDatatypeBuffer
+  {
+    PyObject_HEAD
+    BufferExport* exported;
+  };
+
+  int getDatatypeBuffer(PyObject* self, Py_buffer* view, int flags)
+  {
+    const auto& exported = *reinterpret_cast<PyDatatypeBuffer*>(self)->exported;
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && exported.readonly)
+    {
+      PyErr_SetString(PyExc_BufferError, "SCIRun datatype buffer is read-only");
+      view->obj = nullptr;
+      return -1;
+    }
+    if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && exported.shape.size() > 1
+      && exported.shape[0] > 1 && exported.shape[1] > 1)
+    {
+      PyErr_SetString(PyExc_BufferError, "SCIRun datatype buffer is row-major");
+      view->obj = nullptr;
+      return -1;
+    }
+
+    Py_ssize_t count = 1;
+    for (auto extent : exported.shape)
+      count *= extent;
+
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = exported.data;
+    view->len = count * exported.itemsize;
+    view->readonly = exported.readonly ? 1 : 0;
+    view->itemsize = exported.itemsize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(exported.format.c_str()) : nullptr;
+    view->ndim = static_cast<int>(exported.shape.size());
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? const_cast<Py_ssize_t*>(exported.shape.data()) : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? const_cast<Py_ssize_t*>(exported.strides.data()) : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+  }
+
+  void deallocDatatypeBuffer(PyObject* self)
+  {
+    delete reinterpret_cast<PyDatatypeBuffer*>(self)->exported;
+    Py_TYPE(self)->tp_free(self);
+  }
+
+  PyBufferProcs datatypeBufferProcs = { getDatatypeBuffer, nullptr };
+
+  PyTypeObject* datatypeBufferType()
+  {
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+    if (!type.tp_name)
+    {
+      type.tp_name = "SCIRunPythonAPI.DatatypeBuffer";
+      type.tp_doc = "Shared memory of a SCIRun datatype";
+      type.tp_basicsize = sizeof(PyDatatypeBuffer);
+      type.tp_dealloc = deallocDatatypeBuffer;
+      type.tp_as_buffer = &datatypeBufferProcs;
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+      if (PyType_Ready(&type) < 0)
+      {
+        type.tp_name = nullptr;
+        boost::python::throw_error_already_set();
+      }
+    }
+    return &type;
+  }
+
+  inline const char* bufferFormat(const char*) { return "b"; }
+  inline const char* bufferFormat(const unsigned char*) { return "B"; }
+  inline const char* bufferFormat(const short*) { return "h"; }
+  inline const char* bufferFormat(const unsigned short*) { return "H"; }
+  inline const char* bufferFormat(const int*) { return "i"; }
+  inline const char* bufferFormat(const unsigned int*) { return "I"; }
+  inline const char* bufferFormat(const long*) { return "l"; }
+  inline const char* bufferFormat(const unsigned long*) { return "L"; }
+  inline const char* bufferFormat(const long long*) { return "q"; }
+  inline const char* bufferFormat(const unsigned long long*) { return "Q"; }
+  inline const char* bufferFormat(const float*) { return "f"; }
+  inline const char* bufferFormat(const double*) { return "d"; }
+
+  /// Row-major view of `data`; strides default to C-contiguous.
+  template <typename T>
+  boost::python::object exportBuffer(DatatypeHandle owner, const T* data, std::vector<Py_ssize_t> shape, bool readonly,
+    std::vector<Py_ssize_t> strides = {})
+  {
+    if (strides.empty())
+    {
+      strides.resize(shape.size());
+      Py_ssize_t stride = sizeof(T);
+      for (auto i = shape.size(); i-- > 0; )
+      {
+        strides[i] = stride;
+        stride *= shape[i];
+      }
+    }
+
+    std::unique_ptr<BufferExport> exported(new BufferExport { owner, const_cast<T*>(data), bufferFormat(data),
+      static_cast<Py_ssize_t>(sizeof(T)), std::move(shape), std::move(strides), readonly });
+
+    auto self = PyObject_New(PyDatatypeBuffer, datatypeBufferType());
+    if (!self)
+      boost::python::throw_error_already_set();
+    self->exported = exported.release();
+    boost::python::handle<> exporter(reinterpret_cast<PyObject*>(self));
+    return boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(exporter.get())));
+  }
+
+  /// Follows memoryview bases and numpy `.base` links back to one of our exporters.
+  const BufferExport* findBufferExport(PyObject* obj)
+  {
+    for (int depth = 0; obj && depth < 8; ++depth)
+    {
+      if (Py_TYPE(obj) == datatypeBufferType())
+        return reinterpret_cast<PyDatatypeBuffer*>(obj)->exported;
+      if (PyMemoryView_Check(obj))
+      {
+        obj = PyMemoryView_GET_BASE(obj);
+      }
+      else if (obj != Py_None && PyObject_HasAttrString(obj, "base"))
+      {
+        // borrowed for the rest of the walk: the referring object keeps it alive
+        boost::python::handle<> base(boost::python::allow_null(PyObject_GetAttrString(obj, "base")));
+        obj = base.get();
+      }
+      else
+        return nullptr;
+    }
+    return nullptr;
+  }
+
+  class ScopedBuffer : boost::noncopyable
+  {
+  public:
+    explicit ScopedBuffer(PyObject* obj) : valid_(false)
+    {
+      if (!PyBytes_Check(obj) && !PyByteArray_Check(obj) && !PyUnicode_Check(obj) && PyObject_CheckBuffer(obj))
+      {
+        valid_ = 0 == PyObject_GetBuffer(obj, &view_, PyBUF_STRIDES | PyBUF_FORMAT);
+        if (!valid_)
+          PyErr_Clear();
+      }
+    }
+    ~ScopedBuffer()
+    {
+      if (valid_)
+        PyBuffer_Release(&view_);
+    }
+
+    bool valid() const { return valid_; }
+    const Py_buffer& view() const { return view_; }
+    Py_ssize_t rows() const { return view_.ndim > 0 ? view_.shape[0] : 1; }
+    Py_ssize_t cols() const { return view_.ndim > 1 ? view_.shape[1] : 1; }
+
+    /// Single-character struct code of a native-order numeric element type, or 0.
+    char typeCode() const
+    {
+      if (!valid_)
+        return 0;
+      const char* format = view_.format ? view_.format : "B";
+      if ('@' == *format)
+        ++format;
+      if (format[0] && !format[1] && std::strchr("?bBhHiIlLqQfd", format[0]))
+        return format[0];
+      return 0;
+    }
+
+    bool isNumericArray(int maxDims) const
+    {
+      return valid_ && view_.ndim >= 1 && view_.ndim <= maxDims && typeCode() != 0;
+    }
+
+    /// The originating datatype, if this buffer is an unsliced view of one of our exports.
+    DatatypeHandle exportedDatatype(PyObject* obj) const
+    {
+      auto exported = findBufferExport(obj);
+      if (!exported || exported->data != view_.buf || exported->itemsize != view_.itemsize
+        || static_cast<int>(exported->shape.size()) != view_.ndim)
+        return nullptr;
+      for (int i = 0; i < view_.ndim; ++i)
+      {
+        if (exported->shape[i] != view_.shape[i] || exported->strides[i] != view_.strides[i])
+          return nullptr;
+      }
+      return exported->owner;
+    }
+
+    /// Copies the buffer in row-major order, converting element type as needed.
+    template <typename T>
+    void copyTo(T* dest) const
+    {
+      const auto code = typeCode();
+      if (code == *bufferFormat(dest) && view_.itemsize == sizeof(T) && PyBuffer_IsContiguous(&view_, 'C'))
+      {
+        std::memcpy(dest, view_.buf, view_.len);
+        return;
+      }
+
+      const auto rowStride = view_.ndim > 0 ? view_.strides[0] : 0;
+      const auto colStride = view_.ndim > 1 ? view_.strides[1] : 0;
+      const auto base = static_cast<const char*>(view_.buf);
+      for (Py_ssize_t i = 0; i < rows(); ++i)
+        for (Py_ssize_t j = 0; j < cols(); ++j)
+          *dest++ = readElement<T>(base + i * rowStride + j * colStride, code);
+    }
+
+    template <typename T>
+    std::vector<T> toVector() const
+    {
+      std::vector<T> values(rows() * cols());
+      if (!values.empty())
+        copyTo(&values[0]);
+      return values;
+    }
+
+  private:
+    template <typename T, typename S>
+    static T read(const char* p)
+    {
+      S s;
+      std::memcpy(&s, p, sizeof(S));
+      return static_cast<T>(s);
+    }
+
+    template <typename T>
+    T readElement(const char* p, char code) const
+    {
+      switch (code)
+      {
+      case 'd': return read<T, double>(p);
+      case 'f': return read<T, float>(p);
+      case '?': return read<T, bool>(p);
+      case 'B': case 'H': case 'I': case 'L': case 'Q':
+        switch (view_.itemsize)
+        {
+        case 1: return read<T, uint8_t>(p);
+        case 2: return read<T, uint16_t>(p);
+        case 4: return read<T, uint32_t>(p);
+        default: return read<T, uint64_t>(p);
+        }
+      default:
+        switch (view_.itemsize)
+        {
+        case 1: return read<T, int8_t>(p);
+        case 2: return read<T, int16_t>(p);
+        case 4: return read<T, int32_t>(p);
+        default: return read<T, int64_t>(p);
+        }
+      }
+    }
+
+    Py_buffer view_;
+    bool valid_;
+  };
 }
 
 boost::python::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
@@ -168,6 +440,86 @@ boost::python::object SCIRun::Core::Python::convertStringToPython(StringHandle s
   return {};
 }
 
+boost::python::object SCIRun::Core::Python::convertMatrixToPythonBuffer(DenseMatrixHandle matrix)
+{
+  if (matrix)
+    return exportBuffer(matrix, matrix->data(), { static_cast<Py_ssize_t>(matrix->nrows()), static_cast<Py_ssize_t>(matrix->ncols()) }, true);
+  return {};
+}
+
+boost::python::object SCIRun::Core::Python::convertMatrixToPythonBuffer(DenseColumnMatrixHandle matrix)
+{
+  if (matrix)
+    return exportBuffer(matrix, matrix->data(), { static_cast<Py_ssize_t>(matrix->nrows()) }, true);
+  return {};
+}
+
+boost::python::dict SCIRun::Core::Python::convertMatrixToPythonBuffer(SparseRowMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+
+  auto compressed = matrix;
+  if (!matrix->isCompressed())
+  {
+    compressed = boost::make_shared<SparseRowMatrix>(*matrix);
+    compressed->makeCompressed();
+  }
+
+  boost::python::dict dict;
+  dict["nrows"] = compressed->nrows();
+  dict["ncols"] = compressed->ncols();
+  dict["rows"] = exportBuffer(compressed, compressed->outerIndexPtr(), { static_cast<Py_ssize_t>(compressed->outerSize() + 1) }, true);
+  dict["columns"] = exportBuffer(compressed, compressed->innerIndexPtr(), { static_cast<Py_ssize_t>(compressed->nonZeros()) }, true);
+  dict["values"] = exportBuffer(compressed, compressed->valuePtr(), { static_cast<Py_ssize_t>(compressed->nonZeros()) }, true);
+  return dict;
+}
+
+namespace
+{
+  template <typename T>
+  boost::python::object exportFieldValues(FieldHandle field, VField* vfield)
+  {
+    return exportBuffer(field, static_cast<const T*>(vfield->get_values_pointer()), { static_cast<Py_ssize_t>(vfield->num_values()) }, true);
+  }
+}
+
+boost::python::object SCIRun::Core::Python::convertFieldValuesToPythonBuffer(FieldHandle field)
+{
+  if (!field)
+    return {};
+
+  auto vfield = field->vfield();
+  if (vfield->is_vector())
+  {
+    static_assert(sizeof(Geometry::Vector) == 3 * sizeof(double), "Vector field values must be packed triples");
+    return exportBuffer(field, static_cast<const double*>(vfield->get_values_pointer()),
+      { static_cast<Py_ssize_t>(vfield->num_values()), 3 }, true);
+  }
+  if (!vfield->is_scalar())
+    return {};
+
+  if (vfield->is_double()) return exportFieldValues<double>(field, vfield);
+  if (vfield->is_float()) return exportFieldValues<float>(field, vfield);
+  if (vfield->is_int()) return exportFieldValues<int>(field, vfield);
+  if (vfield->is_unsigned_int()) return exportFieldValues<unsigned int>(field, vfield);
+  if (vfield->is_char()) return exportFieldValues<char>(field, vfield);
+  if (vfield->is_unsigned_char()) return exportFieldValues<unsigned char>(field, vfield);
+  if (vfield->is_short()) return exportFieldValues<short>(field, vfield);
+  if (vfield->is_unsigned_short()) return exportFieldValues<unsigned short>(field, vfield);
+  if (vfield->is_long()) return exportFieldValues<long>(field, vfield);
+  if (vfield->is_unsigned_long()) return exportFieldValues<unsigned long>(field, vfield);
+  if (vfield->is_longlong()) return exportFieldValues<long long>(field, vfield);
+  if (vfield->is_unsigned_longlong()) return exportFieldValues<unsigned long long>(field, vfield);
+  return {};
+}
+
+boost::python::object SCIRun::Core::Python::allocateDenseMatrixBuffer(size_t nrows, size_t ncols)
+{
+  auto matrix = boost::make_shared<DenseMatrix>(nrows, ncols, 0.0);
+  return exportBuffer(matrix, matrix->data(), { static_cast<Py_ssize_t>(nrows), static_cast<Py_ssize_t>(ncols) }, false);
+}
+
 bool DenseMatrixExtractor::check() const
 {
   boost::python::extract<boost::python::list> e(object_);
@@ -228,6 +580,27 @@ DatatypeHandle DenseMatrixExtractor::operator()() const
   return dense;
 }
 
+bool DenseMatrixBufferExtractor::check() const
+{
+  ScopedBuffer buffer(object_.ptr());
+  return buffer.isNumericArray(2);
+}
+
+DatatypeHandle DenseMatrixBufferExtractor::operator()() const
+{
+  ScopedBuffer buffer(object_.ptr());
+  if (!buffer.isNumericArray(2))
+    return nullptr;
+
+  auto adopted = boost::dynamic_pointer_cast<DenseMatrix>(buffer.exportedDatatype(object_.ptr()));
+  if (adopted)
+    return adopted;
+
+  auto dense = boost::make_shared<DenseMatrix>(buffer.rows(), buffer.cols());
+  buffer.copyTo(dense->data());
+  return dense;
+}
+
 std::set<std::string> SparseRowMatrixExtractor::validKeys_ = {"rows", "columns", "values", "nrows", "ncols"};
 
 bool SparseRowMatrixExtractor::check() const
@@ -255,7 +628,7 @@ bool SparseRowMatrixExtractor::check() const
 
     boost::python::extract<boost::python::list> value_i_list(values[i]);
     boost::python::extract<size_t> value_i_int(values[i]);
-    if (!value_i_int.check() && !value_i_list.check())
+    if (!value_i_int.check() && !value_i_list.check() && !ScopedBuffer(boost::python::object(values[i]).ptr()).isNumericArray(1))
       return false;
   }
 
@@ -276,20 +649,26 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
   auto keys = pyMatlabDict.keys();
   auto values = pyMatlabDict.values();
   size_t nrows, ncols;
+  std::multiset<DatatypeHandle> exportedFrom;
 
   for (int i = 0; i < length; ++i)
   {
     boost::python::extract<std::string> key_i(keys[i]);
 
     boost::python::extract<boost::python::list> value_i_list(values[i]);
+    boost::python::object value_i(values[i]);
+    ScopedBuffer value_i_buffer(value_i.ptr());
     auto fieldName = key_i();
+    if (value_i_buffer.isNumericArray(1))
+      exportedFrom.insert(value_i_buffer.exportedDatatype(value_i.ptr()));
+
     if (fieldName == "rows")
     {
-      rows = to_std_vector<index_type>(value_i_list());
+      rows = value_i_buffer.isNumericArray(1) ? value_i_buffer.toVector<index_type>() : to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "columns")
     {
-      columns = to_std_vector<index_type>(value_i_list());
+      columns = value_i_buffer.isNumericArray(1) ? value_i_buffer.toVector<index_type>() : to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "nrows")
     {
@@ -303,10 +682,18 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     }
     else if (fieldName == "values")
     {
-      matrixValues = to_std_vector<double>(value_i_list());
+      matrixValues = value_i_buffer.isNumericArray(1) ? value_i_buffer.toVector<double>() : to_std_vector<double>(value_i_list());
     }
   }
 
+  // CSR arrays straight from convertMatrixToPythonBuffer: hand back the original matrix
+  if (3 == exportedFrom.size() && 3 == exportedFrom.count(*exportedFrom.begin()))
+  {
+    auto adopted = boost::dynamic_pointer_cast<SparseRowMatrix>(*exportedFrom.begin());
+    if (adopted && adopted->nrows() == nrows && adopted->ncols() == ncols)
+      return adopted;
+  }
+
   if (!rows.empty() && !columns.empty() && !matrixValues.empty())
   {
     auto nnz = matrixValues.size();
@@ -462,6 +849,13 @@ Variable SCIRun::Core::Python::convertPythonObjectToVariable(const boost::python
       return makeVariable("bool", e());
     }
   }
+  {
+    DenseMatrixBufferExtractor e(object);
+    if (e.check())
+    {
+      return makeDatatypeVariable(e);
+    }
+  }
   {
     DenseMatrixExtractor e(object);
     if (e.check())
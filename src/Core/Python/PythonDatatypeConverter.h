@@ -92,6 +92,18 @@ namespace SCIRun
       SCISHARE boost::python::dict convertMatrixToPython(Datatypes::SparseRowMatrixHandle matrix);
       SCISHARE boost::python::object convertStringToPython(Datatypes::StringHandle str);
 
+      /// Buffer-protocol views: the returned memoryview shares memory with the datatype and keeps it alive.
+      /// Wrap with numpy.asarray() for a zero-copy array. Views of existing datatypes are read-only.
+      SCISHARE boost::python::object convertMatrixToPythonBuffer(Datatypes::DenseMatrixHandle matrix);
+      SCISHARE boost::python::object convertMatrixToPythonBuffer(Datatypes::DenseColumnMatrixHandle matrix);
+      /// Same keys as convertMatrixToPython, with CSR index/value arrays as memoryviews.
+      SCISHARE boost::python::dict convertMatrixToPythonBuffer(Datatypes::SparseRowMatrixHandle matrix);
+      /// Scalar values as shape (n), vector values as shape (n, 3); None for tensor fields.
+      SCISHARE boost::python::object convertFieldValuesToPythonBuffer(FieldHandle field);
+      /// Writable view of a new zeroed dense matrix. Filling it from Python and passing it back to SCIRun adopts the
+      /// matrix without a copy.
+      SCISHARE boost::python::object allocateDenseMatrixBuffer(size_t nrows, size_t ncols);
+
       SCISHARE Algorithms::Variable convertPythonObjectToVariable(const boost::python::object& object);
       SCISHARE boost::python::object convertVariableToPythonObject(const Algorithms::Variable& object);
 
@@ -116,6 +128,17 @@ namespace SCIRun
         virtual std::string label() const override { return "dense matrix"; }
       };
 
+      /// Accepts any 1- or 2-D numeric buffer (memoryview, numpy array, array.array). Buffers exported by
+      /// convertMatrixToPythonBuffer/allocateDenseMatrixBuffer are adopted as-is, others are block-copied.
+      class SCISHARE DenseMatrixBufferExtractor : public DatatypePythonExtractor
+      {
+      public:
+        explicit DenseMatrixBufferExtractor(const boost::python::object& object) : DatatypePythonExtractor(object) {}
+        virtual bool check() const override;
+        virtual Datatypes::DatatypeHandle operator()() const override;
+        virtual std::string label() const override { return "dense matrix"; }
+      };
+
       class SCISHARE SparseRowMatrixExtractor : public DatatypePythonExtractor
       {
       public:
@@ -33,8 +33,11 @@
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Core/Python/PythonDatatypeConverter.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
@@ -47,6 +50,7 @@
 using namespace SCIRun;
 using namespace SCIRun::Core;
 using namespace Core::Python;
+using namespace Core::Datatypes;
 using namespace Testing;
 using namespace TestUtils;
 
@@ -430,3 +434,172 @@ TEST_F(FieldConversionTests, RejectsIncompatibleDictionary)
 
   ASSERT_FALSE(converter.check());
 }
+
+class BufferConversionTests : public testing::Test
+{
+protected:
+  virtual void SetUp() override
+  {
+  #ifdef WIN32
+  #ifndef DEBUG
+    PythonInterpreter::Instance().initialize(false, "Core_Python_Tests", boost::filesystem::current_path().string());
+  #endif
+  #else
+    Py_Initialize();
+  #endif
+  }
+
+  static boost::python::object eval(const std::string& expression)
+  {
+    auto main = boost::python::import("__main__");
+    return boost::python::eval(expression.c_str(), main.attr("__dict__"));
+  }
+
+  static Py_buffer view(const boost::python::object& obj)
+  {
+    Py_buffer v;
+    EXPECT_EQ(0, PyObject_GetBuffer(obj.ptr(), &v, PyBUF_STRIDES | PyBUF_FORMAT));
+    return v;
+  }
+};
+
+TEST_F(BufferConversionTests, DenseMatrixBufferSharesMemory)
+{
+  auto m = boost::make_shared<DenseMatrix>(3, 4);
+  for (int i = 0; i < m->nrows(); ++i)
+    for (int j = 0; j < m->ncols(); ++j)
+      (*m)(i, j) = 10 * i + j;
+
+  auto pyMatrix = convertMatrixToPythonBuffer(m);
+  auto v = view(pyMatrix);
+  EXPECT_EQ(m->data(), v.buf);
+  EXPECT_EQ(2, v.ndim);
+  EXPECT_EQ(3, v.shape[0]);
+  EXPECT_EQ(4, v.shape[1]);
+  EXPECT_EQ("d", std::string(v.format));
+  EXPECT_TRUE(v.readonly);
+  PyBuffer_Release(&v);
+
+  auto main = boost::python::import("__main__");
+  main.attr("m") = pyMatrix;
+  EXPECT_EQ(12.0, boost::python::extract<double>(eval("m[1, 2]"))());
+}
+
+TEST_F(BufferConversionTests, RoundTripDenseMatrixBufferAdoptsOriginal)
+{
+  auto m = boost::make_shared<DenseMatrix>(2, 2, 1.5);
+  auto pyMatrix = convertMatrixToPythonBuffer(m);
+
+  DenseMatrixBufferExtractor converter(pyMatrix);
+  ASSERT_TRUE(converter.check());
+  EXPECT_EQ(m, converter());
+
+  auto column = boost::make_shared<DenseColumnMatrix>(4);
+  *column << 1, 2, 3, 4;
+  auto main = boost::python::import("__main__");
+  main.attr("c") = convertMatrixToPythonBuffer(column);
+  auto strided = eval("c[::2]");
+  DenseMatrixBufferExtractor sliceConverter(strided);
+  ASSERT_TRUE(sliceConverter.check());
+  auto slice = boost::dynamic_pointer_cast<DenseMatrix>(sliceConverter());
+  ASSERT_TRUE(slice != nullptr);
+  ASSERT_EQ(2, slice->nrows());
+  ASSERT_EQ(1, slice->ncols());
+  EXPECT_EQ(1, (*slice)(0, 0));
+  EXPECT_EQ(3, (*slice)(1, 0));
+}
+
+TEST_F(BufferConversionTests, ForeignBufferIsCopied)
+{
+  auto pyMatrix = eval("memoryview(__import__('array').array('i', [1, 2, 3, 4, 5, 6])).cast('B').cast('i', [2, 3])");
+
+  DenseMatrixBufferExtractor converter(pyMatrix);
+  ASSERT_TRUE(converter.check());
+  auto dense = boost::dynamic_pointer_cast<DenseMatrix>(converter());
+  ASSERT_TRUE(dense != nullptr);
+  DenseMatrix expected(2, 3);
+  expected << 1, 2, 3,
+              4, 5, 6;
+  EXPECT_EQ(expected, *dense);
+
+  auto var = convertPythonObjectToVariable(pyMatrix);
+  EXPECT_EQ(pyDenseMatrixLabel(), var.name().name());
+}
+
+TEST_F(BufferConversionTests, RejectsNonNumericBuffers)
+{
+  auto bytes = eval("b'abc'");
+  EXPECT_FALSE(DenseMatrixBufferExtractor(bytes).check());
+  auto list = eval("[[1.0, 2.0]]");
+  EXPECT_FALSE(DenseMatrixBufferExtractor(list).check());
+  EXPECT_TRUE(DenseMatrixExtractor(list).check());
+}
+
+TEST_F(BufferConversionTests, AllocatedBufferIsWritableAndAdopted)
+{
+  auto pyMatrix = allocateDenseMatrixBuffer(2, 3);
+  auto main = boost::python::import("__main__");
+  main.attr("m") = pyMatrix;
+  boost::python::exec("m[1, 2] = 7.0", main.attr("__dict__"));
+
+  DenseMatrixBufferExtractor converter(pyMatrix);
+  auto dense = boost::dynamic_pointer_cast<DenseMatrix>(converter());
+  ASSERT_TRUE(dense != nullptr);
+  auto v = view(pyMatrix);
+  EXPECT_EQ(dense->data(), v.buf);
+  EXPECT_FALSE(v.readonly);
+  PyBuffer_Release(&v);
+  EXPECT_EQ(7.0, (*dense)(1, 2));
+  EXPECT_EQ(0.0, (*dense)(0, 0));
+}
+
+TEST_F(BufferConversionTests, SparseMatrixBuffersRoundTrip)
+{
+  auto sparse = boost::make_shared<SparseRowMatrix>(3, 3);
+  sparse->insert(0, 0) = 1;
+  sparse->insert(1, 2) = 2;
+  sparse->insert(2, 1) = 3;
+  sparse->makeCompressed();
+
+  auto pyDict = convertMatrixToPythonBuffer(sparse);
+  EXPECT_EQ(5, len(pyDict));
+
+  auto values = view(pyDict["values"]);
+  EXPECT_EQ(sparse->valuePtr(), values.buf);
+  EXPECT_EQ(3, values.shape[0]);
+  PyBuffer_Release(&values);
+
+  SparseRowMatrixExtractor converter(pyDict);
+  ASSERT_TRUE(converter.check());
+  EXPECT_EQ(sparse, converter());
+
+  auto main = boost::python::import("__main__");
+  main.attr("d") = pyDict;
+  auto copiedDict = eval("{k: (list(v) if isinstance(v, memoryview) else v) for k, v in d.items()}");
+  SparseRowMatrixExtractor listConverter(copiedDict);
+  ASSERT_TRUE(listConverter.check());
+  auto copy = boost::dynamic_pointer_cast<SparseRowMatrix>(listConverter());
+  ASSERT_TRUE(copy != nullptr);
+  EXPECT_NE(sparse, copy);
+  EXPECT_EQ(2, copy->coeff(1, 2));
+  EXPECT_EQ(3, copy->coeff(2, 1));
+}
+
+TEST_F(BufferConversionTests, FieldValuesBufferSharesMemory)
+{
+  auto scalar = CreateEmptyLatVol(2, 3, 4);
+  auto pyValues = convertFieldValuesToPythonBuffer(scalar);
+  auto v = view(pyValues);
+  EXPECT_EQ(scalar->vfield()->get_values_pointer(), v.buf);
+  EXPECT_EQ(1, v.ndim);
+  EXPECT_EQ(24, v.shape[0]);
+  PyBuffer_Release(&v);
+
+  auto vector = CreateEmptyLatVol(2, 2, 2, VECTOR_E);
+  auto pyVectors = convertFieldValuesToPythonBuffer(vector);
+  auto vv = view(pyVectors);
+  EXPECT_EQ(2, vv.ndim);
+  EXPECT_EQ(8, vv.shape[0]);
+  EXPECT_EQ(3, vv.shape[1]);
+  PyBuffer_Release(&vv);
+}
@@ -27,8 +27,13 @@
 
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
 #include <Core/Logging/Log.h>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <iostream>
 
@@ -37,22 +42,111 @@ using namespace SCIRun::Core::Logging;
 
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  boost::thread_group threads;
+  ThreadPool::instance().run(task, numProcs);
+}
 
-  for (int i = 0; i < capByUserCoreCount(numProcs); ++i)
+namespace
+{
+  // Chunk indices owned by one participant of Parallel::For. The owner pops from the
+  // front; idle participants steal the back half.
+  class StealableChunks
   {
-    threads.create_thread(boost::bind(task, i));
-  }
+  public:
+    StealableChunks() : begin_(0), end_(0) {}
+
+    void reset(size_t begin, size_t end)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      begin_ = begin;
+      end_ = end;
+    }
+
+    bool popFront(size_t& chunk)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      if (begin_ >= end_)
+        return false;
+      chunk = begin_++;
+      return true;
+    }
 
-  try
+    bool stealBack(size_t& begin, size_t& end)
+    {
+      boost::lock_guard<boost::mutex> lock(lock_);
+      if (begin_ >= end_)
+        return false;
+      auto half = (end_ - begin_ + 1) / 2;
+      end = end_;
+      end_ -= half;
+      begin = end_;
+      return true;
+    }
+
+  private:
+    boost::mutex lock_;
+    size_t begin_, end_;
+  };
+}
+
+void Parallel::For(const IndexRange& range, size_t grain, RangeTask task)
+{
+  const size_t n = range.size();
+  if (n == 0)
+    return;
+
+  const size_t maxWorkers = std::max(NumCores(), 1u);
+  if (grain == 0)
+    grain = std::max<size_t>(1, n / (8 * maxWorkers));
+
+  const size_t numChunks = (n + grain - 1) / grain;
+  const size_t numWorkers = std::min<size_t>(maxWorkers, numChunks);
+  if (numWorkers == 1)
   {
-    threads.join_all();
+    task(range);
+    return;
   }
-  catch (boost::thread_interrupted&)
+
+  std::unique_ptr<StealableChunks[]> chunks(new StealableChunks[numWorkers]);
+  for (size_t w = 0; w < numWorkers; ++w)
+    chunks[w].reset(w * numChunks / numWorkers, (w + 1) * numChunks / numWorkers);
+
+  std::atomic<bool> failed(false);
+  auto runChunk = [&](size_t chunk)
   {
-    threads.interrupt_all();
-    throw;
-  }
+    auto begin = range.begin + chunk * grain;
+    task(IndexRange(begin, std::min(begin + grain, range.end)));
+  };
+
+  RunTasks([&](int self)
+  {
+    try
+    {
+      for (;;)
+      {
+        size_t chunk;
+        while (!failed && chunks[self].popFront(chunk))
+          runChunk(chunk);
+
+        bool stole = false;
+        for (size_t k = 1; k < numWorkers && !stole && !failed; ++k)
+        {
+          size_t begin, end;
+          if (chunks[(self + k) % numWorkers].stealBack(begin, end))
+          {
+            chunks[self].reset(begin, end);
+            stole = true;
+          }
+        }
+        if (!stole)
+          return;
+      }
+    }
+    catch (...)
+    {
+      failed = true;
+      throw;
+    }
+  }, static_cast<int>(numWorkers));
 }
 
 unsigned int Parallel::NumCores()
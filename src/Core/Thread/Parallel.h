@@ -31,6 +31,7 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/function.hpp>
+#include <cstddef>
 #include <Core/Thread/share.h>
 
 namespace SCIRun
@@ -39,11 +40,28 @@ namespace Core
 {
 namespace Thread
 {
+  /// Half-open index range [begin, end).
+  struct SCISHARE IndexRange
+  {
+    IndexRange(size_t b, size_t e) : begin(b), end(e) {}
+    size_t begin, end;
+    size_t size() const { return end > begin ? end - begin : 0; }
+  };
+
   class SCISHARE Parallel : public boost::noncopyable
   {
   public:
     typedef boost::function<void(int)> IndexedTask;
+    typedef boost::function<void(const IndexRange&)> RangeTask;
+
+    /// Runs task(0)..task(numProcs-1) concurrently on the shared ThreadPool. All indices
+    /// run at the same time, so tasks may synchronize with a Barrier of size numProcs.
+    /// Size numProcs with NumCores() to respect SetMaximumCores.
     static void RunTasks(IndexedTask task, int numProcs);
+
+    /// Splits range into chunks of grain indices and processes them on up to NumCores()
+    /// pool workers with work stealing. grain == 0 picks a chunk size automatically.
+    static void For(const IndexRange& range, size_t grain, RangeTask task);
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
   private:
@@ -31,6 +31,10 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+#include <Core/Thread/Barrier.h>
+#include <atomic>
+#include <boost/thread/thread.hpp>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,6 +56,178 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, RunsAllTasksEvenAboveCoreCount)
+{
+  const int size = 4 * Parallel::NumCores() + 3;
+  std::vector<int> hits(size, 0);
+
+  Parallel::RunTasks([&](int i) { hits[i]++; }, size);
+
+  EXPECT_EQ(std::vector<int>(size, 1), hits);
+}
+
+TEST(ParallelTests, RunTasksReusesPoolThreads)
+{
+  const int size = 8;
+  Parallel::RunTasks([](int) {}, size);
+  auto poolSize = ThreadPool::instance().size();
+
+  for (int rep = 0; rep < 20; ++rep)
+    Parallel::RunTasks([](int) {}, size);
+
+  EXPECT_EQ(poolSize, ThreadPool::instance().size());
+}
+
+TEST(ParallelTests, RunTasksSupportsBarrierSynchronization)
+{
+  const int size = 6;
+  Barrier barrier("test", size);
+  std::atomic<int> before(0), after(0);
+  std::atomic<bool> allArrived(true);
+
+  Parallel::RunTasks([&](int)
+  {
+    ++before;
+    barrier.wait();
+    if (before != size)
+      allArrived = false;
+    ++after;
+  }, size);
+
+  EXPECT_TRUE(allArrived);
+  EXPECT_EQ(size, after);
+}
+
+TEST(ParallelTests, RunTasksRunsEveryIndexAboveMaximumCores)
+{
+  Parallel::SetMaximumCores(2);
+  std::vector<int> hits(5, 0);
+  Parallel::RunTasks([&](int i) { hits[i]++; }, 5);
+  Parallel::SetMaximumCores(0);
+
+  EXPECT_EQ(std::vector<int>(5, 1), hits);
+}
+
+TEST(ParallelTests, ForUsesAtMostMaximumCoresWorkers)
+{
+  Parallel::SetMaximumCores(2);
+  std::atomic<int> active(0), peak(0);
+  Parallel::For(IndexRange(0, 64), 1, [&](const IndexRange&)
+  {
+    int now = ++active;
+    int seen = peak;
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    --active;
+  });
+  Parallel::SetMaximumCores(0);
+
+  EXPECT_LE(peak, 2);
+}
+
+TEST(ParallelTests, RunTasksPropagatesExceptions)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 2) throw std::runtime_error("task"); }, 4), std::runtime_error);
+  // pool is still usable afterwards
+  std::atomic<int> count(0);
+  Parallel::RunTasks([&](int) { ++count; }, 4);
+  EXPECT_EQ(4, count);
+}
+
+TEST(ParallelTests, NestedRunTasksDoNotDeadlock)
+{
+  std::atomic<int> count(0);
+  Parallel::RunTasks([&](int)
+  {
+    Parallel::RunTasks([&](int) { ++count; }, 3);
+  }, 3);
+  EXPECT_EQ(9, count);
+}
+
+TEST(ParallelTests, InterruptedRunDoesNotLeakIntoLaterBatches)
+{
+  const int numTasks = 4;
+  for (int round = 0; round < 200; ++round)
+  {
+    boost::thread caller([&]()
+    {
+      try
+      {
+        ThreadPool::instance().run([&](int i)
+        {
+          // helpers finish at staggered times so the interrupt lands around the end of their tasks
+          boost::this_thread::sleep_for(boost::chrono::microseconds(i * (round % 50)));
+        }, numTasks);
+      }
+      catch (boost::thread_interrupted&)
+      {
+      }
+    });
+    boost::this_thread::sleep_for(boost::chrono::microseconds(round % 70));
+    caller.interrupt();
+    caller.join();
+  }
+
+  std::atomic<int> count(0);
+  EXPECT_NO_THROW(ThreadPool::instance().run([&](int)
+  {
+    for (int k = 0; k < 100; ++k)
+      boost::this_thread::interruption_point();
+    ++count;
+  }, numTasks));
+  EXPECT_EQ(numTasks, count);
+}
+
+TEST(ParallelTests, ForVisitsEveryIndexOnce)
+{
+  const size_t size = 100003;
+  std::vector<int> hits(size, 0);
+
+  Parallel::For(IndexRange(0, size), 97, [&](const IndexRange& r)
+  {
+    for (size_t i = r.begin; i < r.end; ++i)
+      hits[i]++;
+  });
+
+  EXPECT_EQ(std::vector<int>(size, 1), hits);
+}
+
+TEST(ParallelTests, ForBalancesUnevenWork)
+{
+  const size_t size = 2000;
+  std::vector<double> values(size, 0);
+
+  Parallel::For(IndexRange(0, size), 1, [&](const IndexRange& r)
+  {
+    for (size_t i = r.begin; i < r.end; ++i)
+    {
+      double v = 0;
+      // later indices are far more expensive than early ones
+      for (size_t k = 0; k < i * 10; ++k)
+        v += 1e-3;
+      values[i] = v;
+    }
+  });
+
+  for (size_t i = 0; i < size; i += 250)
+    EXPECT_NEAR(i * 10 * 1e-3, values[i], 1e-6);
+}
+
+TEST(ParallelTests, ForHandlesEmptyAndOffsetRanges)
+{
+  int calls = 0;
+  Parallel::For(IndexRange(5, 5), 0, [&](const IndexRange&) { ++calls; });
+  EXPECT_EQ(0, calls);
+
+  std::atomic<size_t> sum(0);
+  Parallel::For(IndexRange(10, 20), 0, [&](const IndexRange& r)
+  {
+    for (size_t i = r.begin; i < r.end; ++i)
+      sum += i;
+  });
+  EXPECT_EQ(145u, sum);
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
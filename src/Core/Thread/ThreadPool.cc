@@ -0,0 +1,250 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Thread/ThreadPool.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <exception>
+
+using namespace SCIRun::Core::Thread;
+
+struct ThreadPool::Batch
+{
+  explicit Batch(int count) : remaining_(count) {}
+
+  void taskFinished(std::exception_ptr error)
+  {
+    boost::lock_guard<boost::mutex> lock(lock_);
+    if (error && !error_)
+      error_ = error;
+    if (--remaining_ == 0)
+      done_.notify_all();
+  }
+
+  void wait()
+  {
+    boost::unique_lock<boost::mutex> lock(lock_);
+    while (remaining_ > 0)
+      done_.wait(lock);
+  }
+
+  boost::mutex lock_;
+  boost::condition_variable done_;
+  int remaining_;
+  std::exception_ptr error_;
+};
+
+struct ThreadPool::Worker
+{
+  Worker() : index_(0), batch_(nullptr), stop_(false) {}
+
+  boost::thread thread_;
+  boost::mutex lock_;
+  boost::condition_variable wake_;
+  IndexedTask task_;
+  int index_;
+  Batch* batch_;
+  bool stop_;
+};
+
+ThreadPool& ThreadPool::instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool() : poolLock_("ThreadPool"), shuttingDown_(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    Guard g(poolLock_.get());
+    shuttingDown_ = true;
+  }
+  for (auto& worker : workers_)
+  {
+    {
+      boost::lock_guard<boost::mutex> lock(worker->lock_);
+      worker->stop_ = true;
+    }
+    worker->wake_.notify_one();
+  }
+  for (auto& worker : workers_)
+    worker->thread_.join();
+}
+
+size_t ThreadPool::size() const
+{
+  Guard g(poolLock_.get());
+  return workers_.size();
+}
+
+void ThreadPool::acquireWorkers(size_t count, std::vector<Worker*>& workers)
+{
+  Guard g(poolLock_.get());
+  while (workers.size() < count && !idle_.empty())
+  {
+    workers.push_back(idle_.back());
+    idle_.pop_back();
+  }
+  while (workers.size() < count)
+  {
+    workers_.emplace_back(new Worker);
+    auto worker = workers_.back().get();
+    worker->thread_ = boost::thread([this, worker]() { workerLoop(worker); });
+    workers.push_back(worker);
+  }
+}
+
+void ThreadPool::releaseWorker(Worker* worker)
+{
+  Guard g(poolLock_.get());
+  if (!shuttingDown_)
+    idle_.push_back(worker);
+}
+
+void ThreadPool::workerLoop(Worker* worker)
+{
+  // Interruption is only allowed while a task runs, so a request aimed at one
+  // batch cannot escape into the pool's own bookkeeping.
+  boost::this_thread::disable_interruption noInterrupts;
+  for (;;)
+  {
+    IndexedTask task;
+    int index;
+    Batch* batch;
+    {
+      boost::unique_lock<boost::mutex> lock(worker->lock_);
+      while (!worker->batch_ && !worker->stop_)
+        worker->wake_.wait(lock);
+      if (!worker->batch_)
+        return;
+      task.swap(worker->task_);
+      index = worker->index_;
+      batch = worker->batch_;
+    }
+
+    std::exception_ptr error;
+    {
+      boost::this_thread::restore_interruption interruptsAllowed(noInterrupts);
+      try
+      {
+        task(index);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    }
+
+    {
+      // run() only interrupts a worker whose batch_ still points at its batch,
+      // under this lock, so no request can be issued once batch_ is cleared.
+      boost::lock_guard<boost::mutex> lock(worker->lock_);
+      worker->batch_ = nullptr;
+    }
+
+    {
+      // consume a request that arrived after the task stopped checking, before
+      // it can fire inside an unrelated later batch
+      boost::this_thread::restore_interruption interruptsAllowed(noInterrupts);
+      try
+      {
+        boost::this_thread::interruption_point();
+      }
+      catch (boost::thread_interrupted&)
+      {
+      }
+    }
+
+    releaseWorker(worker);
+    batch->taskFinished(error);
+  }
+}
+
+void ThreadPool::run(const IndexedTask& task, int numTasks)
+{
+  if (numTasks <= 0)
+    return;
+  if (numTasks == 1)
+  {
+    task(0);
+    return;
+  }
+
+  std::vector<Worker*> helpers;
+  acquireWorkers(numTasks - 1, helpers);
+
+  Batch batch(numTasks - 1);
+  for (int i = 0; i < numTasks - 1; ++i)
+  {
+    auto worker = helpers[i];
+    {
+      boost::lock_guard<boost::mutex> lock(worker->lock_);
+      worker->task_ = task;
+      worker->index_ = i + 1;
+      worker->batch_ = &batch;
+    }
+    worker->wake_.notify_one();
+  }
+
+  std::exception_ptr error;
+  try
+  {
+    task(0);
+    batch.wait();
+  }
+  catch (boost::thread_interrupted&)
+  {
+    for (auto worker : helpers)
+    {
+      boost::lock_guard<boost::mutex> lock(worker->lock_);
+      if (worker->batch_ == &batch)
+        worker->thread_.interrupt();
+    }
+    error = std::current_exception();
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  {
+    // helpers reference the caller's task and batch, so always wait for them
+    boost::this_thread::disable_interruption noInterrupts;
+    batch.wait();
+  }
+
+  if (!error)
+    error = batch.error_;
+  if (error)
+    std::rethrow_exception(error);
+}
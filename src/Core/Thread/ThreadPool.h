@@ -0,0 +1,82 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_THREAD_THREADPOOL_H
+#define CORE_THREAD_THREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <memory>
+#include <vector>
+#include <Core/Thread/Mutex.h>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Process-wide pool of worker threads that stay alive between parallel calls.
+  /// A batch of N tasks is guaranteed to run on N distinct threads at the same time
+  /// (the calling thread runs task 0), so callers that synchronize their tasks with a
+  /// Barrier keep working. The pool grows when a batch needs more idle workers than
+  /// it currently has, including nested batches started from inside a worker.
+  class SCISHARE ThreadPool : boost::noncopyable
+  {
+  public:
+    typedef boost::function<void(int)> IndexedTask;
+
+    static ThreadPool& instance();
+    ~ThreadPool();
+
+    /// Runs task(0)..task(numTasks-1) concurrently and returns when all have finished.
+    /// The first exception thrown by any task is rethrown on the calling thread.
+    void run(const IndexedTask& task, int numTasks);
+
+    /// Number of worker threads created so far (excluding callers).
+    size_t size() const;
+
+  private:
+    ThreadPool();
+    struct Worker;
+    struct Batch;
+    void acquireWorkers(size_t count, std::vector<Worker*>& workers);
+    void releaseWorker(Worker* worker);
+    void workerLoop(Worker* worker);
+
+    mutable Mutex poolLock_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<Worker*> idle_;
+    bool shuttingDown_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_UTILS_CONTENTHASH_H
+#define CORE_UTILS_CONTENTHASH_H
+
+#include <cstring>
+#include <string>
+#include <boost/cstdint.hpp>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    /// Word-wise multiplicative hash for recognizing data whose contents
+    /// did not change. Collisions are possible, so this is not cryptographic,
+    /// just fast.
+    class ContentHash
+    {
+    public:
+      ContentHash() : h_(0x9e3779b97f4a7c15ULL) {}
+
+      void add(boost::uint64_t w)
+      {
+        h_ ^= w + 0x9e3779b97f4a7c15ULL + (h_ << 6) + (h_ >> 2);
+        h_ *= 0xff51afd7ed558ccdULL;
+      }
+
+      void add(const void* data, size_t bytes)
+      {
+        const char* p = static_cast<const char*>(data);
+        for (; bytes >= sizeof(boost::uint64_t); bytes -= sizeof(boost::uint64_t), p += sizeof(boost::uint64_t))
+        {
+          boost::uint64_t w;
+          std::memcpy(&w, p, sizeof(w));
+          add(w);
+        }
+        if (bytes > 0)
+        {
+          boost::uint64_t w = 0;
+          std::memcpy(&w, p, bytes);
+          add(w);
+        }
+      }
+
+      void add(const std::string& str)
+      {
+        add(static_cast<boost::uint64_t>(str.size()));
+        add(str.data(), str.size());
+      }
+
+      boost::uint64_t value() const { return h_ ^ (h_ >> 33); }
+
+    private:
+      boost::uint64_t h_;
+    };
+  }
+}
+
+#endif
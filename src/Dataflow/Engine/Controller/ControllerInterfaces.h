@@ -46,6 +46,12 @@ namespace Engine {
     virtual Memento saveNetwork() const = 0;
     virtual void loadNetwork(const Memento& xml) = 0;
     virtual void clear() = 0;
+    /// Brings the network from the current memento to the target one
+    /// in place. Returning false makes the caller clear and reload.
+    virtual bool updateNetwork(const Memento& current, const Memento& target) { return false; }
+    /// Adds and removes the modules and connections of a provenance item's
+    /// edit in place. Returning false makes the caller restore mementos.
+    virtual bool applyDelta(const Networks::NetworkFileDelta& delta) { return false; }
   };
 
   typedef boost::shared_ptr<NetworkIOInterface<Networks::NetworkFileHandle>> NetworkIOHandle;
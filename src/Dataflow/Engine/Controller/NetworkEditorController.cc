@@ -38,6 +38,7 @@
 #include <Dataflow/Network/Module.h>
 #include <Dataflow/Serialization/Network/NetworkXMLSerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
 #include <Dataflow/Engine/Controller/DynamicPortManager.h>
 #include <Core/Logging/Log.h>
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
@@ -85,6 +86,7 @@ NetworkEditorController::NetworkEditorController(ModuleFactoryHandle mf, ModuleS
 
 #ifdef BUILD_WITH_PYTHON
   NetworkEditorPythonAPI::setImpl(boost::make_shared<PythonImpl>(*this, cmdFactory_));
+  registeredWithPython_ = true;
 #endif
 
   eventCmdFactory_->create(NetworkEventCommands::ApplicationStart)->execute();
@@ -94,14 +96,16 @@ NetworkEditorController::NetworkEditorController(NetworkHandle network, Executio
   : theNetwork_(network), executorFactory_(executorFactory),
   eventCmdFactory_(new NullCommandFactory),
   serializationManager_(nesm),
-  signalSwitch_(true)
+  signalSwitch_(true),
+  loadingContext_(false)
 {
 }
 
 NetworkEditorController::~NetworkEditorController()
 {
 #ifdef BUILD_WITH_PYTHON
-  NetworkEditorPythonAPI::clearImpl();
+  if (registeredWithPython_)
+    NetworkEditorPythonAPI::clearImpl();
 #endif
   executionManager_.stop();
 }
@@ -606,6 +610,50 @@ void NetworkEditorController::appendToNetwork(const NetworkFileHandle& xml)
   }
 }
 
+bool NetworkEditorController::applyDelta(const NetworkFileDelta& delta)
+{
+  if (!delta.onlyStructure())
+    return false;
+  for (const auto& mod : delta.modules.changed)
+  {
+    if (theNetwork_->lookupModule(ModuleId(mod.first)))
+      return false;
+  }
+
+  for (const auto& cd : delta.removedConnections)
+    removeConnection(ConnectionId::create(cd));
+  for (const auto& id : delta.modules.removed)
+  {
+    if (theNetwork_->lookupModule(ModuleId(id)))
+      removeModule(ModuleId(id));
+  }
+
+  ModuleCounter modulesDone;
+  for (const auto& mod : delta.modules.changed)
+  {
+    auto module = addModuleImpl(mod.second.module);
+    module->setId(ModuleId(mod.first));
+    module->setState(ModuleStateHandle(new Dataflow::State::SimpleMapModuleState(mod.second.state)));
+    moduleAdded_(module->name(), module, modulesDone);
+  }
+
+  for (const auto& cd : delta.addedConnections)
+  {
+    auto from = theNetwork_->lookupModule(cd.out_.moduleId_);
+    auto to = theNetwork_->lookupModule(cd.in_.moduleId_);
+    if (!from || !to || !requestConnection(from->getOutputPort(cd.out_.portId_).get(), to->getInputPort(cd.in_.portId_).get()))
+      return false;
+  }
+
+  if (serializationManager_ && !delta.modulePositions.changed.empty())
+  {
+    ModulePositions moved;
+    moved.modulePositions = delta.modulePositions.changed;
+    serializationManager_->updateModulePositions(moved, false);
+  }
+  return true;
+}
+
 void NetworkEditorController::clear()
 {
   LOG_DEBUG("NetworkEditorController::clear()");
@@ -653,6 +701,22 @@ boost::shared_ptr<boost::thread> NetworkEditorController::executeGeneric(const E
   return executionManager_.enqueueContext(context);
 }
 
+boost::shared_ptr<NetworkEditorController> NetworkEditorController::createDetachedCopy(const NetworkFileHandle& xml) const
+{
+  ENSURE_NOT_NULL(xml, "Null network file.");
+  auto copy = boost::make_shared<NetworkEditorController>(boost::make_shared<Network>(moduleFactory_, stateFactory_, algoFactory_, reexFactory_), executorFactory_);
+  copy->moduleFactory_ = moduleFactory_;
+  copy->stateFactory_ = stateFactory_;
+  copy->algoFactory_ = algoFactory_;
+  copy->reexFactory_ = reexFactory_;
+  copy->dynamicPortManager_.reset(new DynamicPortManager(copy->connectionAdded_, copy->connectionRemoved_, copy.get()));
+
+  LoadingContext ctx(copy->loadingContext_);
+  NetworkXMLConverter conv(moduleFactory_, stateFactory_, algoFactory_, reexFactory_, copy.get());
+  copy->theNetwork_ = conv.from_xml_data(xml->network);
+  return copy;
+}
+
 void NetworkEditorController::stopExecutionContextLoopWhenExecutionFinishes()
 {
   connectNetworkExecutionFinished([this](int)
@@ -118,6 +118,7 @@ namespace Engine {
 
     Networks::NetworkFileHandle serializeNetworkFragment(Networks::ModuleFilter modFilter, Networks::ConnectionFilter connFilter) const;
     void appendToNetwork(const Networks::NetworkFileHandle& xml);
+    virtual bool applyDelta(const Networks::NetworkFileDelta& delta) override;
 //////////////////////End: To be Pythonized///////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 
@@ -163,6 +164,10 @@ namespace Engine {
 
     const Networks::ModuleFactory& moduleFactory() const { return *moduleFactory_; }  //TOOD: lazy
 
+    /// Builds a controller sharing this one's factories around a new network loaded from xml. The copy is not
+    /// registered with the Python API and has no slots connected, so it can be filled and executed off the main thread.
+    boost::shared_ptr<NetworkEditorController> createDetachedCopy(const Networks::NetworkFileHandle& xml) const;
+
     std::vector<Dataflow::Networks::ModuleExecutionState::Value> moduleExecutionStates() const;
 
   private:
@@ -195,6 +200,7 @@ namespace Engine {
 
     boost::shared_ptr<DynamicPortManager> dynamicPortManager_;
     bool signalSwitch_, loadingContext_;
+    bool registeredWithPython_ = false;
     boost::shared_ptr<Networks::ReplacementImpl::ModuleReplacementFilter> replacementFilter_;
 
     struct LoadingContext
@@ -0,0 +1,272 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
+#include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Scheduler/BoostGraphSerialScheduler.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleStateInterface.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/PortDataCache.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Logging/Log.h>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <algorithm>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+namespace
+{
+  /// Output of a module that runs once, feeding a module that runs per point.
+  struct SharedOutput
+  {
+    ModuleId module;
+    PortId port;
+    DatatypeHandle data;
+  };
+
+  std::set<ModuleId> downstreamOf(const NetworkInterface& network, std::set<ModuleId> modules)
+  {
+    auto connections = network.connections();
+    bool grew = true;
+    while (grew)
+    {
+      grew = false;
+      for (const auto& desc : connections)
+      {
+        if (modules.count(desc.out_.moduleId_) && modules.insert(desc.in_.moduleId_).second)
+          grew = true;
+      }
+    }
+    return modules;
+  }
+
+  bool executeModules(const NetworkInterface& network, const ModuleExecutionOrder& order, const std::set<ModuleId>& dirty, bool runDirty)
+  {
+    bool succeeded = true;
+    for (const auto& id : order)
+    {
+      if ((dirty.count(id) != 0) != runDirty)
+        continue;
+      auto obj = network.lookupExecutable(id);
+      if (obj && !obj->executeWithSignals())
+        succeeded = false;
+    }
+    return succeeded;
+  }
+
+  DatatypeHandle outputData(const OutputPortHandle& port)
+  {
+    if (!port || !port->hasData())
+      return nullptr;
+    auto sink = boost::make_shared<SimpleSink>();
+    port->source()->send(sink);
+    auto data = sink->receive();
+    return data ? *data : nullptr;
+  }
+
+  OutputPortHandle outputPort(const NetworkInterface& network, const ParameterSweepOutput& output)
+  {
+    auto module = network.lookupModule(ModuleId(output.moduleId));
+    if (!module)
+      return nullptr;
+    auto ports = module->outputPorts();
+    return output.portIndex < ports.size() ? ports[output.portIndex] : nullptr;
+  }
+
+  /// Sets the budget of the process-wide port data cache, and puts back the old one.
+  class ScopedMemoryBudget
+  {
+  public:
+    explicit ScopedMemoryBudget(size_t bytes) : previous_(PortDataCache::instance().memoryBudget()), changed_(bytes != 0)
+    {
+      if (changed_)
+        PortDataCache::instance().setMemoryBudget(bytes);
+    }
+    ~ScopedMemoryBudget()
+    {
+      if (changed_)
+        PortDataCache::instance().setMemoryBudget(previous_);
+    }
+  private:
+    size_t previous_;
+    bool changed_;
+  };
+}
+
+ParameterSweep::ParameterSweep(const NetworkEditorController& controller, const NetworkFileHandle& network, const ParameterSweepSettings& settings)
+  : controller_(controller), network_(network), settings_(settings)
+{
+  ENSURE_NOT_NULL(network_, "Null network file.");
+}
+
+size_t ParameterSweep::numberOfPoints() const
+{
+  if (settings_.axes.empty())
+    return 0;
+  size_t n = 1;
+  for (const auto& axis : settings_.axes)
+    n *= axis.values.size();
+  return n;
+}
+
+std::vector<Variable::List> ParameterSweep::points() const
+{
+  std::vector<Variable::List> points;
+  auto n = numberOfPoints();
+  points.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    Variable::List point(settings_.axes.size());
+    auto index = i;
+    for (size_t a = settings_.axes.size(); a-- > 0;)
+    {
+      const auto& axis = settings_.axes[a];
+      point[a] = Variable(axis.stateVariable, axis.values[index % axis.values.size()]);
+      index /= axis.values.size();
+    }
+    points.push_back(point);
+  }
+  return points;
+}
+
+std::vector<ParameterSweepPoint> ParameterSweep::run()
+{
+  auto sweepPoints = points();
+  std::vector<ParameterSweepPoint> results(sweepPoints.size());
+  if (sweepPoints.empty())
+    return results;
+
+  ScopedMemoryBudget budget(settings_.memoryBudget);
+
+  auto base = controller_.createDetachedCopy(network_);
+  auto baseNetwork = base->getNetwork();
+
+  std::set<ModuleId> swept;
+  for (const auto& axis : settings_.axes)
+  {
+    ModuleId id(axis.moduleId);
+    if (!baseNetwork->lookupModule(id))
+      THROW_INVALID_ARGUMENT("Parameter sweep module not found: " + axis.moduleId);
+    swept.insert(id);
+  }
+  auto dirty = downstreamOf(*baseNetwork, swept);
+
+  BoostGraphSerialScheduler scheduler;
+  auto order = scheduler.schedule(*baseNetwork);
+
+  if (!executeModules(*baseNetwork, order, dirty, false))
+  {
+    // every point would start from the same missing input
+    logError("Parameter sweep stopped: a module that is not swept failed.");
+    for (size_t i = 0; i < sweepPoints.size(); ++i)
+    {
+      results[i].parameters = sweepPoints[i];
+      results[i].outputs.resize(settings_.outputs.size());
+    }
+    return results;
+  }
+
+  std::vector<SharedOutput> shared;
+  for (const auto& desc : baseNetwork->connections())
+  {
+    if (dirty.count(desc.out_.moduleId_) || !dirty.count(desc.in_.moduleId_))
+      continue;
+    auto alreadyShared = std::find_if(shared.begin(), shared.end(),
+      [&desc](const SharedOutput& s) { return s.module == desc.out_.moduleId_ && s.port == desc.out_.portId_; });
+    if (alreadyShared == shared.end())
+    {
+      auto data = outputData(baseNetwork->lookupModule(desc.out_.moduleId_)->getOutputPort(desc.out_.portId_));
+      shared.push_back({ desc.out_.moduleId_, desc.out_.portId_, data });
+    }
+  }
+  base.reset();
+
+  // Module construction and destruction touch shared factories and signals, so only execution overlaps.
+  Mutex copyLock("ParameterSweep");
+  std::atomic<size_t> next(0);
+
+  auto runPoints = [&]()
+  {
+    for (auto i = next++; i < sweepPoints.size(); i = next++)
+    {
+      auto& result = results[i];
+      result.parameters = sweepPoints[i];
+      boost::shared_ptr<NetworkEditorController> copy;
+      try
+      {
+        {
+          Guard g(copyLock.get());
+          copy = controller_.createDetachedCopy(network_);
+        }
+        auto network = copy->getNetwork();
+        for (size_t a = 0; a < settings_.axes.size(); ++a)
+          network->lookupModule(ModuleId(settings_.axes[a].moduleId))->get_state()->setValue(settings_.axes[a].stateVariable, sweepPoints[i][a].value());
+        for (const auto& s : shared)
+        {
+          if (s.data)
+            network->lookupModule(s.module)->getOutputPort(s.port)->sendData(s.data);
+        }
+
+        result.succeeded = executeModules(*network, order, dirty, true);
+
+        for (const auto& output : settings_.outputs)
+          result.outputs.push_back(outputData(outputPort(*network, output)));
+      }
+      catch (std::exception& e)
+      {
+        logError("Parameter sweep point {} failed: {}", i, e.what());
+        result.succeeded = false;
+        result.outputs.resize(settings_.outputs.size());
+      }
+      Guard g(copyLock.get());
+      copy.reset();
+    }
+  };
+
+  auto threadCount = std::max<size_t>(1, std::min(settings_.maxConcurrent, sweepPoints.size()));
+  boost::thread_group threads;
+  for (size_t t = 0; t < threadCount; ++t)
+    threads.create_thread(runPoints);
+  threads.join_all();
+
+  return results;
+}
@@ -0,0 +1,109 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_NETWORK_PARAMETERSWEEP_H
+#define ENGINE_NETWORK_PARAMETERSWEEP_H
+
+#include <boost/noncopyable.hpp>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Core/Algorithms/Base/Variable.h>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Dataflow/Engine/Controller/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  class NetworkEditorController;
+
+  /// A module state variable set to each of values in turn.
+  struct SCISHARE ParameterSweepAxis
+  {
+    std::string moduleId;
+    Core::Algorithms::Name stateVariable;
+    std::vector<Core::Algorithms::Variable::Value> values;
+  };
+
+  /// An output port whose data is collected at every sweep point.
+  struct SCISHARE ParameterSweepOutput
+  {
+    std::string moduleId;
+    size_t portIndex;
+  };
+
+  struct SCISHARE ParameterSweepSettings
+  {
+    std::vector<ParameterSweepAxis> axes;
+    std::vector<ParameterSweepOutput> outputs;
+    /// Number of network copies executing at once.
+    size_t maxConcurrent = 1;
+    /// Port data cache budget in bytes while the sweep runs; zero leaves the current budget in place.
+    /// The port data cache is shared by the whole process, so this budget also applies to any other
+    /// network executing during the sweep. The previous budget is restored when run() returns.
+    size_t memoryBudget = 0;
+  };
+
+  struct SCISHARE ParameterSweepPoint
+  {
+    /// One variable per axis, named by its state variable.
+    Core::Algorithms::Variable::List parameters;
+    /// One entry per requested output, null where the port has no data.
+    std::vector<Core::Datatypes::DatatypeHandle> outputs;
+    bool succeeded = false;
+  };
+
+  /// Executes a network once per point of the cartesian product of the sweep axes.
+  ///
+  /// Modules that are not downstream of a swept module run once, in a base copy of the
+  /// network, and their outputs are sent to every point. Each point then runs only the
+  /// remaining modules in its own copy, built with NetworkEditorController::createDetachedCopy,
+  /// with up to maxConcurrent copies in flight. Copies execute on the sweep's threads rather
+  /// than through an ExecutionStrategy, so the global execution start/finish signals that the
+  /// GUI, headless mode and the Python API listen to are never fired.
+  class SCISHARE ParameterSweep : boost::noncopyable
+  {
+  public:
+    ParameterSweep(const NetworkEditorController& controller, const Networks::NetworkFileHandle& network, const ParameterSweepSettings& settings);
+
+    size_t numberOfPoints() const;
+    /// Blocks until every point has run. Results are in axis-major order: the last axis varies fastest.
+    /// If a module that runs once fails, no point is run and every point is reported as failed.
+    std::vector<ParameterSweepPoint> run();
+
+  private:
+    std::vector<Core::Algorithms::Variable::List> points() const;
+
+    const NetworkEditorController& controller_;
+    Networks::NetworkFileHandle network_;
+    ParameterSweepSettings settings_;
+  };
+
+}}}
+
+#endif
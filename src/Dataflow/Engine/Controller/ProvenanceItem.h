@@ -32,7 +32,9 @@
 #define ENGINE_NETWORK_PROVENANCEITEM_H
 
 #include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
 #include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Engine/Controller/ControllerInterfaces.h>
 #include <Dataflow/Engine/Controller/share.h>
 
 namespace SCIRun {
@@ -47,6 +49,14 @@ namespace Engine {
     virtual ~ProvenanceItem() {}
     virtual Memento memento() const = 0;
     virtual std::string name() const = 0;
+    /// Called by the manager when this item is added on top of previous, or
+    /// on top of the initial state when the stack is empty, so items can
+    /// store their memento relative to the one before.
+    virtual void setPrevious(const Handle& previous, const boost::optional<Memento>& initial) {}
+    /// Reverts or repeats this item's own edit on the network in place.
+    /// Returning false makes the manager restore mementos instead.
+    virtual bool undo(NetworkIOInterface<Memento>& io) const { return false; }
+    virtual bool redo(NetworkIOInterface<Memento>& io) const { return false; }
   };
 
 }
@@ -31,18 +31,108 @@
 #include <string>
 #include <sstream>
 #include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Serialization/Network/StateSerialization.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::State;
 
-ProvenanceItemBase::ProvenanceItemBase(NetworkFileHandle state) : state_(state)
+const size_t ProvenanceItemBase::checkpointInterval;
+
+ProvenanceItemBase::ProvenanceItemBase(NetworkFileHandle state) : state_(state), sequence_(0)
+{
+}
+
+ProvenanceItemBase::ProvenanceItemBase(Delta redo, Delta undo) : redo_(redo), undo_(undo), sequence_(0)
 {
 }
 
 NetworkFileHandle ProvenanceItemBase::memento() const
 {
-  return state_;
+  if (state_ || !redo_)
+    return state_;
+
+  std::vector<const NetworkFileDelta*> deltas;
+  auto item = this;
+  for (; item && !item->state_; item = item->previous_.get())
+  {
+    if (!item->redo_)
+      return nullptr;
+    deltas.push_back(item->redo_.get());
+  }
+
+  auto base = item ? item->state_ : initial_;
+  auto file = base ? boost::make_shared<NetworkFile>(*base) : boost::make_shared<NetworkFile>();
+  for (auto delta = deltas.rbegin(); delta != deltas.rend(); ++delta)
+    applyNetworkFileDelta(*file, **delta);
+  return file;
+}
+
+void ProvenanceItemBase::setPrevious(const Handle& previous, const boost::optional<NetworkFileHandle>& initial)
+{
+  previous_ = boost::dynamic_pointer_cast<ProvenanceItemBase>(previous);
+  initial_ = initial ? *initial : nullptr;
+  sequence_ = previous_ ? previous_->sequence_ + 1 : 0;
+
+  // bound the chain memento() replays, and let older items go
+  if (!state_ && sequence_ > 0 && sequence_ % checkpointInterval == 0)
+  {
+    state_ = memento();
+    previous_.reset();
+    initial_.reset();
+  }
+}
+
+bool ProvenanceItemBase::undo(NetworkIOInterface<NetworkFileHandle>& io) const
+{
+  return undo_ && io.applyDelta(*undo_);
+}
+
+bool ProvenanceItemBase::redo(NetworkIOInterface<NetworkFileHandle>& io) const
+{
+  return redo_ && io.applyDelta(*redo_);
+}
+
+namespace
+{
+  using Delta = ProvenanceItemBase::Delta;
+
+  Delta moduleAdded(const ModuleHandle& module, const boost::optional<std::pair<double, double>>& position)
+  {
+    auto delta = boost::make_shared<NetworkFileDelta>();
+    const auto& id = module->id();
+    auto state = make_state_xml(module->get_state());
+    delta->modules.changed[id.id_] = ModuleWithState(module->info(), state ? *state : SimpleMapModuleStateXML());
+    if (position)
+      delta->modulePositions.changed[id.id_] = *position;
+    return delta;
+  }
+
+  Delta moduleRemoved(const ModuleId& id)
+  {
+    auto delta = boost::make_shared<NetworkFileDelta>();
+    delta->modules.removed.push_back(id.id_);
+    delta->modulePositions.removed.push_back(id.id_);
+    return delta;
+  }
+
+  Delta connectionsChanged(const ConnectionDescription& cd, bool added)
+  {
+    auto delta = boost::make_shared<NetworkFileDelta>();
+    (added ? delta->addedConnections : delta->removedConnections).push_back(ConnectionDescriptionXML(cd));
+    return delta;
+  }
+
+  Delta moduleMoved(const ModuleId& id, const boost::optional<std::pair<double, double>>& position)
+  {
+    if (!position)
+      return nullptr;
+    auto delta = boost::make_shared<NetworkFileDelta>();
+    delta->modulePositions.changed[id.id_] = *position;
+    return delta;
+  }
 }
 
 ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleName, NetworkFileHandle state)
@@ -50,6 +140,11 @@ ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleNa
 {
 }
 
+ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleName, const ModuleHandle& module)
+  : ProvenanceItemBase(moduleAdded(module, boost::none), moduleRemoved(module->id())), moduleName_(moduleName)
+{
+}
+
 std::string ModuleAddedProvenanceItem::name() const
 {
   return "Module Added: " + moduleName_;
@@ -60,6 +155,11 @@ ModuleRemovedProvenanceItem::ModuleRemovedProvenanceItem(const ModuleId& moduleI
 {
 }
 
+ModuleRemovedProvenanceItem::ModuleRemovedProvenanceItem(const ModuleHandle& module, const boost::optional<std::pair<double, double>>& position)
+  : ProvenanceItemBase(moduleRemoved(module->id()), moduleAdded(module, position)), moduleId_(module->id())
+{
+}
+
 std::string ModuleRemovedProvenanceItem::name() const
 {
   return "Module Removed: " + moduleId_.id_;
@@ -70,6 +170,11 @@ ConnectionAddedProvenanceItem::ConnectionAddedProvenanceItem(const SCIRun::Dataf
 {
 }
 
+ConnectionAddedProvenanceItem::ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd)
+  : ProvenanceItemBase(connectionsChanged(cd, true), connectionsChanged(cd, false)), desc_(cd)
+{
+}
+
 std::string ConnectionAddedProvenanceItem::name() const
 {
   return "Connection added: " + ConnectionId::create(desc_).id_;
@@ -80,6 +185,11 @@ ConnectionRemovedProvenanceItem::ConnectionRemovedProvenanceItem(const SCIRun::D
 {
 }
 
+ConnectionRemovedProvenanceItem::ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id)
+  : ProvenanceItemBase(connectionsChanged(id.describe(), false), connectionsChanged(id.describe(), true)), id_(id)
+{
+}
+
 std::string ConnectionRemovedProvenanceItem::name() const
 {
   return "Connection Removed: " + id_.id_;
@@ -90,6 +200,13 @@ ModuleMovedProvenanceItem::ModuleMovedProvenanceItem(const SCIRun::Dataflow::Net
 {
 }
 
+ModuleMovedProvenanceItem::ModuleMovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, double newX, double newY,
+  const boost::optional<std::pair<double, double>>& oldPosition)
+  : ProvenanceItemBase(moduleMoved(moduleId, std::make_pair(newX, newY)), moduleMoved(moduleId, oldPosition)),
+  moduleId_(moduleId), newX_(newX), newY_(newY)
+{
+}
+
 std::string ModuleMovedProvenanceItem::name() const
 {
   std::ostringstream ostr;
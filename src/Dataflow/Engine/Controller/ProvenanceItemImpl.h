@@ -34,25 +34,47 @@
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
 #include <Dataflow/Engine/Controller/share.h>
 
 namespace SCIRun {
 namespace Dataflow {
 namespace Engine {
 
+  /// Items record the edit they made, and the edit that reverts it, when
+  /// the action is captured. Undo and redo apply those edits to the network
+  /// in place. The full network file is only rebuilt from the edits when it
+  /// is asked for, and every checkpointInterval-th item keeps it, so the
+  /// undo stack grows with the size of the edits rather than the network.
   class SCISHARE ProvenanceItemBase : public ProvenanceItem<Networks::NetworkFileHandle>
   {
   public:
+    static const size_t checkpointInterval = 16;
+    using Delta = boost::shared_ptr<const Networks::NetworkFileDelta>;
+
+    /// An item holding the full network file after the action.
     explicit ProvenanceItemBase(Networks::NetworkFileHandle state);
-    virtual Networks::NetworkFileHandle memento() const;
-  protected:
+    /// An item holding the edit that performs the action and the one that reverts it.
+    ProvenanceItemBase(Delta redo, Delta undo);
+    virtual Networks::NetworkFileHandle memento() const override;
+    virtual void setPrevious(const Handle& previous, const boost::optional<Networks::NetworkFileHandle>& initial) override;
+    virtual bool undo(NetworkIOInterface<Networks::NetworkFileHandle>& io) const override;
+    virtual bool redo(NetworkIOInterface<Networks::NetworkFileHandle>& io) const override;
+    bool isCheckpoint() const { return state_ != nullptr; }
+  private:
     Networks::NetworkFileHandle state_;
+    boost::shared_ptr<const ProvenanceItemBase> previous_;
+    /// the network before the first item, when previous_ is null
+    Networks::NetworkFileHandle initial_;
+    Delta redo_, undo_;
+    size_t sequence_;
   };
 
   class SCISHARE ModuleAddedProvenanceItem : public ProvenanceItemBase
   {
   public:
     ModuleAddedProvenanceItem(const std::string& moduleName, Networks::NetworkFileHandle state);
+    ModuleAddedProvenanceItem(const std::string& moduleName, const Networks::ModuleHandle& module);
     virtual std::string name() const;
   private:
     std::string moduleName_;
@@ -62,6 +84,8 @@ namespace Engine {
   {
   public:
     ModuleRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, Networks::NetworkFileHandle state);
+    /// position is where the module was, if known, so undo can put it back
+    ModuleRemovedProvenanceItem(const Networks::ModuleHandle& module, const boost::optional<std::pair<double, double>>& position);
     virtual std::string name() const;
   private:
     SCIRun::Dataflow::Networks::ModuleId moduleId_;
@@ -71,6 +95,7 @@ namespace Engine {
   {
   public:
     ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd, Networks::NetworkFileHandle state);
+    explicit ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd);
     virtual std::string name() const;
   private:
     SCIRun::Dataflow::Networks::ConnectionDescription desc_;
@@ -80,6 +105,7 @@ namespace Engine {
   {
   public:
     ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id, Networks::NetworkFileHandle state);
+    explicit ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id);
     virtual std::string name() const;
   private:
     SCIRun::Dataflow::Networks::ConnectionId id_;
@@ -89,6 +115,9 @@ namespace Engine {
   {
   public:
     ModuleMovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, double newX, double newY, Networks::NetworkFileHandle state);
+    /// oldPosition is where the module was, if known, so undo can put it back
+    ModuleMovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, double newX, double newY,
+      const boost::optional<std::pair<double, double>>& oldPosition);
     virtual std::string name() const;
   private:
     SCIRun::Dataflow::Networks::ModuleId moduleId_;
@@ -33,6 +33,7 @@
 
 #include <stack>
 #include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
 #include <Dataflow/Engine/Controller/share.h>
@@ -70,6 +71,7 @@ namespace Engine {
   private:
     ItemHandle undo(bool restore);
     ItemHandle redo(bool restore);
+    void restore(const boost::optional<Memento>& current, const boost::optional<Memento>& target);
     IOType* networkIO_;
     Stack undo_, redo_;
     boost::optional<Memento> initialState_;
@@ -101,6 +103,7 @@ namespace Engine {
   template <class Memento>
   void ProvenanceManager<Memento>::addItem(typename ProvenanceManager<Memento>::ItemHandle item)
   {
+    item->setPrevious(undo_.empty() ? ItemHandle() : undo_.top(), initialState_);
     undo_.push(item);
     Stack().swap(redo_);
   }
@@ -127,14 +130,15 @@ namespace Engine {
       undo_.pop();
       redo_.push(undone);
 
-      //clear and load previous memento
-      if (restore)
+      //revert the item's edit, or move back to the previous memento
+      if (restore && !undone->undo(*networkIO_))
       {
-        networkIO_->clear();
+        boost::optional<Memento> previous;
         if (!undo_.empty())
-          networkIO_->loadNetwork(undo_.top()->memento());
-        else if (initialState_)
-          networkIO_->loadNetwork(initialState_.get());
+          previous = undo_.top()->memento();
+        else
+          previous = initialState_;
+        this->restore(undone->memento(), previous);
       }
 
       return undone;
@@ -154,30 +158,52 @@ namespace Engine {
     if (!redo_.empty())
     {
       auto redone = redo_.top();
-      redo_.pop();
-      undo_.push(redone);
-
-      //clear and load redone memento
-      if (restore)
+      //repeat the item's edit, or move forward to its memento
+      if (restore && !redone->redo(*networkIO_))
       {
-        networkIO_->clear();
-        networkIO_->loadNetwork(redone->memento());
+        boost::optional<Memento> current;
+        if (!undo_.empty())
+          current = undo_.top()->memento();
+        else
+          current = initialState_;
+        this->restore(current, redone->memento());
       }
 
+      redo_.pop();
+      undo_.push(redone);
+
       return redone;
     }
     return ItemHandle();
   }
 
+  template <class Memento>
+  void ProvenanceManager<Memento>::restore(const boost::optional<Memento>& current, const boost::optional<Memento>& target)
+  {
+    if (current && target && networkIO_->updateNetwork(*current, *target))
+      return;
+
+    networkIO_->clear();
+    if (target)
+      networkIO_->loadNetwork(*target);
+  }
+
   template <class Memento>
   typename ProvenanceManager<Memento>::List ProvenanceManager<Memento>::undoAll()
   {
     List undone;
+    bool inPlace = true;
     while (0 != undoSize())
+    {
       undone.push_back(undo(false));
-    networkIO_->clear();
-    if (initialState_)
-      networkIO_->loadNetwork(initialState_.get());
+      inPlace = inPlace && undone.back()->undo(*networkIO_);
+    }
+    if (!inPlace)
+    {
+      networkIO_->clear();
+      if (initialState_)
+        networkIO_->loadNetwork(initialState_.get());
+    }
     return undone;
   }
 
@@ -185,10 +211,17 @@ namespace Engine {
   typename ProvenanceManager<Memento>::List ProvenanceManager<Memento>::redoAll()
   {
     List redone;
+    bool inPlace = true;
     while (0 != redoSize())
+    {
       redone.push_back(redo(false));
-    networkIO_->clear();
-    networkIO_->loadNetwork(undo_.top()->memento());
+      inPlace = inPlace && redone.back()->redo(*networkIO_);
+    }
+    if (!inPlace)
+    {
+      networkIO_->clear();
+      networkIO_->loadNetwork(undo_.top()->memento());
+    }
     return redone;
   }
 
@@ -39,9 +39,12 @@
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Dataflow/Engine/Controller/PythonImpl.h>
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/String.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Matlab/matlabfile.h>
@@ -49,6 +52,7 @@
 
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
+#include <boost/optional.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
 #include <Core/Python/PythonInterpreter.h>
 
@@ -65,6 +69,15 @@ using namespace SCIRun::Dataflow::Networks;
 
 namespace
 {
+  class ScopedGILRelease
+  {
+  public:
+    ScopedGILRelease() : state_(PyEval_SaveThread()) {}
+    ~ScopedGILRelease() { PyEval_RestoreThread(state_); }
+  private:
+    PyThreadState* state_;
+  };
+
   class PyDatatypeString : public PyDatatype
   {
   public:
@@ -82,6 +95,11 @@ namespace
       return str_;
     }
 
+    virtual boost::python::object buffer() const override
+    {
+      return str_;
+    }
+
   private:
     StringHandle underlying_;
     boost::python::object str_;
@@ -90,7 +108,7 @@ namespace
   class PyDatatypeDenseMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -101,18 +119,51 @@ namespace
 
     virtual boost::python::object value() const override
     {
-      return pyMat_;
+      if (!pyMat_)
+        pyMat_ = convertMatrixToPython(underlying_);
+      return *pyMat_;
+    }
+
+    virtual boost::python::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
     }
 
   private:
     DenseMatrixHandle underlying_;
-    boost::python::list pyMat_;
+    mutable boost::optional<boost::python::list> pyMat_;
+  };
+
+  class PyDatatypeDenseColumnMatrix : public PyDatatype
+  {
+  public:
+    explicit PyDatatypeDenseColumnMatrix(DenseColumnMatrixHandle underlying) : underlying_(underlying)
+    {
+    }
+
+    virtual std::string type() const override
+    {
+      return underlying_->dynamic_type_name();
+    }
+
+    virtual boost::python::object value() const override
+    {
+      return toPythonList(std::vector<double>(underlying_->data(), underlying_->data() + underlying_->nrows()));
+    }
+
+    virtual boost::python::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
+    }
+
+  private:
+    DenseColumnMatrixHandle underlying_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -123,18 +174,25 @@ namespace
 
     virtual boost::python::object value() const override
     {
-      return pyMat_;
+      if (!pyMat_)
+        pyMat_ = convertMatrixToPython(underlying_);
+      return *pyMat_;
+    }
+
+    virtual boost::python::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
     }
 
   private:
     SparseRowMatrixHandle underlying_;
-    boost::python::dict pyMat_;
+    mutable boost::optional<boost::python::dict> pyMat_;
   };
 
   class PyDatatypeField : public PyDatatype
   {
   public:
-    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying), matlabStructure_(convertFieldToPython(underlying))
+    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -145,12 +203,19 @@ namespace
 
     virtual boost::python::object value() const override
     {
-      return matlabStructure_;
+      if (!matlabStructure_)
+        matlabStructure_ = convertFieldToPython(underlying_);
+      return *matlabStructure_;
+    }
+
+    virtual boost::python::object buffer() const override
+    {
+      return convertFieldValuesToPythonBuffer(underlying_);
     }
 
   private:
     FieldHandle underlying_;
-    boost::python::dict matlabStructure_;
+    mutable boost::optional<boost::python::dict> matlabStructure_;
   };
 
   class PyDatatypeFactory
@@ -168,6 +233,11 @@ namespace
         if (dense)
           return boost::make_shared<PyDatatypeDenseMatrix>(dense);
       }
+      {
+        auto column = boost::dynamic_pointer_cast<DenseColumnMatrix>(data);
+        if (column)
+          return boost::make_shared<PyDatatypeDenseColumnMatrix>(column);
+      }
       {
         auto sparse = boost::dynamic_pointer_cast<SparseRowMatrix>(data);
         if (sparse)
@@ -619,6 +689,77 @@ std::string PythonImpl::executeAll(const ExecutableLookup* lookup)
   return "Execution started."; //TODO: attach log for execution ended event.
 }
 
+boost::python::object PythonImpl::parameterSweep(const std::string& filename, const boost::python::list& axes,
+  const boost::python::list& outputs, int maxConcurrent, size_t memoryBudget)
+{
+  auto file = XMLSerializer::load_xml<NetworkFile>(filename);
+  if (!file)
+    return boost::python::object("Load failed: " + filename);
+  // Python modules would need the interpreter that is busy running this call
+  for (const auto& module : file->network.modules)
+  {
+    if (module.second.module.category_name_ == "Python")
+      return boost::python::object("Parameter sweep cannot run networks with Python modules: " + module.first);
+  }
+
+  ParameterSweepSettings settings;
+  for (int i = 0; i < boost::python::len(axes); ++i)
+  {
+    boost::python::object axis = axes[i];
+    ParameterSweepAxis sweepAxis;
+    sweepAxis.moduleId = boost::python::extract<std::string>(axis[0]);
+    sweepAxis.stateVariable = Name(boost::python::extract<std::string>(axis[1]));
+    for (int j = 0; j < boost::python::len(axis[2]); ++j)
+      sweepAxis.values.push_back(convertPythonObjectToVariable(axis[2][j]).value());
+    settings.axes.push_back(sweepAxis);
+  }
+  for (int i = 0; i < boost::python::len(outputs); ++i)
+  {
+    boost::python::object output = outputs[i];
+    settings.outputs.push_back({ boost::python::extract<std::string>(output[0]), boost::python::extract<size_t>(output[1]) });
+  }
+  settings.maxConcurrent = maxConcurrent > 0 ? maxConcurrent : 1;
+  settings.memoryBudget = memoryBudget;
+
+  std::vector<ParameterSweepPoint> points;
+  boost::optional<std::string> failure;
+  {
+    // no Python objects are touched until the sweep is done
+    ScopedGILRelease release;
+    try
+    {
+      ParameterSweep sweep(nec_, file, settings);
+      points = sweep.run();
+    }
+    catch (std::exception& e)
+    {
+      failure = e.what();
+    }
+  }
+  if (failure)
+    return boost::python::object("Parameter sweep failed: " + *failure);
+
+  boost::python::list results;
+  for (const auto& point : points)
+  {
+    boost::python::list parameters;
+    for (const auto& parameter : point.parameters)
+      parameters.append(convertVariableToPythonObject(parameter));
+    boost::python::list data;
+    for (const auto& output : point.outputs)
+    {
+      auto wrapper = output ? PyDatatypeFactory::createWrapper(output) : nullptr;
+      data.append(wrapper ? wrapper->value() : boost::python::object());
+    }
+    boost::python::dict result;
+    result["parameters"] = parameters;
+    result["outputs"] = data;
+    result["succeeded"] = point.succeeded;
+    results.append(result);
+  }
+  return results;
+}
+
 std::string PythonImpl::connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex)
 {
   auto network = nec_.getNetwork();
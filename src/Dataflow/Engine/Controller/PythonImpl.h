@@ -56,6 +56,8 @@ namespace Engine {
     virtual std::vector<boost::shared_ptr<PyModule>> moduleList() const override;
     virtual boost::shared_ptr<PyModule> findModule(const std::string& id) const override;
     virtual std::string executeAll(const Networks::ExecutableLookup* lookup) override;
+    virtual boost::python::object parameterSweep(const std::string& filename, const boost::python::list& axes,
+      const boost::python::list& outputs, int maxConcurrent, size_t memoryBudget) override;
     virtual std::string connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) override;
     virtual std::string disconnect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) override;
     virtual std::string saveNetwork(const std::string& filename) override;
@@ -0,0 +1,147 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Modules/Factory/HardCodedModuleFactory.h>
+#include <Modules/Legacy/Fields/CreateLatVol.h>
+#include <Modules/Math/CreateMatrix.h>
+#include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Modules::Factory;
+using namespace SCIRun::Modules::Fields;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+
+class ParameterSweepTests : public ::testing::Test
+{
+protected:
+  ParameterSweepTests() :
+    controller_(boost::make_shared<HardCodedModuleFactory>(), boost::make_shared<SimpleMapModuleStateFactory>(),
+      nullptr, nullptr, nullptr, nullptr, nullptr)
+  {
+    // upstream lattice feeds the swept one, so its output is shared by every point
+    auto upstream = controller_.addModule("CreateLatVol");
+    swept_ = controller_.addModule("CreateLatVol");
+    controller_.requestConnection(upstream->outputPorts()[0].get(), swept_->inputPorts()[0].get());
+  }
+
+  static size_t numNodes(const DatatypeHandle& data)
+  {
+    auto field = boost::dynamic_pointer_cast<Field>(data);
+    return field ? field->vmesh()->num_nodes() : 0;
+  }
+
+  NetworkEditorController controller_;
+  ModuleHandle swept_;
+};
+
+TEST_F(ParameterSweepTests, RunsOnePointPerValue)
+{
+  ParameterSweepSettings settings;
+  settings.axes.push_back({ swept_->id().id_, CreateLatVol::XSize, { 2, 3, 4 } });
+  settings.outputs.push_back({ swept_->id().id_, 0 });
+  settings.maxConcurrent = 2;
+
+  ParameterSweep sweep(controller_, controller_.saveNetwork(), settings);
+  ASSERT_EQ(3, sweep.numberOfPoints());
+  auto points = sweep.run();
+
+  ASSERT_EQ(3, points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_TRUE(points[i].succeeded);
+    EXPECT_EQ(static_cast<int>(i) + 2, points[i].parameters[0].toInt());
+    ASSERT_EQ(1, points[i].outputs.size());
+    EXPECT_EQ((i + 2) * 16 * 16, numNodes(points[i].outputs[0]));
+  }
+  // the sweep works on copies
+  EXPECT_EQ(16, swept_->get_state()->getValue(CreateLatVol::XSize).toInt());
+}
+
+TEST_F(ParameterSweepTests, LastAxisVariesFastest)
+{
+  ParameterSweepSettings settings;
+  settings.axes.push_back({ swept_->id().id_, CreateLatVol::XSize, { 2, 3 } });
+  settings.axes.push_back({ swept_->id().id_, CreateLatVol::YSize, { 4, 5 } });
+  settings.outputs.push_back({ swept_->id().id_, 0 });
+  settings.maxConcurrent = 4;
+
+  auto points = ParameterSweep(controller_, controller_.saveNetwork(), settings).run();
+
+  ASSERT_EQ(4, points.size());
+  const int expected[][2] = { { 2, 4 }, { 2, 5 }, { 3, 4 }, { 3, 5 } };
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_EQ(expected[i][0], points[i].parameters[0].toInt());
+    EXPECT_EQ(expected[i][1], points[i].parameters[1].toInt());
+    EXPECT_EQ(static_cast<size_t>(expected[i][0] * expected[i][1] * 16), numNodes(points[i].outputs[0]));
+  }
+}
+
+TEST_F(ParameterSweepTests, ThrowsForUnknownModule)
+{
+  ParameterSweepSettings settings;
+  settings.axes.push_back({ "NoSuchModule:0", CreateLatVol::XSize, { 2 } });
+
+  ParameterSweep sweep(controller_, controller_.saveNetwork(), settings);
+  EXPECT_ANY_THROW(sweep.run());
+}
+
+TEST_F(ParameterSweepTests, UpstreamFailureFailsEveryPoint)
+{
+  // a ragged matrix makes CreateMatrix throw, so the size port never gets data
+  auto size = controller_.addModule("CreateMatrix");
+  size->get_state()->setValue(Core::Algorithms::Math::Parameters::TextEntry, std::string("1 2\n3"));
+  controller_.requestConnection(size->outputPorts()[0].get(), swept_->inputPorts()[1].get());
+
+  ParameterSweepSettings settings;
+  settings.axes.push_back({ swept_->id().id_, CreateLatVol::XSize, { 2, 3 } });
+  settings.outputs.push_back({ swept_->id().id_, 0 });
+
+  auto points = ParameterSweep(controller_, controller_.saveNetwork(), settings).run();
+
+  ASSERT_EQ(2, points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_FALSE(points[i].succeeded);
+    EXPECT_EQ(static_cast<int>(i) + 2, points[i].parameters[0].toInt());
+    ASSERT_EQ(1, points[i].outputs.size());
+    EXPECT_FALSE(points[i].outputs[0]);
+  }
+}
@@ -34,11 +34,23 @@
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Engine/Controller/ProvenanceItemFactory.h>
 #include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
+#include <Dataflow/Engine/Controller/ControllerInterfaces.h>
+#include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Controller/ProvenanceManager.h>
+#include <Dataflow/Network/Network.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Modules/Factory/HardCodedModuleFactory.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Modules::Factory;
+using namespace SCIRun::Core::Algorithms;
 using ::testing::_;
 using ::testing::Eq;
 using ::testing::NiceMock;
@@ -74,3 +86,129 @@ TEST_F(ProvenanceItemTests, CanCreateRemoveModule)
 
   EXPECT_EQ("Module Removed: " + id, item.name());
 }
+
+namespace
+{
+  NetworkFileHandle networkWithModules(int count, double x)
+  {
+    auto file = boost::make_shared<NetworkFile>();
+    for (int i = 0; i < count; ++i)
+    {
+      ModuleLookupInfoXML info;
+      info.module_name_ = "CreateMatrix";
+      info.category_name_ = "Math";
+      info.package_name_ = "SCIRun";
+      auto id = "CreateMatrix:" + std::to_string(i);
+      file->network.modules[id] = ModuleWithState(info);
+      file->modulePositions.modulePositions[id] = { x, 10.0 * i };
+    }
+    return file;
+  }
+
+  std::string toXml(NetworkFileHandle file)
+  {
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(*file, ostr, "networkFile");
+    return ostr.str();
+  }
+}
+
+TEST_F(ProvenanceItemTests, ItemsRebuildTheirStateFromRecordedEdits)
+{
+  const size_t numItems = 2 * ProvenanceItemBase::checkpointInterval + 3;
+  const boost::optional<NetworkFileHandle> initial(networkWithModules(3, 0));
+  auto expected = boost::make_shared<NetworkFile>(**initial);
+  std::vector<NetworkFileHandle> states;
+  std::vector<ProvenanceItemHandle> items;
+  for (size_t i = 0; i < numItems; ++i)
+  {
+    auto& position = expected->modulePositions.modulePositions["CreateMatrix:0"];
+    auto old = position;
+    position = { i + 1.0, 2.0 * i };
+    states.push_back(boost::make_shared<NetworkFile>(*expected));
+    ProvenanceItemHandle item(boost::make_shared<ModuleMovedProvenanceItem>(ModuleId("CreateMatrix:0"), position.first, position.second, boost::make_optional(old)));
+    item->setPrevious(items.empty() ? ProvenanceItemHandle() : items.back(), initial);
+    items.push_back(item);
+  }
+
+  for (size_t i = 0; i < numItems; ++i)
+  {
+    auto item = boost::dynamic_pointer_cast<ProvenanceItemBase>(items[i]);
+    EXPECT_EQ(i > 0 && i % ProvenanceItemBase::checkpointInterval == 0, item->isCheckpoint()) << i;
+    EXPECT_EQ(toXml(states[i]), toXml(item->memento())) << i;
+  }
+}
+
+namespace
+{
+  /// Forwards to a real controller and counts whole-network reloads.
+  class CountingNetworkIO : public NetworkIOInterface<NetworkFileHandle>
+  {
+  public:
+    explicit CountingNetworkIO(NetworkEditorController& controller) : controller_(controller) {}
+    NetworkFileHandle saveNetwork() const override { return controller_.saveNetwork(); }
+    void loadNetwork(const NetworkFileHandle& xml) override { ++reloads; controller_.loadNetwork(xml); }
+    void clear() override { controller_.clear(); }
+    bool applyDelta(const NetworkFileDelta& delta) override { return controller_.applyDelta(delta); }
+    int reloads = 0;
+  private:
+    NetworkEditorController& controller_;
+  };
+}
+
+TEST_F(ProvenanceItemTests, StructuralUndoAndRedoEditTheNetworkInPlace)
+{
+  ModuleFactoryHandle mf(new HardCodedModuleFactory);
+  ModuleStateFactoryHandle sf(new SimpleMapModuleStateFactory);
+  NetworkEditorController controller(mf, sf, nullptr, nullptr, nullptr, nullptr, nullptr);
+  CountingNetworkIO io(controller);
+  ProvenanceManager<NetworkFileHandle> manager(&io);
+  manager.setInitialState(controller.saveNetwork());
+  auto network = controller.getNetwork();
+
+  Module::resetIdGenerator();
+  auto create = controller.addModule("CreateMatrix");
+  manager.addItem(boost::make_shared<ModuleAddedProvenanceItem>("CreateMatrix", create));
+  auto report = controller.addModule("ReportMatrixInfo");
+  manager.addItem(boost::make_shared<ModuleAddedProvenanceItem>("ReportMatrixInfo", report));
+  auto connection = controller.requestConnection(create->outputPorts()[0].get(), report->inputPorts()[0].get());
+  ASSERT_TRUE(connection);
+  manager.addItem(boost::make_shared<ConnectionAddedProvenanceItem>(connection->describe()));
+
+  manager.undo();
+  EXPECT_EQ(2, network->nmodules());
+  EXPECT_EQ(0, network->nconnections());
+  manager.undo();
+  EXPECT_EQ(1, network->nmodules());
+  EXPECT_FALSE(network->lookupModule(report->id()));
+
+  manager.redo();
+  EXPECT_TRUE(network->lookupModule(report->id()));
+  manager.redo();
+  EXPECT_EQ(1, network->nconnections());
+
+  // the editor removes a module's connections before the module
+  create->get_state()->setValue(Name("TestValue"), 7);
+  controller.removeConnection(*connection);
+  manager.addItem(boost::make_shared<ConnectionRemovedProvenanceItem>(*connection));
+  manager.addItem(boost::make_shared<ModuleRemovedProvenanceItem>(create, std::make_pair(10.0, 20.0)));
+  controller.removeModule(create->id());
+  EXPECT_EQ(1, network->nmodules());
+
+  manager.undo();
+  auto restored = network->lookupModule(create->id());
+  ASSERT_TRUE(restored != nullptr);
+  EXPECT_EQ(7, restored->get_state()->getValue(Name("TestValue")).toInt());
+  manager.undo();
+  EXPECT_EQ(1, network->nconnections());
+
+  manager.redoAll();
+  EXPECT_EQ(1, network->nmodules());
+  EXPECT_EQ(0, network->nconnections());
+
+  manager.undoAll();
+  EXPECT_EQ(0, network->nmodules());
+
+  EXPECT_EQ(0, io.reloads);
+  EXPECT_EQ(network, controller.getNetwork());
+}
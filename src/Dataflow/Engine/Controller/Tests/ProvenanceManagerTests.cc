@@ -47,6 +47,7 @@ public:
   MOCK_CONST_METHOD0(saveNetwork, std::string());
   MOCK_METHOD1(loadNetwork, void(const std::string&));
   MOCK_METHOD0(clear, void());
+  MOCK_METHOD2(updateNetwork, bool(const std::string&, const std::string&));
 };
 
 typedef boost::shared_ptr<MockNetworkIO> MockNetworkIOPtr;
@@ -156,6 +157,28 @@ TEST_F(ProvenanceManagerTests, CanRedoUndoneItem)
   }
 }
 
+TEST_F(ProvenanceManagerTests, UndoAndRedoUpdateNetworkInPlaceWhenPossible)
+{
+  ProvenanceManager<std::string> manager(controller_.get());
+
+  manager.addItem(item("1"));
+  manager.addItem(item("2"));
+
+  {
+    EXPECT_CALL(*controller_, updateNetwork("2", "1")).WillOnce(Return(true));
+    EXPECT_CALL(*controller_, clear()).Times(0);
+    EXPECT_CALL(*controller_, loadNetwork(_)).Times(0);
+    manager.undo();
+  }
+
+  {
+    EXPECT_CALL(*controller_, updateNetwork("1", "2")).WillOnce(Return(false));
+    EXPECT_CALL(*controller_, clear()).Times(1);
+    EXPECT_CALL(*controller_, loadNetwork("2")).Times(1);
+    manager.redo();
+  }
+}
+
 TEST_F(ProvenanceManagerTests, CannotUndoWhenEmpty)
 {
   ProvenanceManager<std::string> manager(controller_.get());
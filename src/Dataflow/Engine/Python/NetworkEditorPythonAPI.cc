@@ -149,6 +149,22 @@ std::string NetworkEditorPythonAPI::executeAll()
   }
 }
 
+boost::python::object NetworkEditorPythonAPI::scirun_parameter_sweep(const std::string& filename, const boost::python::list& axes,
+  const boost::python::list& outputs, int maxConcurrent, size_t memoryBudget)
+{
+  Guard g(pythonLock_.get());
+
+  if (impl_ && impl_->isModuleContext())
+    return boost::python::object("In module context--function not available");
+
+  if (impl_)
+    return impl_->parameterSweep(filename, axes, outputs, maxConcurrent, memoryBudget);
+  else
+  {
+    return boost::python::object("Null implementation: NetworkEditorPythonAPI::scirun_parameter_sweep()");
+  }
+}
+
 void NetworkEditorPythonAPI::unlock()
 {
   if (executeLockedFromPython_)
@@ -429,6 +445,29 @@ boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_value(cons
   return {};
 }
 
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_buffer_index(const std::string& moduleId, int portIndex)
+{
+  auto pyData = scirun_get_module_input_object_index(moduleId, portIndex);
+  Guard g(pythonLock_.get());
+  if (pyData)
+    return pyData->buffer();
+  return {};
+}
+
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_buffer(const std::string& moduleId, const std::string& portName)
+{
+  auto pyData = scirun_get_module_input_object(moduleId, portName);
+  Guard g(pythonLock_.get());
+  if (pyData)
+    return pyData->buffer();
+  return {};
+}
+
+boost::python::object NetworkEditorPythonAPI::scirun_allocate_dense_matrix(size_t nrows, size_t ncols)
+{
+  return Core::Python::allocateDenseMatrixBuffer(nrows, ncols);
+}
+
 boost::python::object SimplePythonAPI::scirun_module_ids()
 {
   auto mods = NetworkEditorPythonAPI::modules();
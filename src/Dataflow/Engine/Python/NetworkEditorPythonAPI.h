@@ -68,8 +68,15 @@ namespace SCIRun {
     //these work on all platforms
     static boost::python::object scirun_get_module_input_value_index(const std::string& moduleId, int portIndex);
     static boost::python::object scirun_get_module_input_value(const std::string& moduleId, const std::string& portName);
+    static boost::python::object scirun_get_module_input_buffer_index(const std::string& moduleId, int portIndex);
+    static boost::python::object scirun_get_module_input_buffer(const std::string& moduleId, const std::string& portName);
+    static boost::python::object scirun_allocate_dense_matrix(size_t nrows, size_t ncols);
 
     static std::string executeAll();
+    /// Runs a copy of the network in filename for each combination of axes, a list of (moduleId, stateVariable, values) tuples,
+    /// and returns one dict per point holding the data on outputs, a list of (moduleId, portIndex) tuples.
+    static boost::python::object scirun_parameter_sweep(const std::string& filename, const boost::python::list& axes,
+      const boost::python::list& outputs, int maxConcurrent, size_t memoryBudget);
     static std::string saveNetwork(const std::string& filename);
     static std::string loadNetwork(const std::string& filename);
     static std::string importNetwork(const std::string& filename);
@@ -77,6 +77,8 @@ namespace SCIRun
     virtual ~PyDatatype() {}
     virtual std::string type() const = 0;
     virtual boost::python::object value() const = 0;
+    /// Zero-copy memoryview(s) of the underlying data where supported, otherwise same as value().
+    virtual boost::python::object buffer() const = 0;
   };
 
   class SCISHARE PyPort : public boost::enable_shared_from_this<PyPort>
@@ -132,6 +134,8 @@ namespace SCIRun
     virtual std::string connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) = 0;
     virtual std::string disconnect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) = 0;
     virtual std::string executeAll(const Dataflow::Networks::ExecutableLookup* lookup) = 0;
+    virtual boost::python::object parameterSweep(const std::string& filename, const boost::python::list& axes,
+      const boost::python::list& outputs, int maxConcurrent, size_t memoryBudget) = 0;
     virtual std::string saveNetwork(const std::string& filename) = 0;
     virtual std::string loadNetwork(const std::string& filename) = 0;
     virtual std::string importNetwork(const std::string& filename) = 0;
@@ -68,6 +68,7 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::class_<PyDatatype, boost::shared_ptr<PyDatatype>, boost::noncopyable>("SCIRun::PyDatatype", boost::python::no_init)
     .add_property("type", &PyDatatype::type)
     .add_property("value", &PyDatatype::value)
+    .add_property("buffer", &PyDatatype::buffer)
   ;
 
   //////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +78,7 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_add_module", &SimplePythonAPI::scirun_add_module);
   boost::python::def("scirun_remove_module", &NetworkEditorPythonAPI::removeModule);
   boost::python::def("scirun_execute_all", &NetworkEditorPythonAPI::executeAll);
+  boost::python::def("scirun_parameter_sweep", &NetworkEditorPythonAPI::scirun_parameter_sweep);
   boost::python::def("scirun_module_ids", &SimplePythonAPI::scirun_module_ids);
 
   boost::python::def("scirun_connect_modules", &NetworkEditorPythonAPI::connect);
@@ -95,6 +97,9 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_get_module_input_value", &NetworkEditorPythonAPI::scirun_get_module_input_value);
   boost::python::def("scirun_get_module_input_object_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_object_index);
   boost::python::def("scirun_get_module_input_value_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_value_index);
+  boost::python::def("scirun_get_module_input_buffer", &NetworkEditorPythonAPI::scirun_get_module_input_buffer);
+  boost::python::def("scirun_get_module_input_buffer_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_buffer_index);
+  boost::python::def("scirun_allocate_dense_matrix", &NetworkEditorPythonAPI::scirun_allocate_dense_matrix);
 
   boost::python::def("scirun_save_network", &NetworkEditorPythonAPI::saveNetwork);
   boost::python::def("scirun_load_network", &NetworkEditorPythonAPI::loadNetwork);
@@ -0,0 +1,236 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/CriticalPathNetworkExecutor.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/ExecutionTrace.h>
+#include <Core/Logging/Log.h>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <queue>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  class CriticalPathExecution : public WaitsForStartupInitialization
+  {
+  public:
+    CriticalPathExecution(const ExecutionContext& context, const NetworkInterface* network, const ModuleDependencyGraph& graph,
+      int maxConcurrent, Mutex* executionLock) :
+      lookup_(&context.lookup), bounds_(&context.bounds()), network_(network), graph_(graph),
+      maxConcurrent_(maxConcurrent), executionLock_(executionLock),
+      waitingOn_(graph.size()), upstreamFailed_(graph.size(), false), threads_(graph.size(), nullptr), readyAt_(graph.size(), 0),
+      running_(0), finished_(0)
+    {
+    }
+
+    void operator()()
+    {
+      Guard g(executionLock_->get());
+
+      boost::signals2::scoped_connection interruptCxn =
+        network_->connectModuleInterrupted([this](const std::string& id) { interruptModule(id); });
+
+      ScopedExecutionBoundsSignaller signaller(bounds_, [this]() { return lookup_->errorCode(); });
+
+      waitForStartupInit(*lookup_);
+
+      boost::unique_lock<boost::mutex> lock(stateLock_);
+      for (int i = 0; i < static_cast<int>(graph_.size()); ++i)
+      {
+        waitingOn_[i] = graph_.upstreamCount(i);
+        if (waitingOn_[i] == 0)
+          makeReady(i);
+      }
+
+      while (finished_ < graph_.size())
+      {
+        while (running_ < maxConcurrent_ && !ready_.empty())
+        {
+          auto next = ready_.top();
+          ready_.pop();
+          ++running_;
+          threads_[next] = moduleThreads_.create_thread([this, next]() { runModule(next); });
+        }
+        while (completed_.empty())
+          moduleFinished_.wait(lock);
+
+        while (!completed_.empty())
+        {
+          auto done = completed_.back();
+          completed_.pop_back();
+          --running_;
+          release(done.first, done.second);
+        }
+      }
+      lock.unlock();
+
+      moduleThreads_.join_all();
+    }
+
+  private:
+    struct ByCriticalPath
+    {
+      explicit ByCriticalPath(const ModuleDependencyGraph* graph) : graph_(graph) {}
+      bool operator()(int a, int b) const
+      {
+        return graph_->criticalPathCost(a) < graph_->criticalPathCost(b);
+      }
+      const ModuleDependencyGraph* graph_;
+    };
+
+    // Called with stateLock_ held.
+    void makeReady(int index)
+    {
+      readyAt_[index] = ExecutionTracer::now();
+      ready_.push(index);
+    }
+
+    void runModule(int index)
+    {
+      {
+        auto& tracer = ExecutionTracer::Instance();
+        if (tracer.enabled())
+          tracer.record("queue", graph_.moduleAt(index).id_, readyAt_[index], ExecutionTracer::now());
+      }
+      // Modules report their own errors from executeWithSignals; anything escaping it
+      // (such as a failed lookup) is reported here, and the module counts as failed.
+      bool succeeded = false;
+      const auto& id = graph_.moduleAt(index);
+      try
+      {
+        succeeded = lookup_->lookupExecutable(id)->executeWithSignals();
+      }
+      catch (const std::exception& e)
+      {
+        SCIRun::logError("Module {} failed: {}", id.id_, e.what());
+        markErrored(index);
+      }
+      catch (...)
+      {
+        SCIRun::logError("Module {} failed with an unknown exception.", id.id_);
+        markErrored(index);
+      }
+      {
+        boost::lock_guard<boost::mutex> lock(stateLock_);
+        threads_[index] = nullptr;
+        completed_.push_back(std::make_pair(index, succeeded));
+      }
+      moduleFinished_.notify_one();
+    }
+
+    // Called with stateLock_ held. Marks a module finished and releases every downstream
+    // module whose last outstanding dependency it was. Modules below a failure are not
+    // run; they leave the Waiting state as Errored.
+    void release(int index, bool succeeded)
+    {
+      std::vector<std::pair<int, bool>> toRelease(1, std::make_pair(index, succeeded));
+      while (!toRelease.empty())
+      {
+        auto current = toRelease.back();
+        toRelease.pop_back();
+        ++finished_;
+        for (int d : graph_.downstreamOf(current.first))
+        {
+          if (!current.second)
+            upstreamFailed_[d] = true;
+          if (--waitingOn_[d] == 0)
+          {
+            if (upstreamFailed_[d])
+            {
+              skip(d);
+              toRelease.push_back(std::make_pair(d, false));
+            }
+            else
+              makeReady(d);
+          }
+        }
+      }
+    }
+
+    void skip(int index)
+    {
+      SCIRun::logWarning("Module {} was not executed because an upstream module failed.", graph_.moduleAt(index).id_);
+      markErrored(index);
+    }
+
+    void markErrored(int index)
+    {
+      if (auto module = network_->lookupModule(graph_.moduleAt(index)))
+        module->executionState().transitionTo(ModuleExecutionState::Errored);
+    }
+
+    void interruptModule(const std::string& id)
+    {
+      boost::lock_guard<boost::mutex> lock(stateLock_);
+      for (int i = 0; i < static_cast<int>(graph_.size()); ++i)
+      {
+        if (threads_[i] && graph_.moduleAt(i).id_ == id)
+          threads_[i]->interrupt();
+      }
+    }
+
+    const ExecutableLookup* lookup_;
+    const ExecutionBounds* bounds_;
+    const NetworkInterface* network_;
+    ModuleDependencyGraph graph_;
+    int maxConcurrent_;
+    Mutex* executionLock_;
+
+    boost::mutex stateLock_;
+    boost::condition_variable moduleFinished_;
+    std::priority_queue<int, std::vector<int>, ByCriticalPath> ready_{ ByCriticalPath(&graph_) };
+    std::vector<int> waitingOn_;
+    std::vector<bool> upstreamFailed_;
+    std::vector<boost::thread*> threads_;
+    std::vector<boost::uint64_t> readyAt_;
+    std::vector<std::pair<int, bool>> completed_;
+    boost::thread_group moduleThreads_;
+    int running_;
+    size_t finished_;
+  };
+}
+
+CriticalPathNetworkExecutor::CriticalPathNetworkExecutor(const NetworkInterface& network, int maxConcurrentModules) :
+  network_(network), maxConcurrentModules_(maxConcurrentModules)
+{
+}
+
+void CriticalPathNetworkExecutor::execute(const ExecutionContext& context, ModuleDependencyGraph order, Mutex& executionLock)
+{
+  auto maxConcurrent = maxConcurrentModules_ > 0 ? maxConcurrentModules_ : std::max(static_cast<int>(Parallel::NumCores()), 2);
+  auto runner = boost::make_shared<CriticalPathExecution>(context, &network_, order, maxConcurrent, &executionLock);
+  boost::thread execution([runner]() { (*runner)(); });
+}
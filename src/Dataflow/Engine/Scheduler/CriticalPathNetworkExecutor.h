@@ -0,0 +1,58 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_CRITICAL_PATH_NETWORK_EXECUTOR_H
+#define ENGINE_SCHEDULER_CRITICAL_PATH_NETWORK_EXECUTOR_H
+
+#include <Dataflow/Engine/Scheduler/ModuleDependencyGraph.h>
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Event-driven executor: each module is released as soon as all of its own upstream
+  /// modules have finished, rather than waiting for a whole topological level. Ready modules
+  /// are started in order of decreasing critical path cost, with at most maxConcurrentModules
+  /// running at once (0 means Parallel::NumCores(), but never fewer than two). Modules
+  /// downstream of a failed module are not executed.
+  class SCISHARE CriticalPathNetworkExecutor : public NetworkExecutor<ModuleDependencyGraph>
+  {
+  public:
+    explicit CriticalPathNetworkExecutor(const Networks::NetworkInterface& network, int maxConcurrentModules = 0);
+    virtual void execute(const ExecutionContext& context, ModuleDependencyGraph order, Core::Thread::Mutex& executionLock) override;
+  private:
+    const Networks::NetworkInterface& network_;
+    int maxConcurrentModules_;
+  };
+
+}}}
+
+#endif
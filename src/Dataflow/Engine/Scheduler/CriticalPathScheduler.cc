@@ -0,0 +1,89 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/CriticalPathScheduler.h>
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleStateInterface.h>
+#include <boost/lexical_cast.hpp>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+CriticalPathScheduler::CriticalPathScheduler(const ModuleFilter& filter) : filter_(filter) {}
+
+namespace
+{
+  const double unknownCost = -1;
+
+  double lastExecutionDuration(const ModuleHandle& module)
+  {
+    try
+    {
+      return boost::lexical_cast<double>(module->metadata().getMetadata("Last execution duration (seconds)"));
+    }
+    catch (boost::bad_lexical_cast&)
+    {
+      return unknownCost;
+    }
+  }
+}
+
+ModuleDependencyGraph CriticalPathScheduler::schedule(const NetworkInterface& network) const
+{
+  NetworkGraphAnalyzer graphAnalyzer(network, filter_, false);
+  auto edges = graphAnalyzer.constructEdgeListFromNetwork();
+  const int count = graphAnalyzer.moduleCount();
+
+  std::vector<ModuleId> modules;
+  std::vector<double> costs;
+  modules.reserve(count);
+  costs.reserve(count);
+  double knownTotal = 0;
+  int knownCount = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    modules.push_back(graphAnalyzer.moduleAt(i));
+    auto cost = lastExecutionDuration(network.lookupModule(modules.back()));
+    if (cost >= 0)
+    {
+      knownTotal += cost;
+      ++knownCount;
+    }
+    costs.push_back(cost);
+  }
+
+  const double defaultCost = knownCount > 0 ? knownTotal / knownCount : 1.0;
+  for (auto& cost : costs)
+    if (cost < 0)
+      cost = defaultCost;
+
+  return ModuleDependencyGraph(modules, edges, costs);
+}
@@ -50,7 +50,8 @@ namespace Engine {
     {
       SERIAL,
       BASIC_PARALLEL,
-      DYNAMIC_PARALLEL
+      DYNAMIC_PARALLEL,
+      CRITICAL_PATH_PARALLEL
       // next: pausable, then with loops
     };
 
@@ -0,0 +1,89 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/ModuleDependencyGraph.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+ModuleDependencyGraph::ModuleDependencyGraph(const std::vector<ModuleId>& modules, const std::vector<std::pair<int,int>>& edges,
+  const std::vector<double>& costs) :
+  modules_(modules),
+  downstream_(modules.size()),
+  upstreamCount_(modules.size(), 0),
+  criticalPath_(modules.size(), 0)
+{
+  for (const auto& edge : edges)
+  {
+    auto& out = downstream_[edge.first];
+    // multiple connections between the same pair of modules are a single dependency
+    if (std::find(out.begin(), out.end(), edge.second) == out.end())
+    {
+      out.push_back(edge.second);
+      ++upstreamCount_[edge.second];
+    }
+  }
+
+  // Kahn's algorithm gives a topological order; walking it backwards accumulates
+  // the longest remaining path below each module.
+  std::vector<int> order;
+  order.reserve(size());
+  std::vector<int> remaining(upstreamCount_);
+  for (int i = 0; i < static_cast<int>(size()); ++i)
+    if (remaining[i] == 0)
+      order.push_back(i);
+  for (size_t next = 0; next < order.size(); ++next)
+    for (int d : downstream_[order[next]])
+      if (--remaining[d] == 0)
+        order.push_back(d);
+
+  if (order.size() != size())
+    BOOST_THROW_EXCEPTION(NetworkHasCyclesException() << Core::ErrorMessage("Module dependency graph contains a cycle"));
+
+  for (auto i = order.rbegin(); i != order.rend(); ++i)
+  {
+    double longestBelow = 0;
+    for (int d : downstream_[*i])
+      longestBelow = std::max(longestBelow, criticalPath_[d]);
+    criticalPath_[*i] = (*i < static_cast<int>(costs.size()) ? costs[*i] : 1.0) + longestBelow;
+  }
+}
+
+std::ostream& SCIRun::Dataflow::Engine::operator<<(std::ostream& out, const ModuleDependencyGraph& graph)
+{
+  for (int i = 0; i < static_cast<int>(graph.size()); ++i)
+  {
+    out << graph.moduleAt(i) << " [" << graph.criticalPathCost(i) << "] ->";
+    for (int d : graph.downstreamOf(i))
+      out << " " << graph.moduleAt(d);
+    out << "\n";
+  }
+  return out;
+}
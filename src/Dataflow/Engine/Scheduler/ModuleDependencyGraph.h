@@ -0,0 +1,69 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_MODULE_DEPENDENCY_GRAPH_H
+#define ENGINE_SCHEDULER_MODULE_DEPENDENCY_GRAPH_H
+
+#include <vector>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Execution order for dataflow-driven executors: the scheduled modules, their downstream
+  /// edges, and a priority per module equal to the estimated cost of the longest path from
+  /// that module to a sink. Modules are addressed by dense index in [0, size()).
+  class SCISHARE ModuleDependencyGraph
+  {
+  public:
+    ModuleDependencyGraph() {}
+    ModuleDependencyGraph(const std::vector<Networks::ModuleId>& modules, const std::vector<std::pair<int,int>>& edges,
+      const std::vector<double>& costs);
+
+    size_t size() const { return modules_.size(); }
+    const Networks::ModuleId& moduleAt(int index) const { return modules_[index]; }
+    const std::vector<int>& downstreamOf(int index) const { return downstream_[index]; }
+    int upstreamCount(int index) const { return upstreamCount_[index]; }
+    double criticalPathCost(int index) const { return criticalPath_[index]; }
+
+  private:
+    std::vector<Networks::ModuleId> modules_;
+    std::vector<std::vector<int>> downstream_;
+    std::vector<int> upstreamCount_;
+    std::vector<double> criticalPath_;
+  };
+
+  SCISHARE std::ostream& operator<<(std::ostream& out, const ModuleDependencyGraph& graph);
+
+}}}
+
+#endif
@@ -47,6 +47,8 @@
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathScheduler.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathExecutionStrategy.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
@@ -431,6 +433,139 @@ TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrderExecutedFromAModuleInADisjo
   }
 }
 
+TEST_F(SchedulingWithBoostGraph, CriticalPathNetworkOrder)
+{
+  setupBasicNetwork();
+
+  CriticalPathScheduler scheduler(ExecuteAllModules::Instance());
+  auto graph = scheduler.schedule(matrixMathNetwork);
+
+  ASSERT_EQ(9, graph.size());
+  std::map<std::string, int> index;
+  for (int i = 0; i < static_cast<int>(graph.size()); ++i)
+    index[graph.moduleAt(i).id_] = i;
+
+  // no module has run yet, so every module costs one unit
+  EXPECT_EQ(5, graph.criticalPathCost(index["CreateMatrix:0"]));
+  EXPECT_EQ(5, graph.criticalPathCost(index["CreateMatrix:1"]));
+  EXPECT_EQ(3, graph.criticalPathCost(index["EvaluateLinearAlgebraUnary:2"]));
+  EXPECT_EQ(4, graph.criticalPathCost(index["EvaluateLinearAlgebraUnary:3"]));
+  EXPECT_EQ(1, graph.criticalPathCost(index["ReportMatrixInfo:7"]));
+
+  EXPECT_EQ(0, graph.upstreamCount(index["CreateMatrix:0"]));
+  EXPECT_EQ(2, graph.upstreamCount(index["EvaluateLinearAlgebraBinary:5"]));
+  EXPECT_EQ(2, graph.upstreamCount(index["EvaluateLinearAlgebraBinary:6"]));
+  EXPECT_EQ(2, graph.downstreamOf(index["CreateMatrix:0"]).size());
+}
+
+TEST(ModuleDependencyGraphTest, LongestWeightedPathWins)
+{
+  //  a(1) -> b(10) -> d(1)
+  //  a(1) -> c(2)  -> d(1)
+  std::vector<ModuleId> modules { ModuleId("a:0"), ModuleId("b:1"), ModuleId("c:2"), ModuleId("d:3") };
+  std::vector<std::pair<int,int>> edges { {0,1}, {0,2}, {1,3}, {2,3}, {2,3} };
+  ModuleDependencyGraph graph(modules, edges, { 1, 10, 2, 1 });
+
+  EXPECT_EQ(12, graph.criticalPathCost(0));
+  EXPECT_EQ(11, graph.criticalPathCost(1));
+  EXPECT_EQ(3, graph.criticalPathCost(2));
+  EXPECT_EQ(1, graph.criticalPathCost(3));
+  EXPECT_EQ(2, graph.upstreamCount(3));
+}
+
+TEST(ModuleDependencyGraphTest, ThrowsOnCycle)
+{
+  std::vector<ModuleId> modules { ModuleId("a:0"), ModuleId("b:1") };
+  std::vector<std::pair<int,int>> edges { {0,1}, {1,0} };
+  EXPECT_THROW(ModuleDependencyGraph(modules, edges, { 1, 1 }), NetworkHasCyclesException);
+}
+
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorCriticalPath)
+{
+  setupBasicNetwork();
+
+  CriticalPathExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, matrixMathNetwork);
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  /// @todo: let executor thread finish.  should be an event generated or something.
+  boost::this_thread::sleep(boost::posix_time::milliseconds(800));
+
+  ReportMatrixInfoAlgorithm::Outputs reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
+TEST_F(SchedulingWithBoostGraph, CriticalPathSkipsModulesBelowAFailure)
+{
+  setupBasicNetwork();
+  auto matrix1Send = matrixMathNetwork.lookupModule(ModuleId("CreateMatrix:0"));
+  matrix1Send->get_state()->setValue(Core::Algorithms::Math::Parameters::TextEntry, std::string("1 2\n3"));
+
+  CriticalPathExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, matrixMathNetwork);
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  boost::this_thread::sleep(boost::posix_time::milliseconds(800));
+
+  // everything fed by the first matrix is left Errored instead of Waiting
+  for (const auto& id : { "EvaluateLinearAlgebraUnary:2", "EvaluateLinearAlgebraUnary:3", "EvaluateLinearAlgebraBinary:5",
+    "EvaluateLinearAlgebraBinary:6", "ReportMatrixInfo:7", "ReportMatrixInfo:8" })
+  {
+    EXPECT_EQ(ModuleExecutionState::Errored, matrixMathNetwork.lookupModule(ModuleId(id))->executionState().currentState()) << id;
+  }
+  EXPECT_EQ(ModuleExecutionState::Completed, matrixMathNetwork.lookupModule(ModuleId("CreateMatrix:1"))->executionState().currentState());
+  EXPECT_EQ(ModuleExecutionState::Completed, matrixMathNetwork.lookupModule(ModuleId("EvaluateLinearAlgebraUnary:4"))->executionState().currentState());
+}
+
+namespace
+{
+  // Delegates to the network, except that looking up one module throws
+  class ThrowingLookup : public ExecutableLookup
+  {
+  public:
+    ThrowingLookup(const ExecutableLookup& lookup, const std::string& failing) : lookup_(lookup), failing_(failing) {}
+    ExecutableObject* lookupExecutable(const ModuleId& id) const override
+    {
+      if (id.id_ == failing_)
+        throw std::runtime_error("lookup failed");
+      return lookup_.lookupExecutable(id);
+    }
+    bool containsViewScene() const override { return lookup_.containsViewScene(); }
+    int errorCode() const override { return lookup_.errorCode(); }
+  private:
+    const ExecutableLookup& lookup_;
+    std::string failing_;
+  };
+}
+
+TEST_F(SchedulingWithBoostGraph, CriticalPathReportsModuleThatThrows)
+{
+  setupBasicNetwork();
+
+  CriticalPathExecutionStrategy strategy;
+  ThrowingLookup lookup(matrixMathNetwork, "CreateMatrix:0");
+  ExecutionContext context(matrixMathNetwork, lookup);
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  boost::this_thread::sleep(boost::posix_time::milliseconds(800));
+
+  // the module that threw is failed, so nothing below it runs
+  for (const auto& id : { "CreateMatrix:0", "EvaluateLinearAlgebraUnary:2", "EvaluateLinearAlgebraUnary:3",
+    "EvaluateLinearAlgebraBinary:5", "EvaluateLinearAlgebraBinary:6", "ReportMatrixInfo:7", "ReportMatrixInfo:8" })
+  {
+    EXPECT_EQ(ModuleExecutionState::Errored, matrixMathNetwork.lookupModule(ModuleId(id))->executionState().currentState()) << id;
+  }
+  EXPECT_EQ(ModuleExecutionState::Completed, matrixMathNetwork.lookupModule(ModuleId("CreateMatrix:1"))->executionState().currentState());
+  EXPECT_EQ(ModuleExecutionState::Completed, matrixMathNetwork.lookupModule(ModuleId("EvaluateLinearAlgebraUnary:4"))->executionState().currentState());
+}
+
 #if 0
 namespace ThreadingPrototype
 {
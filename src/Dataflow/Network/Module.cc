@@ -31,7 +31,6 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/timer.hpp>
 #include <atomic>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -45,8 +44,10 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <Core/Logging/ConsoleLogger.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionTrace.h>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/Interruptible.h>
 
@@ -372,7 +373,10 @@ bool Module::executeWithSignals() NOEXCEPT
   }
 #endif
   impl_->executeBegins_(id());
-  boost::timer executionTimer;
+  // wall time: modules running Parallel tasks must not be charged once per thread
+  auto executionBegin = ExecutionTracer::now();
+  // outputs sent from here on are charged this module's run time in the port data cache
+  PortDataCache::ProductionScope production;
   {
     auto isoString = boost::posix_time::to_simple_string(boost::posix_time::microsec_clock::universal_time());
     impl_->metadata_.setMetadata("Last execution timestamp", isoString);
@@ -436,7 +440,13 @@ bool Module::executeWithSignals() NOEXCEPT
   }
   impl_->threadStopped_ = threadStopValue;
 
-  auto executionTime = executionTimer.elapsed();
+  auto executionEnd = ExecutionTracer::now();
+  auto executionTime = (executionEnd - executionBegin) * 1e-6;
+  {
+    auto& tracer = ExecutionTracer::Instance();
+    if (tracer.enabled())
+      tracer.record("module", id().id_, executionBegin, executionEnd);
+  }
   {
     std::ostringstream ostr;
     ostr << executionTime;
@@ -556,6 +566,7 @@ DatatypeHandleOption Module::get_input_handle(const PortId& id)
     //Log::get() << DEBUG_LOG << id_ << ":: inputsChanged is now " << inputsChanged_ << std::endl;
   }
 
+  ScopedTraceSpan span("port", this->id().id_, id.toString());
   auto data = port->getData();
   impl_->metadata_.setMetadata("Input " + id.toString(), metaInfo(data));
   return data;
@@ -578,6 +589,7 @@ std::vector<DatatypeHandleOption> Module::get_dynamic_input_handles(const PortId
     LOG_TRACE("{} :: inputsChanged is now {}.", id().id_, impl_->inputsChanged_);
   }
 
+  ScopedTraceSpan span("port", id().id_, pid.toString());
   std::vector<DatatypeHandleOption> options;
   auto getData = [](InputPortHandle input) { return input->getData(); };
   std::transform(portsWithName.begin(), portsWithName.end(), std::back_inserter(options), getData);
@@ -595,6 +607,7 @@ void Module::send_output_handle(const PortId& id, DatatypeHandle data)
     THROW_OUT_OF_RANGE("Output port does not exist: " + id.toString());
   }
 
+  ScopedTraceSpan span("port", this->id().id_, id.toString());
   impl_->oports_[id]->sendData(data);
 }
 
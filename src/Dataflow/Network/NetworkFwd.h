@@ -73,6 +73,7 @@ struct DisabledComponents;
 struct Subnetworks;
 /// @todo: rename this
 struct NetworkFile;
+struct NetworkFileDelta;
 struct ToolkitFile;
 class NetworkGlobalSettings;
 class NetworkEditorSerializationManager;
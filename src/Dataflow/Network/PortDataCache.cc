@@ -0,0 +1,553 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/thread/tss.hpp>
+#include <Core/Utils/ContentHash.h>
+#include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionTrace.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Dataflow::Networks;
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      class PortDataCacheEntry
+      {
+      public:
+        PortDataCacheEntry() : hash(0), hashed(false), bytes(0), cost(0), priority(0), spillable(true), spilling(false), isField(false) {}
+        ~PortDataCacheEntry()
+        {
+          if (!file.empty())
+          {
+            boost::system::error_code ec;
+            boost::filesystem::remove(file, ec);
+          }
+        }
+
+        /// Serializes the slow work on this entry (hashing, writing and reading its
+        /// spill file) without holding the cache lock. Guards hash and hashed.
+        boost::mutex work;
+        boost::uint64_t hash;
+        bool hashed;
+
+        // the rest is guarded by the cache lock
+        /// null while spilled
+        DatatypeHandle data;
+        size_t bytes;
+        double cost;
+        double priority;
+        /// the spill file; kept after reloading so the entry can be dropped again without writing
+        boost::filesystem::path file;
+        bool spillable;
+        /// chosen as a victim by a trim that is writing it out
+        bool spilling;
+        bool isField;
+      };
+    }
+  }
+}
+
+namespace
+{
+  boost::thread_specific_ptr<boost::uint64_t> productionStart;
+
+  void addPoint(ContentHash& hash, const Geometry::Point& p)
+  {
+    const double xyz[3] = { p.x(), p.y(), p.z() };
+    hash.add(xyz, sizeof(xyz));
+  }
+
+  /// bytes per field value, or zero for value types that are not plain data
+  size_t valueBytes(VField& vfield)
+  {
+    if (vfield.is_double() || vfield.is_longlong() || vfield.is_unsigned_longlong() || vfield.is_long() || vfield.is_unsigned_long())
+      return 8;
+    if (vfield.is_float() || vfield.is_int() || vfield.is_unsigned_int())
+      return 4;
+    if (vfield.is_short() || vfield.is_unsigned_short())
+      return 2;
+    if (vfield.is_char() || vfield.is_unsigned_char())
+      return 1;
+    if (vfield.is_complex_double())
+      return 16;
+    if (vfield.is_vector())
+      return 3 * sizeof(double);
+    return 0;
+  }
+
+  template <typename T>
+  boost::uint64_t hashSparse(const SparseRowMatrixGeneric<T>& A)
+  {
+    ContentHash hash;
+    hash.add(static_cast<boost::uint64_t>(A.rows()));
+    hash.add(static_cast<boost::uint64_t>(A.cols()));
+    const index_type* rows = A.outerIndexPtr();
+    const index_type* columns = A.innerIndexPtr();
+    const T* values = A.valuePtr();
+    const auto* nonzeros = A.innerNonZeroPtr();
+    for (index_type i = 0; i < A.outerSize(); ++i)
+    {
+      const index_type count = nonzeros ? nonzeros[i] : rows[i + 1] - rows[i];
+      hash.add(static_cast<boost::uint64_t>(count));
+      hash.add(columns + rows[i], count * sizeof(index_type));
+      hash.add(values + rows[i], count * sizeof(T));
+    }
+    return hash.value();
+  }
+
+  boost::uint64_t hashField(Field& field)
+  {
+    VField* vfield = field.vfield();
+    VMesh* vmesh = field.vmesh();
+    if (!vfield || !vmesh)
+      return 0;
+    const size_t valueSize = valueBytes(*vfield);
+    if (!vfield->is_nodata() && valueSize == 0)
+      return 0;
+
+    ContentHash hash;
+    hash.add(field.dynamic_type_name());
+
+    VMesh::dimension_type dims;
+    vmesh->get_dimensions(dims);
+    hash.add(static_cast<boost::uint64_t>(dims.size()));
+    for (auto d : dims)
+      hash.add(static_cast<boost::uint64_t>(d));
+
+    const VMesh::size_type numNodes = vmesh->num_nodes();
+    Geometry::Point p;
+    for (VMesh::Node::index_type i = 0; i < numNodes; ++i)
+    {
+      vmesh->get_center(p, i);
+      addPoint(hash, p);
+    }
+
+    // structured meshes have their connectivity fixed by the dimensions
+    if (vmesh->is_unstructuredmesh())
+    {
+      const VMesh::size_type numElems = vmesh->num_elems();
+      VMesh::Node::array_type nodes;
+      for (VMesh::Elem::index_type i = 0; i < numElems; ++i)
+      {
+        vmesh->get_nodes(nodes, i);
+        hash.add(nodes.data(), nodes.size() * sizeof(VMesh::Node::index_type));
+      }
+    }
+
+    if (!vfield->is_nodata())
+    {
+      hash.add(static_cast<boost::uint64_t>(vfield->basis_order()));
+      hash.add(vfield->fdata_pointer(), vfield->num_values() * valueSize);
+      if (vfield->num_evalues() > 0)
+        hash.add(vfield->efdata_pointer(), vfield->num_evalues() * valueSize);
+    }
+    return hash.value();
+  }
+
+  /// The caller holds entry.work.
+  void hashOnce(PortDataCacheEntry& entry, const DatatypeHandle& data)
+  {
+    if (!entry.hashed)
+    {
+      entry.hash = PortDataCache::hashContents(data);
+      entry.hashed = true;
+    }
+  }
+
+  bool writeSpillFile(const DatatypeHandle& data, const boost::filesystem::path& dir, boost::filesystem::path& file)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir, ec);
+    file = dir / boost::filesystem::unique_path("scirun-port-%%%%-%%%%-%%%%.fas");
+    auto stream = auto_ostream(file.string(), "Fast");
+    if (!stream || stream->error())
+    {
+      logError("Could not spill port data to {}", file.string());
+      return false;
+    }
+
+    if (auto matrix = boost::dynamic_pointer_cast<Matrix>(data))
+      Pio(*stream, matrix);
+    else if (auto field = boost::dynamic_pointer_cast<Field>(data))
+      Pio(*stream, field);
+    const bool failed = stream->error();
+    stream.reset();
+    if (failed)
+    {
+      boost::filesystem::remove(file, ec);
+      logError("Could not spill port data to {}", file.string());
+      return false;
+    }
+    return true;
+  }
+
+  DatatypeHandle readSpillFile(const boost::filesystem::path& file, bool isField)
+  {
+    DatatypeHandle data;
+    PiostreamPtr stream(new FastPiostream(file.string(), Piostream::Read));
+    if (!stream->error())
+    {
+      if (isField)
+      {
+        FieldHandle field;
+        Pio(*stream, field);
+        if (!stream->error())
+          data = field;
+      }
+      else
+      {
+        MatrixHandle matrix;
+        Pio(*stream, matrix);
+        if (!stream->error())
+          data = matrix;
+      }
+    }
+    if (!data)
+      logError("Could not read spilled port data from {}", file.string());
+    return data;
+  }
+}
+
+PortDataCache::PortDataCache(size_t memoryBudget) :
+  memoryBudget_(memoryBudget),
+  clock_(0),
+  spillDirectory_(boost::filesystem::temp_directory_path() / "scirun_port_cache")
+{
+}
+
+PortDataCache::~PortDataCache()
+{
+}
+
+PortDataCache& PortDataCache::instance()
+{
+  static PortDataCache cache;
+  return cache;
+}
+
+PortDataCacheEntryHandle PortDataCache::store(DatatypeHandle data, double productionSeconds)
+{
+  if (!data)
+    return PortDataCacheEntryHandle();
+
+  auto entry = boost::make_shared<PortDataCacheEntry>();
+  entry->data = data;
+  entry->bytes = std::max<size_t>(estimateBytes(data), 1);
+  entry->cost = std::max(productionSeconds, 1e-3);
+  entry->isField = boost::dynamic_pointer_cast<Field>(data) != nullptr;
+  entry->spillable = entry->isField || boost::dynamic_pointer_cast<Matrix>(data);
+
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    touch(*entry);
+    entries_.push_back(entry);
+  }
+  trim();
+  return entry;
+}
+
+DatatypeHandle PortDataCache::fetch(const PortDataCacheEntryHandle& entry)
+{
+  if (!entry)
+    return DatatypeHandle();
+
+  DatatypeHandle data;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    data = entry->data;
+    if (data)
+      touch(*entry);
+  }
+  if (!data)
+  {
+    // one reader per entry goes to disk; the others find its result below
+    boost::mutex::scoped_lock work(entry->work);
+    boost::filesystem::path file;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      data = entry->data;
+      file = entry->file;
+    }
+    if (!data)
+    {
+      auto loaded = readSpillFile(file, entry->isField);
+      if (!loaded)
+        return DatatypeHandle();
+      boost::mutex::scoped_lock lock(mutex_);
+      entry->data = data = loaded;
+    }
+    boost::mutex::scoped_lock lock(mutex_);
+    touch(*entry);
+  }
+  trim();
+  return data;
+}
+
+boost::uint64_t PortDataCache::contentHash(const PortDataCacheEntryHandle& entry)
+{
+  if (!entry)
+    return 0;
+
+  boost::mutex::scoped_lock work(entry->work);
+  if (!entry->hashed)
+  {
+    // spilled entries were hashed before they were written, so data is resident here
+    DatatypeHandle data;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      data = entry->data;
+    }
+    hashOnce(*entry, data);
+  }
+  return entry->hash;
+}
+
+bool PortDataCache::isResident(const PortDataCacheEntryHandle& entry) const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return entry && entry->data;
+}
+
+void PortDataCache::touch(PortDataCacheEntry& entry)
+{
+  entry.priority = clock_ + entry.cost / entry.bytes;
+}
+
+size_t PortDataCache::residentBytes() const
+{
+  size_t bytes = 0;
+  for (const auto& weak : entries_)
+  {
+    auto entry = weak.lock();
+    if (entry && entry->data)
+      bytes += entry->bytes;
+  }
+  return bytes;
+}
+
+void PortDataCache::trim()
+{
+  // Pick victims under the lock, write them out without it, then drop the
+  // in-memory copies of those nobody picked up in the meantime.
+  std::vector<std::pair<PortDataCacheEntryHandle, DatatypeHandle>> victims;
+  boost::filesystem::path dir;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+      [](const boost::weak_ptr<PortDataCacheEntry>& e) { return e.expired(); }), entries_.end());
+
+    if (memoryBudget_ == 0)
+      return;
+
+    std::vector<PortDataCacheEntryHandle> candidates;
+    size_t used = 0;
+    for (const auto& weak : entries_)
+    {
+      auto entry = weak.lock();
+      if (!entry || !entry->data || entry->spilling)
+        continue;
+      used += entry->bytes;
+      // data still referenced elsewhere would not be freed by spilling it
+      if (entry->spillable && entry->data.use_count() == 1)
+        candidates.push_back(entry);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+      [](const PortDataCacheEntryHandle& a, const PortDataCacheEntryHandle& b) { return a->priority < b->priority; });
+
+    for (const auto& entry : candidates)
+    {
+      if (used <= memoryBudget_)
+        break;
+      clock_ = entry->priority;
+      entry->spilling = true;
+      used -= entry->bytes;
+      victims.emplace_back(entry, entry->data);
+    }
+    dir = spillDirectory_;
+  }
+
+  for (auto& victim : victims)
+  {
+    auto& entry = *victim.first;
+    bool written;
+    boost::filesystem::path file;
+    {
+      boost::mutex::scoped_lock work(entry.work);
+      hashOnce(entry, victim.second);
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        file = entry.file;
+      }
+      written = !file.empty() || writeSpillFile(victim.second, dir, file);
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    entry.spilling = false;
+    if (!written)
+    {
+      entry.spillable = false;
+      continue;
+    }
+    entry.file = file;
+    // a fetch during the write took its own reference; keep the data in memory for it
+    if (entry.data.use_count() == 2)
+    {
+      LOG_DEBUG("Spilled {} bytes of port data to {}", entry.bytes, file.string());
+      entry.data.reset();
+    }
+  }
+}
+
+size_t PortDataCache::memoryBudget() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return memoryBudget_;
+}
+
+void PortDataCache::setMemoryBudget(size_t bytes)
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    memoryBudget_ = bytes;
+  }
+  trim();
+}
+
+size_t PortDataCache::memoryUsed() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return residentBytes();
+}
+
+size_t PortDataCache::size() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return std::count_if(entries_.begin(), entries_.end(),
+    [](const boost::weak_ptr<PortDataCacheEntry>& e) { return !e.expired(); });
+}
+
+boost::filesystem::path PortDataCache::spillDirectory() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return spillDirectory_;
+}
+
+void PortDataCache::setSpillDirectory(const boost::filesystem::path& dir)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  spillDirectory_ = dir;
+}
+
+size_t PortDataCache::estimateBytes(const DatatypeHandle& data)
+{
+  const size_t fallback = 1024;
+  if (auto dense = boost::dynamic_pointer_cast<DenseMatrix>(data))
+    return dense->size() * sizeof(double);
+  if (auto column = boost::dynamic_pointer_cast<DenseColumnMatrix>(data))
+    return column->size() * sizeof(double);
+  if (auto sparse = boost::dynamic_pointer_cast<SparseRowMatrix>(data))
+    return sparse->nonZeros() * (sizeof(double) + sizeof(index_type)) + (sparse->outerSize() + 1) * sizeof(index_type);
+  if (auto field = boost::dynamic_pointer_cast<Field>(data))
+  {
+    VField* vfield = field->vfield();
+    VMesh* vmesh = field->vmesh();
+    if (!vfield || !vmesh)
+      return fallback;
+    size_t bytes = fallback;
+    if (vmesh->is_irregularmesh())
+      bytes += vmesh->num_nodes() * 3 * sizeof(double);
+    if (vmesh->is_unstructuredmesh())
+      bytes += vmesh->num_elems() * vmesh->num_nodes_per_elem() * sizeof(VMesh::Node::index_type);
+    const size_t valueSize = std::max<size_t>(valueBytes(*vfield), sizeof(double));
+    bytes += (vfield->num_values() + vfield->num_evalues()) * valueSize;
+    return bytes;
+  }
+  return fallback;
+}
+
+boost::uint64_t PortDataCache::hashContents(const DatatypeHandle& data)
+{
+  if (auto dense = boost::dynamic_pointer_cast<DenseMatrix>(data))
+  {
+    ContentHash hash;
+    hash.add(static_cast<boost::uint64_t>(dense->rows()));
+    hash.add(static_cast<boost::uint64_t>(dense->cols()));
+    hash.add(dense->data(), dense->size() * sizeof(double));
+    return hash.value();
+  }
+  if (auto column = boost::dynamic_pointer_cast<DenseColumnMatrix>(data))
+  {
+    ContentHash hash;
+    hash.add(static_cast<boost::uint64_t>(column->rows()));
+    hash.add(static_cast<boost::uint64_t>(1));
+    hash.add(column->data(), column->size() * sizeof(double));
+    return hash.value();
+  }
+  if (auto sparse = boost::dynamic_pointer_cast<SparseRowMatrix>(data))
+    return hashSparse(*sparse);
+  if (auto field = boost::dynamic_pointer_cast<Field>(data))
+    return hashField(*field);
+  return 0;
+}
+
+PortDataCache::ProductionScope::ProductionScope() :
+  previous_(productionStart.get() ? *productionStart : 0)
+{
+  if (!productionStart.get())
+    productionStart.reset(new boost::uint64_t);
+  *productionStart = Logging::ExecutionTracer::now();
+}
+
+PortDataCache::ProductionScope::~ProductionScope()
+{
+  *productionStart = previous_;
+}
+
+double PortDataCache::ProductionScope::elapsedSeconds()
+{
+  if (!productionStart.get() || *productionStart == 0)
+    return 0;
+  return (Logging::ExecutionTracer::now() - *productionStart) * 1e-6;
+}
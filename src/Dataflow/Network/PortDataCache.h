@@ -0,0 +1,126 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_PORTDATACACHE_H
+#define DATAFLOW_NETWORK_PORTDATACACHE_H
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      class PortDataCacheEntry;
+      typedef boost::shared_ptr<PortDataCacheEntry> PortDataCacheEntryHandle;
+
+      /// Holds the data cached on output ports within a memory budget. When the
+      /// budget is exceeded, matrices and fields that no module is currently
+      /// using are written to disk in the fast binary Pio format and released;
+      /// they are read back the next time a port asks for them. Victims are
+      /// chosen by greedy-dual-size: an entry's priority is the time it took to
+      /// produce divided by its size, aged like LRU, so small, expensive outputs
+      /// stay in memory longest.
+      ///
+      /// Every entry also carries a hash of its contents, which lets an input
+      /// port tell new data with unchanged contents from a real change. It is
+      /// computed on first request, outside the cache lock.
+      /// All functions are thread safe.
+      class SCISHARE PortDataCache : boost::noncopyable
+      {
+      public:
+        /// A budget of zero means unlimited: nothing is ever spilled.
+        explicit PortDataCache(size_t memoryBudget = 0);
+        ~PortDataCache();
+
+        /// The cache used by all output ports.
+        static PortDataCache& instance();
+
+        /// Adds data produced in the given number of seconds. The entry lives as
+        /// long as the returned handle; its spill file is removed with it.
+        PortDataCacheEntryHandle store(Core::Datatypes::DatatypeHandle data, double productionSeconds);
+        /// The data of entry, read back from disk if it was spilled. Empty if it cannot be read.
+        Core::Datatypes::DatatypeHandle fetch(const PortDataCacheEntryHandle& entry);
+        /// Hash of the contents of entry, or zero for datatypes that are not hashed.
+        boost::uint64_t contentHash(const PortDataCacheEntryHandle& entry);
+        bool isResident(const PortDataCacheEntryHandle& entry) const;
+
+        size_t memoryBudget() const;
+        void setMemoryBudget(size_t bytes);
+        size_t memoryUsed() const;
+        size_t size() const;
+
+        boost::filesystem::path spillDirectory() const;
+        void setSpillDirectory(const boost::filesystem::path& dir);
+
+        /// Approximate memory held by data, in bytes.
+        static size_t estimateBytes(const Core::Datatypes::DatatypeHandle& data);
+        /// Hash of the values and structure of matrices and fields; zero for other datatypes.
+        static boost::uint64_t hashContents(const Core::Datatypes::DatatypeHandle& data);
+
+        /// Marks the current thread as executing a module from now on, so that
+        /// stored outputs are charged the time since construction as their cost.
+        class SCISHARE ProductionScope : boost::noncopyable
+        {
+        public:
+          ProductionScope();
+          ~ProductionScope();
+          /// Seconds since the innermost scope on this thread began, or zero outside any scope.
+          static double elapsedSeconds();
+        private:
+          boost::uint64_t previous_;
+        };
+
+      private:
+        void touch(PortDataCacheEntry& entry);
+        size_t residentBytes() const;
+        /// Spills entries until resident data fits the budget. Called without mutex_,
+        /// which is only held to pick victims and publish results, never during file I/O.
+        void trim();
+
+        mutable boost::mutex mutex_;
+        std::vector<boost::weak_ptr<PortDataCacheEntry>> entries_;
+        size_t memoryBudget_;
+        /// greedy-dual-size inflation: the priority of the last entry evicted
+        double clock_;
+        boost::filesystem::path spillDirectory_;
+      };
+    }
+  }
+}
+
+#endif
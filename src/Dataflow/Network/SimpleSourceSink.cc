@@ -39,6 +39,8 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms::General;
 
 SimpleSink::SimpleSink() :
+  lastId_(-1),
+  lastHash_(0),
   hasChanged_(false),
   checkForNewDataOnSetting_(false)
 {
@@ -77,30 +79,47 @@ void SimpleSink::invalidateAll()
     sink->invalidateProvider();
 }
 
+void SimpleSink::invalidateProvider()
+{
+  lastId_ = -1;
+  lastHash_ = 0;
+}
+
 DatatypeHandleOption SimpleSink::receive()
 {
   if (auto strong = weakData_.lock())
   {
     return strong;
   }
+  if (auto entry = weakEntry_.lock())
+  {
+    if (auto data = PortDataCache::instance().fetch(entry))
+    {
+      weakData_ = data;
+      return data;
+    }
+  }
   return DatatypeHandleOption();
 }
 
-void SimpleSink::setData(DatatypeHandle data)
+void SimpleSink::setData(DatatypeHandle data, PortDataCacheEntryHandle entry)
 {
-  if (auto strong = weakData_.lock())
+  if (data)
   {
-    if (data)
+    if (data->id() == lastId_)
+      hasChanged_ = false;
+    else
     {
-      hasChanged_ = strong->id() != data->id();
+      // contents only need comparing when unchanged data may be skipped
+      const auto hash = entry && globalPortCaching_ ? PortDataCache::instance().contentHash(entry) : 0;
+      hasChanged_ = hash == 0 || hash != lastHash_;
+      lastHash_ = hash;
     }
-  }
-  else if (data)
-  {
-    hasChanged_ = true;
+    lastId_ = data->id();
   }
 
   weakData_ = data;
+  weakEntry_ = entry;
   if (data && hasChanged_ && checkForNewDataOnSetting_)
     dataHasChanged_(data);
 }
@@ -131,7 +150,12 @@ boost::signals2::connection SimpleSink::connectDataHasChanged(const DataHasChang
 
 void SimpleSource::cacheData(DatatypeHandle data)
 {
-  data_ = data;
+  entry_ = PortDataCache::instance().store(data, PortDataCache::ProductionScope::elapsedSeconds());
+}
+
+DatatypeHandle SimpleSource::data() const
+{
+  return PortDataCache::instance().fetch(entry_);
 }
 
 void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
@@ -140,12 +164,12 @@ void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
   if (!sink)
     THROW_INVALID_ARGUMENT("SimpleSource can only send to SimpleSinks");
 
-  sink->setData(data_);
+  sink->setData(data(), entry_);
 }
 
 bool SimpleSource::hasData() const
 {
-  return data_ != nullptr;
+  return entry_ != nullptr;
 }
 
 SimpleSource::SimpleSource()
@@ -163,11 +187,13 @@ std::set<SimpleSource*> SimpleSource::instances_;
 void SimpleSource::clearAllSources()
 {
   for (auto source : instances_)
-    source->data_.reset();
+    source->entry_.reset();
 }
 
 std::string SimpleSource::describeData() const
 {
+  if (entry_ && !PortDataCache::instance().isResident(entry_))
+    return "[Spilled to disk]";
   DescribeDatatype dd;
-  return dd.describe(data_);
+  return dd.describe(data());
 }
@@ -32,6 +32,7 @@
 #define DATAFLOW_NETWORK_SIMPLESOURCESINK_H
 
 #include <Dataflow/Network/DataflowInterfaces.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <boost/function.hpp>
 #include <set>
 #include <Dataflow/Network/share.h>
@@ -53,8 +54,10 @@ namespace SCIRun
         Core::Datatypes::DatatypeHandleOption receive() override;
         DatatypeSinkInterface* clone() const override;
         bool hasChanged() const override;
-        void setData(Core::Datatypes::DatatypeHandle data);
-        void invalidateProvider() override { /*TODO*/ }
+        /// Data that has a new id but the same content hash as the last data
+        /// received does not count as a change.
+        void setData(Core::Datatypes::DatatypeHandle data, PortDataCacheEntryHandle entry = PortDataCacheEntryHandle());
+        void invalidateProvider() override;
         boost::signals2::connection connectDataHasChanged(const DataHasChangedSignalType::slot_type& subscriber) override;
         void forceFireDataHasChanged() override;
 
@@ -63,6 +66,10 @@ namespace SCIRun
 
       private:
         WeakDatatypeHandle weakData_;
+        /// lets a spilled output be read back after the sender dropped its copy
+        boost::weak_ptr<PortDataCacheEntry> weakEntry_;
+        Core::Datatypes::Datatype::id_type lastId_;
+        boost::uint64_t lastHash_;
         mutable bool hasChanged_;
         DataHasChangedSignalType dataHasChanged_;
         bool checkForNewDataOnSetting_;
@@ -97,7 +104,8 @@ namespace SCIRun
 
         static void clearAllSources();
       protected:
-        SCIRun::Core::Datatypes::DatatypeHandle data_;
+        Core::Datatypes::DatatypeHandle data() const;
+        PortDataCacheEntryHandle entry_;
         static std::set<SimpleSource*> instances_;
       };
     }
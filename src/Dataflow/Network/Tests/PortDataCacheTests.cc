@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Scalar.h>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  DenseMatrixHandle makeMatrix(double start)
+  {
+    DenseMatrixHandle m(new DenseMatrix(64, 64));
+    for (int i = 0; i < m->rows(); ++i)
+      for (int j = 0; j < m->cols(); ++j)
+        (*m)(i, j) = start + i * m->cols() + j;
+    return m;
+  }
+
+  const size_t matrixBytes = 64 * 64 * sizeof(double);
+}
+
+class PortDataCacheTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("port-cache-test-%%%%-%%%%");
+  }
+  void TearDown() override
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(dir_, ec);
+  }
+  boost::filesystem::path dir_;
+};
+
+TEST_F(PortDataCacheTests, SpillsUnusedMatricesOverBudgetAndReadsThemBack)
+{
+  PortDataCache cache(matrixBytes + matrixBytes / 2);
+  cache.setSpillDirectory(dir_);
+
+  auto first = cache.store(makeMatrix(0), 1.0);
+  EXPECT_TRUE(cache.isResident(first));
+  auto second = cache.store(makeMatrix(1), 1.0);
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_LE(cache.memoryUsed(), cache.memoryBudget());
+  EXPECT_FALSE(cache.isResident(first));
+  EXPECT_TRUE(cache.isResident(second));
+
+  auto reloaded = boost::dynamic_pointer_cast<DenseMatrix>(cache.fetch(first));
+  ASSERT_TRUE(reloaded != nullptr);
+  EXPECT_EQ(*makeMatrix(0), *reloaded);
+  EXPECT_TRUE(cache.isResident(first));
+}
+
+TEST_F(PortDataCacheTests, KeepsDataThatIsStillInUse)
+{
+  PortDataCache cache(matrixBytes / 2);
+  cache.setSpillDirectory(dir_);
+
+  auto data = makeMatrix(0);
+  auto entry = cache.store(data, 1.0);
+  EXPECT_TRUE(cache.isResident(entry));
+
+  data.reset();
+  cache.setMemoryBudget(matrixBytes / 4);
+  EXPECT_FALSE(cache.isResident(entry));
+}
+
+TEST_F(PortDataCacheTests, EvictsCheapOutputsFirst)
+{
+  PortDataCache cache(2 * matrixBytes + matrixBytes / 2);
+  cache.setSpillDirectory(dir_);
+
+  auto expensive = cache.store(makeMatrix(0), 10.0);
+  auto cheap = cache.store(makeMatrix(1), 0.01);
+  auto third = cache.store(makeMatrix(2), 1.0);
+
+  EXPECT_TRUE(cache.isResident(expensive));
+  EXPECT_FALSE(cache.isResident(cheap));
+  EXPECT_TRUE(cache.isResident(third));
+}
+
+TEST_F(PortDataCacheTests, UnlimitedBudgetNeverSpills)
+{
+  PortDataCache cache;
+  cache.setSpillDirectory(dir_);
+
+  auto first = cache.store(makeMatrix(0), 1.0);
+  auto second = cache.store(makeMatrix(1), 1.0);
+  EXPECT_TRUE(cache.isResident(first));
+  EXPECT_TRUE(cache.isResident(second));
+  EXPECT_EQ(2 * matrixBytes, cache.memoryUsed());
+  EXPECT_FALSE(boost::filesystem::exists(dir_));
+}
+
+TEST_F(PortDataCacheTests, EntriesLeaveWithTheirHandles)
+{
+  PortDataCache cache;
+  auto entry = cache.store(makeMatrix(0), 1.0);
+  EXPECT_EQ(1u, cache.size());
+  entry.reset();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.memoryUsed());
+}
+
+TEST_F(PortDataCacheTests, ConcurrentFetchesSeeWholeData)
+{
+  PortDataCache cache(2 * matrixBytes + matrixBytes / 2);
+  cache.setSpillDirectory(dir_);
+
+  const int numEntries = 6;
+  std::vector<PortDataCacheEntryHandle> entries;
+  for (int i = 0; i < numEntries; ++i)
+    entries.push_back(cache.store(makeMatrix(i), 1.0));
+
+  std::atomic<int> mismatches(0);
+  boost::thread_group threads;
+  for (int t = 0; t < 4; ++t)
+    threads.create_thread([&, t]()
+    {
+      for (int n = 0; n < 50; ++n)
+      {
+        const int i = (n + t) % numEntries;
+        auto data = boost::dynamic_pointer_cast<DenseMatrix>(cache.fetch(entries[i]));
+        if (!data || *data != *makeMatrix(i) || cache.contentHash(entries[i]) != PortDataCache::hashContents(data))
+          ++mismatches;
+      }
+    });
+  threads.join_all();
+
+  EXPECT_EQ(0, mismatches);
+  EXPECT_LE(cache.memoryUsed(), cache.memoryBudget());
+}
+
+TEST(PortDataCacheHashTests, EqualContentsHashEqual)
+{
+  auto a = makeMatrix(0);
+  auto b = makeMatrix(0);
+  auto c = makeMatrix(1);
+  ASSERT_NE(a->id(), b->id());
+
+  EXPECT_NE(0u, PortDataCache::hashContents(a));
+  EXPECT_EQ(PortDataCache::hashContents(a), PortDataCache::hashContents(b));
+  EXPECT_NE(PortDataCache::hashContents(a), PortDataCache::hashContents(c));
+  EXPECT_EQ(0u, PortDataCache::hashContents(boost::make_shared<Int32>(2)));
+}
+
+TEST(PortDataCacheHashTests, SinkIgnoresNewDataWithSameContents)
+{
+  auto& cache = PortDataCache::instance();
+  SimpleSink sink;
+
+  auto first = makeMatrix(0);
+  sink.setData(first, cache.store(first, 1.0));
+  EXPECT_TRUE(sink.hasChanged());
+
+  auto same = makeMatrix(0);
+  sink.setData(same, cache.store(same, 1.0));
+  EXPECT_FALSE(sink.hasChanged());
+
+  sink.setData(first, cache.store(first, 1.0));
+  EXPECT_FALSE(sink.hasChanged());
+
+  auto different = makeMatrix(1);
+  auto differentEntry = cache.store(different, 1.0);
+  sink.setData(different, differentEntry);
+  sink.setData(different, differentEntry);
+  EXPECT_FALSE(sink.hasChanged());
+  sink.setData(first, cache.store(first, 1.0));
+  EXPECT_TRUE(sink.hasChanged());
+
+  sink.invalidateProvider();
+  auto again = makeMatrix(0);
+  sink.setData(again, cache.store(again, 1.0));
+  EXPECT_TRUE(sink.hasChanged());
+}
@@ -0,0 +1,198 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Core::Algorithms;
+
+namespace
+{
+  bool sameValue(const NoteXML& lhs, const NoteXML& rhs)
+  {
+    return lhs.noteHTML == rhs.noteHTML && lhs.noteText == rhs.noteText &&
+      lhs.position == rhs.position && lhs.fontSize == rhs.fontSize;
+  }
+
+  template <class T>
+  bool sameValue(const T& lhs, const T& rhs)
+  {
+    return lhs == rhs;
+  }
+
+  bool sameValue(const DisabledComponents& lhs, const DisabledComponents& rhs)
+  {
+    return lhs.disabledModules == rhs.disabledModules && lhs.disabledConnections == rhs.disabledConnections;
+  }
+
+  template <class Map>
+  MapDelta<Map> diffMaps(const Map& from, const Map& to)
+  {
+    MapDelta<Map> delta;
+    for (const auto& entry : to)
+    {
+      auto old = from.find(entry.first);
+      if (old == from.end() || !sameValue(old->second, entry.second))
+        delta.changed.insert(entry);
+    }
+    for (const auto& entry : from)
+    {
+      if (to.find(entry.first) == to.end())
+        delta.removed.push_back(entry.first);
+    }
+    return delta;
+  }
+
+  template <class Map>
+  void applyMap(Map& map, const MapDelta<Map>& delta)
+  {
+    for (const auto& key : delta.removed)
+      map.erase(key);
+    for (const auto& entry : delta.changed)
+      map[entry.first] = entry.second;
+  }
+
+  ConnectionsXML missingFrom(const ConnectionsXML& connections, const ConnectionsXML& other)
+  {
+    ConnectionsXML missing;
+    std::copy_if(connections.begin(), connections.end(), std::back_inserter(missing),
+      [&other](const ConnectionDescriptionXML& cd) { return std::find(other.begin(), other.end(), cd) == other.end(); });
+    return missing;
+  }
+
+  /// Differing variables, or none if the modules differ by more than variable values.
+  boost::optional<Variable::List> diffModuleState(const ModuleWithState& from, const ModuleWithState& to)
+  {
+    if (!(from.module == to.module))
+      return boost::none;
+
+    auto keys = to.state.getKeys();
+    if (keys != from.state.getKeys())
+      return boost::none;
+
+    Variable::List changed;
+    for (const auto& key : keys)
+    {
+      auto value = to.state.getValue(key);
+      if (value != from.state.getValue(key))
+        changed.push_back(value);
+    }
+    return changed;
+  }
+}
+
+bool NetworkFileDelta::empty() const
+{
+  return onlyModulePositions() && modulePositions.empty();
+}
+
+bool NetworkFileDelta::onlyModulePositions() const
+{
+  return onlyStructure() && modules.empty() &&
+    addedConnections.empty() && removedConnections.empty();
+}
+
+bool NetworkFileDelta::onlyStructure() const
+{
+  return moduleStates.empty() &&
+    moduleNotes.empty() && connectionNotes.empty() &&
+    moduleTags.empty() && moduleTagLabels.empty() && !showTagGroupsOnLoad &&
+    !disabledComponents && subnetworks.empty();
+}
+
+NetworkFileDelta SCIRun::Dataflow::Networks::diffNetworkFiles(const NetworkFile& from, const NetworkFile& to)
+{
+  NetworkFileDelta delta;
+
+  const auto& fromModules = from.network.modules;
+  for (const auto& entry : to.network.modules)
+  {
+    auto old = fromModules.find(entry.first);
+    if (old == fromModules.end())
+    {
+      delta.modules.changed.insert(entry);
+      continue;
+    }
+    auto changedVariables = diffModuleState(old->second, entry.second);
+    if (!changedVariables)
+      delta.modules.changed.insert(entry);
+    else if (!changedVariables->empty())
+      delta.moduleStates[entry.first] = *changedVariables;
+  }
+  for (const auto& entry : fromModules)
+  {
+    if (to.network.modules.find(entry.first) == to.network.modules.end())
+      delta.modules.removed.push_back(entry.first);
+  }
+
+  delta.addedConnections = missingFrom(to.network.connections, from.network.connections);
+  delta.removedConnections = missingFrom(from.network.connections, to.network.connections);
+
+  delta.modulePositions = diffMaps(from.modulePositions.modulePositions, to.modulePositions.modulePositions);
+  delta.moduleNotes = diffMaps(from.moduleNotes.notes, to.moduleNotes.notes);
+  delta.connectionNotes = diffMaps(from.connectionNotes.notes, to.connectionNotes.notes);
+  delta.moduleTags = diffMaps(from.moduleTags.tags, to.moduleTags.tags);
+  delta.moduleTagLabels = diffMaps(from.moduleTags.labels, to.moduleTags.labels);
+  if (from.moduleTags.showTagGroupsOnLoad != to.moduleTags.showTagGroupsOnLoad)
+    delta.showTagGroupsOnLoad = to.moduleTags.showTagGroupsOnLoad;
+  if (!sameValue(from.disabledComponents, to.disabledComponents))
+    delta.disabledComponents = to.disabledComponents;
+  delta.subnetworks = diffMaps(from.subnetworks.subnets, to.subnetworks.subnets);
+
+  return delta;
+}
+
+void SCIRun::Dataflow::Networks::applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta)
+{
+  applyMap(file.network.modules, delta.modules);
+  for (const auto& entry : delta.moduleStates)
+  {
+    auto& state = file.network.modules[entry.first].state;
+    for (const auto& variable : entry.second)
+      state.setValue(variable.name(), variable.value());
+  }
+
+  auto& connections = file.network.connections;
+  for (const auto& cd : delta.removedConnections)
+    connections.erase(std::remove(connections.begin(), connections.end(), cd), connections.end());
+  connections.insert(connections.end(), delta.addedConnections.begin(), delta.addedConnections.end());
+
+  applyMap(file.modulePositions.modulePositions, delta.modulePositions);
+  applyMap(file.moduleNotes.notes, delta.moduleNotes);
+  applyMap(file.connectionNotes.notes, delta.connectionNotes);
+  applyMap(file.moduleTags.tags, delta.moduleTags);
+  applyMap(file.moduleTags.labels, delta.moduleTagLabels);
+  if (delta.showTagGroupsOnLoad)
+    file.moduleTags.showTagGroupsOnLoad = *delta.showTagGroupsOnLoad;
+  if (delta.disabledComponents)
+    file.disabledComponents = *delta.disabledComponents;
+  applyMap(file.subnetworks.subnets, delta.subnetworks);
+}
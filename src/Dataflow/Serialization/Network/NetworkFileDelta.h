@@ -0,0 +1,80 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+#define CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+
+#include <boost/optional.hpp>
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Entries of a map that were inserted or changed, and the keys that were erased.
+  template <class Map>
+  struct MapDelta
+  {
+    Map changed;
+    std::vector<typename Map::key_type> removed;
+    bool empty() const { return changed.empty() && removed.empty(); }
+  };
+
+  /// The changes that turn one NetworkFile into another. A module whose
+  /// lookup info and state keys are unchanged only records the state
+  /// variables that differ, so moving or editing one module in a large
+  /// network produces a delta of a few entries.
+  struct SCISHARE NetworkFileDelta
+  {
+    MapDelta<ModuleMapXML> modules;
+    std::map<std::string, Core::Algorithms::Variable::List> moduleStates;
+    ConnectionsXML addedConnections, removedConnections;
+    MapDelta<ModulePositions::Data> modulePositions;
+    MapDelta<NotesMapXML> moduleNotes, connectionNotes;
+    MapDelta<ModuleTagsMapXML> moduleTags;
+    MapDelta<ModuleTagLabelOverridesMapXML> moduleTagLabels;
+    boost::optional<bool> showTagGroupsOnLoad;
+    boost::optional<DisabledComponents> disabledComponents;
+    MapDelta<SubnetworkMap> subnetworks;
+
+    bool empty() const;
+    /// True if applying the delta only changes module positions.
+    bool onlyModulePositions() const;
+    /// True if applying the delta only adds or removes whole modules and
+    /// connections, and moves modules.
+    bool onlyStructure() const;
+  };
+
+  SCISHARE NetworkFileDelta diffNetworkFiles(const NetworkFile& from, const NetworkFile& to);
+  SCISHARE void applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta);
+
+}}}
+
+#endif
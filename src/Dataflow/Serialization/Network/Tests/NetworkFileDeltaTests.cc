@@ -0,0 +1,148 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Algorithms;
+
+namespace
+{
+  ModuleWithState module(const std::string& name, int value)
+  {
+    ModuleLookupInfoXML info;
+    info.module_name_ = name;
+    info.category_name_ = "Math";
+    info.package_name_ = "SCIRun";
+    SCIRun::Dataflow::State::SimpleMapModuleStateXML state;
+    state.setValue(Name("Value"), value);
+    state.setValue(Name("Label"), std::string("label"));
+    return ModuleWithState(info, state);
+  }
+
+  ConnectionDescriptionXML connection(const std::string& from, const std::string& to)
+  {
+    ConnectionDescriptionXML conn;
+    conn.out_.moduleId_ = ModuleId(from);
+    conn.in_.moduleId_ = ModuleId(to);
+    conn.out_.portId_ = PortId(0, "Result");
+    conn.in_.portId_ = PortId(0, "Input");
+    return conn;
+  }
+
+  NetworkFile exampleFile()
+  {
+    NetworkFile file;
+    file.network.modules["CreateMatrix:1"] = module("CreateMatrix", 1);
+    file.network.modules["ReportMatrixInfo:2"] = module("ReportMatrixInfo", 2);
+    file.network.connections.push_back(connection("CreateMatrix:1", "ReportMatrixInfo:2"));
+    file.modulePositions.modulePositions["CreateMatrix:1"] = { 0, 0 };
+    file.modulePositions.modulePositions["ReportMatrixInfo:2"] = { 0, 100 };
+    file.moduleNotes.notes["CreateMatrix:1"] = NoteXML("<b>note</b>", 1, "note", 12);
+    return file;
+  }
+
+  std::string toXml(const NetworkFile& file)
+  {
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(file, ostr, "networkFile");
+    return ostr.str();
+  }
+}
+
+TEST(NetworkFileDeltaTests, IdenticalFilesHaveEmptyDelta)
+{
+  auto file = exampleFile();
+  auto delta = diffNetworkFiles(file, file);
+  EXPECT_TRUE(delta.empty());
+  EXPECT_TRUE(delta.onlyModulePositions());
+}
+
+TEST(NetworkFileDeltaTests, ModuleMoveOnlyRecordsPosition)
+{
+  auto from = exampleFile();
+  auto to = from;
+  to.modulePositions.modulePositions["ReportMatrixInfo:2"] = { 50, 150 };
+
+  auto delta = diffNetworkFiles(from, to);
+  EXPECT_FALSE(delta.empty());
+  EXPECT_TRUE(delta.onlyModulePositions());
+  ASSERT_EQ(1, delta.modulePositions.changed.size());
+  EXPECT_EQ(std::make_pair(50.0, 150.0), delta.modulePositions.changed["ReportMatrixInfo:2"]);
+
+  applyNetworkFileDelta(from, delta);
+  EXPECT_EQ(toXml(to), toXml(from));
+}
+
+TEST(NetworkFileDeltaTests, StateChangeOnlyRecordsChangedVariables)
+{
+  auto from = exampleFile();
+  auto to = from;
+  to.network.modules["CreateMatrix:1"].state.setValue(Name("Value"), 7);
+
+  auto delta = diffNetworkFiles(from, to);
+  EXPECT_TRUE(delta.modules.empty());
+  ASSERT_EQ(1, delta.moduleStates.size());
+  ASSERT_EQ(1, delta.moduleStates["CreateMatrix:1"].size());
+  EXPECT_EQ(7, delta.moduleStates["CreateMatrix:1"][0].toInt());
+  EXPECT_FALSE(delta.onlyModulePositions());
+
+  applyNetworkFileDelta(from, delta);
+  EXPECT_EQ(toXml(to), toXml(from));
+}
+
+TEST(NetworkFileDeltaTests, RoundTripsStructuralChanges)
+{
+  auto from = exampleFile();
+  auto to = from;
+  to.network.modules.erase("ReportMatrixInfo:2");
+  to.network.connections.clear();
+  to.modulePositions.modulePositions.erase("ReportMatrixInfo:2");
+  to.network.modules["ReportMatrixInfo:3"] = module("ReportMatrixInfo", 3);
+  to.network.connections.push_back(connection("CreateMatrix:1", "ReportMatrixInfo:3"));
+  to.modulePositions.modulePositions["ReportMatrixInfo:3"] = { 10, 10 };
+  to.moduleNotes.notes.clear();
+  to.moduleTags.tags["CreateMatrix:1"] = 2;
+  to.disabledComponents.disabledModules.push_back("CreateMatrix:1");
+
+  auto forward = diffNetworkFiles(from, to);
+  auto backward = diffNetworkFiles(to, from);
+  EXPECT_EQ(1, forward.modules.changed.size());
+  EXPECT_EQ(1, forward.modules.removed.size());
+  EXPECT_EQ(1, forward.addedConnections.size());
+  EXPECT_EQ(1, forward.removedConnections.size());
+
+  auto file = from;
+  applyNetworkFileDelta(file, forward);
+  EXPECT_EQ(toXml(to), toXml(file));
+  applyNetworkFileDelta(file, backward);
+  EXPECT_EQ(toXml(from), toXml(file));
+}
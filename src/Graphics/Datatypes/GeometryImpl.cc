@@ -27,9 +27,11 @@
 
 
 #include <Graphics/Datatypes/GeometryImpl.h>
+#include <cmath>
 
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Graphics::Datatypes;
 
 GeometryObjectSpire::GeometryObjectSpire(const GeometryIDGenerator& idGenerator, const std::string& tag, bool isClippable) :
@@ -39,6 +41,145 @@ isClippable_(isClippable)
 
 }
 
+namespace
+{
+  // keeps the indices of a pass within 32 bits, same limit as GlyphGeom::buildObject
+  const size_t maxVerticesPerPass = 3 << 24;
+
+  void cross(const float* a, const float* b, float* out)
+  {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+  }
+
+  void expandPass(const SpireInstancedGlyphs& glyphs, size_t firstInstance, size_t numInstances,
+    const std::string& passID, VBOList& vbos, IBOList& ibos, PassList& passes)
+  {
+    const size_t templateVertices = glyphs.numTemplateVertices();
+    const bool useNormals = glyphs.normals.size() == glyphs.points.size();
+    const std::string vboName = passID + "VBO";
+    const std::string iboName = passID + "IBO";
+
+    size_t stride = 0;
+    for (const auto& attribute : glyphs.attributes)
+      stride += attribute.sizeInBytes;
+
+    const size_t numVertices = numInstances * templateVertices;
+    std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(numVertices * stride));
+    std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(numInstances * glyphs.indices.size() * sizeof(uint32_t)));
+    auto vboBuffer = vboBufferSPtr.get();
+    auto iboBuffer = iboBufferSPtr.get();
+
+    BBox bbox;
+    for (size_t i = 0; i < numInstances; ++i)
+    {
+      const float* instance = &glyphs.instances[(firstInstance + i) * SpireInstancedGlyphs::floatsPerInstance];
+      const float* position = instance;
+      const float* frame = instance + 3;
+      const float* color = instance + 12;
+
+      // normals go through the cofactor matrix, which stays defined for flat frames
+      float cofactor[9];
+      cross(frame + 3, frame + 6, cofactor);
+      cross(frame + 6, frame, cofactor + 3);
+      cross(frame, frame + 3, cofactor + 6);
+      const float det = frame[0] * cofactor[0] + frame[1] * cofactor[1] + frame[2] * cofactor[2];
+      const float orientation = det < 0.0f ? -1.0f : 1.0f;
+
+      // flat glyphs have a single normal, which the template rim vertices lose
+      float flatNormal[3] = { 0.0f, 0.0f, 0.0f };
+      float flatLength = 0.0f;
+      for (int c = 0; c < 3; ++c)
+      {
+        const float* column = cofactor + 3 * c;
+        const float length = std::sqrt(column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+        if (length > flatLength)
+        {
+          flatLength = length;
+          for (int k = 0; k < 3; ++k)
+            flatNormal[k] = column[k] / length;
+        }
+      }
+
+      for (size_t v = 0; v < templateVertices; ++v)
+      {
+        const float* p = &glyphs.points[3 * v];
+        float point[3];
+        for (int k = 0; k < 3; ++k)
+          point[k] = position[k] + frame[k] * p[0] + frame[3 + k] * p[1] + frame[6 + k] * p[2];
+        bbox.extend(Point(point[0], point[1], point[2]));
+
+        for (const auto& attribute : glyphs.attributes)
+        {
+          if (attribute.name == "aPos")
+          {
+            for (int k = 0; k < 3; ++k)
+              vboBuffer->write(point[k]);
+          }
+          else if (attribute.name == "aNormal")
+          {
+            float normal[3] = { 0.0f, 0.0f, 0.0f };
+            if (useNormals)
+            {
+              const float* n = &glyphs.normals[3 * v];
+              for (int k = 0; k < 3; ++k)
+                normal[k] = orientation * (cofactor[k] * n[0] + cofactor[3 + k] * n[1] + cofactor[6 + k] * n[2]);
+              const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+              for (int k = 0; k < 3; ++k)
+                normal[k] = length > 1e-6f * flatLength ? normal[k] / length : flatNormal[k];
+            }
+            for (int k = 0; k < 3; ++k)
+              vboBuffer->write(normal[k]);
+          }
+          else if (attribute.name == "aColor")
+          {
+            for (int k = 0; k < 4; ++k)
+              vboBuffer->write(color[k]);
+          }
+          else if (attribute.name == "aTexCoords")
+          {
+            // color maps look up the value stored in the red channel
+            vboBuffer->write(color[0]);
+            vboBuffer->write(color[0]);
+          }
+        }
+      }
+
+      const uint32_t offset = static_cast<uint32_t>(i * templateVertices);
+      for (auto index : glyphs.indices)
+        iboBuffer->write(index + offset);
+    }
+    if (!glyphs.boundingBox.valid()) bbox.reset();
+
+    SpireVBO geomVBO(vboName, glyphs.attributes, vboBufferSPtr, numVertices, bbox, true);
+    SpireIBO geomIBO(iboName, glyphs.prim, sizeof(uint32_t), iboBufferSPtr);
+    SpireSubPass pass(passID + "Pass", vboName, iboName, glyphs.programName, glyphs.colorScheme,
+      glyphs.renderState, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, SpireText(), glyphs.texture);
+    for (const auto& uniform : glyphs.uniforms) pass.addUniform(uniform);
+
+    vbos.push_back(geomVBO);
+    ibos.push_back(geomIBO);
+    passes.push_back(pass);
+  }
+}
+
+void SCIRun::Graphics::Datatypes::expandInstancedGlyphs(const SpireInstancedGlyphs& glyphs,
+  VBOList& vbos, IBOList& ibos, PassList& passes)
+{
+  const size_t templateVertices = glyphs.numTemplateVertices();
+  if (templateVertices == 0)
+    return;
+  const size_t instancesPerPass = std::max<size_t>(1, maxVerticesPerPass / templateVertices);
+
+  int passNumber = 0;
+  for (size_t first = 0; first < glyphs.numInstances(); first += instancesPerPass)
+  {
+    const size_t count = std::min(instancesPerPass, glyphs.numInstances() - first);
+    expandPass(glyphs, first, count, glyphs.name + "_" + std::to_string(passNumber++), vbos, ibos, passes);
+  }
+}
+
 CompositeGeometryObject::~CompositeGeometryObject()
 {
 }
@@ -244,9 +244,48 @@ namespace SCIRun {
         void addUniform(const Uniform& uniform);
       };
 
+      /// Glyphs that share one template mesh. The template is tessellated once
+      /// around the origin; every instance places it with a linear frame (the
+      /// orientation and scale, or the tensor shape) plus a translation, and
+      /// carries its own color. The remaining fields describe the regular
+      /// passes that expandInstancedGlyphs() builds for renderers without an
+      /// instanced draw path.
+      struct SCISHARE SpireInstancedGlyphs
+      {
+        /// position (3), frame columns (9), color rgba (4)
+        static const size_t floatsPerInstance = 16;
+
+        SpireInstancedGlyphs() : prim(SpireIBO::PRIMITIVE::TRIANGLES), colorScheme(ColorScheme::COLOR_UNIFORM) {}
+
+        size_t numInstances() const { return instances.size() / floatsPerInstance; }
+        size_t numTemplateVertices() const { return points.size() / 3; }
+
+        std::string                           name;
+        SpireIBO::PRIMITIVE                   prim;
+        std::vector<float>                    points;  ///< template vertices, xyz
+        std::vector<float>                    normals; ///< per template vertex, or empty
+        std::vector<uint32_t>                 indices;
+        std::vector<float>                    instances;
+
+        std::vector<SpireVBO::AttributeData>  attributes;
+        std::string                           programName;
+        ColorScheme                           colorScheme;
+        RenderState                           renderState;
+        std::vector<SpireSubPass::Uniform>    uniforms;
+        SpireTexture2D                        texture;
+        Core::Geometry::BBox                  boundingBox;
+      };
+
       using VBOList = std::list<SpireVBO>;
       using IBOList = std::list<SpireIBO>;
       using PassList = std::list<SpireSubPass>;
+      using InstancedGlyphsList = std::list<SpireInstancedGlyphs>;
+
+      /// Tessellates the glyphs into regular VBO/IBO passes appended to the given
+      /// lists. The glyph set is not modified, so the geometry object it belongs
+      /// to can stay shared while a renderer expands it into lists it owns.
+      SCISHARE void expandInstancedGlyphs(const SpireInstancedGlyphs& glyphs,
+        VBOList& vbos, IBOList& ibos, PassList& passes);
 
       class SCISHARE GeometryObjectSpire : public Core::Datatypes::GeometryObject
       {
@@ -260,6 +299,8 @@ namespace SCIRun {
         IBOList& ibos() { return mIBOs; }
         const PassList& passes() const { return mPasses; }
         PassList& passes() { return mPasses; }
+        const InstancedGlyphsList& instancedGlyphs() const { return mInstancedGlyphs; }
+        InstancedGlyphsList& instancedGlyphs() { return mInstancedGlyphs; }
 
         bool isClippable() const {return isClippable_;}
 
@@ -270,6 +311,7 @@ namespace SCIRun {
         VBOList mVBOs;  ///< Array of vertex buffer objects.
         IBOList mIBOs;  ///< Array of index buffer objects.
         PassList  mPasses; /// List of passes to setup.
+        InstancedGlyphsList mInstancedGlyphs;
         bool isClippable_;
         boost::optional<std::string> mColorMap;
       };
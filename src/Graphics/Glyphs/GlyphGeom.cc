@@ -31,6 +31,7 @@
 #include <Core/Datatypes/ColorMap.h>
 #include <Core/Math/MiscMath.h>
 #include <Core/GeometryPrimitives/Transform.h>
+#include <sstream>
 
 using namespace SCIRun;
 using namespace Graphics;
@@ -111,6 +112,9 @@ void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& unique
 
   if (isTransparent) uniforms.push_back(SpireSubPass::Uniform("uTransparency", static_cast<float>(transparencyValue)));
 
+  state.set(RenderState::IS_ON, true);
+  state.set(RenderState::HAS_DATA, true);
+
   size_t pointsLeft = points_.size();
   size_t startOfPass = 0;
   int passNumber = 0;
@@ -177,8 +181,6 @@ void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& unique
     SpireVBO geomVBO(vboName, attribs, vboBufferSPtr, numVBOElements_, newBBox, true);
     SpireIBO geomIBO(iboName, primIn, sizeof(uint32_t), iboBufferSPtr);
 
-    state.set(RenderState::IS_ON, true);
-    state.set(RenderState::HAS_DATA, true);
     SpireSubPass pass(passName, vboName, iboName, shader, colorScheme, state, renderType, geomVBO, geomIBO, text, texture);
 
     for (const auto& uniform : uniforms) pass.addUniform(uniform);
@@ -187,6 +189,23 @@ void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& unique
     geom.ibos().push_back(geomIBO);
     geom.passes().push_back(pass);
   }
+
+  int instancedNumber = 0;
+  for (auto& mesh : instancedGlyphs_)
+  {
+    auto& glyphs = mesh.second;
+    glyphs.name = uniqueNodeID + "_instanced" + std::to_string(instancedNumber++);
+    glyphs.prim = primIn;
+    glyphs.attributes = attribs;
+    glyphs.programName = shader;
+    glyphs.colorScheme = colorScheme;
+    glyphs.renderState = state;
+    glyphs.uniforms = uniforms;
+    glyphs.texture = texture;
+    glyphs.boundingBox = bbox;
+    geom.instancedGlyphs().push_back(std::move(glyphs));
+  }
+  instancedGlyphs_.clear();
 }
 
 void GlyphGeom::addArrow(const Point& p1, const Point& p2, double radius, double ratio, int resolution,
@@ -295,6 +314,152 @@ void GlyphGeom::addPoint(const Point& p, const ColorRGB& color)
   generatePoint(p, color);
 }
 
+SpireInstancedGlyphs& GlyphGeom::instancedMesh(const std::string& key, const std::function<void(GlyphGeom&)>& tessellate)
+{
+  auto found = instancedGlyphs_.find(key);
+  if (found != instancedGlyphs_.end())
+    return found->second;
+
+  GlyphGeom unit;
+  tessellate(unit);
+
+  auto& glyphs = instancedGlyphs_[key];
+  glyphs.points.reserve(3 * unit.points_.size());
+  for (const auto& point : unit.points_)
+  {
+    glyphs.points.push_back(static_cast<float>(point.x()));
+    glyphs.points.push_back(static_cast<float>(point.y()));
+    glyphs.points.push_back(static_cast<float>(point.z()));
+  }
+  if (unit.normals_.size() == unit.points_.size())
+  {
+    glyphs.normals.reserve(3 * unit.normals_.size());
+    for (const auto& normal : unit.normals_)
+    {
+      glyphs.normals.push_back(static_cast<float>(normal.x()));
+      glyphs.normals.push_back(static_cast<float>(normal.y()));
+      glyphs.normals.push_back(static_cast<float>(normal.z()));
+    }
+  }
+  glyphs.indices.assign(unit.indices_.begin(), unit.indices_.end());
+  return glyphs;
+}
+
+void GlyphGeom::addInstance(SpireInstancedGlyphs& glyphs, const Point& position,
+                            const Vector& axis1, const Vector& axis2, const Vector& axis3, const ColorRGB& color)
+{
+  const double values[] = {
+    position.x(), position.y(), position.z(),
+    axis1.x(), axis1.y(), axis1.z(),
+    axis2.x(), axis2.y(), axis2.z(),
+    axis3.x(), axis3.y(), axis3.z(),
+    color.r(), color.g(), color.b(), color.a() };
+  for (auto value : values)
+    glyphs.instances.push_back(static_cast<float>(value));
+}
+
+// Template meshes of axial glyphs run from the origin to (0, 0, 1) with unit radius.
+// The generators start their rim at an axis dependent tangent, so the frame maps the
+// template's (u, crx, n) basis onto the one generateCylinder/generateCone pick for p1, p2.
+void GlyphGeom::addAxialInstance(SpireInstancedGlyphs& glyphs, const Point& p1, const Point& p2,
+                                 double radius, const ColorRGB& color)
+{
+  static const Vector templateN(0, 0, -1);
+  static const Vector templateCrx = templateN.getArbitraryTangent();
+  static const Vector templateU = Cross(templateCrx, templateN).normal();
+
+  const double length = (p2 - p1).length();
+  Vector n = length > 0 ? (p1 - p2).normal() : templateN;
+  Vector crx = n.getArbitraryTangent();
+  Vector u = Cross(crx, n).normal();
+
+  Vector columns[3];
+  for (int j = 0; j < 3; ++j)
+    columns[j] = radius * templateU[j] * u + radius * templateCrx[j] * crx + length * templateN[j] * n;
+  addInstance(glyphs, p1, columns[0], columns[1], columns[2], color);
+}
+
+void GlyphGeom::addArrowInstance(const Point& p1, const Point& p2, double radius, double ratio, int resolution,
+                                 const ColorRGB& color, bool render_cylinder_base, bool render_cone_base)
+{
+  std::ostringstream key;
+  key << "arrow" << resolution << "_" << ratio << "_" << render_cylinder_base << render_cone_base;
+  auto& glyphs = instancedMesh(key.str(), [&](GlyphGeom& unit)
+  {
+    unit.addArrow(Point(0, 0, 0), Point(0, 0, 1), 1.0, ratio, resolution, ColorRGB(), ColorRGB(),
+                  render_cylinder_base, render_cone_base);
+  });
+  addAxialInstance(glyphs, p1, p2, radius, color);
+}
+
+void GlyphGeom::addConeInstance(const Point& p1, const Point& p2, double radius, int resolution,
+                                bool renderBase, const ColorRGB& color)
+{
+  std::ostringstream key;
+  key << "cone" << resolution << "_" << renderBase;
+  auto& glyphs = instancedMesh(key.str(), [&](GlyphGeom& unit)
+  {
+    unit.generateCone(Point(0, 0, 0), Point(0, 0, 1), 1.0, resolution, renderBase, ColorRGB(), ColorRGB());
+  });
+  addAxialInstance(glyphs, p1, p2, radius, color);
+}
+
+void GlyphGeom::addDiskInstance(const Point& p1, const Point& p2, double radius, int resolution, const ColorRGB& color)
+{
+  auto& glyphs = instancedMesh("disk" + std::to_string(resolution), [&](GlyphGeom& unit)
+  {
+    unit.generateCylinder(Point(0, 0, 0), Point(0, 0, 1), 1.0, 1.0, resolution, ColorRGB(), ColorRGB(), true, true);
+  });
+  addAxialInstance(glyphs, p1, p2, radius, color);
+}
+
+void GlyphGeom::addSphereInstance(const Point& p, double radius, int resolution, const ColorRGB& color)
+{
+  auto& glyphs = instancedMesh("sphere" + std::to_string(resolution), [&](GlyphGeom& unit)
+  {
+    unit.generateSphere(Point(0, 0, 0), 1.0, resolution, ColorRGB());
+  });
+  double r = radius < 0 ? 1.0 : radius;
+  addInstance(glyphs, p, Vector(r, 0, 0), Vector(0, r, 0), Vector(0, 0, r), color);
+}
+
+void GlyphGeom::addBoxInstance(const Point& center, Tensor& t, double scale, const ColorRGB& color, bool normalize)
+{
+  auto& glyphs = instancedMesh("box", [](GlyphGeom& unit)
+  {
+    std::vector<Vector> box_points = generateBoxPoints(Transform(), Vector(1, 1, 1));
+    ColorRGB white;
+    unit.generateBoxSide(box_points[5], box_points[4], box_points[7], box_points[6], Vector(1, 0, 0), white);
+    unit.generateBoxSide(box_points[7], box_points[6], box_points[3], box_points[2], Vector(0, 1, 0), white);
+    unit.generateBoxSide(box_points[1], box_points[5], box_points[3], box_points[7], Vector(0, 0, 1), white);
+    unit.generateBoxSide(box_points[3], box_points[2], box_points[1], box_points[0], Vector(-1, 0, 0), white);
+    unit.generateBoxSide(box_points[1], box_points[0], box_points[5], box_points[4], Vector(0, -1, 0), white);
+    unit.generateBoxSide(box_points[2], box_points[6], box_points[0], box_points[4], Vector(0, 0, -1), white);
+  });
+
+  std::vector<Vector> eigvectors;
+  Vector eigvals;
+  int zeroAxis;
+  getTensorAxes(t, scale, normalize, eigvectors, eigvals, zeroAxis);
+  addInstance(glyphs, center, eigvals[0] * eigvectors[0], eigvals[1] * eigvectors[1], eigvals[2] * eigvectors[2], color);
+}
+
+void GlyphGeom::addEllipsoidInstance(const Point& center, Tensor& t, double scale, int resolution,
+                                     const ColorRGB& color, bool normalize)
+{
+  auto& glyphs = instancedMesh("ellipsoid" + std::to_string(resolution), [&](GlyphGeom& unit)
+  {
+    Tensor identity(Vector(1, 0, 0), Vector(0, 1, 0), Vector(0, 0, 1));
+    unit.generateEllipsoid(Point(0, 0, 0), identity, 1.0, resolution, ColorRGB(), false, false);
+  });
+
+  std::vector<Vector> eigvectors;
+  Vector eigvals;
+  int zeroAxis;
+  getTensorAxes(t, scale, normalize, eigvectors, eigvals, zeroAxis);
+  addInstance(glyphs, center, eigvals[0] * eigvectors[0], eigvals[1] * eigvectors[1], eigvals[2] * eigvectors[2], color);
+}
+
 void GlyphGeom::generateCylinder(const Point& p1, const Point& p2, double radius1,
                                  double radius2, int resolution, const ColorRGB& color1,
                                  const ColorRGB& color2)
@@ -733,36 +898,19 @@ void reorderTensor(std::vector<Vector>& eigvectors, Vector& eigvals)
   }
 }
 
-std::vector<Vector> GlyphGeom::generateBoxPoints(const Transform& trans, const Vector& eigvals)
-{
-  std::vector<Vector> box_points;
-  for(int x : {-1, 1})
-    {
-      for(int y : {-1, 1})
-        {
-          for(int z : {-1, 1})
-            {
-              box_points.emplace_back(trans * Point(x * eigvals.x(), y * eigvals.y(), z * eigvals.z()));
-            }
-        }
-    }
-  return box_points;
-}
-
-void GlyphGeom::generateBox(const Point& center, Tensor& t, double scale, ColorRGB& node_color, bool normalize)
+bool GlyphGeom::getTensorAxes(Tensor& t, double scale, bool normalize, std::vector<Vector>& eigvectors, Vector& eigvals, int& zeroAxis)
 {
   static const double zeroThreshold = 0.000001;
+  eigvectors.resize(3);
+  t.get_eigenvectors(eigvectors[0], eigvectors[1], eigvectors[2]);
+
   double eigval1, eigval2, eigval3;
   t.get_eigenvalues(eigval1, eigval2, eigval3);
-
-  Vector eigvals(abs(eigval1), abs(eigval2), abs(eigval3));
+  eigvals = Vector(fabs(eigval1), fabs(eigval2), fabs(eigval3));
   if(normalize)
     eigvals.normalize();
   eigvals *= scale;
 
-  std::vector<Vector> eigvectors(3);
-  t.get_eigenvectors(eigvectors[0], eigvectors[1], eigvectors[2]);
-
   // Checks to see if eigenvalues are close to 0
   bool eig_x_0 = eigvals.x() <= zeroThreshold;
   bool eig_y_0 = eigvals.y() <= zeroThreshold;
@@ -773,6 +921,7 @@ void GlyphGeom::generateBox(const Point& center, Tensor& t, double scale, ColorR
   eigvals[1] = (!eig_y_0) * eigvals[1];
   eigvals[2] = (!eig_z_0) * eigvals[2];
 
+  zeroAxis = -1;
   bool flatTensor = (eig_x_0 + eig_y_0 + eig_z_0) >= 1;
   if(flatTensor)
   {
@@ -781,20 +930,48 @@ void GlyphGeom::generateBox(const Point& center, Tensor& t, double scale, ColorR
     eig_x_0 = eigvals.x() <= zeroThreshold;
     eig_y_0 = eigvals.y() <= zeroThreshold;
     eig_z_0 = eigvals.z() <= zeroThreshold;
-    // Check for zero eigenvectors
+    // Replace the eigenvector of the zero eigenvalue by the normal of the flat glyph
     if(eig_x_0)
     {
+      zeroAxis = 0;
       eigvectors[0] = Cross(eigvectors[1], eigvectors[2]);
     }
     else if(eig_y_0)
     {
+      zeroAxis = 1;
       eigvectors[1] = Cross(eigvectors[0], eigvectors[2]);
     }
     else if(eig_z_0)
     {
+      zeroAxis = 2;
       eigvectors[2] = Cross(eigvectors[0], eigvectors[1]);
     }
   }
+  return flatTensor;
+}
+
+std::vector<Vector> GlyphGeom::generateBoxPoints(const Transform& trans, const Vector& eigvals)
+{
+  std::vector<Vector> box_points;
+  for(int x : {-1, 1})
+    {
+      for(int y : {-1, 1})
+        {
+          for(int z : {-1, 1})
+            {
+              box_points.emplace_back(trans * Point(x * eigvals.x(), y * eigvals.y(), z * eigvals.z()));
+            }
+        }
+    }
+  return box_points;
+}
+
+void GlyphGeom::generateBox(const Point& center, Tensor& t, double scale, ColorRGB& node_color, bool normalize)
+{
+  std::vector<Vector> eigvectors;
+  Vector eigvals;
+  int zeroAxis;
+  getTensorAxes(t, scale, normalize, eigvectors, eigvals, zeroAxis);
 
   Transform trans, rotate;
   generateTransforms(center, eigvectors[0], eigvectors[1], eigvectors[2], trans, rotate);
@@ -836,54 +1013,13 @@ void GlyphGeom::generateBoxSide(const Vector& p1, const Vector& p2, const Vector
 
 void GlyphGeom::generateEllipsoid(const Point& center, Tensor& t, double scale, int resolution, const ColorRGB& color, bool half, bool normalize)
 {
-  static const double zeroThreshold = 0.000001;
-  std::vector<Vector> eigvectors(3);
-  t.get_eigenvectors(eigvectors[0], eigvectors[1], eigvectors[2]);
-
-  double eigval1, eigval2, eigval3;
-  t.get_eigenvalues(eigval1, eigval2, eigval3);
-  Vector eigvals = Vector(fabs(eigval1), fabs(eigval2), fabs(eigval3));
-  if(normalize)
-    eigvals.normalize();
-  eigvals *= scale;
-
-  // Checks to see if eigenvalues are close to 0
-  bool eig_x_0 = eigvals.x() <= zeroThreshold;
-  bool eig_y_0 = eigvals.y() <= zeroThreshold;
-  bool eig_z_0 = eigvals.z() <= zeroThreshold;
-
-  // Set to 0 if below threshold
-  eigvals[0] = (!eig_x_0) * eigvals[0];
-  eigvals[1] = (!eig_y_0) * eigvals[1];
-  eigvals[2] = (!eig_z_0) * eigvals[2];
-
-  bool flatTensor = (eig_x_0 + eig_y_0 + eig_z_0) >= 1;
+  std::vector<Vector> eigvectors;
+  Vector eigvals;
+  int zeroAxis;
+  bool flatTensor = getTensorAxes(t, scale, normalize, eigvectors, eigvals, zeroAxis);
   Vector zero_norm;
-
-  if(flatTensor)
-  {
-    reorderTensor(eigvectors, eigvals);
-
-    eig_x_0 = eigvals.x() <= zeroThreshold;
-    eig_y_0 = eigvals.y() <= zeroThreshold;
-    eig_z_0 = eigvals.z() <= zeroThreshold;
-    // Check for zero eigenvectors
-    if(eig_x_0)
-    {
-      zero_norm = Cross(eigvectors[1], eigvectors[2]);
-      eigvectors[0] = zero_norm;
-    }
-    else if(eig_y_0)
-    {
-      zero_norm = Cross(eigvectors[0], eigvectors[2]);
-      eigvectors[1] = zero_norm;
-    }
-    else if(eig_z_0)
-    {
-      zero_norm = Cross(eigvectors[0], eigvectors[1]);
-      eigvectors[2] = zero_norm;
-    }
-  }
+  if (zeroAxis >= 0)
+    zero_norm = eigvectors[zeroAxis];
 
   Transform trans, rotate;
   generateTransforms(center, eigvectors[0], eigvectors[1], eigvectors[2], trans, rotate);
@@ -36,6 +36,8 @@
 #include <Graphics/Datatypes/GeometryImpl.h>
 #include <Core/Datatypes/Color.h>
 #include <Eigen/Dense>
+#include <functional>
+#include <map>
 
 #include <Graphics/Glyphs/share.h>
 
@@ -89,6 +91,20 @@ namespace SCIRun {
         const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2);
       void addPoint(const Core::Geometry::Point& p, const Core::Datatypes::ColorRGB& color);
 
+      // Instanced versions of the glyphs above: the mesh is tessellated once per
+      // glyph type and resolution, each glyph only stores its position, frame and
+      // color. buildObject hands them on as SpireInstancedGlyphs.
+      void addArrowInstance(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2, double radius, double ratio, int resolution,
+                            const Core::Datatypes::ColorRGB& color, bool render_cylinder_base, bool render_cone_base);
+      void addConeInstance(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2, double radius, int resolution,
+                           bool renderBase, const Core::Datatypes::ColorRGB& color);
+      void addDiskInstance(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2, double radius, int resolution,
+                           const Core::Datatypes::ColorRGB& color);
+      void addSphereInstance(const Core::Geometry::Point& p, double radius, int resolution, const Core::Datatypes::ColorRGB& color);
+      void addBoxInstance(const Core::Geometry::Point& center, Core::Geometry::Tensor& t, double scale, const Core::Datatypes::ColorRGB& color, bool normalize);
+      void addEllipsoidInstance(const Core::Geometry::Point& center, Core::Geometry::Tensor& t, double scale, int resolution,
+                                const Core::Datatypes::ColorRGB& color, bool normalize);
+
       //From SCIRun4
       void addArrow(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double radius, double length, int nu = 20, int nv = 0);
       void addBox(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double x_side, double y_side, double z_side);
@@ -105,6 +121,16 @@ namespace SCIRun {
       std::vector<size_t> indices_;
       size_t numVBOElements_;
       size_t lineIndex_;
+      std::map<std::string, Datatypes::SpireInstancedGlyphs> instancedGlyphs_;
+
+      Datatypes::SpireInstancedGlyphs& instancedMesh(const std::string& key, const std::function<void(GlyphGeom&)>& tessellate);
+      static void addInstance(Datatypes::SpireInstancedGlyphs& glyphs, const Core::Geometry::Point& position,
+                              const Core::Geometry::Vector& axis1, const Core::Geometry::Vector& axis2,
+                              const Core::Geometry::Vector& axis3, const Core::Datatypes::ColorRGB& color);
+      void addAxialInstance(Datatypes::SpireInstancedGlyphs& glyphs, const Core::Geometry::Point& p1, const Core::Geometry::Point& p2,
+                            double radius, const Core::Datatypes::ColorRGB& color);
+      static bool getTensorAxes(Core::Geometry::Tensor& t, double scale, bool normalize,
+                                std::vector<Core::Geometry::Vector>& eigvectors, Core::Geometry::Vector& eigvals, int& zeroAxis);
 
       void generateCylinder(const  Core::Geometry::Point& p1, const  Core::Geometry::Point& p2, double radius1, double radius2, int resolution, const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2);
       void generateSphere(const Core::Geometry::Point& center, double radius, int resolution, const Core::Datatypes::ColorRGB& color);
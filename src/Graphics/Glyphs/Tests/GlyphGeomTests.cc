@@ -0,0 +1,249 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Graphics/Glyphs/GlyphGeom.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <functional>
+
+using namespace SCIRun;
+using namespace SCIRun::Graphics;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  class StubGeometryIDGenerator : public Core::GeometryIDGenerator
+  {
+  public:
+    std::string generateGeometryID(const std::string& tag) const override { return tag; }
+  };
+
+  // Position, normal and rgba color per vertex, as GlyphGeom::buildObject writes them
+  // with normals and in-situ colors.
+  const size_t floatsPerVertex = 10;
+
+  struct Buffers
+  {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+  };
+
+  Buffers build(const std::function<void(GlyphGeom&)>& addGlyphs)
+  {
+    StubGeometryIDGenerator idGen;
+    GeometryObjectSpire geom(idGen, "glyphs", true);
+    GlyphGeom glyphs;
+    addGlyphs(glyphs);
+    glyphs.buildObject(geom, "glyphs", false, 1.0, ColorScheme::COLOR_IN_SITU, RenderState(),
+      SpireIBO::PRIMITIVE::TRIANGLES, BBox(Point(0, 0, 0), Point(1, 1, 1)));
+    auto vbos = geom.vbos();
+    auto ibos = geom.ibos();
+    auto passes = geom.passes();
+    for (const auto& instanced : geom.instancedGlyphs())
+      expandInstancedGlyphs(instanced, vbos, ibos, passes);
+
+    Buffers result;
+    for (const auto& vbo : vbos)
+    {
+      auto data = reinterpret_cast<const float*>(vbo.data->getBuffer());
+      result.vertices.insert(result.vertices.end(), data, data + vbo.data->getBufferSize() / sizeof(float));
+    }
+    for (const auto& ibo : ibos)
+    {
+      auto data = reinterpret_cast<const uint32_t*>(ibo.data->getBuffer());
+      result.indices.insert(result.indices.end(), data, data + ibo.data->getBufferSize() / sizeof(uint32_t));
+    }
+    return result;
+  }
+
+  // Flat glyphs point their single normal either way, so only its direction is compared.
+  void expectSameGlyphs(const Buffers& expanded, const Buffers& instanced, bool flat = false)
+  {
+    ASSERT_EQ(expanded.indices, instanced.indices);
+    ASSERT_EQ(expanded.vertices.size(), instanced.vertices.size());
+    ASSERT_EQ(0, expanded.vertices.size() % floatsPerVertex);
+
+    for (size_t v = 0; v < expanded.vertices.size(); v += floatsPerVertex)
+    {
+      const float* a = &expanded.vertices[v];
+      const float* b = &instanced.vertices[v];
+      for (int k = 0; k < 3; ++k)
+        ASSERT_NEAR(a[k], b[k], 1e-4) << "position of vertex " << v / floatsPerVertex;
+
+      const float dot = a[3] * b[3] + a[4] * b[4] + a[5] * b[5];
+      ASSERT_NEAR(1, flat ? std::abs(dot) : dot, 1e-4) << "normal of vertex " << v / floatsPerVertex;
+
+      for (int k = 6; k < 10; ++k)
+        ASSERT_EQ(a[k], b[k]) << "color of vertex " << v / floatsPerVertex;
+    }
+  }
+
+  const ColorRGB color(0.2, 0.4, 0.6);
+  const Point positions[] = { { 0, 0, 0 }, { 1, -2, 3 }, { -4.5, 0.25, 7 } };
+  const Vector directions[] = { { 0, 0, 1 }, { 1, 1, 0 }, { -0.3, 2, -1.5 } };
+}
+
+TEST(GlyphGeomTests, InstancedArrowsMatchExpandedArrows)
+{
+  auto expanded = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addArrow(positions[i], positions[i] + directions[i], 0.1, 0.7, 10, color, color, true, true);
+  });
+  auto instanced = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addArrowInstance(positions[i], positions[i] + directions[i], 0.1, 0.7, 10, color, true, true);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedConesMatchExpandedCones)
+{
+  auto expanded = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addCone(positions[i], positions[i] + directions[i], 0.2, 8, true, color, color);
+  });
+  auto instanced = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addConeInstance(positions[i], positions[i] + directions[i], 0.2, 8, true, color);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedDisksMatchExpandedDisks)
+{
+  auto expanded = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addDisk(positions[i], positions[i] + 0.05 * directions[i], 0.3, 12, color, color);
+  });
+  auto instanced = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addDiskInstance(positions[i], positions[i] + 0.05 * directions[i], 0.3, 12, color);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedSpheresMatchExpandedSpheres)
+{
+  auto expanded = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addSphere(positions[i], 0.5 * (i + 1), 6, color);
+  });
+  auto instanced = build([](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addSphereInstance(positions[i], 0.5 * (i + 1), 6, color);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedBoxesMatchExpandedBoxes)
+{
+  Tensor t;
+  t.set_outside_eigens(Vector(0, 0.6, 0.8), Vector(0, -0.8, 0.6), Vector(1, 0, 0), 2, 0.5, 1);
+  auto expanded = build([&](GlyphGeom& glyphs)
+  {
+    ColorRGB boxColor(color);
+    for (int i = 0; i < 3; ++i)
+      glyphs.addBox(positions[i], t, 1.5, boxColor, false);
+  });
+  auto instanced = build([&](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addBoxInstance(positions[i], t, 1.5, color, false);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedEllipsoidsMatchExpandedEllipsoids)
+{
+  Tensor t;
+  t.set_outside_eigens(Vector(0, 0.6, 0.8), Vector(0, -0.8, 0.6), Vector(1, 0, 0), 2, 0.5, 1);
+  auto expanded = build([&](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addEllipsoid(positions[i], t, 1.5, 6, color, false);
+  });
+  auto instanced = build([&](GlyphGeom& glyphs)
+  {
+    for (int i = 0; i < 3; ++i)
+      glyphs.addEllipsoidInstance(positions[i], t, 1.5, 6, color, false);
+  });
+  expectSameGlyphs(expanded, instanced);
+}
+
+TEST(GlyphGeomTests, InstancedFlatEllipsoidsMatchExpandedEllipsoids)
+{
+  Tensor t;
+  t.set_outside_eigens(Vector(1, 0, 0), Vector(0, 1, 0), Vector(0, 0, 1), 2, 0.5, 0);
+  auto expanded = build([&](GlyphGeom& glyphs)
+  {
+    glyphs.addEllipsoid(positions[1], t, 1.5, 6, color, false);
+  });
+  auto instanced = build([&](GlyphGeom& glyphs)
+  {
+    glyphs.addEllipsoidInstance(positions[1], t, 1.5, 6, color, false);
+  });
+  expectSameGlyphs(expanded, instanced, true);
+}
+
+TEST(GlyphGeomTests, InstancesOfOneKindShareATemplate)
+{
+  StubGeometryIDGenerator idGen;
+  GeometryObjectSpire geom(idGen, "glyphs", true);
+  GlyphGeom glyphs;
+  for (int i = 0; i < 100; ++i)
+    glyphs.addSphereInstance(Point(i, 0, 0), 0.5, 6, color);
+  glyphs.addSphereInstance(Point(0, 0, 0), 0.5, 8, color);
+  glyphs.buildObject(geom, "glyphs", false, 1.0, ColorScheme::COLOR_IN_SITU, RenderState(),
+    SpireIBO::PRIMITIVE::TRIANGLES, BBox(Point(0, 0, 0), Point(1, 1, 1)));
+
+  ASSERT_EQ(2, geom.instancedGlyphs().size());
+  EXPECT_EQ(100, geom.instancedGlyphs().front().numInstances());
+  EXPECT_EQ(1, geom.instancedGlyphs().back().numInstances());
+  EXPECT_TRUE(geom.vbos().empty());
+
+  VBOList vbos;
+  IBOList ibos;
+  PassList passes;
+  for (const auto& instanced : geom.instancedGlyphs())
+    expandInstancedGlyphs(instanced, vbos, ibos, passes);
+  EXPECT_EQ(2, vbos.size());
+  EXPECT_EQ(2, passes.size());
+  EXPECT_TRUE(geom.vbos().empty());
+  EXPECT_EQ(100, geom.instancedGlyphs().front().numInstances());
+}
@@ -148,6 +148,7 @@ ModuleProxyWidget::~ModuleProxyWidget()
 #ifdef MODULE_POSITION_LOGGING
   qDebug() << "~dtor" << __FILE__ << __LINE__ << pos() << scenePos();
 #endif
+  Q_EMIT widgetDeleted(ModuleId(module_->getModuleId()), pos().x(), pos().y());
 }
 
 void ModuleProxyWidget::showAndColor(const QColor& color)
@@ -430,7 +431,7 @@ void ModuleProxyWidget::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
     if (position_ != pos())
     {
       snapToGrid();
-      Q_EMIT widgetMoved(ModuleId(module_->getModuleId()), pos().x(), pos().y());
+      Q_EMIT widgetMoved(ModuleId(module_->getModuleId()), position_.x(), position_.y(), pos().x(), pos().y());
     }
     QGraphicsItem::mouseReleaseEvent(event);
   }
@@ -69,7 +69,9 @@ namespace SCIRun
 
     Q_SIGNALS:
       void selected();
-      void widgetMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double newX, double newY);
+      void widgetMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double oldX, double oldY, double newX, double newY);
+      /// emitted while the module widget still exists, so its position is known
+      void widgetDeleted(const SCIRun::Dataflow::Networks::ModuleId& id, double x, double y);
       void tagChanged(int tag);
     protected:
       void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
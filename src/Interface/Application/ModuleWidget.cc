@@ -1122,6 +1122,11 @@ void ModuleWidget::updateBackgroundColorForModuleState(int moduleState)
     Q_EMIT backgroundColorUpdated(defaultBackgroundColor_);
   }
   break;
+  case static_cast<int>(ModuleExecutionState::Errored):
+  {
+    Q_EMIT backgroundColorUpdated(colorStateLookup.right.at(static_cast<int>(ModuleExecutionState::Errored)));
+  }
+  break;
   }
 }
 
@@ -41,6 +41,7 @@
 #include <Interface/Application/NetworkEditorControllerGuiProxy.h>
 #include <Interface/Application/ClosestPortFinder.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h> //TODO: remove
 #include <Dataflow/Network/Module.h> //TODO: remove
 #include <Core/Application/Preferences/Preferences.h>
@@ -98,7 +99,7 @@ NetworkEditor::NetworkEditor(const NetworkEditorParameters& params, QWidget* par
   NetworkEditorPythonAPI::setExecutionContext(this);
 #endif
 
-  connect(this, SIGNAL(moduleMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double)), this, SLOT(redrawTagGroups()));
+  connect(this, SIGNAL(moduleMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double, double, double)), this, SLOT(redrawTagGroups()));
 
   setObjectName(QString::fromUtf8("networkEditor_"));
   setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
@@ -481,8 +482,9 @@ ModuleProxyWidget* NetworkEditor::setupModuleWidget(ModuleWidget* module)
 
   connect(scene_, SIGNAL(selectionChanged()), proxy, SLOT(highlightIfSelected()));
   connect(proxy, SIGNAL(selected()), this, SLOT(bringToFront()));
-  connect(proxy, SIGNAL(widgetMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double)), this, SIGNAL(modified()));
-  connect(proxy, SIGNAL(widgetMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double)), this, SIGNAL(moduleMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double)));
+  connect(proxy, SIGNAL(widgetMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double, double, double)), this, SIGNAL(modified()));
+  connect(proxy, SIGNAL(widgetMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double, double, double)), this, SIGNAL(moduleMoved(const SCIRun::Dataflow::Networks::ModuleId&, double, double, double, double))));
+  connect(proxy, SIGNAL(widgetDeleted(const SCIRun::Dataflow::Networks::ModuleId&, double, double)), this, SIGNAL(moduleDeleted(const SCIRun::Dataflow::Networks::ModuleId&, double, double)));
   connect(this, SIGNAL(snapToModules()), proxy, SLOT(snapToGrid()));
   connect(this, SIGNAL(highlightPorts(int)), proxy, SLOT(highlightPorts(int)));
   connect(this, SIGNAL(resetModulesDueToCycle()), module, SLOT(changeExecuteButtonToPlay()));
@@ -1603,6 +1605,46 @@ void NetworkEditor::loadNetwork(const NetworkFileHandle& xml)
 #endif
 }
 
+bool NetworkEditor::updateNetwork(const NetworkFileHandle& current, const NetworkFileHandle& target)
+{
+  if (!current || !target)
+    return false;
+
+  // only module moves are applied in place; anything structural reloads
+  auto delta = diffNetworkFiles(*current, *target);
+  if (!delta.onlyModulePositions() || !delta.modulePositions.removed.empty())
+    return false;
+
+  ModulePositions moved;
+  moved.modulePositions = delta.modulePositions.changed;
+  updateModulePositions(moved, false);
+  return true;
+}
+
+bool NetworkEditor::applyDelta(const NetworkFileDelta& delta)
+{
+  if (!delta.onlyStructure())
+    return false;
+
+  // the controller does not remove the lines of connections it drops, but
+  // deleting a line drops its connection
+  for (const auto& cd : delta.removedConnections)
+  {
+    auto id = ConnectionId::create(cd);
+    Q_FOREACH(QGraphicsItem* item, scene_->items())
+    {
+      auto line = dynamic_cast<ConnectionLine*>(item);
+      if (line && line->id().id_ == id.id_)
+      {
+        scene_->removeItem(line);
+        delete line;
+        break;
+      }
+    }
+  }
+  return controller_->applyDelta(delta);
+}
+
 void NetworkEditor::deselectAll()
 {
   Q_FOREACH(QGraphicsItem* item, scene_->items())
@@ -224,6 +224,8 @@ namespace Gui {
 
     Dataflow::Networks::NetworkFileHandle saveNetwork() const override;
     void loadNetwork(const Dataflow::Networks::NetworkFileHandle& file) override;
+    bool updateNetwork(const Dataflow::Networks::NetworkFileHandle& current, const Dataflow::Networks::NetworkFileHandle& target) override;
+    bool applyDelta(const Dataflow::Networks::NetworkFileDelta& delta) override;
     void appendToNetwork(const Dataflow::Networks::NetworkFileHandle& xml);
 
     Dataflow::Networks::ModulePositionsHandle dumpModulePositions(Dataflow::Networks::ModuleFilter filter) const override;
@@ -372,7 +374,8 @@ namespace Gui {
     void networkExecutionFinished();
     void networkEditorMouseButtonPressed();
     void middleMouseClicked();
-    void moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double newX, double newY);
+    void moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double oldX, double oldY, double newX, double newY);
+    void moduleDeleted(const SCIRun::Dataflow::Networks::ModuleId& id, double x, double y);
     void defaultNotePositionChanged(NotePosition position);
     void defaultNoteSizeChanged(int size);
     void snapToModules();
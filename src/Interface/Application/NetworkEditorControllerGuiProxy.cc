@@ -110,6 +110,11 @@ void NetworkEditorControllerGuiProxy::loadNetwork(const NetworkFileHandle& xml)
   controller_->loadNetwork(xml);
 }
 
+bool NetworkEditorControllerGuiProxy::applyDelta(const NetworkFileDelta& delta)
+{
+  return controller_->applyDelta(delta);
+}
+
 void NetworkEditorControllerGuiProxy::appendToNetwork(const NetworkFileHandle& xml)
 {
   controller_->appendToNetwork(xml);
@@ -70,6 +70,7 @@ namespace Gui {
     void setExecutorType(int type);
     void cleanUpNetwork();
   public:
+    bool applyDelta(const SCIRun::Dataflow::Networks::NetworkFileDelta& delta);
     const SCIRun::Dataflow::Networks::ModuleDescriptionMap& getAllAvailableModuleDescriptions() const;
     SCIRun::Dataflow::Networks::NetworkGlobalSettings& getSettings();
     boost::shared_ptr<SCIRun::Dataflow::Engine::DisableDynamicPortSwitch> createDynamicPortSwitch();
@@ -31,6 +31,7 @@
 #include <Dataflow/Engine/Controller/ProvenanceManager.h>
 #include <Interface/Application/ProvenanceWindow.h>
 #include <Interface/Application/NetworkEditor.h>
+#include <Dataflow/Network/ModuleInterface.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
 
@@ -72,10 +73,8 @@ void ProvenanceWindow::showFile(SCIRun::Dataflow::Networks::NetworkFileHandle fi
   provenanceManager_->setInitialState(file);
 }
 
-//TODO:
-/*
-Key thing: when undoing/redoing, since we're loading from scratch, need to scoped-switch off the signals for provenance window.
-*/
+// Undo and redo edit the network in place and still fire the controller's
+// signals, so the converter ignores them while modifyingNetwork is set.
 
 class ProvenanceWindowListItem : public QListWidgetItem
 {
@@ -84,15 +83,6 @@ public:
     QListWidgetItem(QString::fromStdString(info->name()), parent),
     info_(info)
   {
-    auto xml = info_->memento();
-    if (xml)
-    {
-      std::ostringstream ostr;
-      XMLSerializer::save_xml(*xml, ostr, "networkFile");
-      xmlText_ = QString::fromStdString(ostr.str());
-    }
-    else
-      xmlText_ = "<Unknown state for this item>";
   }
   void setAsUndo()
   {
@@ -108,9 +98,16 @@ public:
     setFont(f);
     setBackground(Qt::lightGray);
   }
+  // generated on demand, items only keep a difference to their neighbor
   QString xmlText() const
   {
-    return xmlText_;
+    auto xml = info_->memento();
+    if (!xml)
+      return "<Unknown state for this item>";
+
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(*xml, ostr, "networkFile");
+    return QString::fromStdString(ostr.str());
   }
   std::string name() const
   {
@@ -118,7 +115,6 @@ public:
   }
 private:
   ProvenanceItemHandle info_;
-  QString xmlText_;
 };
 
 void ProvenanceWindow::addProvenanceItem(ProvenanceItemHandle item)
@@ -290,27 +286,48 @@ GuiActionProvenanceConverter::GuiActionProvenanceConverter(NetworkEditor* editor
 
 void GuiActionProvenanceConverter::moduleAdded(const std::string& name, SCIRun::Dataflow::Networks::ModuleHandle module)
 {
+  modules_[module->id().id_] = module;
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(boost::make_shared<ModuleAddedProvenanceItem>(name, editor_->saveNetwork()));
+    ProvenanceItemHandle item(boost::make_shared<ModuleAddedProvenanceItem>(name, module));
     Q_EMIT provenanceItemCreated(item);
   }
 }
 
+void GuiActionProvenanceConverter::moduleDeleted(const ModuleId& id, double x, double y)
+{
+  deletedPositions_[id.id_] = std::make_pair(x, y);
+}
+
 void GuiActionProvenanceConverter::moduleRemoved(const ModuleId& id)
 {
+  auto module = modules_.find(id.id_);
+  auto position = deletedPositions_.find(id.id_);
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(boost::make_shared<ModuleRemovedProvenanceItem>(id, editor_->saveNetwork()));
+    ProvenanceItemHandle item;
+    if (module != modules_.end())
+    {
+      boost::optional<std::pair<double, double>> where;
+      if (position != deletedPositions_.end())
+        where = position->second;
+      item = boost::make_shared<ModuleRemovedProvenanceItem>(module->second, where);
+    }
+    else
+      item = boost::make_shared<ModuleRemovedProvenanceItem>(id, editor_->saveNetwork());
     Q_EMIT provenanceItemCreated(item);
   }
+  if (module != modules_.end())
+    modules_.erase(module);
+  if (position != deletedPositions_.end())
+    deletedPositions_.erase(position);
 }
 
 void GuiActionProvenanceConverter::connectionAdded(const SCIRun::Dataflow::Networks::ConnectionDescription& cd)
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(boost::make_shared<ConnectionAddedProvenanceItem>(cd, editor_->saveNetwork()));
+    ProvenanceItemHandle item(boost::make_shared<ConnectionAddedProvenanceItem>(cd));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -319,16 +336,16 @@ void GuiActionProvenanceConverter::connectionRemoved(const SCIRun::Dataflow::Net
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(boost::make_shared<ConnectionRemovedProvenanceItem>(id, editor_->saveNetwork()));
+    ProvenanceItemHandle item(boost::make_shared<ConnectionRemovedProvenanceItem>(id));
     Q_EMIT provenanceItemCreated(item);
   }
 }
 
-void GuiActionProvenanceConverter::moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double newX, double newY)
+void GuiActionProvenanceConverter::moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double oldX, double oldY, double newX, double newY)
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(boost::make_shared<ModuleMovedProvenanceItem>(id, newX, newY, editor_->saveNetwork()));
+    ProvenanceItemHandle item(boost::make_shared<ModuleMovedProvenanceItem>(id, newX, newY, std::make_pair(oldX, oldY)));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -86,13 +86,18 @@ public Q_SLOTS:
   void moduleRemoved(const SCIRun::Dataflow::Networks::ModuleId& id);
   void connectionAdded(const SCIRun::Dataflow::Networks::ConnectionDescription&);
   void connectionRemoved(const SCIRun::Dataflow::Networks::ConnectionId& id);
-  void moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double newX, double newY);
+  void moduleMoved(const SCIRun::Dataflow::Networks::ModuleId& id, double oldX, double oldY, double newX, double newY);
+  void moduleDeleted(const SCIRun::Dataflow::Networks::ModuleId& id, double x, double y);
   void networkBeingModifiedByProvenanceManager(bool inProgress);
 Q_SIGNALS:
   void provenanceItemCreated(SCIRun::Dataflow::Engine::ProvenanceItemHandle item);
 private:
   NetworkEditor* editor_;
   bool provenanceManagerModifyingNetwork_;
+  /// Modules are gone from the network when their removal is reported, so
+  /// the converter keeps what it needs to record how to put them back.
+  std::map<std::string, SCIRun::Dataflow::Networks::ModuleHandle> modules_;
+  std::map<std::string, std::pair<double, double>> deletedPositions_;
 };
 
 }
@@ -1082,12 +1082,20 @@ uint32_t SRInterface::getSelectIDForName(const std::string& name)
           }
 
           DEBUG_LOG_LINE_INFO
+          RENDERER_LOG("Copy the buffer and pass lists, the geometry object stays shared with the module. "
+            "There is no instancing shader yet, so instanced glyphs are expanded into the copies.");
+          VBOList vbos = obj->vbos();
+          IBOList ibos = obj->ibos();
+          PassList passes = obj->passes();
+          for (const auto& glyphs : obj->instancedGlyphs())
+            expandInstancedGlyphs(glyphs, vbos, ibos, passes);
+
           RENDERER_LOG("Add vertex buffer objects.");
           std::vector<char*> vbo_buffer;
           std::vector<size_t> stride_vbo;
 
           int nameIndex = 0;
-          for (auto it = obj->vbos().cbegin(); it != obj->vbos().cend(); ++it, ++nameIndex)
+          for (auto it = vbos.cbegin(); it != vbos.cend(); ++it, ++nameIndex)
           {
             const auto& vbo = *it;
 
@@ -1115,7 +1123,7 @@ uint32_t SRInterface::getSelectIDForName(const std::string& name)
           DEBUG_LOG_LINE_INFO
           RENDERER_LOG("Add index buffer objects.");
           nameIndex = 0;
-          for (auto it = obj->ibos().cbegin(); it != obj->ibos().cend(); ++it, ++nameIndex)
+          for (auto it = ibos.cbegin(); it != ibos.cend(); ++it, ++nameIndex)
           {
             const auto& ibo = *it;
             GLenum primType = GL_UNSIGNED_SHORT;
@@ -1271,7 +1279,7 @@ uint32_t SRInterface::getSelectIDForName(const std::string& name)
             }
 
             RENDERER_LOG("Add passes");
-            for (auto& pass : obj->passes())
+            for (auto& pass : passes)
             {
               uint64_t entityID = getEntityIDForName(pass.passName, port);
 
@@ -57,6 +57,7 @@ void SolveBiotSavart::setStateDefaults()
 {
   auto state = get_state();
   setStateIntFromAlgo(Parameters::OutType);
+  setStateDoubleFromAlgo(Parameters::FarFieldOpeningAngle);
 }
 
 void SolveBiotSavart::execute()
@@ -68,6 +69,7 @@ void SolveBiotSavart::execute()
   if (oport_connected(VectorBField) || oport_connected(VectorAField))
   {
     setAlgoIntFromState(Parameters::OutType);
+    setAlgoDoubleFromState(Parameters::FarFieldOpeningAngle);
 
     if (oport_connected(VectorBField) && oport_connected(VectorAField))
     {
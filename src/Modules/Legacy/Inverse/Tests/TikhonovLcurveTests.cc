@@ -0,0 +1,143 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Inverse;
+
+namespace
+{
+  // residual and solution norms of the L-curve by solving for every lambda
+  void expectNormsMatchSolutions(const TikhonovImpl& impl, const DenseMatrix& A, const DenseMatrix& y, const std::vector<double>& lambdaArray)
+  {
+    std::vector<double> rho, eta;
+    ASSERT_TRUE(impl.computeLcurveNorms(lambdaArray, rho, eta));
+    ASSERT_EQ(lambdaArray.size(), rho.size());
+    ASSERT_EQ(lambdaArray.size(), eta.size());
+
+    for (size_t j = 0; j < lambdaArray.size(); ++j)
+    {
+      DenseMatrix x = impl.computeInverseSolution(lambdaArray[j], false);
+      DenseMatrix residual = A * x - y;
+      EXPECT_NEAR(residual.norm(), rho[j], 1e-8 * (1 + residual.norm())) << "lambda " << lambdaArray[j];
+      EXPECT_NEAR(x.norm(), eta[j], 1e-8 * (1 + x.norm())) << "lambda " << lambdaArray[j];
+    }
+  }
+
+  DenseMatrix forwardMatrix(int rows, int cols)
+  {
+    DenseMatrix A(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        A(i, j) = 1.0 / (1 + i + j) + ((i * 7 + j * 3) % 5) * 0.01;
+    return A;
+  }
+
+  std::vector<double> logLambdas()
+  {
+    std::vector<double> lambdas;
+    for (double lambda = 1e-6; lambda < 2; lambda *= 1.5)
+      lambdas.push_back(lambda);
+    return lambdas;
+  }
+
+  DenseMatrix data(int rows)
+  {
+    DenseMatrix y(rows, 2);
+    for (int i = 0; i < rows; ++i)
+    {
+      y(i, 0) = std::sin(0.3 * i);
+      y(i, 1) = 1.0 + 0.1 * i;
+    }
+    return y;
+  }
+}
+
+TEST(TikhonovLcurveTests, StandardTikhonovNormsMatchSolutions)
+{
+  std::vector<double> lambdas = logLambdas();
+  DenseMatrix none;
+
+  auto under = forwardMatrix(12, 30);
+  auto yUnder = data(12);
+  SolveInverseProblemWithStandardTikhonovImpl underdetermined(under, yUnder, none, none,
+    TikhonovAlgoAbstractBase::automatic, TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  expectNormsMatchSolutions(underdetermined, under, yUnder, lambdas);
+
+  auto over = forwardMatrix(30, 12);
+  auto yOver = data(30);
+  SolveInverseProblemWithStandardTikhonovImpl overdetermined(over, yOver, none, none,
+    TikhonovAlgoAbstractBase::automatic, TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  expectNormsMatchSolutions(overdetermined, over, yOver, lambdas);
+}
+
+TEST(TikhonovLcurveTests, StandardTikhonovMatchesDirectSolve)
+{
+  auto A = forwardMatrix(12, 30);
+  auto y = data(12);
+  DenseMatrix none;
+  SolveInverseProblemWithStandardTikhonovImpl impl(A, y, none, none,
+    TikhonovAlgoAbstractBase::automatic, TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+
+  const double lambda = 1e-2;
+  DenseMatrix G = A * A.transpose() + lambda * lambda * DenseMatrix::Identity(12, 12);
+  DenseMatrix expected = A.transpose() * G.lu().solve(y);
+  DenseMatrix x = static_cast<const TikhonovImpl&>(impl).computeInverseSolution(lambda, false);
+  EXPECT_LT((x - expected).norm(), 1e-8 * expected.norm());
+}
+
+TEST(TikhonovLcurveTests, SVDNormsMatchSolutions)
+{
+  std::vector<double> lambdas = logLambdas();
+  DenseMatrix none;
+
+  auto A = forwardMatrix(12, 30);
+  auto y = data(12);
+  SolveInverseProblemWithTikhonovSVD_impl impl(A, y, none, none);
+  expectNormsMatchSolutions(impl, A, y, lambdas);
+
+  // the SVD of the same forward matrix comes from the cache the second time
+  SolveInverseProblemWithTikhonovSVD_impl cached(A, y, none, none);
+  expectNormsMatchSolutions(cached, A, y, lambdas);
+}
+
+TEST(TikhonovLcurveTests, TSVDNormsMatchSolutions)
+{
+  auto A = forwardMatrix(30, 12);
+  auto y = data(30);
+  DenseMatrix none;
+  SolveInverseProblemWithTSVD_impl impl(A, y, none, none);
+  expectNormsMatchSolutions(impl, A, y, static_cast<const TikhonovImpl&>(impl).computeLambdaArray(1, 6, 6));
+}
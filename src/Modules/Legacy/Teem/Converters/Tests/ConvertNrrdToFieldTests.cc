@@ -28,15 +28,89 @@
 
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Modules/Legacy/Teem/Converters/ConvertNrrdToField.h>
+#include <Core/Datatypes/Legacy/Nrrd/NrrdData.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
 
+using namespace SCIRun;
 using namespace SCIRun::Testing;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Dataflow::Networks;
 
 class ConvertNrrdToFieldTests : public ModuleTest
 {
+protected:
+  // 80000 nodes, enough to be copied into the field in several parallel blocks.
+  // Values are their own index modulo 100, so they fit every scalar type.
+  template <class T>
+  static NrrdDataHandle indexedNrrd(int nrrdType)
+  {
+    NrrdDataHandle nrrd(new NrrdData());
+    size_t size[3] = { 50, 40, 40 };
+    nrrdAlloc_nva(nrrd->getNrrd(), nrrdType, 3, size);
+    for (int i = 0; i < 3; ++i)
+    {
+      nrrd->getNrrd()->axis[i].kind = nrrdKindDomain;
+      nrrd->getNrrd()->axis[i].center = nrrdCenterNode;
+      nrrd->getNrrd()->axis[i].spacing = 1.0;
+      nrrd->getNrrd()->axis[i].min = 0.0;
+    }
+    auto data = static_cast<T*>(nrrd->getNrrd()->data);
+    for (size_t i = 0; i < nrrdElementNumber(nrrd->getNrrd()); ++i)
+      data[i] = static_cast<T>(i % 100);
+    return nrrd;
+  }
+
+  FieldHandle convert(NrrdDataHandle nrrd)
+  {
+    auto module = makeModule("ConvertNrrdToField");
+    stubPortNWithThisData(module, 0, nrrd);
+    module->execute();
+    return boost::dynamic_pointer_cast<Field>(getDataOnThisOutputPort(module, 0));
+  }
+
+  template <class T>
+  void expectIndexedValues(int nrrdType)
+  {
+    auto field = convert(indexedNrrd<T>(nrrdType));
+    ASSERT_TRUE(field != nullptr);
+    auto vfield = field->vfield();
+    ASSERT_EQ(80000, vfield->num_values());
+    for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    {
+      T value;
+      vfield->get_value(value, i);
+      ASSERT_EQ(static_cast<T>(i % 100), value) << "nrrd type " << nrrdType << ", value " << i;
+    }
+  }
 };
 
+TEST_F(ConvertNrrdToFieldTests, CopiesEveryScalarTypeInBulk)
+{
+  expectIndexedValues<char>(nrrdTypeChar);
+  expectIndexedValues<unsigned char>(nrrdTypeUChar);
+  expectIndexedValues<short>(nrrdTypeShort);
+  expectIndexedValues<unsigned short>(nrrdTypeUShort);
+  expectIndexedValues<int>(nrrdTypeInt);
+  expectIndexedValues<unsigned int>(nrrdTypeUInt);
+  expectIndexedValues<float>(nrrdTypeFloat);
+  expectIndexedValues<double>(nrrdTypeDouble);
+}
+
+TEST_F(ConvertNrrdToFieldTests, FieldDoesNotShareTheNrrdData)
+{
+  auto nrrd = indexedNrrd<float>(nrrdTypeFloat);
+  auto field = convert(nrrd);
+  ASSERT_TRUE(field != nullptr);
+
+  static_cast<float*>(nrrd->getNrrd()->data)[1] = -1;
+  nrrd.reset();
+
+  float value;
+  field->vfield()->get_value(value, 1);
+  EXPECT_EQ(1, value);
+}
+
 TEST_F(ConvertNrrdToFieldTests, DISABLED_CanCreate)
 {
   auto rn = makeModule("ConvertNrrdToField");
@@ -36,7 +36,9 @@
 #include <Core/Datatypes/ColorMap.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Thread/Parallel.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
+#include <limits>
 
 using namespace SCIRun;
 using namespace Modules::Visualization;
@@ -183,6 +185,7 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(FacesBoundaryOnly, false);
 
   state->setValue(FieldName, std::string());
 
@@ -423,68 +426,281 @@ void GeometryBuilder::renderFaces(
 
 namespace
 {
-  template <typename T>
-  inline void writeFloats(spire::VarBuffer* vboBuffer, std::initializer_list<T> ts)
+  void spiltColorMapToTextureAndCoordinates(
+    const boost::optional<boost::shared_ptr<ColorMap>>& colorMap,
+    ColorMapHandle& textureMap, ColorMapHandle& coordinateMap)
   {
-    for (const T& t : ts)
-      vboBuffer->writeUnsafe(static_cast<float>(t));
-  }
+    ColorMapHandle realColorMap = nullptr;
 
-  inline void writeAtributeToVBO(const Point& point, spire::VarBuffer* vboBuffer)
-  {
-    writeFloats(vboBuffer, {point.x(), point.y(), point.z()});
-  }
+    if(colorMap) realColorMap = colorMap.get();
+    else realColorMap = StandardColorMapFactory::create();
 
-  inline void writeAtributeToVBO(const Vector& vector, spire::VarBuffer* vboBuffer)
-  {
-    writeFloats(vboBuffer, {vector.x(), vector.y(), vector.z()});
-  }
+    textureMap = StandardColorMapFactory::create(realColorMap->getColorMapName(),
+      realColorMap->getColorMapResolution(), realColorMap->getColorMapShift(),
+      realColorMap->getColorMapInvert(), 0.5, 1.0, realColorMap->getAlphaLookup());
 
-  inline void writeAtributeToVBO(const glm::vec2& coords, spire::VarBuffer* vboBuffer)
-  {
-    writeFloats(vboBuffer, {coords.x, coords.y});
+    coordinateMap = StandardColorMapFactory::create("Grayscale", 256, 0, false,
+      realColorMap->getColorMapRescaleScale(), realColorMap->getColorMapRescaleShift());
   }
 
-  template<typename ... Params>
-  void writeTri(spire::VarBuffer* vboBuffer, const Params& ... params)
+  // Attributes of the vertices of one face. Each thread filling the buffers keeps its own.
+  struct FaceVertices
   {
-    for(int i = 0; i < 3; ++i)
-      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vboBuffer), 0)...};
-  }
+    explicit FaceVertices(size_t numNodes) : points(numNodes), normals(numNodes), textureCoords(numNodes),
+      svals(numNodes), vvals(numNodes), tvals(numNodes) {}
 
-  template<typename ...Params>
-  void writeQuad(spire::VarBuffer* vboBuffer, const Params& ... params)
-  {
-    for(int i = 0; i < 4; ++i)
-      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vboBuffer), 0)...};
-  }
+    VMesh::Node::array_type nodes;
+    std::vector<Point> points;
+    std::vector<Vector> normals;
+    std::vector<glm::vec2> textureCoords;
+    std::vector<double> svals;
+    std::vector<Vector> vvals;
+    std::vector<Tensor> tvals;
+  };
 
-  enum : int
+  // Reads positions, normals and color map coordinates of face vertices and
+  // writes them as interleaved floats. Only reads the mesh and field, so it
+  // can be shared by threads once the mesh is synchronized.
+  class FaceAttributeReader
   {
-    TRI, TRI_TEXCOORDS, TRI_NORMALS, TRI_NORMALS_TEXCOORDS,
-    QUAD, QUAD_TEXCOORDS, QUAD_NORMALS, QUAD_NORMALS_TEXCOORDS
+  public:
+    FaceAttributeReader(VMesh* mesh, VField* fld, ColorMapHandle coordinateMap,
+      bool useNormals, bool useFaceNormals, bool invertNormals, bool useColorMap) :
+      mesh_(mesh), fld_(fld), coordinateMap_(coordinateMap),
+      useNormals_(useNormals), useFaceNormals_(useFaceNormals), invertNormals_(invertNormals), useColorMap_(useColorMap),
+      isCellData_(fld->basis_order() == 0 && mesh->dimensionality() == 3),
+      isFaceData_(fld->basis_order() == 0 && mesh->dimensionality() == 2),
+      isNodeData_(fld->basis_order() == 1),
+      isScalar_(fld->is_scalar()), isVector_(fld->is_vector()), isTensor_(fld->is_tensor())
+    {}
+
+    size_t floatsPerVertex() const { return 3 + (useNormals_ ? 3 : 0) + (useColorMap_ ? 2 : 0); }
+
+    /// All attributes only depend on the node, so faces can share their vertices.
+    bool perNodeAttributes() const { return (!useNormals_ || useFaceNormals_) && (!useColorMap_ || isNodeData_); }
+
+    void read(VMesh::Face::index_type face, FaceVertices& v) const
+    {
+      mesh_->get_nodes(v.nodes, face);
+      const size_t numNodes = v.nodes.size();
+
+      for (size_t i = 0; i < numNodes; ++i)
+        mesh_->get_point(v.points[i], v.nodes[i]);
+
+      if (useNormals_)
+      {
+        if (useFaceNormals_)
+        {
+          for (size_t i = 0; i < numNodes; ++i)
+            mesh_->get_normal(v.normals[i], v.nodes[i]);
+        }
+        else
+        {
+          Vector norm;
+          if (numNodes == 4)
+          {
+            Vector edge1 = v.points[1] - v.points[0];
+            Vector edge2 = v.points[2] - v.points[1];
+            Vector edge3 = v.points[3] - v.points[2];
+            Vector edge4 = v.points[0] - v.points[3];
+            norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
+          }
+          else
+          {
+            Vector edge1 = v.points[1] - v.points[0];
+            Vector edge2 = v.points[2] - v.points[1];
+            norm = Cross(edge1, edge2);
+          }
+          norm.normalize();
+
+          for (size_t i = 0; i < numNodes; ++i)
+            v.normals[i] = norm;
+        }
+
+        if (invertNormals_)
+          for (size_t i = 0; i < numNodes; ++i)
+            v.normals[i] = -v.normals[i];
+      }
+
+      if (!useColorMap_)
+        return;
+
+      // Element data (Cells) so two sided faces.
+      if (isCellData_)
+      {
+        VMesh::Elem::array_type cells;
+        mesh_->get_elems(cells, face);
+        float front = 0, back = 0;
+        if (isScalar_)
+          twoSidedCoordinates(cells, v.svals, front, back);
+        else if (isVector_)
+          twoSidedCoordinates(cells, v.vvals, front, back);
+        else if (isTensor_)
+          twoSidedCoordinates(cells, v.tvals, front, back);
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+          v.textureCoords[i].x = front;
+          v.textureCoords[i].y = back;
+        }
+      }
+      // Element data (faces)
+      else if (isFaceData_)
+      {
+        float coord = 0;
+        if (isScalar_)
+          coord = faceCoordinate(face, v.svals[0]);
+        else if (isVector_)
+          coord = faceCoordinate(face, v.vvals[0]);
+        else if (isTensor_)
+          coord = faceCoordinate(face, v.tvals[0]);
+
+        for (size_t i = 0; i < numNodes; ++i)
+          v.textureCoords[i].y = v.textureCoords[i].x = coord;
+      }
+      // Data at nodes
+      else if (isNodeData_)
+      {
+        for (size_t i = 0; i < numNodes; ++i)
+          v.textureCoords[i].x = v.textureCoords[i].y = nodeCoordinate(v.nodes[i], v, i);
+      }
+    }
+
+    /// Attributes of a node, for meshes where perNodeAttributes() holds.
+    void readNode(VMesh::Node::index_type node, Point& point, Vector& normal, glm::vec2& textureCoords, FaceVertices& scratch) const
+    {
+      mesh_->get_point(point, node);
+      if (useNormals_)
+      {
+        mesh_->get_normal(normal, node);
+        if (invertNormals_)
+          normal = -normal;
+      }
+      if (useColorMap_)
+        textureCoords.x = textureCoords.y = nodeCoordinate(node, scratch, 0);
+    }
+
+    void write(float*& out, const Point& point, const Vector& normal, const glm::vec2& textureCoords) const
+    {
+      *out++ = static_cast<float>(point.x());
+      *out++ = static_cast<float>(point.y());
+      *out++ = static_cast<float>(point.z());
+      if (useNormals_)
+      {
+        *out++ = static_cast<float>(normal.x());
+        *out++ = static_cast<float>(normal.y());
+        *out++ = static_cast<float>(normal.z());
+      }
+      if (useColorMap_)
+      {
+        *out++ = textureCoords.x;
+        *out++ = textureCoords.y;
+      }
+    }
+
+  private:
+    template <class T>
+    void twoSidedCoordinates(const VMesh::Elem::array_type& cells, std::vector<T>& vals, float& front, float& back) const
+    {
+      fld_->get_value(vals[0], cells[0]);
+      if (cells.size() > 1) fld_->get_value(vals[1], cells[1]);
+      else vals[1] = vals[0];
+      front = coordinateMap_->valueToColor(vals[0]).r();
+      back = coordinateMap_->valueToColor(vals[1]).r();
+    }
+
+    template <class T>
+    float faceCoordinate(VMesh::Face::index_type face, T& val) const
+    {
+      fld_->get_value(val, face);
+      return coordinateMap_->valueToColor(val).r();
+    }
+
+    float nodeCoordinate(VMesh::Node::index_type node, FaceVertices& v, size_t i) const
+    {
+      if (isScalar_)
+      {
+        fld_->get_value(v.svals[i], node);
+        return coordinateMap_->valueToColor(v.svals[i]).r();
+      }
+      if (isVector_)
+      {
+        fld_->get_value(v.vvals[i], node);
+        return coordinateMap_->valueToColor(v.vvals[i]).r();
+      }
+      if (isTensor_)
+      {
+        fld_->get_value(v.tvals[i], node);
+        return coordinateMap_->valueToColor(v.tvals[i]).r();
+      }
+      return 0;
+    }
+
+    VMesh* mesh_;
+    VField* fld_;
+    ColorMapHandle coordinateMap_;
+    bool useNormals_, useFaceNormals_, invertNormals_, useColorMap_;
+    bool isCellData_, isFaceData_, isNodeData_;
+    bool isScalar_, isVector_, isTensor_;
   };
 
-  inline int getWriteCase(bool writeQuads, bool writeNormals, bool writeTexCoords)
+  // Faces to render; interior faces of volume meshes are dropped when boundaryOnly is set.
+  std::vector<VMesh::Face::index_type> selectFaces(VMesh* mesh, size_t numFaces, bool boundaryOnly)
   {
-    return ((int)writeQuads << 2) | ((int)writeNormals << 1) | ((int)writeTexCoords);
-  }
+    std::vector<VMesh::Face::index_type> faces;
+    if (!boundaryOnly)
+    {
+      faces.resize(numFaces);
+      for (size_t f = 0; f < numFaces; ++f)
+        faces[f] = static_cast<VMesh::Face::index_type>(f);
+      return faces;
+    }
 
-  void spiltColorMapToTextureAndCoordinates(
-    const boost::optional<boost::shared_ptr<ColorMap>>& colorMap,
-    ColorMapHandle& textureMap, ColorMapHandle& coordinateMap)
-  {
-    ColorMapHandle realColorMap = nullptr;
+    std::vector<char> isBoundary(numFaces);
+    Parallel::For(IndexRange(0, numFaces), 0, [&](const IndexRange& range)
+    {
+      VMesh::Elem::array_type cells;
+      for (size_t f = range.begin; f < range.end; ++f)
+      {
+        mesh->get_elems(cells, static_cast<VMesh::Face::index_type>(f));
+        isBoundary[f] = cells.size() < 2;
+      }
+    });
 
-    if(colorMap) realColorMap = colorMap.get();
-    else realColorMap = StandardColorMapFactory::create();
+    for (size_t f = 0; f < numFaces; ++f)
+      if (isBoundary[f])
+        faces.push_back(static_cast<VMesh::Face::index_type>(f));
+    return faces;
+  }
 
-    textureMap = StandardColorMapFactory::create(realColorMap->getColorMapName(),
-      realColorMap->getColorMapResolution(), realColorMap->getColorMapShift(),
-      realColorMap->getColorMapInvert(), 0.5, 1.0, realColorMap->getAlphaLookup());
+  // Triangle indices of face f, whose vertices are vertex[0..numNodesPerFace).
+  inline void writeFaceIndices(uint32_t*& out, const uint32_t* vertex, int numNodesPerFace)
+  {
+    if (numNodesPerFace == 4)
+    {
+      *out++ = vertex[0];
+      *out++ = vertex[1];
+      *out++ = vertex[2];
+      *out++ = vertex[2];
+      *out++ = vertex[3];
+      *out++ = vertex[0];
+    }
+    else
+    {
+      *out++ = vertex[0];
+      *out++ = vertex[1];
+      *out++ = vertex[2];
+    }
+  }
 
-    coordinateMap = StandardColorMapFactory::create("Grayscale", 256, 0, false,
-      realColorMap->getColorMapRescaleScale(), realColorMap->getColorMapRescaleShift());
+  template <class T>
+  std::shared_ptr<spire::VarBuffer> toVarBuffer(const std::vector<T>& data)
+  {
+    const size_t bytes = data.size() * sizeof(T);
+    std::shared_ptr<spire::VarBuffer> buffer(new spire::VarBuffer(bytes));
+    if (bytes > 0)
+      buffer->writeBytes(reinterpret_cast<const char*>(data.data()), bytes);
+    return buffer;
   }
 }
 
@@ -507,254 +723,133 @@ void GeometryBuilder::renderFacesLinear(
   mesh->size(numFaces);
   if (numFaces == 0) return;
 
-  Point idpt;
-  VMesh::Face::iterator fiter, fiterEnd;
-  VMesh::Node::array_type nodes;
-  mesh->get_nodes(nodes, *fiter);
-  mesh->get_point(idpt, nodes[0]);
-  mesh->begin(fiter);
-  mesh->end(fiterEnd);
-  int numNodesPerFace = nodes.size();
-  bool useQuads = (numNodesPerFace == 4);
-  int numAttributes = 3; //intially 3 because we will atleast be rendering verticies (vec3's)
+  VMesh::Node::array_type firstFaceNodes;
+  mesh->get_nodes(firstFaceNodes, VMesh::Face::index_type(0));
+  int numNodesPerFace = firstFaceNodes.size();
 
   bool useNormals = state.get(RenderState::USE_NORMALS);
   bool useFaceNormals = state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
   bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
   if (useNormals)
-  {
-    numAttributes += 3;
     mesh->synchronize(Mesh::NORMALS_E);
-  }
 
   bool useColorMap = (fld->basis_order() >= 0 && state.get(RenderState::USE_COLORMAP));
-  bool isCellData = (fld->basis_order() == 0 && mesh->dimensionality() == 3);
-  bool isFaceData = (fld->basis_order() == 0 && mesh->dimensionality() == 2);
-  bool isNodeData = (fld->basis_order() == 1);
-  bool isScalar = fld->is_scalar();
-  bool isVector = fld->is_vector();
-  bool isTensor = fld->is_tensor();
-  int colorMapCase = (isCellData * 0 + isFaceData * 1 + isNodeData * 2) * 3;
-  colorMapCase += isScalar * 0 + isVector * 1 + isTensor * 2;
-
-  ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
-
+  ColorScheme colorScheme = useColorMap ? ColorScheme::COLOR_MAP : ColorScheme::COLOR_UNIFORM;
 
   ColorMapHandle textureMap, coordinateMap;
   spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
 
-  if (useColorMap)
+  FaceAttributeReader reader(mesh, fld, coordinateMap, useNormals, useFaceNormals, invertNormals, useColorMap);
+  const size_t floatsPerVertex = reader.floatsPerVertex();
+  const size_t indicesPerFace = (numNodesPerFace - 2) * 3;
+
+  // Faces shared by two cells are hidden inside a volume unless it is transparent.
+  bool boundaryOnly = mesh->dimensionality() == 3 && state_->getValue(FacesBoundaryOnly).toBool();
+  std::vector<VMesh::Face::index_type> faces = selectFaces(mesh, numFaces, boundaryOnly);
+  interruptible->checkForInterruption();
+
+  // Faces share vertices through the index buffer when no attribute is per face.
+  // Numbering is per pass so that indices stay 32 bit.
+  bool shareVertices = reader.perNodeAttributes();
+  static const uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> vertexOfNode;
+  if (shareVertices)
   {
-    numAttributes += 2;
-    colorScheme = ColorScheme::COLOR_MAP;
+    VMesh::Node::size_type numNodes;
+    mesh->size(numNodes);
+    vertexOfNode.assign(numNodes, noVertex);
   }
 
-  int writeCase = getWriteCase(useQuads, useNormals, useColorMap);
-
-  std::vector<Point> points(numNodesPerFace);
-  std::vector<Vector> normals(numNodesPerFace);
-  std::vector<glm::vec2> textureCoords(numNodesPerFace);
-  std::vector<double> svals(numNodesPerFace);
-  std::vector<Vector> vvals(numNodesPerFace);
-  std::vector<Tensor> tvals(numNodesPerFace);
-
   size_t passNumber = 0;
-  size_t facesLeft = mesh->num_faces();
-
-  while(facesLeft > 0)
+  const static size_t maxFacesPerPass = 1 << 24;
+  for (size_t firstFace = 0; firstFace < faces.size(); firstFace += maxFacesPerPass)
   {
-    const static size_t maxFacesPerPass = 1 << 24;
-    int facesLeftInThisPass = std::min(facesLeft, maxFacesPerPass);
-    facesLeft -= facesLeftInThisPass;
-
-    // Three 32 bit ints for each triangle to index into the VBO (triangles = verticies - 2)
-    size_t iboSize = static_cast<size_t>(facesLeftInThisPass * sizeof(uint32_t) * (numNodesPerFace - 2) * 3);
-    size_t vboSize = static_cast<size_t>(facesLeftInThisPass * sizeof(float) * numNodesPerFace * numAttributes);
-    std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(iboSize));
-    std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(vboSize));
-    auto iboBuffer = iboBufferSPtr.get();
-    auto vboBuffer = vboBufferSPtr.get();
-
-    if(useQuads)
-    {
-      uint32_t nodesInThisPass = facesLeftInThisPass * 4;
-      for(uint32_t i = 0; i < nodesInThisPass; i += 4)
-      {
-        iboBuffer->writeUnsafe(i+0);
-        iboBuffer->writeUnsafe(i+1);
-        iboBuffer->writeUnsafe(i+2);
-        iboBuffer->writeUnsafe(i+2);
-        iboBuffer->writeUnsafe(i+3);
-        iboBuffer->writeUnsafe(i+0);
-      }
-    }
-    else
-    {
-      uint32_t nodesInThisPass = facesLeftInThisPass * 3;
-      for(uint32_t i = 0; i <  nodesInThisPass; i += 3)
-      {
-        iboBuffer->writeUnsafe(i+0);
-        iboBuffer->writeUnsafe(i+1);
-        iboBuffer->writeUnsafe(i+2);
-      }
-    }
+    const size_t facesInThisPass = std::min(faces.size() - firstFace, maxFacesPerPass);
+    const VMesh::Face::index_type* passFaces = &faces[firstFace];
 
-    while (facesLeftInThisPass > 0)
-    {
-      interruptible->checkForInterruption();
-      mesh->get_nodes(nodes, *fiter);
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices(facesInThisPass * indicesPerFace);
 
-      for(size_t i = 0; i < numNodesPerFace; ++i)
-        mesh->get_point(points[i], nodes[i]);
-
-      if (useNormals)
+    if (shareVertices)
+    {
+      std::vector<VMesh::Node::index_type> faceNodes(facesInThisPass * numNodesPerFace);
+      Parallel::For(IndexRange(0, facesInThisPass), 0, [&](const IndexRange& range)
       {
-        if (useFaceNormals)
+        VMesh::Node::array_type nodes;
+        for (size_t f = range.begin; f < range.end; ++f)
         {
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            mesh->get_normal(normals[i], nodes[i]);
+          mesh->get_nodes(nodes, passFaces[f]);
+          std::copy(nodes.begin(), nodes.end(), faceNodes.begin() + f * numNodesPerFace);
         }
-        else
-        {
-          Vector norm;
-          if (useQuads)
-          {
-            Vector edge1 = points[1] - points[0];
-            Vector edge2 = points[2] - points[1];
-            Vector edge3 = points[3] - points[2];
-            Vector edge4 = points[0] - points[3];
-            norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
-            norm.normalize();
-          }
-          else
-          {
-            Vector edge1 = points[1] - points[0];
-            Vector edge2 = points[2] - points[1];
-            norm = Cross(edge1, edge2);
-            norm.normalize();
-          }
+      });
 
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            normals[i] = norm;
+      // number nodes in order of first use, which keeps neighboring faces close in the VBO
+      std::vector<VMesh::Node::index_type> usedNodes;
+      for (auto node : faceNodes)
+      {
+        if (vertexOfNode[node] == noVertex)
+        {
+          vertexOfNode[node] = static_cast<uint32_t>(usedNodes.size());
+          usedNodes.push_back(node);
         }
-
-        if(invertNormals)
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            normals[i] = -normals[i];
       }
+      interruptible->checkForInterruption();
 
-      if(useColorMap)
+      vertices.resize(usedNodes.size() * floatsPerVertex);
+      Parallel::For(IndexRange(0, usedNodes.size()), 0, [&](const IndexRange& range)
       {
-        // Element data (Cells) so two sided faces.
-        if (isCellData)
+        FaceVertices scratch(1);
+        Point point;
+        Vector normal;
+        glm::vec2 textureCoords;
+        float* out = &vertices[range.begin * floatsPerVertex];
+        for (size_t v = range.begin; v < range.end; ++v)
         {
-          VMesh::Elem::array_type cells;
-          mesh->get_elems(cells, *fiter);
-
-          if (isScalar)
-          {
-            fld->get_value(svals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(svals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToColor(svals[0]).r();
-              textureCoords[i].y = coordinateMap->valueToColor(svals[1]).r();
-            }
-          }
-          else if (isVector)
-          {
-            fld->get_value(vvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(vvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToColor(vvals[0]).r();
-              textureCoords[i].y = coordinateMap->valueToColor(vvals[1]).r();
-            }
-          }
-          else if (isTensor)
-          {
-            fld->get_value(tvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(tvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              textureCoords[i].x = coordinateMap->valueToColor(tvals[0]).r();
-              textureCoords[i].y = coordinateMap->valueToColor(tvals[1]).r();
-            }
-          }
+          reader.readNode(usedNodes[v], point, normal, textureCoords, scratch);
+          reader.write(out, point, normal, textureCoords);
         }
-        // Element data (faces)
-        else if (isFaceData)
-        {
-          if (isScalar)
-          {
-            fld->get_value(svals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToColor(svals[0]).r();
-          }
-          else if (isVector)
-          {
-            fld->get_value(vvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToColor(vvals[0]).r();
-          }
-          else if (isTensor)
-          {
-            fld->get_value(tvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToColor(tvals[0]).r();
-          }
+      });
 
-          for (size_t i = 0; i < numNodesPerFace; ++i)
-            textureCoords[i].y = textureCoords[i].x = textureCoords[0].x;
+      Parallel::For(IndexRange(0, facesInThisPass), 0, [&](const IndexRange& range)
+      {
+        uint32_t vertex[4];
+        uint32_t* out = &indices[range.begin * indicesPerFace];
+        for (size_t f = range.begin; f < range.end; ++f)
+        {
+          for (int i = 0; i < numNodesPerFace; ++i)
+            vertex[i] = vertexOfNode[faceNodes[f * numNodesPerFace + i]];
+          writeFaceIndices(out, vertex, numNodesPerFace);
         }
-        // Data at nodes
-        else if (isNodeData)
+      });
+
+      for (auto node : usedNodes)
+        vertexOfNode[node] = noVertex;
+    }
+    else
+    {
+      vertices.resize(facesInThisPass * numNodesPerFace * floatsPerVertex);
+      Parallel::For(IndexRange(0, facesInThisPass), 0, [&](const IndexRange& range)
+      {
+        FaceVertices v(numNodesPerFace);
+        uint32_t vertex[4];
+        float* out = &vertices[range.begin * numNodesPerFace * floatsPerVertex];
+        uint32_t* indexOut = &indices[range.begin * indicesPerFace];
+        for (size_t f = range.begin; f < range.end; ++f)
         {
-          if (isScalar)
+          reader.read(passFaces[f], v);
+          for (int i = 0; i < numNodesPerFace; ++i)
           {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(svals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToColor(svals[i]).r();
-            }
-          }
-          else if (isVector)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(vvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToColor(vvals[i]).r();
-            }
-          }
-          else if (isTensor)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
-            {
-              fld->get_value(tvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToColor(tvals[i]).r();
-            }
+            reader.write(out, v.points[i], v.normals[i], v.textureCoords[i]);
+            vertex[i] = static_cast<uint32_t>(f * numNodesPerFace + i);
           }
+          writeFaceIndices(indexOut, vertex, numNodesPerFace);
         }
-      }
-
-      switch(writeCase)
-      {
-        case TRI: writeTri(vboBuffer, points); break;
-        case TRI_TEXCOORDS: writeTri(vboBuffer, points, textureCoords); break;
-        case TRI_NORMALS: writeTri(vboBuffer, points, normals); break;
-        case TRI_NORMALS_TEXCOORDS: writeTri(vboBuffer, points, normals, textureCoords); break;
-        case QUAD: writeQuad(vboBuffer, points); break;
-        case QUAD_TEXCOORDS: writeQuad(vboBuffer, points, textureCoords); break;
-        case QUAD_NORMALS: writeQuad(vboBuffer, points, normals); break;
-        case QUAD_NORMALS_TEXCOORDS: writeQuad(vboBuffer, points, normals, textureCoords); break;
-      }
-
-      ++fiter;
-      --facesLeftInThisPass;
+      });
     }
+    interruptible->checkForInterruption();
+
+    std::shared_ptr<spire::VarBuffer> vboBufferSPtr = toVarBuffer(vertices);
+    std::shared_ptr<spire::VarBuffer> iboBufferSPtr = toVarBuffer(indices);
 
     std::stringstream ss;
     ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_" << passNumber;
@@ -1129,3 +1224,4 @@ ALGORITHM_PARAMETER_DEF(Visualization, TextSize);
 ALGORITHM_PARAMETER_DEF(Visualization, TextPrecision);
 ALGORITHM_PARAMETER_DEF(Visualization, TextColoring);
 ALGORITHM_PARAMETER_DEF(Visualization, UseFaceNormals);
+ALGORITHM_PARAMETER_DEF(Visualization, FacesBoundaryOnly);
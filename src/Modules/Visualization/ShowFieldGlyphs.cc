@@ -197,16 +197,16 @@ void GlyphBuilder::addGlyph(
       break;
     }
     case RenderState::GlyphType::CONE_GLYPH:
-      glyphs.addCone(p1, p2, scaled_radius, resolution, render_base1, node_color, node_color);
+      glyphs.addConeInstance(p1, p2, scaled_radius, resolution, render_base1, node_color);
       break;
     case RenderState::GlyphType::ARROW_GLYPH:
-      glyphs.addArrow(p1, p2, scaled_radius, ratio, resolution, node_color, node_color, render_base1, render_base2);
+      glyphs.addArrowInstance(p1, p2, scaled_radius, ratio, resolution, node_color, render_base1, render_base2);
       break;
     case RenderState::GlyphType::DISK_GLYPH:
     {
       Point new_p2 = p1 + dir.normal() * scaled_radius * 2.0;
       double new_radius = dir.length() * scale * 0.5;
-      glyphs.addDisk(p1, new_p2, new_radius, resolution, node_color, node_color);
+      glyphs.addDiskInstance(p1, new_p2, new_radius, resolution, node_color);
       break;
     }
     case RenderState::GlyphType::RING_GLYPH:
@@ -222,7 +222,7 @@ void GlyphBuilder::addGlyph(
       if (use_lines)
         glyphs.addLine(p1, p2, node_color, node_color);
       else
-        glyphs.addArrow(p1, p2, scaled_radius, ratio, resolution, node_color, node_color, render_base1, render_base2);
+        glyphs.addArrowInstance(p1, p2, scaled_radius, ratio, resolution, node_color, render_base1, render_base2);
   }
 }
 
@@ -656,7 +656,7 @@ void GlyphBuilder::renderScalars(
         glyphs.addPoint(points[i], node_color);
         break;
       case RenderState::GlyphType::SPHERE_GLYPH:
-        glyphs.addSphere(points[i], radius, resolution, node_color);
+        glyphs.addSphereInstance(points[i], radius, resolution, node_color);
         break;
       case RenderState::GlyphType::BOX_GLYPH:
         BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Box Geom is not supported yet."));
@@ -668,7 +668,7 @@ void GlyphBuilder::renderScalars(
         if (usePoints)
           glyphs.addPoint(points[i], node_color);
         else
-          glyphs.addSphere(points[i], radius, resolution, node_color);
+          glyphs.addSphereInstance(points[i], radius, resolution, node_color);
         break;
     }
   }
@@ -796,10 +796,10 @@ void GlyphBuilder::renderTensors(
       switch (renState.mGlyphType)
       {
         case RenderState::GlyphType::BOX_GLYPH:
-          glyphs.addBox(points[i], t, scale, node_color, normalizeGlyphs);
+          glyphs.addBoxInstance(points[i], t, scale, node_color, normalizeGlyphs);
           break;
         case RenderState::GlyphType::ELLIPSOID_GLYPH:
-          glyphs.addEllipsoid(points[i], t, scale, resolution, node_color, normalizeGlyphs);
+          glyphs.addEllipsoidInstance(points[i], t, scale, resolution, node_color, normalizeGlyphs);
           break;
         case RenderState::GlyphType::SUPERELLIPSOID_GLYPH:
         {
@@ -807,7 +807,7 @@ void GlyphBuilder::renderTensors(
           if(emphasis > 0.0)
             glyphs.addSuperEllipsoid(points[i], t, scale, resolution, node_color, normalizeGlyphs, emphasis);
           else
-            glyphs.addEllipsoid(points[i], t, scale, resolution, node_color, normalizeGlyphs);
+            glyphs.addEllipsoidInstance(points[i], t, scale, resolution, node_color, normalizeGlyphs);
         }
         default:
           break;
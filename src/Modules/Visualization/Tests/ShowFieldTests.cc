@@ -33,6 +33,14 @@
 #include <Core/Utils/Exception.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <cmath>
+#include <map>
+#include <tuple>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -45,6 +53,8 @@ using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core;
 using namespace SCIRun;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Graphics::Datatypes;
 using ::testing::Values;
 using ::testing::Combine;
 using ::testing::Range;
@@ -172,3 +182,189 @@ TEST_F(ShowFieldPreformaceTest, TestFacePreformace)
   }
   std::cout << "\n";
 }
+
+class ShowFieldFaceBufferTest : public ModuleTest
+{
+protected:
+  virtual void SetUp()
+  {
+    LogSettings::Instance().setVerbose(false);
+    showField = makeModule("ShowField");
+    showField->setStateDefaults();
+    auto state = showField->get_state();
+    state->setValue(ShowFaces, true);
+    state->setValue(ShowEdges, false);
+    state->setValue(ShowNodes, false);
+  }
+
+  void useColorMap()
+  {
+    showField->get_state()->setValue(FacesColoring, 1);
+    stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  }
+
+  boost::shared_ptr<GeometryObjectSpire> render(FieldHandle field)
+  {
+    stubPortNWithThisData(showField, 0, field);
+    showField->execute();
+    return boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  }
+
+  static std::vector<float> vertexFloats(const SpireVBO& vbo)
+  {
+    auto begin = reinterpret_cast<const float*>(vbo.data->getBuffer());
+    return std::vector<float>(begin, begin + vbo.data->getBufferSize() / sizeof(float));
+  }
+
+  static size_t numIndices(const SpireIBO& ibo)
+  {
+    return ibo.data->getBufferSize() / ibo.indexSize;
+  }
+
+  // 3x3x3 nodes on [-1,1]^3: 8 cells, 36 faces of which 24 are on the boundary.
+  static FieldHandle latVol(data_info_type dataType, int basisOrder)
+  {
+    FieldInformation fi(LATVOLMESH_E, basisOrder == 0 ? CONSTANTDATA_E : LINEARDATA_E, dataType);
+    MeshHandle mesh = CreateMesh(fi, 3, 3, 3, Point(-1, -1, -1), Point(1, 1, 1));
+    FieldHandle field = CreateField(fi, mesh);
+    VField* vfield = field->vfield();
+    for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+      vfield->set_value(0.1 * (i + 1), i);
+    return field;
+  }
+
+  UseRealModuleStateFactory f;
+  ModuleHandle showField;
+};
+
+TEST_F(ShowFieldFaceBufferTest, BoundaryOnlyDropsInteriorFacesOfVolumes)
+{
+  auto all = render(CreateEmptyLatVol(3, 3, 3));
+  ASSERT_TRUE(all != nullptr);
+  ASSERT_EQ(1, all->ibos().size());
+  EXPECT_EQ(36 * 6, numIndices(all->ibos().front()));
+  EXPECT_EQ(36 * 4 * 6, vertexFloats(all->vbos().front()).size());
+
+  showField->get_state()->setValue(FacesBoundaryOnly, true);
+  auto boundary = render(CreateEmptyLatVol(3, 3, 3));
+  ASSERT_TRUE(boundary != nullptr);
+  ASSERT_EQ(1, boundary->ibos().size());
+  EXPECT_EQ(24 * 6, numIndices(boundary->ibos().front()));
+
+  auto vertices = vertexFloats(boundary->vbos().front());
+  ASSERT_EQ(24 * 4 * 6, vertices.size());
+  for (size_t v = 0; v < vertices.size(); v += 6)
+  {
+    bool onBoundary = false;
+    for (int i = 0; i < 3; ++i)
+      onBoundary |= std::abs(vertices[v + i]) == 1.0f;
+    EXPECT_TRUE(onBoundary) << "vertex " << v / 6;
+  }
+}
+
+TEST_F(ShowFieldFaceBufferTest, BoundaryOnlyKeepsEveryFaceOfSurfaces)
+{
+  auto field = CubeTriSurfLinearBasis(DOUBLE_E);
+  auto all = render(field);
+  ASSERT_TRUE(all != nullptr);
+  auto numAll = numIndices(all->ibos().front());
+  EXPECT_EQ(12 * 3, numAll);
+
+  showField->get_state()->setValue(FacesBoundaryOnly, true);
+  auto boundary = render(field);
+  ASSERT_TRUE(boundary != nullptr);
+  EXPECT_EQ(numAll, numIndices(boundary->ibos().front()));
+}
+
+TEST_F(ShowFieldFaceBufferTest, CellDataColorsBothSidesOfInteriorFaces)
+{
+  useColorMap();
+  auto geom = render(latVol(DOUBLE_E, 0));
+  ASSERT_TRUE(geom != nullptr);
+
+  // position, normal and a (front, back) color map coordinate per vertex
+  const size_t floatsPerVertex = 8;
+  auto vertices = vertexFloats(geom->vbos().front());
+  ASSERT_EQ(36 * 4 * floatsPerVertex, vertices.size());
+
+  int twoSidedFaces = 0;
+  for (size_t face = 0; face < 36; ++face)
+  {
+    const float* first = &vertices[face * 4 * floatsPerVertex];
+    for (size_t i = 1; i < 4; ++i)
+    {
+      EXPECT_EQ(first[6], first[i * floatsPerVertex + 6]);
+      EXPECT_EQ(first[7], first[i * floatsPerVertex + 7]);
+    }
+    if (first[6] != first[7])
+      ++twoSidedFaces;
+  }
+  EXPECT_EQ(12, twoSidedFaces);
+
+  showField->get_state()->setValue(FacesBoundaryOnly, true);
+  geom = render(latVol(DOUBLE_E, 0));
+  ASSERT_TRUE(geom != nullptr);
+  vertices = vertexFloats(geom->vbos().front());
+  ASSERT_EQ(24 * 4 * floatsPerVertex, vertices.size());
+  for (size_t v = 0; v < vertices.size(); v += floatsPerVertex)
+    EXPECT_EQ(vertices[v + 6], vertices[v + 7]);
+}
+
+TEST_F(ShowFieldFaceBufferTest, NodeDataColorsVerticesByTheirNode)
+{
+  useColorMap();
+  auto geom = render(latVol(DOUBLE_E, 1));
+  ASSERT_TRUE(geom != nullptr);
+
+  // lattice normals are computed per face, so every face has its own vertices
+  const size_t floatsPerVertex = 8;
+  auto vertices = vertexFloats(geom->vbos().front());
+  ASSERT_EQ(36 * 4 * floatsPerVertex, vertices.size());
+
+  std::map<std::tuple<float, float, float>, float> coordinateAt;
+  for (size_t v = 0; v < vertices.size(); v += floatsPerVertex)
+  {
+    EXPECT_EQ(vertices[v + 6], vertices[v + 7]);
+    auto position = std::make_tuple(vertices[v], vertices[v + 1], vertices[v + 2]);
+    auto found = coordinateAt.find(position);
+    if (found == coordinateAt.end())
+      coordinateAt[position] = vertices[v + 6];
+    else
+      EXPECT_EQ(found->second, vertices[v + 6]);
+  }
+  EXPECT_EQ(27, coordinateAt.size());
+}
+
+TEST_F(ShowFieldFaceBufferTest, NodeDataWithMeshNormalsSharesVertices)
+{
+  useColorMap();
+  showField->get_state()->setValue(UseFaceNormals, true);
+  auto field = CubeTriSurfLinearBasis(DOUBLE_E);
+  VField* vfield = field->vfield();
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    vfield->set_value(0.1 * (i + 1), i);
+
+  auto shared = render(field);
+  ASSERT_TRUE(shared != nullptr);
+  EXPECT_EQ(12 * 3, numIndices(shared->ibos().front()));
+  auto sharedVertices = vertexFloats(shared->vbos().front());
+  EXPECT_EQ(8 * 8, sharedVertices.size());
+
+  showField->get_state()->setValue(UseFaceNormals, false);
+  auto perFace = render(field);
+  ASSERT_TRUE(perFace != nullptr);
+  EXPECT_EQ(12 * 3, numIndices(perFace->ibos().front()));
+  auto perFaceVertices = vertexFloats(perFace->vbos().front());
+  EXPECT_EQ(12 * 3 * 8, perFaceVertices.size());
+
+  // both layouts give a vertex the color map coordinate of its node
+  std::map<std::tuple<float, float, float>, float> coordinateAt;
+  for (size_t v = 0; v < sharedVertices.size(); v += 8)
+    coordinateAt[std::make_tuple(sharedVertices[v], sharedVertices[v + 1], sharedVertices[v + 2])] = sharedVertices[v + 6];
+  for (size_t v = 0; v < perFaceVertices.size(); v += 8)
+  {
+    auto found = coordinateAt.find(std::make_tuple(perFaceVertices[v], perFaceVertices[v + 1], perFaceVertices[v + 2]));
+    ASSERT_TRUE(found != coordinateAt.end());
+    EXPECT_EQ(found->second, perFaceVertices[v + 6]);
+  }
+}
@@ -138,6 +138,53 @@ inline Core::Datatypes::SparseRowMatrixHandle toSparseHandle(const Core::Datatyp
   return sp;
 }
 
+// 5-point Laplacian on an m x m grid with Dirichlet boundary
+inline Core::Datatypes::SparseRowMatrixHandle laplacian(int m)
+{
+  std::vector<Eigen::Triplet<double>> t;
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < m; ++j)
+    {
+      const int r = i*m + j;
+      t.push_back(Eigen::Triplet<double>(r, r, 4.0));
+      if (i > 0) t.push_back(Eigen::Triplet<double>(r, r - m, -1.0));
+      if (i < m-1) t.push_back(Eigen::Triplet<double>(r, r + m, -1.0));
+      if (j > 0) t.push_back(Eigen::Triplet<double>(r, r - 1, -1.0));
+      if (j < m-1) t.push_back(Eigen::Triplet<double>(r, r + 1, -1.0));
+    }
+  auto A = boost::make_shared<Core::Datatypes::SparseRowMatrix>(m*m, m*m);
+  A->setFromTriplets(t.begin(), t.end());
+  return A;
+}
+
+inline Core::Datatypes::SparseRowMatrixHandle tridiagonal(int n, double lower, double diag, double upper)
+{
+  std::vector<Eigen::Triplet<double>> t;
+  for (int i = 0; i < n; ++i)
+  {
+    t.push_back(Eigen::Triplet<double>(i, i, diag));
+    if (i > 0) t.push_back(Eigen::Triplet<double>(i, i - 1, lower));
+    if (i < n-1) t.push_back(Eigen::Triplet<double>(i, i + 1, upper));
+  }
+  auto A = boost::make_shared<Core::Datatypes::SparseRowMatrix>(n, n);
+  A->setFromTriplets(t.begin(), t.end());
+  return A;
+}
+
+// Right-hand side with entries in [1, 2], varied by seed
+inline Core::Datatypes::DenseColumnMatrixHandle sampleRhs(int n, int seed)
+{
+  auto b = boost::make_shared<Core::Datatypes::DenseColumnMatrix>(n);
+  for (int i = 0; i < n; ++i)
+    (*b)[i] = 1.0 + ((i * 37 + seed) % 11) / 10.0;
+  return b;
+}
+
+inline double relativeResidual(const Core::Datatypes::SparseRowMatrix& A, const Core::Datatypes::DenseColumnMatrix& x, const Core::Datatypes::DenseColumnMatrix& b)
+{
+  return (b - A * x).norm() / b.norm();
+}
+
 inline Core::Datatypes::DenseMatrixHandle makeDense(const Core::Datatypes::SparseRowMatrix& sparse)
 {
   Core::Datatypes::DenseMatrixHandle dense(new Core::Datatypes::DenseMatrix(sparse.rows(), sparse.cols(), 0));